@@ -0,0 +1,519 @@
+/**
+  * @file    main.c
+  * @author  LuckkMaker
+  * @brief   Main program body
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+
+/* Private includes ----------------------------------------------------------*/
+#include <stdlib.h>
+#include <string.h>
+#include <omni.h>
+#if defined(CONFIG_LUA)
+#include "lua.h"
+#include "lualib.h"
+#include "lauxlib.h"
+#endif /* CONFIG_LUA */
+
+#define BENCH_RING_SIZE     128U
+#define BENCH_BLOCK_SIZE    1024U
+#define BENCH_GPIO_PIN      0x05U       // PA5, QEMU ignores the GPIO writes
+#define BENCH_GPIO_CALLS    256U
+#define BENCH_DSP_LEN       256U
+#define BENCH_FIR_TAPS      32U
+#define BENCH_BIQUAD_STAGES 4U
+
+static uint8_t bench_ring_pool[BENCH_RING_SIZE];
+static ring_buffer_t bench_ring;
+static uint8_t bench_src[BENCH_BLOCK_SIZE];
+static uint8_t bench_dst[BENCH_BLOCK_SIZE];
+static volatile uint32_t bench_sink;
+#if defined(CONFIG_LUA)
+static lua_State *lua_state;
+#endif /* CONFIG_LUA */
+#if defined(CONFIG_COMPONENT_CRC)
+static crc_table_t bench_crc32_table;
+static crc_table_t bench_crc16_table;
+#endif /* CONFIG_COMPONENT_CRC */
+#if defined(CONFIG_COMPONENT_DSP)
+static q15_t bench_dsp_in[BENCH_DSP_LEN];
+static q15_t bench_dsp_out[BENCH_DSP_LEN];
+static q15_t bench_dsp_work[BENCH_DSP_LEN];
+static float bench_dsp_in_f32[BENCH_DSP_LEN];
+static float bench_dsp_work_f32[BENCH_DSP_LEN];
+static float bench_dsp_out_f32[BENCH_DSP_LEN];
+static q15_t bench_fir_coeffs[BENCH_FIR_TAPS];
+static q15_t bench_fir_state[DSP_FIR_STATE_LEN(BENCH_FIR_TAPS, BENCH_DSP_LEN)];
+static q15_t bench_biquad_coeffs[5U * BENCH_BIQUAD_STAGES];
+static q15_t bench_biquad_state[DSP_BIQUAD_STATE_LEN(BENCH_BIQUAD_STAGES)];
+static q15_t bench_rfft_twiddle[DSP_RFFT_TWIDDLE_LEN(BENCH_DSP_LEN)];
+static float bench_rfft_twiddle_f32[DSP_RFFT_TWIDDLE_LEN(BENCH_DSP_LEN)];
+static dsp_fir_q15_t bench_fir;
+static dsp_biquad_q15_t bench_biquad;
+static dsp_rfft_q15_t bench_rfft;
+static dsp_rfft_f32_t bench_rfft_f32;
+#endif /* CONFIG_COMPONENT_DSP */
+
+static void bench_ring_buffer(void *arg, uint32_t iterations);
+static void bench_crc32(void *arg, uint32_t iterations);
+#if defined(CONFIG_COMPONENT_CRC)
+static void bench_crc_table(void *arg, uint32_t iterations);
+#endif /* CONFIG_COMPONENT_CRC */
+static void bench_memcpy(void *arg, uint32_t iterations);
+static void bench_memcpy_unaligned(void *arg, uint32_t iterations);
+static void bench_memset(void *arg, uint32_t iterations);
+#if defined(CONFIG_COMPONENT_MEMOPS)
+static void bench_memops_copy(void *arg, uint32_t iterations);
+static void bench_memops_copy_unaligned(void *arg, uint32_t iterations);
+static void bench_memops_set(void *arg, uint32_t iterations);
+static void bench_memops_copy_small(void *arg, uint32_t iterations);
+#endif /* CONFIG_COMPONENT_MEMOPS */
+#if defined(CONFIG_COMPONENT_DSP)
+static void bench_dsp_fir_q15(void *arg, uint32_t iterations);
+static void bench_dsp_biquad_q15(void *arg, uint32_t iterations);
+static void bench_dsp_rfft_q15(void *arg, uint32_t iterations);
+static void bench_dsp_rfft_f32(void *arg, uint32_t iterations);
+#endif /* CONFIG_COMPONENT_DSP */
+static void bench_gpio_toggle(void *arg, uint32_t iterations);
+static void bench_gpio_set_level(void *arg, uint32_t iterations);
+static void bench_dlog_frame(void *arg, uint32_t iterations);
+static void bench_malloc_free(void *arg, uint32_t iterations);
+#if defined(CONFIG_LUA)
+static void bench_lua_eval(void *arg, uint32_t iterations);
+#endif /* CONFIG_LUA */
+static uint32_t bench_null_write(const void *data, uint32_t len);
+
+static const bench_case_t bench_cases[] = {
+    { .name = "ring_buffer", .func = bench_ring_buffer, .iterations = 16, .bytes = BENCH_RING_SIZE },
+    { .name = "crc32_1k", .func = bench_crc32, .iterations = 4, .bytes = BENCH_BLOCK_SIZE },
+#if defined(CONFIG_COMPONENT_CRC)
+    { .name = "crc32_table_1k", .func = bench_crc_table, .arg = &bench_crc32_table, .iterations = 32, .bytes = BENCH_BLOCK_SIZE },
+    { .name = "crc16_table_1k", .func = bench_crc_table, .arg = &bench_crc16_table, .iterations = 32, .bytes = BENCH_BLOCK_SIZE },
+#endif /* CONFIG_COMPONENT_CRC */
+    { .name = "memcpy_1k", .func = bench_memcpy, .iterations = 64, .bytes = BENCH_BLOCK_SIZE },
+    { .name = "memcpy_unaligned_1k", .func = bench_memcpy_unaligned, .iterations = 64, .bytes = BENCH_BLOCK_SIZE - 1U },
+    { .name = "memset_1k", .func = bench_memset, .iterations = 64, .bytes = BENCH_BLOCK_SIZE },
+#if defined(CONFIG_COMPONENT_MEMOPS)
+    { .name = "memops_copy_1k", .func = bench_memops_copy, .iterations = 64, .bytes = BENCH_BLOCK_SIZE },
+    { .name = "memops_copy_unaligned_1k", .func = bench_memops_copy_unaligned, .iterations = 64, .bytes = BENCH_BLOCK_SIZE - 1U },
+    { .name = "memops_set_1k", .func = bench_memops_set, .iterations = 64, .bytes = BENCH_BLOCK_SIZE },
+    { .name = "memops_copy_small", .func = bench_memops_copy_small, .iterations = 64, .bytes = 0 },
+#endif /* CONFIG_COMPONENT_MEMOPS */
+#if defined(CONFIG_COMPONENT_DSP)
+    { .name = "dsp_fir_q15_32tap_256", .func = bench_dsp_fir_q15, .iterations = 4, .bytes = BENCH_DSP_LEN * sizeof(q15_t) },
+    { .name = "dsp_biquad_q15_4stage_256", .func = bench_dsp_biquad_q15, .iterations = 8, .bytes = BENCH_DSP_LEN * sizeof(q15_t) },
+    { .name = "dsp_rfft_q15_256", .func = bench_dsp_rfft_q15, .iterations = 8, .bytes = BENCH_DSP_LEN * sizeof(q15_t) },
+    { .name = "dsp_rfft_f32_256", .func = bench_dsp_rfft_f32, .iterations = 8, .bytes = BENCH_DSP_LEN * sizeof(float) },
+#endif /* CONFIG_COMPONENT_DSP */
+    { .name = "gpio_toggle", .func = bench_gpio_toggle, .iterations = 16, .bytes = 0 },
+    { .name = "gpio_set_level", .func = bench_gpio_set_level, .iterations = 16, .bytes = 0 },
+    { .name = "dlog_frame", .func = bench_dlog_frame, .iterations = 32, .bytes = 0 },
+    { .name = "malloc_free", .func = bench_malloc_free, .iterations = 64, .bytes = 0 },
+#if defined(CONFIG_LUA)
+    { .name = "lua_eval", .func = bench_lua_eval, .iterations = 4, .bytes = 0 },
+#endif /* CONFIG_LUA */
+};
+
+/**
+ * @brief The application entry point.
+ * 
+ * @return int 
+ */
+int main(void) {
+    setup();
+
+    bench.exit(bench.run_all(bench_cases, ARRAY_SIZE(bench_cases)));
+
+    while (1) {
+    }
+}
+
+/**
+ * @brief Setup the application
+ *
+ * @note driver_init() is not called, QEMU does not model the RCC PLL lock
+ *       and the clock setup would never return. The cases only use the
+ *       core, SRAM and SysTick.
+ */
+void setup(void) {
+    for (uint32_t i = 0; i < BENCH_BLOCK_SIZE; i++) {
+        bench_src[i] = (uint8_t)(i * 7U + 1U);
+    }
+
+    ring_buffer.init(&bench_ring, bench_ring_pool, BENCH_RING_SIZE);
+    dlog.start(bench_null_write);
+
+#if defined(CONFIG_COMPONENT_CRC)
+    crc.init_table(&crc_model_32, &bench_crc32_table);
+    crc.init_table(&crc_model_16_ccitt, &bench_crc16_table);
+#endif /* CONFIG_COMPONENT_CRC */
+
+#if defined(CONFIG_COMPONENT_DSP)
+    // Sawtooth plus square wave below full scale, averaging taps, lowpass stages
+    for (uint32_t i = 0; i < BENCH_DSP_LEN; i++) {
+        bench_dsp_in[i] = (q15_t)((int32_t)((i * 1024U) & 0x3FFFU) - 0x2000 + (int32_t)((i & 8U) << 8));
+        bench_dsp_in_f32[i] = (float)bench_dsp_in[i] / 32768.0f;
+    }
+    for (uint32_t i = 0; i < BENCH_FIR_TAPS; i++) {
+        bench_fir_coeffs[i] = (q15_t)(32768U / BENCH_FIR_TAPS);
+    }
+    for (uint32_t i = 0; i < BENCH_BIQUAD_STAGES; i++) {
+        // Lowpass at 0.1 fs, coefficients scaled by 2^-1
+        bench_biquad_coeffs[(5U * i) + 0U] = 1105;
+        bench_biquad_coeffs[(5U * i) + 1U] = 2210;
+        bench_biquad_coeffs[(5U * i) + 2U] = 1105;
+        bench_biquad_coeffs[(5U * i) + 3U] = -18727;
+        bench_biquad_coeffs[(5U * i) + 4U] = 6763;
+    }
+    dsp.fir_q15_init(&bench_fir, BENCH_FIR_TAPS, bench_fir_coeffs, bench_fir_state, BENCH_DSP_LEN);
+    dsp.biquad_q15_init(&bench_biquad, BENCH_BIQUAD_STAGES, bench_biquad_coeffs, bench_biquad_state, 1);
+    dsp.rfft_q15_init(&bench_rfft, BENCH_DSP_LEN, bench_rfft_twiddle);
+    dsp.rfft_f32_init(&bench_rfft_f32, BENCH_DSP_LEN, bench_rfft_twiddle_f32);
+#endif /* CONFIG_COMPONENT_DSP */
+
+#if defined(CONFIG_LUA)
+    lua_state = luaL_newstate();
+    luaL_openlibs(lua_state);
+#endif /* CONFIG_LUA */
+
+    bench.init();
+}
+
+/**
+ * @brief Fill and drain the ring buffer
+ *
+ * @param arg Unused
+ * @param iterations Number of fill and drain cycles
+ */
+static void bench_ring_buffer(void *arg, uint32_t iterations) {
+    uint8_t value;
+    uint32_t sum = 0;
+
+    for (uint32_t i = 0; i < iterations; i++) {
+        for (uint32_t j = 0; j < BENCH_RING_SIZE; j++) {
+            ring_buffer.enqueue(&bench_ring, (uint8_t)j);
+        }
+        for (uint32_t j = 0; j < BENCH_RING_SIZE; j++) {
+            ring_buffer.dequeue(&bench_ring, &value);
+            sum += value;
+        }
+    }
+
+    bench_sink = sum;
+}
+
+/**
+ * @brief Bitwise CRC-32 (IEEE 802.3) of a 1 KiB block
+ *
+ * @param arg Unused
+ * @param iterations Number of blocks
+ */
+static void bench_crc32(void *arg, uint32_t iterations) {
+    uint32_t crc = 0;
+
+    for (uint32_t i = 0; i < iterations; i++) {
+        crc = 0xFFFFFFFFU;
+        for (uint32_t j = 0; j < BENCH_BLOCK_SIZE; j++) {
+            crc ^= bench_src[j];
+            for (uint32_t k = 0; k < 8U; k++) {
+                crc = (crc >> 1) ^ (0xEDB88320U & (0U - (crc & 1U)));
+            }
+        }
+        crc ^= 0xFFFFFFFFU;
+    }
+
+    bench_sink = crc;
+}
+
+#if defined(CONFIG_COMPONENT_CRC)
+/**
+ * @brief Table driven CRC of a 1 KiB block with the CRC component
+ *
+ * @param arg Pointer to table, CRC-32 or CRC-16/CCITT
+ * @param iterations Number of blocks
+ */
+static void bench_crc_table(void *arg, uint32_t iterations) {
+    const crc_model_t *model = (arg == &bench_crc32_table) ? &crc_model_32 : &crc_model_16_ccitt;
+    uint32_t value = 0;
+
+    for (uint32_t i = 0; i < iterations; i++) {
+        crc.compute(model, (const crc_table_t *)arg, bench_src, BENCH_BLOCK_SIZE, &value);
+    }
+
+    bench_sink = value;
+}
+#endif /* CONFIG_COMPONENT_CRC */
+
+/**
+ * @brief Copy a 1 KiB block
+ *
+ * @param arg Unused
+ * @param iterations Number of copies
+ */
+static void bench_memcpy(void *arg, uint32_t iterations) {
+    for (uint32_t i = 0; i < iterations; i++) {
+        memcpy(bench_dst, bench_src, BENCH_BLOCK_SIZE);
+        // Keep the copy from being merged across iterations
+        __ASM volatile ("" : : : "memory");
+    }
+}
+
+/**
+ * @brief Copy a 1 KiB block less one byte, source and destination one
+ *        byte apart in alignment
+ *
+ * @param arg Unused
+ * @param iterations Number of copies
+ */
+static void bench_memcpy_unaligned(void *arg, uint32_t iterations) {
+    for (uint32_t i = 0; i < iterations; i++) {
+        memcpy(bench_dst, bench_src + 1, BENCH_BLOCK_SIZE - 1U);
+        __ASM volatile ("" : : : "memory");
+    }
+}
+
+/**
+ * @brief Fill a 1 KiB block
+ *
+ * @param arg Unused
+ * @param iterations Number of fills
+ */
+static void bench_memset(void *arg, uint32_t iterations) {
+    for (uint32_t i = 0; i < iterations; i++) {
+        memset(bench_dst, (int)i, BENCH_BLOCK_SIZE);
+        __ASM volatile ("" : : : "memory");
+    }
+}
+
+#if defined(CONFIG_COMPONENT_MEMOPS)
+/**
+ * @brief Copy a 1 KiB block with the memops component
+ *
+ * @param arg Unused
+ * @param iterations Number of copies
+ */
+static void bench_memops_copy(void *arg, uint32_t iterations) {
+    for (uint32_t i = 0; i < iterations; i++) {
+        memops.copy(bench_dst, bench_src, BENCH_BLOCK_SIZE);
+        __ASM volatile ("" : : : "memory");
+    }
+}
+
+/**
+ * @brief Unaligned copy with the memops component, see bench_memcpy_unaligned
+ *
+ * @param arg Unused
+ * @param iterations Number of copies
+ */
+static void bench_memops_copy_unaligned(void *arg, uint32_t iterations) {
+    for (uint32_t i = 0; i < iterations; i++) {
+        memops.copy(bench_dst, bench_src + 1, BENCH_BLOCK_SIZE - 1U);
+        __ASM volatile ("" : : : "memory");
+    }
+}
+
+/**
+ * @brief Fill a 1 KiB block with the memops component
+ *
+ * @param arg Unused
+ * @param iterations Number of fills
+ */
+static void bench_memops_set(void *arg, uint32_t iterations) {
+    for (uint32_t i = 0; i < iterations; i++) {
+        memops.set(bench_dst, (int)i, BENCH_BLOCK_SIZE);
+        __ASM volatile ("" : : : "memory");
+    }
+}
+
+/**
+ * @brief Copies of 1 to 16 bytes with the memops component
+ *
+ * @param arg Unused
+ * @param iterations Number of rounds of 16 copies
+ */
+static void bench_memops_copy_small(void *arg, uint32_t iterations) {
+    for (uint32_t i = 0; i < iterations; i++) {
+        for (uint32_t len = 1; len <= 16U; len++) {
+            memops.copy(bench_dst + len, bench_src, len);
+            __ASM volatile ("" : : : "memory");
+        }
+    }
+}
+#endif /* CONFIG_COMPONENT_MEMOPS */
+
+#if defined(CONFIG_COMPONENT_DSP)
+/**
+ * @brief Q15 FIR filter, 32 taps over blocks of 256 samples
+ *
+ * @param arg Unused
+ * @param iterations Number of blocks
+ */
+static void bench_dsp_fir_q15(void *arg, uint32_t iterations) {
+    for (uint32_t i = 0; i < iterations; i++) {
+        dsp.fir_q15(&bench_fir, bench_dsp_in, bench_dsp_out, BENCH_DSP_LEN);
+    }
+
+    bench_sink = (uint32_t)bench_dsp_out[BENCH_DSP_LEN - 1U];
+}
+
+/**
+ * @brief Q15 biquad cascade, 4 stages over blocks of 256 samples
+ *
+ * @param arg Unused
+ * @param iterations Number of blocks
+ */
+static void bench_dsp_biquad_q15(void *arg, uint32_t iterations) {
+    for (uint32_t i = 0; i < iterations; i++) {
+        dsp.biquad_q15(&bench_biquad, bench_dsp_in, bench_dsp_out, BENCH_DSP_LEN);
+    }
+
+    bench_sink = (uint32_t)bench_dsp_out[BENCH_DSP_LEN - 1U];
+}
+
+/**
+ * @brief Q15 real FFT of 256 samples
+ *
+ * @note The input is copied first, the FFT uses it as work area.
+ * @param arg Unused
+ * @param iterations Number of transforms
+ */
+static void bench_dsp_rfft_q15(void *arg, uint32_t iterations) {
+    for (uint32_t i = 0; i < iterations; i++) {
+        memcpy(bench_dsp_work, bench_dsp_in, sizeof(bench_dsp_work));
+        dsp.rfft_q15(&bench_rfft, bench_dsp_work, bench_dsp_out);
+    }
+
+    bench_sink = (uint32_t)bench_dsp_out[2];
+}
+
+/**
+ * @brief Float real FFT of 256 samples, see bench_dsp_rfft_q15
+ *
+ * @param arg Unused
+ * @param iterations Number of transforms
+ */
+static void bench_dsp_rfft_f32(void *arg, uint32_t iterations) {
+    for (uint32_t i = 0; i < iterations; i++) {
+        memcpy(bench_dsp_work_f32, bench_dsp_in_f32, sizeof(bench_dsp_work_f32));
+        dsp.rfft_f32(&bench_rfft_f32, bench_dsp_work_f32, bench_dsp_out_f32);
+    }
+
+    bench_sink = (uint32_t)(int32_t)bench_dsp_out_f32[2];
+}
+#endif /* CONFIG_COMPONENT_DSP */
+
+/**
+ * @brief Toggle a pin through the GPIO driver API
+ *
+ * @note Measures the driver call, compare builds with and without
+ *       CONFIG_OMNI_DRIVER_DIRECT_CALL.
+ * @param arg Unused
+ * @param iterations Number of rounds of BENCH_GPIO_CALLS calls
+ */
+static void bench_gpio_toggle(void *arg, uint32_t iterations) {
+    for (uint32_t i = 0; i < iterations; i++) {
+        for (uint32_t j = 0; j < BENCH_GPIO_CALLS; j++) {
+            gpio_driver.toggle(BENCH_GPIO_PIN);
+        }
+    }
+}
+
+/**
+ * @brief Bit-bang a byte pattern through the GPIO driver API, see
+ *        bench_gpio_toggle
+ *
+ * @param arg Unused
+ * @param iterations Number of rounds of BENCH_GPIO_CALLS calls
+ */
+static void bench_gpio_set_level(void *arg, uint32_t iterations) {
+    for (uint32_t i = 0; i < iterations; i++) {
+        for (uint32_t j = 0; j < BENCH_GPIO_CALLS; j++) {
+            gpio_driver.set_level(BENCH_GPIO_PIN, (bench_src[j] >> (j & 7U)) & 1U);
+        }
+    }
+}
+
+/**
+ * @brief Record deferred log frames and flush them
+ *
+ * @param arg Unused
+ * @param iterations Number of frames
+ */
+static void bench_dlog_frame(void *arg, uint32_t iterations) {
+    for (uint32_t i = 0; i < iterations; i++) {
+        DLOG_INFO("bench frame %u of %u at %u", i, iterations, bench_sink);
+    }
+
+    dlog.flush();
+}
+
+/**
+ * @brief Allocate and free blocks of two sizes
+ *
+ * @param arg Unused
+ * @param iterations Number of allocation pairs
+ */
+static void bench_malloc_free(void *arg, uint32_t iterations) {
+    for (uint32_t i = 0; i < iterations; i++) {
+        uint8_t *small = (uint8_t *)OMNI_MALLOC(32);
+        uint8_t *large = (uint8_t *)OMNI_MALLOC(256);
+
+        bench_sink = (uint32_t)(uintptr_t)small ^ (uint32_t)(uintptr_t)large;
+
+        OMNI_FREE(large);
+        OMNI_FREE(small);
+    }
+}
+
+#if defined(CONFIG_LUA)
+/**
+ * @brief Evaluate a Lua chunk
+ *
+ * @param arg Unused
+ * @param iterations Number of evaluations
+ */
+static void bench_lua_eval(void *arg, uint32_t iterations) {
+    for (uint32_t i = 0; i < iterations; i++) {
+        luaL_dostring(lua_state, "local s = 0 for i = 1, 100 do s = s + i * i end return s");
+        lua_pop(lua_state, 1);
+    }
+}
+#endif /* CONFIG_LUA */
+
+/**
+ * @brief Deferred log sink, drops the frames
+ *
+ * @param data Pointer to frames
+ * @param len Number of bytes
+ * @return Number of bytes accepted
+ */
+static uint32_t bench_null_write(const void *data, uint32_t len) {
+    (void)data;
+
+    return len;
+}
+
+#if defined(CONFIG_LUA)
+int _gettimeofday(struct timeval *tv, void *tzvp) {
+    return 0;
+}
+#endif /* CONFIG_LUA */
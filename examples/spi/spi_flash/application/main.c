@@ -260,14 +260,14 @@ void flash_read_device_id(flash_info_t *flash) {
  * @brief Select the flash chip
  */
 void flash_chip_select(void) {
-    gpio_driver.set_level(SPI_CS_PIN, GPIO_LEVEL_LOW);
+    gpio_hal_fast_reset(SPI_CS_PIN);
 }
 
 /**
  * @brief Deselect the flash chip
  */
 void flash_chip_deselect(void) {
-    gpio_driver.set_level(SPI_CS_PIN, GPIO_LEVEL_HIGH);
+    gpio_hal_fast_set(SPI_CS_PIN);
 }
 
 /**
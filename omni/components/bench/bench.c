@@ -0,0 +1,240 @@
+/**
+  * @file    bench.c
+  * @author  LuckkMaker
+  * @brief   Microbenchmark component for omni
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include "bench/bench.h"
+
+#define BENCH_SYSTICK_MAX               0xFFFFFFU
+#define BENCH_LINE_SIZE                 192U
+
+// ARM semihosting operations
+#define BENCH_SEMIHOST_SYS_WRITE0       0x04U
+#define BENCH_SEMIHOST_SYS_EXIT         0x18U
+#define BENCH_SEMIHOST_EXIT_OK          0x20026U    /**< ADP_Stopped_ApplicationExit */
+#define BENCH_SEMIHOST_EXIT_ERROR       0x20023U    /**< ADP_Stopped_RunTimeErrorUnknown */
+
+// Ticks of timing an empty run, subtracted from every run
+static uint32_t bench_overhead;
+
+static void bench_init(void);
+static int bench_run(const bench_case_t *bench_case, bench_result_t *result);
+static void bench_report(const bench_case_t *bench_case, const bench_result_t *result);
+static uint32_t bench_run_all(const bench_case_t *cases, uint32_t num);
+static void bench_exit(uint32_t failed);
+static uint32_t bench_measure(bench_func_t func, void *arg, uint32_t iterations, bool *overflow);
+static void bench_empty(void *arg, uint32_t iterations);
+static void bench_print(const char *str);
+
+const struct bench_api bench = {
+    .init = bench_init,
+    .run = bench_run,
+    .report = bench_report,
+    .run_all = bench_run_all,
+    .exit = bench_exit,
+};
+
+/**
+ * @brief Initialize benchmark timer
+ *
+ * @note SysTick is taken over without its interrupt, do not use it as the
+ *       RTOS or HAL tick while benchmarking.
+ */
+static void bench_init(void) {
+    bool overflow;
+
+    SysTick->CTRL = 0;
+    SysTick->LOAD = BENCH_SYSTICK_MAX;
+    SysTick->VAL = 0;
+    SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
+
+    bench_overhead = 0;
+    bench_overhead = bench_measure(bench_empty, NULL, 0, &overflow);
+}
+
+/**
+ * @brief Run a case
+ *
+ * @param bench_case Pointer to case
+ * @param result Pointer to result
+ * @return Operation status, OMNI_FAIL if a run overflowed
+ */
+static int bench_run(const bench_case_t *bench_case, bench_result_t *result) {
+    omni_assert_not_null(bench_case);
+    omni_assert_not_null(bench_case->func);
+    omni_assert_not_null(result);
+
+    bool overflow = false;
+    uint32_t ticks;
+
+    result->runs = 0;
+    result->min = UINT32_MAX;
+    result->max = 0;
+    result->overflow = false;
+
+    // Warm up caches, flash prefetch and lazy initialization
+    bench_case->func(bench_case->arg, bench_case->iterations);
+
+    for (uint32_t i = 0; i < CONFIG_BENCH_REPEAT; i++) {
+        ticks = bench_measure(bench_case->func, bench_case->arg, bench_case->iterations, &overflow);
+        result->overflow |= overflow;
+        result->runs++;
+
+        if (ticks < result->min) {
+            result->min = ticks;
+        }
+        if (ticks > result->max) {
+            result->max = ticks;
+        }
+    }
+
+    return result->overflow ? OMNI_FAIL : OMNI_OK;
+}
+
+/**
+ * @brief Print the result of a case
+ *
+ * @param bench_case Pointer to case
+ * @param result Pointer to result
+ */
+static void bench_report(const bench_case_t *bench_case, const bench_result_t *result) {
+    omni_assert_not_null(bench_case);
+    omni_assert_not_null(result);
+
+    char line[BENCH_LINE_SIZE];
+
+    snprintf(line, sizeof(line),
+             "BENCH {\"name\":\"%s\",\"iterations\":%lu,\"bytes\":%lu,\"runs\":%lu,\"min\":%lu,\"max\":%lu,\"overflow\":%s}\n",
+             bench_case->name, (unsigned long)bench_case->iterations, (unsigned long)bench_case->bytes,
+             (unsigned long)result->runs, (unsigned long)result->min, (unsigned long)result->max,
+             result->overflow ? "true" : "false");
+
+    bench_print(line);
+}
+
+/**
+ * @brief Run and print a list of cases
+ *
+ * @param cases Pointer to cases
+ * @param num Number of cases
+ * @return Number of failed cases
+ */
+static uint32_t bench_run_all(const bench_case_t *cases, uint32_t num) {
+    omni_assert_not_null(cases);
+
+    char line[BENCH_LINE_SIZE];
+    bench_result_t result;
+    uint32_t failed = 0;
+
+    for (uint32_t i = 0; i < num; i++) {
+        if (bench_run(&cases[i], &result) != OMNI_OK) {
+            failed++;
+        }
+        bench_report(&cases[i], &result);
+    }
+
+    snprintf(line, sizeof(line), "BENCH_END {\"cases\":%lu,\"failed\":%lu}\n",
+             (unsigned long)num, (unsigned long)failed);
+    bench_print(line);
+
+    return failed;
+}
+
+/**
+ * @brief End the benchmark run
+ *
+ * @note With semihosting QEMU exits with status 0 when no case failed,
+ *       otherwise the function does not return.
+ * @param failed Number of failed cases
+ */
+static void bench_exit(uint32_t failed) {
+#if defined(CONFIG_BENCH_SEMIHOSTING)
+    register uint32_t r0 __ASM("r0") = BENCH_SEMIHOST_SYS_EXIT;
+    register uint32_t r1 __ASM("r1") = (failed == 0U) ? BENCH_SEMIHOST_EXIT_OK : BENCH_SEMIHOST_EXIT_ERROR;
+
+    __ASM volatile ("bkpt 0xAB" : "+r" (r0) : "r" (r1) : "memory");
+#else
+    (void)failed;
+#endif /* CONFIG_BENCH_SEMIHOSTING */
+
+    while (1) {
+        __WFI();
+    }
+}
+
+/********************* Private functions **********************/
+
+/**
+ * @brief Measure one run
+ *
+ * @param func Measured function
+ * @param arg Function argument
+ * @param iterations Iterations of the run
+ * @param overflow Set if SysTick wrapped during the run
+ * @return Ticks of the run without the timing overhead
+ */
+static uint32_t bench_measure(bench_func_t func, void *arg, uint32_t iterations, bool *overflow) {
+    uint32_t start;
+    uint32_t end;
+    uint32_t ticks;
+
+    // Writing VAL clears COUNTFLAG, the counter reloads on the next tick
+    SysTick->VAL = 0;
+    while ((start = SysTick->VAL) == 0U) {
+    }
+
+    func(arg, iterations);
+
+    end = SysTick->VAL;
+    *overflow = (SysTick->CTRL & SysTick_CTRL_COUNTFLAG_Msk) != 0U;
+
+    ticks = start - end;
+
+    return (ticks > bench_overhead) ? (ticks - bench_overhead) : 0U;
+}
+
+/**
+ * @brief Empty case used to measure the timing overhead
+ *
+ * @param arg Unused
+ * @param iterations Unused
+ */
+static void bench_empty(void *arg, uint32_t iterations) {
+    (void)arg;
+    (void)iterations;
+}
+
+/**
+ * @brief Print a string
+ *
+ * @param str Pointer to null terminated string
+ */
+static void bench_print(const char *str) {
+#if defined(CONFIG_BENCH_SEMIHOSTING)
+    register uint32_t r0 __ASM("r0") = BENCH_SEMIHOST_SYS_WRITE0;
+    register const char *r1 __ASM("r1") = str;
+
+    __ASM volatile ("bkpt 0xAB" : "+r" (r0) : "r" (r1) : "memory");
+#else
+    printf("%s", str);
+#endif /* CONFIG_BENCH_SEMIHOSTING */
+}
@@ -0,0 +1,133 @@
+/**
+  * @file    bench.h
+  * @author  LuckkMaker
+  * @brief   Microbenchmark component for omni
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef COMPONENT_BENCH_H
+#define COMPONENT_BENCH_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "include/device.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Cases are timed with SysTick instead of the DWT cycle counter, QEMU
+ * does not model DWT. SysTick runs from the processor clock without its
+ * interrupt, so a single run must stay below 2^24 ticks, longer runs are
+ * reported as overflowed. Under qemu-system-arm -icount the ticks follow
+ * the executed instructions, so results are deterministic and can be
+ * compared against a baseline.
+ *
+ * Every result is printed as one line:
+ *   BENCH {"name":"memcpy_1k","iterations":64,"bytes":1024,"runs":5,"min":812,"max":830,"overflow":false}
+ * and the run ends with:
+ *   BENCH_END {"cases":6,"failed":0}
+ *
+ * tools/python/qemu_bench.py collects the lines into a JSON file.
+ *
+ * @code
+ * static void bench_memcpy(void *arg, uint32_t iterations) {
+ *     for (uint32_t i = 0; i < iterations; i++) {
+ *         memcpy(dst, src, sizeof(src));
+ *     }
+ * }
+ *
+ * static const bench_case_t cases[] = {
+ *     { .name = "memcpy_1k", .func = bench_memcpy, .iterations = 64, .bytes = 1024 },
+ * };
+ *
+ * bench.init();
+ * bench.exit(bench.run_all(cases, 1));
+ * @endcode
+ */
+
+/**
+ * @brief Benchmark function, runs the measured operation iterations times
+ */
+typedef void (*bench_func_t)(void *arg, uint32_t iterations);
+
+/**
+ * @brief Benchmark case
+ */
+typedef struct bench_case {
+    const char *name;               /**< Case name, printed as is in JSON */
+    bench_func_t func;              /**< Measured function */
+    void *arg;                      /**< Function argument */
+    uint32_t iterations;            /**< Iterations per run */
+    uint32_t bytes;                 /**< Bytes processed per iteration, 0 if not applicable */
+} bench_case_t;
+
+/**
+ * @brief Benchmark result
+ */
+typedef struct bench_result {
+    uint32_t runs;                  /**< Measured runs */
+    uint32_t min;                   /**< Minimum ticks of a run */
+    uint32_t max;                   /**< Maximum ticks of a run */
+    bool overflow;                  /**< A run took 2^24 ticks or more */
+} bench_result_t;
+
+/**
+ * @brief Initialize benchmark timer
+ */
+typedef void (*bench_init_t)(void);
+
+/**
+ * @brief Run a case
+ */
+typedef int (*bench_run_t)(const bench_case_t *bench_case, bench_result_t *result);
+
+/**
+ * @brief Print the result of a case
+ */
+typedef void (*bench_report_t)(const bench_case_t *bench_case, const bench_result_t *result);
+
+/**
+ * @brief Run and print a list of cases, returns number of failed cases
+ */
+typedef uint32_t (*bench_run_all_t)(const bench_case_t *cases, uint32_t num);
+
+/**
+ * @brief End the benchmark run
+ */
+typedef void (*bench_exit_t)(uint32_t failed);
+
+/**
+ * @brief Benchmark API
+ */
+struct bench_api {
+    bench_init_t init;
+    bench_run_t run;
+    bench_report_t report;
+    bench_run_all_t run_all;
+    bench_exit_t exit;
+};
+
+extern const struct bench_api bench;
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* COMPONENT_BENCH_H */
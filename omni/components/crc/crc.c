@@ -0,0 +1,462 @@
+/**
+  * @file    crc.c
+  * @author  LuckkMaker
+  * @brief   CRC component for omni
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "crc/crc.h"
+#if defined(CONFIG_OMNI_DRIVER_CRC)
+#include "drivers/crc.h"
+#endif /* CONFIG_OMNI_DRIVER_CRC */
+
+const crc_model_t crc_model_8 = {
+    .width = 8, .poly = 0x07U, .init = 0x00U,
+    .reflect_in = false, .reflect_out = false, .xor_out = 0x00U,
+};
+
+const crc_model_t crc_model_8_maxim = {
+    .width = 8, .poly = 0x31U, .init = 0x00U,
+    .reflect_in = true, .reflect_out = true, .xor_out = 0x00U,
+};
+
+const crc_model_t crc_model_16_ccitt = {
+    .width = 16, .poly = 0x1021U, .init = 0xFFFFU,
+    .reflect_in = false, .reflect_out = false, .xor_out = 0x0000U,
+};
+
+const crc_model_t crc_model_16_xmodem = {
+    .width = 16, .poly = 0x1021U, .init = 0x0000U,
+    .reflect_in = false, .reflect_out = false, .xor_out = 0x0000U,
+};
+
+const crc_model_t crc_model_16_modbus = {
+    .width = 16, .poly = 0x8005U, .init = 0xFFFFU,
+    .reflect_in = true, .reflect_out = true, .xor_out = 0x0000U,
+};
+
+const crc_model_t crc_model_32 = {
+    .width = 32, .poly = 0x04C11DB7U, .init = 0xFFFFFFFFU,
+    .reflect_in = true, .reflect_out = true, .xor_out = 0xFFFFFFFFU,
+};
+
+const crc_model_t crc_model_32c = {
+    .width = 32, .poly = 0x1EDC6F41U, .init = 0xFFFFFFFFU,
+    .reflect_in = true, .reflect_out = true, .xor_out = 0xFFFFFFFFU,
+};
+
+const crc_model_t crc_model_32_mpeg2 = {
+    .width = 32, .poly = 0x04C11DB7U, .init = 0xFFFFFFFFU,
+    .reflect_in = false, .reflect_out = false, .xor_out = 0x00000000U,
+};
+
+static int crc_init_table(const crc_model_t *model, crc_table_t *table);
+static int crc_start(crc_ctx_t *ctx, const crc_model_t *model, const crc_table_t *table);
+static int crc_update(crc_ctx_t *ctx, const void *data, uint32_t len);
+static int crc_update_async(crc_ctx_t *ctx, const void *data, uint32_t len, crc_update_callback cb, void *arg);
+static uint32_t crc_finish(const crc_ctx_t *ctx);
+static int crc_compute(const crc_model_t *model, const crc_table_t *table, const void *data, uint32_t len,
+                       uint32_t *value);
+static uint32_t crc_reflect(uint32_t value, uint32_t width);
+static uint32_t crc_table_update(const crc_ctx_t *ctx, const uint8_t *data, uint32_t len);
+#if defined(CONFIG_OMNI_DRIVER_CRC)
+static void crc_unit_config(const crc_model_t *model, crc_driver_config_t *config);
+static uint32_t crc_to_unit(const crc_model_t *model, uint32_t value);
+static uint32_t crc_from_unit(const crc_model_t *model, uint32_t value);
+static void crc_unit_done(uint32_t event, uint32_t value, void *arg);
+#endif /* CONFIG_OMNI_DRIVER_CRC */
+
+const struct crc_api crc = {
+    .init_table = crc_init_table,
+    .start = crc_start,
+    .update = crc_update,
+    .update_async = crc_update_async,
+    .finish = crc_finish,
+    .compute = crc_compute,
+};
+
+/*
+ * The table code keeps the register of an LSB first model reflected in
+ * the low bits, and the register of an MSB first model in the high bits
+ * of the word, so both shift out whole bytes without masking.
+ */
+
+/**
+ * @brief Build the table of a model
+ *
+ * @param model Pointer to model
+ * @param table Pointer to table
+ * @return Operation status
+ */
+static int crc_init_table(const crc_model_t *model, crc_table_t *table) {
+    uint32_t poly;
+
+    if ((model == NULL) || (table == NULL) || (model->width == 0U) || (model->width > 32U)) {
+        return OMNI_FAIL;
+    }
+
+    if (model->reflect_in) {
+        poly = crc_reflect(model->poly, model->width);
+
+        for (uint32_t i = 0; i < 256U; i++) {
+            uint32_t entry = i;
+
+            for (uint32_t bit = 0; bit < 8U; bit++) {
+                entry = ((entry & 1U) != 0U) ? ((entry >> 1) ^ poly) : (entry >> 1);
+            }
+
+            table->entry[0][i] = entry;
+        }
+
+        // Slice k is slice k - 1 followed by a zero byte
+        for (uint32_t k = 1; k < CRC_TABLE_SLICES; k++) {
+            for (uint32_t i = 0; i < 256U; i++) {
+                uint32_t prev = table->entry[k - 1][i];
+                table->entry[k][i] = (prev >> 8) ^ table->entry[0][prev & 0xFFU];
+            }
+        }
+    } else {
+        poly = model->poly << (32U - model->width);
+
+        for (uint32_t i = 0; i < 256U; i++) {
+            uint32_t entry = i << 24;
+
+            for (uint32_t bit = 0; bit < 8U; bit++) {
+                entry = ((entry & 0x80000000U) != 0U) ? ((entry << 1) ^ poly) : (entry << 1);
+            }
+
+            table->entry[0][i] = entry;
+        }
+
+        for (uint32_t k = 1; k < CRC_TABLE_SLICES; k++) {
+            for (uint32_t i = 0; i < 256U; i++) {
+                uint32_t prev = table->entry[k - 1][i];
+                table->entry[k][i] = (prev << 8) ^ table->entry[0][prev >> 24];
+            }
+        }
+    }
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Start a CRC
+ *
+ * @param ctx Pointer to context
+ * @param model Pointer to model
+ * @param table Pointer to table built for the model, NULL to use the CRC unit only
+ * @return Operation status, OMNI_FAIL if there is no table and the unit
+ *         does not compute the model
+ */
+static int crc_start(crc_ctx_t *ctx, const crc_model_t *model, const crc_table_t *table) {
+    if ((ctx == NULL) || (model == NULL) || (model->width == 0U) || (model->width > 32U)) {
+        return OMNI_FAIL;
+    }
+
+    if (table == NULL) {
+#if defined(CONFIG_OMNI_DRIVER_CRC)
+        crc_driver_config_t config;
+
+        crc_unit_config(model, &config);
+        if (!crc_driver.is_supported(&config)) {
+            return OMNI_FAIL;
+        }
+#else
+        return OMNI_FAIL;
+#endif /* CONFIG_OMNI_DRIVER_CRC */
+    }
+
+    ctx->model = model;
+    ctx->table = table;
+    ctx->value = model->reflect_in ? crc_reflect(model->init, model->width) : (model->init << (32U - model->width));
+    ctx->cb = NULL;
+    ctx->arg = NULL;
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Add data to a CRC
+ *
+ * @param ctx Pointer to context
+ * @param data Pointer to data
+ * @param len Length in bytes
+ * @return Operation status, OMNI_BUSY if the context has no table and
+ *         the CRC unit is in use
+ */
+static int crc_update(crc_ctx_t *ctx, const void *data, uint32_t len) {
+    omni_assert_not_null(ctx);
+    omni_assert_not_null(data);
+
+#if defined(CONFIG_OMNI_DRIVER_CRC)
+    if ((ctx->table == NULL) || (len >= CONFIG_CRC_HW_THRESHOLD)) {
+        crc_driver_config_t config;
+        uint32_t value = crc_to_unit(ctx->model, ctx->value);
+        int status;
+
+        crc_unit_config(ctx->model, &config);
+        status = crc_driver.update(&config, &value, data, len);
+        if (status == OMNI_OK) {
+            ctx->value = crc_from_unit(ctx->model, value);
+            return OMNI_OK;
+        }
+
+        if (ctx->table == NULL) {
+            return status;
+        }
+    }
+#endif /* CONFIG_OMNI_DRIVER_CRC */
+
+    ctx->value = crc_table_update(ctx, data, len);
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Add data to a CRC, completion reported by callback
+ *
+ * @note Long updates on a CRC unit with DMA call the callback from the
+ *       DMA interrupt, data and context must stay valid until then. All
+ *       other updates call it before the function returns.
+ * @param ctx Pointer to context
+ * @param data Pointer to data
+ * @param len Length in bytes
+ * @param cb Completion callback
+ * @param arg Callback argument
+ * @return Operation status, OMNI_BUSY if the context has no table and
+ *         the CRC unit is in use
+ */
+static int crc_update_async(crc_ctx_t *ctx, const void *data, uint32_t len, crc_update_callback cb, void *arg) {
+    omni_assert_not_null(ctx);
+    omni_assert_not_null(data);
+    omni_assert_not_null(cb);
+
+#if defined(CONFIG_OMNI_DRIVER_CRC)
+    if ((ctx->table == NULL) || (len >= CONFIG_CRC_HW_THRESHOLD)) {
+        crc_driver_config_t config;
+        int status;
+
+        ctx->cb = cb;
+        ctx->arg = arg;
+
+        crc_unit_config(ctx->model, &config);
+        status = crc_driver.update_async(&config, crc_to_unit(ctx->model, ctx->value), data, len, crc_unit_done, ctx);
+        if (status == OMNI_OK) {
+            return OMNI_OK;
+        }
+
+        if (ctx->table == NULL) {
+            return status;
+        }
+    }
+#endif /* CONFIG_OMNI_DRIVER_CRC */
+
+    ctx->value = crc_table_update(ctx, data, len);
+    cb(ctx, OMNI_OK, arg);
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Get the CRC of the data so far
+ *
+ * @param ctx Pointer to context
+ * @return CRC value
+ */
+static uint32_t crc_finish(const crc_ctx_t *ctx) {
+    const crc_model_t *model;
+    uint32_t mask;
+    uint32_t value;
+
+    omni_assert_not_null(ctx);
+
+    model = ctx->model;
+    mask = (model->width == 32U) ? 0xFFFFFFFFU : ((1UL << model->width) - 1U);
+
+    // Back to MSB first
+    value = model->reflect_in ? crc_reflect(ctx->value, model->width) : (ctx->value >> (32U - model->width));
+
+    if (model->reflect_out) {
+        value = crc_reflect(value, model->width);
+    }
+
+    return (value ^ model->xor_out) & mask;
+}
+
+/**
+ * @brief Compute the CRC of a buffer
+ *
+ * @param model Pointer to model
+ * @param table Pointer to table built for the model, NULL to use the CRC unit only
+ * @param data Pointer to data
+ * @param len Length in bytes
+ * @param value Pointer to CRC value
+ * @return Operation status
+ */
+static int crc_compute(const crc_model_t *model, const crc_table_t *table, const void *data, uint32_t len,
+                       uint32_t *value) {
+    crc_ctx_t ctx;
+    int status;
+
+    omni_assert_not_null(value);
+
+    status = crc_start(&ctx, model, table);
+    if (status != OMNI_OK) {
+        return status;
+    }
+
+    status = crc_update(&ctx, data, len);
+    if (status != OMNI_OK) {
+        return status;
+    }
+
+    *value = crc_finish(&ctx);
+
+    return OMNI_OK;
+}
+
+#if defined(CONFIG_OMNI_DRIVER_CRC)
+/********************* Callback functions **********************/
+
+/**
+ * @brief CRC unit update complete callback
+ *
+ * @param event CRC driver event
+ * @param value Register of the unit
+ * @param arg Pointer to context
+ */
+static void crc_unit_done(uint32_t event, uint32_t value, void *arg) {
+    crc_ctx_t *ctx = (crc_ctx_t *)arg;
+
+    if ((event & CRC_EVENT_COMPLETE) != 0U) {
+        ctx->value = crc_from_unit(ctx->model, value);
+        ctx->cb(ctx, OMNI_OK, ctx->arg);
+    } else {
+        ctx->cb(ctx, OMNI_FAIL, ctx->arg);
+    }
+}
+#endif /* CONFIG_OMNI_DRIVER_CRC */
+
+/********************* Private functions **********************/
+
+/**
+ * @brief Reverse the low bits of a value
+ *
+ * @param value Value
+ * @param width Number of bits (1..32)
+ * @return Reflected value
+ */
+static uint32_t crc_reflect(uint32_t value, uint32_t width) {
+    value = ((value >> 1) & 0x55555555U) | ((value & 0x55555555U) << 1);
+    value = ((value >> 2) & 0x33333333U) | ((value & 0x33333333U) << 2);
+    value = ((value >> 4) & 0x0F0F0F0FU) | ((value & 0x0F0F0F0FU) << 4);
+    value = ((value >> 8) & 0x00FF00FFU) | ((value & 0x00FF00FFU) << 8);
+    value = (value >> 16) | (value << 16);
+
+    return value >> (32U - width);
+}
+
+/**
+ * @brief Table code, 8 bytes per step with slice-by-8 tables
+ *
+ * @param ctx Pointer to context
+ * @param data Pointer to data
+ * @param len Length in bytes
+ * @return Updated register
+ */
+static uint32_t crc_table_update(const crc_ctx_t *ctx, const uint8_t *data, uint32_t len) {
+    const uint32_t (*t)[256] = ctx->table->entry;
+    uint32_t value = ctx->value;
+
+    if (ctx->model->reflect_in) {
+#if defined(CONFIG_CRC_SLICE_BY_8)
+        for (; len >= 8U; len -= 8U, data += 8) {
+            uint32_t one = value ^ ((uint32_t)data[0] | ((uint32_t)data[1] << 8) |
+                                    ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24));
+            uint32_t two = (uint32_t)data[4] | ((uint32_t)data[5] << 8) |
+                           ((uint32_t)data[6] << 16) | ((uint32_t)data[7] << 24);
+
+            value = t[7][one & 0xFFU] ^ t[6][(one >> 8) & 0xFFU] ^
+                    t[5][(one >> 16) & 0xFFU] ^ t[4][one >> 24] ^
+                    t[3][two & 0xFFU] ^ t[2][(two >> 8) & 0xFFU] ^
+                    t[1][(two >> 16) & 0xFFU] ^ t[0][two >> 24];
+        }
+#endif /* CONFIG_CRC_SLICE_BY_8 */
+
+        for (; len > 0U; len--) {
+            value = t[0][(value ^ *data++) & 0xFFU] ^ (value >> 8);
+        }
+    } else {
+#if defined(CONFIG_CRC_SLICE_BY_8)
+        for (; len >= 8U; len -= 8U, data += 8) {
+            uint32_t one = value ^ (((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16) |
+                                    ((uint32_t)data[2] << 8) | (uint32_t)data[3]);
+            uint32_t two = ((uint32_t)data[4] << 24) | ((uint32_t)data[5] << 16) |
+                           ((uint32_t)data[6] << 8) | (uint32_t)data[7];
+
+            value = t[7][one >> 24] ^ t[6][(one >> 16) & 0xFFU] ^
+                    t[5][(one >> 8) & 0xFFU] ^ t[4][one & 0xFFU] ^
+                    t[3][two >> 24] ^ t[2][(two >> 16) & 0xFFU] ^
+                    t[1][(two >> 8) & 0xFFU] ^ t[0][two & 0xFFU];
+        }
+#endif /* CONFIG_CRC_SLICE_BY_8 */
+
+        for (; len > 0U; len--) {
+            value = t[0][(value >> 24) ^ *data++] ^ (value << 8);
+        }
+    }
+
+    return value;
+}
+
+#if defined(CONFIG_OMNI_DRIVER_CRC)
+/**
+ * @brief CRC unit configuration of a model
+ *
+ * @param model Pointer to model
+ * @param config Pointer to configuration
+ */
+static void crc_unit_config(const crc_model_t *model, crc_driver_config_t *config) {
+    config->width = model->width;
+    config->poly = model->poly;
+    config->reflect_in = model->reflect_in;
+}
+
+/**
+ * @brief Register of the table code to register of the unit, MSB first
+ *
+ * @param model Pointer to model
+ * @param value Register of the table code
+ * @return Register of the unit
+ */
+static uint32_t crc_to_unit(const crc_model_t *model, uint32_t value) {
+    return model->reflect_in ? crc_reflect(value, model->width) : (value >> (32U - model->width));
+}
+
+/**
+ * @brief Register of the unit to register of the table code
+ *
+ * @param model Pointer to model
+ * @param value Register of the unit, MSB first
+ * @return Register of the table code
+ */
+static uint32_t crc_from_unit(const crc_model_t *model, uint32_t value) {
+    return model->reflect_in ? crc_reflect(value, model->width) : (value << (32U - model->width));
+}
+#endif /* CONFIG_OMNI_DRIVER_CRC */
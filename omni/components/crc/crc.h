@@ -0,0 +1,165 @@
+/**
+  * @file    crc.h
+  * @author  LuckkMaker
+  * @brief   CRC component for omni
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef COMPONENT_CRC_H
+#define COMPONENT_CRC_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "include/device.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * A context holds the running register of one CRC, so any number of CRCs
+ * can be computed over data arriving in pieces. finish returns the CRC of
+ * all data so far and leaves the context running.
+ *
+ * Updates go to the CRC unit when CONFIG_OMNI_DRIVER_CRC is enabled,
+ * crc_driver.init() was called and the unit computes the model: CRC-32
+ * with the polynomial 0x04C11DB7 on STM32F1/F4, 8, 16 and 32 bit models
+ * on STM32H7. Short updates, and updates while the unit is in use, for
+ * example from an interrupt, take the slice-by-8 table code instead. The
+ * table is built once per model by the caller, a context without a table
+ * only runs on the unit.
+ *
+ * @code
+ * static crc_table_t crc32_table;
+ * crc_ctx_t ctx;
+ * uint32_t value;
+ *
+ * crc.init_table(&crc_model_32, &crc32_table);
+ *
+ * crc.start(&ctx, &crc_model_32, &crc32_table);
+ * crc.update(&ctx, header, sizeof(header));
+ * crc.update(&ctx, payload, payload_len);
+ * value = crc.finish(&ctx);
+ * @endcode
+ */
+
+#if defined(CONFIG_CRC_SLICE_BY_8)
+#define CRC_TABLE_SLICES                8U
+#else
+#define CRC_TABLE_SLICES                1U
+#endif /* CONFIG_CRC_SLICE_BY_8 */
+
+/**
+ * @brief CRC model, parameters as in the CRC catalogue
+ */
+typedef struct crc_model {
+    uint32_t width;                 /**< Width in bits (1..32) */
+    uint32_t poly;                  /**< Polynomial, MSB first without the top bit */
+    uint32_t init;                  /**< Initial register, MSB first */
+    bool reflect_in;                /**< Input bytes LSB first */
+    bool reflect_out;               /**< Register reflected before the final XOR */
+    uint32_t xor_out;               /**< Final XOR */
+} crc_model_t;
+
+/**
+ * @brief Common models
+ */
+extern const crc_model_t crc_model_8;           /**< CRC-8/SMBUS */
+extern const crc_model_t crc_model_8_maxim;     /**< CRC-8/MAXIM-DOW, 1-Wire */
+extern const crc_model_t crc_model_16_ccitt;    /**< CRC-16/IBM-3740, CCITT-FALSE */
+extern const crc_model_t crc_model_16_xmodem;   /**< CRC-16/XMODEM */
+extern const crc_model_t crc_model_16_modbus;   /**< CRC-16/MODBUS */
+extern const crc_model_t crc_model_32;          /**< CRC-32/ISO-HDLC, zlib and Ethernet */
+extern const crc_model_t crc_model_32c;         /**< CRC-32/ISCSI, Castagnoli */
+extern const crc_model_t crc_model_32_mpeg2;    /**< CRC-32/MPEG-2, the STM32 CRC unit */
+
+/**
+ * @brief Lookup table of a model
+ */
+typedef struct crc_table {
+    uint32_t entry[CRC_TABLE_SLICES][256];
+} crc_table_t;
+
+struct crc_ctx;
+
+/**
+ * @brief Update callback function, status is OMNI_OK or OMNI_FAIL
+ */
+typedef void (*crc_update_callback)(struct crc_ctx *ctx, int status, void *arg);
+
+/**
+ * @brief CRC context
+ */
+typedef struct crc_ctx {
+    const crc_model_t *model;       /**< Model */
+    const crc_table_t *table;       /**< Table of the model, NULL to use the unit only */
+    uint32_t value;                 /**< Running register, in the bit order of the table code */
+    crc_update_callback cb;         /**< Callback of the update in flight */
+    void *arg;                      /**< Callback argument */
+} crc_ctx_t;
+
+/**
+ * @brief Build the table of a model
+ */
+typedef int (*crc_init_table_t)(const crc_model_t *model, crc_table_t *table);
+
+/**
+ * @brief Start a CRC
+ */
+typedef int (*crc_start_t)(crc_ctx_t *ctx, const crc_model_t *model, const crc_table_t *table);
+
+/**
+ * @brief Add data to a CRC
+ */
+typedef int (*crc_add_t)(crc_ctx_t *ctx, const void *data, uint32_t len);
+
+/**
+ * @brief Add data to a CRC, completion reported by callback
+ */
+typedef int (*crc_add_async_t)(crc_ctx_t *ctx, const void *data, uint32_t len, crc_update_callback cb, void *arg);
+
+/**
+ * @brief Get the CRC of the data so far
+ */
+typedef uint32_t (*crc_finish_t)(const crc_ctx_t *ctx);
+
+/**
+ * @brief Compute the CRC of a buffer
+ */
+typedef int (*crc_compute_t)(const crc_model_t *model, const crc_table_t *table, const void *data, uint32_t len,
+                             uint32_t *value);
+
+/**
+ * @brief CRC API
+ */
+struct crc_api {
+    crc_init_table_t init_table;
+    crc_start_t start;
+    crc_add_t update;
+    crc_add_async_t update_async;
+    crc_finish_t finish;
+    crc_compute_t compute;
+};
+
+extern const struct crc_api crc;
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* COMPONENT_CRC_H */
@@ -0,0 +1,221 @@
+/**
+  * @file    dlog.c
+  * @author  LuckkMaker
+  * @brief   Deferred log component for omni
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "dlog/dlog.h"
+#if defined(CONFIG_DLOG_RTT)
+#include "SEGGER_RTT.h"
+#endif /* CONFIG_DLOG_RTT */
+
+#define DLOG_BUFFER_MASK        (CONFIG_DLOG_BUFFER_SIZE - 1U)
+
+#if ((CONFIG_DLOG_BUFFER_SIZE & DLOG_BUFFER_MASK) != 0) || (CONFIG_DLOG_BUFFER_SIZE < 64)
+#error "CONFIG_DLOG_BUFFER_SIZE must be a power of two of at least 64"
+#endif
+
+// Frames are whole words, so the head always stays word aligned
+static uint8_t dlog_buffer[CONFIG_DLOG_BUFFER_SIZE] __attribute__((aligned(4)));
+static volatile uint32_t dlog_head = 0;
+static volatile uint32_t dlog_tail = 0;
+static volatile uint32_t dlog_lost = 0;
+static uint32_t dlog_lost_reported = 0;
+static volatile uint32_t dlog_enabled = 0;
+static dlog_write_t dlog_output = NULL;
+
+#if defined(CONFIG_DLOG_RTT)
+static uint8_t dlog_rtt_buffer[CONFIG_DLOG_RTT_BUFFER_SIZE];
+#endif /* CONFIG_DLOG_RTT */
+
+static int dlog_start(dlog_write_t write);
+static void dlog_stop(void);
+static uint32_t dlog_flush(void);
+static uint32_t dlog_get_lost(void);
+
+const struct dlog_api dlog = {
+    .start = dlog_start,
+    .stop = dlog_stop,
+    .flush = dlog_flush,
+    .get_lost = dlog_get_lost,
+};
+
+static void dlog_push(uint32_t header, const uint32_t *args, uint32_t num);
+#if defined(CONFIG_DLOG_RTT)
+static uint32_t dlog_rtt_write(const void *data, uint32_t len);
+#endif /* CONFIG_DLOG_RTT */
+
+/**
+ * @brief Record a log frame
+ *
+ * @note Used by the DLOG macros. Safe to call from threads and interrupts,
+ *       interrupts are only masked while the words are copied.
+ * @param header Frame header
+ * @param args Pointer to arguments
+ * @param num Number of arguments
+ */
+void dlog_record(uint32_t header, const uint32_t *args, uint32_t num) {
+    if (!dlog_enabled) {
+        return;
+    }
+
+    dlog_push(header, args, num);
+}
+
+/**
+ * @brief Start logging
+ *
+ * @param write Output function, NULL to use the Segger RTT up channel
+ * @return Operation status
+ */
+static int dlog_start(dlog_write_t write) {
+#if defined(CONFIG_DLOG_RTT)
+    if (write == NULL) {
+        SEGGER_RTT_ConfigUpBuffer(CONFIG_DLOG_RTT_CHANNEL, "omni-dlog", dlog_rtt_buffer, \
+            sizeof(dlog_rtt_buffer), SEGGER_RTT_MODE_NO_BLOCK_TRIM);
+        write = dlog_rtt_write;
+    }
+#endif /* CONFIG_DLOG_RTT */
+
+    if (write == NULL) {
+        return OMNI_FAIL;
+    }
+
+    dlog_enabled = 0;
+    dlog_head = 0;
+    dlog_tail = 0;
+    dlog_lost = 0;
+    dlog_lost_reported = 0;
+    dlog_output = write;
+    dlog_enabled = 1;
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Stop logging
+ *
+ * @note Frames already buffered can still be drained with dlog.flush().
+ */
+static void dlog_stop(void) {
+    dlog_enabled = 0;
+}
+
+/**
+ * @brief Drain buffered frames to the output
+ *
+ * @note Call from a single low priority context. Bytes the output does not
+ *       accept stay buffered for the next call.
+ * @return Number of bytes drained
+ */
+static uint32_t dlog_flush(void) {
+    uint32_t head;
+    uint32_t offset;
+    uint32_t len;
+    uint32_t written;
+    uint32_t lost;
+    uint32_t count = 0;
+
+    if (dlog_output == NULL) {
+        return 0;
+    }
+
+    lost = dlog_lost;
+    if (lost != dlog_lost_reported) {
+        dlog_lost_reported = lost;
+        dlog_push(DLOG_HEADER(0, 1, DLOG_LEVEL_LOST), &lost, 1);
+    }
+
+    head = dlog_head;
+    while (dlog_tail != head) {
+        offset = dlog_tail & DLOG_BUFFER_MASK;
+        len = head - dlog_tail;
+        // Write up to the end of the buffer, the rest in the next round
+        if (len > (CONFIG_DLOG_BUFFER_SIZE - offset)) {
+            len = CONFIG_DLOG_BUFFER_SIZE - offset;
+        }
+
+        written = dlog_output(&dlog_buffer[offset], len);
+        dlog_tail = dlog_tail + written;
+        count += written;
+
+        if (written < len) {
+            break;
+        }
+    }
+
+    return count;
+}
+
+/**
+ * @brief Get number of lost frames
+ *
+ * @return Number of frames dropped because the buffer was full
+ */
+static uint32_t dlog_get_lost(void) {
+    return dlog_lost;
+}
+
+/********************* Private functions **********************/
+
+/**
+ * @brief Copy a frame into the buffer
+ *
+ * @param header Frame header
+ * @param args Pointer to arguments
+ * @param num Number of arguments
+ */
+static void dlog_push(uint32_t header, const uint32_t *args, uint32_t num) {
+    uint32_t primask;
+    uint32_t head;
+    uint32_t size = (num + 1U) * sizeof(uint32_t);
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    head = dlog_head;
+    if ((CONFIG_DLOG_BUFFER_SIZE - (head - dlog_tail)) < size) {
+        dlog_lost = dlog_lost + 1U;
+        __set_PRIMASK(primask);
+        return;
+    }
+
+    *(uint32_t *)&dlog_buffer[head & DLOG_BUFFER_MASK] = header;
+    for (uint32_t i = 0; i < num; i++) {
+        head += sizeof(uint32_t);
+        *(uint32_t *)&dlog_buffer[head & DLOG_BUFFER_MASK] = args[i];
+    }
+    dlog_head = head + sizeof(uint32_t);
+
+    __set_PRIMASK(primask);
+}
+
+#if defined(CONFIG_DLOG_RTT)
+/**
+ * @brief Write frames to the RTT up channel
+ *
+ * @param data Pointer to data
+ * @param len Length of data
+ * @return Number of bytes written
+ */
+static uint32_t dlog_rtt_write(const void *data, uint32_t len) {
+    return SEGGER_RTT_Write(CONFIG_DLOG_RTT_CHANNEL, data, len);
+}
+#endif /* CONFIG_DLOG_RTT */
@@ -0,0 +1,183 @@
+/**
+  * @file    dlog.h
+  * @author  LuckkMaker
+  * @brief   Deferred log component for omni
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef COMPONENT_DLOG_H
+#define COMPONENT_DLOG_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "include/device.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Format strings are never formatted on the device. Each one is placed in
+ * the .omni_log section, which the GCC linker scripts keep in the ELF but
+ * not in the flash image, and its offset in that section is the string ID. A log call
+ * only copies the ID and its raw arguments into a RAM ring, dlog.flush()
+ * sends them out from a low priority context and
+ * tools/python/dlog_decoder.py rebuilds the text from the ELF.
+ *
+ * Frame layout, little endian 32-bit words:
+ *   word 0: string ID (bits 0-19), argument count (bits 20-23),
+ *           level (bits 24-26), DLOG_MARKER (bits 27-31)
+ *   word 1..n: arguments
+ *
+ * Arguments are sent as 32-bit words, so %f and 64-bit integers are not
+ * supported. %s is resolved by the decoder when the pointer refers to a
+ * string constant in the ELF.
+ *
+ * @code
+ * DLOG_INFO("spi%u transfer %u bytes in %u us", spi_num, len, us);
+ * @endcode
+ */
+
+#define DLOG_LEVEL_ERROR            1U
+#define DLOG_LEVEL_WARNING          2U
+#define DLOG_LEVEL_INFO             3U
+#define DLOG_LEVEL_DEBUG            4U
+#define DLOG_LEVEL_LOST             7U      /**< Argument holds number of lost frames */
+
+#define DLOG_MARKER                 0x1AU
+#define DLOG_ARG_MAX                8U
+
+#define DLOG_HEADER(id, num, level) \
+    (((uint32_t)(id) & 0xFFFFFU) | ((uint32_t)(num) << 20U) | ((uint32_t)(level) << 24U) | (DLOG_MARKER << 27U))
+
+#if defined(CONFIG_COMPONENT_DLOG)
+
+// armlink places every allocated section in a load region, the scatter
+// files have no equivalent of the non-loaded .omni_log INFO section
+#if defined(__ARMCC_VERSION)
+#error "Deferred log needs the .omni_log INFO section of the GCC linker scripts"
+#endif /* __ARMCC_VERSION */
+
+/**
+ * @brief Log write function, returns number of bytes accepted
+ */
+typedef uint32_t (*dlog_write_t)(const void *data, uint32_t len);
+
+/**
+ * @brief Start logging
+ */
+typedef int (*dlog_start_t)(dlog_write_t write);
+
+/**
+ * @brief Stop logging
+ */
+typedef void (*dlog_stop_t)(void);
+
+/**
+ * @brief Drain buffered frames to the output
+ */
+typedef uint32_t (*dlog_flush_t)(void);
+
+/**
+ * @brief Get number of lost frames
+ */
+typedef uint32_t (*dlog_get_lost_t)(void);
+
+/**
+ * @brief Deferred log API
+ */
+struct dlog_api {
+    dlog_start_t start;
+    dlog_stop_t stop;
+    dlog_flush_t flush;
+    dlog_get_lost_t get_lost;
+};
+
+extern const struct dlog_api dlog;
+
+void dlog_record(uint32_t header, const uint32_t *args, uint32_t num);
+
+#define DLOG_STRINGIFY_(x)          #x
+#define DLOG_STRINGIFY(x)           DLOG_STRINGIFY_(x)
+#define DLOG_CAT_(a, b)             a##b
+#define DLOG_CAT(a, b)              DLOG_CAT_(a, b)
+
+#define DLOG_NARG(...)              DLOG_NARG_(_, ##__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define DLOG_NARG_(_0, _1, _2, _3, _4, _5, _6, _7, _8, n, ...) n
+
+#define DLOG_WORD(x)                ((uint32_t)(uintptr_t)(x))
+#define DLOG_ARGS_0()
+#define DLOG_ARGS_1(a)              , DLOG_WORD(a)
+#define DLOG_ARGS_2(a, ...)         , DLOG_WORD(a) DLOG_ARGS_1(__VA_ARGS__)
+#define DLOG_ARGS_3(a, ...)         , DLOG_WORD(a) DLOG_ARGS_2(__VA_ARGS__)
+#define DLOG_ARGS_4(a, ...)         , DLOG_WORD(a) DLOG_ARGS_3(__VA_ARGS__)
+#define DLOG_ARGS_5(a, ...)         , DLOG_WORD(a) DLOG_ARGS_4(__VA_ARGS__)
+#define DLOG_ARGS_6(a, ...)         , DLOG_WORD(a) DLOG_ARGS_5(__VA_ARGS__)
+#define DLOG_ARGS_7(a, ...)         , DLOG_WORD(a) DLOG_ARGS_6(__VA_ARGS__)
+#define DLOG_ARGS_8(a, ...)         , DLOG_WORD(a) DLOG_ARGS_7(__VA_ARGS__)
+#define DLOG_ARGS(...)              DLOG_CAT(DLOG_ARGS_, DLOG_NARG(__VA_ARGS__))(__VA_ARGS__)
+
+/**
+ * @brief Log a format string with up to DLOG_ARG_MAX arguments
+ *
+ * @note The location is stored after the format string, so it costs no
+ *       bandwidth and no flash.
+ */
+#define DLOG(level, fmt, ...) do { \
+    static const char dlog_fmt[] __attribute__((section(".omni_log"), used)) = \
+        fmt "\0" __FILE__ ":" DLOG_STRINGIFY(__LINE__); \
+    const uint32_t dlog_args[] = { 0U DLOG_ARGS(__VA_ARGS__) }; \
+    dlog_record(DLOG_HEADER((uintptr_t)dlog_fmt, DLOG_NARG(__VA_ARGS__), (level)), \
+        &dlog_args[1], DLOG_NARG(__VA_ARGS__)); \
+} while (0)
+
+#else
+
+#define DLOG(level, fmt, ...)       do {} while (0)
+
+#endif /* CONFIG_COMPONENT_DLOG */
+
+#if defined(CONFIG_COMPONENT_DLOG) && (CONFIG_DLOG_LEVEL >= 1)
+#define DLOG_ERROR(fmt, ...)        DLOG(DLOG_LEVEL_ERROR, fmt, ##__VA_ARGS__)
+#else
+#define DLOG_ERROR(fmt, ...)        do {} while (0)
+#endif
+
+#if defined(CONFIG_COMPONENT_DLOG) && (CONFIG_DLOG_LEVEL >= 2)
+#define DLOG_WARNING(fmt, ...)      DLOG(DLOG_LEVEL_WARNING, fmt, ##__VA_ARGS__)
+#else
+#define DLOG_WARNING(fmt, ...)      do {} while (0)
+#endif
+
+#if defined(CONFIG_COMPONENT_DLOG) && (CONFIG_DLOG_LEVEL >= 3)
+#define DLOG_INFO(fmt, ...)         DLOG(DLOG_LEVEL_INFO, fmt, ##__VA_ARGS__)
+#else
+#define DLOG_INFO(fmt, ...)         do {} while (0)
+#endif
+
+#if defined(CONFIG_COMPONENT_DLOG) && (CONFIG_DLOG_LEVEL >= 4)
+#define DLOG_DEBUG(fmt, ...)        DLOG(DLOG_LEVEL_DEBUG, fmt, ##__VA_ARGS__)
+#else
+#define DLOG_DEBUG(fmt, ...)        do {} while (0)
+#endif
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* COMPONENT_DLOG_H */
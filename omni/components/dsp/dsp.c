@@ -0,0 +1,1172 @@
+/**
+  * @file    dsp.c
+  * @author  LuckkMaker
+  * @brief   DSP kernel component for omni
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "dsp/dsp.h"
+
+// SIMD kernels need the DSP extension, Cortex-M4/M7
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1) && defined(__SMLALD) && !defined(CONFIG_DSP_REFERENCE)
+#define DSP_SIMD                        1
+#else
+#define DSP_SIMD                        0
+#endif
+
+#if defined(CONFIG_DSP_FAST_CODE)
+#define DSP_FAST                        OMNI_FAST_CODE
+#else
+#define DSP_FAST
+#endif /* CONFIG_DSP_FAST_CODE */
+
+#define DSP_PI                          3.14159265358979323846
+
+static int dsp_fir_q15_init(dsp_fir_q15_t *fir, uint32_t num_taps, const q15_t *coeffs, q15_t *state, uint32_t block_size);
+static void dsp_fir_q15(dsp_fir_q15_t *fir, const q15_t *in, q15_t *out, uint32_t len);
+static int dsp_fir_q31_init(dsp_fir_q31_t *fir, uint32_t num_taps, const q31_t *coeffs, q31_t *state, uint32_t block_size);
+static void dsp_fir_q31(dsp_fir_q31_t *fir, const q31_t *in, q31_t *out, uint32_t len);
+static int dsp_fir_f32_init(dsp_fir_f32_t *fir, uint32_t num_taps, const float *coeffs, float *state, uint32_t block_size);
+static void dsp_fir_f32(dsp_fir_f32_t *fir, const float *in, float *out, uint32_t len);
+static int dsp_biquad_q15_init(dsp_biquad_q15_t *biquad, uint32_t num_stages, const q15_t *coeffs, q15_t *state, uint32_t post_shift);
+static void dsp_biquad_q15(dsp_biquad_q15_t *biquad, const q15_t *in, q15_t *out, uint32_t len);
+static int dsp_biquad_q31_init(dsp_biquad_q31_t *biquad, uint32_t num_stages, const q31_t *coeffs, q31_t *state, uint32_t post_shift);
+static void dsp_biquad_q31(dsp_biquad_q31_t *biquad, const q31_t *in, q31_t *out, uint32_t len);
+static int dsp_biquad_f32_init(dsp_biquad_f32_t *biquad, uint32_t num_stages, const float *coeffs, float *state);
+static void dsp_biquad_f32(dsp_biquad_f32_t *biquad, const float *in, float *out, uint32_t len);
+static int dsp_rfft_q15_init(dsp_rfft_q15_t *rfft, uint32_t n, q15_t *twiddle);
+static void dsp_rfft_q15(dsp_rfft_q15_t *rfft, q15_t *in, q15_t *out);
+static int dsp_rfft_q31_init(dsp_rfft_q31_t *rfft, uint32_t n, q31_t *twiddle);
+static void dsp_rfft_q31(dsp_rfft_q31_t *rfft, q31_t *in, q31_t *out);
+static int dsp_rfft_f32_init(dsp_rfft_f32_t *rfft, uint32_t n, float *twiddle);
+static void dsp_rfft_f32(dsp_rfft_f32_t *rfft, float *in, float *out);
+
+const struct dsp_api dsp = {
+    .fir_q15_init = dsp_fir_q15_init,
+    .fir_q15 = dsp_fir_q15,
+    .fir_q31_init = dsp_fir_q31_init,
+    .fir_q31 = dsp_fir_q31,
+    .fir_f32_init = dsp_fir_f32_init,
+    .fir_f32 = dsp_fir_f32,
+    .biquad_q15_init = dsp_biquad_q15_init,
+    .biquad_q15 = dsp_biquad_q15,
+    .biquad_q31_init = dsp_biquad_q31_init,
+    .biquad_q31 = dsp_biquad_q31,
+    .biquad_f32_init = dsp_biquad_f32_init,
+    .biquad_f32 = dsp_biquad_f32,
+    .rfft_q15_init = dsp_rfft_q15_init,
+    .rfft_q15 = dsp_rfft_q15,
+    .rfft_q31_init = dsp_rfft_q31_init,
+    .rfft_q31 = dsp_rfft_q31,
+    .rfft_f32_init = dsp_rfft_f32_init,
+    .rfft_f32 = dsp_rfft_f32,
+};
+
+/* Helper functions ----------------------------------------------------------*/
+// Two Q15 values in one word, first in the low half as a 32 bit load gives it
+static inline uint32_t dsp_read_q15x2(const q15_t *p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline void dsp_write_q15x2(q15_t *p, uint32_t v) {
+    memcpy(p, &v, sizeof(v));
+}
+
+static inline q15_t dsp_sat_q15(int64_t v) {
+    if (v > INT16_MAX) {
+        return INT16_MAX;
+    } else if (v < INT16_MIN) {
+        return INT16_MIN;
+    }
+
+    return (q15_t)v;
+}
+
+static inline q31_t dsp_sat_q31(int64_t v) {
+    if (v > INT32_MAX) {
+        return INT32_MAX;
+    } else if (v < INT32_MIN) {
+        return INT32_MIN;
+    }
+
+    return (q31_t)v;
+}
+
+/*
+ * Packed Q15 operations of the FFT. The C versions give the same results
+ * as the instructions, halving operations round towards minus infinity.
+ */
+#if DSP_SIMD
+#define dsp_shadd16(x, y)               ((uint32_t)__SHADD16((x), (y)))
+#define dsp_shsub16(x, y)               ((uint32_t)__SHSUB16((x), (y)))
+#define dsp_shasx(x, y)                 ((uint32_t)__SHASX((x), (y)))
+#define dsp_shsax(x, y)                 ((uint32_t)__SHSAX((x), (y)))
+#define dsp_pack_lo_hi(lo, hi)          ((uint32_t)__PKHBT((lo), (hi), 0))
+#define dsp_smuad(x, y)                 ((int32_t)__SMUAD((x), (y)))
+#define dsp_smusdx(x, y)                ((int32_t)__SMUSDX((x), (y)))
+#else
+static inline int32_t dsp_lo(uint32_t x) {
+    return (int16_t)(x & 0xFFFFU);
+}
+
+static inline int32_t dsp_hi(uint32_t x) {
+    return (int16_t)(x >> 16);
+}
+
+static inline uint32_t dsp_pack(int32_t lo, int32_t hi) {
+    return ((uint32_t)lo & 0xFFFFU) | ((uint32_t)hi << 16);
+}
+
+static inline uint32_t dsp_shadd16(uint32_t x, uint32_t y) {
+    return dsp_pack((dsp_lo(x) + dsp_lo(y)) >> 1, (dsp_hi(x) + dsp_hi(y)) >> 1);
+}
+
+static inline uint32_t dsp_shsub16(uint32_t x, uint32_t y) {
+    return dsp_pack((dsp_lo(x) - dsp_lo(y)) >> 1, (dsp_hi(x) - dsp_hi(y)) >> 1);
+}
+
+static inline uint32_t dsp_shasx(uint32_t x, uint32_t y) {
+    return dsp_pack((dsp_lo(x) - dsp_hi(y)) >> 1, (dsp_hi(x) + dsp_lo(y)) >> 1);
+}
+
+static inline uint32_t dsp_shsax(uint32_t x, uint32_t y) {
+    return dsp_pack((dsp_lo(x) + dsp_hi(y)) >> 1, (dsp_hi(x) - dsp_lo(y)) >> 1);
+}
+
+static inline uint32_t dsp_pack_lo_hi(uint32_t lo, uint32_t hi) {
+    return (lo & 0xFFFFU) | (hi & 0xFFFF0000U);
+}
+
+static inline int32_t dsp_smuad(uint32_t x, uint32_t y) {
+    return dsp_lo(x) * dsp_lo(y) + dsp_hi(x) * dsp_hi(y);
+}
+
+static inline int32_t dsp_smusdx(uint32_t x, uint32_t y) {
+    return dsp_lo(x) * dsp_hi(y) - dsp_hi(x) * dsp_lo(y);
+}
+#endif /* DSP_SIMD */
+
+/*
+ * x * conj(w) of packed Q15 (re, im) and (cos, sin). Twiddles stay within
+ * +-32767, so the dual products cannot overflow.
+ */
+static inline uint32_t dsp_cmul_q15(uint32_t x, uint32_t w) {
+    q15_t re = dsp_sat_q15(dsp_smuad(x, w) >> 15);
+    q15_t im = dsp_sat_q15(dsp_smusdx(w, x) >> 15);
+    return ((uint32_t)(uint16_t)re) | ((uint32_t)(uint16_t)im << 16);
+}
+
+// -j * d * conj(w), the odd part of the real FFT split
+static inline uint32_t dsp_cmul_odd_q15(uint32_t d, uint32_t w) {
+    q15_t re = dsp_sat_q15(dsp_smusdx(w, d) >> 15);
+    q15_t im = dsp_sat_q15(-(int64_t)dsp_smuad(d, w) >> 15);
+    return ((uint32_t)(uint16_t)re) | ((uint32_t)(uint16_t)im << 16);
+}
+
+static inline q31_t dsp_half_add_q31(q31_t x, q31_t y) {
+    return (q31_t)(((int64_t)x + y) >> 1);
+}
+
+static inline q31_t dsp_half_sub_q31(q31_t x, q31_t y) {
+    return (q31_t)(((int64_t)x - y) >> 1);
+}
+
+static inline uint32_t dsp_log2(uint32_t n) {
+    uint32_t bits = 0;
+
+    while ((n >> bits) > 1U) {
+        bits++;
+    }
+
+    return bits;
+}
+
+/* Private functions ---------------------------------------------------------*/
+/**
+ * @brief Sine and cosine of 2 pi k / n
+ *
+ * Taylor series on the first octant in double, so every target gets the
+ * same table regardless of its math library. n is a multiple of 8.
+ *
+ * @param k Angle index
+ * @param n Angles per turn
+ * @param c Pointer to cosine
+ * @param s Pointer to sine
+ */
+static void dsp_sincos(uint32_t k, uint32_t n, double *c, double *s) {
+    uint32_t quarter = n / 4;
+    uint32_t quadrant = (k / quarter) & 3U;
+    uint32_t r = k % quarter;
+    bool swap = (r > quarter / 2);
+    double x;
+    double x2;
+    double term;
+    double sin_x;
+    double cos_x;
+    double oct_c;
+    double oct_s;
+
+    if (swap) {
+        r = quarter - r;
+    }
+
+    x = 2.0 * DSP_PI * (double)r / (double)n;
+    x2 = x * x;
+
+    sin_x = x;
+    term = x;
+    cos_x = 1.0;
+    for (uint32_t i = 1; i <= 10; i++) {
+        term *= -x2 / (double)((2 * i) * (2 * i + 1));
+        sin_x += term;
+    }
+
+    term = 1.0;
+    for (uint32_t i = 1; i <= 10; i++) {
+        term *= -x2 / (double)((2 * i - 1) * (2 * i));
+        cos_x += term;
+    }
+
+    oct_c = swap ? sin_x : cos_x;
+    oct_s = swap ? cos_x : sin_x;
+
+    switch (quadrant) {
+        case 0:
+            *c = oct_c;
+            *s = oct_s;
+            break;
+        case 1:
+            *c = -oct_s;
+            *s = oct_c;
+            break;
+        case 2:
+            *c = -oct_c;
+            *s = -oct_s;
+            break;
+        default:
+            *c = oct_s;
+            *s = -oct_c;
+            break;
+    }
+}
+
+/**
+ * @brief Convert to fixed point, rounded and kept within +-(2^bits - 1)
+ */
+static int32_t dsp_to_fixed(double v, uint32_t bits) {
+    double max = (double)((1UL << bits) - 1U);
+    double scaled = v * (double)(1UL << bits);
+
+    if (scaled > max) {
+        scaled = max;
+    } else if (scaled < -max) {
+        scaled = -max;
+    }
+
+    return (int32_t)((scaled >= 0.0) ? (scaled + 0.5) : (scaled - 0.5));
+}
+
+static bool dsp_rfft_len_valid(uint32_t n) {
+    return (n >= DSP_RFFT_MIN_LEN) && (n <= DSP_RFFT_MAX_LEN) && ((n & (n - 1U)) == 0);
+}
+
+/**
+ * @brief Put m complex values of size bytes into bit reversed order
+ */
+static inline void dsp_bit_reverse(void *buf, uint32_t m, size_t size) {
+    uint8_t *p = buf;
+    uint8_t tmp[8];
+    uint32_t j = 0;
+
+    for (uint32_t i = 0; i < m; i++) {
+        uint32_t bit = m >> 1;
+
+        if (i < j) {
+            memcpy(tmp, &p[i * size], size);
+            memcpy(&p[i * size], &p[j * size], size);
+            memcpy(&p[j * size], tmp, size);
+        }
+
+        while ((j & bit) != 0) {
+            j ^= bit;
+            bit >>= 1;
+        }
+        j |= bit;
+    }
+}
+
+/*
+ * Complex FFTs of m = n / 2 points, decimation in frequency. A radix-2
+ * stage comes first when log2(m) is odd, radix-4 stages follow. Each
+ * radix-4 butterfly stores its outputs in the order 0, 2, 1, 3, so the
+ * result is in plain bit reversed order. Twiddles of a stage of length L
+ * are W_L^i = W_n^(i * n / L), all within the first 3n/4 of the table.
+ * Q15 and Q31 stages divide by their radix, the result is scaled 1/m.
+ */
+static DSP_FAST void dsp_cfft_q15(q15_t *buf, uint32_t m, const q15_t *twiddle, uint32_t n) {
+    uint32_t len = m;
+
+    if ((dsp_log2(m) & 1U) != 0) {
+        uint32_t half = len / 2;
+        uint32_t step = n / len;
+
+        for (uint32_t i = 0; i < half; i++) {
+            uint32_t a = dsp_read_q15x2(&buf[2 * i]);
+            uint32_t b = dsp_read_q15x2(&buf[2 * (i + half)]);
+            uint32_t d = dsp_shsub16(a, b);
+
+            if (i != 0) {
+                d = dsp_cmul_q15(d, dsp_read_q15x2(&twiddle[2 * i * step]));
+            }
+
+            dsp_write_q15x2(&buf[2 * i], dsp_shadd16(a, b));
+            dsp_write_q15x2(&buf[2 * (i + half)], d);
+        }
+
+        len = half;
+    }
+
+    for (; len >= 4; len /= 4) {
+        uint32_t quarter = len / 4;
+        uint32_t step = n / len;
+
+        for (uint32_t i = 0; i < quarter; i++) {
+            uint32_t w1 = dsp_read_q15x2(&twiddle[2 * i * step]);
+            uint32_t w2 = dsp_read_q15x2(&twiddle[4 * i * step]);
+            uint32_t w3 = dsp_read_q15x2(&twiddle[6 * i * step]);
+
+            for (uint32_t g = i; g < m; g += len) {
+                q15_t *p0 = &buf[2 * g];
+                q15_t *p1 = p0 + 2 * quarter;
+                q15_t *p2 = p1 + 2 * quarter;
+                q15_t *p3 = p2 + 2 * quarter;
+                uint32_t a = dsp_read_q15x2(p0);
+                uint32_t b = dsp_read_q15x2(p1);
+                uint32_t c = dsp_read_q15x2(p2);
+                uint32_t d = dsp_read_q15x2(p3);
+                uint32_t t0 = dsp_shadd16(a, c);
+                uint32_t t1 = dsp_shsub16(a, c);
+                uint32_t t2 = dsp_shadd16(b, d);
+                uint32_t t3 = dsp_shsub16(b, d);
+                uint32_t x0 = dsp_shadd16(t0, t2);
+                uint32_t x2 = dsp_shsub16(t0, t2);
+                uint32_t x1 = dsp_shsax(t1, t3);   // t1 - j t3
+                uint32_t x3 = dsp_shasx(t1, t3);   // t1 + j t3
+
+                if (i != 0) {
+                    x1 = dsp_cmul_q15(x1, w1);
+                    x2 = dsp_cmul_q15(x2, w2);
+                    x3 = dsp_cmul_q15(x3, w3);
+                }
+
+                dsp_write_q15x2(p0, x0);
+                dsp_write_q15x2(p1, x2);
+                dsp_write_q15x2(p2, x1);
+                dsp_write_q15x2(p3, x3);
+            }
+        }
+    }
+
+    dsp_bit_reverse(buf, m, sizeof(uint32_t));
+}
+
+static inline void dsp_cmul_q31(q31_t *re, q31_t *im, const q31_t *w) {
+    int64_t a = *re;
+    int64_t b = *im;
+
+    *re = dsp_sat_q31((a * w[0] + b * w[1]) >> 31);
+    *im = dsp_sat_q31((b * w[0] - a * w[1]) >> 31);
+}
+
+static DSP_FAST void dsp_cfft_q31(q31_t *buf, uint32_t m, const q31_t *twiddle, uint32_t n) {
+    uint32_t len = m;
+
+    if ((dsp_log2(m) & 1U) != 0) {
+        uint32_t half = len / 2;
+        uint32_t step = n / len;
+
+        for (uint32_t i = 0; i < half; i++) {
+            q31_t *p0 = &buf[2 * i];
+            q31_t *p1 = &buf[2 * (i + half)];
+            q31_t d_re = dsp_half_sub_q31(p0[0], p1[0]);
+            q31_t d_im = dsp_half_sub_q31(p0[1], p1[1]);
+
+            if (i != 0) {
+                dsp_cmul_q31(&d_re, &d_im, &twiddle[2 * i * step]);
+            }
+
+            p0[0] = dsp_half_add_q31(p0[0], p1[0]);
+            p0[1] = dsp_half_add_q31(p0[1], p1[1]);
+            p1[0] = d_re;
+            p1[1] = d_im;
+        }
+
+        len = half;
+    }
+
+    for (; len >= 4; len /= 4) {
+        uint32_t quarter = len / 4;
+        uint32_t step = n / len;
+
+        for (uint32_t i = 0; i < quarter; i++) {
+            const q31_t *w1 = &twiddle[2 * i * step];
+            const q31_t *w2 = &twiddle[4 * i * step];
+            const q31_t *w3 = &twiddle[6 * i * step];
+
+            for (uint32_t g = i; g < m; g += len) {
+                q31_t *p0 = &buf[2 * g];
+                q31_t *p1 = p0 + 2 * quarter;
+                q31_t *p2 = p1 + 2 * quarter;
+                q31_t *p3 = p2 + 2 * quarter;
+                q31_t t0_re = dsp_half_add_q31(p0[0], p2[0]);
+                q31_t t0_im = dsp_half_add_q31(p0[1], p2[1]);
+                q31_t t1_re = dsp_half_sub_q31(p0[0], p2[0]);
+                q31_t t1_im = dsp_half_sub_q31(p0[1], p2[1]);
+                q31_t t2_re = dsp_half_add_q31(p1[0], p3[0]);
+                q31_t t2_im = dsp_half_add_q31(p1[1], p3[1]);
+                q31_t t3_re = dsp_half_sub_q31(p1[0], p3[0]);
+                q31_t t3_im = dsp_half_sub_q31(p1[1], p3[1]);
+                q31_t x1_re = dsp_half_add_q31(t1_re, t3_im);
+                q31_t x1_im = dsp_half_sub_q31(t1_im, t3_re);
+                q31_t x2_re = dsp_half_sub_q31(t0_re, t2_re);
+                q31_t x2_im = dsp_half_sub_q31(t0_im, t2_im);
+                q31_t x3_re = dsp_half_sub_q31(t1_re, t3_im);
+                q31_t x3_im = dsp_half_add_q31(t1_im, t3_re);
+
+                if (i != 0) {
+                    dsp_cmul_q31(&x1_re, &x1_im, w1);
+                    dsp_cmul_q31(&x2_re, &x2_im, w2);
+                    dsp_cmul_q31(&x3_re, &x3_im, w3);
+                }
+
+                p0[0] = dsp_half_add_q31(t0_re, t2_re);
+                p0[1] = dsp_half_add_q31(t0_im, t2_im);
+                p1[0] = x2_re;
+                p1[1] = x2_im;
+                p2[0] = x1_re;
+                p2[1] = x1_im;
+                p3[0] = x3_re;
+                p3[1] = x3_im;
+            }
+        }
+    }
+
+    dsp_bit_reverse(buf, m, 2 * sizeof(q31_t));
+}
+
+static inline void dsp_cmul_f32(float *re, float *im, const float *w) {
+    float a = *re;
+    float b = *im;
+
+    *re = a * w[0] + b * w[1];
+    *im = b * w[0] - a * w[1];
+}
+
+static DSP_FAST void dsp_cfft_f32(float *buf, uint32_t m, const float *twiddle, uint32_t n) {
+    uint32_t len = m;
+
+    if ((dsp_log2(m) & 1U) != 0) {
+        uint32_t half = len / 2;
+        uint32_t step = n / len;
+
+        for (uint32_t i = 0; i < half; i++) {
+            float *p0 = &buf[2 * i];
+            float *p1 = &buf[2 * (i + half)];
+            float d_re = p0[0] - p1[0];
+            float d_im = p0[1] - p1[1];
+
+            if (i != 0) {
+                dsp_cmul_f32(&d_re, &d_im, &twiddle[2 * i * step]);
+            }
+
+            p0[0] = p0[0] + p1[0];
+            p0[1] = p0[1] + p1[1];
+            p1[0] = d_re;
+            p1[1] = d_im;
+        }
+
+        len = half;
+    }
+
+    for (; len >= 4; len /= 4) {
+        uint32_t quarter = len / 4;
+        uint32_t step = n / len;
+
+        for (uint32_t i = 0; i < quarter; i++) {
+            const float *w1 = &twiddle[2 * i * step];
+            const float *w2 = &twiddle[4 * i * step];
+            const float *w3 = &twiddle[6 * i * step];
+
+            for (uint32_t g = i; g < m; g += len) {
+                float *p0 = &buf[2 * g];
+                float *p1 = p0 + 2 * quarter;
+                float *p2 = p1 + 2 * quarter;
+                float *p3 = p2 + 2 * quarter;
+                float t0_re = p0[0] + p2[0];
+                float t0_im = p0[1] + p2[1];
+                float t1_re = p0[0] - p2[0];
+                float t1_im = p0[1] - p2[1];
+                float t2_re = p1[0] + p3[0];
+                float t2_im = p1[1] + p3[1];
+                float t3_re = p1[0] - p3[0];
+                float t3_im = p1[1] - p3[1];
+                float x1_re = t1_re + t3_im;
+                float x1_im = t1_im - t3_re;
+                float x2_re = t0_re - t2_re;
+                float x2_im = t0_im - t2_im;
+                float x3_re = t1_re - t3_im;
+                float x3_im = t1_im + t3_re;
+
+                if (i != 0) {
+                    dsp_cmul_f32(&x1_re, &x1_im, w1);
+                    dsp_cmul_f32(&x2_re, &x2_im, w2);
+                    dsp_cmul_f32(&x3_re, &x3_im, w3);
+                }
+
+                p0[0] = t0_re + t2_re;
+                p0[1] = t0_im + t2_im;
+                p1[0] = x2_re;
+                p1[1] = x2_im;
+                p2[0] = x1_re;
+                p2[1] = x1_im;
+                p3[0] = x3_re;
+                p3[1] = x3_im;
+            }
+        }
+    }
+
+    dsp_bit_reverse(buf, m, 2 * sizeof(float));
+}
+
+/* FIR filters ---------------------------------------------------------------*/
+/**
+ * @brief Initialize FIR filter
+ *
+ * @param fir Pointer to FIR instance
+ * @param num_taps Number of taps
+ * @param coeffs Pointer to coefficients, time reversed
+ * @param state Pointer to state, DSP_FIR_STATE_LEN(num_taps, block_size) samples
+ * @param block_size Maximum samples per call
+ * @return int OMNI_OK if success, OMNI_FAIL on a bad argument
+ */
+static int dsp_fir_q15_init(dsp_fir_q15_t *fir, uint32_t num_taps, const q15_t *coeffs, q15_t *state, uint32_t block_size) {
+    if ((fir == NULL) || (coeffs == NULL) || (state == NULL) || (num_taps == 0) || (block_size == 0)) {
+        return OMNI_FAIL;
+    }
+
+    fir->num_taps = num_taps;
+    fir->block_size = block_size;
+    fir->coeffs = coeffs;
+    fir->state = state;
+    memset(state, 0, DSP_FIR_STATE_LEN(num_taps, block_size) * sizeof(q15_t));
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Filter a block of Q15 samples
+ *
+ * Products are summed in 64 bits and the sum is saturated to Q15, so
+ * there is no overflow inside the filter. The SIMD kernel computes two
+ * outputs per pass with two taps per multiply-accumulate.
+ *
+ * @param fir Pointer to FIR instance
+ * @param in Pointer to input samples
+ * @param out Pointer to output samples, may be in
+ * @param len Number of samples, at most block_size
+ */
+static DSP_FAST void dsp_fir_q15(dsp_fir_q15_t *fir, const q15_t *in, q15_t *out, uint32_t len) {
+    uint32_t taps = fir->num_taps;
+    const q15_t *coeffs = fir->coeffs;
+    q15_t *state = fir->state;
+    uint32_t n = 0;
+
+    omni_assert(len <= fir->block_size);
+
+    memcpy(&state[taps - 1], in, len * sizeof(q15_t));
+
+#if DSP_SIMD
+    for (; n + 1 < len; n += 2) {
+        const q15_t *x = &state[n];
+        int64_t acc0 = 0;
+        int64_t acc1 = 0;
+        uint32_t k = 0;
+
+        for (; k + 1 < taps; k += 2) {
+            uint32_t c = dsp_read_q15x2(&coeffs[k]);
+            acc0 = __SMLALD(c, dsp_read_q15x2(&x[k]), acc0);
+            acc1 = __SMLALD(c, dsp_read_q15x2(&x[k + 1]), acc1);
+        }
+
+        if (k < taps) {
+            acc0 += (int32_t)coeffs[k] * x[k];
+            acc1 += (int32_t)coeffs[k] * x[k + 1];
+        }
+
+        out[n] = dsp_sat_q15(acc0 >> 15);
+        out[n + 1] = dsp_sat_q15(acc1 >> 15);
+    }
+#endif /* DSP_SIMD */
+
+    for (; n < len; n++) {
+        const q15_t *x = &state[n];
+        int64_t acc = 0;
+
+        for (uint32_t k = 0; k < taps; k++) {
+            acc += (int32_t)coeffs[k] * x[k];
+        }
+
+        out[n] = dsp_sat_q15(acc >> 15);
+    }
+
+    memmove(state, &state[len], (taps - 1) * sizeof(q15_t));
+}
+
+/**
+ * @brief Initialize FIR filter
+ *
+ * @param fir Pointer to FIR instance
+ * @param num_taps Number of taps
+ * @param coeffs Pointer to coefficients, time reversed
+ * @param state Pointer to state, DSP_FIR_STATE_LEN(num_taps, block_size) samples
+ * @param block_size Maximum samples per call
+ * @return int OMNI_OK if success, OMNI_FAIL on a bad argument
+ */
+static int dsp_fir_q31_init(dsp_fir_q31_t *fir, uint32_t num_taps, const q31_t *coeffs, q31_t *state, uint32_t block_size) {
+    if ((fir == NULL) || (coeffs == NULL) || (state == NULL) || (num_taps == 0) || (block_size == 0)) {
+        return OMNI_FAIL;
+    }
+
+    fir->num_taps = num_taps;
+    fir->block_size = block_size;
+    fir->coeffs = coeffs;
+    fir->state = state;
+    memset(state, 0, DSP_FIR_STATE_LEN(num_taps, block_size) * sizeof(q31_t));
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Filter a block of Q31 samples
+ *
+ * Products are summed in 64 bits, which leaves one guard bit. Scale the
+ * input down by log2(num_taps) bits when the taps add up beyond 1.
+ *
+ * @param fir Pointer to FIR instance
+ * @param in Pointer to input samples
+ * @param out Pointer to output samples, may be in
+ * @param len Number of samples, at most block_size
+ */
+static DSP_FAST void dsp_fir_q31(dsp_fir_q31_t *fir, const q31_t *in, q31_t *out, uint32_t len) {
+    uint32_t taps = fir->num_taps;
+    const q31_t *coeffs = fir->coeffs;
+    q31_t *state = fir->state;
+
+    omni_assert(len <= fir->block_size);
+
+    memcpy(&state[taps - 1], in, len * sizeof(q31_t));
+
+    for (uint32_t n = 0; n < len; n++) {
+        const q31_t *x = &state[n];
+        int64_t acc = 0;
+
+        for (uint32_t k = 0; k < taps; k++) {
+            acc += (int64_t)coeffs[k] * x[k];
+        }
+
+        out[n] = dsp_sat_q31(acc >> 31);
+    }
+
+    memmove(state, &state[len], (taps - 1) * sizeof(q31_t));
+}
+
+/**
+ * @brief Initialize FIR filter
+ *
+ * @param fir Pointer to FIR instance
+ * @param num_taps Number of taps
+ * @param coeffs Pointer to coefficients, time reversed
+ * @param state Pointer to state, DSP_FIR_STATE_LEN(num_taps, block_size) samples
+ * @param block_size Maximum samples per call
+ * @return int OMNI_OK if success, OMNI_FAIL on a bad argument
+ */
+static int dsp_fir_f32_init(dsp_fir_f32_t *fir, uint32_t num_taps, const float *coeffs, float *state, uint32_t block_size) {
+    if ((fir == NULL) || (coeffs == NULL) || (state == NULL) || (num_taps == 0) || (block_size == 0)) {
+        return OMNI_FAIL;
+    }
+
+    fir->num_taps = num_taps;
+    fir->block_size = block_size;
+    fir->coeffs = coeffs;
+    fir->state = state;
+    memset(state, 0, DSP_FIR_STATE_LEN(num_taps, block_size) * sizeof(float));
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Filter a block of float samples
+ *
+ * @param fir Pointer to FIR instance
+ * @param in Pointer to input samples
+ * @param out Pointer to output samples, may be in
+ * @param len Number of samples, at most block_size
+ */
+static DSP_FAST void dsp_fir_f32(dsp_fir_f32_t *fir, const float *in, float *out, uint32_t len) {
+    uint32_t taps = fir->num_taps;
+    const float *coeffs = fir->coeffs;
+    float *state = fir->state;
+
+    omni_assert(len <= fir->block_size);
+
+    memcpy(&state[taps - 1], in, len * sizeof(float));
+
+    for (uint32_t n = 0; n < len; n++) {
+        const float *x = &state[n];
+        float acc = 0.0f;
+
+        for (uint32_t k = 0; k < taps; k++) {
+            acc += coeffs[k] * x[k];
+        }
+
+        out[n] = acc;
+    }
+
+    memmove(state, &state[len], (taps - 1) * sizeof(float));
+}
+
+/* Biquad cascades -----------------------------------------------------------*/
+/**
+ * @brief Initialize biquad cascade
+ *
+ * @param biquad Pointer to biquad instance
+ * @param num_stages Number of second order stages
+ * @param coeffs Pointer to 5 coefficients per stage
+ * @param state Pointer to state, DSP_BIQUAD_STATE_LEN(num_stages) values
+ * @param post_shift Coefficient scale 2^-post_shift (0..15)
+ * @return int OMNI_OK if success, OMNI_FAIL on a bad argument
+ */
+static int dsp_biquad_q15_init(dsp_biquad_q15_t *biquad, uint32_t num_stages, const q15_t *coeffs, q15_t *state, uint32_t post_shift) {
+    if ((biquad == NULL) || (coeffs == NULL) || (state == NULL) || (num_stages == 0) || (post_shift > 15)) {
+        return OMNI_FAIL;
+    }
+
+    biquad->num_stages = num_stages;
+    biquad->post_shift = post_shift;
+    biquad->coeffs = coeffs;
+    biquad->state = state;
+    memset(state, 0, DSP_BIQUAD_STATE_LEN(num_stages) * sizeof(q15_t));
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Filter a block of Q15 samples
+ *
+ * Direct form I, state { x[-1], x[-2], y[-1], y[-2] } per stage. The sum
+ * is kept in 64 bits and saturated to Q15 once per sample. The SIMD
+ * kernel applies b1, b2 and a1, a2 as pairs on the packed state.
+ *
+ * @param biquad Pointer to biquad instance
+ * @param in Pointer to input samples
+ * @param out Pointer to output samples, may be in
+ * @param len Number of samples
+ */
+static DSP_FAST void dsp_biquad_q15(dsp_biquad_q15_t *biquad, const q15_t *in, q15_t *out, uint32_t len) {
+    uint32_t shift = 15 - biquad->post_shift;
+    const q15_t *src = in;
+
+    for (uint32_t stage = 0; stage < biquad->num_stages; stage++) {
+        const q15_t *c = &biquad->coeffs[5 * stage];
+        q15_t *state = &biquad->state[4 * stage];
+        int32_t b0 = c[0];
+
+#if DSP_SIMD
+        uint32_t b12 = dsp_read_q15x2(&c[1]);
+        uint32_t a12 = dsp_read_q15x2(&c[3]);
+        uint32_t x12 = dsp_read_q15x2(&state[0]);
+        uint32_t y12 = dsp_read_q15x2(&state[2]);
+
+        for (uint32_t i = 0; i < len; i++) {
+            int32_t x = src[i];
+            int64_t acc = __SMLALD(b12, x12, (int64_t)b0 * x);
+            q15_t y;
+
+            acc -= (int64_t)__SMLALD(a12, y12, 0);
+            y = dsp_sat_q15(acc >> shift);
+            x12 = __PKHBT(x, x12, 16);
+            y12 = __PKHBT(y, y12, 16);
+            out[i] = y;
+        }
+
+        dsp_write_q15x2(&state[0], x12);
+        dsp_write_q15x2(&state[2], y12);
+#else
+        int32_t b1 = c[1];
+        int32_t b2 = c[2];
+        int32_t a1 = c[3];
+        int32_t a2 = c[4];
+        int32_t x1 = state[0];
+        int32_t x2 = state[1];
+        int32_t y1 = state[2];
+        int32_t y2 = state[3];
+
+        for (uint32_t i = 0; i < len; i++) {
+            int32_t x = src[i];
+            int64_t acc = (int64_t)b0 * x + (int64_t)b1 * x1 + (int64_t)b2 * x2;
+            q15_t y;
+
+            acc -= (int64_t)a1 * y1 + (int64_t)a2 * y2;
+            y = dsp_sat_q15(acc >> shift);
+            x2 = x1;
+            x1 = x;
+            y2 = y1;
+            y1 = y;
+            out[i] = y;
+        }
+
+        state[0] = (q15_t)x1;
+        state[1] = (q15_t)x2;
+        state[2] = (q15_t)y1;
+        state[3] = (q15_t)y2;
+#endif /* DSP_SIMD */
+
+        src = out;
+    }
+}
+
+/**
+ * @brief Initialize biquad cascade
+ *
+ * @param biquad Pointer to biquad instance
+ * @param num_stages Number of second order stages
+ * @param coeffs Pointer to 5 coefficients per stage
+ * @param state Pointer to state, DSP_BIQUAD_STATE_LEN(num_stages) values
+ * @param post_shift Coefficient scale 2^-post_shift (0..31)
+ * @return int OMNI_OK if success, OMNI_FAIL on a bad argument
+ */
+static int dsp_biquad_q31_init(dsp_biquad_q31_t *biquad, uint32_t num_stages, const q31_t *coeffs, q31_t *state, uint32_t post_shift) {
+    if ((biquad == NULL) || (coeffs == NULL) || (state == NULL) || (num_stages == 0) || (post_shift > 31)) {
+        return OMNI_FAIL;
+    }
+
+    biquad->num_stages = num_stages;
+    biquad->post_shift = post_shift;
+    biquad->coeffs = coeffs;
+    biquad->state = state;
+    memset(state, 0, DSP_BIQUAD_STATE_LEN(num_stages) * sizeof(q31_t));
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Filter a block of Q31 samples
+ *
+ * Direct form I with a 64 bit sum, state { x[-1], x[-2], y[-1], y[-2] }
+ * per stage.
+ *
+ * @param biquad Pointer to biquad instance
+ * @param in Pointer to input samples
+ * @param out Pointer to output samples, may be in
+ * @param len Number of samples
+ */
+static DSP_FAST void dsp_biquad_q31(dsp_biquad_q31_t *biquad, const q31_t *in, q31_t *out, uint32_t len) {
+    uint32_t shift = 31 - biquad->post_shift;
+    const q31_t *src = in;
+
+    for (uint32_t stage = 0; stage < biquad->num_stages; stage++) {
+        const q31_t *c = &biquad->coeffs[5 * stage];
+        q31_t *state = &biquad->state[4 * stage];
+        int64_t b0 = c[0];
+        int64_t b1 = c[1];
+        int64_t b2 = c[2];
+        int64_t a1 = c[3];
+        int64_t a2 = c[4];
+        q31_t x1 = state[0];
+        q31_t x2 = state[1];
+        q31_t y1 = state[2];
+        q31_t y2 = state[3];
+
+        for (uint32_t i = 0; i < len; i++) {
+            q31_t x = src[i];
+            int64_t acc = b0 * x + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2;
+            q31_t y = dsp_sat_q31(acc >> shift);
+
+            x2 = x1;
+            x1 = x;
+            y2 = y1;
+            y1 = y;
+            out[i] = y;
+        }
+
+        state[0] = x1;
+        state[1] = x2;
+        state[2] = y1;
+        state[3] = y2;
+        src = out;
+    }
+}
+
+/**
+ * @brief Initialize biquad cascade
+ *
+ * @param biquad Pointer to biquad instance
+ * @param num_stages Number of second order stages
+ * @param coeffs Pointer to 5 coefficients per stage
+ * @param state Pointer to state, DSP_BIQUAD_STATE_LEN(num_stages) values
+ * @return int OMNI_OK if success, OMNI_FAIL on a bad argument
+ */
+static int dsp_biquad_f32_init(dsp_biquad_f32_t *biquad, uint32_t num_stages, const float *coeffs, float *state) {
+    if ((biquad == NULL) || (coeffs == NULL) || (state == NULL) || (num_stages == 0)) {
+        return OMNI_FAIL;
+    }
+
+    biquad->num_stages = num_stages;
+    biquad->coeffs = coeffs;
+    biquad->state = state;
+    memset(state, 0, DSP_BIQUAD_STATE_LEN(num_stages) * sizeof(float));
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Filter a block of float samples
+ *
+ * Direct form II transposed, uses the first two state values of each
+ * stage.
+ *
+ * @param biquad Pointer to biquad instance
+ * @param in Pointer to input samples
+ * @param out Pointer to output samples, may be in
+ * @param len Number of samples
+ */
+static DSP_FAST void dsp_biquad_f32(dsp_biquad_f32_t *biquad, const float *in, float *out, uint32_t len) {
+    const float *src = in;
+
+    for (uint32_t stage = 0; stage < biquad->num_stages; stage++) {
+        const float *c = &biquad->coeffs[5 * stage];
+        float *state = &biquad->state[4 * stage];
+        float b0 = c[0];
+        float b1 = c[1];
+        float b2 = c[2];
+        float a1 = c[3];
+        float a2 = c[4];
+        float d1 = state[0];
+        float d2 = state[1];
+
+        for (uint32_t i = 0; i < len; i++) {
+            float x = src[i];
+            float y = b0 * x + d1;
+
+            d1 = b1 * x - a1 * y + d2;
+            d2 = b2 * x - a2 * y;
+            out[i] = y;
+        }
+
+        state[0] = d1;
+        state[1] = d2;
+        src = out;
+    }
+}
+
+/* Real FFTs -----------------------------------------------------------------*/
+/*
+ * The n real samples are transformed as m = n / 2 complex samples
+ * z[k] = x[2k] + j x[2k + 1]. With A = Z[k] and B = conj(Z[m - k]) the
+ * bins follow as X[k] = (A + B) / 2 + W_n^k * (-j) * (A - B) / 2.
+ */
+
+/**
+ * @brief Initialize real FFT
+ *
+ * @param rfft Pointer to FFT instance
+ * @param n Number of real samples, power of two (16..4096)
+ * @param twiddle Pointer to twiddle table, DSP_RFFT_TWIDDLE_LEN(n) values
+ * @return int OMNI_OK if success, OMNI_FAIL on a bad argument
+ */
+static int dsp_rfft_q15_init(dsp_rfft_q15_t *rfft, uint32_t n, q15_t *twiddle) {
+    if ((rfft == NULL) || (twiddle == NULL) || !dsp_rfft_len_valid(n)) {
+        return OMNI_FAIL;
+    }
+
+    for (uint32_t k = 0; k < 3 * n / 4; k++) {
+        double c;
+        double s;
+
+        dsp_sincos(k, n, &c, &s);
+        twiddle[2 * k] = (q15_t)dsp_to_fixed(c, 15);
+        twiddle[2 * k + 1] = (q15_t)dsp_to_fixed(s, 15);
+    }
+
+    rfft->n = n;
+    rfft->twiddle = twiddle;
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Transform n Q15 samples, bins scaled by 1/n
+ *
+ * @param rfft Pointer to FFT instance
+ * @param in Pointer to n input samples, destroyed
+ * @param out Pointer to n output values
+ */
+static DSP_FAST void dsp_rfft_q15(dsp_rfft_q15_t *rfft, q15_t *in, q15_t *out) {
+    uint32_t n = rfft->n;
+    uint32_t m = n / 2;
+    const q15_t *twiddle = rfft->twiddle;
+
+    dsp_cfft_q15(in, m, twiddle, n);
+
+    out[0] = (q15_t)(((int32_t)in[0] + in[1]) >> 1);
+    out[1] = (q15_t)(((int32_t)in[0] - in[1]) >> 1);
+
+    for (uint32_t k = 1; k < m; k++) {
+        uint32_t a = dsp_read_q15x2(&in[2 * k]);
+        uint32_t b = dsp_read_q15x2(&in[2 * (m - k)]);
+        uint32_t sum = dsp_shadd16(a, b);
+        uint32_t diff = dsp_shsub16(a, b);
+        uint32_t even = dsp_pack_lo_hi(sum, diff);     // (A + conj B) / 2
+        uint32_t odd = dsp_pack_lo_hi(diff, sum);      // (A - conj B) / 2
+
+        odd = dsp_cmul_odd_q15(odd, dsp_read_q15x2(&twiddle[2 * k]));
+        dsp_write_q15x2(&out[2 * k], dsp_shadd16(even, odd));
+    }
+}
+
+/**
+ * @brief Initialize real FFT
+ *
+ * @param rfft Pointer to FFT instance
+ * @param n Number of real samples, power of two (16..4096)
+ * @param twiddle Pointer to twiddle table, DSP_RFFT_TWIDDLE_LEN(n) values
+ * @return int OMNI_OK if success, OMNI_FAIL on a bad argument
+ */
+static int dsp_rfft_q31_init(dsp_rfft_q31_t *rfft, uint32_t n, q31_t *twiddle) {
+    if ((rfft == NULL) || (twiddle == NULL) || !dsp_rfft_len_valid(n)) {
+        return OMNI_FAIL;
+    }
+
+    for (uint32_t k = 0; k < 3 * n / 4; k++) {
+        double c;
+        double s;
+
+        dsp_sincos(k, n, &c, &s);
+        twiddle[2 * k] = dsp_to_fixed(c, 31);
+        twiddle[2 * k + 1] = dsp_to_fixed(s, 31);
+    }
+
+    rfft->n = n;
+    rfft->twiddle = twiddle;
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Transform n Q31 samples, bins scaled by 1/n
+ *
+ * @param rfft Pointer to FFT instance
+ * @param in Pointer to n input samples, destroyed
+ * @param out Pointer to n output values
+ */
+static DSP_FAST void dsp_rfft_q31(dsp_rfft_q31_t *rfft, q31_t *in, q31_t *out) {
+    uint32_t n = rfft->n;
+    uint32_t m = n / 2;
+    const q31_t *twiddle = rfft->twiddle;
+
+    dsp_cfft_q31(in, m, twiddle, n);
+
+    out[0] = dsp_half_add_q31(in[0], in[1]);
+    out[1] = dsp_half_sub_q31(in[0], in[1]);
+
+    for (uint32_t k = 1; k < m; k++) {
+        const q31_t *a = &in[2 * k];
+        const q31_t *b = &in[2 * (m - k)];
+        q31_t even_re = dsp_half_add_q31(a[0], b[0]);
+        q31_t even_im = dsp_half_sub_q31(a[1], b[1]);
+        q31_t odd_re = dsp_half_add_q31(a[1], b[1]);    // -j * (A - conj B) / 2
+        q31_t odd_im = dsp_half_sub_q31(b[0], a[0]);
+
+        dsp_cmul_q31(&odd_re, &odd_im, &twiddle[2 * k]);
+        out[2 * k] = dsp_half_add_q31(even_re, odd_re);
+        out[2 * k + 1] = dsp_half_add_q31(even_im, odd_im);
+    }
+}
+
+/**
+ * @brief Initialize real FFT
+ *
+ * @param rfft Pointer to FFT instance
+ * @param n Number of real samples, power of two (16..4096)
+ * @param twiddle Pointer to twiddle table, DSP_RFFT_TWIDDLE_LEN(n) values
+ * @return int OMNI_OK if success, OMNI_FAIL on a bad argument
+ */
+static int dsp_rfft_f32_init(dsp_rfft_f32_t *rfft, uint32_t n, float *twiddle) {
+    if ((rfft == NULL) || (twiddle == NULL) || !dsp_rfft_len_valid(n)) {
+        return OMNI_FAIL;
+    }
+
+    for (uint32_t k = 0; k < 3 * n / 4; k++) {
+        double c;
+        double s;
+
+        dsp_sincos(k, n, &c, &s);
+        twiddle[2 * k] = (float)c;
+        twiddle[2 * k + 1] = (float)s;
+    }
+
+    rfft->n = n;
+    rfft->twiddle = twiddle;
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Transform n float samples, bins not scaled
+ *
+ * @param rfft Pointer to FFT instance
+ * @param in Pointer to n input samples, destroyed
+ * @param out Pointer to n output values
+ */
+static DSP_FAST void dsp_rfft_f32(dsp_rfft_f32_t *rfft, float *in, float *out) {
+    uint32_t n = rfft->n;
+    uint32_t m = n / 2;
+    const float *twiddle = rfft->twiddle;
+
+    dsp_cfft_f32(in, m, twiddle, n);
+
+    out[0] = in[0] + in[1];
+    out[1] = in[0] - in[1];
+
+    for (uint32_t k = 1; k < m; k++) {
+        const float *a = &in[2 * k];
+        const float *b = &in[2 * (m - k)];
+        float even_re = 0.5f * (a[0] + b[0]);
+        float even_im = 0.5f * (a[1] - b[1]);
+        float odd_re = 0.5f * (a[1] + b[1]);
+        float odd_im = 0.5f * (b[0] - a[0]);
+
+        dsp_cmul_f32(&odd_re, &odd_im, &twiddle[2 * k]);
+        out[2 * k] = even_re + odd_re;
+        out[2 * k + 1] = even_im + odd_im;
+    }
+}
@@ -0,0 +1,231 @@
+/**
+  * @file    dsp.h
+  * @author  LuckkMaker
+  * @brief   DSP kernel component for omni
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef COMPONENT_DSP_H
+#define COMPONENT_DSP_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "include/device.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Block FIR filters, biquad cascades and real FFTs in Q15, Q31 and float.
+ * Q15 is a 16 bit and Q31 a 32 bit signed fraction in [-1, 1).
+ *
+ * On Cortex-M4/M7 the Q15 kernels work on two samples per instruction
+ * with the SIMD instructions of the CMSIS intrinsics. Other targets, or
+ * CONFIG_DSP_REFERENCE, build portable C kernels. Both round the same
+ * way, Q15 and Q31 results are bit-exact between target and host, so
+ * the host build serves as reference for the target.
+ *
+ * Coefficients and state belong to the caller, the instance only points
+ * to them:
+ * - FIR: coefficients in time reversed order, c[0] is applied to the
+ *   oldest sample. State holds DSP_FIR_STATE_LEN samples.
+ * - Biquad: 5 coefficients { b0, b1, b2, a1, a2 } per stage for
+ *   y = b0 x + b1 x[-1] + b2 x[-2] - a1 y[-1] - a2 y[-2]. Q15 and Q31
+ *   coefficients are scaled down by 2^post_shift to fit [-1, 1). State
+ *   holds DSP_BIQUAD_STATE_LEN values.
+ * - Real FFT: twiddle table of DSP_RFFT_TWIDDLE_LEN values, filled by
+ *   init. The input buffer is used as work area and destroyed. The
+ *   output holds N / 2 + 1 bins in N values, out[0] is the DC bin and
+ *   out[1] the real Nyquist bin, then re/im pairs of bins 1..N/2-1.
+ *   Q15 and Q31 bins are scaled by 1/N, float bins are not scaled.
+ *
+ * @code
+ * #define TAPS    32
+ * #define BLOCK   64
+ *
+ * static const q15_t taps[TAPS] = { ... };
+ * static q15_t fir_state[DSP_FIR_STATE_LEN(TAPS, BLOCK)];
+ * static q15_t twiddle[DSP_RFFT_TWIDDLE_LEN(BLOCK)];
+ * static q15_t filtered[BLOCK];
+ * static q15_t spectrum[BLOCK];
+ * static dsp_fir_q15_t fir;
+ * static dsp_rfft_q15_t fft;
+ *
+ * dsp.fir_q15_init(&fir, TAPS, taps, fir_state, BLOCK);
+ * dsp.rfft_q15_init(&fft, BLOCK, twiddle);
+ *
+ * dsp.fir_q15(&fir, samples, filtered, BLOCK);
+ * dsp.rfft_q15(&fft, filtered, spectrum);
+ * @endcode
+ */
+
+/**
+ * @brief Buffer lengths in values
+ */
+#define DSP_FIR_STATE_LEN(num_taps, block_size)     ((num_taps) + (block_size) - 1)
+#define DSP_BIQUAD_STATE_LEN(num_stages)            (4 * (num_stages))
+#define DSP_RFFT_TWIDDLE_LEN(n)                     (3 * (n) / 2)
+
+/**
+ * @brief Real FFT sizes, powers of two
+ */
+#define DSP_RFFT_MIN_LEN                16U
+#define DSP_RFFT_MAX_LEN                4096U
+
+typedef int16_t q15_t;
+typedef int32_t q31_t;
+
+/**
+ * @brief FIR filter instance
+ */
+typedef struct dsp_fir_q15 {
+    uint32_t num_taps;              /**< Number of taps */
+    uint32_t block_size;            /**< Maximum samples per call */
+    const q15_t *coeffs;            /**< Coefficients, time reversed */
+    q15_t *state;                   /**< State, DSP_FIR_STATE_LEN samples */
+} dsp_fir_q15_t;
+
+typedef struct dsp_fir_q31 {
+    uint32_t num_taps;              /**< Number of taps */
+    uint32_t block_size;            /**< Maximum samples per call */
+    const q31_t *coeffs;            /**< Coefficients, time reversed */
+    q31_t *state;                   /**< State, DSP_FIR_STATE_LEN samples */
+} dsp_fir_q31_t;
+
+typedef struct dsp_fir_f32 {
+    uint32_t num_taps;              /**< Number of taps */
+    uint32_t block_size;            /**< Maximum samples per call */
+    const float *coeffs;            /**< Coefficients, time reversed */
+    float *state;                   /**< State, DSP_FIR_STATE_LEN samples */
+} dsp_fir_f32_t;
+
+/**
+ * @brief Biquad cascade instance
+ */
+typedef struct dsp_biquad_q15 {
+    uint32_t num_stages;            /**< Number of second order stages */
+    uint32_t post_shift;            /**< Coefficient scale 2^-post_shift (0..15) */
+    const q15_t *coeffs;            /**< 5 coefficients per stage */
+    q15_t *state;                   /**< State, DSP_BIQUAD_STATE_LEN values */
+} dsp_biquad_q15_t;
+
+typedef struct dsp_biquad_q31 {
+    uint32_t num_stages;            /**< Number of second order stages */
+    uint32_t post_shift;            /**< Coefficient scale 2^-post_shift (0..31) */
+    const q31_t *coeffs;            /**< 5 coefficients per stage */
+    q31_t *state;                   /**< State, DSP_BIQUAD_STATE_LEN values */
+} dsp_biquad_q31_t;
+
+typedef struct dsp_biquad_f32 {
+    uint32_t num_stages;            /**< Number of second order stages */
+    const float *coeffs;            /**< 5 coefficients per stage */
+    float *state;                   /**< State, DSP_BIQUAD_STATE_LEN values */
+} dsp_biquad_f32_t;
+
+/**
+ * @brief Real FFT instance
+ */
+typedef struct dsp_rfft_q15 {
+    uint32_t n;                     /**< Number of real samples */
+    const q15_t *twiddle;           /**< Twiddle table, DSP_RFFT_TWIDDLE_LEN values */
+} dsp_rfft_q15_t;
+
+typedef struct dsp_rfft_q31 {
+    uint32_t n;                     /**< Number of real samples */
+    const q31_t *twiddle;           /**< Twiddle table, DSP_RFFT_TWIDDLE_LEN values */
+} dsp_rfft_q31_t;
+
+typedef struct dsp_rfft_f32 {
+    uint32_t n;                     /**< Number of real samples */
+    const float *twiddle;           /**< Twiddle table, DSP_RFFT_TWIDDLE_LEN values */
+} dsp_rfft_f32_t;
+
+/**
+ * @brief Initialize FIR filter, clears the state
+ */
+typedef int (*dsp_fir_q15_init_t)(dsp_fir_q15_t *fir, uint32_t num_taps, const q15_t *coeffs, q15_t *state, uint32_t block_size);
+typedef int (*dsp_fir_q31_init_t)(dsp_fir_q31_t *fir, uint32_t num_taps, const q31_t *coeffs, q31_t *state, uint32_t block_size);
+typedef int (*dsp_fir_f32_init_t)(dsp_fir_f32_t *fir, uint32_t num_taps, const float *coeffs, float *state, uint32_t block_size);
+
+/**
+ * @brief Filter a block of at most block_size samples
+ */
+typedef void (*dsp_fir_q15_run_t)(dsp_fir_q15_t *fir, const q15_t *in, q15_t *out, uint32_t len);
+typedef void (*dsp_fir_q31_run_t)(dsp_fir_q31_t *fir, const q31_t *in, q31_t *out, uint32_t len);
+typedef void (*dsp_fir_f32_run_t)(dsp_fir_f32_t *fir, const float *in, float *out, uint32_t len);
+
+/**
+ * @brief Initialize biquad cascade, clears the state
+ */
+typedef int (*dsp_biquad_q15_init_t)(dsp_biquad_q15_t *biquad, uint32_t num_stages, const q15_t *coeffs, q15_t *state, uint32_t post_shift);
+typedef int (*dsp_biquad_q31_init_t)(dsp_biquad_q31_t *biquad, uint32_t num_stages, const q31_t *coeffs, q31_t *state, uint32_t post_shift);
+typedef int (*dsp_biquad_f32_init_t)(dsp_biquad_f32_t *biquad, uint32_t num_stages, const float *coeffs, float *state);
+
+/**
+ * @brief Filter a block of samples, in and out may be the same buffer
+ */
+typedef void (*dsp_biquad_q15_run_t)(dsp_biquad_q15_t *biquad, const q15_t *in, q15_t *out, uint32_t len);
+typedef void (*dsp_biquad_q31_run_t)(dsp_biquad_q31_t *biquad, const q31_t *in, q31_t *out, uint32_t len);
+typedef void (*dsp_biquad_f32_run_t)(dsp_biquad_f32_t *biquad, const float *in, float *out, uint32_t len);
+
+/**
+ * @brief Initialize real FFT of n samples, fills the twiddle table
+ */
+typedef int (*dsp_rfft_q15_init_t)(dsp_rfft_q15_t *rfft, uint32_t n, q15_t *twiddle);
+typedef int (*dsp_rfft_q31_init_t)(dsp_rfft_q31_t *rfft, uint32_t n, q31_t *twiddle);
+typedef int (*dsp_rfft_f32_init_t)(dsp_rfft_f32_t *rfft, uint32_t n, float *twiddle);
+
+/**
+ * @brief Transform n samples, in is destroyed
+ */
+typedef void (*dsp_rfft_q15_run_t)(dsp_rfft_q15_t *rfft, q15_t *in, q15_t *out);
+typedef void (*dsp_rfft_q31_run_t)(dsp_rfft_q31_t *rfft, q31_t *in, q31_t *out);
+typedef void (*dsp_rfft_f32_run_t)(dsp_rfft_f32_t *rfft, float *in, float *out);
+
+/**
+ * @brief DSP API
+ */
+struct dsp_api {
+    dsp_fir_q15_init_t fir_q15_init;
+    dsp_fir_q15_run_t fir_q15;
+    dsp_fir_q31_init_t fir_q31_init;
+    dsp_fir_q31_run_t fir_q31;
+    dsp_fir_f32_init_t fir_f32_init;
+    dsp_fir_f32_run_t fir_f32;
+    dsp_biquad_q15_init_t biquad_q15_init;
+    dsp_biquad_q15_run_t biquad_q15;
+    dsp_biquad_q31_init_t biquad_q31_init;
+    dsp_biquad_q31_run_t biquad_q31;
+    dsp_biquad_f32_init_t biquad_f32_init;
+    dsp_biquad_f32_run_t biquad_f32;
+    dsp_rfft_q15_init_t rfft_q15_init;
+    dsp_rfft_q15_run_t rfft_q15;
+    dsp_rfft_q31_init_t rfft_q31_init;
+    dsp_rfft_q31_run_t rfft_q31;
+    dsp_rfft_f32_init_t rfft_f32_init;
+    dsp_rfft_f32_run_t rfft_f32;
+};
+
+extern const struct dsp_api dsp;
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* COMPONENT_DSP_H */
@@ -42,4 +42,41 @@
 #include "ring_buffer/ring_buffer.h"
 #endif /* CONFIG_COMPONENT_RING_BUFFER */
 
+#if defined(CONFIG_COMPONENT_WAVEFORM)
+#include "waveform/waveform.h"
+#endif /* CONFIG_COMPONENT_WAVEFORM */
+
+#if defined(CONFIG_COMPONENT_RETARGET)
+#include "retarget/retarget.h"
+#endif /* CONFIG_COMPONENT_RETARGET */
+
+#if defined(CONFIG_COMPONENT_MONITOR)
+#include "monitor/monitor.h"
+#endif /* CONFIG_COMPONENT_MONITOR */
+
+#if defined(CONFIG_COMPONENT_BENCH)
+#include "bench/bench.h"
+#endif /* CONFIG_COMPONENT_BENCH */
+
+#if defined(CONFIG_COMPONENT_MPU)
+#include "mpu/mpu.h"
+#endif /* CONFIG_COMPONENT_MPU */
+
+#if defined(CONFIG_COMPONENT_DSP)
+#include "dsp/dsp.h"
+#endif /* CONFIG_COMPONENT_DSP */
+
+#if defined(CONFIG_COMPONENT_CRC)
+#include "crc/crc.h"
+#endif /* CONFIG_COMPONENT_CRC */
+
+#if defined(CONFIG_COMPONENT_MEMOPS)
+#include "memops/memops.h"
+#endif /* CONFIG_COMPONENT_MEMOPS */
+
+// Always included so that profiler zones, trace points and log calls compile out when disabled
+#include "profiler/profiler.h"
+#include "trace/trace.h"
+#include "dlog/dlog.h"
+
 #endif /* OMNI_COMPONENT_H */
@@ -0,0 +1,417 @@
+/**
+  * @file    memops.c
+  * @author  LuckkMaker
+  * @brief   Memory copy and fill component for omni
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "memops/memops.h"
+
+// Burst copies, LDRD/STRD on Cortex-M7, LDM/STM on Cortex-M3/M4, C elsewhere
+#if defined(__CORTEX_M) && (__CORTEX_M == 7U)
+#define MEMOPS_BURST_LDRD               1
+#elif defined(__CORTEX_M) && ((__CORTEX_M == 3U) || (__CORTEX_M == 4U))
+#define MEMOPS_BURST_LDM                1
+#endif
+
+#if defined(CONFIG_MEMOPS_FAST_CODE)
+#define MEMOPS_FAST                     OMNI_FAST_CODE
+#else
+#define MEMOPS_FAST
+#endif /* CONFIG_MEMOPS_FAST_CODE */
+
+// The loops below must not be turned back into calls to memcpy and memset
+#if defined(__GNUC__) && !defined(__clang__)
+#define MEMOPS_NO_LIBCALL               __attribute__((optimize("no-tree-loop-distribute-patterns")))
+#else
+#define MEMOPS_NO_LIBCALL
+#endif
+
+#define MEMOPS_SMALL_LEN                16U
+#define MEMOPS_BURST_LEN                32U
+
+/**
+ * @brief Word access to any address
+ */
+typedef struct __attribute__((packed, may_alias)) {
+    uint32_t value;
+} memops_word_t;
+
+static void *memops_copy(void *dst, const void *src, size_t len);
+static void *memops_set(void *dst, int value, size_t len);
+static void *memops_move(void *dst, const void *src, size_t len);
+static inline uint32_t memops_load(const uint8_t *src);
+static inline void memops_store(uint8_t *dst, uint32_t value);
+static inline void memops_copy_small(uint8_t *dst, const uint8_t *src, size_t len);
+static void memops_copy_forward(uint8_t *dst, const uint8_t *src, size_t len);
+static void memops_copy_backward(uint8_t *dst, const uint8_t *src, size_t len);
+
+const struct memops_api memops = {
+    .copy = memops_copy,
+    .set = memops_set,
+    .move = memops_move,
+};
+
+/**
+ * @brief Copy memory
+ *
+ * @param dst Pointer to destination
+ * @param src Pointer to source
+ * @param len Length in bytes
+ * @return dst
+ */
+static MEMOPS_FAST void *memops_copy(void *dst, const void *src, size_t len) {
+    if (len <= MEMOPS_SMALL_LEN) {
+        memops_copy_small((uint8_t *)dst, (const uint8_t *)src, len);
+    } else {
+        memops_copy_forward((uint8_t *)dst, (const uint8_t *)src, len);
+    }
+
+    return dst;
+}
+
+/**
+ * @brief Fill memory
+ *
+ * @param dst Pointer to destination
+ * @param value Fill value, converted to uint8_t
+ * @param len Length in bytes
+ * @return dst
+ */
+static MEMOPS_FAST MEMOPS_NO_LIBCALL void *memops_set(void *dst, int value, size_t len) {
+    uint8_t *d = (uint8_t *)dst;
+    uint32_t word = (uint32_t)(uint8_t)value * 0x01010101U;
+
+    if (len < 4U) {
+        // 0..3 bytes, stores may hit the same byte
+        if (len != 0U) {
+            d[0] = (uint8_t)word;
+            d[len >> 1] = (uint8_t)word;
+            d[len - 1U] = (uint8_t)word;
+        }
+        return dst;
+    }
+
+    if (len <= MEMOPS_SMALL_LEN) {
+        memops_store(d, word);
+        memops_store(d + len - 4U, word);
+        if (len > 8U) {
+            memops_store(d + 4U, word);
+            memops_store(d + len - 8U, word);
+        }
+        return dst;
+    }
+
+    // The first word may overlap the aligned stores
+    memops_store(d, word);
+    len -= 4U - ((uintptr_t)d & 3U);
+    d += 4U - ((uintptr_t)d & 3U);
+
+    if (len >= MEMOPS_BURST_LEN) {
+        size_t blocks = len / MEMOPS_BURST_LEN;
+
+        len %= MEMOPS_BURST_LEN;
+#if defined(MEMOPS_BURST_LDRD)
+        __ASM volatile (
+            "1: strd %[w], %[w], [%[d]]\n"
+            "   strd %[w], %[w], [%[d], #8]\n"
+            "   strd %[w], %[w], [%[d], #16]\n"
+            "   strd %[w], %[w], [%[d], #24]\n"
+            "   adds %[d], %[d], #32\n"
+            "   subs %[n], %[n], #1\n"
+            "   bne 1b\n"
+            : [d] "+r" (d), [n] "+r" (blocks)
+            : [w] "r" (word)
+            : "cc", "memory");
+#elif defined(MEMOPS_BURST_LDM)
+        __ASM volatile (
+            "   mov r3, %[w]\n"
+            "   mov r4, %[w]\n"
+            "   mov r5, %[w]\n"
+            "   mov r6, %[w]\n"
+            "1: stmia %[d]!, {r3, r4, r5, r6}\n"
+            "   stmia %[d]!, {r3, r4, r5, r6}\n"
+            "   subs %[n], %[n], #1\n"
+            "   bne 1b\n"
+            : [d] "+r" (d), [n] "+r" (blocks)
+            : [w] "r" (word)
+            : "r3", "r4", "r5", "r6", "cc", "memory");
+#else
+        for (; blocks > 0U; blocks--, d += MEMOPS_BURST_LEN) {
+            for (uint32_t i = 0; i < MEMOPS_BURST_LEN; i += 4U) {
+                ((memops_word_t *)(d + i))->value = word;
+            }
+        }
+#endif
+    }
+
+    for (; len >= 4U; len -= 4U, d += 4U) {
+        ((memops_word_t *)d)->value = word;
+    }
+
+    // The last word may overlap the aligned stores
+    if (len != 0U) {
+        memops_store(d + len - 4U, word);
+    }
+
+    return dst;
+}
+
+/**
+ * @brief Copy memory, buffers may overlap
+ *
+ * @param dst Pointer to destination
+ * @param src Pointer to source
+ * @param len Length in bytes
+ * @return dst
+ */
+static MEMOPS_FAST void *memops_move(void *dst, const void *src, size_t len) {
+    uint8_t *d = (uint8_t *)dst;
+    const uint8_t *s = (const uint8_t *)src;
+
+    if ((d == s) || (len == 0U)) {
+        return dst;
+    }
+
+    if (len <= MEMOPS_SMALL_LEN) {
+        // Loads all bytes before the first store
+        memops_copy_small(d, s, len);
+    } else if ((uintptr_t)(d - s) >= len) {
+        // Destination below the source or no overlap, a forward copy never
+        // stores ahead of the loads
+        memops_copy_forward(d, s, len);
+    } else {
+        memops_copy_backward(d, s, len);
+    }
+
+    return dst;
+}
+
+#if defined(CONFIG_MEMOPS_LIBC) && defined(__arm__)
+/********************* Libc functions **********************/
+
+/**
+ * @brief Copy memory, replaces the newlib function
+ */
+void *memcpy(void *dst, const void *src, size_t len) {
+    return memops_copy(dst, src, len);
+}
+
+/**
+ * @brief Fill memory, replaces the newlib function
+ */
+void *memset(void *dst, int value, size_t len) {
+    return memops_set(dst, value, len);
+}
+
+/**
+ * @brief Copy overlapping memory, replaces the newlib function
+ */
+void *memmove(void *dst, const void *src, size_t len) {
+    return memops_move(dst, src, len);
+}
+#endif /* CONFIG_MEMOPS_LIBC && __arm__ */
+
+/********************* Private functions **********************/
+
+/**
+ * @brief Load a word from any address
+ */
+static inline uint32_t memops_load(const uint8_t *src) {
+    return ((const memops_word_t *)src)->value;
+}
+
+/**
+ * @brief Store a word to any address
+ */
+static inline void memops_store(uint8_t *dst, uint32_t value) {
+    ((memops_word_t *)dst)->value = value;
+}
+
+/**
+ * @brief Copy up to 16 bytes
+ *
+ * @note All loads happen before the first store, overlapping buffers are
+ *       copied correctly.
+ * @param dst Pointer to destination
+ * @param src Pointer to source
+ * @param len Length in bytes (0..16)
+ */
+static inline void memops_copy_small(uint8_t *dst, const uint8_t *src, size_t len) {
+    if (len >= 8U) {
+        uint32_t a = memops_load(src);
+        uint32_t b = memops_load(src + 4U);
+        uint32_t c = memops_load(src + len - 8U);
+        uint32_t e = memops_load(src + len - 4U);
+
+        memops_store(dst, a);
+        memops_store(dst + 4U, b);
+        memops_store(dst + len - 8U, c);
+        memops_store(dst + len - 4U, e);
+    } else if (len >= 4U) {
+        uint32_t a = memops_load(src);
+        uint32_t b = memops_load(src + len - 4U);
+
+        memops_store(dst, a);
+        memops_store(dst + len - 4U, b);
+    } else if (len != 0U) {
+        uint8_t a = src[0];
+        uint8_t b = src[len >> 1];
+        uint8_t c = src[len - 1U];
+
+        dst[0] = a;
+        dst[len >> 1] = b;
+        dst[len - 1U] = c;
+    }
+}
+
+/**
+ * @brief Copy more than 16 bytes from the start
+ *
+ * @note Each step loads before it stores, the copy is correct for
+ *       overlapping buffers with dst below src.
+ * @param dst Pointer to destination
+ * @param src Pointer to source
+ * @param len Length in bytes (> 16)
+ */
+static MEMOPS_FAST MEMOPS_NO_LIBCALL void memops_copy_forward(uint8_t *dst, const uint8_t *src, size_t len) {
+    // Align the destination, stores are the slower side of unaligned copies
+    for (; ((uintptr_t)dst & 3U) != 0U; len--) {
+        *dst++ = *src++;
+    }
+
+    if (((uintptr_t)src & 3U) == 0U) {
+        if (len >= MEMOPS_BURST_LEN) {
+            size_t blocks = len / MEMOPS_BURST_LEN;
+
+            len %= MEMOPS_BURST_LEN;
+#if defined(MEMOPS_BURST_LDRD)
+            uint32_t a;
+            uint32_t b;
+            uint32_t c;
+            uint32_t e;
+
+            __ASM volatile (
+                "1: ldrd %[a], %[b], [%[s]]\n"
+                "   ldrd %[c], %[e], [%[s], #8]\n"
+                "   strd %[a], %[b], [%[d]]\n"
+                "   strd %[c], %[e], [%[d], #8]\n"
+                "   ldrd %[a], %[b], [%[s], #16]\n"
+                "   ldrd %[c], %[e], [%[s], #24]\n"
+                "   strd %[a], %[b], [%[d], #16]\n"
+                "   strd %[c], %[e], [%[d], #24]\n"
+                "   adds %[s], %[s], #32\n"
+                "   adds %[d], %[d], #32\n"
+                "   subs %[n], %[n], #1\n"
+                "   bne 1b\n"
+                : [d] "+r" (dst), [s] "+r" (src), [n] "+r" (blocks),
+                  [a] "=&r" (a), [b] "=&r" (b), [c] "=&r" (c), [e] "=&r" (e)
+                :
+                : "cc", "memory");
+#elif defined(MEMOPS_BURST_LDM)
+            __ASM volatile (
+                "1: ldmia %[s]!, {r3, r4, r5, r6}\n"
+                "   stmia %[d]!, {r3, r4, r5, r6}\n"
+                "   ldmia %[s]!, {r3, r4, r5, r6}\n"
+                "   stmia %[d]!, {r3, r4, r5, r6}\n"
+                "   subs %[n], %[n], #1\n"
+                "   bne 1b\n"
+                : [d] "+r" (dst), [s] "+r" (src), [n] "+r" (blocks)
+                :
+                : "r3", "r4", "r5", "r6", "cc", "memory");
+#else
+            for (; blocks > 0U; blocks--, dst += MEMOPS_BURST_LEN, src += MEMOPS_BURST_LEN) {
+                uint32_t w[MEMOPS_BURST_LEN / 4U];
+
+                for (uint32_t i = 0; i < MEMOPS_BURST_LEN / 4U; i++) {
+                    w[i] = memops_load(src + 4U * i);
+                }
+                for (uint32_t i = 0; i < MEMOPS_BURST_LEN / 4U; i++) {
+                    memops_store(dst + 4U * i, w[i]);
+                }
+            }
+#endif
+        }
+    } else {
+        // Unaligned loads, 16 bytes per step
+        for (; len >= 16U; len -= 16U, dst += 16, src += 16) {
+            uint32_t a = memops_load(src);
+            uint32_t b = memops_load(src + 4U);
+            uint32_t c = memops_load(src + 8U);
+            uint32_t e = memops_load(src + 12U);
+
+            memops_store(dst, a);
+            memops_store(dst + 4U, b);
+            memops_store(dst + 8U, c);
+            memops_store(dst + 12U, e);
+        }
+    }
+
+    for (; len >= 4U; len -= 4U, dst += 4, src += 4) {
+        memops_store(dst, memops_load(src));
+    }
+
+    for (; len > 0U; len--) {
+        *dst++ = *src++;
+    }
+}
+
+/**
+ * @brief Copy more than 16 bytes from the end, for dst above src
+ *
+ * @param dst Pointer to destination
+ * @param src Pointer to source
+ * @param len Length in bytes (> 16)
+ */
+static MEMOPS_FAST MEMOPS_NO_LIBCALL void memops_copy_backward(uint8_t *dst, const uint8_t *src, size_t len) {
+    dst += len;
+    src += len;
+
+    for (; ((uintptr_t)dst & 3U) != 0U; len--) {
+        *--dst = *--src;
+    }
+
+    for (; len >= 16U; len -= 16U) {
+        uint32_t a;
+        uint32_t b;
+        uint32_t c;
+        uint32_t e;
+
+        dst -= 16;
+        src -= 16;
+        a = memops_load(src + 12U);
+        b = memops_load(src + 8U);
+        c = memops_load(src + 4U);
+        e = memops_load(src);
+        memops_store(dst + 12U, a);
+        memops_store(dst + 8U, b);
+        memops_store(dst + 4U, c);
+        memops_store(dst, e);
+    }
+
+    for (; len >= 4U; len -= 4U) {
+        dst -= 4;
+        src -= 4;
+        memops_store(dst, memops_load(src));
+    }
+
+    for (; len > 0U; len--) {
+        *--dst = *--src;
+    }
+}
@@ -0,0 +1,85 @@
+/**
+  * @file    memops.h
+  * @author  LuckkMaker
+  * @brief   Memory copy and fill component for omni
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef COMPONENT_MEMOPS_H
+#define COMPONENT_MEMOPS_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stddef.h>
+#include "include/device.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * memcpy, memset and memmove with the same semantics as the libc ones.
+ *
+ * - Up to 16 bytes: loads and stores of the first and last words, which
+ *   may overlap, no loop and no alignment check.
+ * - Same alignment of source and destination: bytes up to a word
+ *   boundary, 32 byte bursts, LDM/STM on Cortex-M3/M4, LDRD/STRD on
+ *   Cortex-M7, then words and bytes.
+ * - Different alignment: aligned stores from unaligned word loads,
+ *   which Cortex-M3/M4/M7 do in hardware.
+ *
+ * With CONFIG_MEMOPS_LIBC the component also defines memcpy, memset and
+ * memmove on ARM targets, so existing code uses it without changes.
+ *
+ * @code
+ * memops.copy(frame, packet + 1, len);
+ * memops.set(buffer, 0, sizeof(buffer));
+ * @endcode
+ */
+
+/**
+ * @brief Copy len bytes, buffers must not overlap
+ */
+typedef void *(*memops_copy_t)(void *dst, const void *src, size_t len);
+
+/**
+ * @brief Fill len bytes with a value
+ */
+typedef void *(*memops_set_t)(void *dst, int value, size_t len);
+
+/**
+ * @brief Copy len bytes, buffers may overlap
+ */
+typedef void *(*memops_move_t)(void *dst, const void *src, size_t len);
+
+/**
+ * @brief Memops API
+ */
+struct memops_api {
+    memops_copy_t copy;
+    memops_set_t set;
+    memops_move_t move;
+};
+
+extern const struct memops_api memops;
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* COMPONENT_MEMOPS_H */
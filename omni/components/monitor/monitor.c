@@ -0,0 +1,488 @@
+/**
+  * @file    monitor.c
+  * @author  LuckkMaker
+  * @brief   RTOS monitor component for omni
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdarg.h>
+#include <stdio.h>
+#include "monitor/monitor.h"
+#if defined(CONFIG_RTOS_THREADX)
+#include "tx_api.h"
+#include "tx_thread.h"
+#include "tx_byte_pool.h"
+#include "tx_execution_profile.h"
+#elif defined(CONFIG_RTOS_CMSIS_FREERTOS) || defined(CONFIG_RTOS_CMSIS_RTX)
+#include "cmsis_os2.h"
+#if defined(CONFIG_RTOS_CMSIS_FREERTOS)
+#include "FreeRTOS.h"
+#endif /* CONFIG_RTOS_CMSIS_FREERTOS */
+#else
+#error "Monitor component requires CMSIS-RTOS2 or ThreadX"
+#endif
+#if defined(CONFIG_IRQ_STATS) && !defined(CONFIG_RTOS_THREADX)
+#include "hal/irq_hal.h"
+#endif /* CONFIG_IRQ_STATS */
+#if defined(CONFIG_MONITOR_SHELL_CMD)
+#include "console/console.h"
+#endif /* CONFIG_MONITOR_SHELL_CMD */
+
+#define MONITOR_THREAD_NUM      CONFIG_MONITOR_THREAD_NUM
+
+/**
+ * @brief Per thread cycle account
+ */
+typedef struct {
+    void *id;                       /**< Kernel thread handle, NULL if free */
+    uint64_t cycles;                /**< Total cycles */
+    uint64_t cycles_last;           /**< Total cycles at the last update */
+    uint64_t window;                /**< Cycles in the last window */
+} monitor_slot_t;
+
+static monitor_slot_t monitor_slot[MONITOR_THREAD_NUM];
+static monitor_thread_t monitor_threads[MONITOR_THREAD_NUM];
+static monitor_summary_t monitor_summary;
+static uint64_t monitor_isr_last = 0;
+
+#if defined(CONFIG_RTOS_THREADX)
+static uint64_t monitor_idle_last = 0;
+static uint64_t monitor_total_last = 0;
+static uint32_t monitor_heap_used_max = 0;
+#else
+static osThreadId_t monitor_ids[MONITOR_THREAD_NUM];
+static monitor_slot_t *monitor_current = NULL;
+static uint64_t monitor_isr_cycles = 0;
+static uint64_t monitor_other_cycles = 0;
+static uint64_t monitor_other_last = 0;
+static uint32_t monitor_last_cycle = 0;
+#if defined(CONFIG_IRQ_STATS)
+static uint32_t monitor_last_isr = 0;
+#endif /* CONFIG_IRQ_STATS */
+#endif /* CONFIG_RTOS_THREADX */
+
+static int monitor_update(void);
+static uint32_t monitor_get_threads(monitor_thread_t *threads, uint32_t num);
+static monitor_summary_t monitor_get_summary(void);
+static void monitor_dump(monitor_print_t print);
+
+const struct monitor_api monitor = {
+    .update = monitor_update,
+    .get_threads = monitor_get_threads,
+    .get_summary = monitor_get_summary,
+    .dump = monitor_dump,
+};
+
+static uint32_t monitor_collect(uint64_t *window, uint64_t *isr, uint64_t *idle);
+static monitor_slot_t *monitor_find(void *id, bool alloc);
+static uint32_t monitor_permille(uint64_t part, uint64_t total);
+static void monitor_get_heap(monitor_summary_t *summary);
+
+#if !defined(CONFIG_RTOS_THREADX)
+/**
+ * @brief Account the cycles since the last switch and switch threads
+ *
+ * @note Called by the kernel when a thread is switched in. Handler cycles
+ *       are taken out of the thread time when IRQ statistics are enabled.
+ * @param id Kernel handle of the thread switched in
+ */
+void monitor_thread_switch(void *id) {
+    uint32_t primask;
+    uint32_t now;
+    uint32_t cycles;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    now = DWT->CYCCNT;
+    cycles = now - monitor_last_cycle;
+    monitor_last_cycle = now;
+
+#if defined(CONFIG_IRQ_STATS)
+    uint32_t isr = irq_hal_stats_cycles();
+    uint32_t isr_cycles = isr - monitor_last_isr;
+    monitor_last_isr = isr;
+    monitor_isr_cycles += isr_cycles;
+    cycles = (cycles > isr_cycles) ? (cycles - isr_cycles) : 0;
+#endif /* CONFIG_IRQ_STATS */
+
+    if (monitor_current != NULL) {
+        monitor_current->cycles += cycles;
+    } else {
+        monitor_other_cycles += cycles;
+    }
+
+    if ((monitor_current == NULL) || (monitor_current->id != id)) {
+        monitor_current = monitor_find(id, true);
+    }
+
+    __set_PRIMASK(primask);
+}
+#endif /* CONFIG_RTOS_THREADX */
+
+/**
+ * @brief Close the current window and compute the statistics
+ *
+ * @note Call from thread mode. The first window starts at boot.
+ * @return Operation status
+ */
+static int monitor_update(void) {
+    uint64_t window = 0;
+    uint64_t isr = 0;
+    uint64_t idle = 0;
+    monitor_summary_t summary = {0};
+
+    summary.thread_num = monitor_collect(&window, &isr, &idle);
+    summary.window_us = (uint32_t)(window / (SystemCoreClock / 1000000U));
+    summary.isr_permille = monitor_permille(isr, window);
+    summary.cpu_permille = 1000U - monitor_permille(idle, window);
+    monitor_get_heap(&summary);
+
+    monitor_summary = summary;
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Get thread information of the last window
+ *
+ * @param threads Pointer to thread information array
+ * @param num Number of array elements
+ * @return Number of threads copied
+ */
+static uint32_t monitor_get_threads(monitor_thread_t *threads, uint32_t num) {
+    omni_assert_not_null(threads);
+
+    if (num > monitor_summary.thread_num) {
+        num = monitor_summary.thread_num;
+    }
+
+    for (uint32_t i = 0; i < num; i++) {
+        threads[i] = monitor_threads[i];
+    }
+
+    return num;
+}
+
+/**
+ * @brief Get system summary of the last window
+ *
+ * @return System summary
+ */
+static monitor_summary_t monitor_get_summary(void) {
+    return monitor_summary;
+}
+
+/**
+ * @brief Dump summary and threads of the last window
+ *
+ * @param print Print function
+ */
+static void monitor_dump(monitor_print_t print) {
+    monitor_summary_t *summary = &monitor_summary;
+
+    omni_assert_not_null(print);
+
+    print("cpu %3lu.%lu%%  isr %3lu.%lu%%  window %lu ms\r\n", \
+        (unsigned long)(summary->cpu_permille / 10U), (unsigned long)(summary->cpu_permille % 10U), \
+        (unsigned long)(summary->isr_permille / 10U), (unsigned long)(summary->isr_permille % 10U), \
+        (unsigned long)(summary->window_us / 1000U));
+    if (summary->heap_size != 0U) {
+        print("heap %lu / %lu bytes, max %lu bytes\r\n", (unsigned long)summary->heap_used, \
+            (unsigned long)summary->heap_size, (unsigned long)summary->heap_used_max);
+    } else {
+        print("heap unavailable\r\n");
+    }
+    print("%6s %8s %8s %6s  %s\r\n", "prio", "stack", "max", "cpu%", "name");
+
+    for (uint32_t i = 0; i < summary->thread_num; i++) {
+        monitor_thread_t *thread = &monitor_threads[i];
+
+        print("%6lu %8lu %8lu %4lu.%lu  %s\r\n", (unsigned long)thread->priority, \
+            (unsigned long)thread->stack_size, (unsigned long)thread->stack_used_max, \
+            (unsigned long)(thread->cpu_permille / 10U), (unsigned long)(thread->cpu_permille % 10U), \
+            (thread->name != NULL) ? thread->name : "-");
+    }
+}
+
+/********************* Private functions **********************/
+
+#if defined(CONFIG_RTOS_THREADX)
+/**
+ * @brief Collect thread information from ThreadX
+ *
+ * @param window Pointer to window cycles
+ * @param isr Pointer to handler cycles in the window
+ * @param idle Pointer to idle cycles in the window
+ * @return Number of threads
+ */
+static uint32_t monitor_collect(uint64_t *window, uint64_t *isr, uint64_t *idle) {
+    uint32_t primask;
+    uint32_t num = 0;
+    uint64_t total;
+    uint64_t isr_total;
+    uint64_t idle_total;
+    TX_THREAD *thread;
+    monitor_slot_t *slot;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    isr_total = _tx_execution_isr_time_total;
+    idle_total = _tx_execution_idle_time_total;
+    total = isr_total + idle_total + _tx_execution_thread_time_total;
+    *window = total - monitor_total_last;
+    *isr = isr_total - monitor_isr_last;
+    *idle = idle_total - monitor_idle_last;
+    monitor_total_last = total;
+    monitor_isr_last = isr_total;
+    monitor_idle_last = idle_total;
+
+    thread = _tx_thread_created_ptr;
+    for (uint32_t i = 0; (i < _tx_thread_created_count) && (num < MONITOR_THREAD_NUM); i++) {
+        slot = monitor_find(thread, true);
+        if (slot != NULL) {
+            slot->cycles = thread->tx_thread_execution_time_total;
+            slot->window = slot->cycles - slot->cycles_last;
+            slot->cycles_last = slot->cycles;
+        }
+
+        monitor_threads[num].id = thread;
+        monitor_threads[num].name = thread->tx_thread_name;
+        monitor_threads[num].priority = thread->tx_thread_priority;
+        monitor_threads[num].stack_size = thread->tx_thread_stack_size;
+        monitor_threads[num].stack_used_max = (uint32_t)thread->tx_thread_stack_end - \
+            (uint32_t)thread->tx_thread_stack_highest_ptr;
+        monitor_threads[num].cpu_permille = (slot != NULL) ? monitor_permille(slot->window, *window) : 0;
+        num++;
+
+        thread = thread->tx_thread_created_next;
+    }
+
+    __set_PRIMASK(primask);
+
+    return num;
+}
+#else
+/**
+ * @brief Collect thread information from CMSIS-RTOS2
+ *
+ * @param window Pointer to window cycles
+ * @param isr Pointer to handler cycles in the window
+ * @param idle Pointer to idle cycles in the window
+ * @return Number of threads
+ */
+static uint32_t monitor_collect(uint64_t *window, uint64_t *isr, uint64_t *idle) {
+    uint32_t primask;
+    uint32_t num;
+    monitor_slot_t *slot;
+
+    // Charge the running thread up to now and close the window
+    primask = __get_PRIMASK();
+    __disable_irq();
+    monitor_thread_switch(osThreadGetId());
+    *window = 0;
+    for (uint32_t i = 0; i < MONITOR_THREAD_NUM; i++) {
+        monitor_slot[i].window = monitor_slot[i].cycles - monitor_slot[i].cycles_last;
+        monitor_slot[i].cycles_last = monitor_slot[i].cycles;
+        *window += monitor_slot[i].window;
+    }
+    *window += monitor_other_cycles - monitor_other_last;
+    monitor_other_last = monitor_other_cycles;
+    *isr = monitor_isr_cycles - monitor_isr_last;
+    monitor_isr_last = monitor_isr_cycles;
+    *window += *isr;
+    __set_PRIMASK(primask);
+
+    num = osThreadEnumerate(monitor_ids, MONITOR_THREAD_NUM);
+    for (uint32_t i = 0; i < num; i++) {
+        slot = monitor_find(monitor_ids[i], false);
+
+        monitor_threads[i].id = monitor_ids[i];
+        monitor_threads[i].name = osThreadGetName(monitor_ids[i]);
+        monitor_threads[i].priority = (uint32_t)osThreadGetPriority(monitor_ids[i]);
+        monitor_threads[i].stack_size = osThreadGetStackSize(monitor_ids[i]);
+        monitor_threads[i].stack_used_max = 0;
+        // Size 0 means the kernel does not report it, leave the mark at 0
+        if (monitor_threads[i].stack_size != 0U) {
+            uint32_t space = osThreadGetStackSpace(monitor_ids[i]);
+
+            if (space < monitor_threads[i].stack_size) {
+                monitor_threads[i].stack_used_max = monitor_threads[i].stack_size - space;
+            }
+        }
+        monitor_threads[i].cpu_permille = (slot != NULL) ? monitor_permille(slot->window, *window) : 0;
+
+        // The kernel idle thread runs at the idle priority
+        if ((slot != NULL) && (monitor_threads[i].priority == (uint32_t)osPriorityIdle)) {
+            *idle += slot->window;
+        }
+    }
+
+    // Release accounts of deleted threads
+    __disable_irq();
+    for (uint32_t i = 0; i < MONITOR_THREAD_NUM; i++) {
+        bool found = (monitor_slot[i].id == NULL) || (&monitor_slot[i] == monitor_current);
+        for (uint32_t j = 0; (j < num) && !found; j++) {
+            found = (monitor_slot[i].id == monitor_ids[j]);
+        }
+        if (!found) {
+            monitor_slot[i] = (monitor_slot_t){0};
+        }
+    }
+    __set_PRIMASK(primask);
+
+    return num;
+}
+#endif /* CONFIG_RTOS_THREADX */
+
+/**
+ * @brief Find the account of a thread
+ *
+ * @param id Kernel thread handle
+ * @param alloc Allocate a free account if not found
+ * @return Pointer to account, NULL if not found or full
+ */
+static monitor_slot_t *monitor_find(void *id, bool alloc) {
+    monitor_slot_t *free = NULL;
+
+    if (id == NULL) {
+        return NULL;
+    }
+
+    for (uint32_t i = 0; i < MONITOR_THREAD_NUM; i++) {
+        if (monitor_slot[i].id == id) {
+            return &monitor_slot[i];
+        }
+        if ((free == NULL) && (monitor_slot[i].id == NULL)) {
+            free = &monitor_slot[i];
+        }
+    }
+
+    if (!alloc || (free == NULL)) {
+        return NULL;
+    }
+
+    *free = (monitor_slot_t){0};
+    free->id = id;
+
+    return free;
+}
+
+/**
+ * @brief Compute a share in permille
+ *
+ * @param part Part cycles
+ * @param total Total cycles
+ * @return Share in permille
+ */
+static uint32_t monitor_permille(uint64_t part, uint64_t total) {
+    if (total == 0) {
+        return 0;
+    }
+
+    if (part > total) {
+        part = total;
+    }
+
+    return (uint32_t)((part * 1000U + total / 2U) / total);
+}
+
+/**
+ * @brief Get heap usage
+ *
+ * @note FreeRTOS reports its heap, ThreadX the sum of all byte pools with
+ *       the high-water mark sampled at each update. RTX5 has no usage
+ *       query for its memory pool and the C library heap is toolchain
+ *       specific, the heap is reported as unknown there.
+ * @param summary Pointer to summary
+ */
+static void monitor_get_heap(monitor_summary_t *summary) {
+#if defined(CONFIG_RTOS_CMSIS_FREERTOS)
+    summary->heap_size = configTOTAL_HEAP_SIZE;
+    summary->heap_used = configTOTAL_HEAP_SIZE - xPortGetFreeHeapSize();
+    summary->heap_used_max = configTOTAL_HEAP_SIZE - xPortGetMinimumEverFreeHeapSize();
+#elif defined(CONFIG_RTOS_THREADX)
+    uint32_t primask;
+    TX_BYTE_POOL *pool;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    pool = _tx_byte_pool_created_ptr;
+    for (uint32_t i = 0; i < _tx_byte_pool_created_count; i++) {
+        summary->heap_size += pool->tx_byte_pool_size;
+        summary->heap_used += pool->tx_byte_pool_size - pool->tx_byte_pool_available;
+        pool = pool->tx_byte_pool_created_next;
+    }
+
+    __set_PRIMASK(primask);
+
+    if (summary->heap_used > monitor_heap_used_max) {
+        monitor_heap_used_max = summary->heap_used;
+    }
+    summary->heap_used_max = monitor_heap_used_max;
+#else
+    summary->heap_size = 0;
+    summary->heap_used = 0;
+    summary->heap_used_max = 0;
+#endif /* CONFIG_RTOS_CMSIS_FREERTOS */
+}
+
+#if defined(CONFIG_MONITOR_SHELL_CMD)
+/**
+ * @brief Print to the current shell
+ *
+ * @param format Format string
+ * @return Number of characters printed
+ */
+static int monitor_shell_print(const char *format, ...) {
+    char buffer[96];
+    int len;
+    va_list args;
+
+    va_start(args, format);
+    len = vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+
+    shellWriteString(shellGetCurrent(), buffer);
+
+    return len;
+}
+
+/**
+ * @brief Monitor shell command
+ *
+ * @note Each call closes a window, so the CPU shares cover the time since
+ *       the previous call.
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @return Operation status
+ */
+static int monitor_shell_cmd(int argc, char *argv[]) {
+    (void)argc;
+    (void)argv;
+
+    monitor_update();
+    monitor_dump(monitor_shell_print);
+
+    return 0;
+}
+SHELL_EXPORT_CMD(SHELL_CMD_PERMISSION(0) | SHELL_CMD_TYPE(SHELL_TYPE_CMD_MAIN), top, monitor_shell_cmd, top);
+#endif /* CONFIG_MONITOR_SHELL_CMD */
@@ -0,0 +1,119 @@
+/**
+  * @file    monitor.h
+  * @author  LuckkMaker
+  * @brief   RTOS monitor component for omni
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef COMPONENT_MONITOR_H
+#define COMPONENT_MONITOR_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "include/device.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * CPU time is measured in DWT cycles and reported as permille of the window
+ * between two monitor.update() calls.
+ *
+ * - ThreadX: thread, ISR and idle time come from the execution profile kit,
+ *   build ThreadX with TX_EXECUTION_PROFILE_ENABLE.
+ * - CMSIS-RTOS2: the kernel calls monitor_thread_switch() whenever a thread
+ *   is switched in, for FreeRTOS in FreeRTOSConfig.h:
+ *     #define traceTASK_SWITCHED_IN() monitor_thread_switch(pxCurrentTCB)
+ *   and for RTX5 from the EvrRtxThreadSwitched event function. Handler
+ *   time is taken from the IRQ statistics and not charged to threads.
+ *
+ * Stack high-water marks come from the kernel stack watermarking, build
+ * ThreadX with TX_ENABLE_STACK_CHECKING. Heap usage comes from the FreeRTOS
+ * heap or the ThreadX byte pools, it is unavailable on RTX5.
+ */
+
+/**
+ * @brief Thread information
+ */
+typedef struct monitor_thread {
+    const char *name;               /**< Thread name */
+    void *id;                       /**< Kernel thread handle */
+    uint32_t priority;              /**< Priority */
+    uint32_t stack_size;            /**< Stack size in bytes */
+    uint32_t stack_used_max;        /**< Stack high-water mark in bytes */
+    uint32_t cpu_permille;          /**< CPU time in the last window */
+} monitor_thread_t;
+
+/**
+ * @brief System summary
+ */
+typedef struct monitor_summary {
+    uint32_t window_us;             /**< Length of the last window */
+    uint32_t cpu_permille;          /**< Busy time, threads and handlers */
+    uint32_t isr_permille;          /**< Handler time */
+    uint32_t thread_num;            /**< Number of threads */
+    uint32_t heap_size;             /**< Heap size in bytes, 0 if unknown */
+    uint32_t heap_used;             /**< Heap in use in bytes */
+    uint32_t heap_used_max;         /**< Heap high-water mark in bytes */
+} monitor_summary_t;
+
+/**
+ * @brief Print function used to dump the monitor
+ */
+typedef int (*monitor_print_t)(const char *format, ...);
+
+/**
+ * @brief Close the current window and compute the statistics
+ */
+typedef int (*monitor_update_t)(void);
+
+/**
+ * @brief Get thread information of the last window
+ */
+typedef uint32_t (*monitor_get_threads_t)(monitor_thread_t *threads, uint32_t num);
+
+/**
+ * @brief Get system summary of the last window
+ */
+typedef monitor_summary_t (*monitor_get_summary_t)(void);
+
+/**
+ * @brief Dump summary and threads
+ */
+typedef void (*monitor_dump_t)(monitor_print_t print);
+
+/**
+ * @brief Monitor API
+ */
+struct monitor_api {
+    monitor_update_t update;
+    monitor_get_threads_t get_threads;
+    monitor_get_summary_t get_summary;
+    monitor_dump_t dump;
+};
+
+extern const struct monitor_api monitor;
+
+void monitor_thread_switch(void *id);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* COMPONENT_MONITOR_H */
@@ -0,0 +1,251 @@
+/**
+  * @file    mpu.c
+  * @author  LuckkMaker
+  * @brief   MPU region manager component for omni
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+
+/* Includes ------------------------------------------------------------------*/
+#include "mpu/mpu.h"
+
+#if defined(CONFIG_MPU_NOCACHE)
+#if defined(__ARMCC_VERSION)
+extern uint8_t Image$$RW_NOCACHE$$Base[];
+extern uint8_t Image$$RW_NOCACHE$$Limit[];
+#define MPU_NOCACHE_START       ((uint32_t)Image$$RW_NOCACHE$$Base)
+#define MPU_NOCACHE_END         ((uint32_t)Image$$RW_NOCACHE$$Limit)
+#else
+extern uint8_t _snoncacheable[];
+extern uint8_t _enoncacheable[];
+#define MPU_NOCACHE_START       ((uint32_t)_snoncacheable)
+#define MPU_NOCACHE_END         ((uint32_t)_enoncacheable)
+#endif /* __ARMCC_VERSION */
+#endif /* CONFIG_MPU_NOCACHE */
+
+#if defined(CONFIG_MPU_STACK_GUARD)
+#if defined(__ARMCC_VERSION)
+extern uint8_t Image$$ARM_LIB_STACK$$ZI$$Base[];
+#define MPU_STACK_BOTTOM        ((uint32_t)Image$$ARM_LIB_STACK$$ZI$$Base)
+#else
+extern uint8_t _estack[];
+extern uint8_t _Min_Stack_Size[];
+#define MPU_STACK_BOTTOM        ((uint32_t)_estack - (uint32_t)_Min_Stack_Size)
+#endif /* __ARMCC_VERSION */
+#endif /* CONFIG_MPU_STACK_GUARD */
+
+// Next free region number
+static uint32_t mpu_region_next;
+
+static int mpu_init(void);
+static int mpu_add_region(const mpu_region_t *region);
+static bool mpu_is_nocache(const void *data, uint32_t len);
+static uint32_t mpu_get_attr(mpu_mem_t attr);
+static uint32_t mpu_get_perm(mpu_perm_t perm);
+
+const struct mpu_api mpu = {
+    .init = mpu_init,
+    .add_region = mpu_add_region,
+    .is_nocache = mpu_is_nocache,
+};
+
+/**
+ * @brief Initialize MPU, program startup regions and enable it
+ *
+ * @note Call before the caches are enabled, a region changing the
+ *       cacheability of memory already held in the cache would leave
+ *       stale lines behind.
+ * @return Operation status
+ */
+static int mpu_init(void) {
+    const mpu_region_t *table;
+    uint32_t num = 0;
+    uint32_t regions;
+
+    regions = (MPU->TYPE & MPU_TYPE_DREGION_Msk) >> MPU_TYPE_DREGION_Pos;
+    if (regions == 0U) {
+        return OMNI_FAIL;
+    }
+
+    ARM_MPU_Disable();
+
+    for (uint32_t i = 0; i < regions; i++) {
+        ARM_MPU_ClrRegion(i);
+    }
+    mpu_region_next = 0;
+
+    ARM_MPU_Enable(MPU_CTRL_PRIVDEFENA_Msk);
+
+    table = mpu_board_regions(&num);
+    for (uint32_t i = 0; i < num; i++) {
+        if (mpu_add_region(&table[i]) < 0) {
+            return OMNI_FAIL;
+        }
+    }
+
+#if defined(CONFIG_MPU_NOCACHE)
+    if (MPU_NOCACHE_END > MPU_NOCACHE_START) {
+        uint32_t len = MPU_NOCACHE_END - MPU_NOCACHE_START;
+        mpu_region_t region = {
+            .base = MPU_NOCACHE_START,
+            .size = mpu_region_size(len),
+            .attr = MPU_MEM_NOCACHE,
+            .perm = MPU_PERM_RW,
+            .exec = false,
+        };
+
+        if (mpu_add_region(&region) < 0) {
+            return OMNI_FAIL;
+        }
+    }
+#endif /* CONFIG_MPU_NOCACHE */
+
+#if defined(CONFIG_MPU_STACK_GUARD)
+    {
+        mpu_region_t region = {
+            .base = mpu_guard_base(MPU_STACK_BOTTOM),
+            .size = MPU_REGION_MIN_SIZE,
+            .attr = MPU_MEM_WRITE_BACK,
+            .perm = MPU_PERM_NONE,
+            .exec = false,
+        };
+
+        if (mpu_add_region(&region) < 0) {
+            return OMNI_FAIL;
+        }
+    }
+#endif /* CONFIG_MPU_STACK_GUARD */
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Add a region
+ *
+ * @note Regions added later take priority where regions overlap.
+ * @param region Pointer to region
+ * @return Region number, OMNI_FAIL if the region is invalid or no
+ *         region is left
+ */
+static int mpu_add_region(const mpu_region_t *region) {
+    omni_assert_not_null(region);
+
+    uint32_t regions = (MPU->TYPE & MPU_TYPE_DREGION_Msk) >> MPU_TYPE_DREGION_Pos;
+    uint32_t number;
+    uint32_t primask;
+
+    if (!mpu_region_is_valid(region->base, region->size)) {
+        return OMNI_FAIL;
+    }
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    if (mpu_region_next >= regions) {
+        __set_PRIMASK(primask);
+        return OMNI_FAIL;
+    }
+    number = mpu_region_next++;
+
+    // SIZE field holds log2(size) - 1
+    ARM_MPU_Disable();
+    ARM_MPU_SetRegion(ARM_MPU_RBAR(number, region->base),
+                      ARM_MPU_RASR_EX(region->exec ? 0U : 1U, mpu_get_perm(region->perm),
+                                      mpu_get_attr(region->attr), 0U, 30U - __CLZ(region->size)));
+    ARM_MPU_Enable(MPU_CTRL_PRIVDEFENA_Msk);
+
+    __set_PRIMASK(primask);
+
+    return (int)number;
+}
+
+/**
+ * @brief Check if a buffer lies in the non-cacheable section
+ *
+ * @param data Pointer to buffer
+ * @param len Length in bytes
+ * @return True if the whole buffer is in the section
+ */
+static bool mpu_is_nocache(const void *data, uint32_t len) {
+#if defined(CONFIG_MPU_NOCACHE)
+    uint32_t addr = (uint32_t)data;
+
+    return (addr >= MPU_NOCACHE_START) && (addr <= MPU_NOCACHE_END) &&
+           (len <= (MPU_NOCACHE_END - addr));
+#else
+    (void)data;
+    (void)len;
+
+    return false;
+#endif /* CONFIG_MPU_NOCACHE */
+}
+
+/**
+ * @brief Get the regions of the board
+ *
+ * @note Override to add board regions, the table must stay valid.
+ * @param num Number of regions
+ * @return Pointer to region table
+ */
+__weak const mpu_region_t *mpu_board_regions(uint32_t *num) {
+    *num = 0;
+
+    return NULL;
+}
+
+/********************* Private functions **********************/
+
+/**
+ * @brief Get the RASR access attributes of a memory type
+ *
+ * @param attr Memory attribute
+ * @return TEX, S, C and B bits
+ */
+static uint32_t mpu_get_attr(mpu_mem_t attr) {
+    switch (attr) {
+        case MPU_MEM_WRITE_THROUGH:
+            return ARM_MPU_ACCESS_NORMAL(ARM_MPU_CACHEP_WT_NWA, ARM_MPU_CACHEP_WT_NWA, 0U);
+        case MPU_MEM_NOCACHE:
+            return ARM_MPU_ACCESS_NORMAL(ARM_MPU_CACHEP_NOCACHE, ARM_MPU_CACHEP_NOCACHE, 1U);
+        case MPU_MEM_DEVICE:
+            return ARM_MPU_ACCESS_DEVICE(1U);
+        case MPU_MEM_STRONGLY_ORDERED:
+            return ARM_MPU_ACCESS_ORDERED;
+        case MPU_MEM_WRITE_BACK:
+        default:
+            return ARM_MPU_ACCESS_NORMAL(ARM_MPU_CACHEP_WB_WRA, ARM_MPU_CACHEP_WB_WRA, 0U);
+    }
+}
+
+/**
+ * @brief Get the RASR access permission
+ *
+ * @param perm Access permission
+ * @return AP field value
+ */
+static uint32_t mpu_get_perm(mpu_perm_t perm) {
+    switch (perm) {
+        case MPU_PERM_RO:
+            return ARM_MPU_AP_RO;
+        case MPU_PERM_NONE:
+            return ARM_MPU_AP_NONE;
+        case MPU_PERM_RW:
+        default:
+            return ARM_MPU_AP_FULL;
+    }
+}
@@ -0,0 +1,178 @@
+/**
+  * @file    mpu.h
+  * @author  LuckkMaker
+  * @brief   MPU region manager component for omni
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef COMPONENT_MPU_H
+#define COMPONENT_MPU_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "include/device.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Regions are programmed in this order, a later region takes priority
+ * where regions overlap:
+ *   1. the table returned by mpu_board_regions()
+ *   2. the non-cacheable DMA region (MPU_NOCACHE)
+ *   3. the main stack guard (MPU_STACK_GUARD)
+ * The default memory map stays enabled as background region for
+ * privileged code. A region size is a power of two of at least 32
+ * bytes and its base is aligned to its size.
+ *
+ * @code
+ * static const mpu_region_t board_regions[] = {
+ *     // AXI SRAM as write-through, framebuffers need no cache maintenance
+ *     { .base = 0x24000000, .size = 512 * 1024, .attr = MPU_MEM_WRITE_THROUGH, .perm = MPU_PERM_RW },
+ * };
+ *
+ * const mpu_region_t *mpu_board_regions(uint32_t *num) {
+ *     *num = sizeof(board_regions) / sizeof(board_regions[0]);
+ *     return board_regions;
+ * }
+ *
+ * MPU_NOCACHE_SECTION static uint8_t rx_buffer[512];
+ * @endcode
+ */
+
+/**
+ * @brief Place a variable in the non-cacheable region
+ */
+#define MPU_NOCACHE_SECTION     __attribute__((section(".noncacheable")))
+
+/**
+ * @brief MPU memory attribute
+ */
+typedef enum {
+    MPU_MEM_WRITE_BACK = 0,         /**< Normal memory, write-back, read and write allocate */
+    MPU_MEM_WRITE_THROUGH,          /**< Normal memory, write-through, no write allocate */
+    MPU_MEM_NOCACHE,                /**< Normal memory, non-cacheable, shareable */
+    MPU_MEM_DEVICE,                 /**< Shareable device memory */
+    MPU_MEM_STRONGLY_ORDERED,       /**< Strongly ordered memory */
+} mpu_mem_t;
+
+/**
+ * @brief MPU access permission
+ */
+typedef enum {
+    MPU_PERM_RW = 0,                /**< Read and write */
+    MPU_PERM_RO,                    /**< Read only */
+    MPU_PERM_NONE,                  /**< No access */
+} mpu_perm_t;
+
+/**
+ * @brief MPU region
+ */
+typedef struct mpu_region {
+    uint32_t base;                  /**< Base address, aligned to size */
+    uint32_t size;                  /**< Size in bytes, power of two, 32 bytes or more */
+    mpu_mem_t attr;                 /**< Memory attribute */
+    mpu_perm_t perm;                /**< Access permission */
+    bool exec;                      /**< Allow instruction fetches */
+} mpu_region_t;
+
+/**
+ * @brief Initialize MPU, program startup regions and enable it
+ */
+typedef int (*mpu_init_t)(void);
+
+/**
+ * @brief Add a region, returns region number or OMNI_FAIL
+ */
+typedef int (*mpu_add_region_t)(const mpu_region_t *region);
+
+/**
+ * @brief Check if a buffer lies in the non-cacheable section
+ */
+typedef bool (*mpu_is_nocache_t)(const void *data, uint32_t len);
+
+/**
+ * @brief MPU API
+ */
+struct mpu_api {
+    mpu_init_t init;
+    mpu_add_region_t add_region;
+    mpu_is_nocache_t is_nocache;
+};
+
+extern const struct mpu_api mpu;
+
+const mpu_region_t *mpu_board_regions(uint32_t *num);
+
+#define MPU_REGION_MIN_SIZE     32U
+#define MPU_REGION_MAX_SIZE     0x80000000U
+
+/**
+ * @brief Smallest region size covering a length
+ *
+ * @param len Length in bytes
+ * @return Power of two of at least MPU_REGION_MIN_SIZE, 0 if @p len is
+ *         above MPU_REGION_MAX_SIZE
+ */
+static inline uint32_t mpu_region_size(uint32_t len) {
+    uint32_t size = MPU_REGION_MIN_SIZE;
+
+    if (len > MPU_REGION_MAX_SIZE) {
+        return 0U;
+    }
+
+    while (size < len) {
+        size <<= 1;
+    }
+
+    return size;
+}
+
+/**
+ * @brief Check the size and base alignment of a region
+ *
+ * @param base Base address
+ * @param size Size in bytes
+ * @return True if the MPU can hold the region
+ */
+static inline bool mpu_region_is_valid(uint32_t base, uint32_t size) {
+    if ((size < MPU_REGION_MIN_SIZE) || ((size & (size - 1U)) != 0U)) {
+        return false;
+    }
+
+    return (base & (size - 1U)) == 0U;
+}
+
+/**
+ * @brief Base of the stack guard region
+ *
+ * @note Rounded up so that the guard stays inside the stack.
+ * @param bottom Lowest address of the stack
+ * @return Base of a MPU_REGION_MIN_SIZE region
+ */
+static inline uint32_t mpu_guard_base(uint32_t bottom) {
+    return (bottom + MPU_REGION_MIN_SIZE - 1U) & ~(MPU_REGION_MIN_SIZE - 1U);
+}
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* COMPONENT_MPU_H */
@@ -0,0 +1,198 @@
+/**
+  * @file    profiler.c
+  * @author  LuckkMaker
+  * @brief   Cycle profiler component for omni
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include "profiler/profiler.h"
+#if defined(CONFIG_SEGGER_RTT)
+#include "SEGGER_RTT.h"
+#endif /* CONFIG_SEGGER_RTT */
+#if defined(CONFIG_PROFILER_SHELL_CMD)
+#include "console/console.h"
+#endif /* CONFIG_PROFILER_SHELL_CMD */
+
+// Zones are linked on their first sample, the list ends with a sentinel
+static profiler_zone_t profiler_zone_end;
+static profiler_zone_t *profiler_zone_head = &profiler_zone_end;
+
+static void profiler_record(profiler_zone_t *zone, uint32_t cycles);
+static void profiler_reset(void);
+static void profiler_dump(profiler_print_t print, bool histogram);
+
+const struct profiler_api profiler = {
+    .record = profiler_record,
+    .reset = profiler_reset,
+    .dump = profiler_dump,
+};
+
+/**
+ * @brief Link a zone on its first sample, called by profiler_zone_record
+ *
+ * @param zone Pointer to profiler zone
+ */
+void profiler_zone_link(profiler_zone_t *zone) {
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    if (zone->next == NULL) {
+        zone->next = profiler_zone_head;
+        profiler_zone_head = zone;
+    }
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Record a sample
+ *
+ * @param zone Pointer to profiler zone
+ * @param cycles Cycles spent in the zone
+ */
+static void profiler_record(profiler_zone_t *zone, uint32_t cycles) {
+    profiler_zone_record(zone, cycles);
+}
+
+/**
+ * @brief Reset statistics of all zones
+ */
+static void profiler_reset(void) {
+    for (profiler_zone_t *zone = profiler_zone_head; zone != &profiler_zone_end; zone = zone->next) {
+        zone->count = 0;
+        zone->min = UINT32_MAX;
+        zone->max = 0;
+        zone->total = 0;
+#if defined(CONFIG_PROFILER_HISTOGRAM)
+        for (uint32_t i = 0; i < PROFILER_HISTOGRAM_NUM; i++) {
+            zone->histogram[i] = 0;
+        }
+#endif /* CONFIG_PROFILER_HISTOGRAM */
+    }
+}
+
+/**
+ * @brief Dump statistics of all zones
+ *
+ * @param print Print function
+ * @param histogram Dump the non-empty histogram buckets as well, ignored
+ *                  without CONFIG_PROFILER_HISTOGRAM
+ */
+static void profiler_dump(profiler_print_t print, bool histogram) {
+    omni_assert_not_null(print);
+#if !defined(CONFIG_PROFILER_HISTOGRAM)
+    UNUSED(histogram);
+#endif /* CONFIG_PROFILER_HISTOGRAM */
+
+    print("%-20s %10s %10s %10s %10s\r\n", "zone", "count", "min", "max", "mean");
+
+    for (profiler_zone_t *zone = profiler_zone_head; zone != &profiler_zone_end; zone = zone->next) {
+        if (zone->count == 0) {
+            print("%-20s %10u %10s %10s %10s\r\n", zone->name, 0U, "-", "-", "-");
+            continue;
+        }
+
+        print("%-20s %10lu %10lu %10lu %10lu\r\n", zone->name, (unsigned long)zone->count, \
+            (unsigned long)zone->min, (unsigned long)zone->max, (unsigned long)(zone->total / zone->count));
+
+#if defined(CONFIG_PROFILER_HISTOGRAM)
+        if (!histogram) {
+            continue;
+        }
+
+        for (uint32_t i = 0; i < PROFILER_HISTOGRAM_NUM; i++) {
+            if (zone->histogram[i] != 0) {
+                // Bucket i holds samples in [2^i, 2^(i+1)) cycles
+                print("  >= 2^%-2lu %21lu\r\n", (unsigned long)i, (unsigned long)zone->histogram[i]);
+            }
+        }
+#endif /* CONFIG_PROFILER_HISTOGRAM */
+    }
+}
+
+#if defined(CONFIG_SEGGER_RTT)
+/**
+ * @brief Print to RTT channel 0
+ *
+ * @note SEGGER_RTT_vprintf ignores field widths, the line is formatted
+ *       with vsnprintf so the dump stays aligned.
+ * @param format Format string
+ * @return Number of characters printed
+ */
+int profiler_rtt_print(const char *format, ...) {
+    char buffer[96];
+    int len;
+    va_list args;
+
+    va_start(args, format);
+    len = vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+
+    if (len < 0) {
+        return len;
+    }
+
+    SEGGER_RTT_Write(0, buffer, strlen(buffer));
+
+    return len;
+}
+#endif /* CONFIG_SEGGER_RTT */
+
+#if defined(CONFIG_PROFILER_SHELL_CMD)
+/**
+ * @brief Print to the current shell
+ *
+ * @param format Format string
+ * @return Number of characters printed
+ */
+static int profiler_shell_print(const char *format, ...) {
+    char buffer[96];
+    int len;
+    va_list args;
+
+    va_start(args, format);
+    len = vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+
+    shellWriteString(shellGetCurrent(), buffer);
+
+    return len;
+}
+
+/**
+ * @brief Profiler shell command
+ *
+ * @param argc Number of arguments
+ * @param argv Arguments, "reset" clears the zones and "hist" adds histograms
+ * @return Operation status
+ */
+static int profiler_shell_cmd(int argc, char *argv[]) {
+    if ((argc > 1) && (strcmp(argv[1], "reset") == 0)) {
+        profiler_reset();
+        return 0;
+    }
+
+    profiler_dump(profiler_shell_print, (argc > 1) && (strcmp(argv[1], "hist") == 0));
+
+    return 0;
+}
+SHELL_EXPORT_CMD(SHELL_CMD_PERMISSION(0) | SHELL_CMD_TYPE(SHELL_TYPE_CMD_MAIN), profiler, profiler_shell_cmd, profiler [hist|reset]);
+#endif /* CONFIG_PROFILER_SHELL_CMD */
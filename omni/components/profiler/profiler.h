@@ -0,0 +1,176 @@
+/**
+  * @file    profiler.h
+  * @author  LuckkMaker
+  * @brief   Cycle profiler component for omni
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef COMPONENT_PROFILER_H
+#define COMPONENT_PROFILER_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "include/device.h"
+
+/**
+ * Zones are measured with the DWT cycle counter. Begin is a single load of
+ * CYCCNT and end takes a second load before the statistics are updated, so
+ * the update itself is not part of the measured cycles. The update is
+ * inlined at the end of the zone, only the first sample of a zone calls
+ * into profiler.c to link it.
+ *
+ * @code
+ * PROFILER_ZONE_DEFINE(spi_isr);
+ *
+ * void spi_handler(void) {
+ *     PROFILER_BEGIN(spi_isr);
+ *     ...
+ *     PROFILER_END(spi_isr);
+ * }
+ * @endcode
+ *
+ * Without CONFIG_COMPONENT_PROFILER the macros expand to nothing, so zones
+ * can stay in production code.
+ */
+
+#if defined(CONFIG_COMPONENT_PROFILER)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PROFILER_HISTOGRAM_NUM      32U
+
+/**
+ * @brief Profiler zone
+ *
+ * @note A zone keeps no begin state, so it can be nested with other zones.
+ *       Statistics are not updated atomically, use a zone from one context.
+ */
+typedef struct profiler_zone {
+    const char *name;                               /**< Zone name */
+    uint32_t count;                                 /**< Number of samples */
+    uint32_t min;                                   /**< Minimum cycles */
+    uint32_t max;                                   /**< Maximum cycles */
+    uint64_t total;                                 /**< Sum of cycles */
+#if defined(CONFIG_PROFILER_HISTOGRAM)
+    uint32_t histogram[PROFILER_HISTOGRAM_NUM];     /**< Samples per log2 bucket */
+#endif /* CONFIG_PROFILER_HISTOGRAM */
+    struct profiler_zone *next;                     /**< Next registered zone */
+} profiler_zone_t;
+
+/**
+ * @brief Print function used to dump zones
+ */
+typedef int (*profiler_print_t)(const char *format, ...);
+
+/**
+ * @brief Record a sample
+ */
+typedef void (*profiler_record_t)(profiler_zone_t *zone, uint32_t cycles);
+
+/**
+ * @brief Reset statistics of all zones
+ */
+typedef void (*profiler_reset_t)(void);
+
+/**
+ * @brief Dump statistics of all zones
+ */
+typedef void (*profiler_dump_t)(profiler_print_t print, bool histogram);
+
+/**
+ * @brief Profiler API
+ */
+struct profiler_api {
+    profiler_record_t record;
+    profiler_reset_t reset;
+    profiler_dump_t dump;
+};
+
+extern const struct profiler_api profiler;
+
+void profiler_zone_link(profiler_zone_t *zone);
+
+#if defined(CONFIG_SEGGER_RTT)
+int profiler_rtt_print(const char *format, ...);
+#endif /* CONFIG_SEGGER_RTT */
+
+/**
+ * @brief Record a sample, inlined by PROFILER_END
+ *
+ * @param zone Pointer to profiler zone
+ * @param cycles Cycles spent in the zone
+ */
+static inline void profiler_zone_record(profiler_zone_t *zone, uint32_t cycles) {
+    if (zone->next == NULL) {
+        profiler_zone_link(zone);
+    }
+
+    zone->count++;
+    zone->total += cycles;
+#if defined(CONFIG_PROFILER_HISTOGRAM)
+    zone->histogram[(cycles == 0U) ? 0U : (31U - __CLZ(cycles))]++;
+#endif /* CONFIG_PROFILER_HISTOGRAM */
+    if (cycles < zone->min) {
+        zone->min = cycles;
+    }
+    if (cycles > zone->max) {
+        zone->max = cycles;
+    }
+}
+
+#define PROFILER_ZONE_DEFINE(zone)  profiler_zone_t zone = { .name = #zone, .min = UINT32_MAX }
+#define PROFILER_ZONE_DECLARE(zone) extern profiler_zone_t zone
+#define PROFILER_BEGIN(zone)        uint32_t profiler_start_##zone = DWT->CYCCNT
+#define PROFILER_END(zone)          profiler_zone_record(&(zone), DWT->CYCCNT - profiler_start_##zone)
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#ifdef __cplusplus
+/**
+ * @brief Profiler scope guard, records the zone when the scope ends
+ */
+class profiler_scope {
+public:
+    explicit profiler_scope(profiler_zone_t &zone) : zone_(zone), start_(DWT->CYCCNT) {}
+    ~profiler_scope() { profiler_zone_record(&zone_, DWT->CYCCNT - start_); }
+    profiler_scope(const profiler_scope &) = delete;
+    profiler_scope &operator=(const profiler_scope &) = delete;
+
+private:
+    profiler_zone_t &zone_;
+    uint32_t start_;
+};
+
+#define PROFILER_SCOPE(zone)        profiler_scope profiler_scope_##zone(zone)
+#endif /* __cplusplus */
+
+#else
+
+#define PROFILER_ZONE_DEFINE(zone)  typedef int profiler_zone_unused_##zone
+#define PROFILER_ZONE_DECLARE(zone) typedef int profiler_zone_unused_##zone
+#define PROFILER_BEGIN(zone)        do {} while (0)
+#define PROFILER_END(zone)          do {} while (0)
+#define PROFILER_SCOPE(zone)        do {} while (0)
+
+#endif /* CONFIG_COMPONENT_PROFILER */
+
+#endif /* COMPONENT_PROFILER_H */
@@ -0,0 +1,350 @@
+/**
+  * @file    retarget.c
+  * @author  LuckkMaker
+  * @brief   Buffered stdio retarget component for omni
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "retarget/retarget.h"
+#if defined(CONFIG_RETARGET_USART)
+#include "drivers/usart.h"
+#endif /* CONFIG_RETARGET_USART */
+#if defined(CONFIG_RETARGET_RTT)
+#include "SEGGER_RTT.h"
+#endif /* CONFIG_RETARGET_RTT */
+
+#define RETARGET_BUFFER_MASK    (CONFIG_RETARGET_BUFFER_SIZE - 1U)
+
+#if (CONFIG_RETARGET_BUFFER_SIZE & RETARGET_BUFFER_MASK) != 0
+#error "CONFIG_RETARGET_BUFFER_SIZE must be a power of two"
+#endif
+
+#define RETARGET_STDOUT         1
+#define RETARGET_STDERR         2
+
+static uint8_t retarget_buffer[CONFIG_RETARGET_BUFFER_SIZE];
+static volatile uint32_t retarget_head = 0;
+static volatile uint32_t retarget_tail = 0;
+static volatile uint32_t retarget_inflight = 0;
+static volatile uint32_t retarget_busy = 0;
+static volatile uint32_t retarget_lost = 0;
+static retarget_write_t retarget_output = NULL;
+static bool retarget_async = false;
+
+static int retarget_open(retarget_write_t write, bool async);
+static void retarget_close(void);
+static void retarget_flush(bool wait);
+static void retarget_tx_complete(void);
+static uint32_t retarget_get_lost(void);
+
+const struct retarget_api retarget = {
+    .open = retarget_open,
+    .close = retarget_close,
+    .flush = retarget_flush,
+    .tx_complete = retarget_tx_complete,
+    .get_lost = retarget_get_lost,
+};
+
+static uint32_t retarget_put(const uint8_t *data, uint32_t len);
+static void retarget_kick(void);
+static bool retarget_can_wait(void);
+
+/**
+ * @brief Open retarget
+ *
+ * @param write Write function used to drain the buffer
+ * @param async True if write only starts a transfer and completion is
+ *              reported by retarget.tx_complete()
+ * @return Operation status
+ */
+static int retarget_open(retarget_write_t write, bool async) {
+    omni_assert_not_null(write);
+
+    if (write == NULL) {
+        return OMNI_FAIL;
+    }
+
+    retarget_output = NULL;
+    retarget_head = 0;
+    retarget_tail = 0;
+    retarget_inflight = 0;
+    retarget_busy = 0;
+    retarget_lost = 0;
+    retarget_async = async;
+    retarget_output = write;
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Close retarget
+ *
+ * @note Buffered output is written out first.
+ */
+static void retarget_close(void) {
+    retarget_flush(true);
+    retarget_output = NULL;
+}
+
+/**
+ * @brief Flush buffered output
+ *
+ * @param wait Wait until the buffer is empty, ignored in interrupts
+ */
+static void retarget_flush(bool wait) {
+    retarget_kick();
+
+    if (!wait || !retarget_can_wait()) {
+        return;
+    }
+
+    while ((retarget_output != NULL) && (retarget_tail != retarget_head)) {
+        retarget_kick();
+    }
+}
+
+/**
+ * @brief Notify completion of an asynchronous write
+ *
+ * @note Call from the completion callback of the backend.
+ */
+static void retarget_tx_complete(void) {
+    uint32_t primask;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    retarget_tail = retarget_tail + retarget_inflight;
+    retarget_inflight = 0;
+    retarget_busy = 0;
+    __set_PRIMASK(primask);
+
+    retarget_kick();
+}
+
+/**
+ * @brief Get number of lost bytes
+ *
+ * @return Number of bytes dropped or overwritten because the buffer was full
+ */
+static uint32_t retarget_get_lost(void) {
+    return retarget_lost;
+}
+
+#if defined(CONFIG_RETARGET_USART)
+/**
+ * @brief Write function for USART send, asynchronous
+ *
+ * @param data Pointer to data
+ * @param len Length of data
+ * @return Number of bytes accepted
+ */
+uint32_t retarget_usart_write(const void *data, uint32_t len) {
+    if (usart_driver.send(CONFIG_RETARGET_USART_NUM, (const uint8_t *)data, len) != OMNI_OK) {
+        return 0;
+    }
+
+    return len;
+}
+#endif /* CONFIG_RETARGET_USART */
+
+#if defined(CONFIG_RETARGET_RTT)
+/**
+ * @brief Write function for Segger RTT, synchronous
+ *
+ * @param data Pointer to data
+ * @param len Length of data
+ * @return Number of bytes accepted
+ */
+uint32_t retarget_rtt_write(const void *data, uint32_t len) {
+    return SEGGER_RTT_Write(CONFIG_RETARGET_RTT_CHANNEL, data, len);
+}
+#endif /* CONFIG_RETARGET_RTT */
+
+/********************* Syscalls **********************/
+
+/**
+ * @brief Write to a file, overrides the weak newlib syscall
+ *
+ * @param file File descriptor
+ * @param ptr Pointer to data
+ * @param len Length of data
+ * @return Number of bytes written
+ */
+int _write(int file, char *ptr, int len) {
+    uint32_t count;
+    bool kick = true;
+
+    if (((file != RETARGET_STDOUT) && (file != RETARGET_STDERR)) || (len <= 0)) {
+        return len;
+    }
+
+    if (retarget_output == NULL) {
+        return len;
+    }
+
+    count = retarget_put((const uint8_t *)ptr, (uint32_t)len);
+    if (count < (uint32_t)len) {
+        retarget_lost = retarget_lost + ((uint32_t)len - count);
+    }
+
+#if defined(CONFIG_RETARGET_FLUSH_ON_NEWLINE)
+    // Line buffered, stderr and a half full buffer are written out at once
+    if (file == RETARGET_STDOUT) {
+        kick = (ptr[len - 1] == '\n') || \
+            ((retarget_head - retarget_tail) >= (CONFIG_RETARGET_BUFFER_SIZE / 2U));
+    }
+#endif /* CONFIG_RETARGET_FLUSH_ON_NEWLINE */
+
+    if (kick) {
+        retarget_kick();
+    }
+
+    return len;
+}
+
+/********************* Private functions **********************/
+
+/**
+ * @brief Copy data into the buffer, applying the overflow policy
+ *
+ * @param data Pointer to data
+ * @param len Length of data
+ * @return Number of bytes buffered
+ */
+static uint32_t retarget_put(const uint8_t *data, uint32_t len) {
+    uint32_t primask;
+    uint32_t space;
+    uint32_t num;
+    uint32_t count = 0;
+#if defined(CONFIG_RETARGET_OVERFLOW_OVERWRITE)
+    uint32_t queued;
+    uint32_t index;
+#endif /* CONFIG_RETARGET_OVERFLOW_OVERWRITE */
+
+    while (count < len) {
+        primask = __get_PRIMASK();
+        __disable_irq();
+
+        space = CONFIG_RETARGET_BUFFER_SIZE - (retarget_head - retarget_tail);
+#if defined(CONFIG_RETARGET_OVERFLOW_OVERWRITE)
+        if (space < (len - count)) {
+            // The block being written stays, the oldest bytes queued after it go
+            queued = (retarget_head - retarget_tail) - retarget_inflight;
+            num = (len - count) - space;
+            if (num > queued) {
+                // Only the end of the new data fits, the rest counts as lost
+                data += num - queued;
+                len -= num - queued;
+                num = queued;
+            }
+
+            // Move the remaining queued bytes down over the discarded ones
+            for (index = retarget_tail + retarget_inflight; index != (retarget_head - num); index++) {
+                retarget_buffer[index & RETARGET_BUFFER_MASK] = retarget_buffer[(index + num) & RETARGET_BUFFER_MASK];
+            }
+            retarget_head = retarget_head - num;
+            retarget_lost = retarget_lost + num;
+            space += num;
+        }
+#endif /* CONFIG_RETARGET_OVERFLOW_OVERWRITE */
+
+        num = len - count;
+        if (num > space) {
+            num = space;
+        }
+        for (uint32_t i = 0; i < num; i++) {
+            retarget_buffer[(retarget_head + i) & RETARGET_BUFFER_MASK] = data[count + i];
+        }
+        retarget_head = retarget_head + num;
+        count += num;
+
+        __set_PRIMASK(primask);
+
+#if defined(CONFIG_RETARGET_OVERFLOW_BLOCK)
+        if ((count < len) && retarget_can_wait()) {
+            // Wait for the backend to make room
+            retarget_kick();
+            continue;
+        }
+#endif /* CONFIG_RETARGET_OVERFLOW_BLOCK */
+
+        break;
+    }
+
+    return count;
+}
+
+/**
+ * @brief Hand the next contiguous block to the write function
+ */
+static void retarget_kick(void) {
+    uint32_t primask;
+    uint32_t offset;
+    uint32_t len;
+    uint32_t written;
+
+    while (retarget_output != NULL) {
+        primask = __get_PRIMASK();
+        __disable_irq();
+        if (retarget_busy || (retarget_tail == retarget_head)) {
+            __set_PRIMASK(primask);
+            return;
+        }
+
+        offset = retarget_tail & RETARGET_BUFFER_MASK;
+        len = retarget_head - retarget_tail;
+        if (len > (CONFIG_RETARGET_BUFFER_SIZE - offset)) {
+            len = CONFIG_RETARGET_BUFFER_SIZE - offset;
+        }
+        retarget_busy = 1;
+        retarget_inflight = len;
+        __set_PRIMASK(primask);
+
+        written = retarget_output(&retarget_buffer[offset], len);
+
+        if (retarget_async) {
+            if (written == 0) {
+                // Backend busy, try again on the next write or flush
+                retarget_inflight = 0;
+                retarget_busy = 0;
+            }
+            return;
+        }
+
+        primask = __get_PRIMASK();
+        __disable_irq();
+        retarget_tail = retarget_tail + written;
+        retarget_inflight = 0;
+        retarget_busy = 0;
+        __set_PRIMASK(primask);
+
+        if (written < len) {
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Check if the caller may busy wait for the backend
+ *
+ * @return True in thread mode with interrupts enabled
+ */
+static bool retarget_can_wait(void) {
+    return (__get_IPSR() == 0) && (__get_PRIMASK() == 0);
+}
@@ -0,0 +1,112 @@
+/**
+  * @file    retarget.h
+  * @author  LuckkMaker
+  * @brief   Buffered stdio retarget component for omni
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef COMPONENT_RETARGET_H
+#define COMPONENT_RETARGET_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "include/device.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * The component replaces the weak _write of the newlib syscalls. Output to
+ * stdout and stderr is copied into a ring buffer and drained in the
+ * background by a write function:
+ *
+ * - Synchronous backends such as Segger RTT copy the data and return.
+ * - Asynchronous backends such as USART TX DMA or a USB CDC IN endpoint
+ *   start a transfer and call retarget.tx_complete() from their completion
+ *   callback, for USART from the USART_EVENT_SEND_COMPLETE event.
+ *
+ * @code
+ * static void usart1_event(uint32_t event) {
+ *     if (event & USART_EVENT_SEND_COMPLETE) {
+ *         retarget.tx_complete();
+ *     }
+ * }
+ *
+ * retarget.open(retarget_usart_write, true);
+ * @endcode
+ */
+
+/**
+ * @brief Write function, returns number of bytes accepted
+ *
+ * @note An asynchronous write must accept all bytes or none.
+ */
+typedef uint32_t (*retarget_write_t)(const void *data, uint32_t len);
+
+/**
+ * @brief Open retarget
+ */
+typedef int (*retarget_open_t)(retarget_write_t write, bool async);
+
+/**
+ * @brief Close retarget
+ */
+typedef void (*retarget_close_t)(void);
+
+/**
+ * @brief Flush buffered output
+ */
+typedef void (*retarget_flush_t)(bool wait);
+
+/**
+ * @brief Notify completion of an asynchronous write
+ */
+typedef void (*retarget_tx_complete_t)(void);
+
+/**
+ * @brief Get number of lost bytes
+ */
+typedef uint32_t (*retarget_get_lost_t)(void);
+
+/**
+ * @brief Retarget API
+ */
+struct retarget_api {
+    retarget_open_t open;
+    retarget_close_t close;
+    retarget_flush_t flush;
+    retarget_tx_complete_t tx_complete;
+    retarget_get_lost_t get_lost;
+};
+
+extern const struct retarget_api retarget;
+
+#if defined(CONFIG_RETARGET_USART)
+uint32_t retarget_usart_write(const void *data, uint32_t len);
+#endif /* CONFIG_RETARGET_USART */
+
+#if defined(CONFIG_RETARGET_RTT)
+uint32_t retarget_rtt_write(const void *data, uint32_t len);
+#endif /* CONFIG_RETARGET_RTT */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* COMPONENT_RETARGET_H */
@@ -0,0 +1,297 @@
+/**
+  * @file    trace.c
+  * @author  LuckkMaker
+  * @brief   Event trace component for omni
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "trace/trace.h"
+#if defined(CONFIG_SOC_FAMILY_HOST)
+#include "hal/clock_hal.h"
+#endif /* CONFIG_SOC_FAMILY_HOST */
+#if defined(CONFIG_TRACE_RTT)
+#include "SEGGER_RTT.h"
+#endif /* CONFIG_TRACE_RTT */
+
+#define TRACE_EVENT_MASK        (CONFIG_TRACE_EVENT_NUM - 1U)
+#define TRACE_FLUSH_CHUNK       16U
+#define TRACE_TIME_PERIOD       0x40000000U
+
+// Timestamp source, the posix host counts nanoseconds at SystemCoreClock 1 GHz
+#if defined(CONFIG_SOC_FAMILY_HOST)
+#define TRACE_CYCLES()          clock_hal_get_cycles()
+#else
+#define TRACE_CYCLES()          (DWT->CYCCNT)
+#endif /* CONFIG_SOC_FAMILY_HOST */
+
+#if (CONFIG_TRACE_EVENT_NUM & TRACE_EVENT_MASK) != 0
+#error "CONFIG_TRACE_EVENT_NUM must be a power of two"
+#endif
+
+/**
+ * @brief Trace record, the info word is written last and marks the slot valid
+ */
+typedef struct {
+    volatile uint32_t word0;
+    volatile uint32_t info;
+} trace_record_t;
+
+static trace_record_t trace_ring[CONFIG_TRACE_EVENT_NUM];
+static volatile uint32_t trace_head = 0;
+static volatile uint32_t trace_tail = 0;
+static volatile uint32_t trace_lost = 0;
+static uint32_t trace_lost_reported = 0;
+static uint32_t trace_last_stamp = 0;
+static volatile uint32_t trace_enabled = 0;
+static trace_write_t trace_output = NULL;
+
+#if defined(CONFIG_TRACE_RTT)
+static uint8_t trace_rtt_buffer[CONFIG_TRACE_RTT_BUFFER_SIZE];
+#endif /* CONFIG_TRACE_RTT */
+
+static int trace_start(trace_write_t write);
+static void trace_stop(void);
+static uint32_t trace_flush(void);
+static uint32_t trace_get_lost(void);
+
+const struct trace_api trace = {
+    .start = trace_start,
+    .stop = trace_stop,
+    .flush = trace_flush,
+    .get_lost = trace_get_lost,
+};
+
+static void trace_push(uint32_t info, const uint32_t *word0);
+#if defined(CONFIG_TRACE_RTT)
+static uint32_t trace_rtt_write(const void *data, uint32_t len);
+#endif /* CONFIG_TRACE_RTT */
+
+/**
+ * @brief Record an event
+ *
+ * @note Safe to call from threads and interrupts of any priority.
+ * @param event Trace event
+ * @param context Event context, 8 bits
+ * @param arg Event argument, 16 bits
+ */
+void trace_record(trace_event_t event, uint32_t context, uint32_t arg) {
+    if (!trace_enabled) {
+        return;
+    }
+
+    trace_push((uint32_t)event | ((context & 0xFFU) << 8U) | ((arg & 0xFFFFU) << 16U), NULL);
+}
+
+/**
+ * @brief Start tracing
+ *
+ * @param write Output function, NULL to use the Segger RTT up channel
+ * @return Operation status
+ */
+static int trace_start(trace_write_t write) {
+    uint32_t word0;
+
+#if defined(CONFIG_TRACE_RTT)
+    if (write == NULL) {
+        SEGGER_RTT_ConfigUpBuffer(CONFIG_TRACE_RTT_CHANNEL, "omni-trace", trace_rtt_buffer, \
+            sizeof(trace_rtt_buffer), SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+        write = trace_rtt_write;
+    }
+#endif /* CONFIG_TRACE_RTT */
+
+    if (write == NULL) {
+        return OMNI_FAIL;
+    }
+
+#if !defined(CONFIG_SOC_FAMILY_HOST)
+    // Make sure the cycle counter runs for timestamps
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif /* CONFIG_SOC_FAMILY_HOST */
+
+    trace_enabled = 0;
+    for (uint32_t i = 0; i < CONFIG_TRACE_EVENT_NUM; i++) {
+        trace_ring[i].info = TRACE_EVENT_NONE;
+    }
+    trace_head = 0;
+    trace_tail = 0;
+    trace_lost = 0;
+    trace_lost_reported = 0;
+    trace_last_stamp = TRACE_CYCLES();
+    trace_output = write;
+
+    // Stream header for the decoder
+    word0 = TRACE_SYNC_MAGIC;
+    trace_push(TRACE_EVENT_SYNC | (TRACE_VERSION << 16U), &word0);
+    word0 = SystemCoreClock;
+    trace_push(TRACE_EVENT_CLOCK, &word0);
+
+    trace_enabled = 1;
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Stop tracing
+ *
+ * @note Events already recorded can still be drained with trace.flush().
+ */
+static void trace_stop(void) {
+    trace_enabled = 0;
+}
+
+/**
+ * @brief Drain recorded events to the output
+ *
+ * @note Call from a single low priority context, for example the idle
+ *       thread. Events the output does not accept are counted as lost.
+ *       A TRACE_EVENT_TIME is recorded when no event was drained for
+ *       TRACE_TIME_PERIOD cycles, so the decoder can unwrap the counter
+ *       across idle time.
+ * @return Number of events written to the output
+ */
+static uint32_t trace_flush(void) {
+    trace_record_t chunk[TRACE_FLUSH_CHUNK];
+    trace_record_t *slot;
+    uint32_t info;
+    uint32_t num;
+    uint32_t count = 0;
+
+    if (trace_output == NULL) {
+        return 0;
+    }
+
+    if (trace_lost != trace_lost_reported) {
+        trace_lost_reported = trace_lost;
+        trace_push(TRACE_EVENT_LOST | ((trace_lost_reported & 0xFFFFU) << 16U), NULL);
+    }
+
+    if (trace_enabled && ((TRACE_CYCLES() - trace_last_stamp) >= TRACE_TIME_PERIOD)) {
+        trace_last_stamp = TRACE_CYCLES();
+        trace_push(TRACE_EVENT_TIME, NULL);
+    }
+
+    while (trace_tail != trace_head) {
+        num = 0;
+        while ((num < TRACE_FLUSH_CHUNK) && (trace_tail != trace_head)) {
+            slot = &trace_ring[trace_tail & TRACE_EVENT_MASK];
+            info = slot->info;
+            // Reserved by a writer that has not finished yet
+            if (info == TRACE_EVENT_NONE) {
+                break;
+            }
+            __DMB();
+            chunk[num].word0 = slot->word0;
+            chunk[num].info = info;
+            // Sync and clock records carry no timestamp
+            if ((info & 0xFFU) > TRACE_EVENT_CLOCK) {
+                trace_last_stamp = chunk[num].word0;
+            }
+            slot->info = TRACE_EVENT_NONE;
+            __DMB();
+            trace_tail = trace_tail + 1U;
+            num++;
+        }
+
+        if (num == 0) {
+            break;
+        }
+
+        if (trace_output((const void *)chunk, num * sizeof(trace_record_t)) < (num * sizeof(trace_record_t))) {
+            trace_lost = trace_lost + num;
+            break;
+        }
+        count += num;
+    }
+
+    return count;
+}
+
+/**
+ * @brief Get number of lost events
+ *
+ * @return Number of lost events since start
+ */
+static uint32_t trace_get_lost(void) {
+    return trace_lost;
+}
+
+/********************* Private functions **********************/
+
+/**
+ * @brief Reserve a slot and write a record
+ *
+ * @note The slot is reserved with an exclusive access loop, so writers in
+ *       interrupts never block each other.
+ * @param info Record info word
+ * @param word0 Pointer to first word, NULL to use the cycle counter
+ */
+static void trace_push(uint32_t info, const uint32_t *word0) {
+    trace_record_t *slot;
+    uint32_t primask;
+    uint32_t index;
+    uint32_t value;
+
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || defined(__ARM_ARCH_8M_MAIN__)
+    do {
+        index = __LDREXW((volatile uint32_t *)&trace_head);
+        if ((index - trace_tail) >= CONFIG_TRACE_EVENT_NUM) {
+            __CLREX();
+            // Callers may already be in a critical section, keep their mask
+            primask = __get_PRIMASK();
+            __disable_irq();
+            trace_lost = trace_lost + 1U;
+            __set_PRIMASK(primask);
+            return;
+        }
+        value = (word0 != NULL) ? *word0 : TRACE_CYCLES();
+    } while (__STREXW(index + 1U, (volatile uint32_t *)&trace_head) != 0);
+#else
+    primask = __get_PRIMASK();
+    __disable_irq();
+    index = trace_head;
+    if ((index - trace_tail) >= CONFIG_TRACE_EVENT_NUM) {
+        trace_lost = trace_lost + 1U;
+        __set_PRIMASK(primask);
+        return;
+    }
+    value = (word0 != NULL) ? *word0 : TRACE_CYCLES();
+    trace_head = index + 1U;
+    __set_PRIMASK(primask);
+#endif
+
+    slot = &trace_ring[index & TRACE_EVENT_MASK];
+    slot->word0 = value;
+    // Publish the record after the first word is visible
+    __DMB();
+    slot->info = info;
+}
+
+#if defined(CONFIG_TRACE_RTT)
+/**
+ * @brief Write trace records to the RTT up channel
+ *
+ * @param data Pointer to data
+ * @param len Length of data
+ * @return Number of bytes written
+ */
+static uint32_t trace_rtt_write(const void *data, uint32_t len) {
+    return SEGGER_RTT_Write(CONFIG_TRACE_RTT_CHANNEL, data, len);
+}
+#endif /* CONFIG_TRACE_RTT */
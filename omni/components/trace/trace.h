@@ -0,0 +1,143 @@
+/**
+  * @file    trace.h
+  * @author  LuckkMaker
+  * @brief   Event trace component for omni
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef COMPONENT_TRACE_H
+#define COMPONENT_TRACE_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "include/device.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Events are 8 byte records written into a RAM ring from any context and
+ * drained by trace.flush() to Segger RTT or a user write function such as
+ * a USB CDC endpoint. tools/python/trace_decoder.py converts the stream to
+ * Chrome trace JSON, which can be opened in Perfetto or chrome://tracing.
+ *
+ * Record layout, little endian:
+ *   word 0: DWT cycle counter, nanoseconds on the posix host
+ *   word 1: event (bits 0-7), context (bits 8-15), argument (bits 16-31)
+ *
+ * The decoder unwraps the 32-bit counter, so two records must be less than
+ * 2^32 cycles apart. trace.flush() records a TRACE_EVENT_TIME when no event
+ * was drained for 2^30 cycles, call it at least every 3 * 2^30 cycles (6.7 s
+ * at 480 MHz, 19 s at 168 MHz).
+ *
+ * RTOS thread switches are recorded by calling TRACE_THREAD_SWITCH() from
+ * the kernel hook, for FreeRTOS in FreeRTOSConfig.h:
+ *   #define traceTASK_SWITCHED_IN() TRACE_THREAD_SWITCH(uxTaskGetTaskNumber(pxCurrentTCB))
+ */
+
+/**
+ * @brief Trace event
+ */
+typedef enum {
+    TRACE_EVENT_NONE = 0x00,            /**< Empty slot, never recorded */
+    TRACE_EVENT_SYNC = 0x01,            /**< Stream start, word 0 holds TRACE_SYNC_MAGIC */
+    TRACE_EVENT_CLOCK = 0x02,           /**< Word 0 holds the cycle counter frequency */
+    TRACE_EVENT_LOST = 0x03,            /**< Argument holds number of lost events */
+    TRACE_EVENT_TIME = 0x04,            /**< Timestamp only, recorded by trace.flush() while idle */
+    TRACE_EVENT_IRQ_ENTER = 0x10,       /**< Context holds exception number */
+    TRACE_EVENT_IRQ_EXIT = 0x11,        /**< Context holds exception number */
+    TRACE_EVENT_THREAD_SWITCH = 0x20,   /**< Argument holds thread ID */
+    TRACE_EVENT_DRV_START = 0x30,       /**< Driver transfer start, argument holds length */
+    TRACE_EVENT_DRV_COMPLETE = 0x31,    /**< Driver transfer complete */
+    TRACE_EVENT_DRV_ERROR = 0x32,       /**< Driver transfer error */
+    TRACE_EVENT_USER_BEGIN = 0x40,      /**< User span begin, context holds span ID */
+    TRACE_EVENT_USER_END = 0x41,        /**< User span end, context holds span ID */
+    TRACE_EVENT_USER_MARK = 0x42,       /**< User instant, context holds mark ID */
+} trace_event_t;
+
+/**
+ * @brief Driver identifiers, upper nibble of the driver event context
+ */
+#define TRACE_DRV_USART             0x10U   /**< USART transmit */
+#define TRACE_DRV_SPI               0x20U
+#define TRACE_DRV_I2C               0x30U
+#define TRACE_DRV_USART_RX          0x40U   /**< USART receive */
+
+#define TRACE_SYNC_MAGIC            0x4352544FU     /**< "OTRC" */
+#define TRACE_VERSION               0x0001U
+
+#if defined(CONFIG_COMPONENT_TRACE)
+
+/**
+ * @brief Trace write function, returns number of bytes accepted
+ */
+typedef uint32_t (*trace_write_t)(const void *data, uint32_t len);
+
+/**
+ * @brief Start tracing
+ */
+typedef int (*trace_start_t)(trace_write_t write);
+
+/**
+ * @brief Stop tracing
+ */
+typedef void (*trace_stop_t)(void);
+
+/**
+ * @brief Drain recorded events to the output
+ */
+typedef uint32_t (*trace_flush_t)(void);
+
+/**
+ * @brief Get number of lost events
+ */
+typedef uint32_t (*trace_get_lost_t)(void);
+
+/**
+ * @brief Trace API
+ */
+struct trace_api {
+    trace_start_t start;
+    trace_stop_t stop;
+    trace_flush_t flush;
+    trace_get_lost_t get_lost;
+};
+
+extern const struct trace_api trace;
+
+void trace_record(trace_event_t event, uint32_t context, uint32_t arg);
+
+#define TRACE_RECORD(event, context, arg)   trace_record((event), (uint32_t)(context), (uint32_t)(arg))
+
+#else
+
+#define TRACE_RECORD(event, context, arg)   do {} while (0)
+
+#endif /* CONFIG_COMPONENT_TRACE */
+
+#define TRACE_THREAD_SWITCH(id)     TRACE_RECORD(TRACE_EVENT_THREAD_SWITCH, 0, (id))
+#define TRACE_BEGIN(id)             TRACE_RECORD(TRACE_EVENT_USER_BEGIN, (id), 0)
+#define TRACE_END(id)               TRACE_RECORD(TRACE_EVENT_USER_END, (id), 0)
+#define TRACE_MARK(id, arg)         TRACE_RECORD(TRACE_EVENT_USER_MARK, (id), (arg))
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* COMPONENT_TRACE_H */
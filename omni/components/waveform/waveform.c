@@ -0,0 +1,323 @@
+/**
+  * @file    waveform.c
+  * @author  LuckkMaker
+  * @brief   GPIO waveform component for omni
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "waveform/waveform.h"
+
+#if (CONFIG_TIMER_UP_DMA != 1)
+#error "Waveform component requires a timer with update DMA in omni_device_cfg.h"
+#endif /* (CONFIG_TIMER_UP_DMA != 1) */
+
+#define WAVEFORM_PORT_PINS      16U
+
+// Timer events carry no context, only one waveform is active at a time
+static waveform_obj_t *waveform_active = NULL;
+
+static int waveform_open(waveform_obj_t *obj);
+static int waveform_close(waveform_obj_t *obj);
+static int waveform_write(waveform_obj_t *obj, const uint32_t *samples, uint32_t len);
+static uint32_t waveform_encode(const waveform_encoding_t *encoding, const uint16_t *pins, const uint8_t *const *lanes, \
+    uint32_t lane_num, uint32_t byte_num, uint32_t *samples, uint32_t len);
+static waveform_status_t waveform_get_status(waveform_obj_t *obj);
+static waveform_error_t waveform_get_error(waveform_obj_t *obj);
+
+const struct waveform_api waveform = {
+    .open = waveform_open,
+    .close = waveform_close,
+    .write = waveform_write,
+    .encode = waveform_encode,
+    .get_status = waveform_get_status,
+    .get_error = waveform_get_error,
+};
+
+static void waveform_timer_event(uint32_t event);
+static void waveform_reset_pins(waveform_config_t *config, uint16_t pin_mask);
+
+/**
+ * @brief Open waveform
+ *
+ * @param obj Pointer to waveform object structure
+ * @return Operation status
+ */
+static int waveform_open(waveform_obj_t *obj) {
+    gpio_driver_config_t gpio_config = {0};
+    timer_driver_config_t timer_config = {0};
+    omni_assert_not_null(obj);
+
+    waveform_config_t *config = &obj->config;
+    omni_assert_non_zero(config->pin_mask);
+
+    if ((waveform_active != NULL) && (waveform_active != obj)) {
+        return OMNI_BUSY;
+    }
+
+    obj->status = (waveform_status_t){0};
+    obj->error = (waveform_error_t){0};
+
+    // Drive all waveform pins low before the first sample
+    gpio_config.mode = GPIO_MODE_PP_OUTPUT;
+    gpio_config.pull = GPIO_PULL_NONE;
+    gpio_config.speed = GPIO_SPEED_LEVEL_VERYHIGH;
+    gpio_config.level = GPIO_LEVEL_LOW;
+
+    for (uint32_t pin = 0; pin < WAVEFORM_PORT_PINS; pin++) {
+        if (config->pin_mask & (1U << pin)) {
+            if (gpio_driver.init((config->gpio_num & ~0xFU) + pin, &gpio_config) != OMNI_OK) {
+                // Release the pins initialized so far
+                waveform_reset_pins(config, config->pin_mask & ((1U << pin) - 1U));
+                return OMNI_FAIL;
+            }
+        }
+    }
+
+    obj->data.bsrr = gpio_hal_get_bsrr(config->gpio_num);
+
+    // Initialize pacing timer
+    timer_config.mode = TIMER_MODE_BASE;
+    timer_config.frequency = config->frequency;
+    timer_config.period = config->period;
+    timer_config.event_cb = waveform_timer_event;
+
+    waveform_active = obj;
+
+    // The timer driver releases its update DMA stream when init fails
+    if (timer_driver.init(config->timer_num, &timer_config) != OMNI_OK) {
+        waveform_active = NULL;
+        obj->data = (waveform_data_t){0};
+        waveform_reset_pins(config, config->pin_mask);
+        return OMNI_FAIL;
+    }
+
+    // Set initialized status
+    obj->status.is_initialized = 1;
+    // Call event callback
+    if (obj->event_cb != NULL) {
+        // Set initialized event
+        obj->event_cb(WAVEFORM_EVENT_INITIALIZED);
+    }
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Close waveform
+ *
+ * @param obj Pointer to waveform object structure
+ * @return Operation status
+ */
+static int waveform_close(waveform_obj_t *obj) {
+    omni_assert_not_null(obj);
+
+    waveform_config_t *config = &obj->config;
+
+    timer_driver.deinit(config->timer_num);
+
+    waveform_reset_pins(config, config->pin_mask);
+
+    if (waveform_active == obj) {
+        waveform_active = NULL;
+    }
+
+    obj->data = (waveform_data_t){0};
+    obj->status = (waveform_status_t){0};
+    obj->error = (waveform_error_t){0};
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Output a waveform buffer
+ *
+ * @note The buffer is read by DMA while the waveform is output and must stay
+ *       valid until the complete event. Samples only touch pins in the pin
+ *       mask if they are built with waveform.encode() or WAVEFORM_SAMPLE().
+ * @param obj Pointer to waveform object structure
+ * @param samples Pointer to BSRR samples
+ * @param len Number of samples
+ * @return Operation status
+ */
+static int waveform_write(waveform_obj_t *obj, const uint32_t *samples, uint32_t len) {
+    omni_assert_not_null(obj);
+    omni_assert_not_null(samples);
+    omni_assert_non_zero(len);
+
+    if (!obj->status.is_initialized) {
+        return OMNI_FAIL;
+    }
+
+    if (obj->status.busy) {
+        return OMNI_BUSY;
+    }
+
+    // Set busy status
+    obj->status.busy = 1;
+
+    if (timer_driver.dma_write(obj->config.timer_num, obj->data.bsrr, samples, len) != OMNI_OK) {
+        obj->status.busy = 0;
+        return OMNI_FAIL;
+    }
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Encode data lanes into a waveform buffer
+ *
+ * @note Lane n is output on the pins in @p pins[n] and all lanes send
+ *       @p byte_num bytes in parallel. The buffer needs
+ *       byte_num * 8 * samples_per_bit + reset_samples words.
+ * @param encoding Pointer to bit encoding
+ * @param pins Pointer to pin mask of each lane
+ * @param lanes Pointer to data of each lane
+ * @param lane_num Number of lanes
+ * @param byte_num Number of bytes per lane
+ * @param samples Pointer to waveform buffer
+ * @param len Size of waveform buffer in words
+ * @return Number of samples written, 0 if the buffer is too small
+ */
+static uint32_t waveform_encode(const waveform_encoding_t *encoding, const uint16_t *pins, const uint8_t *const *lanes, \
+    uint32_t lane_num, uint32_t byte_num, uint32_t *samples, uint32_t len) {
+    uint32_t all_mask = 0;
+    uint32_t one_mask;
+    uint32_t high_mask;
+    uint32_t index = 0;
+    omni_assert_not_null(encoding);
+    omni_assert_not_null(pins);
+    omni_assert_not_null(lanes);
+    omni_assert_not_null(samples);
+    omni_assert_non_zero(encoding->samples_per_bit);
+
+    if (len < (byte_num * 8U * encoding->samples_per_bit + encoding->reset_samples)) {
+        return 0;
+    }
+
+    for (uint32_t lane = 0; lane < lane_num; lane++) {
+        all_mask |= pins[lane];
+    }
+
+    for (uint32_t byte = 0; byte < byte_num; byte++) {
+        for (int32_t bit = 7; bit >= 0; bit--) {
+            // Collect the lanes sending a 1 bit
+            one_mask = 0;
+            for (uint32_t lane = 0; lane < lane_num; lane++) {
+                if ((lanes[lane][byte] >> bit) & 0x01U) {
+                    one_mask |= pins[lane];
+                }
+            }
+
+            for (uint32_t sample = 0; sample < encoding->samples_per_bit; sample++) {
+                high_mask = 0;
+                if (sample < encoding->zero_high) {
+                    high_mask |= all_mask & ~one_mask;
+                }
+                if (sample < encoding->one_high) {
+                    high_mask |= one_mask;
+                }
+                samples[index++] = WAVEFORM_SAMPLE(high_mask, all_mask & ~high_mask);
+            }
+        }
+    }
+
+    for (uint32_t sample = 0; sample < encoding->reset_samples; sample++) {
+        samples[index++] = WAVEFORM_SAMPLE(0, all_mask);
+    }
+
+    return index;
+}
+
+/**
+ * @brief Get waveform status
+ *
+ * @param obj Pointer to waveform object structure
+ * @return Waveform status
+ */
+static waveform_status_t waveform_get_status(waveform_obj_t *obj) {
+    omni_assert_not_null(obj);
+
+    return obj->status;
+}
+
+/**
+ * @brief Get waveform error
+ *
+ * @param obj Pointer to waveform object structure
+ * @return Waveform error
+ */
+static waveform_error_t waveform_get_error(waveform_obj_t *obj) {
+    omni_assert_not_null(obj);
+
+    return obj->error;
+}
+
+/********************* Callback functions **********************/
+
+/**
+ * @brief Pacing timer event callback
+ *
+ * @param event Timer event
+ */
+static void waveform_timer_event(uint32_t event) {
+    waveform_obj_t *obj = waveform_active;
+
+    if (obj == NULL) {
+        return;
+    }
+
+    if (event & TIMER_EVENT_DMA_WRITE_COMPLETE) {
+        // Clear busy status
+        obj->status.busy = 0;
+
+        if (obj->event_cb != NULL) {
+            // Set complete event
+            obj->event_cb(WAVEFORM_EVENT_COMPLETE);
+        }
+    }
+
+    if (event & TIMER_EVENT_DMA_ERROR) {
+        // Clear busy status
+        obj->status.busy = 0;
+
+        // Set DMA error
+        obj->error.dma_error = 1;
+
+        if (obj->event_cb != NULL) {
+            // Set error event
+            obj->event_cb(WAVEFORM_EVENT_ERROR);
+        }
+    }
+}
+
+/********************* Private functions **********************/
+
+/**
+ * @brief Deinitialize waveform pins
+ *
+ * @param config Pointer to waveform configuration
+ * @param pin_mask Pins of the port to deinitialize
+ */
+static void waveform_reset_pins(waveform_config_t *config, uint16_t pin_mask) {
+    for (uint32_t pin = 0; pin < WAVEFORM_PORT_PINS; pin++) {
+        if (pin_mask & (1U << pin)) {
+            gpio_driver.deinit((config->gpio_num & ~0xFU) + pin);
+        }
+    }
+}
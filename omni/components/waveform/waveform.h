@@ -0,0 +1,177 @@
+/**
+  * @file    waveform.h
+  * @author  LuckkMaker
+  * @brief   GPIO waveform component for omni
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef COMPONENT_WAVEFORM_H
+#define COMPONENT_WAVEFORM_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "drivers/gpio.h"
+#include "drivers/timer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * A waveform is a buffer of BSRR words, one word per sample. The low half
+ * sets pins and the high half resets pins of one GPIO port. The timer update
+ * DMA writes one sample per counter period, so all pins of the port change
+ * on the same bus cycle and the CPU is free while the waveform is output.
+ *
+ * Buffers can be built at runtime with waveform.encode() or offline with
+ * tools/python/waveform_encoder.py, which uses the same bit encoding.
+ */
+
+/**
+ * @brief Build a waveform sample from pins driven high and low
+ */
+#define WAVEFORM_SAMPLE(set_mask, reset_mask) \
+    ((uint32_t)((set_mask) & 0xFFFFU) | ((uint32_t)((reset_mask) & 0xFFFFU) << 16U))
+
+/**
+ * @brief Waveform event
+ */
+#define WAVEFORM_EVENT_INITIALIZED      (1 << 0)    /**< Initialized */
+#define WAVEFORM_EVENT_COMPLETE         (1 << 1)    /**< Waveform output complete */
+#define WAVEFORM_EVENT_ERROR            (1 << 2)    /**< Waveform output error */
+
+/**
+ * @brief Event callback function
+ */
+typedef void (*waveform_event_callback)(uint32_t event);
+
+/**
+ * @brief Waveform configuration
+ */
+typedef struct waveform_config {
+    timer_num_t timer_num;          /**< Timer pacing the samples */
+    uint32_t gpio_num;              /**< Any GPIO number on the output port */
+    uint16_t pin_mask;              /**< Pins of the port driven by the waveform */
+    uint32_t frequency;             /**< Timer counter frequency in Hz */
+    uint32_t period;                /**< Counter ticks per sample */
+} waveform_config_t;
+
+/**
+ * @brief Waveform bit encoding
+ *
+ * @note Each data bit is output as @p samples_per_bit samples. The pin is
+ *       high for the first @p zero_high samples of a 0 bit and the first
+ *       @p one_high samples of a 1 bit, then low. Bits are sent MSB first.
+ */
+typedef struct waveform_encoding {
+    uint8_t samples_per_bit;        /**< Samples per data bit */
+    uint8_t zero_high;              /**< High samples of a 0 bit */
+    uint8_t one_high;               /**< High samples of a 1 bit */
+    uint16_t reset_samples;         /**< Low samples appended after the data */
+} waveform_encoding_t;
+
+/**
+ * @brief WS2812 encoding at 800 kbit/s with a 2.4 MHz sample rate
+ */
+#define WAVEFORM_ENCODING_WS2812    { .samples_per_bit = 3, .zero_high = 1, .one_high = 2, .reset_samples = 120 }
+
+/**
+ * @brief Waveform status
+ */
+typedef struct waveform_status {
+    uint32_t is_initialized:1;      /**< Initialization status */
+    uint32_t busy:1;                /**< Waveform output busy flag */
+    uint32_t reserved:30;           /**< Reserved */
+} waveform_status_t;
+
+/**
+ * @brief Waveform error
+ */
+typedef struct waveform_error {
+    uint32_t dma_error:1;           /**< DMA error */
+    uint32_t reserved:31;           /**< Reserved */
+} waveform_error_t;
+
+/**
+ * @brief Waveform data
+ */
+typedef struct waveform_data {
+    volatile uint32_t *bsrr;        /**< Pointer to port set/reset register */
+} waveform_data_t;
+
+/**
+ * @brief Waveform object structure
+ */
+typedef struct {
+    waveform_config_t config;
+    waveform_data_t data;
+    volatile waveform_status_t status;
+    volatile waveform_error_t error;
+    waveform_event_callback event_cb;
+} waveform_obj_t;
+
+/**
+ * @brief Open waveform
+ */
+typedef int (*waveform_open_t)(waveform_obj_t *obj);
+
+/**
+ * @brief Close waveform
+ */
+typedef int (*waveform_close_t)(waveform_obj_t *obj);
+
+/**
+ * @brief Output a waveform buffer
+ */
+typedef int (*waveform_write_t)(waveform_obj_t *obj, const uint32_t *samples, uint32_t len);
+
+/**
+ * @brief Encode data lanes into a waveform buffer
+ */
+typedef uint32_t (*waveform_encode_t)(const waveform_encoding_t *encoding, const uint16_t *pins, const uint8_t *const *lanes, \
+    uint32_t lane_num, uint32_t byte_num, uint32_t *samples, uint32_t len);
+
+/**
+ * @brief Waveform get status
+ */
+typedef waveform_status_t (*waveform_get_status_t)(waveform_obj_t *obj);
+
+/**
+ * @brief Waveform get error
+ */
+typedef waveform_error_t (*waveform_get_error_t)(waveform_obj_t *obj);
+
+/**
+ * @brief Waveform API
+ */
+struct waveform_api {
+    waveform_open_t open;
+    waveform_close_t close;
+    waveform_write_t write;
+    waveform_encode_t encode;
+    waveform_get_status_t get_status;
+    waveform_get_error_t get_error;
+};
+
+extern const struct waveform_api waveform;
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* COMPONENT_WAVEFORM_H */
@@ -89,6 +89,37 @@ extern "C" {
 #define SSD1306_SET_COM_PINS_HW_CONFIG_SEQ          0x02    /**< Sequential COM pin configuration */
 #define SSD1306_SET_COM_PINS_HW_CONFIG_ALT          0x12    /**< Alternative COM pin configuration */
 
+/**
+ * @brief SSD1306 timing and driving scheme setting command
+ */
+#define SSD1306_SET_DISPLAY_CLOCK_DIV               0xD5    /**< Set display clock divide ratio and oscillator frequency (double byte command) */
+#define SSD1306_SET_PRECHARGE_PERIOD                0xD9    /**< Set pre-charge period (double byte command) */
+#define SSD1306_SET_VCOMH_DESELECT_LEVEL            0xDB    /**< Set VCOMH deselect level (double byte command) */
+#define SSD1306_NOP                                 0xE3    /**< No operation */
+
+/**
+ * @brief SSD1306 charge pump command
+ */
+#define SSD1306_SET_CHARGE_PUMP                     0x8D    /**< Charge pump setting (double byte command) */
+#define SSD1306_SET_CHARGE_PUMP_ENABLE              0x14    /**< Enable charge pump */
+#define SSD1306_SET_CHARGE_PUMP_DISABLE             0x10    /**< Disable charge pump */
+
+/**
+ * @brief SSD1306 scrolling command
+ */
+#define SSD1306_RIGHT_HORIZ_SCROLL                  0x26    /**< Right horizontal scroll (7 byte command) */
+#define SSD1306_LEFT_HORIZ_SCROLL                   0x27    /**< Left horizontal scroll (7 byte command) */
+#define SSD1306_VERT_RIGHT_HORIZ_SCROLL             0x29    /**< Vertical and right horizontal scroll (6 byte command) */
+#define SSD1306_VERT_LEFT_HORIZ_SCROLL              0x2A    /**< Vertical and left horizontal scroll (6 byte command) */
+#define SSD1306_DEACTIVATE_SCROLL                   0x2E    /**< Deactivate scroll */
+#define SSD1306_ACTIVATE_SCROLL                     0x2F    /**< Activate scroll */
+#define SSD1306_SET_VERT_SCROLL_AREA                0xA3    /**< Set vertical scroll area (triple byte command) */
+
+/**
+ * @brief SSD1306 status byte
+ */
+#define SSD1306_STATUS_DISPLAY_OFF                  0x40    /**< Display is off */
+
 /**
  * @brief SSD1306 controller
  */
@@ -0,0 +1,207 @@
+/**
+  * @file    adc.h
+  * @author  LuckkMaker
+  * @brief   ADC driver for omni
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef OMNI_DRIVER_ADC_H
+#define OMNI_DRIVER_ADC_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "drivers/adc_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Each trigger scans the channel sequence once and a circular DMA writes
+ * the samples into the ring buffer given to start. The ring holds two
+ * blocks, the block callback is called from the DMA interrupt when one is
+ * full while the DMA fills the other, so there is no interrupt per sample.
+ * A block must be consumed before the DMA wraps around to it.
+ *
+ * In dual and triple modes only ADC1 has a DMA. Initialize ADC2 (and ADC3)
+ * first with ADC_TRIGGER_SOFTWARE, then ADC1 with the multi mode and the
+ * trigger, and start and stop ADC1 only. Samples of the ADCs are
+ * interleaved in the ring in conversion order.
+ *
+ * Timer triggers need CONFIG_ADC_TIMER_TRIGGER. On STM32F4 with
+ * CONFIG_TIMER_HARDWARE the timer driver outputs the update event on TRGO,
+ * as in the example below. On STM32F1 and STM32H7 the timer driver has no
+ * hardware timers: configure the timer and its TRGO (master mode update)
+ * with the vendor HAL or registers and start it outside omni.
+ *
+ * @code
+ * // 8 channels, TIM2 TRGO at 100 kHz, 64 scans per block (STM32F4)
+ * static uint16_t ring[2 * 64 * 8];
+ * static const uint8_t channels[8] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+ *
+ * static void block_ready(const uint16_t *block, uint32_t len) {
+ *     filter_push(block, len);
+ * }
+ *
+ * adc_driver_config_t config = {
+ *     .mode = ADC_MODE_INDEPENDENT,
+ *     .resolution = ADC_RESOLUTION_12BIT,
+ *     .trigger = ADC_TRIGGER_TIM2_TRGO,
+ *     .channels = channels,
+ *     .channel_num = 8,
+ *     .sample_cycles = 15,
+ * };
+ *
+ * timer_driver_config_t timer_config = {
+ *     .mode = TIMER_MODE_BASE,
+ *     .frequency = 1000000,
+ *     .period = 10,
+ * };
+ *
+ * timer_driver.init(TIMER_NUM_2, &timer_config);
+ * adc_driver.init(ADC_NUM_1, &config);
+ * adc_driver.start(ADC_NUM_1, ring, ARRAY_SIZE(ring), block_ready);
+ * timer_driver.start(TIMER_NUM_2);
+ * @endcode
+ */
+
+/**
+ * @brief ADC event
+ */
+#define ADC_EVENT_INITIALIZED           (1 << 0)    /**< Initialized */
+#define ADC_EVENT_OVERRUN               (1 << 1)    /**< Conversion lost, sampling stopped */
+#define ADC_EVENT_DMA_ERROR             (1 << 2)    /**< DMA transfer error, sampling stopped */
+
+/**
+ * @brief Event callback function
+ */
+typedef void (*adc_event_callback)(uint32_t event);
+
+/**
+ * @brief Block callback function
+ *
+ * Called from the DMA interrupt with the ring half just filled, len
+ * samples long.
+ */
+typedef void (*adc_block_callback)(const uint16_t *block, uint32_t len);
+
+/**
+ * @brief ADC driver configuration
+ */
+typedef struct adc_driver_config {
+    adc_mode_t mode;                /**< Multi mode, ADC1 only */
+    adc_resolution_t resolution;    /**< Resolution */
+    adc_trigger_t trigger;          /**< Scan trigger */
+    const uint8_t *channels;        /**< Channel numbers of the sequence, in conversion order */
+    uint32_t channel_num;           /**< Number of channels (1..16) */
+    uint32_t sample_cycles;         /**< Sampling time in ADC clock cycles, rounded up */
+    uint32_t oversampling;          /**< Oversampling ratio (1..1024), 0 or 1 to disable, STM32H7 only */
+    uint32_t oversampling_shift;    /**< Right shift of the oversampled sum (0..11), STM32H7 only */
+    adc_event_callback event_cb;    /**< Event callback */
+} adc_driver_config_t;
+
+/**
+ * @brief ADC driver status
+ */
+typedef struct adc_driver_status {
+    uint32_t is_initialized:1;      /**< Initialization status */
+    uint32_t busy:1;                /**< Sampling running */
+    uint32_t reserved:30;           /**< Reserved */
+} adc_driver_status_t;
+
+/**
+ * @brief ADC driver error
+ */
+typedef struct adc_driver_error {
+    uint32_t overrun:1;             /**< Conversion overrun */
+    uint32_t dma_error:1;           /**< DMA error */
+    uint32_t reserved:30;           /**< Reserved */
+} adc_driver_error_t;
+
+/**
+ * @brief ADC driver data
+ */
+typedef struct adc_driver_data {
+    adc_mode_t mode;                /**< Multi mode */
+    uint32_t channels;              /**< Bit mask of the sequence channels */
+    uint32_t scan;                  /**< Samples per scan of all ADCs */
+    uint16_t *buffer;               /**< Pointer to ring buffer */
+    uint32_t len;                   /**< Ring length in samples */
+} adc_driver_data_t;
+
+/**
+ * @brief ADC object
+ */
+typedef struct {
+    adc_dev_t *dev;
+    adc_driver_data_t data;
+    volatile adc_driver_status_t status;
+    volatile adc_driver_error_t error;
+    adc_event_callback event_cb;
+    adc_block_callback block_cb;
+} adc_obj_t;
+
+/**
+ * @brief Initialize ADC
+ */
+typedef int (*adc_init_t)(adc_num_t adc_num, adc_driver_config_t *config);
+
+/**
+ * @brief Deinitialize ADC
+ */
+typedef int (*adc_deinit_t)(adc_num_t adc_num);
+
+/**
+ * @brief Start sampling into a ring buffer
+ */
+typedef int (*adc_start_t)(adc_num_t adc_num, uint16_t *buffer, uint32_t len, adc_block_callback cb);
+
+/**
+ * @brief Stop sampling
+ */
+typedef int (*adc_stop_t)(adc_num_t adc_num);
+
+/**
+ * @brief Get ADC status
+ */
+typedef adc_driver_status_t (*adc_get_status_t)(adc_num_t adc_num);
+
+/**
+ * @brief Get ADC error
+ */
+typedef adc_driver_error_t (*adc_get_error_t)(adc_num_t adc_num);
+
+/**
+ * @brief ADC driver API
+ */
+struct adc_driver_api {
+    adc_init_t init;
+    adc_deinit_t deinit;
+    adc_start_t start;
+    adc_stop_t stop;
+    adc_get_status_t get_status;
+    adc_get_error_t get_error;
+};
+
+extern const struct adc_driver_api adc_driver;
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* OMNI_DRIVER_ADC_H */
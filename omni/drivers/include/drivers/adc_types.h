@@ -0,0 +1,104 @@
+/**
+  * @file    adc_types.h
+  * @author  LuckkMaker
+  * @brief   ADC driver types
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef OMNI_DRIVER_ADC_TYPES_H
+#define OMNI_DRIVER_ADC_TYPES_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "include/device.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief ADC multi mode
+ *
+ * Set on the ADC1 configuration, ADC2 (and ADC3) follow ADC1. Dual modes
+ * use ADC1 and ADC2, triple modes ADC1, ADC2 and ADC3 (STM32F4 only).
+ */
+typedef enum {
+    ADC_MODE_INDEPENDENT = 0x00,    /**< Every ADC converts on its own */
+    ADC_MODE_DUAL_SIMULT = 0x01,    /**< ADC1 and ADC2 convert their sequences at the same time */
+    ADC_MODE_DUAL_INTERL = 0x02,    /**< ADC1 and ADC2 take turns on the same channel */
+    ADC_MODE_TRIPLE_SIMULT = 0x03,  /**< ADC1, ADC2 and ADC3 convert their sequences at the same time */
+    ADC_MODE_TRIPLE_INTERL = 0x04,  /**< ADC1, ADC2 and ADC3 take turns on the same channel */
+} adc_mode_t;
+
+/**
+ * @brief ADC resolution
+ */
+typedef enum {
+    ADC_RESOLUTION_12BIT = 0x00,    /**< All targets */
+    ADC_RESOLUTION_16BIT = 0x01,    /**< STM32H7 */
+    ADC_RESOLUTION_14BIT = 0x02,    /**< STM32H7 */
+    ADC_RESOLUTION_10BIT = 0x03,    /**< STM32F4, STM32H7 */
+    ADC_RESOLUTION_8BIT = 0x04,     /**< STM32F4, STM32H7 */
+    ADC_RESOLUTION_6BIT = 0x05,     /**< STM32F4 */
+} adc_resolution_t;
+
+/**
+ * @brief ADC conversion trigger
+ *
+ * Timer events start one scan of the sequence. Not every event exists on
+ * every family, init fails on an event the family does not have. See the
+ * reference manual for the events of each ADC.
+ */
+typedef enum {
+    ADC_TRIGGER_SOFTWARE = 0x00,    /**< Free running, scans back to back */
+    ADC_TRIGGER_TIM1_CC1,
+    ADC_TRIGGER_TIM1_CC2,
+    ADC_TRIGGER_TIM1_CC3,
+    ADC_TRIGGER_TIM1_TRGO,
+    ADC_TRIGGER_TIM2_CC2,
+    ADC_TRIGGER_TIM2_TRGO,
+    ADC_TRIGGER_TIM3_TRGO,
+    ADC_TRIGGER_TIM4_CC4,
+    ADC_TRIGGER_TIM4_TRGO,
+    ADC_TRIGGER_TIM6_TRGO,
+    ADC_TRIGGER_TIM8_TRGO,
+    ADC_TRIGGER_TIM15_TRGO,
+    ADC_TRIGGER_EXTI11,
+} adc_trigger_t;
+
+/**
+ * @brief ADC number
+ */
+typedef enum {
+#if (CONFIG_ADC_NUM_1 == 1)
+    ADC_NUM_1 = 0x00,
+#endif /* (CONFIG_ADC_NUM_1 == 1) */
+#if (CONFIG_ADC_NUM_2 == 1)
+    ADC_NUM_2,
+#endif /* (CONFIG_ADC_NUM_2 == 1) */
+#if (CONFIG_ADC_NUM_3 == 1)
+    ADC_NUM_3,
+#endif /* (CONFIG_ADC_NUM_3 == 1) */
+    ADC_NUM_MAX,
+} adc_num_t;
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* OMNI_DRIVER_ADC_TYPES_H */
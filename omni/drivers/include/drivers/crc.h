@@ -0,0 +1,136 @@
+/**
+  * @file    crc.h
+  * @author  LuckkMaker
+  * @brief   CRC unit driver for omni
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef OMNI_DRIVER_CRC_H
+#define OMNI_DRIVER_CRC_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "include/device.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * The unit holds the CRC register MSB first, as in the polynomial
+ * division, whatever the bit order of the input. Every update loads the
+ * register from value and stores it back, so the unit is shared between
+ * any number of running CRCs. Final reflection and XOR are left to the
+ * caller, see the CRC component.
+ *
+ * Updates fail with OMNI_BUSY while another update is running, also when
+ * called from an interrupt during an update of the thread, so the caller
+ * can fall back to software. Asynchronous updates of at least
+ * CONFIG_CRC_DMA_THRESHOLD bytes are fed by DMA on STM32H7, all other
+ * updates by the CPU before the call returns.
+ *
+ * @code
+ * // CRC-32/MPEG-2
+ * crc_driver_config_t config = { .width = 32, .poly = 0x04C11DB7, .reflect_in = false };
+ * uint32_t value = 0xFFFFFFFF;
+ *
+ * crc_driver.init();
+ * crc_driver.update(&config, &value, frame, frame_len);
+ * @endcode
+ */
+
+/**
+ * @brief CRC event
+ */
+#define CRC_EVENT_COMPLETE              (1 << 0)    /**< All bytes processed, value is valid */
+#define CRC_EVENT_ERROR                 (1 << 1)    /**< DMA transfer error, value is not valid */
+
+/**
+ * @brief Event callback function, value is the register after the update
+ */
+typedef void (*crc_event_callback)(uint32_t event, uint32_t value, void *arg);
+
+/**
+ * @brief CRC unit configuration
+ */
+typedef struct crc_driver_config {
+    uint32_t width;                 /**< Register width in bits, 8, 16 or 32 */
+    uint32_t poly;                  /**< Polynomial, MSB first without the top bit */
+    bool reflect_in;                /**< Input bytes LSB first */
+} crc_driver_config_t;
+
+/**
+ * @brief CRC driver status
+ */
+typedef struct crc_driver_status {
+    uint32_t is_initialized:1;      /**< Initialization status */
+    uint32_t busy:1;                /**< Update running */
+    uint32_t reserved:30;           /**< Reserved */
+} crc_driver_status_t;
+
+/**
+ * @brief Initialize CRC unit
+ */
+typedef int (*crc_init_t)(void);
+
+/**
+ * @brief Deinitialize CRC unit
+ */
+typedef int (*crc_deinit_t)(void);
+
+/**
+ * @brief Check if the unit computes a configuration
+ */
+typedef bool (*crc_is_supported_t)(const crc_driver_config_t *config);
+
+/**
+ * @brief Update a CRC register with data
+ */
+typedef int (*crc_update_t)(const crc_driver_config_t *config, uint32_t *value, const void *data, uint32_t len);
+
+/**
+ * @brief Update a CRC register with data, completion reported by callback
+ */
+typedef int (*crc_update_async_t)(const crc_driver_config_t *config, uint32_t value, const void *data, uint32_t len,
+                                  crc_event_callback cb, void *arg);
+
+/**
+ * @brief Get CRC unit status
+ */
+typedef crc_driver_status_t (*crc_get_status_t)(void);
+
+/**
+ * @brief CRC driver API
+ */
+struct crc_driver_api {
+    crc_init_t init;
+    crc_deinit_t deinit;
+    crc_is_supported_t is_supported;
+    crc_update_t update;
+    crc_update_async_t update_async;
+    crc_get_status_t get_status;
+};
+
+extern const struct crc_driver_api crc_driver;
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* OMNI_DRIVER_CRC_H */
@@ -0,0 +1,134 @@
+/**
+  * @file    dma.h
+  * @author  LuckkMaker
+  * @brief   DMA driver for omni
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef OMNI_DRIVER_DMA_H
+#define OMNI_DRIVER_DMA_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "include/device.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Memory to memory transfers run on a stream claimed when the transfer
+ * starts and released when it completes, so a stream is only taken away
+ * from the peripherals while a copy is in flight.
+ *
+ * Transfers shorter than CONFIG_DMA_MEMCPY_THRESHOLD, or touching memory
+ * the DMA cannot reach (CCM on STM32F4, DTCM and ITCM on STM32H7), are
+ * done by the CPU and the callback is called before the function returns.
+ * Otherwise the callback is called from the DMA interrupt. Buffers and
+ * scatter-gather lists must stay valid until then.
+ *
+ * @code
+ * static void copy_done(uint32_t event, void *arg) {
+ *     if (event & DMA_EVENT_TRANSFER_COMPLETE) {
+ *         frame_ready = true;
+ *     }
+ * }
+ *
+ * dma_driver.init();
+ * dma_driver.copy(frame_back, frame_front, sizeof(frame_front), copy_done, NULL);
+ * @endcode
+ */
+
+/**
+ * @brief DMA event
+ */
+#define DMA_EVENT_TRANSFER_COMPLETE     (1 << 0)    /**< All bytes transferred */
+#define DMA_EVENT_TRANSFER_ERROR        (1 << 1)    /**< Bus error, the destination is incomplete */
+
+/**
+ * @brief Event callback function
+ */
+typedef void (*dma_event_callback)(uint32_t event, void *arg);
+
+/**
+ * @brief Scatter-gather list entry
+ */
+typedef struct dma_sg_entry {
+    void *dst;                      /**< Destination address */
+    const void *src;                /**< Source address */
+    uint32_t len;                   /**< Length in bytes */
+} dma_sg_entry_t;
+
+/**
+ * @brief DMA driver status
+ */
+typedef struct dma_driver_status {
+    uint32_t is_initialized:1;      /**< Initialization status */
+    uint32_t busy:1;                /**< At least one transfer in flight */
+    uint32_t reserved:30;           /**< Reserved */
+} dma_driver_status_t;
+
+/**
+ * @brief Initialize DMA driver
+ */
+typedef int (*dma_init_t)(void);
+
+/**
+ * @brief Deinitialize DMA driver
+ */
+typedef int (*dma_deinit_t)(void);
+
+/**
+ * @brief Copy memory
+ */
+typedef int (*dma_copy_t)(void *dst, const void *src, uint32_t len, dma_event_callback cb, void *arg);
+
+/**
+ * @brief Fill memory with a byte value
+ */
+typedef int (*dma_fill_t)(void *dst, uint8_t value, uint32_t len, dma_event_callback cb, void *arg);
+
+/**
+ * @brief Copy a scatter-gather list
+ */
+typedef int (*dma_copy_sg_t)(const dma_sg_entry_t *list, uint32_t num, dma_event_callback cb, void *arg);
+
+/**
+ * @brief Get DMA driver status
+ */
+typedef dma_driver_status_t (*dma_get_status_t)(void);
+
+/**
+ * @brief DMA driver API
+ */
+struct dma_driver_api {
+    dma_init_t init;
+    dma_deinit_t deinit;
+    dma_copy_t copy;
+    dma_fill_t fill;
+    dma_copy_sg_t copy_sg;
+    dma_get_status_t get_status;
+};
+
+extern const struct dma_driver_api dma_driver;
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* OMNI_DRIVER_DMA_H */
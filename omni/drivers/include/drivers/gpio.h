@@ -42,6 +42,15 @@ typedef struct gpio_driver_config {
     gpio_level_t level;     /**< GPIO level */
 } gpio_driver_config_t;
 
+/**
+ * @brief GPIO edge event
+ */
+typedef struct gpio_event {
+    uint32_t timestamp;     /**< Cycle counter value at the interrupt */
+    uint8_t gpio_num;       /**< GPIO number */
+    uint8_t level;          /**< Pin level read in the interrupt */
+} gpio_event_t;
+
 /**
  * @brief Initialize GPIO
  */
@@ -67,6 +76,31 @@ typedef uint32_t (*gpio_get_level_t)(uint32_t gpio_num);
  */
 typedef int (*gpio_toggle_t)(uint32_t gpio_num);
 
+/**
+ * @brief Enable edge interrupt on a GPIO
+ */
+typedef int (*gpio_irq_enable_t)(uint32_t gpio_num, gpio_trigger_t trigger, gpio_pull_t pull, uint32_t debounce_us);
+
+/**
+ * @brief Disable edge interrupt on a GPIO
+ */
+typedef int (*gpio_irq_disable_t)(uint32_t gpio_num);
+
+/**
+ * @brief Read the next edge event
+ */
+typedef int (*gpio_read_event_t)(gpio_event_t *event);
+
+/**
+ * @brief Get number of edges seen on a GPIO
+ */
+typedef uint32_t (*gpio_get_count_t)(uint32_t gpio_num);
+
+/**
+ * @brief Get number of edge events lost on a full ring
+ */
+typedef uint32_t (*gpio_get_lost_t)(void);
+
 /**
  * @brief GPIO driver API
  */
@@ -76,9 +110,48 @@ struct gpio_driver_api {
     gpio_set_level_t set_level;
     gpio_get_level_t get_level;
     gpio_toggle_t toggle;
+    gpio_irq_enable_t irq_enable;
+    gpio_irq_disable_t irq_disable;
+    gpio_read_event_t read_event;
+    gpio_get_count_t get_count;
+    gpio_get_lost_t get_lost;
 };
 
+#if defined(CONFIG_OMNI_DRIVER_DIRECT_CALL)
+/**
+ * Direct calls, the table is a constant of every translation unit and
+ * calls through it resolve to the HAL functions at compile time.
+ */
+int gpio_hal_init(uint32_t gpio_num, gpio_driver_config_t *config);
+int gpio_hal_deinit(uint32_t gpio_num);
+int gpio_hal_set_level(uint32_t gpio_num, uint32_t level);
+uint32_t gpio_hal_get_level(uint32_t gpio_num);
+int gpio_hal_toggle(uint32_t gpio_num);
+#if defined(CONFIG_GPIO_IRQ)
+int gpio_hal_irq_enable(uint32_t gpio_num, gpio_trigger_t trigger, gpio_pull_t pull, uint32_t debounce_us);
+int gpio_hal_irq_disable(uint32_t gpio_num);
+int gpio_hal_read_event(gpio_event_t *event);
+uint32_t gpio_hal_get_count(uint32_t gpio_num);
+uint32_t gpio_hal_get_lost(void);
+#endif /* CONFIG_GPIO_IRQ */
+
+static const struct gpio_driver_api gpio_driver = {
+    .init = gpio_hal_init,
+    .deinit = gpio_hal_deinit,
+    .set_level = gpio_hal_set_level,
+    .get_level = gpio_hal_get_level,
+    .toggle = gpio_hal_toggle,
+#if defined(CONFIG_GPIO_IRQ)
+    .irq_enable = gpio_hal_irq_enable,
+    .irq_disable = gpio_hal_irq_disable,
+    .read_event = gpio_hal_read_event,
+    .get_count = gpio_hal_get_count,
+    .get_lost = gpio_hal_get_lost,
+#endif /* CONFIG_GPIO_IRQ */
+};
+#else
 extern const struct gpio_driver_api gpio_driver;
+#endif /* CONFIG_OMNI_DRIVER_DIRECT_CALL */
 
 #ifdef __cplusplus
 }
@@ -67,6 +67,15 @@ typedef enum {
     GPIO_LEVEL_HIGH = 0x01,
 } gpio_level_t;
 
+/**
+ * @brief GPIO interrupt trigger
+ */
+typedef enum {
+    GPIO_TRIGGER_RISING = 0x01,
+    GPIO_TRIGGER_FALLING = 0x02,
+    GPIO_TRIGGER_BOTH = 0x03,
+} gpio_trigger_t;
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -45,6 +45,17 @@ extern "C" {
  */
 typedef void (*spi_event_callback)(uint32_t event);
 
+/**
+ * @brief Stream callback function
+ *
+ * Called from the DMA interrupt each time the stream has finished a buffer
+ * and moved on to the other one. A receive buffer holds len new frames and
+ * must be read before the other buffer is full. A send buffer must be
+ * refilled before the callback returns. buffer is NULL if the stream
+ * stopped on a DMA error.
+ */
+typedef void (*spi_stream_callback)(void *buffer);
+
 /**
  * @brief SPI driver configuration
  */
@@ -57,7 +68,7 @@ typedef struct spi_driver_config {
      * - 1..2: Direction @ref SPI direction
      * - 3: Polarity @ref SPI clock polarity
      * - 4: Phase @ref SPI clock phase
-     * - 5..10: Data size (4..16 bits)
+     * - 5..10: Data size (8 or 16 bits, 4..32 bits on STM32H7)
      * - 11: Bit order @ref SPI bit order
      * - 12..13: Slave select @ref SPI slave select
      * - 14: Control SS @ref SPI control slave select
@@ -107,6 +118,7 @@ typedef struct {
     volatile spi_driver_status_t status;
     volatile spi_driver_error_t error;
     spi_event_callback event_cb;
+    spi_stream_callback stream_cb;
 } spi_obj_t;
 
 /**
@@ -144,6 +156,21 @@ typedef int (*spi_receive_t)(spi_num_t spi_num, void *data, uint32_t len);
  */
 typedef int (*spi_transfer_t)(spi_num_t spi_num, const void *tx_data, void *rx_data, uint32_t len);
 
+/**
+ * @brief Send a continuous stream from two buffers
+ */
+typedef int (*spi_stream_send_t)(spi_num_t spi_num, void *buffer0, void *buffer1, uint32_t len, spi_stream_callback cb);
+
+/**
+ * @brief Receive a continuous stream into two buffers
+ */
+typedef int (*spi_stream_receive_t)(spi_num_t spi_num, void *buffer0, void *buffer1, uint32_t len, spi_stream_callback cb);
+
+/**
+ * @brief Stop the stream
+ */
+typedef void (*spi_stream_stop_t)(spi_num_t spi_num);
+
 /**
  * @brief Get SPI bus status
  */
@@ -165,11 +192,47 @@ struct spi_driver_api {
     spi_send_t send;
     spi_receive_t receive;
     spi_transfer_t transfer;
+    spi_stream_send_t stream_send;
+    spi_stream_receive_t stream_receive;
+    spi_stream_stop_t stream_stop;
     spi_get_status_t get_status;
     spi_get_error_t get_error;
 };
 
+#if defined(CONFIG_OMNI_DRIVER_DIRECT_CALL)
+/**
+ * Direct calls, see gpio.h
+ */
+int spi_hal_init(spi_num_t spi_num, spi_driver_config_t *config);
+int spi_hal_deinit(spi_num_t spi_num);
+void spi_hal_start(spi_num_t spi_num);
+void spi_hal_stop(spi_num_t spi_num);
+int spi_hal_send(spi_num_t spi_num, const void *data, uint32_t len);
+int spi_hal_receive(spi_num_t spi_num, void *data, uint32_t len);
+int spi_hal_transfer(spi_num_t spi_num, const void *tx_data, void *rx_data, uint32_t len);
+int spi_hal_stream_send(spi_num_t spi_num, void *buffer0, void *buffer1, uint32_t len, spi_stream_callback cb);
+int spi_hal_stream_receive(spi_num_t spi_num, void *buffer0, void *buffer1, uint32_t len, spi_stream_callback cb);
+void spi_hal_stream_stop(spi_num_t spi_num);
+spi_driver_status_t spi_hal_get_status(spi_num_t spi_num);
+spi_driver_error_t spi_hal_get_error(spi_num_t spi_num);
+
+static const struct spi_driver_api spi_driver = {
+    .init = spi_hal_init,
+    .deinit = spi_hal_deinit,
+    .start = spi_hal_start,
+    .stop = spi_hal_stop,
+    .send = spi_hal_send,
+    .receive = spi_hal_receive,
+    .transfer = spi_hal_transfer,
+    .stream_send = spi_hal_stream_send,
+    .stream_receive = spi_hal_stream_receive,
+    .stream_stop = spi_hal_stream_stop,
+    .get_status = spi_hal_get_status,
+    .get_error = spi_hal_get_error,
+};
+#else
 extern const struct spi_driver_api spi_driver;
+#endif /* CONFIG_OMNI_DRIVER_DIRECT_CALL */
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,64 @@
+/**
+  * @file    tickless.h
+  * @author  LuckkMaker
+  * @brief   Tickless idle hooks for omni
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef OMNI_DRIVER_TICKLESS_H
+#define OMNI_DRIVER_TICKLESS_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "include/device.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * FreeRTOS: set configUSE_TICKLESS_IDLE to 2 and add to FreeRTOSConfig.h
+ *   #define portSUPPRESS_TICKS_AND_SLEEP(x) tickless_freertos_sleep(x)
+ *
+ * CMSIS-RTX: call tickless_rtx_idle() in the loop of osRtxIdleThread().
+ *
+ * ThreadX: define TX_LOW_POWER and add to tx_user.h
+ *   #define TX_LOW_POWER_TIMER_SETUP(x)       tickless_threadx_setup(x)
+ *   #define TX_LOW_POWER_USER_ENTER           tickless_threadx_enter()
+ *   #define TX_LOW_POWER_USER_TIMER_ADJUST    tickless_threadx_adjust()
+ */
+
+#if defined(CONFIG_RTOS_CMSIS_FREERTOS)
+void tickless_freertos_sleep(uint32_t expected_ticks);
+#endif /* CONFIG_RTOS_CMSIS_FREERTOS */
+
+#if defined(CONFIG_RTOS_CMSIS_RTX)
+void tickless_rtx_idle(void);
+#endif /* CONFIG_RTOS_CMSIS_RTX */
+
+#if defined(CONFIG_RTOS_THREADX)
+void tickless_threadx_setup(uint32_t ticks);
+void tickless_threadx_enter(void);
+uint32_t tickless_threadx_adjust(void);
+#endif /* CONFIG_RTOS_THREADX */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* OMNI_DRIVER_TICKLESS_H */
@@ -31,6 +31,146 @@
 extern "C" {
 #endif
 
+/**
+ * @brief Timer event
+ */
+#define TIMER_EVENT_INITIALIZED         (1 << 0)    /**< Initialized */
+#define TIMER_EVENT_UPDATE              (1 << 1)    /**< Counter update */
+#define TIMER_EVENT_CAPTURE_HALF        (1 << 2)    /**< Capture buffer half full */
+#define TIMER_EVENT_CAPTURE_COMPLETE    (1 << 3)    /**< Capture buffer full */
+#define TIMER_EVENT_BURST_COMPLETE      (1 << 4)    /**< DMA burst complete */
+#define TIMER_EVENT_DMA_ERROR           (1 << 5)    /**< DMA transfer error */
+#define TIMER_EVENT_DMA_WRITE_COMPLETE  (1 << 6)    /**< DMA write stream complete */
+
+/**
+ * @brief Event callback function
+ */
+typedef void (*timer_event_callback)(uint32_t event);
+
+#if defined(CONFIG_TIMER_HARDWARE)
+/**
+ * @brief Timer driver configuration
+ */
+typedef struct timer_driver_config {
+    timer_mode_t mode;              /**< Timer mode */
+    uint32_t frequency;             /**< Counter frequency in Hz */
+    uint32_t period;                /**< Counter period in ticks */
+    timer_event_callback event_cb;  /**< Event callback */
+} timer_driver_config_t;
+
+/**
+ * @brief Timer driver status
+ */
+typedef struct timer_driver_status {
+    uint32_t is_initialized:1;      /**< Initialization status */
+    uint32_t running:1;             /**< Counter running flag */
+    uint32_t capture_busy:1;        /**< Capture busy flag */
+    uint32_t burst_busy:1;          /**< DMA burst busy flag */
+    uint32_t dma_write_busy:1;      /**< DMA write stream busy flag */
+    uint32_t reserved:27;           /**< Reserved */
+} timer_driver_status_t;
+
+/**
+ * @brief Timer driver error
+ */
+typedef struct timer_driver_error {
+    uint32_t dma_error:1;           /**< DMA error */
+    uint32_t reserved:31;           /**< Reserved */
+} timer_driver_error_t;
+
+/**
+ * @brief Timer driver data
+ */
+typedef struct timer_driver_data {
+    timer_mode_t mode;              /**< Timer mode */
+    uint32_t *capture_buffer;       /**< Pointer to capture buffer */
+    uint32_t capture_num;           /**< Number of captures requested */
+    const uint32_t *burst_buffer;   /**< Pointer to burst buffer */
+    uint32_t burst_num;             /**< Number of burst words */
+} timer_driver_data_t;
+
+/**
+ * @brief Timer object
+ */
+typedef struct {
+    timer_dev_t *dev;
+    timer_driver_data_t data;
+    volatile timer_driver_status_t status;
+    volatile timer_driver_error_t error;
+    timer_event_callback event_cb;
+} timer_obj_t;
+
+/**
+ * @brief Initialize timer
+ */
+typedef int (*timer_init_t)(timer_num_t timer_num, timer_driver_config_t *config);
+
+/**
+ * @brief Deinitialize timer
+ */
+typedef int (*timer_deinit_t)(timer_num_t timer_num);
+
+/**
+ * @brief Start timer counter
+ */
+typedef int (*timer_start_t)(timer_num_t timer_num);
+
+/**
+ * @brief Stop timer counter
+ */
+typedef int (*timer_stop_t)(timer_num_t timer_num);
+
+/**
+ * @brief Get timer counter
+ */
+typedef uint32_t (*timer_get_counter_t)(timer_num_t timer_num);
+
+/**
+ * @brief Start PWM output on a channel
+ */
+typedef int (*timer_pwm_start_t)(timer_num_t timer_num, timer_channel_t channel, uint32_t pulse, timer_pwm_polarity_t polarity);
+
+/**
+ * @brief Stop PWM output on a channel
+ */
+typedef int (*timer_pwm_stop_t)(timer_num_t timer_num, timer_channel_t channel);
+
+/**
+ * @brief Set PWM pulse of a channel
+ */
+typedef void (*timer_pwm_set_pulse_t)(timer_num_t timer_num, timer_channel_t channel, uint32_t pulse);
+
+/**
+ * @brief Start input capture into a buffer
+ */
+typedef int (*timer_capture_start_t)(timer_num_t timer_num, timer_channel_t channel, timer_capture_edge_t edge, uint32_t *buffer, uint32_t len);
+
+/**
+ * @brief Stop input capture
+ */
+typedef int (*timer_capture_stop_t)(timer_num_t timer_num, timer_channel_t channel);
+
+/**
+ * @brief Write compare registers with DMA burst on update events
+ */
+typedef int (*timer_burst_write_t)(timer_num_t timer_num, timer_channel_t channel, uint32_t channels, const uint32_t *data, uint32_t len);
+
+/**
+ * @brief Write words to a peripheral register with DMA on update events
+ */
+typedef int (*timer_dma_write_t)(timer_num_t timer_num, volatile uint32_t *reg, const uint32_t *data, uint32_t len);
+
+/**
+ * @brief Get timer status
+ */
+typedef timer_driver_status_t (*timer_get_status_t)(timer_num_t timer_num);
+
+/**
+ * @brief Get timer error
+ */
+typedef timer_driver_error_t (*timer_get_error_t)(timer_num_t timer_num);
+#endif /* CONFIG_TIMER_HARDWARE */
+
 /**
  * @brief Timer delay ms function
  */
@@ -46,13 +186,35 @@ typedef void (*timer_delay_us_t)(uint32_t delay);
  */
 typedef uint32_t (*timer_get_tick_t)(uint32_t frequency);
 
+/**
+ * @brief Timer idle function
+ */
+typedef uint32_t (*timer_idle_t)(uint32_t us);
+
 /**
  * @brief Timer driver API
  */
 struct timer_driver_api {
+#if defined(CONFIG_TIMER_HARDWARE)
+    timer_init_t init;
+    timer_deinit_t deinit;
+    timer_start_t start;
+    timer_stop_t stop;
+    timer_get_counter_t get_counter;
+    timer_pwm_start_t pwm_start;
+    timer_pwm_stop_t pwm_stop;
+    timer_pwm_set_pulse_t pwm_set_pulse;
+    timer_capture_start_t capture_start;
+    timer_capture_stop_t capture_stop;
+    timer_burst_write_t burst_write;
+    timer_dma_write_t dma_write;
+    timer_get_status_t get_status;
+    timer_get_error_t get_error;
+#endif /* CONFIG_TIMER_HARDWARE */
     timer_delay_ms_t delay_ms;
     timer_delay_us_t delay_us;
     timer_get_tick_t get_tick;
+    timer_idle_t idle;
 };
 
 extern const struct timer_driver_api timer_driver;
@@ -39,6 +39,69 @@ typedef enum {
     TIMER_FREQ_1MHZ = 0x01,
 } timer_freq_t;
 
+/**
+ * @brief Timer mode
+ */
+typedef enum {
+    TIMER_MODE_BASE = 0x00,         /**< Time base, update event only */
+    TIMER_MODE_PWM = 0x01,          /**< PWM generation */
+    TIMER_MODE_CAPTURE = 0x02,      /**< Input capture */
+    TIMER_MODE_ENCODER = 0x03,      /**< Quadrature encoder on CH1 and CH2 */
+} timer_mode_t;
+
+/**
+ * @brief Timer channel
+ */
+typedef enum {
+    TIMER_CHANNEL_1 = 0x00,
+    TIMER_CHANNEL_2 = 0x01,
+    TIMER_CHANNEL_3 = 0x02,
+    TIMER_CHANNEL_4 = 0x03,
+    TIMER_CHANNEL_MAX,
+} timer_channel_t;
+
+/**
+ * @brief Timer PWM polarity
+ */
+typedef enum {
+    TIMER_PWM_POLARITY_HIGH = 0x00,
+    TIMER_PWM_POLARITY_LOW = 0x01,
+} timer_pwm_polarity_t;
+
+/**
+ * @brief Timer capture edge
+ */
+typedef enum {
+    TIMER_CAPTURE_EDGE_RISING = 0x00,
+    TIMER_CAPTURE_EDGE_FALLING = 0x01,
+    TIMER_CAPTURE_EDGE_BOTH = 0x02,
+} timer_capture_edge_t;
+
+/**
+ * @brief Timer number
+ */
+typedef enum {
+#if (CONFIG_TIMER_NUM_1 == 1)
+    TIMER_NUM_1 = 0x00,
+#endif /* (CONFIG_TIMER_NUM_1 == 1) */
+#if (CONFIG_TIMER_NUM_2 == 1)
+    TIMER_NUM_2,
+#endif /* (CONFIG_TIMER_NUM_2 == 1) */
+#if (CONFIG_TIMER_NUM_3 == 1)
+    TIMER_NUM_3,
+#endif /* (CONFIG_TIMER_NUM_3 == 1) */
+#if (CONFIG_TIMER_NUM_4 == 1)
+    TIMER_NUM_4,
+#endif /* (CONFIG_TIMER_NUM_4 == 1) */
+#if (CONFIG_TIMER_NUM_5 == 1)
+    TIMER_NUM_5,
+#endif /* (CONFIG_TIMER_NUM_5 == 1) */
+#if (CONFIG_TIMER_NUM_8 == 1)
+    TIMER_NUM_8,
+#endif /* (CONFIG_TIMER_NUM_8 == 1) */
+    TIMER_NUM_MAX,
+} timer_num_t;
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
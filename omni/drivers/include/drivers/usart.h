@@ -50,6 +50,17 @@ extern "C" {
  */
 typedef void (*usart_event_callback)(uint32_t event);
 
+/**
+ * @brief Stream callback function
+ *
+ * Called from the DMA interrupt each time the stream has finished a buffer
+ * and moved on to the other one. A receive buffer holds len new bytes and
+ * must be read before the other buffer is full. A send buffer must be
+ * refilled before the callback returns. buffer is NULL if the stream
+ * stopped on a DMA error.
+ */
+typedef void (*usart_stream_callback)(void *buffer);
+
 /**
  * @brief USART driver configuration
  */
@@ -106,6 +117,8 @@ typedef struct {
     volatile usart_driver_status_t status;
     volatile usart_driver_error_t error;
     usart_event_callback event_cb;
+    usart_stream_callback tx_stream_cb;
+    usart_stream_callback rx_stream_cb;
 } usart_obj_t;
 
 /**
@@ -148,6 +161,21 @@ typedef int (*usar_send_t)(usart_num_t usart_num, const uint8_t *data, uint32_t
  */
 typedef int (*usart_receive_t)(usart_num_t usart_num, void *data, uint32_t len);
 
+/**
+ * @brief Send a continuous stream from two buffers
+ */
+typedef int (*usart_stream_send_t)(usart_num_t usart_num, void *buffer0, void *buffer1, uint32_t len, usart_stream_callback cb);
+
+/**
+ * @brief Receive a continuous stream into two buffers
+ */
+typedef int (*usart_stream_receive_t)(usart_num_t usart_num, void *buffer0, void *buffer1, uint32_t len, usart_stream_callback cb);
+
+/**
+ * @brief Stop the send and receive streams
+ */
+typedef void (*usart_stream_stop_t)(usart_num_t usart_num);
+
 /**
  * @brief Get USART port status
  */
@@ -170,11 +198,49 @@ struct usart_driver_api {
     usart_poll_receive_t poll_receive;
     usar_send_t send;
     usart_receive_t receive;
+    usart_stream_send_t stream_send;
+    usart_stream_receive_t stream_receive;
+    usart_stream_stop_t stream_stop;
     usart_get_status_t get_status;
     usart_get_error_t get_error;
 };
 
+#if defined(CONFIG_OMNI_DRIVER_DIRECT_CALL)
+/**
+ * Direct calls, see gpio.h
+ */
+int usart_hal_init(usart_num_t usart_num, usart_driver_config_t *config);
+int usart_hal_deinit(usart_num_t usart_num);
+void usart_hal_start(usart_num_t usart_num);
+void usart_hal_stop(usart_num_t usart_num);
+int usart_hal_poll_send(usart_num_t usart_num, const uint8_t *data, uint32_t len, uint32_t timeout);
+int usart_hal_poll_receive(usart_num_t usart_num, void *data, uint32_t len, uint32_t timeout);
+int usart_hal_send(usart_num_t usart_num, const uint8_t *data, uint32_t len);
+int usart_hal_receive(usart_num_t usart_num, void *data, uint32_t len);
+int usart_hal_stream_send(usart_num_t usart_num, void *buffer0, void *buffer1, uint32_t len, usart_stream_callback cb);
+int usart_hal_stream_receive(usart_num_t usart_num, void *buffer0, void *buffer1, uint32_t len, usart_stream_callback cb);
+void usart_hal_stream_stop(usart_num_t usart_num);
+usart_driver_status_t usart_hal_get_status(usart_num_t usart_num);
+usart_driver_error_t usart_hal_get_error(usart_num_t usart_num);
+
+static const struct usart_driver_api usart_driver = {
+    .init = usart_hal_init,
+    .deinit = usart_hal_deinit,
+    .start = usart_hal_start,
+    .stop = usart_hal_stop,
+    .poll_send = usart_hal_poll_send,
+    .poll_receive = usart_hal_poll_receive,
+    .send = usart_hal_send,
+    .receive = usart_hal_receive,
+    .stream_send = usart_hal_stream_send,
+    .stream_receive = usart_hal_stream_receive,
+    .stream_stop = usart_hal_stream_stop,
+    .get_status = usart_hal_get_status,
+    .get_error = usart_hal_get_error,
+};
+#else
 extern const struct usart_driver_api usart_driver;
+#endif /* CONFIG_OMNI_DRIVER_DIRECT_CALL */
 
 #ifdef __cplusplus
 }
@@ -32,6 +32,22 @@
 #include "drivers/timer.h"
 #include "ipc/ring_buffer.h"
 
+#if defined(CONFIG_OMNI_DRIVER_ADC)
+#include "drivers/adc.h"
+#endif /* CONFIG_OMNI_DRIVER_ADC */
+
+#if defined(CONFIG_OMNI_DRIVER_CRC)
+#include "drivers/crc.h"
+#endif /* CONFIG_OMNI_DRIVER_CRC */
+
+#if defined(CONFIG_OMNI_DRIVER_DMA)
+#include "drivers/dma.h"
+#endif /* CONFIG_OMNI_DRIVER_DMA */
+
+#if defined(CONFIG_TIMER_TICKLESS_IDLE)
+#include "drivers/tickless.h"
+#endif /* CONFIG_TIMER_TICKLESS_IDLE */
+
 #if defined(CONFIG_OMNI_DRIVER_I2C)
 #include "drivers/i2c.h"
 #endif /* CONFIG_OMNI_DRIVER_I2C */
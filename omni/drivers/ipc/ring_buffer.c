@@ -89,7 +89,7 @@ static int rb_deinit(ring_buffer_t *rb) {
  * @param rb Pointer to the ring buffer
  * @return Data size
  */
-static uint32_t rb_get_data_size(ring_buffer_t *rb) {
+static OMNI_FAST_RING_BUFFER uint32_t rb_get_data_size(ring_buffer_t *rb) {
     omni_assert_not_null(rb);
 
     if (rb->status.is_empty) {
@@ -108,7 +108,7 @@ static uint32_t rb_get_data_size(ring_buffer_t *rb) {
  * @param value Value to enqueue
  * @return Operation status
  */
-static int rb_enqueue(ring_buffer_t *rb, uint8_t value) {
+static OMNI_FAST_RING_BUFFER int rb_enqueue(ring_buffer_t *rb, uint8_t value) {
     omni_assert_not_null(rb);
 
     if (rb_is_full(rb)) {
@@ -129,7 +129,7 @@ static int rb_enqueue(ring_buffer_t *rb, uint8_t value) {
  * @param value Pointer to the value
  * @return Operation status
  */
-static int rb_dequeue(ring_buffer_t *rb, uint8_t *value) {
+static OMNI_FAST_RING_BUFFER int rb_dequeue(ring_buffer_t *rb, uint8_t *value) {
     omni_assert_not_null(rb);
     omni_assert_not_null(value);
 
@@ -0,0 +1,154 @@
+/**
+  * @file    tickless.c
+  * @author  LuckkMaker
+  * @brief   Tickless idle hooks for omni
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "drivers/tickless.h"
+#include "drivers/timer.h"
+
+#if defined(CONFIG_RTOS_CMSIS_FREERTOS)
+#include "FreeRTOS.h"
+#include "task.h"
+#elif defined(CONFIG_RTOS_CMSIS_RTX)
+#include "cmsis_os2.h"
+#elif defined(CONFIG_RTOS_THREADX)
+#include "tx_api.h"
+#endif
+
+#if defined(CONFIG_RTOS_CMSIS_FREERTOS) || defined(CONFIG_RTOS_CMSIS_RTX) || defined(CONFIG_RTOS_THREADX)
+/**
+ * @brief Sleep with the kernel tick suspended
+ *
+ * @note The kernel tick runs on SysTick. The idle backend resumes SysTick
+ *       on its period grid, so the ticks to step the kernel by are the
+ *       period boundaries crossed. They are counted from the phases of
+ *       the tick before and after the sleep, not rounded down from the
+ *       slept time, which would drop the partial tick on every sleep.
+ * @param max_ticks Maximum number of whole ticks to sleep, 0 for no limit
+ * @param us_per_tick Microseconds per tick
+ * @return Number of tick periods that ended during the sleep
+ */
+static uint32_t tickless_sleep(uint32_t max_ticks, uint32_t us_per_tick) {
+    uint32_t cycles_per_us = SystemCoreClock / 1000000U;
+    uint32_t period = SysTick->LOAD + 1U;
+    uint32_t before = period - 1U - SysTick->VAL;
+    uint32_t after;
+    uint32_t us = UINT32_MAX;
+    uint32_t slept_us;
+
+    if ((max_ticks != 0U) && (max_ticks <= (UINT32_MAX / us_per_tick))) {
+        us = max_ticks * us_per_tick;
+    }
+
+    slept_us = timer_driver.idle(us);
+    after = period - 1U - SysTick->VAL;
+
+    // The slept time is rounded down to microseconds, the phases are exact
+    return (uint32_t)(((int64_t)slept_us * cycles_per_us + before - after + period / 2U) / period);
+}
+#endif /* CONFIG_RTOS_CMSIS_FREERTOS || CONFIG_RTOS_CMSIS_RTX || CONFIG_RTOS_THREADX */
+
+#if defined(CONFIG_RTOS_CMSIS_FREERTOS)
+/**
+ * @brief FreeRTOS tickless idle
+ * 
+ * @param expected_ticks Number of ticks until the next task unblocks
+ */
+void tickless_freertos_sleep(uint32_t expected_ticks) {
+    uint32_t us_per_tick = 1000000 / configTICK_RATE_HZ;
+    uint32_t slept_ticks;
+
+    if (expected_ticks < 2U) {
+        return;
+    }
+
+    __disable_irq();
+
+    if (eTaskConfirmSleepModeStatus() == eAbortSleep) {
+        __enable_irq();
+        return;
+    }
+
+    // The current tick is partly elapsed, its rest is carried by the idle backend
+    slept_ticks = tickless_sleep(expected_ticks - 1, us_per_tick);
+    if (slept_ticks > expected_ticks) {
+        slept_ticks = expected_ticks;
+    }
+    vTaskStepTick(slept_ticks);
+
+    __enable_irq();
+}
+#endif /* CONFIG_RTOS_CMSIS_FREERTOS */
+
+#if defined(CONFIG_RTOS_CMSIS_RTX)
+/**
+ * @brief CMSIS-RTX tickless idle
+ */
+void tickless_rtx_idle(void) {
+    uint32_t us_per_tick = 1000000 / osKernelGetTickFreq();
+    uint32_t slept_ticks = 0;
+    uint32_t ticks;
+
+    ticks = osKernelSuspend();
+    if (ticks > 1) {
+        slept_ticks = tickless_sleep(ticks - 1, us_per_tick);
+    }
+    osKernelResume(slept_ticks);
+}
+#endif /* CONFIG_RTOS_CMSIS_RTX */
+
+#if defined(CONFIG_RTOS_THREADX)
+static uint32_t tickless_threadx_ticks = 0;
+static uint32_t tickless_threadx_slept = 0;
+
+/**
+ * @brief ThreadX low power timer setup
+ * 
+ * @param ticks Number of ticks until the next timer expires
+ */
+void tickless_threadx_setup(uint32_t ticks) {
+    tickless_threadx_ticks = ticks;
+}
+
+/**
+ * @brief ThreadX low power enter
+ */
+void tickless_threadx_enter(void) {
+    uint32_t us_per_tick = 1000000 / TX_TIMER_TICKS_PER_SECOND;
+
+    // No active timer (0), sleep until an interrupt occurs
+    tickless_threadx_slept = tickless_sleep(tickless_threadx_ticks, us_per_tick);
+    tickless_threadx_ticks = 0;
+}
+
+/**
+ * @brief ThreadX low power timer adjust
+ * 
+ * @return Number of ticks slept
+ */
+uint32_t tickless_threadx_adjust(void) {
+    uint32_t slept = tickless_threadx_slept;
+
+    tickless_threadx_slept = 0;
+
+    return slept;
+}
+#endif /* CONFIG_RTOS_THREADX */
@@ -28,10 +28,10 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+#include "omni_config.h"
 #include "include/toolchain.h"
 #include "include/util.h"
 #include "include/assert.h"
-#include "omni_config.h"
 #if defined(CONFIG_OMNI_DRIVER)
 #include "omni_device_cfg.h"
 #endif /* CONFIG_OMNI_DRIVER */
@@ -47,6 +47,42 @@ extern "C" {
   #endif /* __packed */
 #endif /* __GNUC__ */
 
+/**
+ * Memory placement, the linker scripts of each target map the sections:
+ * - OMNI_FAST_CODE: ITCM on STM32H7, copied from flash at startup. Stays
+ *   in flash on F1/F4 where the fast RAM cannot execute.
+ * - OMNI_FAST_DATA: CCMRAM on STM32F405/407, DTCM on STM32H7, regular
+ *   SRAM otherwise. Initialized at startup, not reachable by DMA.
+ * - OMNI_DMA_DATA: SRAM reachable by every DMA controller, D2 SRAM on
+ *   STM32H7. Zeroed at startup, aligned to the cache line.
+ */
+#define OMNI_FAST_CODE      __attribute__((section(".omni_fast_code"), noinline))
+#define OMNI_FAST_DATA      __attribute__((section(".omni_fast_data")))
+#define OMNI_DMA_DATA       __attribute__((section(".omni_dma"), aligned(32)))
+
+#if defined(CONFIG_FAST_ISR)
+#define OMNI_FAST_ISR       OMNI_FAST_CODE
+#else
+#define OMNI_FAST_ISR
+#endif /* CONFIG_FAST_ISR */
+
+#if defined(CONFIG_FAST_RING_BUFFER)
+#define OMNI_FAST_RING_BUFFER   OMNI_FAST_CODE
+#else
+#define OMNI_FAST_RING_BUFFER
+#endif /* CONFIG_FAST_RING_BUFFER */
+
+/**
+ * Linkage of the HAL functions behind a driver API table. With direct
+ * driver calls the driver header defines the table in every translation
+ * unit, so the HAL functions must be visible to them.
+ */
+#if defined(CONFIG_OMNI_DRIVER_DIRECT_CALL)
+#define OMNI_DRIVER_API
+#else
+#define OMNI_DRIVER_API     static
+#endif /* CONFIG_OMNI_DRIVER_DIRECT_CALL */
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -1,7 +1,7 @@
 /**
-  * @file    dwt_hal.c
+  * @file    timer_hal.c
   * @author  LuckkMaker
-  * @brief   DWT HAL driver
+  * @brief   Timer HAL driver
   * @attention
   *
   * Copyright (c) 2024 LuckkMaker
@@ -27,11 +27,13 @@
 static void timer_delay_ms(uint32_t delay);
 static void timer_delay_us(uint32_t delay);
 static uint32_t timer_get_tick(uint32_t frequency);
+static uint32_t timer_idle(uint32_t us);
 
 const struct timer_driver_api timer_driver = {
     .delay_ms = timer_delay_ms,
     .delay_us = timer_delay_us,
     .get_tick = timer_get_tick,
+    .idle = timer_idle,
 };
 
 /**
@@ -60,3 +62,13 @@ static void timer_delay_us(uint32_t delay) {
 static uint32_t timer_get_tick(uint32_t frequency) {
     return dwt_hal_get_tick(frequency);
 }
+
+/**
+ * @brief Sleep until the next interrupt or timeout
+ * 
+ * @param us Maximum number of microseconds to sleep
+ * @return Number of microseconds actually slept
+ */
+static uint32_t timer_idle(uint32_t us) {
+    return dwt_hal_sleep_us(us);
+}
@@ -0,0 +1,194 @@
+/**
+  * @file    dwt_hal.c
+  * @author  LuckkMaker
+  * @brief   DWT HAL driver
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "hal/dwt_hal.h"
+
+#define DWT_GET_CYCLE_COUNT()   DWT->CYCCNT
+#define DWT_RESET_CYCLE_COUNT() DWT->CYCCNT = 0
+
+// Shorter rests of a SysTick period are not armed, the period ends at wake-up
+#define DWT_SYSTICK_MIN_RELOAD  16U
+
+/**
+ * @brief Initialize DWT
+ * 
+ * @return Operation status
+ */
+int dwt_hal_init(void) {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT_RESET_CYCLE_COUNT();
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Deinitialize DWT
+ * 
+ * @return Operation status
+ */
+int dwt_hal_deinit(void) {
+    // Disable DWT unit
+    DWT->CTRL &= ~DWT_CTRL_CYCCNTENA_Msk;
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Delay for a number of microseconds
+ * 
+ * @param us Number of microseconds to delay
+ */
+void dwt_hal_delay_us(uint32_t us) {
+    uint32_t start = DWT_GET_CYCLE_COUNT();
+    // Calculate number of cycles per microsecond
+    uint32_t cycles = us * (SystemCoreClock / 1000000);
+
+#if defined(CONFIG_TIMER_LOW_POWER_DELAY)
+    if (us > CONFIG_TIMER_LOW_POWER_THRESHOLD_US) {
+        // Keep the tail of the delay for the calibrated spin below
+        uint32_t sleep_cycles = cycles - CONFIG_TIMER_LOW_POWER_THRESHOLD_US * (SystemCoreClock / 1000000);
+        uint32_t elapsed;
+
+        // Other interrupts may wake the core early, so sleep again until done
+        while ((elapsed = DWT_GET_CYCLE_COUNT() - start) < sleep_cycles) {
+            if (dwt_hal_sleep_us((sleep_cycles - elapsed) / (SystemCoreClock / 1000000)) == 0) {
+                break;
+            }
+        }
+    }
+#endif /* CONFIG_TIMER_LOW_POWER_DELAY */
+
+    while ((DWT_GET_CYCLE_COUNT() - start) < cycles) {
+    }
+}
+
+/**
+ * @brief Delay for a number of milliseconds
+ * 
+ * @param ms Number of milliseconds to delay
+ */
+void dwt_hal_delay_ms(uint32_t ms) {
+    dwt_hal_delay_us(ms * 1000);
+}
+
+/**
+ * @brief Get tick
+ * 
+ * @return Current tick
+ */
+uint32_t dwt_hal_get_tick(uint32_t frequency) {
+    return DWT_GET_CYCLE_COUNT() / (SystemCoreClock / frequency);
+}
+
+/**
+ * @brief Sleep for up to a number of microseconds
+ * 
+ * @note SysTick is armed as the wake-up compare timer and restored before
+ *       return, so the caller must own SysTick (bare metal, or kernel tick
+ *       suspended). The sleep length is limited by the 24-bit SysTick counter.
+ *       A running SysTick resumes on its own period grid, the part of the
+ *       period elapsed before and during the sleep is carried into the
+ *       first reload, so a kernel tick does not drift by the sleep. The
+ *       kernel tick must run on the processor clock.
+ *       CYCCNT may halt while the core is gated, the slept cycles are added
+ *       back so that dwt_hal_get_tick() stays monotonic.
+ * @param us Maximum number of microseconds to sleep
+ * @return Number of microseconds actually slept
+ */
+uint32_t dwt_hal_sleep_us(uint32_t us) {
+    uint32_t cycles_per_us = SystemCoreClock / 1000000;
+    uint32_t cycles;
+    uint32_t elapsed;
+    uint32_t measured;
+    uint32_t start;
+    uint32_t primask;
+    uint32_t ctrl;
+    uint32_t load;
+    uint32_t phase;
+
+    if (us > (SysTick_LOAD_RELOAD_Msk / cycles_per_us)) {
+        us = SysTick_LOAD_RELOAD_Msk / cycles_per_us;
+    }
+
+    cycles = us * cycles_per_us;
+    if (cycles < 2) {
+        return 0;
+    }
+
+    // Mask interrupts, WFI still wakes up on a pending interrupt
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    ctrl = SysTick->CTRL;
+    load = SysTick->LOAD;
+    // Cycles of the running period already elapsed
+    phase = load - SysTick->VAL;
+    start = DWT_GET_CYCLE_COUNT();
+
+    SysTick->CTRL = 0;
+    SysTick->LOAD = cycles - 1;
+    SysTick->VAL = 0;
+    SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk | SysTick_CTRL_ENABLE_Msk;
+
+    // Wait for the first reload, VAL is zero until then
+    while (SysTick->VAL == 0) {
+    }
+
+    __DSB();
+    __WFI();
+    __ISB();
+
+    elapsed = (cycles - 1) - SysTick->VAL;
+    if (SysTick->CTRL & SysTick_CTRL_COUNTFLAG_Msk) {
+        elapsed = cycles;
+    }
+
+    // Restore SysTick and drop the wake-up request
+    SysTick->CTRL = 0;
+    SCB->ICSR = SCB_ICSR_PENDSTCLR_Msk;
+    phase = (phase + elapsed) % (load + 1U);
+    if ((load - phase) < DWT_SYSTICK_MIN_RELOAD) {
+        // Too little left to arm, the period ends here
+        phase = 0;
+    }
+
+    // First period is the rest of the interrupted one, then full periods
+    SysTick->LOAD = load - phase;
+    SysTick->VAL = 0;
+    SysTick->CTRL = ctrl & (SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk | SysTick_CTRL_ENABLE_Msk);
+    if ((ctrl & SysTick_CTRL_ENABLE_Msk) != 0U) {
+        while (SysTick->VAL == 0) {
+        }
+    }
+    SysTick->LOAD = load;
+
+    measured = DWT_GET_CYCLE_COUNT() - start;
+    if (measured < elapsed) {
+        DWT->CYCCNT += elapsed - measured;
+    }
+
+    __set_PRIMASK(primask);
+
+    return elapsed / cycles_per_us;
+}
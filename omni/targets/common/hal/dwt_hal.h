@@ -36,6 +36,7 @@ int dwt_hal_deinit(void);
 void dwt_hal_delay_us(uint32_t us);
 void dwt_hal_delay_ms(uint32_t ms);
 uint32_t dwt_hal_get_tick(uint32_t frequency);
+uint32_t dwt_hal_sleep_us(uint32_t us);
 
 #ifdef __cplusplus
 }
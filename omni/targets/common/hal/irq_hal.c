@@ -0,0 +1,420 @@
+/**
+  * @file    irq_hal.c
+  * @author  LuckkMaker
+  * @brief   IRQ HAL for STM32
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "hal/irq_hal.h"
+#include "ll/irq_ll.h"
+#if defined(CONFIG_TRACE_IRQ)
+#include "trace/trace.h"
+#endif /* CONFIG_TRACE_IRQ */
+
+// NVIC priority grouping
+#define NVIC_PRIORITY_GROUPING_0     0x00000007U
+#define NVIC_PRIORITY_GROUPING_1     0x00000006U
+#define NVIC_PRIORITY_GROUPING_2     0x00000005U
+#define NVIC_PRIORITY_GROUPING_3     0x00000004U
+#define NVIC_PRIORITY_GROUPING_4     0x00000003U
+
+typedef void(*irq_vector_table_t)(void);
+
+#define IRQ_VECTOR_NUM  (CONFIG_IRQ_RES_NUM + CONFIG_IRQ_DEV_NUM)
+
+static __attribute__((section(".vtable"))) \
+irq_vector_table_t irq_ram_vector_table[IRQ_VECTOR_NUM] __attribute__((aligned(256)));
+
+#if defined(CONFIG_IRQ_STATS)
+#define IRQ_STATS_DEPTH_MAX     16U
+
+static irq_vector_table_t irq_stats_handler[IRQ_VECTOR_NUM];
+static irq_stats_t irq_stats[IRQ_VECTOR_NUM];
+static uint32_t irq_stats_pend_time[IRQ_VECTOR_NUM];
+static uint32_t irq_stats_nested_cycles[IRQ_STATS_DEPTH_MAX + 1];
+static uint32_t irq_stats_depth = 0;
+static uint32_t irq_stats_start = 0;
+static volatile uint32_t irq_stats_cycles = 0;
+
+static void irq_hal_stats_trampoline(void);
+#endif /* CONFIG_IRQ_STATS */
+
+
+/**
+ * @brief Register an interrupt handler
+ * 
+ * @param irq Interrupt number
+ * @param handler Pointer to the interrupt handler
+ */
+void irq_hal_register_handler(int irq, void (*handler)(void)) {
+    void (**base_addr)(void);
+    uint32_t i;
+
+    // Check if the RAM vector table is initialized
+    if (SCB->VTOR != (uint32_t)irq_ram_vector_table) {
+        base_addr = (void (**)(void))SCB->VTOR;
+        // Copy the vector table to RAM
+        for (i = 0; i < IRQ_VECTOR_NUM; i++) {
+            irq_ram_vector_table[i] = base_addr[i];
+        }
+
+        // Set the vector table to RAM
+        SCB->VTOR = (uint32_t)irq_ram_vector_table;
+    }
+
+#if defined(CONFIG_IRQ_STATS)
+    // Route the IRQ through the statistics trampoline
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    irq_stats_handler[irq + CONFIG_IRQ_RES_NUM] = handler;
+    handler = irq_hal_stats_trampoline;
+#endif /* CONFIG_IRQ_STATS */
+
+    // Register the interrupt handler
+    irq_ram_vector_table[irq + CONFIG_IRQ_RES_NUM] = handler;
+}
+
+/**
+ * @brief Unregister an interrupt handler
+ * 
+ * @param irq Interrupt number
+ */
+void irq_hal_unregister_handler(int irq) {
+    // Unregister the interrupt handler
+    irq_ram_vector_table[irq + CONFIG_IRQ_RES_NUM] = Default_Handler;
+}
+
+/**
+ * @brief Get a registered interrupt handler
+ * 
+ * @param irq Interrupt number
+ * @return Pointer to the interrupt handler, NULL if the RAM vector table is not in use
+ */
+irq_vector_table_t irq_hal_get_handler(int irq) {
+    if (SCB->VTOR != (uint32_t)irq_ram_vector_table) {
+        return NULL;
+    }
+
+#if defined(CONFIG_IRQ_STATS)
+    if (irq_ram_vector_table[irq + CONFIG_IRQ_RES_NUM] == irq_hal_stats_trampoline) {
+        return irq_stats_handler[irq + CONFIG_IRQ_RES_NUM];
+    }
+#endif /* CONFIG_IRQ_STATS */
+
+    return irq_ram_vector_table[irq + CONFIG_IRQ_RES_NUM];
+}
+
+/**
+ * @brief Set interrupt vector
+ * 
+ * @param irq Interrupt number
+ * @param vector Address of interrupt handler function
+ */
+void irq_hal_set_vector(int irq, uint32_t vector) {
+    NVIC_SetVector(irq, vector);
+}
+
+/**
+ * @brief Get interrupt vector
+ * 
+ * @param irq Interrupt number
+ * @return Address of interrupt handler function
+ */
+uint32_t irq_hal_get_vector(int irq) {
+    return NVIC_GetVector(irq);
+}
+
+/**
+ * @brief Set interrupt priority grouping
+ * 
+ * @param priority_grouping Priority grouping
+ */
+void irq_hal_set_priority_grouping(irq_priority_grouping_t priority_grouping) {
+    uint32_t temp;
+
+    switch (priority_grouping) {
+        case IRQ_PRIORITY_GROUP_0:
+            temp = NVIC_PRIORITY_GROUPING_0;
+            break;
+        case IRQ_PRIORITY_GROUP_1:
+            temp = NVIC_PRIORITY_GROUPING_1;
+            break;
+        case IRQ_PRIORITY_GROUP_2:
+            temp = NVIC_PRIORITY_GROUPING_2;
+            break;
+        case IRQ_PRIORITY_GROUP_3:
+            temp = NVIC_PRIORITY_GROUPING_3;
+            break;
+        case IRQ_PRIORITY_GROUP_4:
+            temp = NVIC_PRIORITY_GROUPING_4;
+            break;
+        default:
+            temp = NVIC_PRIORITY_GROUPING_4;
+            break;
+    }
+
+    // Set priority grouping
+    NVIC_SetPriorityGrouping(temp);
+}
+
+/**
+ * @brief Get interrupt priority grouping
+ * 
+ * @return Priority grouping
+ */
+uint32_t irq_hal_get_priority_grouping(void) {
+    return NVIC_GetPriorityGrouping();
+}
+
+/**
+ * @brief Enable interrupt
+ * 
+ * @param irq Interrupt number
+ */
+void irq_hal_enable(int irq) {
+    NVIC_EnableIRQ(irq);
+}
+
+/**
+ * @brief Get interrupt enable status
+ * 
+ * @param irq Interrupt number
+ * @return Enable status
+ */
+uint32_t irq_hal_get_enable(int irq) {
+    return NVIC_GetEnableIRQ(irq);
+}
+
+/**
+ * @brief Disable interrupt
+ * 
+ * @param irq Interrupt number
+ */
+void irq_hal_disable(int irq) {
+    NVIC_DisableIRQ(irq);
+}
+
+/**
+ * @brief Set interrupt pending
+ * 
+ * @param irq Interrupt number
+ */
+void irq_hal_set_pending(int irq) {
+#if defined(CONFIG_IRQ_STATS)
+    // Hardware does not record when an IRQ becomes pending, software
+    // pended IRQs are the only ones with a known pend time
+    irq_stats_pend_time[irq + CONFIG_IRQ_RES_NUM] = DWT->CYCCNT;
+#endif /* CONFIG_IRQ_STATS */
+    NVIC_SetPendingIRQ(irq);
+}
+
+/**
+ * @brief Get interrupt pending status
+ * 
+ * @param irq Interrupt number
+ * @return Pending status
+ */
+uint32_t irq_hal_get_pending(int irq) {
+    return NVIC_GetPendingIRQ(irq);
+}
+
+/**
+ * @brief Clear interrupt pending
+ * 
+ * @param irq Interrupt number
+ */
+void irq_hal_clear_pending(int irq) {
+    NVIC_ClearPendingIRQ(irq);
+}
+
+/**
+ * @brief Set interrupt priority
+ * 
+ * @param irq Interrupt number
+ * @param preemption_priority Preemption priority
+ * @param sub_priority Sub priority
+ */
+void irq_hal_set_priority(int irq, uint32_t preemption_priority, uint32_t sub_priority) {
+    NVIC_SetPriority(irq, NVIC_EncodePriority(NVIC_GetPriorityGrouping(), preemption_priority, sub_priority));
+}
+
+/**
+ * @brief Get interrupt priority
+ * 
+ * @param irq Interrupt number
+ * @param preemption_priority Preemption priority
+ * @param sub_priority Sub priority
+ */
+void irq_hal_get_priority(int irq, uint32_t *preemption_priority, uint32_t *sub_priority) {
+    NVIC_DecodePriority(NVIC_GetPriority(irq), NVIC_GetPriorityGrouping(), preemption_priority, sub_priority);
+}
+
+/**
+ * @brief Get active interrupt
+ * 
+ * @param irq Interrupt number
+ * @return Active interrupt
+ */
+uint32_t irq_hal_get_active(int irq) {
+    return NVIC_GetActive(irq);
+}
+
+/**
+ * @brief System reset
+ */
+void irq_hal_system_reset(void) {
+    NVIC_SystemReset();
+}
+
+#if defined(CONFIG_IRQ_STATS)
+/**
+ * @brief Get statistics of an interrupt
+ * 
+ * @param irq Interrupt number
+ * @param stats Pointer to statistics
+ * @return Operation status
+ */
+int irq_hal_stats_get(int irq, irq_stats_t *stats) {
+    uint32_t primask;
+
+    if ((irq + CONFIG_IRQ_RES_NUM < 0) || (irq + CONFIG_IRQ_RES_NUM >= IRQ_VECTOR_NUM) || (stats == NULL)) {
+        return OMNI_FAIL;
+    }
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    *stats = irq_stats[irq + CONFIG_IRQ_RES_NUM];
+    __set_PRIMASK(primask);
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Get cycles spent in interrupt handlers
+ * 
+ * @note Free running counter that wraps like the DWT cycle counter, the
+ *       difference of two reads is the handler time in between.
+ * @return Handler cycles
+ */
+uint32_t irq_hal_stats_cycles(void) {
+    return irq_stats_cycles;
+}
+
+/**
+ * @brief Reset statistics of all interrupts
+ */
+void irq_hal_stats_reset(void) {
+    uint32_t primask;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    for (uint32_t i = 0; i < IRQ_VECTOR_NUM; i++) {
+        irq_stats[i] = (irq_stats_t){0};
+    }
+    irq_stats_start = DWT->CYCCNT;
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Dump statistics of all interrupts that have run
+ * 
+ * @note The load column is the share of cycles since the last reset, it is
+ *       only meaningful while the cycle counter has not wrapped.
+ * @param print Print function
+ */
+void irq_hal_stats_dump(int (*print)(const char *format, ...)) {
+    irq_stats_t stats;
+    uint32_t elapsed = DWT->CYCCNT - irq_stats_start;
+
+    print("%5s %10s %10s %10s %10s %5s %7s\r\n", "irq", "count", "mean", "max", "latency", "depth", "load");
+
+    for (int i = 0; i < (int)IRQ_VECTOR_NUM; i++) {
+        irq_hal_stats_get(i - CONFIG_IRQ_RES_NUM, &stats);
+        if (stats.count == 0) {
+            continue;
+        }
+
+        print("%5d %10lu %10lu %10lu %10lu %5lu %6lu%%\r\n", i - CONFIG_IRQ_RES_NUM, (unsigned long)stats.count, \
+            (unsigned long)(stats.total_cycles / stats.count), (unsigned long)stats.max_cycles, \
+            (unsigned long)stats.max_latency, (unsigned long)stats.max_depth, \
+            (unsigned long)((elapsed != 0) ? (stats.total_cycles * 100U / elapsed) : 0));
+    }
+}
+
+/**
+ * @brief Statistics trampoline installed for every registered interrupt
+ * 
+ * @note The active exception number is read from IPSR, so one trampoline
+ *       serves all vectors. Cycles of nested interrupts are subtracted from
+ *       the interrupted handler.
+ */
+static OMNI_FAST_ISR void irq_hal_stats_trampoline(void) {
+    uint32_t start = DWT->CYCCNT;
+    uint32_t vector = __get_IPSR();
+    irq_stats_t *stats = &irq_stats[vector];
+    uint32_t depth;
+    uint32_t cycles;
+    uint32_t primask;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    depth = ++irq_stats_depth;
+    if (depth <= IRQ_STATS_DEPTH_MAX) {
+        irq_stats_nested_cycles[depth] = 0;
+    }
+    if (irq_stats_pend_time[vector] != 0) {
+        cycles = start - irq_stats_pend_time[vector];
+        irq_stats_pend_time[vector] = 0;
+        if (cycles > stats->max_latency) {
+            stats->max_latency = cycles;
+        }
+    }
+    __set_PRIMASK(primask);
+
+#if defined(CONFIG_TRACE_IRQ)
+    TRACE_RECORD(TRACE_EVENT_IRQ_ENTER, vector, 0);
+#endif /* CONFIG_TRACE_IRQ */
+    irq_stats_handler[vector]();
+#if defined(CONFIG_TRACE_IRQ)
+    TRACE_RECORD(TRACE_EVENT_IRQ_EXIT, vector, 0);
+#endif /* CONFIG_TRACE_IRQ */
+
+    __disable_irq();
+    cycles = DWT->CYCCNT - start;
+    if (depth <= IRQ_STATS_DEPTH_MAX) {
+        // Hand the full duration to the interrupted handler
+        irq_stats_nested_cycles[depth - 1] += cycles;
+        cycles -= irq_stats_nested_cycles[depth];
+    }
+    irq_stats_depth--;
+    if (depth == 1) {
+        irq_stats_cycles += DWT->CYCCNT - start;
+    }
+
+    stats->count++;
+    stats->total_cycles += cycles;
+    if (cycles > stats->max_cycles) {
+        stats->max_cycles = cycles;
+    }
+    if (depth > stats->max_depth) {
+        stats->max_depth = depth;
+    }
+    __set_PRIMASK(primask);
+}
+#endif /* CONFIG_IRQ_STATS */
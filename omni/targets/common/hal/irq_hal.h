@@ -44,6 +44,7 @@ typedef enum {
 
 void irq_hal_register_handler(int irq, void (*handler)(void));
 void irq_hal_unregister_handler(int irq);
+void (*irq_hal_get_handler(int irq))(void);
 void irq_hal_set_vector(int irq, uint32_t vector);
 uint32_t irq_hal_get_vector(int irq);
 void irq_hal_set_priority_grouping(irq_priority_grouping_t priority_grouping);
@@ -59,6 +60,24 @@ void irq_hal_get_priority(int irq, uint32_t *preemption_priority, uint32_t *sub_
 uint32_t irq_hal_get_active(int irq);
 void irq_hal_system_reset(void);
 
+#if defined(CONFIG_IRQ_STATS)
+/**
+ * @brief IRQ statistics
+ */
+typedef struct irq_stats {
+    uint32_t count;                 /**< Number of invocations */
+    uint32_t max_cycles;            /**< Longest execution, nested IRQs excluded */
+    uint64_t total_cycles;          /**< Total execution, nested IRQs excluded */
+    uint32_t max_latency;           /**< Longest pend to entry latency */
+    uint32_t max_depth;             /**< Deepest nesting level at entry */
+} irq_stats_t;
+
+int irq_hal_stats_get(int irq, irq_stats_t *stats);
+void irq_hal_stats_reset(void);
+uint32_t irq_hal_stats_cycles(void);
+void irq_hal_stats_dump(int (*print)(const char *format, ...));
+#endif /* CONFIG_IRQ_STATS */
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
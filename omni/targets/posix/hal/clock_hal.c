@@ -0,0 +1,92 @@
+/**
+  * @file    clock_hal.c
+  * @author  LuckkMaker
+  * @brief   Clock HAL driver
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <time.h>
+#include <errno.h>
+#include "drivers/clock.h"
+#include "hal/clock_hal.h"
+
+#define CLOCK_HAL_NS_PER_SEC    1000000000ULL
+
+// Cycles are nanoseconds of the monotonic clock
+uint32_t SystemCoreClock = 1000000000U;
+
+static int clock_hal_init(void);
+
+const struct clock_driver_api clock_driver = {
+    .init = clock_hal_init,
+};
+
+/**
+ * @brief Initialize clock driver
+ * 
+ * @note Nothing to configure on the host, the monotonic clock always runs.
+ * @return Operation status
+ */
+static int clock_hal_init(void) {
+    struct timespec ts;
+
+    if (clock_getres(CLOCK_MONOTONIC, &ts) != 0) {
+        return OMNI_FAIL;
+    }
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Get monotonic time
+ * 
+ * @return Time in nanoseconds
+ */
+uint64_t clock_hal_get_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ((uint64_t)ts.tv_sec * CLOCK_HAL_NS_PER_SEC) + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Get free running cycle counter
+ * 
+ * @note Stands in for DWT->CYCCNT, wraps every 4.29 seconds.
+ * @return Cycle counter
+ */
+uint32_t clock_hal_get_cycles(void) {
+    return (uint32_t)clock_hal_get_ns();
+}
+
+/**
+ * @brief Sleep for a number of nanoseconds
+ * 
+ * @param ns Number of nanoseconds
+ */
+void clock_hal_sleep_ns(uint64_t ns) {
+    struct timespec ts;
+
+    ts.tv_sec = (time_t)(ns / CLOCK_HAL_NS_PER_SEC);
+    ts.tv_nsec = (long)(ns % CLOCK_HAL_NS_PER_SEC);
+
+    while (clock_nanosleep(CLOCK_MONOTONIC, 0, &ts, &ts) == EINTR) {
+    }
+}
@@ -1,7 +1,7 @@
 /**
-  * @file    dwt_hal.h
+  * @file    clock_hal.h
   * @author  LuckkMaker
-  * @brief   Header for dwt_hal.c file
+  * @brief   Header for clock_hal.c file
   * @attention
   *
   * Copyright (c) 2024 LuckkMaker
@@ -21,8 +21,8 @@
   */
 
 /* Define to prevent recursive inclusion -------------------------------------*/
-#ifndef OMNI_HAL_DWT_H
-#define OMNI_HAL_DWT_H
+#ifndef OMNI_HAL_CLOCK_H
+#define OMNI_HAL_CLOCK_H
 
 /* Includes ------------------------------------------------------------------*/
 #include "include/device.h"
@@ -31,14 +31,12 @@
 extern "C" {
 #endif
 
-int dwt_hal_init(void);
-int dwt_hal_deinit(void);
-void dwt_hal_delay_us(uint32_t us);
-void dwt_hal_delay_ms(uint32_t ms);
-uint32_t dwt_hal_get_tick(uint32_t frequency);
+uint64_t clock_hal_get_ns(void);
+uint32_t clock_hal_get_cycles(void);
+void clock_hal_sleep_ns(uint64_t ns);
 
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
 
-#endif /* OMNI_HAL_DWT_H */
+#endif /* OMNI_HAL_CLOCK_H */
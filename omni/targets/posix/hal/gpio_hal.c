@@ -0,0 +1,608 @@
+/**
+  * @file    gpio_hal.c
+  * @author  LuckkMaker
+  * @brief   GPIO HAL driver
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <pthread.h>
+#include "drivers/gpio.h"
+#include "hal/gpio_hal.h"
+#include "hal/clock_hal.h"
+#if defined(CONFIG_GPIO_IRQ)
+#include "hal/irq_hal.h"
+#endif /* CONFIG_GPIO_IRQ */
+
+#define PIN_PORT(gpio_num)           ((uint8_t)(((gpio_num) >> 4) & 0xFU))
+#define PIN_NUM(gpio_num)            ((uint8_t)((gpio_num) & 0xFU))
+#define GET_GPIO_PIN(gpio_num)       ((uint16_t)(1U << PIN_NUM(gpio_num)))
+
+#define GPIO_PORT_MAX                ((uint32_t)CONFIG_GPIO_PORT_NUM)
+#define GPIO_PIN_MAX                 (GPIO_PORT_MAX * 16U)
+
+/**
+ * @brief GPIO port state
+ */
+typedef struct {
+    uint16_t output;                /**< Output data */
+    uint16_t input;                 /**< Level driven from outside */
+    uint16_t driven;                /**< Pins driven from outside */
+    uint16_t is_output;             /**< Pins configured as output */
+    uint16_t pull_up;               /**< Level of an undriven input */
+} gpio_port_t;
+
+/**
+ * @brief GPIO pin watch
+ */
+typedef struct {
+    gpio_hal_watch_t watch;
+    void *context;
+} gpio_watch_t;
+
+static gpio_port_t gpio_port[GPIO_PORT_MAX];
+static gpio_watch_t gpio_watch[GPIO_PIN_MAX];
+static pthread_mutex_t gpio_lock = PTHREAD_MUTEX_INITIALIZER;
+
+OMNI_DRIVER_API int gpio_hal_init(uint32_t gpio_num, gpio_driver_config_t *config);
+OMNI_DRIVER_API int gpio_hal_deinit(uint32_t gpio_num);
+OMNI_DRIVER_API int gpio_hal_set_level(uint32_t gpio_num, uint32_t level);
+OMNI_DRIVER_API uint32_t gpio_hal_get_level(uint32_t gpio_num);
+OMNI_DRIVER_API int gpio_hal_toggle(uint32_t gpio_num);
+#if defined(CONFIG_GPIO_IRQ)
+OMNI_DRIVER_API int gpio_hal_irq_enable(uint32_t gpio_num, gpio_trigger_t trigger, gpio_pull_t pull, uint32_t debounce_us);
+OMNI_DRIVER_API int gpio_hal_irq_disable(uint32_t gpio_num);
+OMNI_DRIVER_API int gpio_hal_read_event(gpio_event_t *event);
+OMNI_DRIVER_API uint32_t gpio_hal_get_count(uint32_t gpio_num);
+OMNI_DRIVER_API uint32_t gpio_hal_get_lost(void);
+#endif /* CONFIG_GPIO_IRQ */
+
+#if !defined(CONFIG_OMNI_DRIVER_DIRECT_CALL)
+const struct gpio_driver_api gpio_driver = {
+    .init = gpio_hal_init,
+    .deinit = gpio_hal_deinit,
+    .set_level = gpio_hal_set_level,
+    .get_level = gpio_hal_get_level,
+    .toggle = gpio_hal_toggle,
+#if defined(CONFIG_GPIO_IRQ)
+    .irq_enable = gpio_hal_irq_enable,
+    .irq_disable = gpio_hal_irq_disable,
+    .read_event = gpio_hal_read_event,
+    .get_count = gpio_hal_get_count,
+    .get_lost = gpio_hal_get_lost,
+#endif /* CONFIG_GPIO_IRQ */
+};
+#endif /* CONFIG_OMNI_DRIVER_DIRECT_CALL */
+
+#if defined(CONFIG_GPIO_IRQ)
+#define GPIO_EVENT_MASK             (CONFIG_GPIO_IRQ_EVENT_NUM - 1U)
+
+#if (CONFIG_GPIO_IRQ_EVENT_NUM & GPIO_EVENT_MASK) != 0
+#error "CONFIG_GPIO_IRQ_EVENT_NUM must be a power of two"
+#endif
+
+/**
+ * @brief Edge interrupt state of a pin
+ */
+typedef struct {
+    uint8_t trigger;                /**< Enabled edges, 0 if disabled */
+    uint8_t pending;                /**< Edge waiting for the handler */
+    uint8_t level;                  /**< Level after the edge */
+    uint32_t timestamp;             /**< Cycle counter value at the edge */
+    uint32_t debounce;              /**< Debounce time in cycles */
+    uint32_t last;                  /**< Timestamp of the last accepted edge */
+    volatile uint32_t count;        /**< Edges seen on the pin */
+} gpio_exti_line_t;
+
+/**
+ * @brief Edge event ring, written by the EXTI handler and read by threads
+ */
+typedef struct {
+    gpio_event_t event[CONFIG_GPIO_IRQ_EVENT_NUM];
+    volatile uint32_t head;
+    volatile uint32_t tail;
+    volatile uint32_t lost;
+} gpio_event_ring_t;
+
+static gpio_exti_line_t gpio_exti_line[GPIO_PIN_MAX];
+static gpio_event_ring_t gpio_event_ring;
+static uint32_t gpio_exti_init = 0;
+
+static void gpio_hal_exti_irq_handler(void);
+#endif /* CONFIG_GPIO_IRQ */
+
+static uint16_t gpio_hal_port_level(const gpio_port_t *port);
+static void gpio_hal_update(uint32_t port, uint16_t before);
+
+/**
+ * @brief Open GPIO
+ * 
+ * @param gpio_num GPIO number
+ * @param config Pointer to GPIO driver configuration structure
+ * @return Operation status
+ */
+OMNI_DRIVER_API int gpio_hal_init(uint32_t gpio_num, gpio_driver_config_t *config) {
+    gpio_port_t *port;
+    uint16_t pin;
+    uint16_t before;
+    omni_assert_not_null(config);
+    omni_assert(PIN_PORT(gpio_num) < GPIO_PORT_MAX);
+
+    port = &gpio_port[PIN_PORT(gpio_num)];
+    pin = GET_GPIO_PIN(gpio_num);
+
+    pthread_mutex_lock(&gpio_lock);
+    before = gpio_hal_port_level(port);
+
+    if (config->level == GPIO_LEVEL_HIGH) {
+        port->output |= pin;
+    } else {
+        port->output &= ~pin;
+    }
+
+    if (config->mode == GPIO_MODE_DEFAULT_INPUT) {
+        port->is_output &= ~pin;
+    } else {
+        port->is_output |= pin;
+    }
+
+    if (config->pull == GPIO_PULL_UP) {
+        port->pull_up |= pin;
+    } else {
+        port->pull_up &= ~pin;
+    }
+    pthread_mutex_unlock(&gpio_lock);
+
+    gpio_hal_update(PIN_PORT(gpio_num), before);
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Close GPIO
+ * 
+ * @param gpio_num GPIO number
+ * @return Operation status
+ */
+OMNI_DRIVER_API int gpio_hal_deinit(uint32_t gpio_num) {
+    gpio_port_t *port;
+    uint16_t pin;
+    uint16_t before;
+    omni_assert(PIN_PORT(gpio_num) < GPIO_PORT_MAX);
+
+    port = &gpio_port[PIN_PORT(gpio_num)];
+    pin = GET_GPIO_PIN(gpio_num);
+
+    pthread_mutex_lock(&gpio_lock);
+    before = gpio_hal_port_level(port);
+    port->output &= ~pin;
+    port->is_output &= ~pin;
+    port->pull_up &= ~pin;
+    pthread_mutex_unlock(&gpio_lock);
+
+    gpio_hal_update(PIN_PORT(gpio_num), before);
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Set GPIO level
+ * 
+ * @param gpio_num GPIO number
+ * @param level GPIO level
+ * @return Operation status
+ */
+OMNI_DRIVER_API int gpio_hal_set_level(uint32_t gpio_num, uint32_t level) {
+    omni_assert(PIN_PORT(gpio_num) < GPIO_PORT_MAX);
+
+    gpio_hal_fast_write(gpio_num, level);
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Get GPIO level
+ * 
+ * @param gpio_num GPIO number
+ * @return GPIO level
+ */
+OMNI_DRIVER_API uint32_t gpio_hal_get_level(uint32_t gpio_num) {
+    omni_assert(PIN_PORT(gpio_num) < GPIO_PORT_MAX);
+
+    return gpio_hal_fast_read(gpio_num);
+}
+
+/**
+ * @brief Toggle GPIO level
+ * 
+ * @param gpio_num GPIO number
+ * @return Operation status
+ */
+OMNI_DRIVER_API int gpio_hal_toggle(uint32_t gpio_num) {
+    omni_assert(PIN_PORT(gpio_num) < GPIO_PORT_MAX);
+
+    gpio_hal_fast_toggle(gpio_num);
+
+    return OMNI_OK;
+}
+
+#if defined(CONFIG_GPIO_IRQ)
+/**
+ * @brief Enable edge interrupt on a GPIO
+ *
+ * @note Every pin has its own line on the host. Edges closer than
+ *       @p debounce_us to the last accepted edge are dropped when events
+ *       are read.
+ * @param gpio_num GPIO number
+ * @param trigger Interrupt trigger edge
+ * @param pull GPIO pull
+ * @param debounce_us Debounce time in microseconds, 0 to disable
+ * @return Operation status
+ */
+OMNI_DRIVER_API int gpio_hal_irq_enable(uint32_t gpio_num, gpio_trigger_t trigger, gpio_pull_t pull, uint32_t debounce_us) {
+    gpio_exti_line_t *line;
+    gpio_driver_config_t config = {
+        .mode = GPIO_MODE_DEFAULT_INPUT,
+        .pull = pull,
+        .speed = GPIO_SPEED_LEVEL_LOW,
+        .level = GPIO_LEVEL_LOW,
+    };
+    omni_assert(PIN_PORT(gpio_num) < GPIO_PORT_MAX);
+
+    if (!gpio_exti_init) {
+        irq_hal_register_handler(EXTI_IRQn, gpio_hal_exti_irq_handler);
+        irq_hal_set_priority(EXTI_IRQn, CONFIG_GPIO_IRQ_PRIO, 0);
+        irq_hal_enable(EXTI_IRQn);
+        gpio_exti_init = 1;
+    }
+
+    gpio_hal_init(gpio_num, &config);
+
+    line = &gpio_exti_line[gpio_num];
+    pthread_mutex_lock(&gpio_lock);
+    line->pending = 0;
+    line->debounce = debounce_us * (SystemCoreClock / 1000000U);
+    line->last = 0;
+    line->count = 0;
+    line->trigger = (uint8_t)trigger;
+    pthread_mutex_unlock(&gpio_lock);
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Disable edge interrupt on a GPIO
+ *
+ * @param gpio_num GPIO number
+ * @return Operation status
+ */
+OMNI_DRIVER_API int gpio_hal_irq_disable(uint32_t gpio_num) {
+    gpio_exti_line_t *line;
+    omni_assert(PIN_PORT(gpio_num) < GPIO_PORT_MAX);
+
+    line = &gpio_exti_line[gpio_num];
+    if (line->trigger == 0) {
+        return OMNI_FAIL;
+    }
+
+    pthread_mutex_lock(&gpio_lock);
+    line->trigger = 0;
+    line->pending = 0;
+    pthread_mutex_unlock(&gpio_lock);
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Read the next edge event
+ *
+ * @note Debounce filtering is done here in thread context, the interrupt
+ *       handler only queues edges.
+ * @param event Pointer to event
+ * @return OMNI_OK if an event was read, OMNI_FAIL if the ring is empty
+ */
+OMNI_DRIVER_API int gpio_hal_read_event(gpio_event_t *event) {
+    gpio_exti_line_t *line;
+    uint32_t tail;
+    omni_assert_not_null(event);
+
+    tail = gpio_event_ring.tail;
+    while (tail != gpio_event_ring.head) {
+        *event = gpio_event_ring.event[tail];
+        tail = (tail + 1U) & GPIO_EVENT_MASK;
+        // Release the slot after the event has been copied
+        __DMB();
+        gpio_event_ring.tail = tail;
+
+        line = &gpio_exti_line[event->gpio_num];
+        if ((line->debounce != 0) && ((event->timestamp - line->last) < line->debounce)) {
+            continue;
+        }
+        line->last = event->timestamp;
+
+        return OMNI_OK;
+    }
+
+    return OMNI_FAIL;
+}
+
+/**
+ * @brief Get number of edges seen on a GPIO
+ *
+ * @note Counted before debouncing, edges are counted even if the event ring
+ *       is full.
+ * @param gpio_num GPIO number
+ * @return Number of edges
+ */
+OMNI_DRIVER_API uint32_t gpio_hal_get_count(uint32_t gpio_num) {
+    omni_assert(PIN_PORT(gpio_num) < GPIO_PORT_MAX);
+
+    return gpio_exti_line[gpio_num].count;
+}
+
+/**
+ * @brief Get number of edge events lost on a full ring
+ *
+ * @return Number of lost events
+ */
+OMNI_DRIVER_API uint32_t gpio_hal_get_lost(void) {
+    return gpio_event_ring.lost;
+}
+
+/********************* IRQ handlers **********************/
+
+/**
+ * @brief EXTI IRQ handler, queues the edges latched since the last run
+ */
+static void gpio_hal_exti_irq_handler(void) {
+    gpio_exti_line_t *line;
+    gpio_event_t *event;
+    uint32_t head;
+    uint32_t next;
+
+    for (uint32_t i = 0; i < GPIO_PIN_MAX; i++) {
+        line = &gpio_exti_line[i];
+
+        pthread_mutex_lock(&gpio_lock);
+        if (!line->pending) {
+            pthread_mutex_unlock(&gpio_lock);
+            continue;
+        }
+        line->pending = 0;
+        pthread_mutex_unlock(&gpio_lock);
+
+        line->count++;
+
+        head = gpio_event_ring.head;
+        next = (head + 1U) & GPIO_EVENT_MASK;
+        if (next == gpio_event_ring.tail) {
+            gpio_event_ring.lost++;
+            continue;
+        }
+
+        event = &gpio_event_ring.event[head];
+        event->timestamp = line->timestamp;
+        event->gpio_num = (uint8_t)i;
+        event->level = line->level;
+        // Publish the event after it has been written
+        __DMB();
+        gpio_event_ring.head = next;
+    }
+}
+#endif /* CONFIG_GPIO_IRQ */
+
+/********************* HAL functions **********************/
+
+/**
+ * @brief Set and clear output pins of a port
+ * 
+ * @param gpio_num Any GPIO number on the port
+ * @param set_mask Pins to drive high
+ * @param clear_mask Pins to drive low
+ */
+void gpio_hal_write_port(uint32_t gpio_num, uint16_t set_mask, uint16_t clear_mask) {
+    gpio_port_t *port;
+    uint16_t before;
+    omni_assert(PIN_PORT(gpio_num) < GPIO_PORT_MAX);
+
+    port = &gpio_port[PIN_PORT(gpio_num)];
+
+    pthread_mutex_lock(&gpio_lock);
+    before = gpio_hal_port_level(port);
+    port->output = (uint16_t)((port->output & ~clear_mask) | set_mask);
+    pthread_mutex_unlock(&gpio_lock);
+
+    gpio_hal_update(PIN_PORT(gpio_num), before);
+}
+
+/**
+ * @brief Toggle output pins of a port
+ * 
+ * @param gpio_num Any GPIO number on the port
+ * @param mask Pins to toggle
+ */
+void gpio_hal_toggle_port(uint32_t gpio_num, uint16_t mask) {
+    gpio_port_t *port;
+    uint16_t before;
+    omni_assert(PIN_PORT(gpio_num) < GPIO_PORT_MAX);
+
+    port = &gpio_port[PIN_PORT(gpio_num)];
+
+    pthread_mutex_lock(&gpio_lock);
+    before = gpio_hal_port_level(port);
+    port->output ^= mask;
+    pthread_mutex_unlock(&gpio_lock);
+
+    gpio_hal_update(PIN_PORT(gpio_num), before);
+}
+
+/**
+ * @brief Read pin levels of a port
+ * 
+ * @param gpio_num Any GPIO number on the port
+ * @return Pin levels
+ */
+uint16_t gpio_hal_read_port(uint32_t gpio_num) {
+    uint16_t level;
+    omni_assert(PIN_PORT(gpio_num) < GPIO_PORT_MAX);
+
+    pthread_mutex_lock(&gpio_lock);
+    level = gpio_hal_port_level(&gpio_port[PIN_PORT(gpio_num)]);
+    pthread_mutex_unlock(&gpio_lock);
+
+    return level;
+}
+
+/**
+ * @brief Drive an input pin from outside
+ * 
+ * @note Used by tests and device models as stimulus, an edge on a pin with
+ *       an enabled edge interrupt raises EXTI_IRQn.
+ * @param gpio_num GPIO number
+ * @param level GPIO level
+ * @return Operation status
+ */
+int gpio_hal_inject(uint32_t gpio_num, uint32_t level) {
+    gpio_port_t *port;
+    uint16_t pin;
+    uint16_t before;
+
+    if (PIN_PORT(gpio_num) >= GPIO_PORT_MAX) {
+        return OMNI_FAIL;
+    }
+
+    port = &gpio_port[PIN_PORT(gpio_num)];
+    pin = GET_GPIO_PIN(gpio_num);
+
+    pthread_mutex_lock(&gpio_lock);
+    before = gpio_hal_port_level(port);
+    port->driven |= pin;
+    if (level) {
+        port->input |= pin;
+    } else {
+        port->input &= ~pin;
+    }
+    pthread_mutex_unlock(&gpio_lock);
+
+    gpio_hal_update(PIN_PORT(gpio_num), before);
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Watch level changes of a pin
+ * 
+ * @note The callback runs in the thread that changed the pin and must not
+ *       block. One watch per pin, NULL removes it.
+ * @param gpio_num GPIO number
+ * @param watch Callback, NULL to remove the watch
+ * @param context Context passed to the callback
+ * @return Operation status
+ */
+int gpio_hal_watch(uint32_t gpio_num, gpio_hal_watch_t watch, void *context) {
+    if (PIN_PORT(gpio_num) >= GPIO_PORT_MAX) {
+        return OMNI_FAIL;
+    }
+
+    pthread_mutex_lock(&gpio_lock);
+    if ((watch != NULL) && (gpio_watch[gpio_num].watch != NULL)) {
+        pthread_mutex_unlock(&gpio_lock);
+        return OMNI_BUSY;
+    }
+    gpio_watch[gpio_num].watch = watch;
+    gpio_watch[gpio_num].context = context;
+    pthread_mutex_unlock(&gpio_lock);
+
+    return OMNI_OK;
+}
+
+/********************* Private functions **********************/
+
+/**
+ * @brief Get pin levels of a port, called with the lock held
+ * 
+ * @param port Pointer to port state
+ * @return Pin levels
+ */
+static uint16_t gpio_hal_port_level(const gpio_port_t *port) {
+    uint16_t input;
+
+    input = (uint16_t)((port->input & port->driven) | (port->pull_up & ~port->driven));
+
+    return (uint16_t)((port->output & port->is_output) | (input & ~port->is_output));
+}
+
+/**
+ * @brief Report level changes of a port to watches and edge interrupts
+ * 
+ * @param port Port index
+ * @param before Pin levels before the change
+ */
+static void gpio_hal_update(uint32_t port, uint16_t before) {
+    uint16_t after;
+    uint16_t changed;
+    uint32_t gpio_num;
+    uint32_t level;
+    gpio_watch_t watch;
+#if defined(CONFIG_GPIO_IRQ)
+    uint32_t timestamp = clock_hal_get_cycles();
+    uint32_t pend = 0;
+    gpio_exti_line_t *line;
+#endif /* CONFIG_GPIO_IRQ */
+
+    pthread_mutex_lock(&gpio_lock);
+    after = gpio_hal_port_level(&gpio_port[port]);
+    changed = before ^ after;
+#if defined(CONFIG_GPIO_IRQ)
+    for (uint32_t i = 0; i < 16U; i++) {
+        line = &gpio_exti_line[(port * 16U) + i];
+        if (!(changed & (1U << i)) || (line->trigger == 0)) {
+            continue;
+        }
+
+        level = (after >> i) & 1U;
+        if (line->trigger & (level ? GPIO_TRIGGER_RISING : GPIO_TRIGGER_FALLING)) {
+            line->pending = 1;
+            line->level = (uint8_t)level;
+            line->timestamp = timestamp;
+            pend = 1;
+        }
+    }
+#endif /* CONFIG_GPIO_IRQ */
+    pthread_mutex_unlock(&gpio_lock);
+
+#if defined(CONFIG_GPIO_IRQ)
+    if (pend) {
+        irq_hal_set_pending(EXTI_IRQn);
+    }
+#endif /* CONFIG_GPIO_IRQ */
+
+    while (changed != 0) {
+        gpio_num = (port * 16U) + (31U - __CLZ(changed));
+        changed &= (uint16_t)~GET_GPIO_PIN(gpio_num);
+        level = (after >> PIN_NUM(gpio_num)) & 1U;
+
+        pthread_mutex_lock(&gpio_lock);
+        watch = gpio_watch[gpio_num];
+        pthread_mutex_unlock(&gpio_lock);
+
+        if (watch.watch != NULL) {
+            watch.watch(watch.context, gpio_num, level);
+        }
+    }
+}
@@ -0,0 +1,160 @@
+/**
+  * @file    gpio_hal.h
+  * @author  LuckkMaker
+  * @brief   Header for gpio_hal.c file
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef OMNI_HAL_GPIO_H
+#define OMNI_HAL_GPIO_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "include/device.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * GPIO ports of the host target are an in-memory pin table. Outputs are
+ * written by the driver, inputs are driven from outside with
+ * gpio_hal_inject(), an undriven input reads its pull level. Device models
+ * follow pins with gpio_hal_watch(), for example a chip select.
+ */
+
+/**
+ * @brief GPIO port index used by GET_PIN()
+ */
+enum {
+    GPIO_HAL_PORT_A = 0,
+    GPIO_HAL_PORT_B,
+    GPIO_HAL_PORT_C,
+    GPIO_HAL_PORT_D,
+    GPIO_HAL_PORT_E,
+    GPIO_HAL_PORT_F,
+    GPIO_HAL_PORT_G,
+    GPIO_HAL_PORT_H,
+    GPIO_HAL_PORT_I,
+    GPIO_HAL_PORT_J,
+    GPIO_HAL_PORT_K,
+};
+
+#define GET_PIN(PORT, PIN)  ((16 * GPIO_HAL_PORT_##PORT) + PIN)
+#define GET_PORT(PORT)      GET_PIN(PORT, 0)
+
+/**
+ * @brief Callback of a watched pin, called on every level change
+ */
+typedef void (*gpio_hal_watch_t)(void *context, uint32_t gpio_num, uint32_t level);
+
+void gpio_hal_write_port(uint32_t gpio_num, uint16_t set_mask, uint16_t clear_mask);
+void gpio_hal_toggle_port(uint32_t gpio_num, uint16_t mask);
+uint16_t gpio_hal_read_port(uint32_t gpio_num);
+int gpio_hal_inject(uint32_t gpio_num, uint32_t level);
+int gpio_hal_watch(uint32_t gpio_num, gpio_hal_watch_t watch, void *context);
+
+/**
+ * GPIO fast access
+ *
+ * Same interface as on the devices, each call is one locked update of the
+ * pin table so that watches and edge interrupts see every change.
+ */
+
+/**
+ * @brief Set GPIO pin high
+ *
+ * @param gpio_num GPIO number
+ */
+static inline void gpio_hal_fast_set(uint32_t gpio_num) {
+    gpio_hal_write_port(gpio_num, (uint16_t)(1U << (gpio_num & 0xFU)), 0);
+}
+
+/**
+ * @brief Set GPIO pin low
+ *
+ * @param gpio_num GPIO number
+ */
+static inline void gpio_hal_fast_reset(uint32_t gpio_num) {
+    gpio_hal_write_port(gpio_num, 0, (uint16_t)(1U << (gpio_num & 0xFU)));
+}
+
+/**
+ * @brief Write GPIO pin level
+ *
+ * @param gpio_num GPIO number
+ * @param level GPIO level
+ */
+static inline void gpio_hal_fast_write(uint32_t gpio_num, uint32_t level) {
+    if (level) {
+        gpio_hal_fast_set(gpio_num);
+    } else {
+        gpio_hal_fast_reset(gpio_num);
+    }
+}
+
+/**
+ * @brief Read GPIO pin level
+ *
+ * @param gpio_num GPIO number
+ * @return GPIO level
+ */
+static inline uint32_t gpio_hal_fast_read(uint32_t gpio_num) {
+    return (gpio_hal_read_port(gpio_num) >> (gpio_num & 0xFU)) & 1U;
+}
+
+/**
+ * @brief Toggle GPIO pin level
+ *
+ * @param gpio_num GPIO number
+ */
+static inline void gpio_hal_fast_toggle(uint32_t gpio_num) {
+    gpio_hal_toggle_port(gpio_num, (uint16_t)(1U << (gpio_num & 0xFU)));
+}
+
+/**
+ * @brief Set and clear several pins of a port at once
+ *
+ * @note Pins in both masks are set.
+ * @param port GPIO number of the port, see GET_PORT()
+ * @param set_mask Pins to drive high
+ * @param clear_mask Pins to drive low
+ */
+static inline void gpio_hal_write_mask(uint32_t port, uint16_t set_mask, uint16_t clear_mask) {
+    gpio_hal_write_port(port, set_mask, (uint16_t)(clear_mask & ~set_mask));
+}
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#ifdef __cplusplus
+/**
+ * @brief GPIO fast access for a pin fixed at compile time
+ */
+template <uint32_t gpio_num>
+struct gpio_hal_pin {
+    static inline void set(void) { gpio_hal_fast_set(gpio_num); }
+    static inline void reset(void) { gpio_hal_fast_reset(gpio_num); }
+    static inline void write(uint32_t level) { gpio_hal_fast_write(gpio_num, level); }
+    static inline uint32_t read(void) { return gpio_hal_fast_read(gpio_num); }
+    static inline void toggle(void) { gpio_hal_fast_toggle(gpio_num); }
+};
+#endif /* __cplusplus */
+
+#endif /* OMNI_HAL_GPIO_H */
@@ -0,0 +1,747 @@
+/**
+  * @file    i2c_hal.c
+  * @author  LuckkMaker
+  * @brief   I2C HAL driver
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <pthread.h>
+#include "drivers/i2c.h"
+#include "hal/i2c_hal.h"
+#include "hal/irq_hal.h"
+#include "hal/clock_hal.h"
+#include "trace/trace.h"
+#include "ll/i2c_ll.h"
+
+#define I2C_EVENT_NACK  (I2C_EVENT_TRANSFER_COMPLETE | I2C_EVENT_TRANSFER_INCOMPLETE)
+
+// START, address byte, ACK and STOP of an addressing attempt
+#define I2C_POLL_BITS   11U
+
+/**
+ * @brief Host side of an I2C bus
+ */
+typedef struct {
+    const i2c_hal_model_t *model[CONFIG_I2C_MODEL_NUM];
+    const i2c_hal_model_t *active;  /**< Model addressed in a sequence without STOP */
+    volatile uint32_t event;        /**< Event for the handler */
+    uint32_t bit_ns;                /**< SCL period in nanoseconds */
+} i2c_bus_t;
+
+static i2c_obj_t i2c_obj[I2C_NUM_MAX];
+static i2c_bus_t i2c_bus[I2C_NUM_MAX];
+static pthread_mutex_t i2c_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static int i2c_hal_init(i2c_num_t i2c_num, i2c_driver_config_t *config);
+static int i2c_hal_deinit(i2c_num_t i2c_num);
+static void i2c_hal_start(i2c_num_t i2c_num);
+static void i2c_hal_stop(i2c_num_t i2c_num);
+static int i2c_hal_master_transmit(i2c_num_t i2c_num, uint16_t addr, const uint8_t *data, uint32_t len, uint8_t pending);
+static int i2c_hal_master_receive(i2c_num_t i2c_num, uint16_t addr, uint8_t *data, uint32_t len, uint8_t pending);
+static int i2c_hal_slave_transmit(i2c_num_t i2c_num, const uint8_t *data, uint32_t len);
+static int i2c_hal_slave_receive(i2c_num_t i2c_num, uint8_t *data, uint32_t len);
+static int i2c_hal_write(i2c_num_t i2c_num, uint16_t dev_addr, uint16_t mem_addr, i2c_mem_addr_size_t mem_addr_size, const uint8_t *data, uint16_t len);
+static int i2c_hal_read(i2c_num_t i2c_num, uint16_t dev_addr, uint16_t mem_addr, i2c_mem_addr_size_t mem_addr_size, uint8_t *data, uint16_t len);
+static int i2c_hal_is_device_ready(i2c_num_t i2c_num, uint16_t dev_addr, uint32_t trials);
+static i2c_driver_status_t i2c_hal_get_status(i2c_num_t i2c_num);
+static i2c_driver_error_t i2c_hal_get_error(i2c_num_t i2c_num);
+
+const struct i2c_driver_api i2c_driver = {
+    .init = i2c_hal_init,
+    .deinit = i2c_hal_deinit,
+    .start = i2c_hal_start,
+    .stop = i2c_hal_stop,
+    .master_transmit = i2c_hal_master_transmit,
+    .master_receive = i2c_hal_master_receive,
+    .slave_transmit = i2c_hal_slave_transmit,
+    .slave_receive = i2c_hal_slave_receive,
+    .write = i2c_hal_write,
+    .read = i2c_hal_read,
+    .is_device_ready = i2c_hal_is_device_ready,
+    .get_status = i2c_hal_get_status,
+    .get_error = i2c_hal_get_error,
+};
+
+static void i2c_hal_irq_register(i2c_num_t i2c_num);
+static int i2c_hal_begin(i2c_num_t i2c_num, uint16_t addr, uint32_t len);
+static void i2c_hal_end(i2c_num_t i2c_num, uint32_t event);
+static const i2c_hal_model_t *i2c_hal_bus_start(i2c_bus_t *bus, uint16_t addr, i2c_dir_t direction);
+static void i2c_hal_bus_stop(i2c_bus_t *bus);
+static uint32_t i2c_hal_bit_ns(i2c_bus_speed_t bus_speed);
+
+/**
+ * @brief Open I2C bus
+ * 
+ * @param i2c_num I2C number
+ * @param config Pointer to the I2C driver configuration
+ * @return Operation status
+ */
+static int i2c_hal_init(i2c_num_t i2c_num, i2c_driver_config_t *config) {
+    omni_assert(i2c_num < I2C_NUM_MAX);
+    omni_assert_not_null(config);
+
+    i2c_obj_t *obj = &i2c_obj[i2c_num];
+
+    // Set event callback
+    if (config->event_cb != NULL) {
+        obj->event_cb = config->event_cb;
+    } else {
+        obj->event_cb = NULL;
+    }
+
+    // Get dev information
+    obj->dev = i2c_ll_get_dev(i2c_num);
+    omni_assert_not_null(obj->dev);
+
+    // Clear status
+    obj->status = (i2c_driver_status_t){0};
+
+    // Clear error
+    obj->error = (i2c_driver_error_t){0};
+
+    obj->mode = config->mode;
+    obj->flags = (i2c_driver_flags_t){0};
+    i2c_bus[i2c_num].active = NULL;
+    i2c_bus[i2c_num].event = 0;
+    i2c_bus[i2c_num].bit_ns = i2c_hal_bit_ns(config->bus_speed);
+
+    // Register IRQ
+    i2c_hal_irq_register(i2c_num);
+
+    // Initialize IRQ
+    irq_hal_clear_pending(obj->dev->irq_num);
+    irq_hal_set_priority(obj->dev->irq_num, obj->dev->irq_prio, 0);
+    irq_hal_enable(obj->dev->irq_num);
+
+    // Set initialized status
+    obj->status.is_initialized = 1;
+    // Call event callback
+    if (obj->event_cb != NULL) {
+        // Set initialized event
+        obj->event_cb(I2C_EVENT_INITIALIZED);
+    }
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Close I2C bus
+ * 
+ * @note Attached models stay attached.
+ * @param i2c_num I2C number
+ * @return Operation status
+ */
+static int i2c_hal_deinit(i2c_num_t i2c_num) {
+    omni_assert(i2c_num < I2C_NUM_MAX);
+
+    i2c_obj_t *obj = &i2c_obj[i2c_num];
+    omni_assert_not_null(obj);
+
+    // Disable I2C IRQ
+    if (obj->dev != NULL) {
+        irq_hal_disable(obj->dev->irq_num);
+    }
+
+    i2c_hal_bus_stop(&i2c_bus[i2c_num]);
+
+    i2c_obj[i2c_num] = (i2c_obj_t){0};
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Start I2C bus
+ * 
+ * @param i2c_num I2C number
+ */
+static void i2c_hal_start(i2c_num_t i2c_num) {
+    omni_assert(i2c_num < I2C_NUM_MAX);
+}
+
+/**
+ * @brief Stop I2C bus
+ * 
+ * @param i2c_num I2C number
+ */
+static void i2c_hal_stop(i2c_num_t i2c_num) {
+    omni_assert(i2c_num < I2C_NUM_MAX);
+}
+
+/**
+ * @brief I2C master transmit
+ * 
+ * @param i2c_num I2C number
+ * @param addr Slave address
+ * @param data Pointer to data buffer
+ * @param len Data length
+ * @param pending Pending flag, no STOP at the end if set
+ * @return Operation status
+ */
+static int i2c_hal_master_transmit(i2c_num_t i2c_num, uint16_t addr, const uint8_t *data, uint32_t len, uint8_t pending) {
+    const i2c_hal_model_t *model;
+    uint32_t event = I2C_EVENT_TRANSFER_COMPLETE;
+    int ret;
+    omni_assert(i2c_num < I2C_NUM_MAX);
+    omni_assert_not_null(data);
+    omni_assert_non_zero(len);
+
+    i2c_obj_t *obj = &i2c_obj[i2c_num];
+    i2c_bus_t *bus = &i2c_bus[i2c_num];
+
+    ret = i2c_hal_begin(i2c_num, addr, len);
+    if (ret != OMNI_OK) {
+        return ret;
+    }
+
+    obj->direction = I2C_DIR_TRANSMITTER;
+    obj->data.buffer = (uint8_t *)data;
+    obj->data.num = len;
+    obj->data.count = 0;
+
+    model = i2c_hal_bus_start(bus, addr, I2C_DIR_TRANSMITTER);
+    if (model == NULL) {
+        event = I2C_EVENT_NACK | I2C_EVENT_ADDRESS_NACK;
+        pending = 0;
+    } else {
+        obj->data.count = model->write(model->context, data, len);
+        if (obj->data.count < len) {
+            event = I2C_EVENT_NACK;
+            pending = 0;
+        }
+    }
+
+    // Keep the device addressed for a repeated start
+    obj->flags.no_stop = pending ? 1U : 0U;
+    if (!pending) {
+        i2c_hal_bus_stop(bus);
+    }
+
+    i2c_hal_end(i2c_num, event);
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief I2C master receive
+ * 
+ * @param i2c_num I2C number
+ * @param addr Slave address
+ * @param data Pointer to data buffer
+ * @param len Data length
+ * @param pending Pending flag, no STOP at the end if set
+ * @return Operation status
+ */
+static int i2c_hal_master_receive(i2c_num_t i2c_num, uint16_t addr, uint8_t *data, uint32_t len, uint8_t pending) {
+    const i2c_hal_model_t *model;
+    uint32_t event = I2C_EVENT_TRANSFER_COMPLETE;
+    int ret;
+    omni_assert(i2c_num < I2C_NUM_MAX);
+    omni_assert_not_null(data);
+    omni_assert_non_zero(len);
+
+    i2c_obj_t *obj = &i2c_obj[i2c_num];
+    i2c_bus_t *bus = &i2c_bus[i2c_num];
+
+    ret = i2c_hal_begin(i2c_num, addr, len);
+    if (ret != OMNI_OK) {
+        return ret;
+    }
+
+    obj->direction = I2C_DIR_RECEIVER;
+    obj->data.buffer = data;
+    obj->data.num = len;
+    obj->data.count = 0;
+
+    model = i2c_hal_bus_start(bus, addr, I2C_DIR_RECEIVER);
+    if (model == NULL) {
+        event = I2C_EVENT_NACK | I2C_EVENT_ADDRESS_NACK;
+        pending = 0;
+    } else {
+        model->read(model->context, data, len);
+        obj->data.count = len;
+    }
+
+    obj->flags.no_stop = pending ? 1U : 0U;
+    if (!pending) {
+        i2c_hal_bus_stop(bus);
+    }
+
+    i2c_hal_end(i2c_num, event);
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief I2C slave transmit
+ * 
+ * @note Slave mode is not emulated on the host.
+ * @param i2c_num I2C number
+ * @param data Pointer to data buffer
+ * @param len Data length
+ * @return Operation status
+ */
+static int i2c_hal_slave_transmit(i2c_num_t i2c_num, const uint8_t *data, uint32_t len) {
+    omni_assert(i2c_num < I2C_NUM_MAX);
+
+    UNUSED(data);
+    UNUSED(len);
+
+    return OMNI_FAIL;
+}
+
+/**
+ * @brief I2C slave receive
+ * 
+ * @note Slave mode is not emulated on the host.
+ * @param i2c_num I2C number
+ * @param data Pointer to data buffer
+ * @param len Data length
+ * @return Operation status
+ */
+static int i2c_hal_slave_receive(i2c_num_t i2c_num, uint8_t *data, uint32_t len) {
+    omni_assert(i2c_num < I2C_NUM_MAX);
+
+    UNUSED(data);
+    UNUSED(len);
+
+    return OMNI_FAIL;
+}
+
+/**
+ * @brief I2C write memory
+ * 
+ * @param i2c_num I2C number
+ * @param dev_addr Device address
+ * @param mem_addr Memory address
+ * @param mem_addr_size Memory address size
+ * @param data Pointer to data buffer
+ * @param len Data length
+ * @return Operation status
+ */
+static int i2c_hal_write(i2c_num_t i2c_num, uint16_t dev_addr, uint16_t mem_addr, i2c_mem_addr_size_t mem_addr_size, const uint8_t *data, uint16_t len) {
+    const i2c_hal_model_t *model;
+    uint8_t addr[2] = {(uint8_t)(mem_addr >> 8), (uint8_t)mem_addr};
+    uint32_t addr_len = (mem_addr_size == I2C_MEM_ADDR_SIZE_8) ? 1U : 2U;
+    uint32_t event = I2C_EVENT_TRANSFER_COMPLETE;
+    int ret;
+    omni_assert(i2c_num < I2C_NUM_MAX);
+    omni_assert_not_null(data);
+    omni_assert_non_zero(len);
+
+    i2c_obj_t *obj = &i2c_obj[i2c_num];
+    i2c_bus_t *bus = &i2c_bus[i2c_num];
+
+    ret = i2c_hal_begin(i2c_num, dev_addr, len);
+    if (ret != OMNI_OK) {
+        return ret;
+    }
+
+    obj->direction = I2C_DIR_TRANSMITTER;
+    obj->data.count = 0;
+
+    model = i2c_hal_bus_start(bus, dev_addr, I2C_DIR_TRANSMITTER);
+    if (model == NULL) {
+        event = I2C_EVENT_NACK | I2C_EVENT_ADDRESS_NACK;
+    } else if (model->write(model->context, &addr[2U - addr_len], addr_len) < addr_len) {
+        event = I2C_EVENT_NACK;
+    } else {
+        obj->data.count = model->write(model->context, data, len);
+        if (obj->data.count < len) {
+            event = I2C_EVENT_NACK;
+        }
+    }
+
+    i2c_hal_bus_stop(bus);
+    i2c_hal_end(i2c_num, event);
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief I2C read memory
+ * 
+ * @param i2c_num I2C number
+ * @param dev_addr Device address
+ * @param mem_addr Memory address
+ * @param mem_addr_size Memory address size
+ * @param data Pointer to data buffer
+ * @param len Data length
+ * @return Operation status
+ */
+static int i2c_hal_read(i2c_num_t i2c_num, uint16_t dev_addr, uint16_t mem_addr, i2c_mem_addr_size_t mem_addr_size, uint8_t *data, uint16_t len) {
+    const i2c_hal_model_t *model;
+    uint8_t addr[2] = {(uint8_t)(mem_addr >> 8), (uint8_t)mem_addr};
+    uint32_t addr_len = (mem_addr_size == I2C_MEM_ADDR_SIZE_8) ? 1U : 2U;
+    uint32_t event = I2C_EVENT_TRANSFER_COMPLETE;
+    int ret;
+    omni_assert(i2c_num < I2C_NUM_MAX);
+    omni_assert_not_null(data);
+    omni_assert_non_zero(len);
+
+    i2c_obj_t *obj = &i2c_obj[i2c_num];
+    i2c_bus_t *bus = &i2c_bus[i2c_num];
+
+    ret = i2c_hal_begin(i2c_num, dev_addr, len);
+    if (ret != OMNI_OK) {
+        return ret;
+    }
+
+    obj->direction = I2C_DIR_RECEIVER;
+    obj->data.count = 0;
+
+    model = i2c_hal_bus_start(bus, dev_addr, I2C_DIR_TRANSMITTER);
+    if (model == NULL) {
+        event = I2C_EVENT_NACK | I2C_EVENT_ADDRESS_NACK;
+    } else if (model->write(model->context, &addr[2U - addr_len], addr_len) < addr_len) {
+        event = I2C_EVENT_NACK;
+    } else if (i2c_hal_bus_start(bus, dev_addr, I2C_DIR_RECEIVER) == NULL) {
+        // Repeated start refused
+        event = I2C_EVENT_NACK | I2C_EVENT_ADDRESS_NACK;
+    } else {
+        model->read(model->context, data, len);
+        obj->data.count = len;
+    }
+
+    i2c_hal_bus_stop(bus);
+    i2c_hal_end(i2c_num, event);
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief I2C check device ready
+ * 
+ * @param i2c_num I2C number
+ * @param dev_addr Device address
+ * @param trials Number of trials
+ * @return Operation status
+ */
+static int i2c_hal_is_device_ready(i2c_num_t i2c_num, uint16_t dev_addr, uint32_t trials) {
+    int ret = OMNI_FAIL;
+    omni_assert(i2c_num < I2C_NUM_MAX);
+
+    i2c_obj_t *obj = &i2c_obj[i2c_num];
+    i2c_bus_t *bus = &i2c_bus[i2c_num];
+    omni_assert_not_null(obj);
+
+    if ((dev_addr & ~((uint32_t)I2C_ADDR_10_BITS_FLAG | (uint32_t)I2C_ADDR_GENERAL_CALL_FLAG)) > 0x3FFU) {
+        return OMNI_FAIL;
+    }
+
+    if (obj->status.busy) {
+        return OMNI_BUSY;
+    }
+
+    obj->status.busy = 1;
+
+    for (uint32_t i = 0; (i < trials) && (ret != OMNI_OK); i++) {
+        if (i2c_hal_bus_start(bus, dev_addr, I2C_DIR_TRANSMITTER) != NULL) {
+            ret = OMNI_OK;
+        } else {
+            // A refused attempt still occupies the bus, models time out against it
+            clock_hal_sleep_ns((uint64_t)bus->bit_ns * I2C_POLL_BITS);
+        }
+        i2c_hal_bus_stop(bus);
+    }
+
+    obj->status.busy = 0;
+
+    return ret;
+}
+
+/**
+ * @brief I2C get status
+ *
+ * @param i2c_num I2C number
+ * @return I2C driver status
+ */
+static i2c_driver_status_t i2c_hal_get_status(i2c_num_t i2c_num) {
+    omni_assert(i2c_num < I2C_NUM_MAX);
+
+    i2c_obj_t *obj = &i2c_obj[i2c_num];
+    omni_assert_not_null(obj);
+
+    return obj->status;
+}
+
+/**
+ * @brief I2C get error
+ *
+ * @param i2c_num I2C number
+ * @return I2C driver error
+ */
+static i2c_driver_error_t i2c_hal_get_error(i2c_num_t i2c_num) {
+    omni_assert(i2c_num < I2C_NUM_MAX);
+
+    i2c_obj_t *obj = &i2c_obj[i2c_num];
+    omni_assert_not_null(obj);
+
+    return obj->error;
+}
+
+/********************* HAL functions **********************/
+
+/**
+ * @brief Attach a device model to an I2C bus
+ * 
+ * @note The model must stay valid until it is detached.
+ * @param i2c_num I2C number
+ * @param model Pointer to device model
+ * @return Operation status
+ */
+int i2c_hal_attach(i2c_num_t i2c_num, const i2c_hal_model_t *model) {
+    i2c_bus_t *bus;
+    int ret = OMNI_BUSY;
+
+    if ((i2c_num >= I2C_NUM_MAX) || (model == NULL) || (model->write == NULL) || (model->read == NULL)) {
+        return OMNI_FAIL;
+    }
+
+    bus = &i2c_bus[i2c_num];
+
+    pthread_mutex_lock(&i2c_lock);
+    for (uint32_t i = 0; i < CONFIG_I2C_MODEL_NUM; i++) {
+        if ((bus->model[i] != NULL) && (bus->model[i]->addr == model->addr)) {
+            // Address already taken
+            ret = OMNI_FAIL;
+            break;
+        }
+    }
+
+    for (uint32_t i = 0; (i < CONFIG_I2C_MODEL_NUM) && (ret == OMNI_BUSY); i++) {
+        if (bus->model[i] == NULL) {
+            bus->model[i] = model;
+            ret = OMNI_OK;
+        }
+    }
+    pthread_mutex_unlock(&i2c_lock);
+
+    return ret;
+}
+
+/**
+ * @brief Detach a device model from an I2C bus
+ * 
+ * @param i2c_num I2C number
+ * @param model Pointer to device model
+ * @return Operation status
+ */
+int i2c_hal_detach(i2c_num_t i2c_num, const i2c_hal_model_t *model) {
+    i2c_bus_t *bus;
+    int ret = OMNI_FAIL;
+
+    if ((i2c_num >= I2C_NUM_MAX) || (model == NULL)) {
+        return OMNI_FAIL;
+    }
+
+    bus = &i2c_bus[i2c_num];
+
+    pthread_mutex_lock(&i2c_lock);
+    for (uint32_t i = 0; i < CONFIG_I2C_MODEL_NUM; i++) {
+        if (bus->model[i] == model) {
+            bus->model[i] = NULL;
+            ret = OMNI_OK;
+            break;
+        }
+    }
+
+    if (bus->active == model) {
+        bus->active = NULL;
+    }
+    pthread_mutex_unlock(&i2c_lock);
+
+    return ret;
+}
+
+/********************* IRQ handlers **********************/
+
+/**
+ * @brief I2C IRQ handler, reports the completed transfer
+ * 
+ * @param obj Pointer to I2C object
+ */
+static void i2c_hal_irq_request(i2c_obj_t *obj) {
+    uint32_t event;
+    omni_assert_not_null(obj);
+
+    i2c_bus_t *bus = &i2c_bus[obj - i2c_obj];
+
+    if (!obj->status.busy) {
+        return;
+    }
+
+    event = bus->event;
+    bus->event = 0;
+
+    obj->status.busy = 0U;
+    if (event & I2C_EVENT_TRANSFER_INCOMPLETE) {
+        TRACE_RECORD(TRACE_EVENT_DRV_ERROR, TRACE_DRV_I2C | (uint32_t)(obj - i2c_obj), 0);
+    } else {
+        TRACE_RECORD(TRACE_EVENT_DRV_COMPLETE, TRACE_DRV_I2C | (uint32_t)(obj - i2c_obj), 0);
+    }
+
+    if (obj->event_cb != NULL) {
+        obj->event_cb(event);
+    }
+}
+
+#if (CONFIG_I2C_NUM_1 == 1)
+/**
+ * @brief I2C1 IRQ handler
+ */
+static void i2c1_irq_handler(void) {
+    i2c_hal_irq_request(&i2c_obj[I2C_NUM_1]);
+}
+#endif /* (CONFIG_I2C_NUM_1 == 1) */
+
+#if (CONFIG_I2C_NUM_2 == 1)
+/**
+ * @brief I2C2 IRQ handler
+ */
+static void i2c2_irq_handler(void) {
+    i2c_hal_irq_request(&i2c_obj[I2C_NUM_2]);
+}
+#endif /* (CONFIG_I2C_NUM_2 == 1) */
+
+/**
+ * @brief Register I2C IRQ
+ * 
+ * @param i2c_num I2C number
+ */
+static void i2c_hal_irq_register(i2c_num_t i2c_num) {
+    switch (i2c_num) {
+#if (CONFIG_I2C_NUM_1 == 1)
+        case I2C_NUM_1:
+            irq_hal_register_handler(i2c_obj[I2C_NUM_1].dev->irq_num, i2c1_irq_handler);
+            break;
+#endif /* (CONFIG_I2C_NUM_1 == 1) */
+#if (CONFIG_I2C_NUM_2 == 1)
+        case I2C_NUM_2:
+            irq_hal_register_handler(i2c_obj[I2C_NUM_2].dev->irq_num, i2c2_irq_handler);
+            break;
+#endif /* (CONFIG_I2C_NUM_2 == 1) */
+        default:
+            break;
+    }
+}
+
+/********************* Private functions **********************/
+
+/**
+ * @brief Check the address and mark the bus busy
+ * 
+ * @param i2c_num I2C number
+ * @param addr Slave address
+ * @param len Data length
+ * @return Operation status
+ */
+static int i2c_hal_begin(i2c_num_t i2c_num, uint16_t addr, uint32_t len) {
+    i2c_obj_t *obj = &i2c_obj[i2c_num];
+    omni_assert_not_null(obj);
+
+    if ((addr & ~((uint32_t)I2C_ADDR_10_BITS_FLAG | (uint32_t)I2C_ADDR_GENERAL_CALL_FLAG)) > 0x3FFU) {
+        return OMNI_FAIL;
+    }
+
+    if (obj->status.busy) {
+        return OMNI_BUSY;
+    }
+
+    obj->status.busy = 1;
+    obj->xfer_mode = I2C_XFER_MODE_MASTER;
+    obj->device_addr = addr;
+    TRACE_RECORD(TRACE_EVENT_DRV_START, TRACE_DRV_I2C | i2c_num, len);
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Report the end of a transfer from the I2C interrupt
+ * 
+ * @param i2c_num I2C number
+ * @param event Event to report
+ */
+static void i2c_hal_end(i2c_num_t i2c_num, uint32_t event) {
+    i2c_bus[i2c_num].event = event;
+    irq_hal_set_pending(i2c_obj[i2c_num].dev->irq_num);
+}
+
+/**
+ * @brief Address a model with a start or repeated start
+ * 
+ * @param bus Pointer to host bus
+ * @param addr Slave address
+ * @param direction Transfer direction
+ * @return Addressed model, NULL if the address was not acknowledged
+ */
+static const i2c_hal_model_t *i2c_hal_bus_start(i2c_bus_t *bus, uint16_t addr, i2c_dir_t direction) {
+    const i2c_hal_model_t *model = NULL;
+
+    pthread_mutex_lock(&i2c_lock);
+    for (uint32_t i = 0; i < CONFIG_I2C_MODEL_NUM; i++) {
+        if ((bus->model[i] != NULL) && (bus->model[i]->addr == (addr & 0x3FFU))) {
+            model = bus->model[i];
+            break;
+        }
+    }
+    pthread_mutex_unlock(&i2c_lock);
+
+    if ((model != NULL) && (model->start != NULL) && !model->start(model->context, direction)) {
+        model = NULL;
+    }
+
+    bus->active = model;
+
+    return model;
+}
+
+/**
+ * @brief Send a STOP to the addressed model
+ * 
+ * @param bus Pointer to host bus
+ */
+static void i2c_hal_bus_stop(i2c_bus_t *bus) {
+    const i2c_hal_model_t *model = bus->active;
+
+    bus->active = NULL;
+
+    if ((model != NULL) && (model->stop != NULL)) {
+        model->stop(model->context);
+    }
+}
+
+/**
+ * @brief Get SCL period of a bus speed
+ * 
+ * @param bus_speed Bus speed
+ * @return SCL period in nanoseconds
+ */
+static uint32_t i2c_hal_bit_ns(i2c_bus_speed_t bus_speed) {
+    switch (bus_speed) {
+        case I2C_BUS_SPEED_FAST:
+            return 2500U;
+        case I2C_BUS_SPEED_FAST_PLUS:
+            return 1000U;
+        case I2C_BUS_SPEED_HIGH:
+            return 295U;
+        case I2C_BUS_SPEED_STANDARD:
+        default:
+            return 10000U;
+    }
+}
@@ -0,0 +1,74 @@
+/**
+  * @file    i2c_hal.h
+  * @author  LuckkMaker
+  * @brief   Header for i2c_hal.c file
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef OMNI_HAL_I2C_H
+#define OMNI_HAL_I2C_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "drivers/i2c_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * I2C buses of the host target serve master transfers from device models.
+ * A transfer to an address without a model, or to a model whose start
+ * callback refuses the address, ends with I2C_EVENT_ADDRESS_NACK. Slave
+ * mode is not emulated.
+ */
+
+/**
+ * @brief I2C device model
+ */
+typedef struct i2c_hal_model {
+    void *context;                  /**< Passed to the callbacks */
+    uint16_t addr;                  /**< Device address, 7 or 10 bits */
+    /**
+     * @brief Start or repeated start addressing the model, optional
+     * @return False to NACK the address
+     */
+    bool (*start)(void *context, i2c_dir_t direction);
+    /**
+     * @brief Bytes written by the master
+     * @return Number of bytes acknowledged
+     */
+    uint32_t (*write)(void *context, const uint8_t *data, uint32_t len);
+    /**
+     * @brief Bytes read by the master
+     */
+    void (*read)(void *context, uint8_t *data, uint32_t len);
+    /**
+     * @brief Stop condition, optional
+     */
+    void (*stop)(void *context);
+} i2c_hal_model_t;
+
+int i2c_hal_attach(i2c_num_t i2c_num, const i2c_hal_model_t *model);
+int i2c_hal_detach(i2c_num_t i2c_num, const i2c_hal_model_t *model);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* OMNI_HAL_I2C_H */
@@ -0,0 +1,608 @@
+/**
+  * @file    irq_hal.c
+  * @author  LuckkMaker
+  * @brief   IRQ HAL driver
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <pthread.h>
+#include <stdlib.h>
+#include <time.h>
+#include "hal/irq_hal.h"
+#include "hal/clock_hal.h"
+#if defined(CONFIG_TRACE_IRQ)
+#include "trace/trace.h"
+#endif /* CONFIG_TRACE_IRQ */
+
+// Exception numbers start after the 16 system exceptions as on the core
+#define IRQ_EXCEPTION_BASE  16U
+#define IRQ_VECTOR_NUM      ((uint32_t)IRQn_MAX)
+#define IRQ_PRIORITY_MAX    15U
+
+typedef void(*irq_vector_table_t)(void);
+
+static irq_vector_table_t irq_vector_table[IRQ_VECTOR_NUM];
+static uint8_t irq_priority[IRQ_VECTOR_NUM];
+static irq_priority_grouping_t irq_priority_grouping = IRQ_PRIORITY_GROUP_4;
+static uint32_t irq_enabled = 0;
+static uint32_t irq_pending = 0;
+static volatile uint32_t irq_active = 0;
+static uint32_t irq_dispatched = 0;
+
+// Held by a thread with interrupts disabled and by the running handler
+static pthread_mutex_t irq_cpu_lock = PTHREAD_MUTEX_INITIALIZER;
+// Protects the enable and pending state
+static pthread_mutex_t irq_state_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t irq_state_cond;
+static pthread_once_t irq_once = PTHREAD_ONCE_INIT;
+static pthread_t irq_thread;
+
+static __thread uint32_t irq_primask = 0;
+static __thread uint32_t irq_ipsr = 0;
+
+#if defined(CONFIG_IRQ_STATS)
+static irq_stats_t irq_stats[IRQ_VECTOR_NUM];
+static uint32_t irq_stats_pend_time[IRQ_VECTOR_NUM];
+static uint32_t irq_stats_start = 0;
+static volatile uint32_t irq_stats_cycles = 0;
+#endif /* CONFIG_IRQ_STATS */
+
+static void irq_hal_start(void);
+static void *irq_hal_dispatch(void *argument);
+static int irq_hal_is_valid(int irq);
+
+/**
+ * @brief Register an interrupt handler
+ * 
+ * @param irq Interrupt number
+ * @param handler Pointer to the interrupt handler
+ */
+void irq_hal_register_handler(int irq, void (*handler)(void)) {
+    if (!irq_hal_is_valid(irq)) {
+        return;
+    }
+
+    pthread_once(&irq_once, irq_hal_start);
+
+    pthread_mutex_lock(&irq_state_lock);
+    irq_vector_table[irq] = handler;
+    pthread_mutex_unlock(&irq_state_lock);
+}
+
+/**
+ * @brief Unregister an interrupt handler
+ * 
+ * @param irq Interrupt number
+ */
+void irq_hal_unregister_handler(int irq) {
+    if (!irq_hal_is_valid(irq)) {
+        return;
+    }
+
+    pthread_mutex_lock(&irq_state_lock);
+    irq_vector_table[irq] = NULL;
+    pthread_mutex_unlock(&irq_state_lock);
+}
+
+/**
+ * @brief Set interrupt vector
+ * 
+ * @note Vectors are function pointers and do not fit in 32 bits on the
+ *       host, use irq_hal_register_handler() instead.
+ * @param irq Interrupt number
+ * @param vector Address of interrupt handler function
+ */
+void irq_hal_set_vector(int irq, uint32_t vector) {
+    UNUSED(irq);
+    UNUSED(vector);
+}
+
+/**
+ * @brief Get interrupt vector
+ * 
+ * @param irq Interrupt number
+ * @return Address of interrupt handler function, always 0 on the host
+ */
+uint32_t irq_hal_get_vector(int irq) {
+    UNUSED(irq);
+
+    return 0;
+}
+
+/**
+ * @brief Set interrupt priority grouping
+ * 
+ * @param priority_grouping Priority grouping
+ */
+void irq_hal_set_priority_grouping(irq_priority_grouping_t priority_grouping) {
+    irq_priority_grouping = priority_grouping;
+}
+
+/**
+ * @brief Get interrupt priority grouping
+ * 
+ * @return Priority grouping
+ */
+uint32_t irq_hal_get_priority_grouping(void) {
+    return (uint32_t)irq_priority_grouping;
+}
+
+/**
+ * @brief Enable interrupt
+ * 
+ * @param irq Interrupt number
+ */
+void irq_hal_enable(int irq) {
+    if (!irq_hal_is_valid(irq)) {
+        return;
+    }
+
+    pthread_once(&irq_once, irq_hal_start);
+
+    pthread_mutex_lock(&irq_state_lock);
+    irq_enabled |= (1U << irq);
+    pthread_cond_broadcast(&irq_state_cond);
+    pthread_mutex_unlock(&irq_state_lock);
+}
+
+/**
+ * @brief Get interrupt enable status
+ * 
+ * @param irq Interrupt number
+ * @return Enable status
+ */
+uint32_t irq_hal_get_enable(int irq) {
+    uint32_t enabled;
+
+    if (!irq_hal_is_valid(irq)) {
+        return 0;
+    }
+
+    pthread_mutex_lock(&irq_state_lock);
+    enabled = (irq_enabled >> irq) & 1U;
+    pthread_mutex_unlock(&irq_state_lock);
+
+    return enabled;
+}
+
+/**
+ * @brief Disable interrupt
+ * 
+ * @param irq Interrupt number
+ */
+void irq_hal_disable(int irq) {
+    if (!irq_hal_is_valid(irq)) {
+        return;
+    }
+
+    pthread_mutex_lock(&irq_state_lock);
+    irq_enabled &= ~(1U << irq);
+    pthread_mutex_unlock(&irq_state_lock);
+}
+
+/**
+ * @brief Set interrupt pending
+ * 
+ * @note Safe to call from any thread, this is how device emulation raises
+ *       interrupts.
+ * @param irq Interrupt number
+ */
+void irq_hal_set_pending(int irq) {
+    if (!irq_hal_is_valid(irq)) {
+        return;
+    }
+
+    pthread_once(&irq_once, irq_hal_start);
+
+    pthread_mutex_lock(&irq_state_lock);
+#if defined(CONFIG_IRQ_STATS)
+    if ((irq_pending & (1U << irq)) == 0) {
+        irq_stats_pend_time[irq] = clock_hal_get_cycles();
+    }
+#endif /* CONFIG_IRQ_STATS */
+    irq_pending |= (1U << irq);
+    pthread_cond_broadcast(&irq_state_cond);
+    pthread_mutex_unlock(&irq_state_lock);
+}
+
+/**
+ * @brief Get interrupt pending status
+ * 
+ * @param irq Interrupt number
+ * @return Pending status
+ */
+uint32_t irq_hal_get_pending(int irq) {
+    uint32_t pending;
+
+    if (!irq_hal_is_valid(irq)) {
+        return 0;
+    }
+
+    pthread_mutex_lock(&irq_state_lock);
+    pending = (irq_pending >> irq) & 1U;
+    pthread_mutex_unlock(&irq_state_lock);
+
+    return pending;
+}
+
+/**
+ * @brief Clear interrupt pending
+ * 
+ * @param irq Interrupt number
+ */
+void irq_hal_clear_pending(int irq) {
+    if (!irq_hal_is_valid(irq)) {
+        return;
+    }
+
+    pthread_mutex_lock(&irq_state_lock);
+    irq_pending &= ~(1U << irq);
+    pthread_mutex_unlock(&irq_state_lock);
+}
+
+/**
+ * @brief Set interrupt priority
+ * 
+ * @note Only the pre-emption priority orders pending interrupts.
+ * @param irq Interrupt number
+ * @param preemption_priority Preemption priority
+ * @param sub_priority Sub priority
+ */
+void irq_hal_set_priority(int irq, uint32_t preemption_priority, uint32_t sub_priority) {
+    UNUSED(sub_priority);
+
+    if (!irq_hal_is_valid(irq)) {
+        return;
+    }
+
+    pthread_mutex_lock(&irq_state_lock);
+    irq_priority[irq] = (uint8_t)MIN(preemption_priority, IRQ_PRIORITY_MAX);
+    pthread_mutex_unlock(&irq_state_lock);
+}
+
+/**
+ * @brief Get interrupt priority
+ * 
+ * @param irq Interrupt number
+ * @param preemption_priority Preemption priority
+ * @param sub_priority Sub priority
+ */
+void irq_hal_get_priority(int irq, uint32_t *preemption_priority, uint32_t *sub_priority) {
+    *preemption_priority = irq_hal_is_valid(irq) ? irq_priority[irq] : 0U;
+    *sub_priority = 0;
+}
+
+/**
+ * @brief Get active interrupt
+ * 
+ * @param irq Interrupt number
+ * @return Active interrupt
+ */
+uint32_t irq_hal_get_active(int irq) {
+    if (!irq_hal_is_valid(irq)) {
+        return 0;
+    }
+
+    return (irq_active >> irq) & 1U;
+}
+
+/**
+ * @brief System reset
+ * 
+ * @note Ends the process, the exit status tells a runner about the reset.
+ */
+void irq_hal_system_reset(void) {
+    exit(EXIT_FAILURE);
+}
+
+/**
+ * @brief Wait for an interrupt
+ * 
+ * @note With interrupts enabled the call returns after a handler has run,
+ *       with interrupts disabled it returns once an interrupt is pending,
+ *       like WFI.
+ * @param us Maximum number of microseconds to wait
+ * @return Number of microseconds waited
+ */
+uint32_t irq_hal_wait(uint32_t us) {
+    struct timespec deadline;
+    uint64_t start = clock_hal_get_ns();
+    uint64_t end = start + ((uint64_t)us * 1000U);
+    uint32_t dispatched;
+    int masked = (irq_primask != 0) || (irq_ipsr != 0);
+
+    pthread_once(&irq_once, irq_hal_start);
+
+    deadline.tv_sec = (time_t)(end / 1000000000U);
+    deadline.tv_nsec = (long)(end % 1000000000U);
+
+    pthread_mutex_lock(&irq_state_lock);
+    dispatched = irq_dispatched;
+    while (masked ? ((irq_pending & irq_enabled) == 0) : (irq_dispatched == dispatched)) {
+        if (pthread_cond_timedwait(&irq_state_cond, &irq_state_lock, &deadline) != 0) {
+            break;
+        }
+    }
+    pthread_mutex_unlock(&irq_state_lock);
+
+    return (uint32_t)((clock_hal_get_ns() - start) / 1000U);
+}
+
+#if defined(CONFIG_IRQ_STATS)
+/**
+ * @brief Get statistics of an interrupt
+ * 
+ * @param irq Interrupt number
+ * @param stats Pointer to statistics
+ * @return Operation status
+ */
+int irq_hal_stats_get(int irq, irq_stats_t *stats) {
+    uint32_t primask;
+
+    if (!irq_hal_is_valid(irq) || (stats == NULL)) {
+        return OMNI_FAIL;
+    }
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    *stats = irq_stats[irq];
+    __set_PRIMASK(primask);
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Get cycles spent in interrupt handlers
+ * 
+ * @note Free running counter in nanoseconds, the difference of two reads is
+ *       the handler time in between.
+ * @return Handler cycles
+ */
+uint32_t irq_hal_stats_cycles(void) {
+    return irq_stats_cycles;
+}
+
+/**
+ * @brief Reset statistics of all interrupts
+ */
+void irq_hal_stats_reset(void) {
+    uint32_t primask;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    for (uint32_t i = 0; i < IRQ_VECTOR_NUM; i++) {
+        irq_stats[i] = (irq_stats_t){0};
+    }
+    irq_stats_start = clock_hal_get_cycles();
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Dump statistics of all interrupts that have run
+ * 
+ * @note The load column is the share of time since the last reset, it is
+ *       only meaningful while the cycle counter has not wrapped.
+ * @param print Print function
+ */
+void irq_hal_stats_dump(int (*print)(const char *format, ...)) {
+    irq_stats_t stats;
+    uint32_t elapsed = clock_hal_get_cycles() - irq_stats_start;
+
+    print("%5s %10s %10s %10s %10s %5s %7s\r\n", "irq", "count", "mean", "max", "latency", "depth", "load");
+
+    for (int i = 0; i < (int)IRQ_VECTOR_NUM; i++) {
+        irq_hal_stats_get(i, &stats);
+        if (stats.count == 0) {
+            continue;
+        }
+
+        print("%5d %10lu %10lu %10lu %10lu %5lu %6lu%%\r\n", i, (unsigned long)stats.count, \
+            (unsigned long)(stats.total_cycles / stats.count), (unsigned long)stats.max_cycles, \
+            (unsigned long)stats.max_latency, (unsigned long)stats.max_depth, \
+            (unsigned long)((elapsed != 0) ? (stats.total_cycles * 100U / elapsed) : 0));
+    }
+}
+#endif /* CONFIG_IRQ_STATS */
+
+/********************* Intrinsics **********************/
+
+/**
+ * @brief Enable interrupts
+ */
+void __enable_irq(void) {
+    if ((irq_primask != 0) && (irq_ipsr == 0)) {
+        irq_primask = 0;
+        pthread_mutex_unlock(&irq_cpu_lock);
+    }
+    irq_primask = 0;
+}
+
+/**
+ * @brief Disable interrupts
+ * 
+ * @note A handler already owns the CPU, it only records the mask.
+ */
+void __disable_irq(void) {
+    if ((irq_primask == 0) && (irq_ipsr == 0)) {
+        pthread_mutex_lock(&irq_cpu_lock);
+    }
+    irq_primask = 1;
+}
+
+/**
+ * @brief Get interrupt mask of the calling thread
+ * 
+ * @return 1 if interrupts are disabled
+ */
+uint32_t __get_PRIMASK(void) {
+    return irq_primask;
+}
+
+/**
+ * @brief Set interrupt mask of the calling thread
+ * 
+ * @param primask 1 to disable interrupts
+ */
+void __set_PRIMASK(uint32_t primask) {
+    if (primask & 1U) {
+        __disable_irq();
+    } else {
+        __enable_irq();
+    }
+}
+
+/**
+ * @brief Get active exception number
+ * 
+ * @return Exception number in a handler, 0 in thread mode
+ */
+uint32_t __get_IPSR(void) {
+    return irq_ipsr;
+}
+
+/**
+ * @brief Wait for interrupt
+ */
+void __WFI(void) {
+    irq_hal_wait(UINT32_MAX);
+}
+
+/********************* Private functions **********************/
+
+/**
+ * @brief Start the dispatcher thread
+ */
+static void irq_hal_start(void) {
+    pthread_condattr_t attr;
+
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&irq_state_cond, &attr);
+    pthread_condattr_destroy(&attr);
+
+    if (pthread_create(&irq_thread, NULL, irq_hal_dispatch, NULL) != 0) {
+        abort();
+    }
+    pthread_detach(irq_thread);
+}
+
+/**
+ * @brief Dispatcher thread, runs pending handlers in priority order
+ * 
+ * @param argument Not used
+ * @return Never returns
+ */
+static void *irq_hal_dispatch(void *argument) {
+    irq_vector_table_t handler;
+    uint32_t ready;
+    int irq;
+#if defined(CONFIG_IRQ_STATS)
+    uint32_t start;
+    uint32_t cycles;
+    irq_stats_t *stats;
+#endif /* CONFIG_IRQ_STATS */
+
+    UNUSED(argument);
+
+    while (1) {
+        pthread_mutex_lock(&irq_state_lock);
+        while ((irq_pending & irq_enabled) == 0) {
+            pthread_cond_wait(&irq_state_cond, &irq_state_lock);
+        }
+        pthread_mutex_unlock(&irq_state_lock);
+
+        // Wait until no thread has interrupts disabled, the interrupt is
+        // chosen afterwards so all that pended while masked compete
+        pthread_mutex_lock(&irq_cpu_lock);
+
+        pthread_mutex_lock(&irq_state_lock);
+        ready = irq_pending & irq_enabled;
+        if (ready == 0) {
+            // Cleared or disabled while masked
+            pthread_mutex_unlock(&irq_state_lock);
+            pthread_mutex_unlock(&irq_cpu_lock);
+            continue;
+        }
+
+        // Lowest priority value first, lowest number on a tie
+        irq = -1;
+        for (int i = 0; i < (int)IRQ_VECTOR_NUM; i++) {
+            if ((ready & (1U << i)) && ((irq < 0) || (irq_priority[i] < irq_priority[irq]))) {
+                irq = i;
+            }
+        }
+        irq_pending &= ~(1U << irq);
+        handler = irq_vector_table[irq];
+        pthread_mutex_unlock(&irq_state_lock);
+
+        irq_active |= (1U << irq);
+        irq_ipsr = (uint32_t)irq + IRQ_EXCEPTION_BASE;
+
+#if defined(CONFIG_IRQ_STATS)
+        start = clock_hal_get_cycles();
+        stats = &irq_stats[irq];
+        if ((start - irq_stats_pend_time[irq]) > stats->max_latency) {
+            stats->max_latency = start - irq_stats_pend_time[irq];
+        }
+#endif /* CONFIG_IRQ_STATS */
+#if defined(CONFIG_TRACE_IRQ)
+        TRACE_RECORD(TRACE_EVENT_IRQ_ENTER, irq_ipsr, 0);
+#endif /* CONFIG_TRACE_IRQ */
+
+        if (handler != NULL) {
+            handler();
+        }
+
+#if defined(CONFIG_TRACE_IRQ)
+        TRACE_RECORD(TRACE_EVENT_IRQ_EXIT, irq_ipsr, 0);
+#endif /* CONFIG_TRACE_IRQ */
+#if defined(CONFIG_IRQ_STATS)
+        cycles = clock_hal_get_cycles() - start;
+        irq_stats_cycles += cycles;
+        stats->count++;
+        stats->total_cycles += cycles;
+        stats->max_depth = 1;
+        if (cycles > stats->max_cycles) {
+            stats->max_cycles = cycles;
+        }
+#endif /* CONFIG_IRQ_STATS */
+
+        irq_ipsr = 0;
+        irq_primask = 0;
+        irq_active &= ~(1U << irq);
+        pthread_mutex_unlock(&irq_cpu_lock);
+
+        pthread_mutex_lock(&irq_state_lock);
+        irq_dispatched++;
+        pthread_cond_broadcast(&irq_state_cond);
+        pthread_mutex_unlock(&irq_state_lock);
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Check an interrupt number
+ * 
+ * @param irq Interrupt number
+ * @return 1 if the number is valid
+ */
+static int irq_hal_is_valid(int irq) {
+    return (irq >= 0) && (irq < (int)IRQ_VECTOR_NUM);
+}
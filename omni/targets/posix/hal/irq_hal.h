@@ -31,6 +31,14 @@
 extern "C" {
 #endif
 
+/**
+ * Interrupts of the host target are emulated. irq_hal_set_pending() queues
+ * an interrupt and a dispatcher thread runs the registered handler, one at a
+ * time and ordered by priority. A handler only runs while no thread has
+ * interrupts disabled, so PRIMASK critical sections work as on the core.
+ * Handlers do not nest.
+ */
+
 /**
  * @brief IRQ pre-emption priority group
  */
@@ -58,6 +66,25 @@ void irq_hal_set_priority(int irq, uint32_t preemption_priority, uint32_t sub_pr
 void irq_hal_get_priority(int irq, uint32_t *preemption_priority, uint32_t *sub_priority);
 uint32_t irq_hal_get_active(int irq);
 void irq_hal_system_reset(void);
+uint32_t irq_hal_wait(uint32_t us);
+
+#if defined(CONFIG_IRQ_STATS)
+/**
+ * @brief IRQ statistics
+ */
+typedef struct irq_stats {
+    uint32_t count;                 /**< Number of invocations */
+    uint32_t max_cycles;            /**< Longest execution, nested IRQs excluded */
+    uint64_t total_cycles;          /**< Total execution, nested IRQs excluded */
+    uint32_t max_latency;           /**< Longest pend to entry latency */
+    uint32_t max_depth;             /**< Deepest nesting level at entry */
+} irq_stats_t;
+
+int irq_hal_stats_get(int irq, irq_stats_t *stats);
+void irq_hal_stats_reset(void);
+uint32_t irq_hal_stats_cycles(void);
+void irq_hal_stats_dump(int (*print)(const char *format, ...));
+#endif /* CONFIG_IRQ_STATS */
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,45 @@
+/**
+  * @file    soc.c
+  * @author  LuckkMaker
+  * @brief   System on Chip (SoC) initialization for the POSIX host target
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <signal.h>
+#include "drivers/init.h"
+
+/**
+ * @brief Initialize device
+ */
+void device_init(void) {
+    // Writes to a closed pseudo terminal or pipe are reported by errno
+    signal(SIGPIPE, SIG_IGN);
+}
+
+/**
+ * @brief Initialize power
+ */
+void power_init(void) {
+}
+
+/**
+ * @brief Initialize watchdog
+ */
+void watchdog_init(void) {
+}
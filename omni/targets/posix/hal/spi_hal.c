@@ -0,0 +1,530 @@
+/**
+  * @file    spi_hal.c
+  * @author  LuckkMaker
+  * @brief   SPI HAL driver
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <pthread.h>
+#include <string.h>
+#include "drivers/spi.h"
+#include "hal/spi_hal.h"
+#include "hal/gpio_hal.h"
+#include "hal/irq_hal.h"
+#include "trace/trace.h"
+#include "ll/spi_ll.h"
+
+/**
+ * @brief Host side of a SPI bus
+ */
+typedef struct {
+    const spi_hal_model_t *model[CONFIG_SPI_MODEL_NUM];
+    uint32_t frame_size;            /**< Bytes per frame */
+} spi_bus_t;
+
+static spi_obj_t spi_obj[SPI_NUM_MAX];
+static spi_bus_t spi_bus[SPI_NUM_MAX];
+static pthread_mutex_t spi_lock = PTHREAD_MUTEX_INITIALIZER;
+
+OMNI_DRIVER_API int spi_hal_init(spi_num_t spi_num, spi_driver_config_t *config);
+OMNI_DRIVER_API int spi_hal_deinit(spi_num_t spi_num);
+OMNI_DRIVER_API void spi_hal_start(spi_num_t spi_num);
+OMNI_DRIVER_API void spi_hal_stop(spi_num_t spi_num);
+OMNI_DRIVER_API int spi_hal_send(spi_num_t spi_num, const void *data, uint32_t len);
+OMNI_DRIVER_API int spi_hal_receive(spi_num_t spi_num, void *data, uint32_t len);
+OMNI_DRIVER_API int spi_hal_transfer(spi_num_t spi_num, const void *tx_data, void *rx_data, uint32_t len);
+OMNI_DRIVER_API int spi_hal_stream_send(spi_num_t spi_num, void *buffer0, void *buffer1, uint32_t len, spi_stream_callback cb);
+OMNI_DRIVER_API int spi_hal_stream_receive(spi_num_t spi_num, void *buffer0, void *buffer1, uint32_t len, spi_stream_callback cb);
+OMNI_DRIVER_API void spi_hal_stream_stop(spi_num_t spi_num);
+OMNI_DRIVER_API spi_driver_status_t spi_hal_get_status(spi_num_t spi_num);
+OMNI_DRIVER_API spi_driver_error_t spi_hal_get_error(spi_num_t spi_num);
+
+#if !defined(CONFIG_OMNI_DRIVER_DIRECT_CALL)
+const struct spi_driver_api spi_driver = {
+    .init = spi_hal_init,
+    .deinit = spi_hal_deinit,
+    .start = spi_hal_start,
+    .stop = spi_hal_stop,
+    .send = spi_hal_send,
+    .receive = spi_hal_receive,
+    .transfer = spi_hal_transfer,
+    .stream_send = spi_hal_stream_send,
+    .stream_receive = spi_hal_stream_receive,
+    .stream_stop = spi_hal_stream_stop,
+    .get_status = spi_hal_get_status,
+    .get_error = spi_hal_get_error,
+};
+#endif /* CONFIG_OMNI_DRIVER_DIRECT_CALL */
+
+static void spi_hal_irq_register(spi_num_t spi_num);
+static int spi_hal_xfer(spi_num_t spi_num, const void *tx_data, void *rx_data, uint32_t len);
+static void spi_hal_cs_watch(void *context, uint32_t gpio_num, uint32_t level);
+
+/**
+ * @brief Initialize SPI bus
+ * 
+ * @param spi_num SPI number
+ * @param config Pointer to the SPI driver configuration
+ * @return Operation status
+ */
+OMNI_DRIVER_API int spi_hal_init(spi_num_t spi_num, spi_driver_config_t *config) {
+    uint32_t data_size;
+    omni_assert(spi_num < SPI_NUM_MAX);
+    omni_assert_not_null(config);
+
+    spi_obj_t *obj = &spi_obj[spi_num];
+
+    // Set event callback
+    if (config->event_cb != NULL) {
+        obj->event_cb = config->event_cb;
+    } else {
+        obj->event_cb = NULL;
+    }
+
+    // Get dev information
+    obj->dev = spi_ll_get_dev(spi_num);
+    omni_assert_not_null(obj->dev);
+
+    // Clear status
+    obj->status = (spi_driver_status_t){0};
+
+    // Clear error
+    obj->error = (spi_driver_error_t){0};
+
+    // Only the master side is emulated
+    if (SPI_OP_MODE_GET(config->option) != SPI_OP_MODE_MASTER) {
+        return OMNI_FAIL;
+    }
+
+    // Frames wider than 8 bits take two bytes in the buffers
+    data_size = SPI_OP_DATA_SIZE_GET(config->option);
+    spi_bus[spi_num].frame_size = (data_size > 8U) ? 2U : 1U;
+
+    // Register IRQ
+    spi_hal_irq_register(spi_num);
+
+    // Initialize IRQ
+    irq_hal_clear_pending(obj->dev->irq_num);
+    irq_hal_set_priority(obj->dev->irq_num, obj->dev->irq_prio, 0);
+    irq_hal_enable(obj->dev->irq_num);
+
+    // Set initialized status
+    obj->status.is_initialized = 1;
+    // Call event callback
+    if (obj->event_cb != NULL) {
+        // Set initialized event
+        obj->event_cb(SPI_EVENT_INITIALIZED);
+    }
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Deinitialize SPI bus
+ * 
+ * @note Attached models stay attached.
+ * @param spi_num SPI number
+ * @return Operation status
+ */
+OMNI_DRIVER_API int spi_hal_deinit(spi_num_t spi_num) {
+    omni_assert(spi_num < SPI_NUM_MAX);
+
+    spi_obj_t *obj = &spi_obj[spi_num];
+    omni_assert_not_null(obj);
+
+    // Disable SPI IRQ
+    if (obj->dev != NULL) {
+        irq_hal_disable(obj->dev->irq_num);
+    }
+
+    spi_obj[spi_num] = (spi_obj_t){0};
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Start SPI bus
+ * 
+ * @param spi_num SPI number
+ */
+OMNI_DRIVER_API void spi_hal_start(spi_num_t spi_num) {
+    omni_assert(spi_num < SPI_NUM_MAX);
+}
+
+/**
+ * @brief Stop SPI bus
+ * 
+ * @param spi_num SPI number
+ */
+OMNI_DRIVER_API void spi_hal_stop(spi_num_t spi_num) {
+    omni_assert(spi_num < SPI_NUM_MAX);
+}
+
+/**
+ * @brief Send data via SPI bus
+ * 
+ * @param spi_num SPI number
+ * @param data Pointer to data buffer
+ * @param len Number of frames
+ * @return Operation status
+ */
+OMNI_DRIVER_API int spi_hal_send(spi_num_t spi_num, const void *data, uint32_t len) {
+    omni_assert(spi_num < SPI_NUM_MAX);
+    omni_assert_not_null(data);
+    omni_assert_non_zero(len);
+
+    return spi_hal_xfer(spi_num, data, NULL, len);
+}
+
+/**
+ * @brief Receive data via SPI bus
+ * 
+ * @param spi_num SPI number
+ * @param data Pointer to data buffer
+ * @param len Number of frames
+ * @return Operation status
+ */
+OMNI_DRIVER_API int spi_hal_receive(spi_num_t spi_num, void *data, uint32_t len) {
+    omni_assert(spi_num < SPI_NUM_MAX);
+    omni_assert_not_null(data);
+    omni_assert_non_zero(len);
+
+    return spi_hal_xfer(spi_num, NULL, data, len);
+}
+
+/**
+ * @brief Transfer data via SPI bus
+ * 
+ * @param spi_num SPI number
+ * @param tx_data Pointer to TX data buffer
+ * @param rx_data Pointer to RX data buffer
+ * @param len Number of frames
+ * @return Operation status
+ */
+OMNI_DRIVER_API int spi_hal_transfer(spi_num_t spi_num, const void *tx_data, void *rx_data, uint32_t len) {
+    omni_assert(spi_num < SPI_NUM_MAX);
+    omni_assert_not_null(tx_data);
+    omni_assert_not_null(rx_data);
+    omni_assert_non_zero(len);
+
+    return spi_hal_xfer(spi_num, tx_data, rx_data, len);
+}
+
+/**
+ * @brief Send a continuous stream from two buffers
+ *
+ * @note Not supported on the host, there is no DMA.
+ * @param spi_num SPI number
+ * @param buffer0 Pointer to first buffer
+ * @param buffer1 Pointer to second buffer
+ * @param len Number of frames in each buffer
+ * @param cb Stream callback
+ * @return Operation status
+ */
+OMNI_DRIVER_API int spi_hal_stream_send(spi_num_t spi_num, void *buffer0, void *buffer1, uint32_t len, spi_stream_callback cb) {
+    omni_assert(spi_num < SPI_NUM_MAX);
+
+    (void)buffer0;
+    (void)buffer1;
+    (void)len;
+    (void)cb;
+
+    return OMNI_FAIL;
+}
+
+/**
+ * @brief Receive a continuous stream into two buffers
+ *
+ * @note Not supported on the host, there is no DMA.
+ * @param spi_num SPI number
+ * @param buffer0 Pointer to first buffer
+ * @param buffer1 Pointer to second buffer
+ * @param len Number of frames in each buffer
+ * @param cb Stream callback
+ * @return Operation status
+ */
+OMNI_DRIVER_API int spi_hal_stream_receive(spi_num_t spi_num, void *buffer0, void *buffer1, uint32_t len, spi_stream_callback cb) {
+    omni_assert(spi_num < SPI_NUM_MAX);
+
+    (void)buffer0;
+    (void)buffer1;
+    (void)len;
+    (void)cb;
+
+    return OMNI_FAIL;
+}
+
+/**
+ * @brief Stop the stream
+ *
+ * @note Not supported on the host.
+ * @param spi_num SPI number
+ */
+OMNI_DRIVER_API void spi_hal_stream_stop(spi_num_t spi_num) {
+    omni_assert(spi_num < SPI_NUM_MAX);
+}
+
+/**
+ * @brief Get SPI bus status
+ * 
+ * @param spi_num SPI number
+ * @return SPI bus status
+ */
+OMNI_DRIVER_API spi_driver_status_t spi_hal_get_status(spi_num_t spi_num) {
+    omni_assert(spi_num < SPI_NUM_MAX);
+
+    spi_obj_t *obj = &spi_obj[spi_num];
+    omni_assert_not_null(obj);
+
+    return obj->status;
+}
+
+/**
+ * @brief Get SPI bus error
+ * 
+ * @param spi_num SPI number
+ * @return SPI bus error
+ */
+OMNI_DRIVER_API spi_driver_error_t spi_hal_get_error(spi_num_t spi_num) {
+    omni_assert(spi_num < SPI_NUM_MAX);
+
+    spi_obj_t *obj = &spi_obj[spi_num];
+    omni_assert_not_null(obj);
+
+    return obj->error;
+}
+
+/********************* HAL functions **********************/
+
+/**
+ * @brief Attach a device model to a SPI bus
+ * 
+ * @note The model must stay valid until it is detached.
+ * @param spi_num SPI number
+ * @param model Pointer to device model
+ * @return Operation status
+ */
+int spi_hal_attach(spi_num_t spi_num, const spi_hal_model_t *model) {
+    spi_bus_t *bus;
+    int ret = OMNI_BUSY;
+
+    if ((spi_num >= SPI_NUM_MAX) || (model == NULL) || (model->transfer == NULL)) {
+        return OMNI_FAIL;
+    }
+
+    bus = &spi_bus[spi_num];
+
+    pthread_mutex_lock(&spi_lock);
+    for (uint32_t i = 0; i < CONFIG_SPI_MODEL_NUM; i++) {
+        if (bus->model[i] == NULL) {
+            bus->model[i] = model;
+            ret = OMNI_OK;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&spi_lock);
+
+    if ((ret == OMNI_OK) && (model->cs_pin != SPI_HAL_CS_HARD) && (model->select != NULL)) {
+        ret = gpio_hal_watch(model->cs_pin, spi_hal_cs_watch, (void *)model);
+        if (ret != OMNI_OK) {
+            spi_hal_detach(spi_num, model);
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Detach a device model from a SPI bus
+ * 
+ * @param spi_num SPI number
+ * @param model Pointer to device model
+ * @return Operation status
+ */
+int spi_hal_detach(spi_num_t spi_num, const spi_hal_model_t *model) {
+    spi_bus_t *bus;
+    int ret = OMNI_FAIL;
+
+    if ((spi_num >= SPI_NUM_MAX) || (model == NULL)) {
+        return OMNI_FAIL;
+    }
+
+    bus = &spi_bus[spi_num];
+
+    pthread_mutex_lock(&spi_lock);
+    for (uint32_t i = 0; i < CONFIG_SPI_MODEL_NUM; i++) {
+        if (bus->model[i] == model) {
+            bus->model[i] = NULL;
+            ret = OMNI_OK;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&spi_lock);
+
+    if ((ret == OMNI_OK) && (model->cs_pin != SPI_HAL_CS_HARD) && (model->select != NULL)) {
+        gpio_hal_watch(model->cs_pin, NULL, NULL);
+    }
+
+    return ret;
+}
+
+/********************* IRQ handlers **********************/
+
+/**
+ * @brief SPI IRQ handler, reports the completed transfer
+ * 
+ * @param obj Pointer to SPI object
+ */
+static void spi_hal_irq_request(spi_obj_t *obj) {
+    omni_assert_not_null(obj);
+
+    if (!obj->status.busy) {
+        return;
+    }
+
+    // Clear busy status
+    obj->status.busy = 0;
+    TRACE_RECORD(TRACE_EVENT_DRV_COMPLETE, TRACE_DRV_SPI | (uint32_t)(obj - spi_obj), 0);
+
+    if (obj->event_cb != NULL) {
+        obj->event_cb(SPI_EVENT_TRANSFER_COMPLETE);
+    }
+}
+
+#if (CONFIG_SPI_NUM_1 == 1)
+/**
+ * @brief SPI1 IRQ handler
+ */
+static void spi1_irq_handler(void) {
+    spi_hal_irq_request(&spi_obj[SPI_NUM_1]);
+}
+#endif /* (CONFIG_SPI_NUM_1 == 1) */
+
+#if (CONFIG_SPI_NUM_2 == 1)
+/**
+ * @brief SPI2 IRQ handler
+ */
+static void spi2_irq_handler(void) {
+    spi_hal_irq_request(&spi_obj[SPI_NUM_2]);
+}
+#endif /* (CONFIG_SPI_NUM_2 == 1) */
+
+/**
+ * @brief Register SPI IRQ
+ * 
+ * @param spi_num SPI number
+ */
+static void spi_hal_irq_register(spi_num_t spi_num) {
+    switch (spi_num) {
+#if (CONFIG_SPI_NUM_1 == 1)
+        case SPI_NUM_1:
+            irq_hal_register_handler(spi_obj[SPI_NUM_1].dev->irq_num, spi1_irq_handler);
+            break;
+#endif /* (CONFIG_SPI_NUM_1 == 1) */
+#if (CONFIG_SPI_NUM_2 == 1)
+        case SPI_NUM_2:
+            irq_hal_register_handler(spi_obj[SPI_NUM_2].dev->irq_num, spi2_irq_handler);
+            break;
+#endif /* (CONFIG_SPI_NUM_2 == 1) */
+        default:
+            break;
+    }
+}
+
+/********************* Private functions **********************/
+
+/**
+ * @brief Clock data through the selected models
+ * 
+ * @note Runs in the calling thread, completion is reported from the SPI
+ *       interrupt as on the devices.
+ * @param spi_num SPI number
+ * @param tx_data Pointer to TX data buffer, NULL on receive
+ * @param rx_data Pointer to RX data buffer, NULL on send
+ * @param len Number of frames
+ * @return Operation status
+ */
+static int spi_hal_xfer(spi_num_t spi_num, const void *tx_data, void *rx_data, uint32_t len) {
+    const spi_hal_model_t *model[CONFIG_SPI_MODEL_NUM];
+    uint8_t *rx = (uint8_t *)rx_data;
+    uint32_t size;
+    bool hard;
+
+    spi_obj_t *obj = &spi_obj[spi_num];
+    omni_assert_not_null(obj);
+
+    if (obj->status.busy) {
+        return OMNI_BUSY;
+    }
+
+    // Set busy status
+    obj->status.busy = 1;
+    TRACE_RECORD(TRACE_EVENT_DRV_START, TRACE_DRV_SPI | spi_num, len);
+
+    size = len * spi_bus[spi_num].frame_size;
+    if (rx != NULL) {
+        memset(rx, 0xFF, size);
+    }
+
+    pthread_mutex_lock(&spi_lock);
+    memcpy(model, spi_bus[spi_num].model, sizeof(model));
+    pthread_mutex_unlock(&spi_lock);
+
+    for (uint32_t i = 0; i < CONFIG_SPI_MODEL_NUM; i++) {
+        if (model[i] == NULL) {
+            continue;
+        }
+
+        hard = (model[i]->cs_pin == SPI_HAL_CS_HARD);
+        if (!hard && (gpio_hal_fast_read(model[i]->cs_pin) != 0U)) {
+            continue;
+        }
+
+        if (hard && (model[i]->select != NULL)) {
+            model[i]->select(model[i]->context, true);
+        }
+
+        model[i]->transfer(model[i]->context, (const uint8_t *)tx_data, rx, size);
+        // Only the first selected model drives MISO
+        rx = NULL;
+
+        if (hard && (model[i]->select != NULL)) {
+            model[i]->select(model[i]->context, false);
+        }
+    }
+
+    irq_hal_set_pending(obj->dev->irq_num);
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Chip select watch of a model
+ * 
+ * @param context Pointer to device model
+ * @param gpio_num Chip select GPIO
+ * @param level GPIO level
+ */
+static void spi_hal_cs_watch(void *context, uint32_t gpio_num, uint32_t level) {
+    const spi_hal_model_t *model = (const spi_hal_model_t *)context;
+
+    UNUSED(gpio_num);
+
+    model->select(model->context, level == 0U);
+}
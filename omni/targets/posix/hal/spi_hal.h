@@ -0,0 +1,66 @@
+/**
+  * @file    spi_hal.h
+  * @author  LuckkMaker
+  * @brief   Header for spi_hal.c file
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef OMNI_HAL_SPI_H
+#define OMNI_HAL_SPI_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "drivers/spi_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * SPI buses of the host target clock data through device models. A model
+ * with a chip select GPIO is selected while the pin is low, a model with
+ * SPI_HAL_CS_HARD is selected for each transfer. Only the first selected
+ * model drives MISO, with no model selected all ones are received.
+ */
+
+#define SPI_HAL_CS_HARD     0xFFFFFFFFU     /**< Selected by the bus for each transfer */
+
+/**
+ * @brief SPI device model
+ */
+typedef struct spi_hal_model {
+    void *context;                  /**< Passed to the callbacks */
+    uint32_t cs_pin;                /**< Chip select GPIO or SPI_HAL_CS_HARD */
+    /**
+     * @brief Chip select changed, optional
+     */
+    void (*select)(void *context, bool selected);
+    /**
+     * @brief Clock bytes, @p tx is NULL on receive and @p rx is NULL on send
+     */
+    void (*transfer)(void *context, const uint8_t *tx, uint8_t *rx, uint32_t len);
+} spi_hal_model_t;
+
+int spi_hal_attach(spi_num_t spi_num, const spi_hal_model_t *model);
+int spi_hal_detach(spi_num_t spi_num, const spi_hal_model_t *model);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* OMNI_HAL_SPI_H */
@@ -0,0 +1,607 @@
+/**
+  * @file    timer_hal.c
+  * @author  LuckkMaker
+  * @brief   Timer HAL driver
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "drivers/timer.h"
+#include "hal/clock_hal.h"
+#include "hal/irq_hal.h"
+#if defined(CONFIG_TIMER_HARDWARE)
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+#include "ll/timer_ll.h"
+
+#define TIMER_NS_PER_SEC        1000000000ULL
+
+/**
+ * @brief Host side of a timer, the counter is derived from the monotonic clock
+ */
+typedef struct {
+    pthread_t thread;               /**< Update thread */
+    uint32_t thread_started;        /**< Update thread created */
+    uint32_t exit;                  /**< Update thread shall exit */
+    pthread_mutex_t lock;           /**< Protects the timer state */
+    pthread_cond_t cond;            /**< Signalled on start, stop and exit */
+    uint32_t frequency;             /**< Counter frequency in Hz */
+    uint32_t period;                /**< Counter period in ticks */
+    uint64_t period_ns;             /**< Update period in nanoseconds */
+    uint64_t start_ns;              /**< Time the counter was zero */
+    uint64_t next_ns;               /**< Time of the next update */
+} timer_port_t;
+
+static timer_obj_t timer_obj[TIMER_NUM_MAX];
+static timer_port_t timer_port[TIMER_NUM_MAX];
+
+static int timer_hal_init(timer_num_t timer_num, timer_driver_config_t *config);
+static int timer_hal_deinit(timer_num_t timer_num);
+static int timer_hal_start(timer_num_t timer_num);
+static int timer_hal_stop(timer_num_t timer_num);
+static uint32_t timer_hal_get_counter(timer_num_t timer_num);
+static int timer_hal_pwm_start(timer_num_t timer_num, timer_channel_t channel, uint32_t pulse, timer_pwm_polarity_t polarity);
+static int timer_hal_pwm_stop(timer_num_t timer_num, timer_channel_t channel);
+static void timer_hal_pwm_set_pulse(timer_num_t timer_num, timer_channel_t channel, uint32_t pulse);
+static int timer_hal_capture_start(timer_num_t timer_num, timer_channel_t channel, timer_capture_edge_t edge, uint32_t *buffer, uint32_t len);
+static int timer_hal_capture_stop(timer_num_t timer_num, timer_channel_t channel);
+static int timer_hal_burst_write(timer_num_t timer_num, timer_channel_t channel, uint32_t channels, const uint32_t *data, uint32_t len);
+static int timer_hal_dma_write(timer_num_t timer_num, volatile uint32_t *reg, const uint32_t *data, uint32_t len);
+static timer_driver_status_t timer_hal_get_status(timer_num_t timer_num);
+static timer_driver_error_t timer_hal_get_error(timer_num_t timer_num);
+#endif /* CONFIG_TIMER_HARDWARE */
+static void timer_hal_delay_ms(uint32_t delay);
+static void timer_hal_delay_us(uint32_t delay);
+static uint32_t timer_hal_get_tick(uint32_t frequency);
+static uint32_t timer_hal_idle(uint32_t us);
+
+const struct timer_driver_api timer_driver = {
+#if defined(CONFIG_TIMER_HARDWARE)
+    .init = timer_hal_init,
+    .deinit = timer_hal_deinit,
+    .start = timer_hal_start,
+    .stop = timer_hal_stop,
+    .get_counter = timer_hal_get_counter,
+    .pwm_start = timer_hal_pwm_start,
+    .pwm_stop = timer_hal_pwm_stop,
+    .pwm_set_pulse = timer_hal_pwm_set_pulse,
+    .capture_start = timer_hal_capture_start,
+    .capture_stop = timer_hal_capture_stop,
+    .burst_write = timer_hal_burst_write,
+    .dma_write = timer_hal_dma_write,
+    .get_status = timer_hal_get_status,
+    .get_error = timer_hal_get_error,
+#endif /* CONFIG_TIMER_HARDWARE */
+    .delay_ms = timer_hal_delay_ms,
+    .delay_us = timer_hal_delay_us,
+    .get_tick = timer_hal_get_tick,
+    .idle = timer_hal_idle,
+};
+
+#if defined(CONFIG_TIMER_HARDWARE)
+static void timer_hal_irq_register(timer_num_t timer_num);
+static void *timer_hal_thread(void *argument);
+
+/**
+ * @brief Initialize timer
+ *
+ * @note Only the time base mode is emulated on the host.
+ * @param timer_num Timer number
+ * @param config Pointer to the timer driver configuration
+ * @return Operation status
+ */
+static int timer_hal_init(timer_num_t timer_num, timer_driver_config_t *config) {
+    omni_assert(timer_num < TIMER_NUM_MAX);
+    omni_assert_not_null(config);
+
+    timer_obj_t *obj = &timer_obj[timer_num];
+    timer_port_t *port = &timer_port[timer_num];
+    pthread_condattr_t attr;
+
+    if ((config->mode != TIMER_MODE_BASE) || (config->frequency == 0) || \
+        (config->frequency > TIMER_NS_PER_SEC) || (config->period == 0)) {
+        return OMNI_FAIL;
+    }
+
+    // Set event callback
+    if (config->event_cb != NULL) {
+        obj->event_cb = config->event_cb;
+    } else {
+        obj->event_cb = NULL;
+    }
+
+    // Get dev information
+    obj->dev = timer_ll_get_dev(timer_num);
+    omni_assert_not_null(obj->dev);
+
+    // Clear status
+    obj->status = (timer_driver_status_t){0};
+
+    // Clear error
+    obj->error = (timer_driver_error_t){0};
+
+    obj->data = (timer_driver_data_t){0};
+    obj->data.mode = config->mode;
+
+    // Prepare the host timer
+    port->exit = 0;
+    port->frequency = config->frequency;
+    port->period = config->period;
+    port->period_ns = ((uint64_t)config->period * TIMER_NS_PER_SEC) / config->frequency;
+    if (port->period_ns == 0) {
+        port->period_ns = 1;
+    }
+
+    pthread_mutex_init(&port->lock, NULL);
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&port->cond, &attr);
+    pthread_condattr_destroy(&attr);
+
+    // Register IRQ
+    timer_hal_irq_register(timer_num);
+
+    // Initialize IRQ
+    irq_hal_clear_pending(obj->dev->irq_num);
+    irq_hal_set_priority(obj->dev->irq_num, obj->dev->irq_prio, 0);
+    irq_hal_enable(obj->dev->irq_num);
+
+    // Start the update thread
+    if (pthread_create(&port->thread, NULL, timer_hal_thread, (void *)(uintptr_t)timer_num) != 0) {
+        irq_hal_disable(obj->dev->irq_num);
+        return OMNI_FAIL;
+    }
+    port->thread_started = 1;
+
+    // Set initialized status
+    obj->status.is_initialized = 1;
+    // Call event callback
+    if (obj->event_cb != NULL) {
+        // Set initialized event
+        obj->event_cb(TIMER_EVENT_INITIALIZED);
+    }
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Deinitialize timer
+ *
+ * @param timer_num Timer number
+ * @return Operation status
+ */
+static int timer_hal_deinit(timer_num_t timer_num) {
+    omni_assert(timer_num < TIMER_NUM_MAX);
+
+    timer_obj_t *obj = &timer_obj[timer_num];
+    timer_port_t *port = &timer_port[timer_num];
+    omni_assert_not_null(obj->dev);
+
+    // Disable timer IRQ
+    irq_hal_disable(obj->dev->irq_num);
+
+    // Stop the update thread
+    if (port->thread_started) {
+        pthread_mutex_lock(&port->lock);
+        port->exit = 1;
+        pthread_cond_broadcast(&port->cond);
+        pthread_mutex_unlock(&port->lock);
+
+        pthread_join(port->thread, NULL);
+        port->thread_started = 0;
+
+        pthread_cond_destroy(&port->cond);
+        pthread_mutex_destroy(&port->lock);
+    }
+
+    timer_obj[timer_num] = (timer_obj_t){0};
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Start timer counter
+ *
+ * @note The counter restarts from zero.
+ * @param timer_num Timer number
+ * @return Operation status
+ */
+static int timer_hal_start(timer_num_t timer_num) {
+    omni_assert(timer_num < TIMER_NUM_MAX);
+
+    timer_obj_t *obj = &timer_obj[timer_num];
+    timer_port_t *port = &timer_port[timer_num];
+    omni_assert_not_null(obj->dev);
+
+    pthread_mutex_lock(&port->lock);
+    port->start_ns = clock_hal_get_ns();
+    port->next_ns = port->start_ns + port->period_ns;
+    obj->status.running = 1;
+    pthread_cond_broadcast(&port->cond);
+    pthread_mutex_unlock(&port->lock);
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Stop timer counter
+ *
+ * @param timer_num Timer number
+ * @return Operation status
+ */
+static int timer_hal_stop(timer_num_t timer_num) {
+    omni_assert(timer_num < TIMER_NUM_MAX);
+
+    timer_obj_t *obj = &timer_obj[timer_num];
+    timer_port_t *port = &timer_port[timer_num];
+    omni_assert_not_null(obj->dev);
+
+    pthread_mutex_lock(&port->lock);
+    obj->status.running = 0;
+    pthread_cond_broadcast(&port->cond);
+    pthread_mutex_unlock(&port->lock);
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Get timer counter
+ *
+ * @param timer_num Timer number
+ * @return Counter value, 0 while stopped
+ */
+static uint32_t timer_hal_get_counter(timer_num_t timer_num) {
+    omni_assert(timer_num < TIMER_NUM_MAX);
+
+    timer_obj_t *obj = &timer_obj[timer_num];
+    timer_port_t *port = &timer_port[timer_num];
+    omni_assert_not_null(obj->dev);
+
+    uint64_t elapsed;
+    uint64_t ticks;
+
+    if (!obj->status.running) {
+        return 0;
+    }
+
+    elapsed = clock_hal_get_ns() - port->start_ns;
+    // Split the product so that it cannot overflow
+    ticks = ((elapsed / TIMER_NS_PER_SEC) * port->frequency) + \
+        (((elapsed % TIMER_NS_PER_SEC) * port->frequency) / TIMER_NS_PER_SEC);
+
+    return (uint32_t)(ticks % port->period);
+}
+
+/**
+ * @brief Start PWM output on a channel
+ *
+ * @note Not supported on the host.
+ * @param timer_num Timer number
+ * @param channel Timer channel
+ * @param pulse Pulse width in ticks
+ * @param polarity Output polarity
+ * @return Operation status
+ */
+static int timer_hal_pwm_start(timer_num_t timer_num, timer_channel_t channel, uint32_t pulse, timer_pwm_polarity_t polarity) {
+    omni_assert(timer_num < TIMER_NUM_MAX);
+
+    (void)channel;
+    (void)pulse;
+    (void)polarity;
+
+    return OMNI_FAIL;
+}
+
+/**
+ * @brief Stop PWM output on a channel
+ *
+ * @note Not supported on the host.
+ * @param timer_num Timer number
+ * @param channel Timer channel
+ * @return Operation status
+ */
+static int timer_hal_pwm_stop(timer_num_t timer_num, timer_channel_t channel) {
+    omni_assert(timer_num < TIMER_NUM_MAX);
+
+    (void)channel;
+
+    return OMNI_FAIL;
+}
+
+/**
+ * @brief Set PWM pulse of a channel
+ *
+ * @note Not supported on the host.
+ * @param timer_num Timer number
+ * @param channel Timer channel
+ * @param pulse Pulse width in ticks
+ */
+static void timer_hal_pwm_set_pulse(timer_num_t timer_num, timer_channel_t channel, uint32_t pulse) {
+    omni_assert(timer_num < TIMER_NUM_MAX);
+
+    (void)channel;
+    (void)pulse;
+}
+
+/**
+ * @brief Start input capture on a channel
+ *
+ * @note Not supported on the host.
+ * @param timer_num Timer number
+ * @param channel Timer channel
+ * @param edge Capture edge
+ * @param buffer Pointer to capture buffer
+ * @param len Number of captures
+ * @return Operation status
+ */
+static int timer_hal_capture_start(timer_num_t timer_num, timer_channel_t channel, timer_capture_edge_t edge, uint32_t *buffer, uint32_t len) {
+    omni_assert(timer_num < TIMER_NUM_MAX);
+
+    (void)channel;
+    (void)edge;
+    (void)buffer;
+    (void)len;
+
+    return OMNI_FAIL;
+}
+
+/**
+ * @brief Stop input capture on a channel
+ *
+ * @note Not supported on the host.
+ * @param timer_num Timer number
+ * @param channel Timer channel
+ * @return Operation status
+ */
+static int timer_hal_capture_stop(timer_num_t timer_num, timer_channel_t channel) {
+    omni_assert(timer_num < TIMER_NUM_MAX);
+
+    (void)channel;
+
+    return OMNI_FAIL;
+}
+
+/**
+ * @brief Write compare registers through DMA burst
+ *
+ * @note Not supported on the host.
+ * @param timer_num Timer number
+ * @param channel First channel of the burst
+ * @param channels Number of channels per update
+ * @param data Pointer to data
+ * @param len Number of words
+ * @return Operation status
+ */
+static int timer_hal_burst_write(timer_num_t timer_num, timer_channel_t channel, uint32_t channels, const uint32_t *data, uint32_t len) {
+    omni_assert(timer_num < TIMER_NUM_MAX);
+
+    (void)channel;
+    (void)channels;
+    (void)data;
+    (void)len;
+
+    return OMNI_FAIL;
+}
+
+/**
+ * @brief Write a register on every update through DMA
+ *
+ * @note Not supported on the host.
+ * @param timer_num Timer number
+ * @param reg Pointer to destination register
+ * @param data Pointer to data
+ * @param len Number of words
+ * @return Operation status
+ */
+static int timer_hal_dma_write(timer_num_t timer_num, volatile uint32_t *reg, const uint32_t *data, uint32_t len) {
+    omni_assert(timer_num < TIMER_NUM_MAX);
+
+    (void)reg;
+    (void)data;
+    (void)len;
+
+    return OMNI_FAIL;
+}
+
+/**
+ * @brief Get timer status
+ *
+ * @param timer_num Timer number
+ * @return Timer driver status
+ */
+static timer_driver_status_t timer_hal_get_status(timer_num_t timer_num) {
+    omni_assert(timer_num < TIMER_NUM_MAX);
+
+    timer_obj_t *obj = &timer_obj[timer_num];
+    omni_assert_not_null(obj);
+
+    return obj->status;
+}
+
+/**
+ * @brief Get timer error
+ *
+ * @param timer_num Timer number
+ * @return Timer driver error
+ */
+static timer_driver_error_t timer_hal_get_error(timer_num_t timer_num) {
+    omni_assert(timer_num < TIMER_NUM_MAX);
+
+    timer_obj_t *obj = &timer_obj[timer_num];
+    omni_assert_not_null(obj);
+
+    return obj->error;
+}
+#endif /* CONFIG_TIMER_HARDWARE */
+
+/**
+ * @brief Delay for a number of milliseconds
+ *
+ * @param delay Number of milliseconds to delay
+ */
+static void timer_hal_delay_ms(uint32_t delay) {
+    clock_hal_sleep_ns((uint64_t)delay * 1000000U);
+}
+
+/**
+ * @brief Delay for a number of microseconds
+ *
+ * @param delay Number of microseconds to delay
+ */
+static void timer_hal_delay_us(uint32_t delay) {
+    clock_hal_sleep_ns((uint64_t)delay * 1000U);
+}
+
+/**
+ * @brief Get current tick
+ *
+ * @param frequency Tick frequency in Hz
+ * @return Current tick
+ */
+static uint32_t timer_hal_get_tick(uint32_t frequency) {
+    omni_assert_non_zero(frequency);
+
+    return (uint32_t)(clock_hal_get_ns() / (SystemCoreClock / frequency));
+}
+
+/**
+ * @brief Sleep until the next interrupt or timeout
+ *
+ * @param us Maximum number of microseconds to sleep
+ * @return Number of microseconds actually slept
+ */
+static uint32_t timer_hal_idle(uint32_t us) {
+    return irq_hal_wait(us);
+}
+
+#if defined(CONFIG_TIMER_HARDWARE)
+/********************* Private functions **********************/
+
+/**
+ * @brief Update thread, pends the timer IRQ once per period
+ *
+ * @param argument Timer number
+ * @return Always NULL
+ */
+static void *timer_hal_thread(void *argument) {
+    timer_num_t timer_num = (timer_num_t)(uintptr_t)argument;
+    timer_obj_t *obj = &timer_obj[timer_num];
+    timer_port_t *port = &timer_port[timer_num];
+    struct timespec ts;
+    uint64_t now;
+    int ret;
+
+    pthread_mutex_lock(&port->lock);
+    while (!port->exit) {
+        if (!obj->status.running) {
+            pthread_cond_wait(&port->cond, &port->lock);
+            continue;
+        }
+
+        ts.tv_sec = (time_t)(port->next_ns / TIMER_NS_PER_SEC);
+        ts.tv_nsec = (long)(port->next_ns % TIMER_NS_PER_SEC);
+        ret = pthread_cond_timedwait(&port->cond, &port->lock, &ts);
+        if ((ret != ETIMEDOUT) || !obj->status.running || port->exit) {
+            // Woken up by start, stop or deinit
+            continue;
+        }
+
+        // Updates missed while the host was busy are merged into one
+        now = clock_hal_get_ns();
+        port->next_ns += port->period_ns;
+        if (port->next_ns <= now) {
+            port->next_ns += (((now - port->next_ns) / port->period_ns) + 1U) * port->period_ns;
+        }
+
+        pthread_mutex_unlock(&port->lock);
+        irq_hal_set_pending(obj->dev->irq_num);
+        pthread_mutex_lock(&port->lock);
+    }
+    pthread_mutex_unlock(&port->lock);
+
+    return NULL;
+}
+
+/********************* IRQ handlers **********************/
+
+/**
+ * @brief Timer IRQ handler
+ */
+static void timer_hal_irq_request(timer_obj_t *obj) {
+    omni_assert_not_null(obj);
+
+    if (obj->status.running && (obj->event_cb != NULL)) {
+        obj->event_cb(TIMER_EVENT_UPDATE);
+    }
+}
+
+#if (CONFIG_TIMER_NUM_1 == 1)
+/**
+ * @brief TIM1 IRQ handler
+ */
+static void tim1_irq_handler(void) {
+    timer_hal_irq_request(&timer_obj[TIMER_NUM_1]);
+}
+#endif /* (CONFIG_TIMER_NUM_1 == 1) */
+
+#if (CONFIG_TIMER_NUM_2 == 1)
+/**
+ * @brief TIM2 IRQ handler
+ */
+static void tim2_irq_handler(void) {
+    timer_hal_irq_request(&timer_obj[TIMER_NUM_2]);
+}
+#endif /* (CONFIG_TIMER_NUM_2 == 1) */
+
+#if (CONFIG_TIMER_NUM_3 == 1)
+/**
+ * @brief TIM3 IRQ handler
+ */
+static void tim3_irq_handler(void) {
+    timer_hal_irq_request(&timer_obj[TIMER_NUM_3]);
+}
+#endif /* (CONFIG_TIMER_NUM_3 == 1) */
+
+/**
+ * @brief Register timer IRQ
+ *
+ * @param timer_num Timer number
+ */
+static void timer_hal_irq_register(timer_num_t timer_num) {
+    switch (timer_num) {
+#if (CONFIG_TIMER_NUM_1 == 1)
+        case TIMER_NUM_1:
+            irq_hal_register_handler(timer_obj[TIMER_NUM_1].dev->irq_num, tim1_irq_handler);
+            break;
+#endif /* (CONFIG_TIMER_NUM_1 == 1) */
+#if (CONFIG_TIMER_NUM_2 == 1)
+        case TIMER_NUM_2:
+            irq_hal_register_handler(timer_obj[TIMER_NUM_2].dev->irq_num, tim2_irq_handler);
+            break;
+#endif /* (CONFIG_TIMER_NUM_2 == 1) */
+#if (CONFIG_TIMER_NUM_3 == 1)
+        case TIMER_NUM_3:
+            irq_hal_register_handler(timer_obj[TIMER_NUM_3].dev->irq_num, tim3_irq_handler);
+            break;
+#endif /* (CONFIG_TIMER_NUM_3 == 1) */
+        default:
+            break;
+    }
+}
+#endif /* CONFIG_TIMER_HARDWARE */
@@ -0,0 +1,808 @@
+/**
+  * @file    usart_hal.c
+  * @author  LuckkMaker
+  * @brief   USART HAL driver
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+#include "drivers/usart.h"
+#include "hal/irq_hal.h"
+#include "hal/clock_hal.h"
+#include "trace/trace.h"
+#include "ll/usart_ll.h"
+
+#define USART_FIFO_MASK             (CONFIG_USART_RX_FIFO_SIZE - 1U)
+
+#if (CONFIG_USART_RX_FIFO_SIZE & USART_FIFO_MASK) != 0
+#error "CONFIG_USART_RX_FIFO_SIZE must be a power of two"
+#endif
+
+#define USART_FD_NONE               (-1)
+#define USART_STDIO_PATH            "stdio"
+#define USART_READ_SIZE             256U
+
+/**
+ * @brief Host side of a USART port
+ */
+typedef struct {
+    int fd_in;                      /**< Descriptor data is received from */
+    int fd_out;                     /**< Descriptor data is sent to */
+    int fd_slave;                   /**< Slave of a pseudo terminal, kept open */
+    pthread_t reader;               /**< Reader thread */
+    uint32_t running;               /**< Reader thread started */
+    pthread_mutex_t lock;           /**< Protects the RX FIFO */
+    pthread_cond_t cond;            /**< Signalled when data arrives */
+    uint8_t fifo[CONFIG_USART_RX_FIFO_SIZE];
+    uint32_t head;
+    uint32_t tail;
+    uint32_t overflow;              /**< Bytes dropped on a full FIFO */
+    volatile uint32_t tx_done;      /**< Send completion for the handler */
+} usart_port_t;
+
+static usart_obj_t usart_obj[USART_NUM_MAX];
+static usart_port_t usart_port[USART_NUM_MAX];
+
+OMNI_DRIVER_API int usart_hal_init(usart_num_t usart_num, usart_driver_config_t *config);
+OMNI_DRIVER_API int usart_hal_deinit(usart_num_t usart_num);
+OMNI_DRIVER_API void usart_hal_start(usart_num_t usart_num);
+OMNI_DRIVER_API void usart_hal_stop(usart_num_t usart_num);
+OMNI_DRIVER_API int usart_hal_poll_send(usart_num_t usart_num, const uint8_t *data, uint32_t len, uint32_t timeout);
+OMNI_DRIVER_API int usart_hal_poll_receive(usart_num_t usart_num, void *data, uint32_t len, uint32_t timeout);
+OMNI_DRIVER_API int usart_hal_send(usart_num_t usart_num, const uint8_t *data, uint32_t len);
+OMNI_DRIVER_API int usart_hal_receive(usart_num_t usart_num, void *data, uint32_t len);
+OMNI_DRIVER_API int usart_hal_stream_send(usart_num_t usart_num, void *buffer0, void *buffer1, uint32_t len, usart_stream_callback cb);
+OMNI_DRIVER_API int usart_hal_stream_receive(usart_num_t usart_num, void *buffer0, void *buffer1, uint32_t len, usart_stream_callback cb);
+OMNI_DRIVER_API void usart_hal_stream_stop(usart_num_t usart_num);
+OMNI_DRIVER_API usart_driver_status_t usart_hal_get_status(usart_num_t usart_num);
+OMNI_DRIVER_API usart_driver_error_t usart_hal_get_error(usart_num_t usart_num);
+
+#if !defined(CONFIG_OMNI_DRIVER_DIRECT_CALL)
+const struct usart_driver_api usart_driver = {
+    .init = usart_hal_init,
+    .deinit = usart_hal_deinit,
+    .start = usart_hal_start,
+    .stop = usart_hal_stop,
+    .poll_send = usart_hal_poll_send,
+    .poll_receive = usart_hal_poll_receive,
+    .send = usart_hal_send,
+    .receive = usart_hal_receive,
+    .stream_send = usart_hal_stream_send,
+    .stream_receive = usart_hal_stream_receive,
+    .stream_stop = usart_hal_stream_stop,
+    .get_status = usart_hal_get_status,
+    .get_error = usart_hal_get_error,
+};
+#endif /* CONFIG_OMNI_DRIVER_DIRECT_CALL */
+
+static void usart_hal_irq_register(usart_num_t usart_num);
+static void usart_hal_irq_request(usart_obj_t *obj);
+static int usart_hal_open(usart_port_t *port, const char *path, usart_num_t usart_num);
+static void usart_hal_close(usart_port_t *port);
+static void usart_hal_set_termios(int fd, usart_driver_config_t *config);
+static int usart_hal_write(int fd, const uint8_t *data, uint32_t len);
+static uint32_t usart_hal_fifo_read(usart_port_t *port, uint8_t *data, uint32_t len);
+static void *usart_hal_reader(void *argument);
+
+/**
+ * @brief Open the USART port
+ * 
+ * @param usart_num USART port number
+ * @param config Pointer to driver configuration structure
+ * @return Operation status
+ */
+OMNI_DRIVER_API int usart_hal_init(usart_num_t usart_num, usart_driver_config_t *config) {
+    omni_assert(usart_num < USART_NUM_MAX);
+    omni_assert_not_null(config);
+
+    usart_obj_t *obj = &usart_obj[usart_num];
+    usart_port_t *port = &usart_port[usart_num];
+
+    // Set event callback
+    if (config->event_cb != NULL) {
+        obj->event_cb = config->event_cb;
+    } else {
+        obj->event_cb = NULL;
+    }
+
+    // Get dev information
+    obj->dev = usart_ll_get_dev(usart_num);
+    omni_assert_not_null(obj->dev);
+
+    // Clear status
+    obj->status = (usart_driver_status_t){0};
+
+    // Clear error
+    obj->error = (usart_driver_error_t){0};
+
+    // Open the host device
+    if (usart_hal_open(port, obj->dev->path, usart_num) != OMNI_OK) {
+        return OMNI_FAIL;
+    }
+
+    if (isatty(port->fd_in)) {
+        usart_hal_set_termios(port->fd_in, config);
+    }
+
+    // Register IRQ
+    usart_hal_irq_register(usart_num);
+
+    // Initialize IRQ
+    irq_hal_clear_pending(obj->dev->irq_num);
+    irq_hal_set_priority(obj->dev->irq_num, obj->dev->irq_prio, 0);
+    irq_hal_enable(obj->dev->irq_num);
+
+    // Start the reader thread
+    if (pthread_create(&port->reader, NULL, usart_hal_reader, (void *)(uintptr_t)usart_num) != 0) {
+        usart_hal_close(port);
+        return OMNI_FAIL;
+    }
+    port->running = 1;
+
+    // Set initialized status
+    obj->status.is_initialized = 1;
+    // Call event callback
+    if (obj->event_cb != NULL) {
+        // Set initialized event
+        obj->event_cb(USART_EVENT_INITIALIZED);
+    }
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Close the USART port
+ * 
+ * @param usart_num USART port number
+ * @return Operation status
+ */
+OMNI_DRIVER_API int usart_hal_deinit(usart_num_t usart_num) {
+    omni_assert(usart_num < USART_NUM_MAX);
+
+    usart_obj_t *obj = &usart_obj[usart_num];
+    usart_port_t *port = &usart_port[usart_num];
+    omni_assert_not_null(obj);
+
+    // Disable USART IRQ
+    if (obj->dev != NULL) {
+        irq_hal_disable(obj->dev->irq_num);
+    }
+
+    // Stop the reader thread, read() is a cancellation point
+    if (port->running) {
+        pthread_cancel(port->reader);
+        pthread_join(port->reader, NULL);
+        port->running = 0;
+    }
+
+    usart_hal_close(port);
+
+    usart_obj[usart_num] = (usart_obj_t){0};
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Start USART port
+ * 
+ * @note The host device is open from init on, nothing to do.
+ * @param usart_num USART port number
+ */
+OMNI_DRIVER_API void usart_hal_start(usart_num_t usart_num) {
+    omni_assert(usart_num < USART_NUM_MAX);
+}
+
+/**
+ * @brief Stop USART port
+ * 
+ * @param usart_num USART port number
+ */
+OMNI_DRIVER_API void usart_hal_stop(usart_num_t usart_num) {
+    omni_assert(usart_num < USART_NUM_MAX);
+}
+
+/**
+ * @brief Write data to USART with polling
+ * 
+ * @param usart_num USART port number
+ * @param data Pointer to data buffer
+ * @param len Length of data buffer
+ * @param timeout Timeout in ms, not used as writes complete at once
+ * @return Operation status
+ */
+OMNI_DRIVER_API int usart_hal_poll_send(usart_num_t usart_num, const uint8_t *data, uint32_t len, uint32_t timeout) {
+    omni_assert(usart_num < USART_NUM_MAX);
+    omni_assert_not_null(data);
+    omni_assert_non_zero(len);
+
+    UNUSED(timeout);
+
+    return usart_hal_write(usart_port[usart_num].fd_out, data, len);
+}
+
+/**
+ * @brief Read data from USART with polling
+ * 
+ * @param usart_num USART port number
+ * @param data Pointer to data buffer
+ * @param len Length of data buffer
+ * @param timeout Timeout in ms
+ * @return Operation status
+ */
+OMNI_DRIVER_API int usart_hal_poll_receive(usart_num_t usart_num, void *data, uint32_t len, uint32_t timeout) {
+    omni_assert(usart_num < USART_NUM_MAX);
+    omni_assert_not_null(data);
+    omni_assert_non_zero(len);
+
+    usart_port_t *port = &usart_port[usart_num];
+    uint64_t end = clock_hal_get_ns() + ((uint64_t)timeout * 1000000U);
+    struct timespec deadline = {
+        .tv_sec = (time_t)(end / 1000000000U),
+        .tv_nsec = (long)(end % 1000000000U),
+    };
+    uint32_t count = 0;
+
+    pthread_mutex_lock(&port->lock);
+    while (1) {
+        count += usart_hal_fifo_read(port, (uint8_t *)data + count, len - count);
+        if (count == len) {
+            break;
+        }
+
+        if (pthread_cond_timedwait(&port->cond, &port->lock, &deadline) == ETIMEDOUT) {
+            break;
+        }
+    }
+    pthread_mutex_unlock(&port->lock);
+
+    return (count == len) ? OMNI_OK : OMNI_FAIL;
+}
+
+/**
+ * @brief Write data to USART port
+ * 
+ * @note The data is written to the host device at once, completion is
+ *       reported from the USART interrupt as on the devices.
+ * @param usart_num USART port number
+ * @param data Pointer to data buffer
+ * @param len Length of data buffer
+ * @return Operation status
+ */
+OMNI_DRIVER_API int usart_hal_send(usart_num_t usart_num, const uint8_t *data, uint32_t len) {
+    omni_assert(usart_num < USART_NUM_MAX);
+    omni_assert_not_null(data);
+    omni_assert_non_zero(len);
+
+    usart_obj_t *obj = &usart_obj[usart_num];
+    usart_port_t *port = &usart_port[usart_num];
+    omni_assert_not_null(obj);
+
+    if (obj->status.tx_busy) {
+        return OMNI_BUSY;
+    }
+
+    // Prepare transfer data
+    obj->data.tx_buffer = (uint8_t *)data;
+    obj->data.tx_num = len;
+    obj->data.tx_count = 0;
+
+    obj->status.tx_busy = 1;
+    TRACE_RECORD(TRACE_EVENT_DRV_START, TRACE_DRV_USART | usart_num, len);
+
+    if (usart_hal_write(port->fd_out, data, len) != OMNI_OK) {
+        obj->status.tx_busy = 0;
+        return OMNI_FAIL;
+    }
+
+    port->tx_done = 1;
+    irq_hal_set_pending(obj->dev->irq_num);
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Read data from USART port
+ * 
+ * @param usart_num USART port number
+ * @param data Pointer to data buffer
+ * @param len Length of data buffer
+ * @return Operation status
+ */
+OMNI_DRIVER_API int usart_hal_receive(usart_num_t usart_num, void *data, uint32_t len) {
+    omni_assert(usart_num < USART_NUM_MAX);
+    omni_assert_not_null(data);
+    omni_assert_non_zero(len);
+
+    usart_obj_t *obj = &usart_obj[usart_num];
+    omni_assert_not_null(obj);
+
+    if (obj->status.rx_busy) {
+        return OMNI_BUSY;
+    }
+
+    // Prepare transfer data
+    obj->data.rx_buffer = (uint8_t *)data;
+    obj->data.rx_num = len;
+    obj->data.rx_count = 0;
+
+    // Clear error
+    obj->error = (usart_driver_error_t){0};
+
+    obj->status.rx_busy = 1;
+    TRACE_RECORD(TRACE_EVENT_DRV_START, TRACE_DRV_USART_RX | usart_num, len);
+
+    // Serve data already in the FIFO
+    irq_hal_set_pending(obj->dev->irq_num);
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Send a continuous stream from two buffers
+ *
+ * @note Not supported on the host, there is no DMA.
+ * @param usart_num USART port number
+ * @param buffer0 Pointer to first buffer
+ * @param buffer1 Pointer to second buffer
+ * @param len Length of each buffer
+ * @param cb Stream callback
+ * @return Operation status
+ */
+OMNI_DRIVER_API int usart_hal_stream_send(usart_num_t usart_num, void *buffer0, void *buffer1, uint32_t len, usart_stream_callback cb) {
+    omni_assert(usart_num < USART_NUM_MAX);
+
+    (void)buffer0;
+    (void)buffer1;
+    (void)len;
+    (void)cb;
+
+    return OMNI_FAIL;
+}
+
+/**
+ * @brief Receive a continuous stream into two buffers
+ *
+ * @note Not supported on the host, there is no DMA.
+ * @param usart_num USART port number
+ * @param buffer0 Pointer to first buffer
+ * @param buffer1 Pointer to second buffer
+ * @param len Length of each buffer
+ * @param cb Stream callback
+ * @return Operation status
+ */
+OMNI_DRIVER_API int usart_hal_stream_receive(usart_num_t usart_num, void *buffer0, void *buffer1, uint32_t len, usart_stream_callback cb) {
+    omni_assert(usart_num < USART_NUM_MAX);
+
+    (void)buffer0;
+    (void)buffer1;
+    (void)len;
+    (void)cb;
+
+    return OMNI_FAIL;
+}
+
+/**
+ * @brief Stop the send and receive streams
+ *
+ * @note Not supported on the host.
+ * @param usart_num USART port number
+ */
+OMNI_DRIVER_API void usart_hal_stream_stop(usart_num_t usart_num) {
+    omni_assert(usart_num < USART_NUM_MAX);
+}
+
+/**
+ * @brief Get USART port status
+ * 
+ * @param usart_num USART port number
+ * @return USART driver status
+ */
+OMNI_DRIVER_API usart_driver_status_t usart_hal_get_status(usart_num_t usart_num) {
+    omni_assert(usart_num < USART_NUM_MAX);
+
+    usart_obj_t *obj = &usart_obj[usart_num];
+    omni_assert_not_null(obj);
+
+    return obj->status;
+}
+
+/**
+ * @brief Get USART port error
+ * 
+ * @param usart_num USART port number
+ * @return USART driver error
+ */
+OMNI_DRIVER_API usart_driver_error_t usart_hal_get_error(usart_num_t usart_num) {
+    omni_assert(usart_num < USART_NUM_MAX);
+
+    usart_obj_t *obj = &usart_obj[usart_num];
+    omni_assert_not_null(obj);
+
+    return obj->error;
+}
+
+/********************* IRQ handlers **********************/
+/**
+ * @brief USART IRQ handler
+ */
+static void usart_hal_irq_request(usart_obj_t *obj) {
+    uint32_t event = 0;
+    uint32_t count;
+    omni_assert_not_null(obj);
+
+    usart_port_t *port = &usart_port[obj - usart_obj];
+
+    // Send complete, the data has been handed to the host device
+    if (port->tx_done) {
+        port->tx_done = 0;
+        obj->data.tx_count = obj->data.tx_num;
+        obj->status.tx_busy = 0;
+        event |= USART_EVENT_SEND_COMPLETE | USART_EVENT_TX_COMPLETE;
+    }
+
+    pthread_mutex_lock(&port->lock);
+    if (obj->status.rx_busy) {
+        count = usart_hal_fifo_read(port, obj->data.rx_buffer + obj->data.rx_count, \
+            obj->data.rx_num - obj->data.rx_count);
+        obj->data.rx_count += count;
+
+        if (obj->data.rx_count == obj->data.rx_num) {
+            // Clear RX busy flag
+            obj->status.rx_busy = 0;
+            // Set receive complete event
+            event |= USART_EVENT_RECEIVE_COMPLETE;
+        } else if ((count != 0) && (port->head == port->tail)) {
+            // Line idle after a burst
+            event |= USART_EVENT_RX_TIMEOUT;
+        }
+    }
+
+    // RX overrun error
+    if (port->overflow != 0) {
+        port->overflow = 0;
+        obj->error.rx_overflow = 1;
+        // Set RX overflow event
+        event |= USART_EVENT_RX_OVERFLOW;
+    }
+    pthread_mutex_unlock(&port->lock);
+
+#if defined(CONFIG_COMPONENT_TRACE)
+    if (event & USART_EVENT_TX_COMPLETE) {
+        TRACE_RECORD(TRACE_EVENT_DRV_COMPLETE, TRACE_DRV_USART | (uint32_t)(obj - usart_obj), 0);
+    }
+    if (event & USART_EVENT_RECEIVE_COMPLETE) {
+        TRACE_RECORD(TRACE_EVENT_DRV_COMPLETE, TRACE_DRV_USART_RX | (uint32_t)(obj - usart_obj), 0);
+    }
+    if (event & USART_EVENT_RX_OVERFLOW) {
+        TRACE_RECORD(TRACE_EVENT_DRV_ERROR, TRACE_DRV_USART_RX | (uint32_t)(obj - usart_obj), event);
+    }
+#endif /* CONFIG_COMPONENT_TRACE */
+
+    // Send event
+    if ((obj->event_cb != NULL) && (event != 0)) {
+        obj->event_cb(event);
+    }
+}
+
+#if (CONFIG_USART_NUM_1 == 1)
+/**
+ * @brief USART1 IRQ handler
+ */
+static void usart1_irq_handler(void) {
+    usart_hal_irq_request(&usart_obj[USART_NUM_1]);
+}
+#endif /* CONFIG_USART_NUM_1 */
+
+#if (CONFIG_USART_NUM_2 == 1)
+/**
+ * @brief USART2 IRQ handler
+ */
+static void usart2_irq_handler(void) {
+    usart_hal_irq_request(&usart_obj[USART_NUM_2]);
+}
+#endif /* CONFIG_USART_NUM_2 */
+
+#if (CONFIG_USART_NUM_3 == 1)
+/**
+ * @brief USART3 IRQ handler
+ */
+static void usart3_irq_handler(void) {
+    usart_hal_irq_request(&usart_obj[USART_NUM_3]);
+}
+#endif /* CONFIG_USART_NUM_3 */
+
+/**
+ * @brief Register USART IRQ
+ * 
+ * @param usart_num USART port number
+ */
+static void usart_hal_irq_register(usart_num_t usart_num) {
+    switch (usart_num) {
+#if (CONFIG_USART_NUM_1 == 1)
+        case USART_NUM_1:
+            irq_hal_register_handler(usart_obj[USART_NUM_1].dev->irq_num, usart1_irq_handler);
+            break;
+#endif /* (CONFIG_USART_NUM_1 == 1) */
+#if (CONFIG_USART_NUM_2 == 1)
+        case USART_NUM_2:
+            irq_hal_register_handler(usart_obj[USART_NUM_2].dev->irq_num, usart2_irq_handler);
+            break;
+#endif /* (CONFIG_USART_NUM_2 == 1) */
+#if (CONFIG_USART_NUM_3 == 1)
+        case USART_NUM_3:
+            irq_hal_register_handler(usart_obj[USART_NUM_3].dev->irq_num, usart3_irq_handler);
+            break;
+#endif /* (CONFIG_USART_NUM_3 == 1) */
+        default:
+            break;
+    }
+}
+
+/********************* Private functions **********************/
+
+/**
+ * @brief Open the host device of a port
+ * 
+ * @param port Pointer to host port
+ * @param path Device path, see omni_device_cfg.h
+ * @param usart_num USART port number
+ * @return Operation status
+ */
+static int usart_hal_open(usart_port_t *port, const char *path, usart_num_t usart_num) {
+    pthread_condattr_t attr;
+    int fd;
+
+    port->fd_in = USART_FD_NONE;
+    port->fd_out = USART_FD_NONE;
+    port->fd_slave = USART_FD_NONE;
+    port->head = 0;
+    port->tail = 0;
+    port->overflow = 0;
+    port->tx_done = 0;
+
+    pthread_mutex_init(&port->lock, NULL);
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&port->cond, &attr);
+    pthread_condattr_destroy(&attr);
+
+    if ((path == NULL) || (path[0] == '\0')) {
+        // Pseudo terminal, connect with a terminal program to the slave
+        fd = posix_openpt(O_RDWR | O_NOCTTY);
+        if ((fd < 0) || (grantpt(fd) != 0) || (unlockpt(fd) != 0)) {
+            if (fd >= 0) {
+                close(fd);
+            }
+            return OMNI_FAIL;
+        }
+
+        // Keep the slave open so that reads block instead of failing
+        // while no terminal program is connected
+        port->fd_slave = open(ptsname(fd), O_RDWR | O_NOCTTY);
+        if (port->fd_slave >= 0) {
+            struct termios tio;
+
+            tcgetattr(port->fd_slave, &tio);
+            cfmakeraw(&tio);
+            tcsetattr(port->fd_slave, TCSANOW, &tio);
+        }
+
+        port->fd_in = fd;
+        port->fd_out = fd;
+        fprintf(stderr, "omni: USART%u on %s\n", (unsigned int)usart_num + 1U, ptsname(fd));
+    } else if (strcmp(path, USART_STDIO_PATH) == 0) {
+        port->fd_in = STDIN_FILENO;
+        port->fd_out = STDOUT_FILENO;
+    } else {
+        fd = open(path, O_RDWR | O_NOCTTY);
+        if (fd < 0) {
+            return OMNI_FAIL;
+        }
+
+        port->fd_in = fd;
+        port->fd_out = fd;
+    }
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Close the host device of a port
+ * 
+ * @param port Pointer to host port
+ */
+static void usart_hal_close(usart_port_t *port) {
+    if ((port->fd_in != USART_FD_NONE) && (port->fd_in != STDIN_FILENO)) {
+        close(port->fd_in);
+    }
+
+    if (port->fd_slave != USART_FD_NONE) {
+        close(port->fd_slave);
+    }
+
+    port->fd_in = USART_FD_NONE;
+    port->fd_out = USART_FD_NONE;
+    port->fd_slave = USART_FD_NONE;
+}
+
+/**
+ * @brief Apply the line settings to a terminal device
+ * 
+ * @param fd Terminal descriptor
+ * @param config Pointer to driver configuration structure
+ */
+static void usart_hal_set_termios(int fd, usart_driver_config_t *config) {
+    struct termios tio;
+    speed_t speed;
+
+    if (tcgetattr(fd, &tio) != 0) {
+        return;
+    }
+
+    cfmakeraw(&tio);
+
+    switch (config->baudrate) {
+        case 9600:
+            speed = B9600;
+            break;
+        case 19200:
+            speed = B19200;
+            break;
+        case 38400:
+            speed = B38400;
+            break;
+        case 57600:
+            speed = B57600;
+            break;
+        case 230400:
+            speed = B230400;
+            break;
+        case 460800:
+            speed = B460800;
+            break;
+        case 921600:
+            speed = B921600;
+            break;
+        default:
+            speed = B115200;
+            break;
+    }
+    cfsetispeed(&tio, speed);
+    cfsetospeed(&tio, speed);
+
+    if (config->stop_bits == USART_STOP_BITS_2) {
+        tio.c_cflag |= CSTOPB;
+    } else {
+        tio.c_cflag &= ~CSTOPB;
+    }
+
+    tio.c_cflag &= ~(PARENB | PARODD);
+    if (config->parity == USART_PARITY_TYPE_EVEN) {
+        tio.c_cflag |= PARENB;
+    } else if (config->parity == USART_PARITY_TYPE_ODD) {
+        tio.c_cflag |= PARENB | PARODD;
+    }
+
+    if (config->flow_ctrl == USART_FLOW_CTRL_RTS_CTS) {
+        tio.c_cflag |= CRTSCTS;
+    } else {
+        tio.c_cflag &= ~CRTSCTS;
+    }
+
+    tcsetattr(fd, TCSANOW, &tio);
+}
+
+/**
+ * @brief Write all data to a descriptor
+ * 
+ * @param fd Descriptor
+ * @param data Pointer to data
+ * @param len Length of data
+ * @return Operation status
+ */
+static int usart_hal_write(int fd, const uint8_t *data, uint32_t len) {
+    ssize_t ret;
+
+    while (len > 0) {
+        ret = write(fd, data, len);
+        if (ret < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return OMNI_FAIL;
+        }
+
+        data += ret;
+        len -= (uint32_t)ret;
+    }
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Read from the RX FIFO, called with the port lock held
+ * 
+ * @param port Pointer to host port
+ * @param data Pointer to data buffer
+ * @param len Maximum number of bytes
+ * @return Number of bytes read
+ */
+static uint32_t usart_hal_fifo_read(usart_port_t *port, uint8_t *data, uint32_t len) {
+    uint32_t count = 0;
+
+    while ((count < len) && (port->tail != port->head)) {
+        data[count++] = port->fifo[port->tail & USART_FIFO_MASK];
+        port->tail++;
+    }
+
+    return count;
+}
+
+/**
+ * @brief Reader thread, moves received data into the RX FIFO
+ * 
+ * @param argument USART port number
+ * @return Always NULL
+ */
+static void *usart_hal_reader(void *argument) {
+    usart_num_t usart_num = (usart_num_t)(uintptr_t)argument;
+    usart_port_t *port = &usart_port[usart_num];
+    uint8_t buffer[USART_READ_SIZE];
+    ssize_t ret;
+
+    while (1) {
+        ret = read(port->fd_in, buffer, sizeof(buffer));
+        if (ret < 0) {
+            if ((errno == EINTR) || (errno == EAGAIN) || (errno == EIO)) {
+                // EIO while the far end of a terminal is closed
+                clock_hal_sleep_ns(10000000U);
+                continue;
+            }
+            break;
+        }
+
+        if (ret == 0) {
+            // End of file, stdin or a pipe was closed
+            break;
+        }
+
+        pthread_mutex_lock(&port->lock);
+        for (ssize_t i = 0; i < ret; i++) {
+            if ((port->head - port->tail) == CONFIG_USART_RX_FIFO_SIZE) {
+                port->overflow++;
+                continue;
+            }
+            port->fifo[port->head & USART_FIFO_MASK] = buffer[i];
+            port->head++;
+        }
+        pthread_cond_broadcast(&port->cond);
+        pthread_mutex_unlock(&port->lock);
+
+        irq_hal_set_pending(usart_obj[usart_num].dev->irq_num);
+    }
+
+    return NULL;
+}
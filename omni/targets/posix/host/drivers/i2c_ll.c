@@ -0,0 +1,63 @@
+/**
+  * @file    i2c_ll.c
+  * @author  LuckkMaker
+  * @brief   Low-level I2C configuration
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "ll/i2c_ll.h"
+
+#if (CONFIG_I2C_NUM_1 == 1)
+static i2c_dev_t i2c1_dev = {
+    .irq_num = I2C1_IRQn,
+    .irq_prio = CONFIG_I2C_IRQ_PRIO,
+};
+#endif /* (CONFIG_I2C_NUM_1 == 1) */
+
+#if (CONFIG_I2C_NUM_2 == 1)
+static i2c_dev_t i2c2_dev = {
+    .irq_num = I2C2_IRQn,
+    .irq_prio = CONFIG_I2C_IRQ_PRIO,
+};
+#endif /* (CONFIG_I2C_NUM_2 == 1) */
+
+/**
+ * @brief Get I2C device information
+ * 
+ * @param i2c_num I2C bus number
+ * @return I2C device information
+ */
+i2c_dev_t* i2c_ll_get_dev(i2c_num_t i2c_num) {
+    switch (i2c_num) {
+#if (CONFIG_I2C_NUM_1 == 1)
+        case I2C_NUM_1:
+            return &i2c1_dev;
+#endif /* (CONFIG_I2C_NUM_1 == 1) */
+
+#if (CONFIG_I2C_NUM_2 == 1)
+        case I2C_NUM_2:
+            return &i2c2_dev;
+#endif /* (CONFIG_I2C_NUM_2 == 1) */
+
+        default:
+            return NULL;
+    }
+
+    return NULL;
+}
@@ -0,0 +1,63 @@
+/**
+  * @file    spi_ll.c
+  * @author  LuckkMaker
+  * @brief   Low-level SPI configuration
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "ll/spi_ll.h"
+
+#if (CONFIG_SPI_NUM_1 == 1)
+static spi_dev_t spi1_dev = {
+    .irq_num = SPI1_IRQn,
+    .irq_prio = CONFIG_SPI_IRQ_PRIO,
+};
+#endif /* (CONFIG_SPI_NUM_1 == 1) */
+
+#if (CONFIG_SPI_NUM_2 == 1)
+static spi_dev_t spi2_dev = {
+    .irq_num = SPI2_IRQn,
+    .irq_prio = CONFIG_SPI_IRQ_PRIO,
+};
+#endif /* (CONFIG_SPI_NUM_2 == 1) */
+
+/**
+ * @brief Get SPI device information
+ * 
+ * @param spi_num SPI bus number
+ * @return SPI device information
+ */
+spi_dev_t* spi_ll_get_dev(spi_num_t spi_num) {
+    switch (spi_num) {
+#if (CONFIG_SPI_NUM_1 == 1)
+        case SPI_NUM_1:
+            return &spi1_dev;
+#endif /* (CONFIG_SPI_NUM_1 == 1) */
+
+#if (CONFIG_SPI_NUM_2 == 1)
+        case SPI_NUM_2:
+            return &spi2_dev;
+#endif /* (CONFIG_SPI_NUM_2 == 1) */
+
+        default:
+            return NULL;
+    }
+
+    return NULL;
+}
@@ -0,0 +1,75 @@
+/**
+  * @file    timer_ll.c
+  * @author  LuckkMaker
+  * @brief   Low-level timer configuration
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "ll/timer_ll.h"
+
+#if (CONFIG_TIMER_NUM_1 == 1)
+static timer_dev_t timer1_dev = {
+    .irq_num = TIM1_IRQn,
+    .irq_prio = CONFIG_TIMER_IRQ_PRIO,
+};
+#endif /* (CONFIG_TIMER_NUM_1 == 1) */
+
+#if (CONFIG_TIMER_NUM_2 == 1)
+static timer_dev_t timer2_dev = {
+    .irq_num = TIM2_IRQn,
+    .irq_prio = CONFIG_TIMER_IRQ_PRIO,
+};
+#endif /* (CONFIG_TIMER_NUM_2 == 1) */
+
+#if (CONFIG_TIMER_NUM_3 == 1)
+static timer_dev_t timer3_dev = {
+    .irq_num = TIM3_IRQn,
+    .irq_prio = CONFIG_TIMER_IRQ_PRIO,
+};
+#endif /* (CONFIG_TIMER_NUM_3 == 1) */
+
+/**
+ * @brief Get timer device information
+ * 
+ * @param timer_num Timer number
+ * @return timer device information
+ */
+timer_dev_t* timer_ll_get_dev(timer_num_t timer_num) {
+    switch (timer_num) {
+#if (CONFIG_TIMER_NUM_1 == 1)
+        case TIMER_NUM_1:
+            return &timer1_dev;
+#endif /* (CONFIG_TIMER_NUM_1 == 1) */
+
+#if (CONFIG_TIMER_NUM_2 == 1)
+        case TIMER_NUM_2:
+            return &timer2_dev;
+#endif /* (CONFIG_TIMER_NUM_2 == 1) */
+
+#if (CONFIG_TIMER_NUM_3 == 1)
+        case TIMER_NUM_3:
+            return &timer3_dev;
+#endif /* (CONFIG_TIMER_NUM_3 == 1) */
+
+        default:
+            return NULL;
+    }
+
+    return NULL;
+}
@@ -0,0 +1,78 @@
+/**
+  * @file    usart_ll.c
+  * @author  LuckkMaker
+  * @brief   Low-level USART configuration
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "ll/usart_ll.h"
+
+#if (CONFIG_USART_NUM_1 == 1)
+static usart_dev_t usart1_dev = {
+    .path = CONFIG_USART1_PATH,
+    .irq_num = USART1_IRQn,
+    .irq_prio = CONFIG_USART_IRQ_PRIO,
+};
+#endif /* (CONFIG_USART_NUM_1 == 1) */
+
+#if (CONFIG_USART_NUM_2 == 1)
+static usart_dev_t usart2_dev = {
+    .path = CONFIG_USART2_PATH,
+    .irq_num = USART2_IRQn,
+    .irq_prio = CONFIG_USART_IRQ_PRIO,
+};
+#endif /* (CONFIG_USART_NUM_2 == 1) */
+
+#if (CONFIG_USART_NUM_3 == 1)
+static usart_dev_t usart3_dev = {
+    .path = CONFIG_USART3_PATH,
+    .irq_num = USART3_IRQn,
+    .irq_prio = CONFIG_USART_IRQ_PRIO,
+};
+#endif /* (CONFIG_USART_NUM_3 == 1) */
+
+/**
+ * @brief Get USART device information
+ * 
+ * @param usart_num USART port number
+ * @return USART device information
+ */
+usart_dev_t* usart_ll_get_dev(usart_num_t usart_num) {
+    switch (usart_num) {
+#if (CONFIG_USART_NUM_1 == 1)
+        case USART_NUM_1:
+            return &usart1_dev;
+#endif /* (CONFIG_USART_NUM_1 == 1) */
+
+#if (CONFIG_USART_NUM_2 == 1)
+        case USART_NUM_2:
+            return &usart2_dev;
+#endif /* (CONFIG_USART_NUM_2 == 1) */
+
+#if (CONFIG_USART_NUM_3 == 1)
+        case USART_NUM_3:
+            return &usart3_dev;
+#endif /* (CONFIG_USART_NUM_3 == 1) */
+
+        default:
+            return NULL;
+    }
+
+    return NULL;
+}
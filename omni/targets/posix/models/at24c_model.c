@@ -0,0 +1,349 @@
+/**
+  * @file    at24c_model.c
+  * @author  LuckkMaker
+  * @brief   AT24Cxx I2C EEPROM model for the POSIX host target
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "models/at24c_model.h"
+#include "hal/clock_hal.h"
+
+// Parts up to 16 Kbit take one word address byte
+#define AT24C_SMALL_SIZE_MAX    2048U
+#define AT24C_BLOCK_SIZE        256U
+
+static bool at24c_model_start(void *context, i2c_dir_t direction);
+static uint32_t at24c_model_write(void *context, const uint8_t *data, uint32_t len);
+static void at24c_model_read(void *context, uint8_t *data, uint32_t len);
+static void at24c_model_stop(void *context);
+static uint32_t at24c_model_page_size(uint32_t size);
+static void at24c_model_update(at24c_model_t *model);
+
+/**
+ * @brief Initialize AT24C model
+ *
+ * @param model Pointer to model
+ * @param config Pointer to model configuration
+ * @return Operation status
+ */
+int at24c_model_init(at24c_model_t *model, const at24c_model_config_t *config) {
+    omni_assert_not_null(model);
+    omni_assert_not_null(config);
+
+    uint32_t page_size = config->page_size;
+
+    if ((config->size < 128U) || (config->size > 65536U) || ((config->size & (config->size - 1U)) != 0)) {
+        return OMNI_FAIL;
+    }
+
+    if (page_size == 0) {
+        page_size = at24c_model_page_size(config->size);
+    }
+    if ((page_size > AT24C_MODEL_PAGE_MAX) || (page_size > config->size) || ((page_size & (page_size - 1U)) != 0)) {
+        return OMNI_FAIL;
+    }
+
+    memset(model, 0, sizeof(at24c_model_t));
+    model->config = *config;
+    model->config.page_size = page_size;
+
+    if (model->config.memory == NULL) {
+        model->config.memory = (uint8_t *)OMNI_MALLOC(config->size);
+        if (model->config.memory == NULL) {
+            return OMNI_FAIL;
+        }
+        // Shipped erased
+        memset(model->config.memory, 0xFF, config->size);
+        model->allocated = true;
+    }
+
+    if (config->size <= AT24C_SMALL_SIZE_MAX) {
+        model->addr_len = 1U;
+        model->block_num = (config->size + AT24C_BLOCK_SIZE - 1U) / AT24C_BLOCK_SIZE;
+    } else {
+        model->addr_len = 2U;
+        model->block_num = 1U;
+    }
+
+    for (uint32_t i = 0; i < model->block_num; i++) {
+        at24c_model_block_t *block = &model->block[i];
+
+        block->model = model;
+        block->offset = i * AT24C_BLOCK_SIZE;
+        block->bus.context = block;
+        block->bus.addr = (uint16_t)(config->addr + i);
+        block->bus.start = at24c_model_start;
+        block->bus.write = at24c_model_write;
+        block->bus.read = at24c_model_read;
+        block->bus.stop = at24c_model_stop;
+    }
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Deinitialize AT24C model
+ *
+ * @note Detach the model from its bus first.
+ * @param model Pointer to model
+ */
+void at24c_model_deinit(at24c_model_t *model) {
+    omni_assert_not_null(model);
+
+    if (model->allocated) {
+        OMNI_FREE(model->config.memory);
+    }
+
+    memset(model, 0, sizeof(at24c_model_t));
+}
+
+/**
+ * @brief Attach AT24C model to an I2C bus
+ *
+ * @param model Pointer to model
+ * @param i2c_num I2C number
+ * @return Operation status
+ */
+int at24c_model_attach(at24c_model_t *model, i2c_num_t i2c_num) {
+    omni_assert_not_null(model);
+
+    for (uint32_t i = 0; i < model->block_num; i++) {
+        if (i2c_hal_attach(i2c_num, &model->block[i].bus) != OMNI_OK) {
+            while (i-- > 0U) {
+                i2c_hal_detach(i2c_num, &model->block[i].bus);
+            }
+            return OMNI_FAIL;
+        }
+    }
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Detach AT24C model from an I2C bus
+ *
+ * @param model Pointer to model
+ * @param i2c_num I2C number
+ * @return Operation status
+ */
+int at24c_model_detach(at24c_model_t *model, i2c_num_t i2c_num) {
+    omni_assert_not_null(model);
+
+    int ret = OMNI_OK;
+
+    for (uint32_t i = 0; i < model->block_num; i++) {
+        if (i2c_hal_detach(i2c_num, &model->block[i].bus) != OMNI_OK) {
+            ret = OMNI_FAIL;
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Check if a write cycle is running
+ *
+ * @param model Pointer to model
+ * @return True during tWR
+ */
+bool at24c_model_is_busy(at24c_model_t *model) {
+    omni_assert_not_null(model);
+
+    at24c_model_update(model);
+
+    return model->busy_until != 0U;
+}
+
+/**
+ * @brief Get AT24C model statistics
+ *
+ * @param model Pointer to model
+ * @return Statistics
+ */
+at24c_model_stats_t at24c_model_get_stats(at24c_model_t *model) {
+    omni_assert_not_null(model);
+
+    return model->stats;
+}
+
+/**
+ * @brief Reset AT24C model statistics
+ *
+ * @param model Pointer to model
+ */
+void at24c_model_reset_stats(at24c_model_t *model) {
+    omni_assert_not_null(model);
+
+    model->stats = (at24c_model_stats_t){0};
+}
+
+/********************* Bus callbacks **********************/
+
+/**
+ * @brief Start or repeated start addressing the device
+ *
+ * @param context Pointer to model block
+ * @param direction Transfer direction
+ * @return False to NACK during a write cycle
+ */
+static bool at24c_model_start(void *context, i2c_dir_t direction) {
+    at24c_model_block_t *block = (at24c_model_block_t *)context;
+    at24c_model_t *model = block->model;
+
+    at24c_model_update(model);
+
+    if (model->busy_until != 0U) {
+        model->stats.address_nack++;
+        return false;
+    }
+
+    if (direction == I2C_DIR_TRANSMITTER) {
+        model->addr_count = 0;
+        model->written = 0;
+    } else if (model->addr_len == 1U) {
+        // The device address selects the block of a current address read
+        model->addr = block->offset | (model->addr & (AT24C_BLOCK_SIZE - 1U));
+    }
+
+    return true;
+}
+
+/**
+ * @brief Bytes written by the master
+ *
+ * @param context Pointer to model block
+ * @param data Pointer to data
+ * @param len Number of bytes
+ * @return Number of bytes acknowledged
+ */
+static uint32_t at24c_model_write(void *context, const uint8_t *data, uint32_t len) {
+    at24c_model_block_t *block = (at24c_model_block_t *)context;
+    at24c_model_t *model = block->model;
+    uint32_t page_mask = model->config.page_size - 1U;
+
+    for (uint32_t i = 0; i < len; i++) {
+        if (model->addr_count < model->addr_len) {
+            // Word address
+            model->addr = (model->addr << 8) | data[i];
+            model->addr_count++;
+            if (model->addr_count == model->addr_len) {
+                if (model->addr_len == 1U) {
+                    model->addr = block->offset | data[i];
+                }
+                model->addr &= model->config.size - 1U;
+            }
+            continue;
+        }
+
+        if (model->written == 0U) {
+            model->page = model->addr & ~page_mask;
+            memset(model->dirty, 0, sizeof(model->dirty));
+        }
+
+        // The address counter rolls over inside the page
+        model->latch[model->addr & page_mask] = data[i];
+        model->dirty[model->addr & page_mask] = true;
+        model->addr = model->page | ((model->addr + 1U) & page_mask);
+        model->written++;
+        model->stats.write_bytes++;
+    }
+
+    return len;
+}
+
+/**
+ * @brief Bytes read by the master
+ *
+ * @param context Pointer to model block
+ * @param data Pointer to data
+ * @param len Number of bytes
+ */
+static void at24c_model_read(void *context, uint8_t *data, uint32_t len) {
+    at24c_model_block_t *block = (at24c_model_block_t *)context;
+    at24c_model_t *model = block->model;
+
+    for (uint32_t i = 0; i < len; i++) {
+        // Sequential reads roll over at the end of the array
+        data[i] = model->config.memory[model->addr & (model->config.size - 1U)];
+        model->addr = (model->addr + 1U) & (model->config.size - 1U);
+    }
+
+    model->stats.read_bytes += len;
+}
+
+/**
+ * @brief Stop condition, starts the write cycle
+ *
+ * @param context Pointer to model block
+ */
+static void at24c_model_stop(void *context) {
+    at24c_model_block_t *block = (at24c_model_block_t *)context;
+    at24c_model_t *model = block->model;
+
+    if (model->written == 0U) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < model->config.page_size; i++) {
+        if (model->dirty[i]) {
+            model->config.memory[model->page + i] = model->latch[i];
+        }
+    }
+
+    model->written = 0;
+    model->stats.write_cycle++;
+
+    if (model->config.write_time_us != 0U) {
+        model->busy_until = clock_hal_get_ns() + ((uint64_t)model->config.write_time_us * 1000U);
+    }
+}
+
+/********************* Private functions **********************/
+
+/**
+ * @brief Get default page size of a part
+ *
+ * @param size Capacity in bytes
+ * @return Page size in bytes
+ */
+static uint32_t at24c_model_page_size(uint32_t size) {
+    if (size <= 256U) {
+        return 8U;
+    } else if (size <= 2048U) {
+        return 16U;
+    } else if (size <= 8192U) {
+        return 32U;
+    } else if (size <= 32768U) {
+        return 64U;
+    }
+
+    return 128U;
+}
+
+/**
+ * @brief End a write cycle whose time has elapsed
+ *
+ * @param model Pointer to model
+ */
+static void at24c_model_update(at24c_model_t *model) {
+    if ((model->busy_until != 0U) && (clock_hal_get_ns() >= model->busy_until)) {
+        model->busy_until = 0;
+    }
+}
@@ -0,0 +1,115 @@
+/**
+  * @file    at24c_model.h
+  * @author  LuckkMaker
+  * @brief   Header for at24c_model.c file
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef OMNI_MODEL_AT24C_H
+#define OMNI_MODEL_AT24C_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "hal/i2c_hal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Behavioral model of an Atmel/Microchip AT24Cxx I2C EEPROM.
+ *
+ * - AT24C01 to AT24C16 take one word address byte, the upper address bits
+ *   of the 4, 8 and 16 Kbit parts select the device address, so these
+ *   answer on 2, 4 or 8 consecutive addresses. AT24C32 and larger take
+ *   two address bytes.
+ * - Page writes wrap at the page boundary, bytes beyond a page overwrite
+ *   the start of the same page.
+ * - The write cycle starts at STOP and lasts tWR, the device does not
+ *   acknowledge its address until it ends (ACK polling).
+ * - Sequential reads roll over at the end of the array.
+ */
+
+#define AT24C_MODEL_BLOCK_MAX   8U
+#define AT24C_MODEL_PAGE_MAX    128U
+
+/**
+ * @brief AT24C model configuration
+ */
+typedef struct at24c_model_config {
+    uint32_t size;                  /**< Capacity in bytes, power of two from 128 to 65536 */
+    uint32_t page_size;             /**< Page size in bytes, 0 for the part default */
+    uint16_t addr;                  /**< Device address of the first block */
+    uint32_t write_time_us;         /**< Write cycle time tWR, 0 for none */
+    uint8_t *memory;                /**< Backing memory of size bytes, allocated if NULL */
+} at24c_model_config_t;
+
+/**
+ * @brief AT24C model statistics
+ */
+typedef struct at24c_model_stats {
+    uint32_t write_cycle;           /**< Page write cycles */
+    uint32_t address_nack;          /**< Addressing attempts refused during a write cycle */
+    uint64_t read_bytes;            /**< Bytes read */
+    uint64_t write_bytes;           /**< Data bytes written */
+} at24c_model_stats_t;
+
+struct at24c_model;
+
+/**
+ * @brief Device address of an AT24C model
+ */
+typedef struct at24c_model_block {
+    i2c_hal_model_t bus;            /**< Attached to the I2C bus */
+    struct at24c_model *model;
+    uint32_t offset;                /**< Memory offset selected by the address */
+} at24c_model_block_t;
+
+/**
+ * @brief AT24C model
+ */
+typedef struct at24c_model {
+    at24c_model_block_t block[AT24C_MODEL_BLOCK_MAX];
+    uint32_t block_num;
+    at24c_model_config_t config;
+    bool allocated;                 /**< Backing memory owned by the model */
+    uint32_t addr_len;              /**< Word address bytes */
+    uint64_t busy_until;            /**< End of the write cycle */
+    /* Transfer in progress */
+    uint32_t addr;                  /**< Address counter */
+    uint32_t addr_count;            /**< Word address bytes received */
+    uint32_t page;                  /**< Page of the pending write */
+    uint32_t written;               /**< Data bytes of the pending write */
+    uint8_t latch[AT24C_MODEL_PAGE_MAX];
+    bool dirty[AT24C_MODEL_PAGE_MAX];
+    at24c_model_stats_t stats;
+} at24c_model_t;
+
+int at24c_model_init(at24c_model_t *model, const at24c_model_config_t *config);
+void at24c_model_deinit(at24c_model_t *model);
+int at24c_model_attach(at24c_model_t *model, i2c_num_t i2c_num);
+int at24c_model_detach(at24c_model_t *model, i2c_num_t i2c_num);
+bool at24c_model_is_busy(at24c_model_t *model);
+at24c_model_stats_t at24c_model_get_stats(at24c_model_t *model);
+void at24c_model_reset_stats(at24c_model_t *model);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* OMNI_MODEL_AT24C_H */
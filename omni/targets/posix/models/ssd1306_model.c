@@ -0,0 +1,456 @@
+/**
+  * @file    ssd1306_model.c
+  * @author  LuckkMaker
+  * @brief   SSD1306 OLED controller model for the POSIX host target
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "models/ssd1306_model.h"
+#include "drivers/display/ssd1306_types.h"
+
+#define SSD1306_CONTROL_CO      0x80U
+#define SSD1306_CONTROL_DC      0x40U
+
+#define SSD1306_LINES           64U
+
+static bool ssd1306_model_start(void *context, i2c_dir_t direction);
+static uint32_t ssd1306_model_write(void *context, const uint8_t *data, uint32_t len);
+static void ssd1306_model_read(void *context, uint8_t *data, uint32_t len);
+static void ssd1306_model_command(ssd1306_model_t *model, uint8_t byte);
+static void ssd1306_model_execute(ssd1306_model_t *model);
+static void ssd1306_model_data(ssd1306_model_t *model, uint8_t byte);
+static uint32_t ssd1306_model_param_num(uint8_t cmd);
+
+/**
+ * @brief Initialize SSD1306 model
+ *
+ * @note Registers start with their reset values, GDDRAM is cleared.
+ * @param model Pointer to model
+ * @param config Pointer to model configuration
+ * @return Operation status
+ */
+int ssd1306_model_init(ssd1306_model_t *model, const ssd1306_model_config_t *config) {
+    omni_assert_not_null(model);
+    omni_assert_not_null(config);
+
+    if ((config->height != 32U) && (config->height != 64U)) {
+        return OMNI_FAIL;
+    }
+
+    memset(model, 0, sizeof(ssd1306_model_t));
+    model->config = *config;
+
+    model->mode = SSD1306_SET_MEMORY_ADDR_PAGE;
+    model->col_end = SSD1306_MODEL_WIDTH - 1U;
+    model->page_end = SSD1306_MODEL_PAGES - 1U;
+    model->contrast = 0x7F;
+    model->mux = SSD1306_LINES - 1U;
+
+    model->bus.context = model;
+    model->bus.addr = config->addr;
+    model->bus.start = ssd1306_model_start;
+    model->bus.write = ssd1306_model_write;
+    model->bus.read = ssd1306_model_read;
+    model->bus.stop = NULL;
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Attach SSD1306 model to an I2C bus
+ *
+ * @param model Pointer to model
+ * @param i2c_num I2C number
+ * @return Operation status
+ */
+int ssd1306_model_attach(ssd1306_model_t *model, i2c_num_t i2c_num) {
+    omni_assert_not_null(model);
+
+    return i2c_hal_attach(i2c_num, &model->bus);
+}
+
+/**
+ * @brief Detach SSD1306 model from an I2C bus
+ *
+ * @param model Pointer to model
+ * @param i2c_num I2C number
+ * @return Operation status
+ */
+int ssd1306_model_detach(ssd1306_model_t *model, i2c_num_t i2c_num) {
+    omni_assert_not_null(model);
+
+    return i2c_hal_detach(i2c_num, &model->bus);
+}
+
+/**
+ * @brief Get pixel as shown on the panel
+ *
+ * @param model Pointer to model
+ * @param x Column, 0 is the left edge
+ * @param y Row, 0 is the top edge
+ * @return 1 if the pixel is lit
+ */
+uint32_t ssd1306_model_get_pixel(ssd1306_model_t *model, uint32_t x, uint32_t y) {
+    omni_assert_not_null(model);
+
+    uint32_t com;
+    uint32_t line;
+    uint32_t seg;
+    uint32_t pixel;
+
+    if (!model->display_on || (x >= SSD1306_MODEL_WIDTH) || (y >= model->config.height) || (y > model->mux)) {
+        return 0;
+    }
+
+    if (model->entire_on) {
+        return 1;
+    }
+
+    // Row y is driven by COM y, or COM[N-1-y] with the scan direction flipped
+    com = model->com_flip ? (model->mux - y) : y;
+    line = (com + model->start_line + model->offset) % SSD1306_LINES;
+    seg = model->seg_remap ? (SSD1306_MODEL_WIDTH - 1U - x) : x;
+
+    pixel = (model->ram[line / 8U][seg] >> (line % 8U)) & 1U;
+
+    return model->inverse ? (pixel ^ 1U) : pixel;
+}
+
+/**
+ * @brief Dump the panel as text, one character per pixel
+ *
+ * @param model Pointer to model
+ * @param print Print function
+ */
+void ssd1306_model_dump(ssd1306_model_t *model, ssd1306_model_print_t print) {
+    omni_assert_not_null(model);
+    omni_assert_not_null(print);
+
+    char line[SSD1306_MODEL_WIDTH + 1U];
+
+    for (uint32_t y = 0; y < model->config.height; y++) {
+        for (uint32_t x = 0; x < SSD1306_MODEL_WIDTH; x++) {
+            line[x] = ssd1306_model_get_pixel(model, x, y) ? '#' : '.';
+        }
+        line[SSD1306_MODEL_WIDTH] = '\0';
+        print("%s\n", line);
+    }
+}
+
+/**
+ * @brief Get SSD1306 model statistics
+ *
+ * @param model Pointer to model
+ * @return Statistics
+ */
+ssd1306_model_stats_t ssd1306_model_get_stats(ssd1306_model_t *model) {
+    omni_assert_not_null(model);
+
+    return model->stats;
+}
+
+/**
+ * @brief Reset SSD1306 model statistics
+ *
+ * @param model Pointer to model
+ */
+void ssd1306_model_reset_stats(ssd1306_model_t *model) {
+    omni_assert_not_null(model);
+
+    model->stats = (ssd1306_model_stats_t){0};
+}
+
+/********************* Bus callbacks **********************/
+
+/**
+ * @brief Start addressing the controller
+ *
+ * @param context Pointer to model
+ * @param direction Transfer direction
+ * @return Always true
+ */
+static bool ssd1306_model_start(void *context, i2c_dir_t direction) {
+    ssd1306_model_t *model = (ssd1306_model_t *)context;
+
+    UNUSED(direction);
+
+    // Every transfer begins with a control byte
+    model->control = true;
+    model->stats.transfers++;
+
+    return true;
+}
+
+/**
+ * @brief Bytes written by the master
+ *
+ * @param context Pointer to model
+ * @param data Pointer to data
+ * @param len Number of bytes
+ * @return Number of bytes acknowledged
+ */
+static uint32_t ssd1306_model_write(void *context, const uint8_t *data, uint32_t len) {
+    ssd1306_model_t *model = (ssd1306_model_t *)context;
+
+    model->stats.bus_bytes += len;
+
+    for (uint32_t i = 0; i < len; i++) {
+        if (model->control) {
+            model->co = (data[i] & SSD1306_CONTROL_CO) != 0U;
+            model->dc = (data[i] & SSD1306_CONTROL_DC) != 0U;
+            model->control = false;
+            continue;
+        }
+
+        if (model->dc) {
+            ssd1306_model_data(model, data[i]);
+        } else {
+            ssd1306_model_command(model, data[i]);
+        }
+
+        // With Co set a single byte follows each control byte
+        if (model->co) {
+            model->control = true;
+        }
+    }
+
+    return len;
+}
+
+/**
+ * @brief Bytes read by the master
+ *
+ * @param context Pointer to model
+ * @param data Pointer to data
+ * @param len Number of bytes
+ */
+static void ssd1306_model_read(void *context, uint8_t *data, uint32_t len) {
+    ssd1306_model_t *model = (ssd1306_model_t *)context;
+
+    memset(data, model->display_on ? 0x00 : SSD1306_STATUS_DISPLAY_OFF, len);
+    model->stats.bus_bytes += len;
+}
+
+/********************* Private functions **********************/
+
+/**
+ * @brief Collect a command byte
+ *
+ * @param model Pointer to model
+ * @param byte Command or parameter byte
+ */
+static void ssd1306_model_command(ssd1306_model_t *model, uint8_t byte) {
+    model->stats.cmd_bytes++;
+
+    if (model->cmd_need == 0U) {
+        model->cmd[0] = byte;
+        model->cmd_len = 1U;
+        model->cmd_need = ssd1306_model_param_num(byte);
+    } else {
+        model->cmd[model->cmd_len++] = byte;
+        model->cmd_need--;
+    }
+
+    if (model->cmd_need == 0U) {
+        ssd1306_model_execute(model);
+    }
+}
+
+/**
+ * @brief Execute a complete command
+ *
+ * @param model Pointer to model
+ */
+static void ssd1306_model_execute(ssd1306_model_t *model) {
+    uint8_t cmd = model->cmd[0];
+
+    if (cmd <= (SSD1306_SET_LOWER_COL_START_ADDR | SSD1306_SET_LOWER_COL_START_ADDR_MASK)) {
+        model->page_col = (uint8_t)((model->page_col & 0xF0U) | (cmd & SSD1306_SET_LOWER_COL_START_ADDR_MASK));
+        model->col = model->page_col;
+        return;
+    }
+
+    if ((cmd >= SSD1306_SET_HIGHER_COL_START_ADDR) && \
+        (cmd <= (SSD1306_SET_HIGHER_COL_START_ADDR | SSD1306_SET_HIGHER_COL_START_ADDR_MASK))) {
+        model->page_col = (uint8_t)(((cmd & 0x07U) << 4) | (model->page_col & 0x0FU));
+        model->col = model->page_col;
+        return;
+    }
+
+    if ((cmd >= SSD1306_SET_DISPLAY_START_LINE) && \
+        (cmd <= (SSD1306_SET_DISPLAY_START_LINE | SSD1306_SET_DISPLAY_START_LINE_MASK))) {
+        model->start_line = cmd & SSD1306_SET_DISPLAY_START_LINE_MASK;
+        return;
+    }
+
+    if ((cmd >= SSD1306_SET_PAGE_START_ADDR) && \
+        (cmd <= (SSD1306_SET_PAGE_START_ADDR | SSD1306_SET_PAGE_START_ADDR_MASK))) {
+        model->page = cmd & SSD1306_SET_PAGE_START_ADDR_MASK;
+        return;
+    }
+
+    switch (cmd) {
+        case SSD1306_SET_CONTRAST_CONTROL:
+            model->contrast = model->cmd[1];
+            break;
+
+        case SSD1306_ENTIRE_DISPLAY_RESUME:
+        case SSD1306_ENTIRE_DISPLAY_ON:
+            model->entire_on = (cmd == SSD1306_ENTIRE_DISPLAY_ON);
+            break;
+
+        case SSD1306_SET_NORMAL_DISPLAY:
+        case SSD1306_SET_INVERSE_DISPLAY:
+            model->inverse = (cmd == SSD1306_SET_INVERSE_DISPLAY);
+            break;
+
+        case SSD1306_SET_DISPLAY_OFF:
+        case SSD1306_SET_DISPLAY_ON:
+            model->display_on = (cmd == SSD1306_SET_DISPLAY_ON);
+            break;
+
+        case SSD1306_SET_MEMORY_ADDR_MODE:
+            // 11b is invalid and ignored
+            if ((model->cmd[1] & 0x03U) <= SSD1306_SET_MEMORY_ADDR_PAGE) {
+                model->mode = model->cmd[1] & 0x03U;
+            }
+            break;
+
+        case SSD1306_SET_COLUMN_ADDR:
+            model->col_start = model->cmd[1] & 0x7FU;
+            model->col_end = model->cmd[2] & 0x7FU;
+            model->col = model->col_start;
+            break;
+
+        case SSD1306_SET_PAGE_ADDR:
+            model->page_start = model->cmd[1] & 0x07U;
+            model->page_end = model->cmd[2] & 0x07U;
+            model->page = model->page_start;
+            break;
+
+        case SSD1306_SET_SEGMENT_MAP_NORMAL:
+        case SSD1306_SET_SEGMENT_MAP_REMAP:
+            model->seg_remap = (cmd == SSD1306_SET_SEGMENT_MAP_REMAP);
+            break;
+
+        case SSD1306_SET_MULTIPLEX_RATIO:
+            // Values below 15 are invalid
+            if ((model->cmd[1] & 0x3FU) >= 15U) {
+                model->mux = model->cmd[1] & 0x3FU;
+            }
+            break;
+
+        case SSD1306_SET_COM_OUTPUT_SCAN_DIR_NORMAL:
+        case SSD1306_SET_COM_OUTPUT_SCAN_DIR_FLIP:
+            model->com_flip = (cmd == SSD1306_SET_COM_OUTPUT_SCAN_DIR_FLIP);
+            break;
+
+        case SSD1306_SET_DISPLAY_OFFSET:
+            model->offset = model->cmd[1] & 0x3FU;
+            break;
+
+        case SSD1306_SET_CHARGE_PUMP:
+            model->charge_pump = (model->cmd[1] & 0x04U) != 0U;
+            break;
+
+        default:
+            // Timing, scrolling and NOP commands do not change the GDDRAM
+            break;
+    }
+}
+
+/**
+ * @brief Write a GDDRAM byte and advance the address pointers
+ *
+ * @param model Pointer to model
+ * @param byte Data byte, one column of eight rows
+ */
+static void ssd1306_model_data(ssd1306_model_t *model, uint8_t byte) {
+    uint8_t *cell = &model->ram[model->page][model->col];
+
+    if (*cell == byte) {
+        model->stats.unchanged_bytes++;
+    }
+    *cell = byte;
+    model->stats.data_bytes++;
+
+    switch (model->mode) {
+        case SSD1306_SET_MEMORY_ADDR_HORIZ:
+            if (model->col == model->col_end) {
+                model->col = model->col_start;
+                model->page = (model->page == model->page_end) ? model->page_start : ((model->page + 1U) & 0x07U);
+            } else {
+                model->col = (model->col + 1U) & 0x7FU;
+            }
+            break;
+
+        case SSD1306_SET_MEMORY_ADDR_VERT:
+            if (model->page == model->page_end) {
+                model->page = model->page_start;
+                model->col = (model->col == model->col_end) ? model->col_start : ((model->col + 1U) & 0x7FU);
+            } else {
+                model->page = (model->page + 1U) & 0x07U;
+            }
+            break;
+
+        case SSD1306_SET_MEMORY_ADDR_PAGE:
+        default:
+            // The page pointer does not move in page addressing mode
+            model->col = (model->col == (SSD1306_MODEL_WIDTH - 1U)) ? model->page_col : (model->col + 1U);
+            break;
+    }
+}
+
+/**
+ * @brief Get number of parameter bytes of a command
+ *
+ * @param cmd Command byte
+ * @return Number of parameter bytes
+ */
+static uint32_t ssd1306_model_param_num(uint8_t cmd) {
+    switch (cmd) {
+        case SSD1306_SET_CONTRAST_CONTROL:
+        case SSD1306_SET_MEMORY_ADDR_MODE:
+        case SSD1306_SET_MULTIPLEX_RATIO:
+        case SSD1306_SET_DISPLAY_OFFSET:
+        case SSD1306_SET_COM_PINS_HW_CONFIG:
+        case SSD1306_SET_DISPLAY_CLOCK_DIV:
+        case SSD1306_SET_PRECHARGE_PERIOD:
+        case SSD1306_SET_VCOMH_DESELECT_LEVEL:
+        case SSD1306_SET_CHARGE_PUMP:
+            return 1U;
+
+        case SSD1306_SET_COLUMN_ADDR:
+        case SSD1306_SET_PAGE_ADDR:
+        case SSD1306_SET_VERT_SCROLL_AREA:
+            return 2U;
+
+        case SSD1306_VERT_RIGHT_HORIZ_SCROLL:
+        case SSD1306_VERT_LEFT_HORIZ_SCROLL:
+            return 5U;
+
+        case SSD1306_RIGHT_HORIZ_SCROLL:
+        case SSD1306_LEFT_HORIZ_SCROLL:
+            return 6U;
+
+        default:
+            return 0U;
+    }
+}
@@ -0,0 +1,125 @@
+/**
+  * @file    ssd1306_model.h
+  * @author  LuckkMaker
+  * @brief   Header for ssd1306_model.c file
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef OMNI_MODEL_SSD1306_H
+#define OMNI_MODEL_SSD1306_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "hal/i2c_hal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Behavioral model of a SSD1306 OLED controller on I2C.
+ *
+ * - Control bytes (Co, D/C#) select single commands or data and streams.
+ * - Page, horizontal and vertical addressing with the column and page
+ *   windows of 21h/22h wrap exactly as the GDDRAM pointers of the part.
+ * - Segment remap, COM scan direction, start line, display offset,
+ *   inverse and entire display on are applied by ssd1306_model_get_pixel().
+ * - Reads return the status byte.
+ *
+ * Scrolling commands are accepted but not animated. The statistics count
+ * the bytes that cross the bus, unchanged_bytes the data bytes that wrote
+ * what the GDDRAM already held.
+ */
+
+#define SSD1306_MODEL_WIDTH     128U
+#define SSD1306_MODEL_PAGES     8U
+
+/**
+ * @brief SSD1306 model configuration
+ */
+typedef struct ssd1306_model_config {
+    uint16_t addr;                  /**< Device address, 0x3C or 0x3D */
+    uint32_t height;                /**< Panel height in pixels, 32 or 64 */
+} ssd1306_model_config_t;
+
+/**
+ * @brief SSD1306 model statistics
+ */
+typedef struct ssd1306_model_stats {
+    uint32_t transfers;             /**< Addressed transfers */
+    uint64_t bus_bytes;             /**< Bytes after the address, control bytes included */
+    uint64_t cmd_bytes;             /**< Command and parameter bytes */
+    uint64_t data_bytes;            /**< GDDRAM bytes written */
+    uint64_t unchanged_bytes;       /**< GDDRAM bytes written with the value they held */
+} ssd1306_model_stats_t;
+
+/**
+ * @brief SSD1306 model
+ */
+typedef struct ssd1306_model {
+    i2c_hal_model_t bus;            /**< Attached to the I2C bus */
+    ssd1306_model_config_t config;
+    uint8_t ram[SSD1306_MODEL_PAGES][SSD1306_MODEL_WIDTH];
+    /* Address pointers */
+    uint8_t mode;                   /**< Memory addressing mode */
+    uint8_t col;
+    uint8_t page;
+    uint8_t col_start;
+    uint8_t col_end;
+    uint8_t page_start;
+    uint8_t page_end;
+    uint8_t page_col;               /**< Column start of page addressing mode */
+    /* Display settings */
+    bool display_on;
+    bool entire_on;
+    bool inverse;
+    bool seg_remap;
+    bool com_flip;
+    uint8_t contrast;
+    uint8_t start_line;
+    uint8_t offset;
+    uint8_t mux;                    /**< Multiplex ratio */
+    bool charge_pump;
+    /* Transfer in progress */
+    bool control;                   /**< Next byte is a control byte */
+    bool co;                        /**< Continuation bit of the last control byte */
+    bool dc;                        /**< Data or command of the last control byte */
+    uint8_t cmd[8];
+    uint32_t cmd_len;
+    uint32_t cmd_need;              /**< Parameter bytes still expected */
+    ssd1306_model_stats_t stats;
+} ssd1306_model_t;
+
+/**
+ * @brief Print function used to dump the panel
+ */
+typedef int (*ssd1306_model_print_t)(const char *format, ...);
+
+int ssd1306_model_init(ssd1306_model_t *model, const ssd1306_model_config_t *config);
+int ssd1306_model_attach(ssd1306_model_t *model, i2c_num_t i2c_num);
+int ssd1306_model_detach(ssd1306_model_t *model, i2c_num_t i2c_num);
+uint32_t ssd1306_model_get_pixel(ssd1306_model_t *model, uint32_t x, uint32_t y);
+void ssd1306_model_dump(ssd1306_model_t *model, ssd1306_model_print_t print);
+ssd1306_model_stats_t ssd1306_model_get_stats(ssd1306_model_t *model);
+void ssd1306_model_reset_stats(ssd1306_model_t *model);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* OMNI_MODEL_SSD1306_H */
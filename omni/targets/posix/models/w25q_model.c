@@ -0,0 +1,556 @@
+/**
+  * @file    w25q_model.c
+  * @author  LuckkMaker
+  * @brief   W25Qxx serial NOR flash model for the POSIX host target
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "models/w25q_model.h"
+#include "hal/clock_hal.h"
+
+#define W25Q_MANUFACTURER_ID    0xEFU
+#define W25Q_MEMORY_TYPE        0x40U
+
+#define W25Q_SR1_BUSY           0x01U
+#define W25Q_SR1_WEL            0x02U
+#define W25Q_SR3_ADS            0x01U
+
+// Bits written by the write status register commands
+#define W25Q_SR1_WRITE_MASK     0xFCU
+#define W25Q_SR2_WRITE_MASK     0x7BU
+#define W25Q_SR3_WRITE_MASK     0x66U
+
+#define W25Q_INS_WRITE_ENABLE       0x06U
+#define W25Q_INS_WRITE_DISABLE      0x04U
+#define W25Q_INS_READ_STATUS_REG1   0x05U
+#define W25Q_INS_READ_STATUS_REG2   0x35U
+#define W25Q_INS_READ_STATUS_REG3   0x15U
+#define W25Q_INS_WRITE_STATUS_REG1  0x01U
+#define W25Q_INS_WRITE_STATUS_REG2  0x31U
+#define W25Q_INS_WRITE_STATUS_REG3  0x11U
+#define W25Q_INS_READ_DATA          0x03U
+#define W25Q_INS_FAST_READ_DATA     0x0BU
+#define W25Q_INS_PAGE_PROGRAM       0x02U
+#define W25Q_INS_SECTOR_ERASE       0x20U
+#define W25Q_INS_BLOCK_ERASE_32K    0x52U
+#define W25Q_INS_BLOCK_ERASE_64K    0xD8U
+#define W25Q_INS_CHIP_ERASE         0xC7U
+#define W25Q_INS_CHIP_ERASE_ALT     0x60U
+#define W25Q_INS_POWER_DOWN         0xB9U
+#define W25Q_INS_RELEASE_POWER_DOWN 0xABU
+#define W25Q_INS_MANUFACTURER_ID    0x90U
+#define W25Q_INS_JEDEC_ID           0x9FU
+#define W25Q_INS_ENTER_4BYTE        0xB7U
+#define W25Q_INS_EXIT_4BYTE         0xE9U
+
+// Typical times of the W25Q64JV in microseconds
+#define W25Q_TIME_PAGE_PROGRAM_US   400U
+#define W25Q_TIME_SECTOR_ERASE_US   45000U
+#define W25Q_TIME_BLOCK_32K_US      120000U
+#define W25Q_TIME_BLOCK_64K_US      150000U
+#define W25Q_TIME_CHIP_ERASE_US     20000000U
+#define W25Q_TIME_WRITE_SR_US       10000U
+
+#define W25Q_CHIP_ERASE_REF_SIZE    (8U * 1024U * 1024U)
+
+static void w25q_model_select(void *context, bool selected);
+static void w25q_model_transfer(void *context, const uint8_t *tx, uint8_t *rx, uint32_t len);
+static uint8_t w25q_model_clock(w25q_model_t *model, uint8_t in);
+static void w25q_model_command(w25q_model_t *model, uint8_t cmd);
+static void w25q_model_execute(w25q_model_t *model);
+static void w25q_model_erase(w25q_model_t *model, uint32_t size, uint32_t time_us);
+static void w25q_model_set_busy(w25q_model_t *model, uint64_t time_us);
+static void w25q_model_update(w25q_model_t *model);
+static uint32_t w25q_model_addr_len(w25q_model_t *model);
+
+/**
+ * @brief Initialize W25Q model
+ *
+ * @param model Pointer to model
+ * @param config Pointer to model configuration
+ * @return Operation status
+ */
+int w25q_model_init(w25q_model_t *model, const w25q_model_config_t *config) {
+    omni_assert_not_null(model);
+    omni_assert_not_null(config);
+
+    uint8_t capacity = 0;
+
+    if ((config->size == 0) || ((config->size & (config->size - 1U)) != 0)) {
+        return OMNI_FAIL;
+    }
+
+    while ((1UL << capacity) < config->size) {
+        capacity++;
+    }
+    if ((capacity < 20U) || (capacity > 25U)) {
+        return OMNI_FAIL;
+    }
+
+    memset(model, 0, sizeof(w25q_model_t));
+    model->config = *config;
+    model->capacity = capacity;
+
+    if (model->config.memory == NULL) {
+        model->config.memory = (uint8_t *)OMNI_MALLOC(config->size);
+        if (model->config.memory == NULL) {
+            return OMNI_FAIL;
+        }
+        // Erased state
+        memset(model->config.memory, 0xFF, config->size);
+        model->allocated = true;
+    }
+
+    model->bus.context = model;
+    model->bus.cs_pin = config->cs_pin;
+    model->bus.select = w25q_model_select;
+    model->bus.transfer = w25q_model_transfer;
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Deinitialize W25Q model
+ *
+ * @note Detach the model from its bus first.
+ * @param model Pointer to model
+ */
+void w25q_model_deinit(w25q_model_t *model) {
+    omni_assert_not_null(model);
+
+    if (model->allocated) {
+        OMNI_FREE(model->config.memory);
+    }
+
+    memset(model, 0, sizeof(w25q_model_t));
+}
+
+/**
+ * @brief Attach W25Q model to a SPI bus
+ *
+ * @param model Pointer to model
+ * @param spi_num SPI number
+ * @return Operation status
+ */
+int w25q_model_attach(w25q_model_t *model, spi_num_t spi_num) {
+    omni_assert_not_null(model);
+
+    return spi_hal_attach(spi_num, &model->bus);
+}
+
+/**
+ * @brief Detach W25Q model from a SPI bus
+ *
+ * @param model Pointer to model
+ * @param spi_num SPI number
+ * @return Operation status
+ */
+int w25q_model_detach(w25q_model_t *model, spi_num_t spi_num) {
+    omni_assert_not_null(model);
+
+    return spi_hal_detach(spi_num, &model->bus);
+}
+
+/**
+ * @brief Check if a program or erase cycle is running
+ *
+ * @param model Pointer to model
+ * @return True while BUSY is set
+ */
+bool w25q_model_is_busy(w25q_model_t *model) {
+    omni_assert_not_null(model);
+
+    w25q_model_update(model);
+
+    return (model->sr[0] & W25Q_SR1_BUSY) != 0U;
+}
+
+/**
+ * @brief Get W25Q model statistics
+ *
+ * @param model Pointer to model
+ * @return Statistics
+ */
+w25q_model_stats_t w25q_model_get_stats(w25q_model_t *model) {
+    omni_assert_not_null(model);
+
+    return model->stats;
+}
+
+/**
+ * @brief Reset W25Q model statistics
+ *
+ * @param model Pointer to model
+ */
+void w25q_model_reset_stats(w25q_model_t *model) {
+    omni_assert_not_null(model);
+
+    model->stats = (w25q_model_stats_t){0};
+}
+
+/********************* Bus callbacks **********************/
+
+/**
+ * @brief Chip select changed
+ *
+ * @param context Pointer to model
+ * @param selected True when CS is low
+ */
+static void w25q_model_select(void *context, bool selected) {
+    w25q_model_t *model = (w25q_model_t *)context;
+
+    if (selected) {
+        model->selected = true;
+        model->count = 0;
+        model->addr = 0;
+        model->ignore = false;
+        return;
+    }
+
+    // Write, erase and mode commands take effect on the rising edge of CS
+    if (model->selected && (model->count > 0U) && !model->ignore) {
+        w25q_model_execute(model);
+    }
+    model->selected = false;
+}
+
+/**
+ * @brief Clock bytes through the model
+ *
+ * @param context Pointer to model
+ * @param tx Bytes on MOSI, NULL to send ones
+ * @param rx Bytes on MISO, NULL if not read
+ * @param len Number of bytes
+ */
+static void w25q_model_transfer(void *context, const uint8_t *tx, uint8_t *rx, uint32_t len) {
+    w25q_model_t *model = (w25q_model_t *)context;
+    uint8_t out;
+
+    for (uint32_t i = 0; i < len; i++) {
+        out = w25q_model_clock(model, (tx != NULL) ? tx[i] : 0xFFU);
+        if (rx != NULL) {
+            rx[i] = out;
+        }
+    }
+}
+
+/********************* Private functions **********************/
+
+/**
+ * @brief Clock one byte
+ *
+ * @param model Pointer to model
+ * @param in Byte on MOSI
+ * @return Byte on MISO
+ */
+static uint8_t w25q_model_clock(w25q_model_t *model, uint8_t in) {
+    uint32_t index = model->count++;
+    uint32_t addr_len = w25q_model_addr_len(model);
+    uint32_t mask = model->config.size - 1U;
+    uint8_t out = 0xFFU;
+
+    if (index == 0U) {
+        w25q_model_command(model, in);
+        return out;
+    }
+
+    if (model->ignore) {
+        return out;
+    }
+
+    switch (model->cmd) {
+        case W25Q_INS_READ_STATUS_REG1:
+            w25q_model_update(model);
+            out = model->sr[0];
+            break;
+
+        case W25Q_INS_READ_STATUS_REG2:
+            out = model->sr[1];
+            break;
+
+        case W25Q_INS_READ_STATUS_REG3:
+            out = model->sr[2];
+            break;
+
+        case W25Q_INS_JEDEC_ID:
+            if (index == 1U) {
+                out = W25Q_MANUFACTURER_ID;
+            } else if (index == 2U) {
+                out = W25Q_MEMORY_TYPE;
+            } else if (index == 3U) {
+                out = model->capacity;
+            }
+            break;
+
+        case W25Q_INS_MANUFACTURER_ID:
+            // Three address bytes, then manufacturer and device ID repeat
+            if (index > 3U) {
+                out = ((index & 1U) == 0U) ? W25Q_MANUFACTURER_ID : (uint8_t)(model->capacity - 1U);
+            }
+            break;
+
+        case W25Q_INS_RELEASE_POWER_DOWN:
+            // Three dummy bytes, then the device ID
+            if (index > 3U) {
+                out = (uint8_t)(model->capacity - 1U);
+            }
+            break;
+
+        case W25Q_INS_READ_DATA:
+        case W25Q_INS_FAST_READ_DATA:
+            if (index <= addr_len) {
+                model->addr = (model->addr << 8) | in;
+            } else if ((model->cmd == W25Q_INS_READ_DATA) || (index > (addr_len + 1U))) {
+                // Reads continue across the whole array
+                out = model->config.memory[model->addr & mask];
+                model->addr++;
+                model->stats.read_bytes++;
+            }
+            break;
+
+        case W25Q_INS_PAGE_PROGRAM:
+            if (index <= addr_len) {
+                model->addr = (model->addr << 8) | in;
+                if (index == addr_len) {
+                    memset(model->latch, 0xFF, sizeof(model->latch));
+                }
+            } else {
+                // The address wraps inside the page, later bytes overwrite the latch
+                model->latch[model->addr % W25Q_MODEL_PAGE_SIZE] = in;
+                model->addr = (model->addr & ~(W25Q_MODEL_PAGE_SIZE - 1U)) | \
+                    ((model->addr + 1U) & (W25Q_MODEL_PAGE_SIZE - 1U));
+                model->stats.program_bytes++;
+            }
+            break;
+
+        case W25Q_INS_SECTOR_ERASE:
+        case W25Q_INS_BLOCK_ERASE_32K:
+        case W25Q_INS_BLOCK_ERASE_64K:
+            if (index <= addr_len) {
+                model->addr = (model->addr << 8) | in;
+            }
+            break;
+
+        case W25Q_INS_WRITE_STATUS_REG1:
+        case W25Q_INS_WRITE_STATUS_REG2:
+        case W25Q_INS_WRITE_STATUS_REG3:
+            // 01h may carry status register 2 as second byte
+            if (index <= 2U) {
+                model->latch[index - 1U] = in;
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    return out;
+}
+
+/**
+ * @brief Decode the instruction byte
+ *
+ * @param model Pointer to model
+ * @param cmd Instruction
+ */
+static void w25q_model_command(w25q_model_t *model, uint8_t cmd) {
+    bool status = (cmd == W25Q_INS_READ_STATUS_REG1) || (cmd == W25Q_INS_READ_STATUS_REG2) || \
+        (cmd == W25Q_INS_READ_STATUS_REG3);
+
+    model->cmd = cmd;
+
+    w25q_model_update(model);
+
+    if (model->power_down && (cmd != W25Q_INS_RELEASE_POWER_DOWN)) {
+        // Only the release instruction is recognized in power down
+        model->ignore = true;
+    } else if ((model->sr[0] & W25Q_SR1_BUSY) != 0U) {
+        if (status) {
+            model->stats.status_poll++;
+        } else {
+            model->ignore = true;
+        }
+    }
+
+    if (model->ignore) {
+        model->stats.ignored++;
+    }
+}
+
+/**
+ * @brief Execute the command when CS goes high
+ *
+ * @param model Pointer to model
+ */
+static void w25q_model_execute(w25q_model_t *model) {
+    uint32_t addr_len = w25q_model_addr_len(model);
+    uint32_t mask = model->config.size - 1U;
+    bool wel = (model->sr[0] & W25Q_SR1_WEL) != 0U;
+    uint8_t *page;
+
+    switch (model->cmd) {
+        case W25Q_INS_WRITE_ENABLE:
+            model->sr[0] |= W25Q_SR1_WEL;
+            break;
+
+        case W25Q_INS_WRITE_DISABLE:
+            model->sr[0] &= (uint8_t)~W25Q_SR1_WEL;
+            break;
+
+        case W25Q_INS_PAGE_PROGRAM:
+            if (!wel || (model->count <= (addr_len + 1U))) {
+                model->stats.ignored++;
+                break;
+            }
+            // Programming only clears bits
+            page = &model->config.memory[model->addr & mask & ~(W25Q_MODEL_PAGE_SIZE - 1U)];
+            for (uint32_t i = 0; i < W25Q_MODEL_PAGE_SIZE; i++) {
+                page[i] &= model->latch[i];
+            }
+            model->stats.page_program++;
+            w25q_model_set_busy(model, W25Q_TIME_PAGE_PROGRAM_US);
+            break;
+
+        case W25Q_INS_SECTOR_ERASE:
+        case W25Q_INS_BLOCK_ERASE_32K:
+        case W25Q_INS_BLOCK_ERASE_64K:
+            if (!wel || (model->count != (addr_len + 1U))) {
+                model->stats.ignored++;
+                break;
+            }
+            if (model->cmd == W25Q_INS_SECTOR_ERASE) {
+                w25q_model_erase(model, 4096U, W25Q_TIME_SECTOR_ERASE_US);
+            } else if (model->cmd == W25Q_INS_BLOCK_ERASE_32K) {
+                w25q_model_erase(model, 32768U, W25Q_TIME_BLOCK_32K_US);
+            } else {
+                w25q_model_erase(model, 65536U, W25Q_TIME_BLOCK_64K_US);
+            }
+            break;
+
+        case W25Q_INS_CHIP_ERASE:
+        case W25Q_INS_CHIP_ERASE_ALT:
+            if (!wel || (model->count != 1U)) {
+                model->stats.ignored++;
+                break;
+            }
+            model->addr = 0;
+            w25q_model_erase(model, model->config.size, \
+                (uint32_t)(((uint64_t)W25Q_TIME_CHIP_ERASE_US * model->config.size) / W25Q_CHIP_ERASE_REF_SIZE));
+            break;
+
+        case W25Q_INS_WRITE_STATUS_REG1:
+        case W25Q_INS_WRITE_STATUS_REG2:
+        case W25Q_INS_WRITE_STATUS_REG3:
+            if (!wel || (model->count < 2U)) {
+                model->stats.ignored++;
+                break;
+            }
+            if (model->cmd == W25Q_INS_WRITE_STATUS_REG3) {
+                model->sr[2] = (uint8_t)((model->sr[2] & ~W25Q_SR3_WRITE_MASK) | (model->latch[0] & W25Q_SR3_WRITE_MASK));
+            } else if (model->cmd == W25Q_INS_WRITE_STATUS_REG2) {
+                model->sr[1] = (uint8_t)((model->sr[1] & ~W25Q_SR2_WRITE_MASK) | (model->latch[0] & W25Q_SR2_WRITE_MASK));
+            } else {
+                model->sr[0] = (uint8_t)((model->sr[0] & ~W25Q_SR1_WRITE_MASK) | (model->latch[0] & W25Q_SR1_WRITE_MASK));
+                if (model->count > 2U) {
+                    model->sr[1] = (uint8_t)((model->sr[1] & ~W25Q_SR2_WRITE_MASK) | (model->latch[1] & W25Q_SR2_WRITE_MASK));
+                }
+            }
+            w25q_model_set_busy(model, W25Q_TIME_WRITE_SR_US);
+            break;
+
+        case W25Q_INS_POWER_DOWN:
+            model->power_down = true;
+            break;
+
+        case W25Q_INS_RELEASE_POWER_DOWN:
+            model->power_down = false;
+            break;
+
+        case W25Q_INS_ENTER_4BYTE:
+            if (model->config.size > (1UL << 24)) {
+                model->addr_4byte = true;
+                model->sr[2] |= W25Q_SR3_ADS;
+            }
+            break;
+
+        case W25Q_INS_EXIT_4BYTE:
+            model->addr_4byte = false;
+            model->sr[2] &= (uint8_t)~W25Q_SR3_ADS;
+            break;
+
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Erase an aligned region
+ *
+ * @param model Pointer to model
+ * @param size Region size in bytes
+ * @param time_us Typical erase time in microseconds
+ */
+static void w25q_model_erase(w25q_model_t *model, uint32_t size, uint32_t time_us) {
+    uint32_t start = model->addr & (model->config.size - 1U) & ~(size - 1U);
+
+    memset(&model->config.memory[start], 0xFF, size);
+    model->stats.erase++;
+    w25q_model_set_busy(model, time_us);
+}
+
+/**
+ * @brief Start a program or erase cycle
+ *
+ * @param model Pointer to model
+ * @param time_us Typical cycle time in microseconds
+ */
+static void w25q_model_set_busy(w25q_model_t *model, uint64_t time_us) {
+    uint64_t time_ns = (time_us * 1000U * model->config.time_percent) / 100U;
+
+    if (time_ns == 0U) {
+        // Completes at once, WEL is cleared as at the end of the cycle
+        model->sr[0] &= (uint8_t)~W25Q_SR1_WEL;
+        return;
+    }
+
+    model->sr[0] |= W25Q_SR1_BUSY;
+    model->busy_until = clock_hal_get_ns() + time_ns;
+}
+
+/**
+ * @brief Finish a cycle whose time has elapsed
+ *
+ * @param model Pointer to model
+ */
+static void w25q_model_update(w25q_model_t *model) {
+    if (((model->sr[0] & W25Q_SR1_BUSY) != 0U) && (clock_hal_get_ns() >= model->busy_until)) {
+        model->sr[0] &= (uint8_t)~(W25Q_SR1_BUSY | W25Q_SR1_WEL);
+    }
+}
+
+/**
+ * @brief Get number of address bytes
+ *
+ * @param model Pointer to model
+ * @return 3 or 4
+ */
+static uint32_t w25q_model_addr_len(w25q_model_t *model) {
+    return model->addr_4byte ? 4U : 3U;
+}
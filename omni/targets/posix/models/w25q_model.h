@@ -0,0 +1,107 @@
+/**
+  * @file    w25q_model.h
+  * @author  LuckkMaker
+  * @brief   Header for w25q_model.c file
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef OMNI_MODEL_W25Q_H
+#define OMNI_MODEL_W25Q_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "hal/spi_hal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Behavioral model of a Winbond W25Qxx serial NOR flash.
+ *
+ * - Read (03h), fast read (0Bh), page program (02h), sector (20h), 32 KiB
+ *   (52h), 64 KiB (D8h) and chip erase (C7h/60h), status registers, write
+ *   enable/disable, power down and the ID commands are served.
+ * - Page program wraps at the 256 byte page boundary and can only clear
+ *   bits. Program and erase start when CS goes high.
+ * - BUSY reads as set for the typical W25Q64JV program and erase times,
+ *   scaled by time_percent. Other commands are ignored while busy.
+ * - Capacities above 16 MiB start in 3 byte address mode, B7h/E9h switch.
+ *
+ * Block protection and the security registers are not modeled.
+ */
+
+#define W25Q_MODEL_PAGE_SIZE    256U
+
+/**
+ * @brief W25Q model configuration
+ */
+typedef struct w25q_model_config {
+    uint32_t size;                  /**< Capacity in bytes, power of two from 1 MiB to 32 MiB */
+    uint32_t cs_pin;                /**< Chip select GPIO or SPI_HAL_CS_HARD */
+    uint32_t time_percent;          /**< Busy times in percent of typical, 0 for none */
+    uint8_t *memory;                /**< Backing memory of size bytes, allocated if NULL */
+} w25q_model_config_t;
+
+/**
+ * @brief W25Q model statistics
+ */
+typedef struct w25q_model_stats {
+    uint32_t page_program;          /**< Page programs */
+    uint32_t erase;                 /**< Sector, block and chip erases */
+    uint32_t status_poll;           /**< Status reads while busy */
+    uint32_t ignored;               /**< Commands ignored while busy or not write enabled */
+    uint64_t read_bytes;            /**< Bytes read from the array */
+    uint64_t program_bytes;         /**< Bytes clocked in by page programs */
+} w25q_model_stats_t;
+
+/**
+ * @brief W25Q model
+ */
+typedef struct w25q_model {
+    spi_hal_model_t bus;            /**< Attached to the SPI bus */
+    w25q_model_config_t config;
+    bool allocated;                 /**< Backing memory owned by the model */
+    uint8_t capacity;               /**< log2 of size */
+    uint8_t sr[3];                  /**< Status registers 1 to 3 */
+    bool power_down;
+    bool addr_4byte;
+    uint64_t busy_until;            /**< End of the program or erase cycle */
+    /* Command in progress */
+    bool selected;
+    uint8_t cmd;
+    uint32_t count;                 /**< Bytes clocked since CS went low */
+    uint32_t addr;
+    bool ignore;                    /**< Rest of the command is ignored */
+    uint8_t latch[W25Q_MODEL_PAGE_SIZE];
+    w25q_model_stats_t stats;
+} w25q_model_t;
+
+int w25q_model_init(w25q_model_t *model, const w25q_model_config_t *config);
+void w25q_model_deinit(w25q_model_t *model);
+int w25q_model_attach(w25q_model_t *model, spi_num_t spi_num);
+int w25q_model_detach(w25q_model_t *model, spi_num_t spi_num);
+bool w25q_model_is_busy(w25q_model_t *model);
+w25q_model_stats_t w25q_model_get_stats(w25q_model_t *model);
+void w25q_model_reset_stats(w25q_model_t *model);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* OMNI_MODEL_W25Q_H */
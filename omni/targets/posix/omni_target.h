@@ -0,0 +1,111 @@
+/**
+  * @file    omni_target.h
+  * @author  LuckkMaker
+  * @brief   Target specific header file for the POSIX host target
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef OMNI_TARGETS_H
+#define OMNI_TARGETS_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "omni_device_cfg.h"
+
+#if !defined(CONFIG_SOC_FAMILY_HOST)
+#error "Unknown target"
+#endif /* CONFIG_SOC_FAMILY_HOST */
+
+#include "omni_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * The host target runs the driver stack as a Linux process. Interrupts are
+ * emulated by a dispatcher thread, see hal/irq_hal.h. The intrinsics below
+ * keep the PRIMASK pattern of the Cortex-M code working: while a thread has
+ * interrupts disabled no emulated handler runs.
+ */
+
+/**
+ * @brief Emulated interrupt numbers
+ */
+typedef enum {
+    USART1_IRQn = 0,
+    USART2_IRQn = 1,
+    USART3_IRQn = 2,
+    SPI1_IRQn = 3,
+    SPI2_IRQn = 4,
+    I2C1_IRQn = 5,
+    I2C2_IRQn = 6,
+    TIM1_IRQn = 7,
+    TIM2_IRQn = 8,
+    TIM3_IRQn = 9,
+    EXTI_IRQn = 10,
+    USER_IRQn = 16,                 /**< First interrupt free for applications */
+    IRQn_MAX = 32,
+} IRQn_Type;
+
+/**
+ * @brief Core clock, the cycle count is kept in nanoseconds
+ */
+extern uint32_t SystemCoreClock;
+
+void __enable_irq(void);
+void __disable_irq(void);
+uint32_t __get_PRIMASK(void);
+void __set_PRIMASK(uint32_t primask);
+uint32_t __get_IPSR(void);
+void __WFI(void);
+
+#define __NOP()         __asm__ volatile ("nop")
+#define __DMB()         __sync_synchronize()
+#define __DSB()         __sync_synchronize()
+#define __ISB()         __sync_synchronize()
+#define __CLZ(x)        (((x) == 0U) ? 32U : (uint32_t)__builtin_clz(x))
+
+typedef const struct i2c_dev {
+    IRQn_Type irq_num;
+    uint8_t irq_prio;
+} i2c_dev_t;
+
+typedef const struct spi_dev {
+    IRQn_Type irq_num;
+    uint8_t irq_prio;
+} spi_dev_t;
+
+typedef const struct usart_dev {
+    const char *path;               /**< Device path, see omni_device_cfg.h */
+    IRQn_Type irq_num;
+    uint8_t irq_prio;
+} usart_dev_t;
+
+typedef const struct timer_dev {
+    IRQn_Type irq_num;
+    uint8_t irq_prio;
+} timer_dev_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OMNI_TARGETS_H */
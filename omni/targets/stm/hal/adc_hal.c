@@ -0,0 +1,1121 @@
+/**
+  * @file    adc_hal.c
+  * @author  LuckkMaker
+  * @brief   ADC HAL driver
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "drivers/adc.h"
+#include "hal/gpio_hal.h"
+#include "hal/dma_hal.h"
+#include "hal/irq_hal.h"
+#include "ll/adc_ll.h"
+
+// Dual and triple modes run from ADC1 with ADC2 (and ADC3) as slaves
+#if defined(ADC2) && (CONFIG_ADC_NUM_1 == 1) && (CONFIG_ADC_NUM_2 == 1)
+#define ADC_HAL_MULTI           1
+#endif
+
+#if defined(CONFIG_SOC_FAMILY_STM32H7XX)
+#define ADC_HAL_CHANNEL_MAX     20U
+#elif defined(CONFIG_SOC_FAMILY_STM32F4XX)
+#define ADC_HAL_CHANNEL_MAX     19U
+#else
+#define ADC_HAL_CHANNEL_MAX     18U
+#endif /* CONFIG_SOC_FAMILY_STM32H7XX */
+
+#define ADC_HAL_SEQUENCE_MAX    16U
+
+// Sampling times in half ADC clock cycles, shortest first
+#if defined(CONFIG_SOC_FAMILY_STM32H7XX)
+static const uint16_t adc_sample_half_cycles[] = { 3, 5, 17, 33, 65, 129, 775, 1621 };
+static const uint32_t adc_sample_time[] = {
+    ADC_SAMPLETIME_1CYCLE_5, ADC_SAMPLETIME_2CYCLES_5, ADC_SAMPLETIME_8CYCLES_5,
+    ADC_SAMPLETIME_16CYCLES_5, ADC_SAMPLETIME_32CYCLES_5, ADC_SAMPLETIME_64CYCLES_5,
+    ADC_SAMPLETIME_387CYCLES_5, ADC_SAMPLETIME_810CYCLES_5,
+};
+static const uint32_t adc_rank[ADC_HAL_SEQUENCE_MAX] = {
+    ADC_REGULAR_RANK_1, ADC_REGULAR_RANK_2, ADC_REGULAR_RANK_3, ADC_REGULAR_RANK_4,
+    ADC_REGULAR_RANK_5, ADC_REGULAR_RANK_6, ADC_REGULAR_RANK_7, ADC_REGULAR_RANK_8,
+    ADC_REGULAR_RANK_9, ADC_REGULAR_RANK_10, ADC_REGULAR_RANK_11, ADC_REGULAR_RANK_12,
+    ADC_REGULAR_RANK_13, ADC_REGULAR_RANK_14, ADC_REGULAR_RANK_15, ADC_REGULAR_RANK_16,
+};
+#elif defined(CONFIG_SOC_FAMILY_STM32F4XX)
+static const uint16_t adc_sample_half_cycles[] = { 6, 30, 56, 112, 168, 224, 288, 960 };
+static const uint32_t adc_sample_time[] = {
+    ADC_SAMPLETIME_3CYCLES, ADC_SAMPLETIME_15CYCLES, ADC_SAMPLETIME_28CYCLES,
+    ADC_SAMPLETIME_56CYCLES, ADC_SAMPLETIME_84CYCLES, ADC_SAMPLETIME_112CYCLES,
+    ADC_SAMPLETIME_144CYCLES, ADC_SAMPLETIME_480CYCLES,
+};
+#else
+static const uint16_t adc_sample_half_cycles[] = { 3, 15, 27, 57, 83, 111, 143, 479 };
+static const uint32_t adc_sample_time[] = {
+    ADC_SAMPLETIME_1CYCLE_5, ADC_SAMPLETIME_7CYCLES_5, ADC_SAMPLETIME_13CYCLES_5,
+    ADC_SAMPLETIME_28CYCLES_5, ADC_SAMPLETIME_41CYCLES_5, ADC_SAMPLETIME_55CYCLES_5,
+    ADC_SAMPLETIME_71CYCLES_5, ADC_SAMPLETIME_239CYCLES_5,
+};
+#endif /* CONFIG_SOC_FAMILY_STM32H7XX */
+
+static adc_obj_t adc_obj[ADC_NUM_MAX];
+
+static int adc_hal_init(adc_num_t adc_num, adc_driver_config_t *config);
+static int adc_hal_deinit(adc_num_t adc_num);
+static int adc_hal_start(adc_num_t adc_num, uint16_t *buffer, uint32_t len, adc_block_callback cb);
+static int adc_hal_stop(adc_num_t adc_num);
+static adc_driver_status_t adc_hal_get_status(adc_num_t adc_num);
+static adc_driver_error_t adc_hal_get_error(adc_num_t adc_num);
+
+const struct adc_driver_api adc_driver = {
+    .init = adc_hal_init,
+    .deinit = adc_hal_deinit,
+    .start = adc_hal_start,
+    .stop = adc_hal_stop,
+    .get_status = adc_hal_get_status,
+    .get_error = adc_hal_get_error,
+};
+
+static int adc_hal_configure(adc_dev_t *dev, adc_driver_config_t *config);
+static int adc_hal_get_resolution(adc_resolution_t resolution, uint32_t *value);
+static int adc_hal_get_trigger(adc_trigger_t trigger, uint32_t *value);
+static uint32_t adc_hal_get_sample_time(uint32_t cycles);
+static uint32_t adc_hal_get_adc_num(adc_mode_t mode);
+#if defined(ADC_HAL_MULTI)
+static int adc_hal_configure_multi(adc_mode_t mode);
+#endif /* ADC_HAL_MULTI */
+static void adc_hal_irq_register(adc_dev_t *dev);
+static void adc_hal_set_gpio(adc_dev_t *dev, uint32_t channels);
+static void adc_hal_reset_gpio(adc_dev_t *dev, uint32_t channels);
+static int adc_hal_enable_clock(adc_num_t adc_num);
+static void adc_hal_reset_clock(adc_num_t adc_num);
+static adc_obj_t *adc_hal_get_obj(ADC_HandleTypeDef *hadc);
+static void adc_hal_block_done(ADC_HandleTypeDef *hadc, uint32_t half);
+
+/**
+ * @brief Initialize ADC
+ *
+ * @param adc_num ADC number
+ * @param config Pointer to the ADC driver configuration
+ * @return Operation status
+ */
+static int adc_hal_init(adc_num_t adc_num, adc_driver_config_t *config) {
+    omni_assert(adc_num < ADC_NUM_MAX);
+    omni_assert_not_null(config);
+    omni_assert_not_null(config->channels);
+
+    adc_obj_t *obj = &adc_obj[adc_num];
+
+    if ((config->channel_num == 0) || (config->channel_num > ADC_HAL_SEQUENCE_MAX)) {
+        return OMNI_FAIL;
+    }
+
+    // Only ADC1 runs a multi mode
+#if defined(ADC_HAL_MULTI)
+    if ((config->mode != ADC_MODE_INDEPENDENT) && (adc_num != ADC_NUM_1)) {
+        return OMNI_FAIL;
+    }
+#else
+    if (config->mode != ADC_MODE_INDEPENDENT) {
+        return OMNI_FAIL;
+    }
+#endif /* ADC_HAL_MULTI */
+
+    // Set event callback
+    if (config->event_cb != NULL) {
+        obj->event_cb = config->event_cb;
+    } else {
+        obj->event_cb = NULL;
+    }
+
+    // Get dev information
+    obj->dev = adc_ll_get_dev(adc_num);
+    omni_assert_not_null(obj->dev);
+
+    // Clear status
+    obj->status = (adc_driver_status_t){0};
+
+    // Clear error
+    obj->error = (adc_driver_error_t){0};
+
+    // Clear data
+    obj->data = (adc_driver_data_t){0};
+    obj->data.mode = config->mode;
+    obj->data.scan = config->channel_num * adc_hal_get_adc_num(config->mode);
+    for (uint32_t i = 0; i < config->channel_num; i++) {
+        if (config->channels[i] >= ADC_HAL_CHANNEL_MAX) {
+            return OMNI_FAIL;
+        }
+        obj->data.channels |= (1UL << config->channels[i]);
+    }
+
+    // Register IRQ
+    adc_hal_irq_register(obj->dev);
+
+    // Enable ADC clock
+    if (adc_hal_enable_clock(adc_num) != OMNI_OK) {
+        return OMNI_FAIL;
+    }
+
+    // Initialize GPIO
+    adc_hal_set_gpio(obj->dev, obj->data.channels);
+
+    // Initialize DMA
+    if (obj->dev->dma != NULL) {
+        if (dma_hal_claim(obj->dev->dma, obj->dev->handle->Instance, DMA_HAL_DIR_RX) != OMNI_OK) {
+            return OMNI_FAIL;
+        }
+
+        dma_hal_enable_clock(obj->dev->dma->ins);
+
+        // A multi mode packs the samples of two ADCs in one word
+        if (config->mode == ADC_MODE_INDEPENDENT) {
+            obj->dev->dma->handle->Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+            obj->dev->dma->handle->Init.MemDataAlignment = DMA_MDATAALIGN_HALFWORD;
+        } else {
+            obj->dev->dma->handle->Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+            obj->dev->dma->handle->Init.MemDataAlignment = DMA_MDATAALIGN_WORD;
+        }
+
+        if (HAL_DMA_Init(obj->dev->dma->handle) != HAL_OK) {
+            return OMNI_FAIL;
+        }
+
+        __HAL_LINKDMA(obj->dev->handle, DMA_Handle, *(obj->dev->dma->handle));
+
+        // Enable DMA IRQ
+        NVIC_ClearPendingIRQ(obj->dev->dma->irq_num);
+        NVIC_SetPriority(obj->dev->dma->irq_num, \
+            NVIC_EncodePriority(NVIC_GetPriorityGrouping(), obj->dev->dma->irq_prio, 0));
+        NVIC_EnableIRQ(obj->dev->dma->irq_num);
+    }
+
+    // Initialize IRQ
+    NVIC_ClearPendingIRQ(obj->dev->irq_num);
+    NVIC_SetPriority(obj->dev->irq_num, \
+        NVIC_EncodePriority(NVIC_GetPriorityGrouping(), obj->dev->irq_prio, 0));
+    NVIC_EnableIRQ(obj->dev->irq_num);
+
+    // Initialize ADC
+    if (adc_hal_configure(obj->dev, config) != OMNI_OK) {
+        return OMNI_FAIL;
+    }
+
+#if defined(ADC_HAL_MULTI)
+    if (config->mode != ADC_MODE_INDEPENDENT) {
+        if (adc_hal_configure_multi(config->mode) != OMNI_OK) {
+            return OMNI_FAIL;
+        }
+    }
+#endif /* ADC_HAL_MULTI */
+
+    // Set initialized status
+    obj->status.is_initialized = 1;
+    // Call event callback
+    if (obj->event_cb != NULL) {
+        // Set initialized event
+        obj->event_cb(ADC_EVENT_INITIALIZED);
+    }
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Deinitialize ADC
+ *
+ * @param adc_num ADC number
+ * @return Operation status
+ */
+static int adc_hal_deinit(adc_num_t adc_num) {
+    bool irq_used = false;
+    omni_assert(adc_num < ADC_NUM_MAX);
+
+    adc_obj_t *obj = &adc_obj[adc_num];
+    omni_assert_not_null(obj);
+
+    if (obj->dev == NULL) {
+        return OMNI_OK;
+    }
+
+    // A circular DMA cannot be deinitialized
+    adc_hal_stop(adc_num);
+
+    HAL_ADC_DeInit(obj->dev->handle);
+
+    // Clear initialized status first, the clock of ADC1 and ADC2 is shared on STM32H7
+    obj->status.is_initialized = 0;
+
+    // Reset ADC clock
+    adc_hal_reset_clock(adc_num);
+
+    // Reset GPIO
+    adc_hal_reset_gpio(obj->dev, obj->data.channels);
+
+    // Deinitialize DMA
+    if (obj->dev->dma != NULL) {
+        dma_hal_release(obj->dev->dma);
+        HAL_DMA_DeInit(obj->dev->dma->handle);
+        NVIC_DisableIRQ(obj->dev->dma->irq_num);
+    }
+
+    // The IRQ is shared, leave it enabled while another ADC uses it
+    for (uint32_t i = 0; i < ADC_NUM_MAX; i++) {
+        if (adc_obj[i].status.is_initialized && (adc_obj[i].dev->irq_num == obj->dev->irq_num)) {
+            irq_used = true;
+        }
+    }
+
+    if (!irq_used) {
+        NVIC_DisableIRQ(obj->dev->irq_num);
+    }
+
+    adc_obj[adc_num] = (adc_obj_t){0};
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Start sampling into a ring buffer
+ *
+ * @note The ring is split in two blocks of len / 2 samples, cb is called
+ *       each time one is full. len must be a multiple of two scans. With
+ *       the data cache enabled the ring must start and end on a cache line
+ *       unless it is in the non-cacheable region.
+ * @param adc_num ADC number
+ * @param buffer Pointer to ring buffer
+ * @param len Ring length in samples
+ * @param cb Block callback
+ * @return Operation status
+ */
+static int adc_hal_start(adc_num_t adc_num, uint16_t *buffer, uint32_t len, adc_block_callback cb) {
+    HAL_StatusTypeDef status;
+    omni_assert(adc_num < ADC_NUM_MAX);
+    omni_assert_not_null(buffer);
+    omni_assert_not_null(cb);
+    omni_assert_non_zero(len);
+
+    adc_obj_t *obj = &adc_obj[adc_num];
+    omni_assert_not_null(obj);
+
+    if (!obj->status.is_initialized || (obj->dev->dma == NULL)) {
+        return OMNI_FAIL;
+    }
+
+    if (obj->status.busy) {
+        return OMNI_BUSY;
+    }
+
+    // Both blocks hold whole scans, a word holds two samples in multi modes
+    if ((len % (2U * obj->data.scan)) != 0U) {
+        return OMNI_FAIL;
+    }
+
+    if (obj->data.mode == ADC_MODE_INDEPENDENT) {
+        if (len > 0xFFFFU) {
+            return OMNI_FAIL;
+        }
+    } else {
+        if (((len % 4U) != 0U) || ((len / 2U) > 0xFFFFU)) {
+            return OMNI_FAIL;
+        }
+    }
+
+    if (dma_hal_circular_prepare(buffer, len * sizeof(uint16_t)) != OMNI_OK) {
+        return OMNI_FAIL;
+    }
+
+    obj->data.buffer = buffer;
+    obj->data.len = len;
+    obj->block_cb = cb;
+    obj->error = (adc_driver_error_t){0};
+    obj->status.busy = 1;
+
+    if (obj->data.mode == ADC_MODE_INDEPENDENT) {
+        status = HAL_ADC_Start_DMA(obj->dev->handle, (uint32_t *)buffer, len);
+    } else {
+#if defined(ADC_HAL_MULTI)
+#if defined(CONFIG_SOC_FAMILY_STM32F4XX)
+        // Slaves are not enabled by the multi mode start
+        for (uint32_t i = ADC_NUM_2; i < adc_hal_get_adc_num(obj->data.mode); i++) {
+            HAL_ADC_Start(adc_obj[i].dev->handle);
+        }
+#endif /* CONFIG_SOC_FAMILY_STM32F4XX */
+        status = HAL_ADCEx_MultiModeStart_DMA(obj->dev->handle, (uint32_t *)buffer, len / 2U);
+#else
+        status = HAL_ERROR;
+#endif /* ADC_HAL_MULTI */
+    }
+
+    if (status != HAL_OK) {
+        obj->status.busy = 0;
+        return OMNI_FAIL;
+    }
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Stop sampling
+ *
+ * @param adc_num ADC number
+ * @return Operation status
+ */
+static int adc_hal_stop(adc_num_t adc_num) {
+    omni_assert(adc_num < ADC_NUM_MAX);
+
+    adc_obj_t *obj = &adc_obj[adc_num];
+    omni_assert_not_null(obj);
+
+    if (!obj->status.busy) {
+        return OMNI_OK;
+    }
+
+    if (obj->data.mode == ADC_MODE_INDEPENDENT) {
+        HAL_ADC_Stop_DMA(obj->dev->handle);
+    } else {
+#if defined(ADC_HAL_MULTI)
+        HAL_ADCEx_MultiModeStop_DMA(obj->dev->handle);
+#if defined(CONFIG_SOC_FAMILY_STM32F4XX)
+        for (uint32_t i = ADC_NUM_2; i < adc_hal_get_adc_num(obj->data.mode); i++) {
+            HAL_ADC_Stop(adc_obj[i].dev->handle);
+        }
+#endif /* CONFIG_SOC_FAMILY_STM32F4XX */
+#endif /* ADC_HAL_MULTI */
+    }
+
+    obj->status.busy = 0;
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Get ADC status
+ *
+ * @param adc_num ADC number
+ * @return ADC driver status
+ */
+static adc_driver_status_t adc_hal_get_status(adc_num_t adc_num) {
+    omni_assert(adc_num < ADC_NUM_MAX);
+
+    adc_obj_t *obj = &adc_obj[adc_num];
+    omni_assert_not_null(obj);
+
+    return obj->status;
+}
+
+/**
+ * @brief Get ADC error
+ *
+ * @param adc_num ADC number
+ * @return ADC driver error
+ */
+static adc_driver_error_t adc_hal_get_error(adc_num_t adc_num) {
+    omni_assert(adc_num < ADC_NUM_MAX);
+
+    adc_obj_t *obj = &adc_obj[adc_num];
+    omni_assert_not_null(obj);
+
+    return obj->error;
+}
+
+/********************* IRQ handlers **********************/
+
+/**
+ * @brief ADC IRQ handler
+ *
+ * ADCs share their IRQ lines, every initialized ADC is checked.
+ */
+static OMNI_FAST_ISR void adc_irq_handler(void) {
+    for (uint32_t i = 0; i < ADC_NUM_MAX; i++) {
+        if (adc_obj[i].status.is_initialized) {
+            HAL_ADC_IRQHandler(adc_obj[i].dev->handle);
+        }
+    }
+}
+
+#if (CONFIG_ADC_NUM_1 == 1) && (CONFIG_ADC1_DMA == 1)
+OMNI_FAST_ISR void adc1_dma_irq_handler(void) {
+    HAL_DMA_IRQHandler(adc_obj[ADC_NUM_1].dev->dma->handle);
+}
+#endif /* (CONFIG_ADC_NUM_1 == 1) && (CONFIG_ADC1_DMA == 1) */
+
+#if (CONFIG_ADC_NUM_2 == 1) && (CONFIG_ADC2_DMA == 1)
+OMNI_FAST_ISR void adc2_dma_irq_handler(void) {
+    HAL_DMA_IRQHandler(adc_obj[ADC_NUM_2].dev->dma->handle);
+}
+#endif /* (CONFIG_ADC_NUM_2 == 1) && (CONFIG_ADC2_DMA == 1) */
+
+#if (CONFIG_ADC_NUM_3 == 1) && (CONFIG_ADC3_DMA == 1)
+OMNI_FAST_ISR void adc3_dma_irq_handler(void) {
+    HAL_DMA_IRQHandler(adc_obj[ADC_NUM_3].dev->dma->handle);
+}
+#endif /* (CONFIG_ADC_NUM_3 == 1) && (CONFIG_ADC3_DMA == 1) */
+
+/**
+ * @brief Register ADC IRQ
+ *
+ * @param dev ADC device information
+ */
+static void adc_hal_irq_register(adc_dev_t *dev) {
+    irq_hal_register_handler(dev->irq_num, adc_irq_handler);
+
+#if (CONFIG_ADC_NUM_1 == 1) && (CONFIG_ADC1_DMA == 1)
+    if (dev == adc_ll_get_dev(ADC_NUM_1)) {
+        irq_hal_register_handler(dev->dma->irq_num, adc1_dma_irq_handler);
+    }
+#endif /* (CONFIG_ADC_NUM_1 == 1) && (CONFIG_ADC1_DMA == 1) */
+
+#if (CONFIG_ADC_NUM_2 == 1) && (CONFIG_ADC2_DMA == 1)
+    if (dev == adc_ll_get_dev(ADC_NUM_2)) {
+        irq_hal_register_handler(dev->dma->irq_num, adc2_dma_irq_handler);
+    }
+#endif /* (CONFIG_ADC_NUM_2 == 1) && (CONFIG_ADC2_DMA == 1) */
+
+#if (CONFIG_ADC_NUM_3 == 1) && (CONFIG_ADC3_DMA == 1)
+    if (dev == adc_ll_get_dev(ADC_NUM_3)) {
+        irq_hal_register_handler(dev->dma->irq_num, adc3_dma_irq_handler);
+    }
+#endif /* (CONFIG_ADC_NUM_3 == 1) && (CONFIG_ADC3_DMA == 1) */
+}
+
+/********************* Callback functions **********************/
+void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc) {
+    adc_hal_block_done(hadc, 0);
+}
+
+void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc) {
+    adc_hal_block_done(hadc, 1);
+}
+
+void HAL_ADC_ErrorCallback(ADC_HandleTypeDef *hadc) {
+    adc_obj_t *obj = adc_hal_get_obj(hadc);
+    uint32_t event = 0;
+    omni_assert_not_null(obj);
+
+#if defined(HAL_ADC_ERROR_OVR)
+    if ((hadc->ErrorCode & HAL_ADC_ERROR_OVR) != 0U) {
+        obj->error.overrun = 1;
+        event |= ADC_EVENT_OVERRUN;
+    }
+#endif /* HAL_ADC_ERROR_OVR */
+
+    if ((hadc->ErrorCode & HAL_ADC_ERROR_DMA) != 0U) {
+        obj->error.dma_error = 1;
+        event |= ADC_EVENT_DMA_ERROR;
+    }
+
+    if (event == 0U) {
+        return;
+    }
+
+    // Samples are lost, the ring no longer holds whole scans
+    adc_hal_stop((adc_num_t)(obj - adc_obj));
+
+    if (obj->event_cb != NULL) {
+        obj->event_cb(event);
+    }
+}
+
+/********************* Private functions **********************/
+
+/**
+ * @brief Configure ADC
+ *
+ * @param dev ADC device information
+ * @param config Pointer to the ADC driver configuration
+ * @return Operation status
+ */
+static int adc_hal_configure(adc_dev_t *dev, adc_driver_config_t *config) {
+    ADC_ChannelConfTypeDef channel_config = {0};
+    ADC_HandleTypeDef *handle = dev->handle;
+    uint32_t resolution;
+    uint32_t trigger;
+
+    if (adc_hal_get_resolution(config->resolution, &resolution) != OMNI_OK) {
+        return OMNI_FAIL;
+    }
+
+#if !defined(CONFIG_ADC_TIMER_TRIGGER)
+    // No timer would run or output the trigger
+    if ((config->trigger != ADC_TRIGGER_SOFTWARE) && (config->trigger != ADC_TRIGGER_EXTI11)) {
+        return OMNI_FAIL;
+    }
+#endif /* CONFIG_ADC_TIMER_TRIGGER */
+
+    if (adc_hal_get_trigger(config->trigger, &trigger) != OMNI_OK) {
+        return OMNI_FAIL;
+    }
+
+#if defined(CONFIG_SOC_FAMILY_STM32F1XX)
+    RCC_PeriphCLKInitTypeDef PeriphClkInitStruct = {0};
+
+    // ADC clock comes from PCLK2 through the RCC prescaler
+    PeriphClkInitStruct.PeriphClockSelection = RCC_PERIPHCLK_ADC;
+    PeriphClkInitStruct.AdcClockSelection = dev->clock_prescaler;
+    if (HAL_RCCEx_PeriphCLKConfig(&PeriphClkInitStruct) != HAL_OK) {
+        return OMNI_FAIL;
+    }
+    (void)resolution;
+#else
+    handle->Init.ClockPrescaler = dev->clock_prescaler;
+    handle->Init.Resolution = resolution;
+    handle->Init.EOCSelection = ADC_EOC_SEQ_CONV;
+    handle->Init.ExternalTrigConvEdge = (config->trigger == ADC_TRIGGER_SOFTWARE) ? \
+        ADC_EXTERNALTRIGCONVEDGE_NONE : ADC_EXTERNALTRIGCONVEDGE_RISING;
+#endif /* CONFIG_SOC_FAMILY_STM32F1XX */
+
+#if defined(ADC_SCAN_ENABLE)
+    handle->Init.ScanConvMode = ADC_SCAN_ENABLE;
+#else
+    handle->Init.ScanConvMode = ENABLE;
+#endif /* ADC_SCAN_ENABLE */
+    // Without a trigger the ADC scans back to back
+    handle->Init.ContinuousConvMode = (config->trigger == ADC_TRIGGER_SOFTWARE) ? ENABLE : DISABLE;
+    handle->Init.NbrOfConversion = config->channel_num;
+    handle->Init.DiscontinuousConvMode = DISABLE;
+    handle->Init.ExternalTrigConv = trigger;
+
+#if defined(CONFIG_SOC_FAMILY_STM32H7XX)
+    handle->Init.LowPowerAutoWait = DISABLE;
+    handle->Init.ConversionDataManagement = (dev->dma != NULL) ? \
+        ADC_CONVERSIONDATA_DMA_CIRCULAR : ADC_CONVERSIONDATA_DR;
+    handle->Init.Overrun = ADC_OVR_DATA_PRESERVED;
+    handle->Init.LeftBitShift = ADC_LEFTBITSHIFT_NONE;
+
+    if (config->oversampling > 1U) {
+        if ((config->oversampling > 1024U) || (config->oversampling_shift > 11U)) {
+            return OMNI_FAIL;
+        }
+
+        handle->Init.OversamplingMode = ENABLE;
+        handle->Init.Oversampling.Ratio = config->oversampling;
+        handle->Init.Oversampling.RightBitShift = config->oversampling_shift << ADC_CFGR2_OVSS_Pos;
+        handle->Init.Oversampling.TriggeredMode = ADC_TRIGGEREDMODE_SINGLE_TRIGGER;
+        handle->Init.Oversampling.OversamplingStopReset = ADC_REGOVERSAMPLING_CONTINUED_MODE;
+    } else {
+        handle->Init.OversamplingMode = DISABLE;
+    }
+#else
+    if (config->oversampling > 1U) {
+        return OMNI_FAIL;
+    }
+
+    handle->Init.DataAlign = ADC_DATAALIGN_RIGHT;
+#if defined(CONFIG_SOC_FAMILY_STM32F4XX)
+    handle->Init.DMAContinuousRequests = ENABLE;
+#endif /* CONFIG_SOC_FAMILY_STM32F4XX */
+#endif /* CONFIG_SOC_FAMILY_STM32H7XX */
+
+    if (HAL_ADC_Init(handle) != HAL_OK) {
+        return OMNI_FAIL;
+    }
+
+    channel_config.SamplingTime = adc_hal_get_sample_time(config->sample_cycles);
+#if defined(CONFIG_SOC_FAMILY_STM32H7XX)
+    channel_config.SingleDiff = ADC_SINGLE_ENDED;
+    channel_config.OffsetNumber = ADC_OFFSET_NONE;
+#endif /* CONFIG_SOC_FAMILY_STM32H7XX */
+
+    for (uint32_t i = 0; i < config->channel_num; i++) {
+#if defined(CONFIG_SOC_FAMILY_STM32H7XX)
+        channel_config.Channel = __LL_ADC_DECIMAL_NB_TO_CHANNEL(config->channels[i]);
+        channel_config.Rank = adc_rank[i];
+#else
+        channel_config.Channel = config->channels[i];
+        channel_config.Rank = i + 1U;
+#endif /* CONFIG_SOC_FAMILY_STM32H7XX */
+        if (HAL_ADC_ConfigChannel(handle, &channel_config) != HAL_OK) {
+            return OMNI_FAIL;
+        }
+    }
+
+    // Calibrate once the ADC is configured and still disabled
+#if defined(CONFIG_SOC_FAMILY_STM32H7XX)
+    if (HAL_ADCEx_Calibration_Start(handle, ADC_CALIB_OFFSET_LINEARITY, ADC_SINGLE_ENDED) != HAL_OK) {
+        return OMNI_FAIL;
+    }
+#elif defined(CONFIG_SOC_FAMILY_STM32F1XX)
+    if (HAL_ADCEx_Calibration_Start(handle) != HAL_OK) {
+        return OMNI_FAIL;
+    }
+#endif /* CONFIG_SOC_FAMILY_STM32H7XX */
+
+    return OMNI_OK;
+}
+
+#if defined(ADC_HAL_MULTI)
+/**
+ * @brief Configure a multi mode on ADC1
+ *
+ * @note The slaves must be initialized. They are set to the conversion
+ *       mode of ADC1 and converted on its trigger.
+ * @param mode Multi mode
+ * @return Operation status
+ */
+static int adc_hal_configure_multi(adc_mode_t mode) {
+    ADC_MultiModeTypeDef multi_config = {0};
+    ADC_HandleTypeDef *master = adc_obj[ADC_NUM_1].dev->handle;
+    uint32_t num = adc_hal_get_adc_num(mode);
+
+    switch (mode) {
+        case ADC_MODE_DUAL_SIMULT:
+            multi_config.Mode = ADC_DUALMODE_REGSIMULT;
+            break;
+
+        case ADC_MODE_DUAL_INTERL:
+#if defined(ADC_DUALMODE_INTERL)
+            multi_config.Mode = ADC_DUALMODE_INTERL;
+#else
+            multi_config.Mode = ADC_DUALMODE_INTERLFAST;
+#endif /* ADC_DUALMODE_INTERL */
+            break;
+
+#if defined(ADC_TRIPLEMODE_REGSIMULT) && (CONFIG_ADC_NUM_3 == 1)
+        case ADC_MODE_TRIPLE_SIMULT:
+            multi_config.Mode = ADC_TRIPLEMODE_REGSIMULT;
+            break;
+
+        case ADC_MODE_TRIPLE_INTERL:
+            multi_config.Mode = ADC_TRIPLEMODE_INTERL;
+            break;
+#endif /* ADC_TRIPLEMODE_REGSIMULT && (CONFIG_ADC_NUM_3 == 1) */
+
+        default:
+            return OMNI_FAIL;
+    }
+
+#if defined(ADC_DMAACCESSMODE_2)
+    multi_config.DMAAccessMode = ADC_DMAACCESSMODE_2;
+    multi_config.TwoSamplingDelay = ADC_TWOSAMPLINGDELAY_5CYCLES;
+#elif defined(ADC_DUALMODEDATAFORMAT_32_10_BITS)
+    multi_config.DualModeData = ADC_DUALMODEDATAFORMAT_32_10_BITS;
+    multi_config.TwoSamplingDelay = ADC_TWOSAMPLINGDELAY_1CYCLE;
+#endif /* ADC_DMAACCESSMODE_2 */
+
+    for (uint32_t i = ADC_NUM_2; i < num; i++) {
+        adc_obj_t *slave = &adc_obj[i];
+
+        if (!slave->status.is_initialized) {
+            return OMNI_FAIL;
+        }
+
+        slave->data.mode = mode;
+        slave->dev->handle->Init.ContinuousConvMode = master->Init.ContinuousConvMode;
+        if (HAL_ADC_Init(slave->dev->handle) != HAL_OK) {
+            return OMNI_FAIL;
+        }
+    }
+
+    if (HAL_ADCEx_MultiModeConfigChannel(master, &multi_config) != HAL_OK) {
+        return OMNI_FAIL;
+    }
+
+    return OMNI_OK;
+}
+#endif /* ADC_HAL_MULTI */
+
+/**
+ * @brief Get the resolution value of the family
+ *
+ * @param resolution ADC resolution
+ * @param value Pointer to the resolution value
+ * @return Operation status, OMNI_FAIL if the family does not have it
+ */
+static int adc_hal_get_resolution(adc_resolution_t resolution, uint32_t *value) {
+    switch (resolution) {
+        case ADC_RESOLUTION_12BIT:
+#if defined(ADC_RESOLUTION_12B)
+            *value = ADC_RESOLUTION_12B;
+#else
+            *value = 0;
+#endif /* ADC_RESOLUTION_12B */
+            break;
+
+#if defined(ADC_RESOLUTION_16B)
+        case ADC_RESOLUTION_16BIT:
+            *value = ADC_RESOLUTION_16B;
+            break;
+#endif /* ADC_RESOLUTION_16B */
+
+#if defined(ADC_RESOLUTION_14B)
+        case ADC_RESOLUTION_14BIT:
+            *value = ADC_RESOLUTION_14B;
+            break;
+#endif /* ADC_RESOLUTION_14B */
+
+#if defined(ADC_RESOLUTION_10B)
+        case ADC_RESOLUTION_10BIT:
+            *value = ADC_RESOLUTION_10B;
+            break;
+#endif /* ADC_RESOLUTION_10B */
+
+#if defined(ADC_RESOLUTION_8B)
+        case ADC_RESOLUTION_8BIT:
+            *value = ADC_RESOLUTION_8B;
+            break;
+#endif /* ADC_RESOLUTION_8B */
+
+#if defined(ADC_RESOLUTION_6B)
+        case ADC_RESOLUTION_6BIT:
+            *value = ADC_RESOLUTION_6B;
+            break;
+#endif /* ADC_RESOLUTION_6B */
+
+        default:
+            return OMNI_FAIL;
+    }
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Get the external trigger value of the family
+ *
+ * @param trigger ADC trigger
+ * @param value Pointer to the trigger value
+ * @return Operation status, OMNI_FAIL if the family does not have it
+ */
+static int adc_hal_get_trigger(adc_trigger_t trigger, uint32_t *value) {
+    switch (trigger) {
+        case ADC_TRIGGER_SOFTWARE:
+            *value = ADC_SOFTWARE_START;
+            break;
+
+#if defined(ADC_EXTERNALTRIGCONV_T1_CC1)
+        case ADC_TRIGGER_TIM1_CC1:
+            *value = ADC_EXTERNALTRIGCONV_T1_CC1;
+            break;
+
+        case ADC_TRIGGER_TIM1_CC2:
+            *value = ADC_EXTERNALTRIGCONV_T1_CC2;
+            break;
+
+        case ADC_TRIGGER_TIM1_CC3:
+            *value = ADC_EXTERNALTRIGCONV_T1_CC3;
+            break;
+
+        case ADC_TRIGGER_TIM2_CC2:
+            *value = ADC_EXTERNALTRIGCONV_T2_CC2;
+            break;
+
+        case ADC_TRIGGER_TIM3_TRGO:
+            *value = ADC_EXTERNALTRIGCONV_T3_TRGO;
+            break;
+
+        case ADC_TRIGGER_TIM4_CC4:
+            *value = ADC_EXTERNALTRIGCONV_T4_CC4;
+            break;
+
+#if defined(ADC_EXTERNALTRIGCONV_T2_TRGO)
+        case ADC_TRIGGER_TIM2_TRGO:
+            *value = ADC_EXTERNALTRIGCONV_T2_TRGO;
+            break;
+#endif /* ADC_EXTERNALTRIGCONV_T2_TRGO */
+
+#if defined(ADC_EXTERNALTRIGCONV_T8_TRGO)
+        case ADC_TRIGGER_TIM8_TRGO:
+            *value = ADC_EXTERNALTRIGCONV_T8_TRGO;
+            break;
+#endif /* ADC_EXTERNALTRIGCONV_T8_TRGO */
+
+#if defined(ADC_EXTERNALTRIGCONV_Ext_IT11)
+        case ADC_TRIGGER_EXTI11:
+            *value = ADC_EXTERNALTRIGCONV_Ext_IT11;
+            break;
+#elif defined(ADC_EXTERNALTRIGCONV_EXT_IT11)
+        case ADC_TRIGGER_EXTI11:
+            *value = ADC_EXTERNALTRIGCONV_EXT_IT11;
+            break;
+#endif /* ADC_EXTERNALTRIGCONV_Ext_IT11 */
+#else
+        case ADC_TRIGGER_TIM1_CC1:
+            *value = ADC_EXTERNALTRIG_T1_CC1;
+            break;
+
+        case ADC_TRIGGER_TIM1_CC2:
+            *value = ADC_EXTERNALTRIG_T1_CC2;
+            break;
+
+        case ADC_TRIGGER_TIM1_CC3:
+            *value = ADC_EXTERNALTRIG_T1_CC3;
+            break;
+
+        case ADC_TRIGGER_TIM1_TRGO:
+            *value = ADC_EXTERNALTRIG_T1_TRGO;
+            break;
+
+        case ADC_TRIGGER_TIM2_CC2:
+            *value = ADC_EXTERNALTRIG_T2_CC2;
+            break;
+
+        case ADC_TRIGGER_TIM2_TRGO:
+            *value = ADC_EXTERNALTRIG_T2_TRGO;
+            break;
+
+        case ADC_TRIGGER_TIM3_TRGO:
+            *value = ADC_EXTERNALTRIG_T3_TRGO;
+            break;
+
+        case ADC_TRIGGER_TIM4_CC4:
+            *value = ADC_EXTERNALTRIG_T4_CC4;
+            break;
+
+        case ADC_TRIGGER_TIM4_TRGO:
+            *value = ADC_EXTERNALTRIG_T4_TRGO;
+            break;
+
+        case ADC_TRIGGER_TIM6_TRGO:
+            *value = ADC_EXTERNALTRIG_T6_TRGO;
+            break;
+
+        case ADC_TRIGGER_TIM8_TRGO:
+            *value = ADC_EXTERNALTRIG_T8_TRGO;
+            break;
+
+        case ADC_TRIGGER_TIM15_TRGO:
+            *value = ADC_EXTERNALTRIG_T15_TRGO;
+            break;
+
+        case ADC_TRIGGER_EXTI11:
+            *value = ADC_EXTERNALTRIG_EXT_IT11;
+            break;
+#endif /* ADC_EXTERNALTRIGCONV_T1_CC1 */
+
+        default:
+            return OMNI_FAIL;
+    }
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Get the shortest sampling time of at least a number of cycles
+ *
+ * @param cycles Sampling time in ADC clock cycles
+ * @return Sampling time value, the longest one if cycles is above it
+ */
+static uint32_t adc_hal_get_sample_time(uint32_t cycles) {
+    uint32_t num = ARRAY_SIZE(adc_sample_half_cycles);
+
+    for (uint32_t i = 0; i < num; i++) {
+        if (adc_sample_half_cycles[i] >= (cycles * 2U)) {
+            return adc_sample_time[i];
+        }
+    }
+
+    return adc_sample_time[num - 1U];
+}
+
+/**
+ * @brief Get the number of ADCs a mode converts with
+ *
+ * @param mode Multi mode
+ * @return Number of ADCs
+ */
+static uint32_t adc_hal_get_adc_num(adc_mode_t mode) {
+    switch (mode) {
+        case ADC_MODE_DUAL_SIMULT:
+        case ADC_MODE_DUAL_INTERL:
+            return 2;
+
+        case ADC_MODE_TRIPLE_SIMULT:
+        case ADC_MODE_TRIPLE_INTERL:
+            return 3;
+
+        default:
+            return 1;
+    }
+}
+
+/**
+ * @brief Set GPIO for ADC
+ *
+ * @param dev ADC device information
+ * @param channels Bit mask of the channels
+ */
+static void adc_hal_set_gpio(adc_dev_t *dev, uint32_t channels) {
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+
+    GPIO_InitStruct.Mode = GPIO_MODE_ANALOG;
+    GPIO_InitStruct.Pull = GPIO_NOPULL;
+
+    for (uint32_t i = 0; i < dev->ch_num; i++) {
+        // Internal channels and dedicated analog pads have no GPIO
+        if (((channels & (1UL << i)) == 0U) || (dev->ch_pin[i].ins == NULL)) {
+            continue;
+        }
+
+        gpio_hal_enable_clock(dev->ch_pin[i].ins);
+        GPIO_InitStruct.Pin = dev->ch_pin[i].index;
+        HAL_GPIO_Init(dev->ch_pin[i].ins, &GPIO_InitStruct);
+    }
+}
+
+/**
+ * @brief Reset GPIO for ADC
+ *
+ * @param dev ADC device information
+ * @param channels Bit mask of the channels
+ */
+static void adc_hal_reset_gpio(adc_dev_t *dev, uint32_t channels) {
+    for (uint32_t i = 0; i < dev->ch_num; i++) {
+        if (((channels & (1UL << i)) == 0U) || (dev->ch_pin[i].ins == NULL)) {
+            continue;
+        }
+
+        HAL_GPIO_DeInit(dev->ch_pin[i].ins, dev->ch_pin[i].index);
+    }
+}
+
+/**
+ * @brief Enable ADC clock
+ *
+ * @param adc_num ADC number
+ * @return Operation status
+ */
+static int adc_hal_enable_clock(adc_num_t adc_num) {
+    switch (adc_num) {
+#if defined(ADC1) && (CONFIG_ADC_NUM_1 == 1)
+        case ADC_NUM_1:
+#if defined(CONFIG_SOC_FAMILY_STM32H7XX)
+            __HAL_RCC_ADC12_CLK_ENABLE();
+#else
+            __HAL_RCC_ADC1_CLK_ENABLE();
+#endif /* CONFIG_SOC_FAMILY_STM32H7XX */
+            break;
+#endif /* ADC1 && (CONFIG_ADC_NUM_1 == 1) */
+
+#if defined(ADC2) && (CONFIG_ADC_NUM_2 == 1)
+        case ADC_NUM_2:
+#if defined(CONFIG_SOC_FAMILY_STM32H7XX)
+            __HAL_RCC_ADC12_CLK_ENABLE();
+#else
+            __HAL_RCC_ADC2_CLK_ENABLE();
+#endif /* CONFIG_SOC_FAMILY_STM32H7XX */
+            break;
+#endif /* ADC2 && (CONFIG_ADC_NUM_2 == 1) */
+
+#if defined(ADC3) && (CONFIG_ADC_NUM_3 == 1)
+        case ADC_NUM_3:
+            __HAL_RCC_ADC3_CLK_ENABLE();
+            break;
+#endif /* ADC3 && (CONFIG_ADC_NUM_3 == 1) */
+
+        default:
+            return OMNI_FAIL;
+    }
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Reset ADC clock
+ *
+ * @param adc_num ADC number
+ */
+static void adc_hal_reset_clock(adc_num_t adc_num) {
+    switch (adc_num) {
+#if defined(ADC1) && (CONFIG_ADC_NUM_1 == 1)
+        case ADC_NUM_1:
+#if defined(CONFIG_SOC_FAMILY_STM32H7XX)
+#if (CONFIG_ADC_NUM_2 == 1)
+            if (adc_obj[ADC_NUM_2].status.is_initialized) {
+                break;
+            }
+#endif /* (CONFIG_ADC_NUM_2 == 1) */
+            __HAL_RCC_ADC12_CLK_DISABLE();
+#else
+            __HAL_RCC_ADC1_CLK_DISABLE();
+#endif /* CONFIG_SOC_FAMILY_STM32H7XX */
+            break;
+#endif /* ADC1 && (CONFIG_ADC_NUM_1 == 1) */
+
+#if defined(ADC2) && (CONFIG_ADC_NUM_2 == 1)
+        case ADC_NUM_2:
+#if defined(CONFIG_SOC_FAMILY_STM32H7XX)
+#if (CONFIG_ADC_NUM_1 == 1)
+            if (adc_obj[ADC_NUM_1].status.is_initialized) {
+                break;
+            }
+#endif /* (CONFIG_ADC_NUM_1 == 1) */
+            __HAL_RCC_ADC12_CLK_DISABLE();
+#else
+            __HAL_RCC_ADC2_CLK_DISABLE();
+#endif /* CONFIG_SOC_FAMILY_STM32H7XX */
+            break;
+#endif /* ADC2 && (CONFIG_ADC_NUM_2 == 1) */
+
+#if defined(ADC3) && (CONFIG_ADC_NUM_3 == 1)
+        case ADC_NUM_3:
+            __HAL_RCC_ADC3_CLK_DISABLE();
+            break;
+#endif /* ADC3 && (CONFIG_ADC_NUM_3 == 1) */
+
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Get ADC object
+ *
+ * @param hadc ADC handle
+ * @return ADC object
+ */
+static adc_obj_t *adc_hal_get_obj(ADC_HandleTypeDef *hadc) {
+    adc_obj_t *obj = NULL;
+
+#if defined(ADC1) && (CONFIG_ADC_NUM_1 == 1)
+    if (hadc->Instance == ADC1) {
+        obj = &adc_obj[ADC_NUM_1];
+    }
+#endif /* ADC1 && (CONFIG_ADC_NUM_1 == 1) */
+
+#if defined(ADC2) && (CONFIG_ADC_NUM_2 == 1)
+    if (hadc->Instance == ADC2) {
+        obj = &adc_obj[ADC_NUM_2];
+    }
+#endif /* ADC2 && (CONFIG_ADC_NUM_2 == 1) */
+
+#if defined(ADC3) && (CONFIG_ADC_NUM_3 == 1)
+    if (hadc->Instance == ADC3) {
+        obj = &adc_obj[ADC_NUM_3];
+    }
+#endif /* ADC3 && (CONFIG_ADC_NUM_3 == 1) */
+
+    return obj;
+}
+
+/**
+ * @brief Hand a filled block of the ring to the block callback
+ *
+ * @param hadc ADC handle
+ * @param half 0 for the first block, 1 for the second
+ */
+static void adc_hal_block_done(ADC_HandleTypeDef *hadc, uint32_t half) {
+    adc_obj_t *obj = adc_hal_get_obj(hadc);
+    omni_assert_not_null(obj);
+
+    uint32_t len = obj->data.len / 2U;
+    uint16_t *block = obj->data.buffer + (half * len);
+
+    dma_hal_circular_done(block, len * sizeof(uint16_t));
+
+    if (obj->block_cb != NULL) {
+        obj->block_cb(block, len);
+    }
+}
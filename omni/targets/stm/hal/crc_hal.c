@@ -0,0 +1,390 @@
+/**
+  * @file    crc_hal.c
+  * @author  LuckkMaker
+  * @brief   CRC HAL driver
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "drivers/crc.h"
+#include "hal/dma_hal.h"
+
+// Programmable polynomial, size and input reversal, STM32H7
+#if defined(CRC_CR_POLYSIZE)
+#define CRC_HAL_PROGRAMMABLE        1
+#endif /* CRC_CR_POLYSIZE */
+
+#if defined(CRC_HAL_PROGRAMMABLE) && defined(CONFIG_OMNI_DRIVER_DMA)
+#define CRC_HAL_DMA                 1
+#endif
+
+// Polynomial of the fixed unit, and of the programmable one after reset
+#define CRC_HAL_POLY                0x04C11DB7U
+
+static bool crc_hal_initialized;
+static volatile bool crc_hal_busy;
+#if defined(CRC_HAL_PROGRAMMABLE)
+static crc_driver_config_t crc_hal_config;
+#endif /* CRC_HAL_PROGRAMMABLE */
+#if defined(CRC_HAL_DMA)
+static uint32_t crc_hal_mask;
+static crc_event_callback crc_hal_cb;
+static void *crc_hal_arg;
+#endif /* CRC_HAL_DMA */
+
+static int crc_hal_init(void);
+static int crc_hal_deinit(void);
+static bool crc_hal_is_supported(const crc_driver_config_t *config);
+static int crc_hal_update(const crc_driver_config_t *config, uint32_t *value, const void *data, uint32_t len);
+static int crc_hal_update_async(const crc_driver_config_t *config, uint32_t value, const void *data, uint32_t len,
+                                crc_event_callback cb, void *arg);
+static crc_driver_status_t crc_hal_get_status(void);
+static bool crc_hal_acquire(void);
+static void crc_hal_load(const crc_driver_config_t *config, uint32_t value);
+static uint32_t crc_hal_feed(const crc_driver_config_t *config, const uint8_t *data, uint32_t len);
+#if defined(CRC_HAL_DMA)
+static void crc_hal_dma_done(uint32_t event, void *arg);
+#endif /* CRC_HAL_DMA */
+
+const struct crc_driver_api crc_driver = {
+    .init = crc_hal_init,
+    .deinit = crc_hal_deinit,
+    .is_supported = crc_hal_is_supported,
+    .update = crc_hal_update,
+    .update_async = crc_hal_update_async,
+    .get_status = crc_hal_get_status,
+};
+
+/**
+ * @brief Initialize CRC unit
+ *
+ * @return Operation status
+ */
+static int crc_hal_init(void) {
+    __HAL_RCC_CRC_CLK_ENABLE();
+
+#if defined(CRC_HAL_PROGRAMMABLE)
+    // Programmed on the first update
+    memset(&crc_hal_config, 0, sizeof(crc_hal_config));
+#endif /* CRC_HAL_PROGRAMMABLE */
+
+    crc_hal_busy = false;
+    crc_hal_initialized = true;
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Deinitialize CRC unit
+ *
+ * @return Operation status, OMNI_BUSY if an update is running
+ */
+static int crc_hal_deinit(void) {
+    if (crc_hal_busy) {
+        return OMNI_BUSY;
+    }
+
+    __HAL_RCC_CRC_CLK_DISABLE();
+    crc_hal_initialized = false;
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Check if the unit computes a configuration
+ *
+ * @param config Pointer to configuration
+ * @return True if supported
+ */
+static bool crc_hal_is_supported(const crc_driver_config_t *config) {
+    omni_assert_not_null(config);
+
+#if defined(CRC_HAL_PROGRAMMABLE)
+    return (config->width == 8U) || (config->width == 16U) || (config->width == 32U);
+#else
+    return (config->width == 32U) && (config->poly == CRC_HAL_POLY);
+#endif /* CRC_HAL_PROGRAMMABLE */
+}
+
+/**
+ * @brief Update a CRC register with data
+ *
+ * @param config Pointer to configuration
+ * @param value Pointer to register, MSB first, updated in place
+ * @param data Pointer to data
+ * @param len Length in bytes
+ * @return Operation status, OMNI_BUSY if the unit is in use, OMNI_FAIL if
+ *         the configuration is not supported
+ */
+static int crc_hal_update(const crc_driver_config_t *config, uint32_t *value, const void *data, uint32_t len) {
+    omni_assert_not_null(value);
+    omni_assert_not_null(data);
+
+    if (!crc_hal_initialized || !crc_hal_is_supported(config)) {
+        return OMNI_FAIL;
+    }
+
+    if (!crc_hal_acquire()) {
+        return OMNI_BUSY;
+    }
+
+    crc_hal_load(config, *value);
+    *value = crc_hal_feed(config, data, len);
+    crc_hal_busy = false;
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Update a CRC register with data, completion reported by callback
+ *
+ * @note Long updates on STM32H7 are fed by DMA and the callback is called
+ *       from the DMA interrupt, data must stay valid until then. Otherwise
+ *       the callback is called before the function returns.
+ * @param config Pointer to configuration
+ * @param value Register, MSB first
+ * @param data Pointer to data
+ * @param len Length in bytes
+ * @param cb Completion callback
+ * @param arg Callback argument
+ * @return Operation status, OMNI_BUSY if the unit is in use, OMNI_FAIL if
+ *         the configuration is not supported
+ */
+static int crc_hal_update_async(const crc_driver_config_t *config, uint32_t value, const void *data, uint32_t len,
+                                crc_event_callback cb, void *arg) {
+    omni_assert_not_null(data);
+    omni_assert_not_null(cb);
+
+    if (!crc_hal_initialized || !crc_hal_is_supported(config)) {
+        return OMNI_FAIL;
+    }
+
+    if (!crc_hal_acquire()) {
+        return OMNI_BUSY;
+    }
+
+    crc_hal_load(config, value);
+
+#if defined(CRC_HAL_DMA)
+    if (len >= CONFIG_CRC_DMA_THRESHOLD) {
+        crc_hal_mask = (config->width == 32U) ? 0xFFFFFFFFU : ((1UL << config->width) - 1U);
+        crc_hal_cb = cb;
+        crc_hal_arg = arg;
+
+        // REV_IN reverses each byte written to DR8, as for the CPU tail
+        if (dma_hal_feed(&CRC->DR, data, len, crc_hal_dma_done, NULL) == OMNI_OK) {
+            return OMNI_OK;
+        }
+    }
+#endif /* CRC_HAL_DMA */
+
+    value = crc_hal_feed(config, data, len);
+    crc_hal_busy = false;
+    cb(CRC_EVENT_COMPLETE, value, arg);
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Get CRC unit status
+ *
+ * @return CRC driver status
+ */
+static crc_driver_status_t crc_hal_get_status(void) {
+    crc_driver_status_t status = {0};
+
+    status.is_initialized = crc_hal_initialized ? 1U : 0U;
+    status.busy = crc_hal_busy ? 1U : 0U;
+
+    return status;
+}
+
+/********************* Callback functions **********************/
+
+#if defined(CRC_HAL_DMA)
+/**
+ * @brief DMA feed complete callback
+ *
+ * @param event DMA event
+ * @param arg Unused
+ */
+static void crc_hal_dma_done(uint32_t event, void *arg) {
+    uint32_t value = CRC->DR & crc_hal_mask;
+
+    (void)arg;
+
+    crc_hal_busy = false;
+
+    if ((event & DMA_EVENT_TRANSFER_COMPLETE) != 0U) {
+        crc_hal_cb(CRC_EVENT_COMPLETE, value, crc_hal_arg);
+    } else {
+        crc_hal_cb(CRC_EVENT_ERROR, 0U, crc_hal_arg);
+    }
+}
+#endif /* CRC_HAL_DMA */
+
+/********************* Private functions **********************/
+
+/**
+ * @brief Take the unit
+ *
+ * @return True if taken, false if an update is running
+ */
+static bool crc_hal_acquire(void) {
+    uint32_t primask;
+    bool taken = false;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    if (!crc_hal_busy) {
+        crc_hal_busy = true;
+        taken = true;
+    }
+
+    __set_PRIMASK(primask);
+
+    return taken;
+}
+
+#if !defined(CRC_HAL_PROGRAMMABLE)
+/**
+ * @brief Word that moves the reset register to value
+ *
+ * @note The register is only reset to 0xFFFFFFFF. A word w written after
+ *       the reset gives (0xFFFFFFFF ^ w) * x^32 mod P, so running value
+ *       back by 32 bits gives the word that loads it.
+ * @param value Register to load
+ * @return Word to write after the reset
+ */
+static uint32_t crc_hal_preload(uint32_t value) {
+    for (uint32_t i = 0; i < 32U; i++) {
+        if ((value & 1U) != 0U) {
+            value = ((value ^ CRC_HAL_POLY) >> 1) | 0x80000000U;
+        } else {
+            value >>= 1;
+        }
+    }
+
+    return value ^ 0xFFFFFFFFU;
+}
+
+/**
+ * @brief Bitwise update of the bytes after the last word
+ *
+ * @param value Register
+ * @param data Pointer to data
+ * @param len Length in bytes, less than 4
+ * @param reflect_in Input bytes LSB first
+ * @return Updated register
+ */
+static uint32_t crc_hal_tail(uint32_t value, const uint8_t *data, uint32_t len, bool reflect_in) {
+    for (uint32_t i = 0; i < len; i++) {
+        for (uint32_t bit = 0; bit < 8U; bit++) {
+            uint32_t in = reflect_in ? ((uint32_t)data[i] >> bit) : ((uint32_t)data[i] >> (7U - bit));
+
+            if (((value >> 31) ^ in) & 1U) {
+                value = (value << 1) ^ CRC_HAL_POLY;
+            } else {
+                value <<= 1;
+            }
+        }
+    }
+
+    return value;
+}
+#endif /* CRC_HAL_PROGRAMMABLE */
+
+/**
+ * @brief Program the unit and load the register
+ *
+ * @param config Pointer to configuration
+ * @param value Register to load
+ */
+static void crc_hal_load(const crc_driver_config_t *config, uint32_t value) {
+#if defined(CRC_HAL_PROGRAMMABLE)
+    if ((config->width != crc_hal_config.width) || (config->poly != crc_hal_config.poly) ||
+        (config->reflect_in != crc_hal_config.reflect_in)) {
+        uint32_t cr = 0;
+
+        if (config->width == 16U) {
+            cr |= CRC_CR_POLYSIZE_0;
+        } else if (config->width == 8U) {
+            cr |= CRC_CR_POLYSIZE_1;
+        }
+
+        // Bit reversal by byte, words are written byte swapped
+        if (config->reflect_in) {
+            cr |= CRC_CR_REV_IN_0;
+        }
+
+        CRC->POL = config->poly;
+        CRC->CR = cr;
+        crc_hal_config = *config;
+    }
+
+    CRC->INIT = value;
+    CRC->CR |= CRC_CR_RESET;
+#else
+    (void)config;
+
+    CRC->CR = CRC_CR_RESET;
+    CRC->DR = crc_hal_preload(value);
+#endif /* CRC_HAL_PROGRAMMABLE */
+}
+
+/**
+ * @brief Feed data to the loaded unit
+ *
+ * @note The unit takes a word MSB first, words are read in memory order
+ *       and swapped so that the first byte goes in first. Unaligned
+ *       data is read with unaligned loads.
+ * @param config Pointer to configuration
+ * @param data Pointer to data
+ * @param len Length in bytes
+ * @return Register after the data
+ */
+static uint32_t crc_hal_feed(const crc_driver_config_t *config, const uint8_t *data, uint32_t len) {
+    uint32_t words = len / 4U;
+    uint32_t word;
+
+    for (uint32_t i = 0; i < words; i++) {
+        memcpy(&word, data, sizeof(word));
+        data += 4;
+#if defined(CRC_HAL_PROGRAMMABLE)
+        CRC->DR = __REV(word);
+#else
+        // The fixed unit has no input reversal, LSB first bytes are mirrored with the word
+        CRC->DR = config->reflect_in ? __RBIT(word) : __REV(word);
+#endif /* CRC_HAL_PROGRAMMABLE */
+    }
+
+    len &= 3U;
+
+#if defined(CRC_HAL_PROGRAMMABLE)
+    for (uint32_t i = 0; i < len; i++) {
+        *(volatile uint8_t *)&CRC->DR = data[i];
+    }
+
+    return (config->width == 32U) ? CRC->DR : (CRC->DR & ((1UL << config->width) - 1U));
+#else
+    // The fixed unit only takes words
+    return crc_hal_tail(CRC->DR, data, len, config->reflect_in);
+#endif /* CRC_HAL_PROGRAMMABLE */
+}
@@ -21,7 +21,158 @@
   */
 
 /* Includes ------------------------------------------------------------------*/
+#include <string.h>
 #include "hal/dma_hal.h"
+#include "hal/dma_m2m.h"
+#include "ll/dma_ll.h"
+#if defined(CONFIG_MPU_NOCACHE)
+#include "mpu/mpu.h"
+#endif /* CONFIG_MPU_NOCACHE */
+#if defined(CONFIG_OMNI_DRIVER_DMA)
+#include "drivers/dma.h"
+#include "hal/irq_hal.h"
+#endif /* CONFIG_OMNI_DRIVER_DMA */
+
+// Stream based controllers of STM32F4 and STM32H7 can copy memory to memory
+#if defined(CONFIG_OMNI_DRIVER_DMA) && defined(DMA_SxCR_EN)
+#define DMA_HAL_M2M                 1
+#endif
+
+// Streams of STM32F4 and STM32H7 swap two memory buffers in hardware
+#if defined(DMA_SxCR_DBM)
+#define DMA_HAL_DOUBLE              1
+#endif
+
+// Tightly coupled memories of STM32H7, DMA1 and DMA2 cannot access them
+#if defined(D1_DTCMRAM_BASE)
+#define DMA_HAL_DTCM_BASE           0x20000000U
+#define DMA_HAL_DTCM_END            0x20020000U
+#define DMA_HAL_ITCM_END            0x00010000U
+#endif /* D1_DTCMRAM_BASE */
+
+// CCM data RAM of STM32F4 is only connected to the D-bus of the core
+#if defined(CCMDATARAM_BASE)
+#define DMA_HAL_CCM_BASE            0x10000000U
+#define DMA_HAL_CCM_END             0x10010000U
+#endif /* CCMDATARAM_BASE */
+
+/**
+ * @brief Stream ownership
+ */
+typedef struct dma_hal_slot {
+    dma_dev_t *owner;               /**< Peripheral the stream is configured for, NULL if free */
+    volatile bool lent;             /**< Used by the memory to memory driver */
+    void (*handler)(void);          /**< IRQ handler of the owner while lent */
+} dma_hal_slot_t;
+
+static dma_hal_slot_t dma_hal_slot[DMA_LL_STREAM_NUM];
+
+static int dma_hal_stream_index(const void *ins);
+static bool dma_hal_map_check(uint32_t index, const void *periph, dma_hal_dir_t dir, DMA_HandleTypeDef *handle);
+static bool dma_hal_is_reachable(const void *data, uint32_t len);
+
+#if defined(DMA_HAL_DCACHE)
+
+#if ((CONFIG_DMA_BOUNCE_SIZE % DMA_HAL_CACHE_LINE) != 0)
+#error "CONFIG_DMA_BOUNCE_SIZE must be a multiple of the cache line"
+#endif
+
+#if (CONFIG_DMA_BOUNCE_NUM > 32)
+#error "CONFIG_DMA_BOUNCE_NUM must not exceed 32"
+#endif
+
+// Placed in D2 SRAM by the linker script
+static OMNI_DMA_DATA uint8_t dma_hal_pool[CONFIG_DMA_BOUNCE_NUM][CONFIG_DMA_BOUNCE_SIZE];
+static volatile uint32_t dma_hal_pool_used;
+
+static uint8_t *dma_hal_bounce_alloc(uint32_t len);
+static void dma_hal_bounce_free(uint8_t *bounce);
+static uint32_t dma_hal_line_size(uint32_t len);
+
+#endif /* DMA_HAL_DCACHE */
+
+#if defined(CONFIG_OMNI_DRIVER_DMA)
+
+#if defined(DMA_HAL_M2M)
+// Only DMA2 of STM32F4 has a memory port on both sides
+#if defined(DMAMUX1)
+#define DMA_HAL_M2M_MASK            (CONFIG_DMA_MEMCPY_STREAM_MASK & 0xFFFFU)
+#else
+#define DMA_HAL_M2M_MASK            (CONFIG_DMA_MEMCPY_STREAM_MASK & 0xFF00U)
+#endif /* DMAMUX1 */
+
+// Destination alignment of the DMA part, head and tail bytes are copied by the CPU
+#if defined(DMA_HAL_DCACHE)
+#define DMA_HAL_M2M_ALIGN           DMA_HAL_CACHE_LINE
+#else
+#define DMA_HAL_M2M_ALIGN           4U
+#endif /* DMA_HAL_DCACHE */
+
+/**
+ * @brief Memory to memory channel
+ */
+typedef struct dma_hal_channel {
+    DMA_Stream_TypeDef *stream;     /**< Claimed stream, NULL if the channel is idle */
+    DMA_TypeDef *ins;               /**< Controller of the stream */
+    uint32_t stream_index;          /**< Index in the stream table */
+    IRQn_Type irq_num;
+    dma_dev_t *lender;              /**< Peripheral the stream is borrowed from, NULL if it was free */
+    const dma_sg_entry_t *list;     /**< Next entries */
+    uint32_t num;                   /**< Number of next entries */
+    dma_sg_entry_t single;          /**< Entry of copy and fill */
+    uint8_t *entry_dst;             /**< DMA part of the current entry */
+    uint32_t entry_len;
+    uint8_t *dst;                   /**< Next chunk of the current entry */
+    const uint8_t *src;
+    uint32_t len;                   /**< Bytes left in the current entry */
+    uint32_t chunk;                 /**< Bytes of the chunk in flight */
+    bool fill;
+    uint8_t value;                  /**< Byte value of a fill */
+    volatile void *port;            /**< Fixed byte destination of a feed, NULL otherwise */
+    dma_event_callback cb;
+    void *arg;
+} dma_hal_channel_t;
+
+// Position of the stream flags in LISR/HISR
+static const uint8_t dma_hal_flag_shift[4] = {0U, 6U, 16U, 22U};
+
+static dma_hal_channel_t dma_hal_channel[CONFIG_DMA_MEMCPY_CHANNELS];
+
+// Source word of fills, one cache line per channel
+static OMNI_DMA_DATA uint32_t dma_hal_fill_word[CONFIG_DMA_MEMCPY_CHANNELS][DMA_HAL_CACHE_LINE / 4U];
+#endif /* DMA_HAL_M2M */
+
+static bool dma_hal_initialized;
+
+static int dma_hal_init(void);
+static int dma_hal_deinit(void);
+static int dma_hal_copy(void *dst, const void *src, uint32_t len, dma_event_callback cb, void *arg);
+static int dma_hal_fill(void *dst, uint8_t value, uint32_t len, dma_event_callback cb, void *arg);
+static int dma_hal_copy_sg(const dma_sg_entry_t *list, uint32_t num, dma_event_callback cb, void *arg);
+static dma_driver_status_t dma_hal_get_status(void);
+static void dma_hal_cpu_copy_sg(const dma_sg_entry_t *list, uint32_t num);
+#if defined(DMA_HAL_M2M)
+static dma_hal_channel_t *dma_hal_channel_claim(void);
+static int dma_hal_stream_borrow(dma_dev_t **lender);
+static void dma_hal_channel_release(dma_hal_channel_t *ch);
+static void dma_hal_m2m_submit(dma_hal_channel_t *ch, const dma_sg_entry_t *list, uint32_t num,
+                               dma_event_callback cb, void *arg);
+static bool dma_hal_m2m_next(dma_hal_channel_t *ch);
+static void dma_hal_m2m_start(dma_hal_channel_t *ch);
+static void dma_hal_m2m_irq_request(dma_hal_channel_t *ch);
+static void dma_hal_m2m_irq_handler(void);
+#endif /* DMA_HAL_M2M */
+
+const struct dma_driver_api dma_driver = {
+    .init = dma_hal_init,
+    .deinit = dma_hal_deinit,
+    .copy = dma_hal_copy,
+    .fill = dma_hal_fill,
+    .copy_sg = dma_hal_copy_sg,
+    .get_status = dma_hal_get_status,
+};
+
+#endif /* CONFIG_OMNI_DRIVER_DMA */
 
 /********************* HAL functions **********************/
 
@@ -38,3 +189,1165 @@ void dma_hal_enable_clock(DMA_TypeDef *DMAx) {
     if (DMAx == DMA2) {__HAL_RCC_DMA2_CLK_ENABLE();}
 #endif /* DMA2 */
 }
+
+/**
+ * @brief Claim the stream of a peripheral DMA
+ *
+ * @note Called by the peripheral drivers at init. Fails if the stream is
+ *       not wired to the request or is configured for another peripheral,
+ *       so conflicting bindings are found before the first transfer.
+ * @param dma DMA device information
+ * @param periph Peripheral registers
+ * @param dir Request direction
+ * @return Operation status, OMNI_BUSY while the memory to memory driver uses the stream
+ */
+int dma_hal_claim(dma_dev_t *dma, const void *periph, dma_hal_dir_t dir) {
+    omni_assert_not_null(dma);
+
+    int index = dma_hal_stream_index(dma->handle->Instance);
+    int ret = OMNI_OK;
+    uint32_t primask;
+
+    if (index < 0) {
+        return OMNI_FAIL;
+    }
+
+    if (!dma_hal_map_check((uint32_t)index, periph, dir, dma->handle)) {
+        return OMNI_FAIL;
+    }
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    if ((dma_hal_slot[index].owner != NULL) && (dma_hal_slot[index].owner != dma)) {
+        ret = OMNI_FAIL;
+    } else if (dma_hal_slot[index].lent) {
+        ret = OMNI_BUSY;
+    } else {
+        dma_hal_slot[index].owner = dma;
+    }
+
+    __set_PRIMASK(primask);
+
+    return ret;
+}
+
+/**
+ * @brief Release the stream of a peripheral DMA
+ *
+ * @note Called by the peripheral drivers at deinit, waits for a memory to
+ *       memory transfer that borrowed the stream.
+ * @param dma DMA device information
+ */
+void dma_hal_release(dma_dev_t *dma) {
+    omni_assert_not_null(dma);
+
+    int index = dma_hal_stream_index(dma->handle->Instance);
+
+    if ((index < 0) || (dma_hal_slot[index].owner != dma)) {
+        return;
+    }
+
+    while (dma_hal_slot[index].lent) {
+    }
+
+    dma_hal_slot[index].owner = NULL;
+}
+
+/**
+ * @brief Start a double buffer stream
+ *
+ * @note The stream runs until dma_hal_double_stop(). swap_cb is called
+ *       from the DMA interrupt each time a buffer is finished and the
+ *       stream has switched to the other one. With the data cache enabled
+ *       both buffers must start and end on a cache line unless they are in
+ *       the non-cacheable region, there is no bounce buffer for streams.
+ * @param hdma DMA handle
+ * @param dir Request direction
+ * @param periph Peripheral data register
+ * @param buffer0 Pointer to first buffer
+ * @param buffer1 Pointer to second buffer
+ * @param num Number of data items per buffer
+ * @param len Length of a buffer in bytes
+ * @param swap_cb Buffer switch callback
+ * @param error_cb Transfer error callback
+ * @return Operation status, OMNI_FAIL if the family has no double buffer mode
+ */
+int dma_hal_double_start(DMA_HandleTypeDef *hdma, dma_hal_dir_t dir, volatile void *periph,
+                         void *buffer0, void *buffer1, uint32_t num, uint32_t len,
+                         void (*swap_cb)(DMA_HandleTypeDef *hdma), void (*error_cb)(DMA_HandleTypeDef *hdma)) {
+    omni_assert_not_null(hdma);
+    omni_assert_not_null(buffer0);
+    omni_assert_not_null(buffer1);
+    omni_assert_not_null(swap_cb);
+    omni_assert_not_null(error_cb);
+
+#if defined(DMA_HAL_DOUBLE)
+    HAL_StatusTypeDef status;
+
+    if ((num == 0U) || (num > 0xFFFFU)) {
+        return OMNI_FAIL;
+    }
+
+    if ((dma_hal_circular_prepare(buffer0, len) != OMNI_OK) ||
+        (dma_hal_circular_prepare(buffer1, len) != OMNI_OK)) {
+        return OMNI_FAIL;
+    }
+
+    hdma->XferCpltCallback = swap_cb;
+    hdma->XferM1CpltCallback = swap_cb;
+    hdma->XferHalfCpltCallback = NULL;
+    hdma->XferM1HalfCpltCallback = NULL;
+    hdma->XferErrorCallback = error_cb;
+    hdma->XferAbortCallback = NULL;
+
+    if (dir == DMA_HAL_DIR_TX) {
+        status = HAL_DMAEx_MultiBufferStart_IT(hdma, (uint32_t)buffer0, (uint32_t)periph, (uint32_t)buffer1, num);
+    } else {
+        status = HAL_DMAEx_MultiBufferStart_IT(hdma, (uint32_t)periph, (uint32_t)buffer0, (uint32_t)buffer1, num);
+    }
+
+    return (status == HAL_OK) ? OMNI_OK : OMNI_FAIL;
+#else
+    (void)dir;
+    (void)periph;
+    (void)num;
+    (void)len;
+
+    return OMNI_FAIL;
+#endif /* DMA_HAL_DOUBLE */
+}
+
+/**
+ * @brief Get the buffer a double buffer stream has just finished
+ *
+ * @note Called from swap_cb. A receive buffer is invalidated so the CPU
+ *       reads the new data, it must not be written by the CPU.
+ * @param hdma DMA handle
+ * @param dir Request direction
+ * @param len Length of a buffer in bytes
+ * @return Pointer to the buffer
+ */
+void *dma_hal_double_done(DMA_HandleTypeDef *hdma, dma_hal_dir_t dir, uint32_t len) {
+    omni_assert_not_null(hdma);
+
+#if defined(DMA_HAL_DOUBLE)
+    DMA_Stream_TypeDef *stream = (DMA_Stream_TypeDef *)hdma->Instance;
+    void *buffer;
+
+    // CT already points to the buffer in use
+    if ((stream->CR & DMA_SxCR_CT) != 0U) {
+        buffer = (void *)stream->M0AR;
+    } else {
+        buffer = (void *)stream->M1AR;
+    }
+
+#if defined(DMA_HAL_DCACHE)
+    if (dir == DMA_HAL_DIR_RX) {
+        SCB_InvalidateDCache_by_Addr(buffer, (int32_t)len);
+    }
+#else
+    (void)dir;
+    (void)len;
+#endif /* DMA_HAL_DCACHE */
+
+    return buffer;
+#else
+    (void)dir;
+    (void)len;
+
+    return NULL;
+#endif /* DMA_HAL_DOUBLE */
+}
+
+/**
+ * @brief Hand a refilled transmit buffer back to a double buffer stream
+ *
+ * @param buffer Pointer to the buffer returned by dma_hal_double_done()
+ * @param len Length of a buffer in bytes
+ */
+void dma_hal_double_refill(void *buffer, uint32_t len) {
+#if defined(DMA_HAL_DCACHE)
+    SCB_CleanDCache_by_Addr(buffer, (int32_t)len);
+#else
+    (void)buffer;
+    (void)len;
+#endif /* DMA_HAL_DCACHE */
+}
+
+/**
+ * @brief Stop a double buffer stream
+ *
+ * @param hdma DMA handle
+ */
+void dma_hal_double_stop(DMA_HandleTypeDef *hdma) {
+    omni_assert_not_null(hdma);
+
+    HAL_DMA_Abort(hdma);
+}
+
+/**
+ * @brief Prepare a buffer a DMA keeps writing or reading in a loop
+ *
+ * @note Used by circular and double buffer transfers, which run until
+ *       stopped. The buffer is used as is, there is no bounce buffer, so
+ *       with the data cache enabled it must start and end on a cache line
+ *       unless it is in the non-cacheable region.
+ * @param buffer Pointer to buffer
+ * @param len Length in bytes
+ * @return Operation status
+ */
+int dma_hal_circular_prepare(void *buffer, uint32_t len) {
+    omni_assert_not_null(buffer);
+
+    if (!dma_hal_is_reachable(buffer, len)) {
+        return OMNI_FAIL;
+    }
+
+#if defined(DMA_HAL_DCACHE)
+#if defined(CONFIG_MPU_NOCACHE)
+    if (!mpu.is_nocache(buffer, len))
+#endif /* CONFIG_MPU_NOCACHE */
+    {
+        // A line shared with other data would be written back over the transfer
+        if ((((uint32_t)buffer | len) & (DMA_HAL_CACHE_LINE - 1U)) != 0U) {
+            return OMNI_FAIL;
+        }
+
+        SCB_CleanInvalidateDCache_by_Addr(buffer, (int32_t)len);
+    }
+#endif /* DMA_HAL_DCACHE */
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Make a block a circular receive transfer has just filled visible to the CPU
+ *
+ * @note Called from the half and full transfer callbacks. The block must
+ *       not be written by the CPU.
+ * @param block Pointer to the block
+ * @param len Length of the block in bytes
+ */
+void dma_hal_circular_done(void *block, uint32_t len) {
+#if defined(DMA_HAL_DCACHE)
+    SCB_InvalidateDCache_by_Addr(block, (int32_t)len);
+#else
+    (void)block;
+    (void)len;
+#endif /* DMA_HAL_DCACHE */
+}
+
+#if defined(CONFIG_OMNI_DRIVER_DMA)
+/**
+ * @brief Write a buffer byte by byte into a fixed register
+ *
+ * @note Runs on a stream claimed like a memory copy, for data registers
+ *       of units without a DMA request such as CRC. The callback is
+ *       called from the DMA interrupt.
+ * @param port Pointer to register, written with byte accesses
+ * @param src Pointer to source
+ * @param len Length in bytes
+ * @param cb Completion callback, can be NULL
+ * @param arg Callback argument
+ * @return Operation status, OMNI_BUSY if no stream is free, OMNI_FAIL if
+ *         the DMA cannot take the buffer
+ */
+int dma_hal_feed(volatile void *port, const void *src, uint32_t len, dma_event_callback cb, void *arg) {
+    omni_assert_not_null(port);
+    omni_assert_not_null(src);
+
+#if defined(DMA_HAL_M2M)
+    dma_hal_channel_t *ch;
+
+    if (!dma_hal_initialized || (len == 0U) || !dma_hal_is_reachable(src, len)) {
+        return OMNI_FAIL;
+    }
+
+    ch = dma_hal_channel_claim();
+    if (ch == NULL) {
+        return OMNI_BUSY;
+    }
+
+#if defined(DMA_HAL_DCACHE)
+    SCB_CleanDCache_by_Addr((void *)src, (int32_t)len);
+#endif /* DMA_HAL_DCACHE */
+
+    ch->port = port;
+    ch->fill = false;
+    ch->list = NULL;
+    ch->num = 0;
+    ch->src = src;
+    ch->len = len;
+    ch->cb = cb;
+    ch->arg = arg;
+    dma_hal_m2m_start(ch);
+
+    return OMNI_OK;
+#else
+    (void)len;
+    (void)cb;
+    (void)arg;
+
+    return OMNI_FAIL;
+#endif /* DMA_HAL_M2M */
+}
+#endif /* CONFIG_OMNI_DRIVER_DMA */
+
+#if defined(DMA_HAL_DCACHE)
+/**
+ * @brief Prepare a buffer for memory to peripheral DMA
+ *
+ * @param buffer Pointer to DMA transfer buffer
+ * @param data Pointer to data
+ * @param len Length in bytes
+ * @return Address to give to DMA, NULL if no bounce buffer is available
+ */
+const void *dma_hal_tx_prepare(dma_hal_buffer_t *buffer, const void *data, uint32_t len) {
+    omni_assert_not_null(buffer);
+
+    buffer->data = (void *)data;
+    buffer->len = len;
+    buffer->bounce = NULL;
+
+#if defined(CONFIG_MPU_NOCACHE)
+    // Mapped non-cacheable by the MPU, nothing to maintain
+    if (mpu.is_nocache(data, len)) {
+        buffer->data = NULL;
+        return data;
+    }
+#endif /* CONFIG_MPU_NOCACHE */
+
+    if (dma_hal_is_reachable(data, len)) {
+        // DMA reads memory, write back the cached data
+        SCB_CleanDCache_by_Addr((void *)data, (int32_t)len);
+        return data;
+    }
+
+    buffer->bounce = dma_hal_bounce_alloc(len);
+    if (buffer->bounce == NULL) {
+        buffer->data = NULL;
+        return NULL;
+    }
+
+    memcpy(buffer->bounce, data, len);
+    SCB_CleanDCache_by_Addr(buffer->bounce, (int32_t)len);
+
+    return buffer->bounce;
+}
+
+/**
+ * @brief Prepare a buffer for peripheral to memory DMA
+ *
+ * @note The buffer content is written to memory first, so the same buffer
+ *       can be sent by a full duplex transfer. An unaligned buffer longer
+ *       than a bounce buffer is used in place, the CPU must not write data
+ *       sharing its first or last cache line until the transfer completes.
+ * @param buffer Pointer to DMA transfer buffer
+ * @param data Pointer to data
+ * @param len Length in bytes
+ * @return Address to give to DMA, NULL if no bounce buffer is available
+ */
+void *dma_hal_rx_prepare(dma_hal_buffer_t *buffer, void *data, uint32_t len) {
+    omni_assert_not_null(buffer);
+
+    buffer->data = data;
+    buffer->len = len;
+    buffer->bounce = NULL;
+
+#if defined(CONFIG_MPU_NOCACHE)
+    // Mapped non-cacheable by the MPU, nothing to maintain
+    if (mpu.is_nocache(data, len)) {
+        buffer->data = NULL;
+        return data;
+    }
+#endif /* CONFIG_MPU_NOCACHE */
+
+    // A line shared with other data could be written back over the received bytes
+    if (dma_hal_is_reachable(data, len) &&
+        (((((uint32_t)data | len) & (DMA_HAL_CACHE_LINE - 1U)) == 0U) || (len > CONFIG_DMA_BOUNCE_SIZE))) {
+        SCB_CleanInvalidateDCache_by_Addr(data, (int32_t)len);
+        return data;
+    }
+
+    buffer->bounce = dma_hal_bounce_alloc(len);
+    if (buffer->bounce == NULL) {
+        buffer->data = NULL;
+        return NULL;
+    }
+
+    memcpy(buffer->bounce, data, len);
+    SCB_CleanInvalidateDCache_by_Addr(buffer->bounce, (int32_t)dma_hal_line_size(len));
+
+    return buffer->bounce;
+}
+
+/**
+ * @brief Complete a memory to peripheral DMA
+ *
+ * @param buffer Pointer to DMA transfer buffer
+ */
+void dma_hal_tx_complete(dma_hal_buffer_t *buffer) {
+    dma_hal_abort(buffer);
+}
+
+/**
+ * @brief Complete a peripheral to memory DMA
+ *
+ * @param buffer Pointer to DMA transfer buffer
+ */
+void dma_hal_rx_complete(dma_hal_buffer_t *buffer) {
+    omni_assert_not_null(buffer);
+
+    if (buffer->data == NULL) {
+        return;
+    }
+
+    if (buffer->bounce == NULL) {
+        // Drop lines fetched speculatively during the transfer
+        SCB_InvalidateDCache_by_Addr(buffer->data, (int32_t)buffer->len);
+    } else {
+        SCB_InvalidateDCache_by_Addr(buffer->bounce, (int32_t)dma_hal_line_size(buffer->len));
+        memcpy(buffer->data, buffer->bounce, buffer->len);
+        dma_hal_bounce_free(buffer->bounce);
+        buffer->bounce = NULL;
+    }
+
+    buffer->data = NULL;
+}
+
+/**
+ * @brief Release a DMA transfer buffer without copying received data
+ *
+ * @param buffer Pointer to DMA transfer buffer
+ */
+void dma_hal_abort(dma_hal_buffer_t *buffer) {
+    omni_assert_not_null(buffer);
+
+    if (buffer->bounce != NULL) {
+        dma_hal_bounce_free(buffer->bounce);
+        buffer->bounce = NULL;
+    }
+
+    buffer->data = NULL;
+}
+
+/********************* Private functions **********************/
+
+/**
+ * @brief Allocate a bounce buffer
+ *
+ * @param len Length in bytes
+ * @return Pointer to bounce buffer, NULL if none is free or len is too large
+ */
+static uint8_t *dma_hal_bounce_alloc(uint32_t len) {
+    uint8_t *bounce = NULL;
+    uint32_t primask;
+
+    if (len > CONFIG_DMA_BOUNCE_SIZE) {
+        return NULL;
+    }
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    for (uint32_t i = 0; i < CONFIG_DMA_BOUNCE_NUM; i++) {
+        if ((dma_hal_pool_used & (1UL << i)) == 0U) {
+            dma_hal_pool_used |= (1UL << i);
+            bounce = dma_hal_pool[i];
+            break;
+        }
+    }
+
+    __set_PRIMASK(primask);
+
+    return bounce;
+}
+
+/**
+ * @brief Free a bounce buffer
+ *
+ * @param bounce Pointer to bounce buffer
+ */
+static void dma_hal_bounce_free(uint8_t *bounce) {
+    uint32_t index = (uint32_t)(bounce - dma_hal_pool[0]) / CONFIG_DMA_BOUNCE_SIZE;
+    uint32_t primask;
+
+    omni_assert(index < CONFIG_DMA_BOUNCE_NUM);
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    dma_hal_pool_used &= ~(1UL << index);
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Round a length up to whole cache lines
+ *
+ * @param len Length in bytes
+ * @return Length in bytes
+ */
+static uint32_t dma_hal_line_size(uint32_t len) {
+    return (len + DMA_HAL_CACHE_LINE - 1U) & ~(DMA_HAL_CACHE_LINE - 1U);
+}
+#endif /* DMA_HAL_DCACHE */
+
+#if defined(CONFIG_OMNI_DRIVER_DMA)
+/**
+ * @brief Initialize DMA driver
+ *
+ * @return Operation status
+ */
+static int dma_hal_init(void) {
+#if defined(DMA_HAL_M2M)
+    if ((DMA_HAL_M2M_MASK & 0x00FFU) != 0U) {
+        dma_hal_enable_clock(DMA1);
+    }
+    if ((DMA_HAL_M2M_MASK & 0xFF00U) != 0U) {
+        dma_hal_enable_clock(DMA2);
+    }
+
+    memset(dma_hal_channel, 0, sizeof(dma_hal_channel));
+#endif /* DMA_HAL_M2M */
+
+    dma_hal_initialized = true;
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Deinitialize DMA driver
+ *
+ * @return Operation status, OMNI_BUSY if a transfer is in flight
+ */
+static int dma_hal_deinit(void) {
+    if (dma_hal_get_status().busy) {
+        return OMNI_BUSY;
+    }
+
+    dma_hal_initialized = false;
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Copy memory
+ *
+ * @note The areas must not overlap.
+ * @param dst Pointer to destination
+ * @param src Pointer to source
+ * @param len Length in bytes
+ * @param cb Completion callback, can be NULL
+ * @param arg Callback argument
+ * @return Operation status, OMNI_BUSY if no stream is free
+ */
+static int dma_hal_copy(void *dst, const void *src, uint32_t len, dma_event_callback cb, void *arg) {
+    omni_assert_not_null(dst);
+    omni_assert_not_null(src);
+
+    dma_sg_entry_t entry = {.dst = dst, .src = src, .len = len};
+
+    return dma_hal_copy_sg(&entry, 1, cb, arg);
+}
+
+/**
+ * @brief Fill memory with a byte value
+ *
+ * @param dst Pointer to destination
+ * @param value Byte value
+ * @param len Length in bytes
+ * @param cb Completion callback, can be NULL
+ * @param arg Callback argument
+ * @return Operation status, OMNI_BUSY if no stream is free
+ */
+static int dma_hal_fill(void *dst, uint8_t value, uint32_t len, dma_event_callback cb, void *arg) {
+    omni_assert_not_null(dst);
+
+    if (!dma_hal_initialized) {
+        return OMNI_FAIL;
+    }
+
+#if defined(DMA_HAL_M2M)
+    if ((len >= CONFIG_DMA_MEMCPY_THRESHOLD) && dma_hal_is_reachable(dst, len)) {
+        dma_hal_channel_t *ch = dma_hal_channel_claim();
+        uint32_t *word;
+
+        if (ch == NULL) {
+            return OMNI_BUSY;
+        }
+
+        word = dma_hal_fill_word[ch - dma_hal_channel];
+        word[0] = value * 0x01010101U;
+#if defined(DMA_HAL_DCACHE)
+        SCB_CleanDCache_by_Addr(word, (int32_t)DMA_HAL_CACHE_LINE);
+#endif /* DMA_HAL_DCACHE */
+
+        ch->single.dst = dst;
+        ch->single.src = word;
+        ch->single.len = len;
+        ch->fill = true;
+        ch->value = value;
+        dma_hal_m2m_submit(ch, &ch->single, 1, cb, arg);
+
+        return OMNI_OK;
+    }
+#endif /* DMA_HAL_M2M */
+
+    memset(dst, value, len);
+    if (cb != NULL) {
+        cb(DMA_EVENT_TRANSFER_COMPLETE, arg);
+    }
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Copy a scatter-gather list
+ *
+ * @note The entries are copied in order on one stream, the list must stay
+ *       valid until the callback. Entries below the threshold or outside
+ *       DMA reachable memory are copied by the CPU in between.
+ * @param list Pointer to list
+ * @param num Number of entries
+ * @param cb Completion callback, called once for the whole list, can be NULL
+ * @param arg Callback argument
+ * @return Operation status, OMNI_BUSY if no stream is free
+ */
+static int dma_hal_copy_sg(const dma_sg_entry_t *list, uint32_t num, dma_event_callback cb, void *arg) {
+    omni_assert_not_null(list);
+
+    if (!dma_hal_initialized) {
+        return OMNI_FAIL;
+    }
+
+#if defined(DMA_HAL_M2M)
+    uint32_t total = 0;
+
+    for (uint32_t i = 0; i < num; i++) {
+        total += list[i].len;
+    }
+
+    if (total >= CONFIG_DMA_MEMCPY_THRESHOLD) {
+        dma_hal_channel_t *ch = dma_hal_channel_claim();
+
+        if (ch == NULL) {
+            return OMNI_BUSY;
+        }
+
+        // Copy the single entry, the caller's one may live on the stack
+        if (num == 1U) {
+            ch->single = list[0];
+            list = &ch->single;
+        }
+
+        ch->fill = false;
+        dma_hal_m2m_submit(ch, list, num, cb, arg);
+
+        return OMNI_OK;
+    }
+#endif /* DMA_HAL_M2M */
+
+    dma_hal_cpu_copy_sg(list, num);
+    if (cb != NULL) {
+        cb(DMA_EVENT_TRANSFER_COMPLETE, arg);
+    }
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Get DMA driver status
+ *
+ * @return DMA driver status
+ */
+static dma_driver_status_t dma_hal_get_status(void) {
+    dma_driver_status_t status = {0};
+
+    status.is_initialized = dma_hal_initialized ? 1U : 0U;
+
+#if defined(DMA_HAL_M2M)
+    for (uint32_t i = 0; i < CONFIG_DMA_MEMCPY_CHANNELS; i++) {
+        if (dma_hal_channel[i].stream != NULL) {
+            status.busy = 1U;
+        }
+    }
+#endif /* DMA_HAL_M2M */
+
+    return status;
+}
+
+#if defined(DMA_HAL_M2M)
+/********************* IRQ handlers **********************/
+
+/**
+ * @brief Memory to memory stream IRQ handler
+ *
+ * @note Shared by all claimed streams, the active IRQ selects the channel.
+ */
+static OMNI_FAST_ISR void dma_hal_m2m_irq_handler(void) {
+    IRQn_Type irq_num = (IRQn_Type)((int32_t)__get_IPSR() - 16);
+
+    for (uint32_t i = 0; i < CONFIG_DMA_MEMCPY_CHANNELS; i++) {
+        if ((dma_hal_channel[i].stream != NULL) && (dma_hal_channel[i].irq_num == irq_num)) {
+            dma_hal_m2m_irq_request(&dma_hal_channel[i]);
+        }
+    }
+}
+#endif /* DMA_HAL_M2M */
+
+/********************* Private functions **********************/
+
+/**
+ * @brief Copy a scatter-gather list with the CPU
+ *
+ * @param list Pointer to list
+ * @param num Number of entries
+ */
+static void dma_hal_cpu_copy_sg(const dma_sg_entry_t *list, uint32_t num) {
+    for (uint32_t i = 0; i < num; i++) {
+        memcpy(list[i].dst, list[i].src, list[i].len);
+    }
+}
+
+#if defined(DMA_HAL_M2M)
+/**
+ * @brief Claim a channel and an idle stream
+ *
+ * @return Pointer to channel, NULL if no channel or stream is free
+ */
+static dma_hal_channel_t *dma_hal_channel_claim(void) {
+    const dma_hal_stream_t *streams = dma_ll_get_streams();
+    dma_hal_channel_t *ch = NULL;
+    dma_dev_t *lender = NULL;
+    uint32_t primask;
+    int index = -1;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    for (uint32_t i = 0; i < CONFIG_DMA_MEMCPY_CHANNELS; i++) {
+        if (dma_hal_channel[i].stream == NULL) {
+            ch = &dma_hal_channel[i];
+            break;
+        }
+    }
+
+    if (ch != NULL) {
+        index = dma_hal_stream_borrow(&lender);
+    }
+
+    if (index >= 0) {
+        ch->stream = (DMA_Stream_TypeDef *)streams[index].ins;
+        ch->ins = streams[index].dma;
+        ch->stream_index = (uint32_t)index;
+        ch->irq_num = streams[index].irq_num;
+        ch->lender = lender;
+        ch->port = NULL;
+    } else {
+        ch = NULL;
+    }
+
+    __set_PRIMASK(primask);
+
+    if (ch == NULL) {
+        return NULL;
+    }
+
+#if defined(DMAMUX1)
+    // Request 0 of the DMAMUX channel, the transfer is started by software
+    (DMAMUX1_Channel0 + ch->stream_index)->CCR = 0U;
+#endif /* DMAMUX1 */
+
+    // The handler of a lender is restored on release
+    if (lender != NULL) {
+        dma_hal_slot[ch->stream_index].handler = irq_hal_get_handler(ch->irq_num);
+    }
+
+    irq_hal_register_handler(ch->irq_num, dma_hal_m2m_irq_handler);
+    NVIC_ClearPendingIRQ(ch->irq_num);
+    NVIC_SetPriority(ch->irq_num, \
+        NVIC_EncodePriority(NVIC_GetPriorityGrouping(), CONFIG_DMA_MEMCPY_IRQ_PRIO, 0));
+    NVIC_EnableIRQ(ch->irq_num);
+
+    return ch;
+}
+
+/**
+ * @brief Pick a stream for a memory to memory transfer
+ *
+ * @note Called with interrupts disabled. Streams no peripheral driver
+ *       claimed are taken first. With CONFIG_DMA_LEND_IDLE a stream of a
+ *       peripheral without a transfer in flight is borrowed, its HAL handle
+ *       is held busy so the peripheral cannot start one meanwhile.
+ * @param lender Set to the peripheral the stream is borrowed from
+ * @return Stream index, -1 if none is free
+ */
+static int dma_hal_stream_borrow(dma_dev_t **lender) {
+    const dma_hal_stream_t *streams = dma_ll_get_streams();
+    DMA_Stream_TypeDef *stream;
+
+    for (uint32_t i = 0; i < DMA_LL_STREAM_NUM; i++) {
+        stream = (DMA_Stream_TypeDef *)streams[i].ins;
+
+        // Also skip streams configured outside the omni drivers
+        if (((DMA_HAL_M2M_MASK & (1UL << i)) == 0U) || dma_hal_slot[i].lent ||
+            (dma_hal_slot[i].owner != NULL) || (stream->CR != 0U)) {
+            continue;
+        }
+
+        dma_hal_slot[i].lent = true;
+        *lender = NULL;
+        return (int)i;
+    }
+
+#if defined(CONFIG_DMA_LEND_IDLE)
+    for (uint32_t i = 0; i < DMA_LL_STREAM_NUM; i++) {
+        dma_dev_t *owner = dma_hal_slot[i].owner;
+
+        stream = (DMA_Stream_TypeDef *)streams[i].ins;
+
+        if (((DMA_HAL_M2M_MASK & (1UL << i)) == 0U) || dma_hal_slot[i].lent || (owner == NULL)) {
+            continue;
+        }
+
+        // HAL locks the handle before it checks the state, both must be free
+        if ((owner->handle->Lock != HAL_UNLOCKED) || (owner->handle->State != HAL_DMA_STATE_READY) ||
+            ((stream->CR & DMA_SxCR_EN) != 0U)) {
+            continue;
+        }
+
+        owner->handle->State = HAL_DMA_STATE_BUSY;
+        dma_hal_slot[i].lent = true;
+        *lender = owner;
+        return (int)i;
+    }
+#endif /* CONFIG_DMA_LEND_IDLE */
+
+    return -1;
+}
+
+/**
+ * @brief Release the stream of a channel
+ *
+ * @param ch Pointer to channel
+ */
+static void dma_hal_channel_release(dma_hal_channel_t *ch) {
+    dma_hal_slot_t *slot = &dma_hal_slot[ch->stream_index];
+    uint32_t primask;
+
+    NVIC_DisableIRQ(ch->irq_num);
+
+    ch->stream->CR = 0U;
+    while ((ch->stream->CR & DMA_SxCR_EN) != 0U) {
+    }
+
+    if (ch->lender != NULL) {
+        // Give the stream back configured for the peripheral
+        HAL_DMA_Init(ch->lender->handle);
+
+        if (slot->handler != NULL) {
+            irq_hal_register_handler(ch->irq_num, slot->handler);
+            slot->handler = NULL;
+        }
+
+        NVIC_ClearPendingIRQ(ch->irq_num);
+        NVIC_SetPriority(ch->irq_num, \
+            NVIC_EncodePriority(NVIC_GetPriorityGrouping(), ch->lender->irq_prio, 0));
+        NVIC_EnableIRQ(ch->irq_num);
+    }
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    slot->lent = false;
+    ch->stream = NULL;
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Start a list on a claimed channel
+ *
+ * @param ch Pointer to channel
+ * @param list Pointer to list
+ * @param num Number of entries
+ * @param cb Completion callback
+ * @param arg Callback argument
+ */
+static void dma_hal_m2m_submit(dma_hal_channel_t *ch, const dma_sg_entry_t *list, uint32_t num,
+                               dma_event_callback cb, void *arg) {
+    ch->list = list;
+    ch->num = num;
+    ch->cb = cb;
+    ch->arg = arg;
+
+    if (dma_hal_m2m_next(ch)) {
+        return;
+    }
+
+    // Nothing left for the DMA
+    dma_hal_channel_release(ch);
+    if (cb != NULL) {
+        cb(DMA_EVENT_TRANSFER_COMPLETE, arg);
+    }
+}
+
+/**
+ * @brief Start the DMA part of the next entry
+ *
+ * @note Bytes before the first and after the last aligned destination
+ *       address, and entries the DMA cannot take, are copied by the CPU.
+ * @param ch Pointer to channel
+ * @return True if a transfer was started, false if the list is done
+ */
+static bool dma_hal_m2m_next(dma_hal_channel_t *ch) {
+    while (ch->num > 0U) {
+        const dma_sg_entry_t *entry = ch->list;
+        uint8_t *dst = entry->dst;
+        const uint8_t *src = entry->src;
+        uint32_t len = entry->len;
+        uint32_t head;
+        uint32_t tail;
+        uint32_t dma_len;
+
+        ch->list++;
+        ch->num--;
+
+        dma_len = dma_m2m_split((uintptr_t)dst, len, DMA_HAL_M2M_ALIGN, &head, &tail);
+        if ((len < CONFIG_DMA_MEMCPY_THRESHOLD) || (dma_len == 0U) ||
+            !dma_hal_is_reachable(dst, len) || (!ch->fill && !dma_hal_is_reachable(src, len))) {
+            if (ch->fill) {
+                memset(dst, ch->value, len);
+            } else {
+                memcpy(dst, src, len);
+            }
+            continue;
+        }
+
+        if (ch->fill) {
+            memset(dst, ch->value, head);
+            memset(dst + len - tail, ch->value, tail);
+        } else {
+            memcpy(dst, src, head);
+            memcpy(dst + len - tail, src + len - tail, tail);
+            src += head;
+        }
+
+        ch->entry_dst = dst + head;
+        ch->entry_len = dma_len;
+        ch->dst = ch->entry_dst;
+        ch->src = src;
+        ch->len = dma_len;
+
+#if defined(DMA_HAL_DCACHE)
+        // Write back the source, drop the destination lines the DMA overwrites
+        if (!ch->fill) {
+            SCB_CleanDCache_by_Addr((void *)ch->src, (int32_t)ch->len);
+        }
+        SCB_InvalidateDCache_by_Addr(ch->entry_dst, (int32_t)ch->entry_len);
+#endif /* DMA_HAL_DCACHE */
+
+        dma_hal_m2m_start(ch);
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Start the next chunk of the current entry
+ *
+ * @note The destination is word aligned and the length a multiple of
+ *       words. A source that is not word aligned is read in bytes and
+ *       packed by the FIFO. The priority is left low, so peripheral
+ *       streams win the arbitration.
+ * @param ch Pointer to channel
+ */
+static void dma_hal_m2m_start(dma_hal_channel_t *ch) {
+    DMA_Stream_TypeDef *stream = ch->stream;
+    uint32_t index = ch->stream_index & 0x7U;
+    uint32_t shift = dma_hal_flag_shift[index & 0x3U];
+    uint32_t cr = DMA_SxCR_DIR_1 | DMA_SxCR_MINC | DMA_SxCR_MSIZE_1 | DMA_SxCR_TCIE | DMA_SxCR_TEIE;
+    dma_m2m_mode_t mode = DMA_M2M_MODE_PACK;
+    uint32_t count;
+
+    if (!ch->fill) {
+        cr |= DMA_SxCR_PINC;
+    }
+
+    if (ch->port != NULL) {
+        // Bytes into a fixed register
+        cr = DMA_SxCR_DIR_1 | DMA_SxCR_PINC | DMA_SxCR_TCIE | DMA_SxCR_TEIE;
+        mode = DMA_M2M_MODE_PORT;
+    } else if (ch->fill || (((uint32_t)ch->src & 0x3U) == 0U)) {
+        cr |= DMA_SxCR_PSIZE_1;
+        mode = DMA_M2M_MODE_WORD;
+    }
+    ch->chunk = dma_m2m_chunk(mode, ch->len, &count);
+
+    // Clear the stream flags
+    if (index < 4U) {
+        ch->ins->LIFCR = 0x3DUL << shift;
+    } else {
+        ch->ins->HIFCR = 0x3DUL << shift;
+    }
+
+    stream->PAR = (uint32_t)ch->src;
+    stream->M0AR = (ch->port != NULL) ? (uint32_t)ch->port : (uint32_t)ch->dst;
+    stream->NDTR = count;
+    stream->FCR = DMA_SxFCR_DMDIS | DMA_SxFCR_FTH;
+    stream->CR = cr;
+    stream->CR = cr | DMA_SxCR_EN;
+}
+
+/**
+ * @brief Handle a stream interrupt of a channel
+ *
+ * @param ch Pointer to channel
+ */
+static void dma_hal_m2m_irq_request(dma_hal_channel_t *ch) {
+    uint32_t index = ch->stream_index & 0x7U;
+    uint32_t shift = dma_hal_flag_shift[index & 0x3U];
+    dma_event_callback cb = ch->cb;
+    void *arg = ch->arg;
+    uint32_t event;
+    uint32_t flags;
+
+    if (index < 4U) {
+        flags = ch->ins->LISR >> shift;
+        ch->ins->LIFCR = 0x3DUL << shift;
+    } else {
+        flags = ch->ins->HISR >> shift;
+        ch->ins->HIFCR = 0x3DUL << shift;
+    }
+
+    if ((flags & DMA_LISR_TEIF0) != 0U) {
+        event = DMA_EVENT_TRANSFER_ERROR;
+    } else if ((flags & DMA_LISR_TCIF0) != 0U) {
+        if (ch->port == NULL) {
+            ch->dst += ch->chunk;
+        }
+        if (!ch->fill) {
+            ch->src += ch->chunk;
+        }
+        ch->len -= ch->chunk;
+
+        if (ch->len != 0U) {
+            dma_hal_m2m_start(ch);
+            return;
+        }
+
+#if defined(DMA_HAL_DCACHE)
+        // Drop lines fetched speculatively during the transfer
+        if (ch->port == NULL) {
+            SCB_InvalidateDCache_by_Addr(ch->entry_dst, (int32_t)ch->entry_len);
+        }
+#endif /* DMA_HAL_DCACHE */
+
+        if (dma_hal_m2m_next(ch)) {
+            return;
+        }
+
+        event = DMA_EVENT_TRANSFER_COMPLETE;
+    } else {
+        return;
+    }
+
+    dma_hal_channel_release(ch);
+    if (cb != NULL) {
+        cb(event, arg);
+    }
+}
+#endif /* DMA_HAL_M2M */
+#endif /* CONFIG_OMNI_DRIVER_DMA */
+
+/**
+ * @brief Check if DMA1 and DMA2 can access a buffer
+ *
+ * @param data Pointer to data
+ * @param len Length in bytes
+ * @return True if the buffer is outside the memories only the core can access
+ */
+static bool dma_hal_is_reachable(const void *data, uint32_t len) {
+    uint32_t addr = (uint32_t)data;
+
+#if defined(DMA_HAL_DTCM_BASE)
+    if (((addr + len) > DMA_HAL_DTCM_BASE) && (addr < DMA_HAL_DTCM_END)) {
+        return false;
+    }
+    if (addr < DMA_HAL_ITCM_END) {
+        return false;
+    }
+#endif /* DMA_HAL_DTCM_BASE */
+
+#if defined(DMA_HAL_CCM_BASE)
+    if (((addr + len) > DMA_HAL_CCM_BASE) && (addr < DMA_HAL_CCM_END)) {
+        return false;
+    }
+#endif /* DMA_HAL_CCM_BASE */
+
+    return true;
+}
+
+/**
+ * @brief Get the index of a stream in the stream table
+ *
+ * @param ins Stream or channel registers
+ * @return Stream index, -1 if not found
+ */
+static int dma_hal_stream_index(const void *ins) {
+    const dma_hal_stream_t *streams = dma_ll_get_streams();
+
+    for (uint32_t i = 0; i < DMA_LL_STREAM_NUM; i++) {
+        if (streams[i].ins == ins) {
+            return (int)i;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * @brief Check a stream against the request mapping of the family
+ *
+ * @param index Stream index
+ * @param periph Peripheral registers
+ * @param dir Request direction
+ * @param handle DMA handle
+ * @return True if the request can use the stream
+ */
+static bool dma_hal_map_check(uint32_t index, const void *periph, dma_hal_dir_t dir, DMA_HandleTypeDef *handle) {
+#if defined(DMAMUX1)
+    (void)index;
+    (void)periph;
+    (void)dir;
+
+    // DMAMUX routes any request to any stream
+    return handle->Init.Request != DMA_REQUEST_MEM2MEM;
+#else
+    const dma_hal_map_t *map;
+    uint32_t channel = 0;
+    uint32_t num;
+    bool known = false;
+
+#if defined(DMA_SxCR_CHSEL)
+    channel = handle->Init.Channel;
+#else
+    (void)handle;
+#endif /* DMA_SxCR_CHSEL */
+
+    map = dma_ll_get_map(&num);
+
+    for (uint32_t i = 0; i < num; i++) {
+        if ((map[i].periph != periph) || (map[i].dir != dir)) {
+            continue;
+        }
+
+        if ((map[i].stream == index) && (map[i].channel == channel)) {
+            return true;
+        }
+        known = true;
+    }
+
+    // Requests outside the mapping, such as timers, are not checked
+    return !known;
+#endif /* DMAMUX1 */
+}
@@ -26,12 +26,116 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include "include/device.h"
+#if defined(CONFIG_OMNI_DRIVER_DMA)
+#include "drivers/dma.h"
+#endif /* CONFIG_OMNI_DRIVER_DMA */
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#if defined(CONFIG_DCACHE) && defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
+#define DMA_HAL_DCACHE              1
+#endif
+
+#define DMA_HAL_CACHE_LINE          32U
+
+/**
+ * @brief DMA transfer buffer
+ *
+ * With the data cache enabled, transmit buffers are cleaned before the
+ * transfer and receive buffers are invalidated after it. A receive buffer
+ * that does not start and end on a cache line, or a buffer in DTCM which
+ * DMA1/DMA2 cannot reach, is replaced by a bounce buffer from the DMA pool
+ * for the duration of the transfer. Buffers placed in the non-cacheable
+ * region of the MPU component (MPU_NOCACHE_SECTION) are used as is.
+ *
+ * The STM32H7 linker scripts place data, bss and the stack in AXI SRAM,
+ * only OMNI_FAST_DATA is in DTCM. A DTCM buffer longer than a bounce
+ * buffer cannot be transferred.
+ */
+typedef struct dma_hal_buffer {
+    void *data;                     /**< Caller buffer */
+    uint8_t *bounce;                /**< Bounce buffer, NULL if DMA uses the caller buffer */
+    uint32_t len;                   /**< Transfer length in bytes */
+} dma_hal_buffer_t;
+
+/**
+ * @brief DMA request direction
+ */
+typedef enum {
+    DMA_HAL_DIR_TX = 0,             /**< Memory to peripheral */
+    DMA_HAL_DIR_RX = 1,             /**< Peripheral to memory */
+} dma_hal_dir_t;
+
+/**
+ * @brief DMA stream, a channel on STM32F1
+ */
+typedef struct dma_hal_stream {
+    void *ins;                      /**< Stream or channel registers */
+    DMA_TypeDef *dma;               /**< DMA controller */
+    IRQn_Type irq_num;              /**< Stream IRQ number */
+} dma_hal_stream_t;
+
+/**
+ * @brief DMA request mapping
+ *
+ * Streams and channel selections a peripheral request is wired to. Empty
+ * on STM32H7, where DMAMUX routes any request to any stream.
+ */
+typedef struct dma_hal_map {
+    const void *periph;             /**< Peripheral registers */
+    dma_hal_dir_t dir;              /**< Request direction */
+    uint8_t stream;                 /**< Index in the stream table */
+    uint32_t channel;               /**< Channel selection, 0 if the family has none */
+} dma_hal_map_t;
+
 void dma_hal_enable_clock(DMA_TypeDef *DMAx);
+int dma_hal_claim(dma_dev_t *dma, const void *periph, dma_hal_dir_t dir);
+void dma_hal_release(dma_dev_t *dma);
+int dma_hal_circular_prepare(void *buffer, uint32_t len);
+void dma_hal_circular_done(void *block, uint32_t len);
+int dma_hal_double_start(DMA_HandleTypeDef *hdma, dma_hal_dir_t dir, volatile void *periph,
+                         void *buffer0, void *buffer1, uint32_t num, uint32_t len,
+                         void (*swap_cb)(DMA_HandleTypeDef *hdma), void (*error_cb)(DMA_HandleTypeDef *hdma));
+void *dma_hal_double_done(DMA_HandleTypeDef *hdma, dma_hal_dir_t dir, uint32_t len);
+void dma_hal_double_refill(void *buffer, uint32_t len);
+void dma_hal_double_stop(DMA_HandleTypeDef *hdma);
+#if defined(CONFIG_OMNI_DRIVER_DMA)
+int dma_hal_feed(volatile void *port, const void *src, uint32_t len, dma_event_callback cb, void *arg);
+#endif /* CONFIG_OMNI_DRIVER_DMA */
+
+#if defined(DMA_HAL_DCACHE)
+const void *dma_hal_tx_prepare(dma_hal_buffer_t *buffer, const void *data, uint32_t len);
+void *dma_hal_rx_prepare(dma_hal_buffer_t *buffer, void *data, uint32_t len);
+void dma_hal_tx_complete(dma_hal_buffer_t *buffer);
+void dma_hal_rx_complete(dma_hal_buffer_t *buffer);
+void dma_hal_abort(dma_hal_buffer_t *buffer);
+#else
+static inline const void *dma_hal_tx_prepare(dma_hal_buffer_t *buffer, const void *data, uint32_t len) {
+    (void)buffer;
+    (void)len;
+    return data;
+}
+
+static inline void *dma_hal_rx_prepare(dma_hal_buffer_t *buffer, void *data, uint32_t len) {
+    (void)buffer;
+    (void)len;
+    return data;
+}
+
+static inline void dma_hal_tx_complete(dma_hal_buffer_t *buffer) {
+    (void)buffer;
+}
+
+static inline void dma_hal_rx_complete(dma_hal_buffer_t *buffer) {
+    (void)buffer;
+}
+
+static inline void dma_hal_abort(dma_hal_buffer_t *buffer) {
+    (void)buffer;
+}
+#endif /* DMA_HAL_DCACHE */
 
 #ifdef __cplusplus
 }
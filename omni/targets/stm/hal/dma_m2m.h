@@ -0,0 +1,112 @@
+/**
+  * @file    dma_m2m.h
+  * @author  LuckkMaker
+  * @brief   Transfer split of the memory to memory DMA streams
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef OMNI_HAL_DMA_M2M_H
+#define OMNI_HAL_DMA_M2M_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Address arithmetic of dma_hal.c, kept free of device headers so the
+ * host tests can check it.
+ */
+
+#define DMA_M2M_NDTR_MAX            0xFFFFU
+
+/**
+ * @brief Stream data sizes of a chunk
+ */
+typedef enum dma_m2m_mode {
+    DMA_M2M_MODE_PORT,              /**< Bytes into a fixed register */
+    DMA_M2M_MODE_WORD,              /**< Word aligned source, words on both sides */
+    DMA_M2M_MODE_PACK,              /**< Byte reads packed into words by the FIFO */
+} dma_m2m_mode_t;
+
+/**
+ * @brief Split an entry into CPU head, DMA part and CPU tail
+ *
+ * @note The DMA part starts at the first @p align boundary of the
+ *       destination and is a multiple of @p align bytes long.
+ * @param dst Destination address
+ * @param len Entry length in bytes
+ * @param align Destination alignment, a power of two
+ * @param head Bytes copied by the CPU before the DMA part
+ * @param tail Bytes copied by the CPU after the DMA part
+ * @return Length of the DMA part, 0 if the CPU copies the whole entry
+ */
+static inline uint32_t dma_m2m_split(uintptr_t dst, uint32_t len, uint32_t align,
+                                     uint32_t *head, uint32_t *tail) {
+    uint32_t before = (align - ((uint32_t)dst & (align - 1U))) & (align - 1U);
+    uint32_t after;
+
+    if (before >= len) {
+        *head = len;
+        *tail = 0U;
+        return 0U;
+    }
+
+    after = (len - before) & (align - 1U);
+    if ((before + after) == len) {
+        *head = len;
+        *tail = 0U;
+        return 0U;
+    }
+
+    *head = before;
+    *tail = after;
+
+    return len - before - after;
+}
+
+/**
+ * @brief Next chunk of a DMA part
+ *
+ * @note The destination of the word modes is word aligned and @p len a
+ *       multiple of words. A chunk of packed bytes stays a multiple of
+ *       words so the FIFO never holds a partial word.
+ * @param mode Stream data sizes
+ * @param len Bytes left in the DMA part
+ * @param count Number of data items, the NDTR value
+ * @return Bytes of the chunk
+ */
+static inline uint32_t dma_m2m_chunk(dma_m2m_mode_t mode, uint32_t len, uint32_t *count) {
+    uint32_t items = (mode == DMA_M2M_MODE_WORD) ? (len / 4U) : len;
+
+    if (items > DMA_M2M_NDTR_MAX) {
+        items = (mode == DMA_M2M_MODE_PACK) ? (DMA_M2M_NDTR_MAX & ~0x3U) : DMA_M2M_NDTR_MAX;
+    }
+    *count = items;
+
+    return (mode == DMA_M2M_MODE_WORD) ? (items * 4U) : items;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OMNI_HAL_DMA_M2M_H */
@@ -23,6 +23,9 @@
 /* Includes ------------------------------------------------------------------*/
 #include "drivers/gpio.h"
 #include "hal/gpio_hal.h"
+#if defined(CONFIG_GPIO_IRQ)
+#include "hal/irq_hal.h"
+#endif /* CONFIG_GPIO_IRQ */
 
 #define PIN_PORT(gpio_num)           ((uint8_t)(((gpio_num) >> 4) & 0xFU))
 #define PIN_NUM(gpio_num)            ((uint8_t)((gpio_num) & 0xFU))
@@ -57,19 +60,78 @@
 #error Unsupported GPIO peripheral.
 #endif
 
-static int gpio_hal_init(uint32_t gpio_num, gpio_driver_config_t *config);
-static int gpio_hal_deinit(uint32_t gpio_num);
-static int gpio_hal_set_level(uint32_t gpio_num, uint32_t level);
-static uint32_t gpio_hal_get_level(uint32_t gpio_num);
-static int gpio_hal_toggle(uint32_t gpio_num);
-
+OMNI_DRIVER_API int gpio_hal_init(uint32_t gpio_num, gpio_driver_config_t *config);
+OMNI_DRIVER_API int gpio_hal_deinit(uint32_t gpio_num);
+OMNI_DRIVER_API int gpio_hal_set_level(uint32_t gpio_num, uint32_t level);
+OMNI_DRIVER_API uint32_t gpio_hal_get_level(uint32_t gpio_num);
+OMNI_DRIVER_API int gpio_hal_toggle(uint32_t gpio_num);
+#if defined(CONFIG_GPIO_IRQ)
+OMNI_DRIVER_API int gpio_hal_irq_enable(uint32_t gpio_num, gpio_trigger_t trigger, gpio_pull_t pull, uint32_t debounce_us);
+OMNI_DRIVER_API int gpio_hal_irq_disable(uint32_t gpio_num);
+OMNI_DRIVER_API int gpio_hal_read_event(gpio_event_t *event);
+OMNI_DRIVER_API uint32_t gpio_hal_get_count(uint32_t gpio_num);
+OMNI_DRIVER_API uint32_t gpio_hal_get_lost(void);
+#endif /* CONFIG_GPIO_IRQ */
+
+#if !defined(CONFIG_OMNI_DRIVER_DIRECT_CALL)
 const struct gpio_driver_api gpio_driver = {
     .init = gpio_hal_init,
     .deinit = gpio_hal_deinit,
     .set_level = gpio_hal_set_level,
     .get_level = gpio_hal_get_level,
     .toggle = gpio_hal_toggle,
+#if defined(CONFIG_GPIO_IRQ)
+    .irq_enable = gpio_hal_irq_enable,
+    .irq_disable = gpio_hal_irq_disable,
+    .read_event = gpio_hal_read_event,
+    .get_count = gpio_hal_get_count,
+    .get_lost = gpio_hal_get_lost,
+#endif /* CONFIG_GPIO_IRQ */
 };
+#endif /* CONFIG_OMNI_DRIVER_DIRECT_CALL */
+
+#if defined(CONFIG_GPIO_IRQ)
+#define GPIO_EXTI_LINE_NUM          16U
+#define GPIO_EXTI_LINE_FREE         0xFFU
+#define GPIO_EVENT_MASK             (CONFIG_GPIO_IRQ_EVENT_NUM - 1U)
+
+#if (CONFIG_GPIO_IRQ_EVENT_NUM & GPIO_EVENT_MASK) != 0
+#error "CONFIG_GPIO_IRQ_EVENT_NUM must be a power of two"
+#endif
+
+#if defined(EXTI_D1)
+#define GPIO_EXTI_PENDING           (EXTI_D1->PR1)
+#else
+#define GPIO_EXTI_PENDING           (EXTI->PR)
+#endif /* EXTI_D1 */
+
+/**
+ * @brief EXTI line state
+ */
+typedef struct {
+    uint8_t gpio_num;               /**< GPIO owning the line */
+    uint32_t debounce;              /**< Debounce time in cycles */
+    uint32_t last;                  /**< Timestamp of the last accepted edge */
+    volatile uint32_t count;        /**< Edges seen on the line */
+} gpio_exti_line_t;
+
+/**
+ * @brief Edge event ring, written by the EXTI handlers and read by threads
+ */
+typedef struct {
+    gpio_event_t event[CONFIG_GPIO_IRQ_EVENT_NUM];
+    volatile uint32_t head;
+    volatile uint32_t tail;
+    volatile uint32_t lost;
+} gpio_event_ring_t;
+
+static gpio_exti_line_t gpio_exti_line[GPIO_EXTI_LINE_NUM];
+static gpio_event_ring_t gpio_event_ring;
+static uint32_t gpio_exti_init = 0;
+
+static void gpio_hal_exti_irq_register(void);
+static IRQn_Type gpio_hal_exti_get_irq(uint32_t line);
+#endif /* CONFIG_GPIO_IRQ */
 
 /**
  * @brief Open GPIO
@@ -78,7 +140,7 @@ const struct gpio_driver_api gpio_driver = {
  * @param config Pointer to GPIO driver configuration structure
  * @return Operation status
  */
-static int gpio_hal_init(uint32_t gpio_num, gpio_driver_config_t *config) {
+OMNI_DRIVER_API int gpio_hal_init(uint32_t gpio_num, gpio_driver_config_t *config) {
     GPIO_TypeDef *gpio_port;
     uint32_t gpio_pin;
     uint32_t gpio_mode;
@@ -117,7 +179,7 @@ static int gpio_hal_init(uint32_t gpio_num, gpio_driver_config_t *config) {
  * @param gpio_num GPIO number
  * @return Operation status
  */
-static int gpio_hal_deinit(uint32_t gpio_num) {
+OMNI_DRIVER_API int gpio_hal_deinit(uint32_t gpio_num) {
     GPIO_TypeDef *gpio_port;
     uint32_t gpio_pin;
     omni_assert(PIN_PORT(gpio_num) < GPIO_PORT_MAX);
@@ -137,15 +199,10 @@ static int gpio_hal_deinit(uint32_t gpio_num) {
  * @param level GPIO level
  * @return Operation status
  */
-static int gpio_hal_set_level(uint32_t gpio_num, uint32_t level) {
-    GPIO_TypeDef *gpio_port;
-    uint32_t gpio_pin;
+OMNI_DRIVER_API int gpio_hal_set_level(uint32_t gpio_num, uint32_t level) {
     omni_assert(PIN_PORT(gpio_num) < GPIO_PORT_MAX);
 
-    gpio_port = GET_GPIO_PORT(gpio_num);
-    gpio_pin = GET_GPIO_PIN(gpio_num);
-
-    HAL_GPIO_WritePin(gpio_port, gpio_pin, (GPIO_PinState)level);
+    gpio_hal_fast_write(gpio_num, level);
 
     return OMNI_OK;
 }
@@ -156,7 +213,7 @@ static int gpio_hal_set_level(uint32_t gpio_num, uint32_t level) {
  * @param gpio_num GPIO number
  * @return GPIO level
  */
-static uint32_t gpio_hal_get_level(uint32_t gpio_num) {
+OMNI_DRIVER_API uint32_t gpio_hal_get_level(uint32_t gpio_num) {
     GPIO_TypeDef *gpio_port;
     uint32_t gpio_pin;
     omni_assert(PIN_PORT(gpio_num) < GPIO_PORT_MAX);
@@ -173,7 +230,7 @@ static uint32_t gpio_hal_get_level(uint32_t gpio_num) {
  * @param gpio_num GPIO number
  * @return Operation status
  */
-static int gpio_hal_toggle(uint32_t gpio_num) {
+OMNI_DRIVER_API int gpio_hal_toggle(uint32_t gpio_num) {
     GPIO_TypeDef *gpio_port;
     uint32_t gpio_pin;
     omni_assert(PIN_PORT(gpio_num) < GPIO_PORT_MAX);
@@ -186,6 +243,273 @@ static int gpio_hal_toggle(uint32_t gpio_num) {
     return OMNI_OK;
 }
 
+#if defined(CONFIG_GPIO_IRQ)
+/**
+ * @brief Enable edge interrupt on a GPIO
+ *
+ * @note EXTI line n is shared by pin n of all ports, so only one port can
+ *       use a pin number at a time. Edges closer than @p debounce_us to the
+ *       last accepted edge are dropped when events are read.
+ * @param gpio_num GPIO number
+ * @param trigger Interrupt trigger edge
+ * @param pull GPIO pull
+ * @param debounce_us Debounce time in microseconds, 0 to disable
+ * @return Operation status
+ */
+OMNI_DRIVER_API int gpio_hal_irq_enable(uint32_t gpio_num, gpio_trigger_t trigger, gpio_pull_t pull, uint32_t debounce_us) {
+    GPIO_TypeDef *gpio_port;
+    uint32_t line;
+    IRQn_Type irq_num;
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+    omni_assert(PIN_PORT(gpio_num) < GPIO_PORT_MAX);
+
+    gpio_port = GET_GPIO_PORT(gpio_num);
+    line = PIN_NUM(gpio_num);
+
+    if (!gpio_exti_init) {
+        for (uint32_t i = 0; i < GPIO_EXTI_LINE_NUM; i++) {
+            gpio_exti_line[i].gpio_num = GPIO_EXTI_LINE_FREE;
+        }
+        gpio_hal_exti_irq_register();
+        gpio_exti_init = 1;
+    }
+
+    if ((gpio_exti_line[line].gpio_num != GPIO_EXTI_LINE_FREE) && (gpio_exti_line[line].gpio_num != gpio_num)) {
+        return OMNI_BUSY;
+    }
+
+    switch (trigger) {
+        case GPIO_TRIGGER_RISING:
+            GPIO_InitStruct.Mode = GPIO_MODE_IT_RISING;
+            break;
+
+        case GPIO_TRIGGER_FALLING:
+            GPIO_InitStruct.Mode = GPIO_MODE_IT_FALLING;
+            break;
+
+        default:
+            GPIO_InitStruct.Mode = GPIO_MODE_IT_RISING_FALLING;
+            break;
+    }
+
+    gpio_exti_line[line].gpio_num = (uint8_t)gpio_num;
+    gpio_exti_line[line].debounce = debounce_us * (SystemCoreClock / 1000000U);
+    gpio_exti_line[line].last = 0;
+    gpio_exti_line[line].count = 0;
+
+    // Make sure the cycle counter runs for timestamps
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    // Enable GPIO clock
+    gpio_hal_enable_clock(gpio_port);
+
+    GPIO_InitStruct.Pin = GET_GPIO_PIN(gpio_num);
+    GPIO_InitStruct.Pull = (uint32_t)pull;
+    GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
+    HAL_GPIO_Init(gpio_port, &GPIO_InitStruct);
+
+    // Enable EXTI IRQ, shared lines stay enabled while any pin uses them
+    irq_num = gpio_hal_exti_get_irq(line);
+    __HAL_GPIO_EXTI_CLEAR_IT(GET_GPIO_PIN(gpio_num));
+    NVIC_SetPriority(irq_num, \
+        NVIC_EncodePriority(NVIC_GetPriorityGrouping(), CONFIG_GPIO_IRQ_PRIO, 0));
+    NVIC_EnableIRQ(irq_num);
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Disable edge interrupt on a GPIO
+ *
+ * @param gpio_num GPIO number
+ * @return Operation status
+ */
+OMNI_DRIVER_API int gpio_hal_irq_disable(uint32_t gpio_num) {
+    uint32_t line;
+    IRQn_Type irq_num;
+    uint32_t shared = 0;
+    omni_assert(PIN_PORT(gpio_num) < GPIO_PORT_MAX);
+
+    line = PIN_NUM(gpio_num);
+
+    if (!gpio_exti_init || (gpio_exti_line[line].gpio_num != gpio_num)) {
+        return OMNI_FAIL;
+    }
+
+    HAL_GPIO_DeInit(GET_GPIO_PORT(gpio_num), GET_GPIO_PIN(gpio_num));
+    gpio_exti_line[line].gpio_num = GPIO_EXTI_LINE_FREE;
+
+    // Disable the IRQ when no other line uses it
+    irq_num = gpio_hal_exti_get_irq(line);
+    for (uint32_t i = 0; i < GPIO_EXTI_LINE_NUM; i++) {
+        if ((gpio_exti_line[i].gpio_num != GPIO_EXTI_LINE_FREE) && (gpio_hal_exti_get_irq(i) == irq_num)) {
+            shared = 1;
+        }
+    }
+
+    if (!shared) {
+        NVIC_DisableIRQ(irq_num);
+    }
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Read the next edge event
+ *
+ * @note Debounce filtering is done here in thread context, the interrupt
+ *       handler only stamps and queues edges.
+ * @param event Pointer to event
+ * @return OMNI_OK if an event was read, OMNI_FAIL if the ring is empty
+ */
+OMNI_DRIVER_API int gpio_hal_read_event(gpio_event_t *event) {
+    gpio_exti_line_t *line;
+    uint32_t tail;
+    omni_assert_not_null(event);
+
+    tail = gpio_event_ring.tail;
+    while (tail != gpio_event_ring.head) {
+        *event = gpio_event_ring.event[tail];
+        tail = (tail + 1U) & GPIO_EVENT_MASK;
+        // Release the slot after the event has been copied
+        __DMB();
+        gpio_event_ring.tail = tail;
+
+        line = &gpio_exti_line[PIN_NUM(event->gpio_num)];
+        if ((line->debounce != 0) && ((event->timestamp - line->last) < line->debounce)) {
+            continue;
+        }
+        line->last = event->timestamp;
+
+        return OMNI_OK;
+    }
+
+    return OMNI_FAIL;
+}
+
+/**
+ * @brief Get number of edges seen on a GPIO
+ *
+ * @note Counted in the interrupt before debouncing, edges are counted even
+ *       if the event ring is full.
+ * @param gpio_num GPIO number
+ * @return Number of edges
+ */
+OMNI_DRIVER_API uint32_t gpio_hal_get_count(uint32_t gpio_num) {
+    omni_assert(PIN_PORT(gpio_num) < GPIO_PORT_MAX);
+
+    return gpio_exti_line[PIN_NUM(gpio_num)].count;
+}
+
+/**
+ * @brief Get number of edge events lost on a full ring
+ *
+ * @return Number of lost events
+ */
+OMNI_DRIVER_API uint32_t gpio_hal_get_lost(void) {
+    return gpio_event_ring.lost;
+}
+
+/********************* IRQ handlers **********************/
+
+/**
+ * @brief EXTI IRQ handler
+ *
+ * @param line_mask EXTI lines served by the IRQ
+ */
+static OMNI_FAST_ISR void gpio_hal_exti_irq_request(uint32_t line_mask) {
+    uint32_t timestamp = DWT->CYCCNT;
+    uint32_t pending;
+    uint32_t line;
+    uint32_t head;
+    uint32_t next;
+    gpio_event_t *event;
+
+    pending = GPIO_EXTI_PENDING & line_mask;
+    GPIO_EXTI_PENDING = pending;
+
+    while (pending != 0) {
+        line = 31U - __CLZ(pending);
+        pending &= ~(1U << line);
+
+        gpio_exti_line[line].count++;
+
+        head = gpio_event_ring.head;
+        next = (head + 1U) & GPIO_EVENT_MASK;
+        if (next == gpio_event_ring.tail) {
+            gpio_event_ring.lost++;
+            continue;
+        }
+
+        event = &gpio_event_ring.event[head];
+        event->timestamp = timestamp;
+        event->gpio_num = gpio_exti_line[line].gpio_num;
+        event->level = (GET_GPIO_PORT(event->gpio_num)->IDR & (1U << line)) ? 1U : 0U;
+        // Publish the event after it has been written
+        __DMB();
+        gpio_event_ring.head = next;
+    }
+}
+
+static OMNI_FAST_ISR void gpio_hal_exti0_irq_handler(void) {
+    gpio_hal_exti_irq_request(0x0001U);
+}
+
+static OMNI_FAST_ISR void gpio_hal_exti1_irq_handler(void) {
+    gpio_hal_exti_irq_request(0x0002U);
+}
+
+static OMNI_FAST_ISR void gpio_hal_exti2_irq_handler(void) {
+    gpio_hal_exti_irq_request(0x0004U);
+}
+
+static OMNI_FAST_ISR void gpio_hal_exti3_irq_handler(void) {
+    gpio_hal_exti_irq_request(0x0008U);
+}
+
+static OMNI_FAST_ISR void gpio_hal_exti4_irq_handler(void) {
+    gpio_hal_exti_irq_request(0x0010U);
+}
+
+static OMNI_FAST_ISR void gpio_hal_exti9_5_irq_handler(void) {
+    gpio_hal_exti_irq_request(0x03E0U);
+}
+
+static OMNI_FAST_ISR void gpio_hal_exti15_10_irq_handler(void) {
+    gpio_hal_exti_irq_request(0xFC00U);
+}
+
+/**
+ * @brief Register EXTI IRQ handlers
+ */
+static void gpio_hal_exti_irq_register(void) {
+    irq_hal_register_handler(EXTI0_IRQn, gpio_hal_exti0_irq_handler);
+    irq_hal_register_handler(EXTI1_IRQn, gpio_hal_exti1_irq_handler);
+    irq_hal_register_handler(EXTI2_IRQn, gpio_hal_exti2_irq_handler);
+    irq_hal_register_handler(EXTI3_IRQn, gpio_hal_exti3_irq_handler);
+    irq_hal_register_handler(EXTI4_IRQn, gpio_hal_exti4_irq_handler);
+    irq_hal_register_handler(EXTI9_5_IRQn, gpio_hal_exti9_5_irq_handler);
+    irq_hal_register_handler(EXTI15_10_IRQn, gpio_hal_exti15_10_irq_handler);
+}
+
+/**
+ * @brief Get EXTI IRQ number of a line
+ *
+ * @param line EXTI line
+ * @return IRQ number
+ */
+static IRQn_Type gpio_hal_exti_get_irq(uint32_t line) {
+    if (line <= 4U) {
+        return (IRQn_Type)(EXTI0_IRQn + line);
+    } else if (line <= 9U) {
+        return EXTI9_5_IRQn;
+    } else {
+        return EXTI15_10_IRQn;
+    }
+}
+#endif /* CONFIG_GPIO_IRQ */
+
 /********************* HAL functions **********************/
 
 /**
@@ -223,6 +547,18 @@ void gpio_hal_enable_clock(GPIO_TypeDef *GPIOx) {
 #endif /* GPIOI */
 }
 
+/**
+ * @brief Get GPIO port set/reset register
+ * 
+ * @param gpio_num Any GPIO number on the port
+ * @return Pointer to the port BSRR register
+ */
+volatile uint32_t *gpio_hal_get_bsrr(uint32_t gpio_num) {
+    omni_assert(PIN_PORT(gpio_num) < GPIO_PORT_MAX);
+
+    return &(GET_GPIO_PORT(gpio_num)->BSRR);
+}
+
 #if defined(CONFIG_SOC_FAMILY_STM32F1XX)
 /**
  * @brief Set GPIO alternate function
@@ -36,15 +36,110 @@ extern "C" {
 
 #define STM32_PORT(port)    GPIO##port##_BASE
 #define GET_PIN(PORT, PIN)  ((16 * ( (STM32_PORT(PORT) - GPIOA_BASE) / (0x0400UL) )) + PIN)
+#define GET_PORT(PORT)      GET_PIN(PORT, 0)
+
+#define GPIO_HAL_PORT(gpio_num)     ((GPIO_TypeDef *)(GPIOA_BASE + (0x400U * (((gpio_num) >> 4) & 0xFU))))
+#define GPIO_HAL_PIN(gpio_num)      ((uint32_t)(1U << ((gpio_num) & 0xFU)))
 
 void gpio_hal_enable_clock(GPIO_TypeDef *GPIOx);
+volatile uint32_t *gpio_hal_get_bsrr(uint32_t gpio_num);
 
 #if defined(CONFIG_SOC_FAMILY_STM32F1XX)
 void gpio_hal_alternate(uint32_t alternate);
 #endif /* CONFIG_SOC_FAMILY_STM32F1XX */
 
+/**
+ * GPIO fast access
+ *
+ * For pins known at compile time the port address and pin mask fold into
+ * constants, so each call is a single store to BSRR or a load of IDR. The
+ * pin must be configured with gpio_driver.init() first.
+ */
+
+/**
+ * @brief Set GPIO pin high
+ *
+ * @param gpio_num GPIO number
+ */
+static inline void gpio_hal_fast_set(uint32_t gpio_num) {
+    GPIO_HAL_PORT(gpio_num)->BSRR = GPIO_HAL_PIN(gpio_num);
+}
+
+/**
+ * @brief Set GPIO pin low
+ *
+ * @param gpio_num GPIO number
+ */
+static inline void gpio_hal_fast_reset(uint32_t gpio_num) {
+    GPIO_HAL_PORT(gpio_num)->BSRR = GPIO_HAL_PIN(gpio_num) << 16U;
+}
+
+/**
+ * @brief Write GPIO pin level
+ *
+ * @param gpio_num GPIO number
+ * @param level GPIO level
+ */
+static inline void gpio_hal_fast_write(uint32_t gpio_num, uint32_t level) {
+    GPIO_HAL_PORT(gpio_num)->BSRR = GPIO_HAL_PIN(gpio_num) << (level ? 0U : 16U);
+}
+
+/**
+ * @brief Read GPIO pin level
+ *
+ * @param gpio_num GPIO number
+ * @return GPIO level
+ */
+static inline uint32_t gpio_hal_fast_read(uint32_t gpio_num) {
+    return (GPIO_HAL_PORT(gpio_num)->IDR & GPIO_HAL_PIN(gpio_num)) ? 1U : 0U;
+}
+
+/**
+ * @brief Toggle GPIO pin level
+ *
+ * @note Uses BSRR so that other pins of the port are not affected if an
+ *       interrupt writes the port in between.
+ * @param gpio_num GPIO number
+ */
+static inline void gpio_hal_fast_toggle(uint32_t gpio_num) {
+    uint32_t odr = GPIO_HAL_PORT(gpio_num)->ODR;
+
+    GPIO_HAL_PORT(gpio_num)->BSRR = ((odr & GPIO_HAL_PIN(gpio_num)) << 16U) | (~odr & GPIO_HAL_PIN(gpio_num));
+}
+
+/**
+ * @brief Set and clear several pins of a port at once
+ *
+ * @note Pins in both masks are set.
+ * @param port GPIO number of the port, see GET_PORT()
+ * @param set_mask Pins to drive high
+ * @param clear_mask Pins to drive low
+ */
+static inline void gpio_hal_write_mask(uint32_t port, uint16_t set_mask, uint16_t clear_mask) {
+    GPIO_HAL_PORT(port)->BSRR = (uint32_t)set_mask | ((uint32_t)clear_mask << 16U);
+}
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
 
+#ifdef __cplusplus
+/**
+ * @brief GPIO fast access for a pin fixed at compile time
+ *
+ * @code
+ * using flash_cs = gpio_hal_pin<GET_PIN(F, 5)>;
+ * flash_cs::reset();
+ * @endcode
+ */
+template <uint32_t gpio_num>
+struct gpio_hal_pin {
+    static inline void set(void) { gpio_hal_fast_set(gpio_num); }
+    static inline void reset(void) { gpio_hal_fast_reset(gpio_num); }
+    static inline void write(uint32_t level) { gpio_hal_fast_write(gpio_num, level); }
+    static inline uint32_t read(void) { return gpio_hal_fast_read(gpio_num); }
+    static inline void toggle(void) { gpio_hal_fast_toggle(gpio_num); }
+};
+#endif /* __cplusplus */
+
 #endif /* OMNI_HAL_GPIO_H */
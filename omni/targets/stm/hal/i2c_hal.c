@@ -25,11 +25,18 @@
 #include "hal/gpio_hal.h"
 #include "hal/dma_hal.h"
 #include "hal/irq_hal.h"
+#include "trace/trace.h"
 #include "ll/i2c_ll.h"
 
 #define I2C_CHECK_DEV_READY_TIMEOUT     1000
 
 static i2c_obj_t i2c_obj[I2C_NUM_MAX];
+#if (CONFIG_I2C_TX_DMA == 1)
+static dma_hal_buffer_t i2c_dma_tx[I2C_NUM_MAX];
+#endif /* (CONFIG_I2C_TX_DMA == 1) */
+#if (CONFIG_I2C_RX_DMA == 1)
+static dma_hal_buffer_t i2c_dma_rx[I2C_NUM_MAX];
+#endif /* (CONFIG_I2C_RX_DMA == 1) */
 
 static int i2c_hal_init(i2c_num_t i2c_num, i2c_driver_config_t *config);
 static int i2c_hal_deinit(i2c_num_t i2c_num);
@@ -69,6 +76,7 @@ static void i2c_hal_reset_gpio(i2c_dev_t *dev);
 static void i2c_hal_enable_clock(i2c_num_t i2c_num);
 static void i2c_hal_reset_clock(i2c_num_t i2c_num);
 static i2c_obj_t *i2c_hal_get_obj(I2C_HandleTypeDef *hi2c);
+static void i2c_hal_dma_complete(i2c_obj_t *obj);
 
 /**
  * @brief Open I2C bus
@@ -115,6 +123,10 @@ static int i2c_hal_init(i2c_num_t i2c_num, i2c_driver_config_t *config) {
 #if (CONFIG_I2C_TX_DMA == 1)
     // Configure DMA TX
     if (obj->dev->dma_tx != NULL) {
+        if (dma_hal_claim(obj->dev->dma_tx, obj->dev->handle->Instance, DMA_HAL_DIR_TX) != OMNI_OK) {
+            return OMNI_FAIL;
+        }
+
         dma_hal_enable_clock(obj->dev->dma_tx->ins);
 
         if (HAL_DMA_Init(obj->dev->dma_tx->handle) != HAL_OK) {
@@ -133,6 +145,10 @@ static int i2c_hal_init(i2c_num_t i2c_num, i2c_driver_config_t *config) {
 #if (CONFIG_I2C_RX_DMA == 1)
      // Configure DMA RX
     if (obj->dev->dma_rx != NULL) {
+        if (dma_hal_claim(obj->dev->dma_rx, obj->dev->handle->Instance, DMA_HAL_DIR_RX) != OMNI_OK) {
+            return OMNI_FAIL;
+        }
+
         dma_hal_enable_clock(obj->dev->dma_rx->ins);
 
         if (HAL_DMA_Init(obj->dev->dma_rx->handle) != HAL_OK) {
@@ -231,6 +247,7 @@ static int i2c_hal_deinit(i2c_num_t i2c_num) {
 #if (CONFIG_I2C_TX_DMA == 1)
     // Deinitialize I2C DMA TX
     if (obj->dev->dma_tx != NULL) {
+        dma_hal_release(obj->dev->dma_tx);
         HAL_DMA_DeInit(obj->dev->dma_tx->handle);
     }
 #endif /* (CONFIG_I2C_TX_DMA == 1) */
@@ -238,10 +255,19 @@ static int i2c_hal_deinit(i2c_num_t i2c_num) {
 #if (CONFIG_I2C_RX_DMA == 1)
     // Deinitialize I2C DMA RX
     if (obj->dev->dma_rx != NULL) {
+        dma_hal_release(obj->dev->dma_rx);
         HAL_DMA_DeInit(obj->dev->dma_rx->handle);
     }
 #endif /* (CONFIG_I2C_RX_DMA == 1) */
 
+    // Release bounce buffers of aborted transfers
+#if (CONFIG_I2C_TX_DMA == 1)
+    dma_hal_abort(&i2c_dma_tx[i2c_num]);
+#endif /* (CONFIG_I2C_TX_DMA == 1) */
+#if (CONFIG_I2C_RX_DMA == 1)
+    dma_hal_abort(&i2c_dma_rx[i2c_num]);
+#endif /* (CONFIG_I2C_RX_DMA == 1) */
+
     // Disable I2C IRQ
     NVIC_DisableIRQ(obj->dev->er_irq_num);
     NVIC_DisableIRQ(obj->dev->ev_irq_num);
@@ -343,6 +369,7 @@ static int i2c_hal_master_transmit(i2c_num_t i2c_num, uint16_t addr, const uint8
     }
 
     obj->status.busy = 1;
+    TRACE_RECORD(TRACE_EVENT_DRV_START, TRACE_DRV_I2C | i2c_num, len);
 
     if (pending) {  // If transfer should not generate STOP at the end
         if (obj->flags.no_stop == 0U) {  // First transfer without STOP generation
@@ -362,7 +389,16 @@ static int i2c_hal_master_transmit(i2c_num_t i2c_num, uint16_t addr, const uint8
     }
 
 #if (CONFIG_I2C_TX_DMA == 1)
-    status = HAL_I2C_Master_Seq_Transmit_DMA(handle, addr_temp, (uint8_t *)data, len, option);
+    const uint8_t *tx_dma = dma_hal_tx_prepare(&i2c_dma_tx[i2c_num], data, len);
+    if (tx_dma == NULL) {
+        obj->status.busy = 0;
+        return OMNI_FAIL;
+    }
+
+    status = HAL_I2C_Master_Seq_Transmit_DMA(handle, addr_temp, (uint8_t *)tx_dma, len, option);
+    if (status != HAL_OK) {
+        dma_hal_tx_complete(&i2c_dma_tx[i2c_num]);
+    }
 #else
     status = HAL_I2C_Master_Seq_Transmit_IT(handle, addr_temp, (uint8_t *)data, len, option);
 #endif /* (CONFIG_USART_TX_DMA == 1) */
@@ -412,6 +448,7 @@ static int i2c_hal_master_receive(i2c_num_t i2c_num, uint16_t addr, uint8_t *dat
     }
 
     obj->status.busy = 1;
+    TRACE_RECORD(TRACE_EVENT_DRV_START, TRACE_DRV_I2C | i2c_num, len);
 
     if (pending) {  // If transfer should not generate STOP at the end
         if (obj->flags.no_stop == 0U) {  // First transfer without STOP generation
@@ -431,7 +468,16 @@ static int i2c_hal_master_receive(i2c_num_t i2c_num, uint16_t addr, uint8_t *dat
     }
 
 #if (CONFIG_I2C_RX_DMA == 1)
-    status = HAL_I2C_Master_Seq_Receive_DMA(handle, addr_temp, data, len, option);
+    uint8_t *rx_dma = dma_hal_rx_prepare(&i2c_dma_rx[i2c_num], data, len);
+    if (rx_dma == NULL) {
+        obj->status.busy = 0;
+        return OMNI_FAIL;
+    }
+
+    status = HAL_I2C_Master_Seq_Receive_DMA(handle, addr_temp, rx_dma, len, option);
+    if (status != HAL_OK) {
+        dma_hal_abort(&i2c_dma_rx[i2c_num]);
+    }
 #else
     status = HAL_I2C_Master_Seq_Receive_IT(handle, addr_temp, data, len, option);
 #endif /* (CONFIG_USART_RX_DMA == 1) */
@@ -483,10 +529,20 @@ static int i2c_hal_slave_transmit(i2c_num_t i2c_num, const uint8_t *data, uint32
     obj->error = (i2c_driver_error_t){0};
 
     obj->status.busy = 1;
+    TRACE_RECORD(TRACE_EVENT_DRV_START, TRACE_DRV_I2C | i2c_num, len);
     obj->flags.xfer_set = 1;
 
 #if (CONFIG_I2C_TX_DMA == 1)
-    status = HAL_I2C_Slave_Seq_Transmit_DMA(handle, (uint8_t *)data, len, I2C_NEXT_FRAME);
+    const uint8_t *tx_dma = dma_hal_tx_prepare(&i2c_dma_tx[i2c_num], data, len);
+    if (tx_dma == NULL) {
+        obj->status.busy = 0;
+        return OMNI_FAIL;
+    }
+
+    status = HAL_I2C_Slave_Seq_Transmit_DMA(handle, (uint8_t *)tx_dma, len, I2C_NEXT_FRAME);
+    if (status != HAL_OK) {
+        dma_hal_tx_complete(&i2c_dma_tx[i2c_num]);
+    }
 #else
     status = HAL_I2C_Slave_Seq_Transmit_IT(handle, (uint8_t *)data, len, I2C_NEXT_FRAME);
 #endif /* (CONFIG_I2C_TX_DMA == 1) */
@@ -532,12 +588,22 @@ static int i2c_hal_slave_receive(i2c_num_t i2c_num, uint8_t *data, uint32_t len)
     obj->error = (i2c_driver_error_t){0};
 
     obj->status.busy = 1;
+    TRACE_RECORD(TRACE_EVENT_DRV_START, TRACE_DRV_I2C | i2c_num, len);
     obj->flags.xfer_set = 1;
 
     I2C_HandleTypeDef *handle = obj->dev->handle;
 
 #if (CONFIG_I2C_RX_DMA == 1)
-    status = HAL_I2C_Slave_Seq_Receive_DMA(handle, (uint8_t *)data, len, I2C_NEXT_FRAME);
+    uint8_t *rx_dma = dma_hal_rx_prepare(&i2c_dma_rx[i2c_num], data, len);
+    if (rx_dma == NULL) {
+        obj->status.busy = 0;
+        return OMNI_FAIL;
+    }
+
+    status = HAL_I2C_Slave_Seq_Receive_DMA(handle, rx_dma, len, I2C_NEXT_FRAME);
+    if (status != HAL_OK) {
+        dma_hal_abort(&i2c_dma_rx[i2c_num]);
+    }
 #else
     status = HAL_I2C_Slave_Seq_Receive_IT(handle, (uint8_t *)data, len, I2C_NEXT_FRAME);
 #endif /* (CONFIG_I2C_RX_DMA == 1) */
@@ -588,6 +654,7 @@ static int i2c_hal_write(i2c_num_t i2c_num, uint16_t dev_addr, uint16_t mem_addr
     }
 
     obj->status.busy = 1;
+    TRACE_RECORD(TRACE_EVENT_DRV_START, TRACE_DRV_I2C | i2c_num, len);
 
     if (mem_addr_size == I2C_MEM_ADDR_SIZE_8) {
         mem_addr_temp = I2C_MEMADD_SIZE_8BIT;
@@ -596,7 +663,16 @@ static int i2c_hal_write(i2c_num_t i2c_num, uint16_t dev_addr, uint16_t mem_addr
     }
 
 #if (CONFIG_I2C_TX_DMA == 1)
-    status = HAL_I2C_Mem_Write_DMA(handle, addr_temp, mem_addr, mem_addr_temp, (uint8_t *)data, len);
+    const uint8_t *tx_dma = dma_hal_tx_prepare(&i2c_dma_tx[i2c_num], data, len);
+    if (tx_dma == NULL) {
+        obj->status.busy = 0;
+        return OMNI_FAIL;
+    }
+
+    status = HAL_I2C_Mem_Write_DMA(handle, addr_temp, mem_addr, mem_addr_temp, (uint8_t *)tx_dma, len);
+    if (status != HAL_OK) {
+        dma_hal_tx_complete(&i2c_dma_tx[i2c_num]);
+    }
 #else
     status = HAL_I2C_Mem_Write_IT(handle, addr_temp, mem_addr, mem_addr_temp, (uint8_t *)data, len);
 #endif /* (CONFIG_USART_TX_DMA == 1) */
@@ -647,6 +723,7 @@ static int i2c_hal_read(i2c_num_t i2c_num, uint16_t dev_addr, uint16_t mem_addr,
     }
 
     obj->status.busy = 1;
+    TRACE_RECORD(TRACE_EVENT_DRV_START, TRACE_DRV_I2C | i2c_num, len);
 
     if (mem_addr_size == I2C_MEM_ADDR_SIZE_8) {
         mem_addr_temp = I2C_MEMADD_SIZE_8BIT;
@@ -655,7 +732,16 @@ static int i2c_hal_read(i2c_num_t i2c_num, uint16_t dev_addr, uint16_t mem_addr,
     }
 
 #if (CONFIG_I2C_RX_DMA == 1)
-    status = HAL_I2C_Mem_Read_DMA(handle, addr_temp, mem_addr, mem_addr_temp, data, len);
+    uint8_t *rx_dma = dma_hal_rx_prepare(&i2c_dma_rx[i2c_num], data, len);
+    if (rx_dma == NULL) {
+        obj->status.busy = 0;
+        return OMNI_FAIL;
+    }
+
+    status = HAL_I2C_Mem_Read_DMA(handle, addr_temp, mem_addr, mem_addr_temp, rx_dma, len);
+    if (status != HAL_OK) {
+        dma_hal_abort(&i2c_dma_rx[i2c_num]);
+    }
 #else
     status = HAL_I2C_Mem_Read_IT(handle, addr_temp, mem_addr, mem_addr_temp, data, len);
 #endif /* (CONFIG_USART_RX_DMA == 1) */
@@ -744,26 +830,26 @@ static i2c_driver_error_t i2c_hal_get_error(i2c_num_t i2c_num) {
 /**
  * @brief I2C event IRQ handler
  */
-static void i2c_hal_ev_irq_request(i2c_obj_t *obj) {
+static OMNI_FAST_ISR void i2c_hal_ev_irq_request(i2c_obj_t *obj) {
     HAL_I2C_EV_IRQHandler(obj->dev->handle);
 }
 /**
  * @brief I2C error IRQ handler
  */
-static void i2c_hal_er_irq_request(i2c_obj_t *obj) {
+static OMNI_FAST_ISR void i2c_hal_er_irq_request(i2c_obj_t *obj) {
     HAL_I2C_ER_IRQHandler(obj->dev->handle);
 }
 #if (CONFIG_I2C_NUM_1 == 1)
 /**
  * @brief I2C1 event IRQ handler
  */
-static void i2c1_event_irq_handler(void) {
+static OMNI_FAST_ISR void i2c1_event_irq_handler(void) {
     i2c_hal_ev_irq_request(&i2c_obj[I2C_NUM_1]);
 }
 /**
  * @brief I2C1 error IRQ handler
  */
-static void i2c1_error_irq_handler(void) {
+static OMNI_FAST_ISR void i2c1_error_irq_handler(void) {
     i2c_hal_er_irq_request(&i2c_obj[I2C_NUM_1]);
 }
 #endif /* (CONFIG_I2C_NUM_1 == 1) */
@@ -771,13 +857,13 @@ static void i2c1_error_irq_handler(void) {
 /**
  * @brief I2C2 event IRQ handler
  */
-static void i2c2_event_irq_handler(void) {
+static OMNI_FAST_ISR void i2c2_event_irq_handler(void) {
     i2c_hal_ev_irq_request(&i2c_obj[I2C_NUM_2]);
 }
 /**
  * @brief I2C2 error IRQ handler
  */
-static void i2c2_error_irq_handler(void) {
+static OMNI_FAST_ISR void i2c2_error_irq_handler(void) {
     i2c_hal_er_irq_request(&i2c_obj[I2C_NUM_2]);
 }
 #endif /* (CONFIG_I2C_NUM_2 == 1) */
@@ -785,30 +871,30 @@ static void i2c2_error_irq_handler(void) {
 /**
  * @brief I2C3 event IRQ handler
  */
-static void i2c3_event_irq_handler(void) {
+static OMNI_FAST_ISR void i2c3_event_irq_handler(void) {
     i2c_hal_ev_irq_request(&i2c_obj[I2C_NUM_3]);
 }
 /**
  * @brief I2C3 error IRQ handler
  */
-static void i2c3_error_irq_handler(void) {
+static OMNI_FAST_ISR void i2c3_error_irq_handler(void) {
     i2c_hal_er_irq_request(&i2c_obj[I2C_NUM_3]);
 }
 #endif /* (CONFIG_I2C_NUM_3 == 1) */
 
 #if (CONFIG_I2C_TX_DMA == 1)
 #if (CONFIG_I2C1_TX_DMA == 1)
-void i2c1_tx_dma_irq_handler(void) {
+OMNI_FAST_ISR void i2c1_tx_dma_irq_handler(void) {
     HAL_DMA_IRQHandler(i2c_obj[I2C_NUM_1].dev->dma_tx->handle);
 }
 #endif /* (CONFIG_I2C1_TX_DMA == 1) */
 #if (CONFIG_I2C2_TX_DMA == 1)
-void i2c2_tx_dma_irq_handler(void) {
+OMNI_FAST_ISR void i2c2_tx_dma_irq_handler(void) {
     HAL_DMA_IRQHandler(i2c_obj[I2C_NUM_2].dev->dma_tx->handle);
 }
 #endif /* (CONFIG_I2C2_TX_DMA == 1) */
 #if (CONFIG_I2C3_TX_DMA == 1)
-void i2c3_tx_dma_irq_handler(void) {
+OMNI_FAST_ISR void i2c3_tx_dma_irq_handler(void) {
     HAL_DMA_IRQHandler(i2c_obj[I2C_NUM_3].dev->dma_tx->handle);
 }
 #endif /* (CONFIG_I2C3_TX_DMA == 1) */
@@ -816,17 +902,17 @@ void i2c3_tx_dma_irq_handler(void) {
 
 #if (CONFIG_I2C_RX_DMA == 1)
 #if (CONFIG_I2C1_RX_DMA == 1)
-void i2c1_rx_dma_irq_handler(void) {
+OMNI_FAST_ISR void i2c1_rx_dma_irq_handler(void) {
     HAL_DMA_IRQHandler(i2c_obj[I2C_NUM_1].dev->dma_rx->handle);
 }
 #endif /* (CONFIG_I2C1_RX_DMA == 1) */
 #if (CONFIG_I2C2_RX_DMA == 1)
-void i2c2_rx_dma_irq_handler(void) {
+OMNI_FAST_ISR void i2c2_rx_dma_irq_handler(void) {
     HAL_DMA_IRQHandler(i2c_obj[I2C_NUM_2].dev->dma_rx->handle);
 }
 #endif /* (CONFIG_I2C2_RX_DMA == 1) */
 #if (CONFIG_I2C3_RX_DMA == 1)
-void i2c3_rx_dma_irq_handler(void) {
+OMNI_FAST_ISR void i2c3_rx_dma_irq_handler(void) {
     HAL_DMA_IRQHandler(i2c_obj[I2C_NUM_3].dev->dma_rx->handle);
 }
 #endif /* (CONFIG_I2C3_RX_DMA == 1) */
@@ -885,7 +971,10 @@ void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c) {
     i2c_obj_t *obj = i2c_hal_get_obj(hi2c);
     omni_assert_not_null(obj);
 
+    i2c_hal_dma_complete(obj);
+
     obj->status.busy = 0U;
+    TRACE_RECORD(TRACE_EVENT_DRV_COMPLETE, TRACE_DRV_I2C | (uint32_t)(obj - i2c_obj), 0);
 
     if (obj->event_cb != NULL) {
         obj->event_cb(I2C_EVENT_TRANSFER_COMPLETE);
@@ -896,7 +985,10 @@ void HAL_I2C_MasterRxCpltCallback(I2C_HandleTypeDef *hi2c) {
     i2c_obj_t *obj = i2c_hal_get_obj(hi2c);
     omni_assert_not_null(obj);
 
+    i2c_hal_dma_complete(obj);
+
     obj->status.busy = 0U;
+    TRACE_RECORD(TRACE_EVENT_DRV_COMPLETE, TRACE_DRV_I2C | (uint32_t)(obj - i2c_obj), 0);
 
     if (obj->event_cb != NULL) {
         obj->event_cb(I2C_EVENT_TRANSFER_COMPLETE);
@@ -907,7 +999,10 @@ void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef *hi2c) {
     i2c_obj_t *obj = i2c_hal_get_obj(hi2c);
     omni_assert_not_null(obj);
 
+    i2c_hal_dma_complete(obj);
+
     obj->status.busy = 0U;
+    TRACE_RECORD(TRACE_EVENT_DRV_COMPLETE, TRACE_DRV_I2C | (uint32_t)(obj - i2c_obj), 0);
 
     if (obj->event_cb != NULL) {
         obj->event_cb(I2C_EVENT_TRANSFER_COMPLETE);
@@ -918,7 +1013,10 @@ void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c) {
     i2c_obj_t *obj = i2c_hal_get_obj(hi2c);
     omni_assert_not_null(obj);
 
+    i2c_hal_dma_complete(obj);
+
     obj->status.busy = 0U;
+    TRACE_RECORD(TRACE_EVENT_DRV_COMPLETE, TRACE_DRV_I2C | (uint32_t)(obj - i2c_obj), 0);
 
     if (obj->event_cb != NULL) {
         obj->event_cb(I2C_EVENT_TRANSFER_COMPLETE);
@@ -963,8 +1061,11 @@ void HAL_I2C_SlaveTxCpltCallback(I2C_HandleTypeDef *hi2c) {
     i2c_obj_t *obj = i2c_hal_get_obj(hi2c);
     omni_assert_not_null(obj);
 
+    i2c_hal_dma_complete(obj);
+
     obj->flags.xfer_set = 0;
     obj->status.busy = 0U;
+    TRACE_RECORD(TRACE_EVENT_DRV_COMPLETE, TRACE_DRV_I2C | (uint32_t)(obj - i2c_obj), 0);
 
     if (obj->event_cb != NULL) {
         obj->event_cb(I2C_EVENT_TRANSFER_COMPLETE);
@@ -975,8 +1076,11 @@ void HAL_I2C_SlaveRxCpltCallback(I2C_HandleTypeDef *hi2c) {
     i2c_obj_t *obj = i2c_hal_get_obj(hi2c);
     omni_assert_not_null(obj);
 
+    i2c_hal_dma_complete(obj);
+
     obj->flags.xfer_set = 0;
     obj->status.busy = 0U;
+    TRACE_RECORD(TRACE_EVENT_DRV_COMPLETE, TRACE_DRV_I2C | (uint32_t)(obj - i2c_obj), 0);
 
     if (obj->event_cb != NULL) {
         obj->event_cb(I2C_EVENT_TRANSFER_COMPLETE);
@@ -996,6 +1100,8 @@ void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c) {
     i2c_obj_t *obj = i2c_hal_get_obj(hi2c);
     omni_assert_not_null(obj);
 
+    i2c_hal_dma_complete(obj);
+
     error = HAL_I2C_GetError(hi2c);
 
     event = I2C_EVENT_TRANSFER_COMPLETE | I2C_EVENT_TRANSFER_INCOMPLETE;
@@ -1019,6 +1125,7 @@ void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c) {
     }
 
     obj->status.busy = 0U;
+    TRACE_RECORD(TRACE_EVENT_DRV_ERROR, TRACE_DRV_I2C | (uint32_t)(obj - i2c_obj), 0);
 
     if (obj->event_cb != NULL) {
         obj->event_cb(event);
@@ -1175,3 +1282,17 @@ static i2c_obj_t *i2c_hal_get_obj(I2C_HandleTypeDef *hi2c) {
 
     return obj;
 }
+
+/**
+ * @brief Complete the DMA buffers of a transfer
+ * 
+ * @param obj I2C object
+ */
+static void i2c_hal_dma_complete(i2c_obj_t *obj) {
+#if (CONFIG_I2C_TX_DMA == 1)
+    dma_hal_tx_complete(&i2c_dma_tx[obj - i2c_obj]);
+#endif /* (CONFIG_I2C_TX_DMA == 1) */
+#if (CONFIG_I2C_RX_DMA == 1)
+    dma_hal_rx_complete(&i2c_dma_rx[obj - i2c_obj]);
+#endif /* (CONFIG_I2C_RX_DMA == 1) */
+}
@@ -23,14 +23,26 @@
 /* Includes ------------------------------------------------------------------*/
 #include "drivers/init.h"
 #include "hal/dwt_hal.h"
+#if defined(CONFIG_COMPONENT_MPU)
+#include "mpu/mpu.h"
+#endif /* CONFIG_COMPONENT_MPU */
 
 /**
  * @brief Initialize device
  */
 void device_init(void) {
+#if defined(CONFIG_COMPONENT_MPU)
+    // Regions must be set before the caches hold any of their lines
+    if (mpu.init() != OMNI_OK) {
+        error_handler(__FILE__, __LINE__);
+    }
+#endif /* CONFIG_COMPONENT_MPU */
 #if defined(CONFIG_SOC_FAMILY_STM32H7XX)
     SCB_EnableICache();
-    // SCB_EnableDCache();
+#if defined(CONFIG_DCACHE)
+    // DMA buffers are maintained by the drivers, see hal/dma_hal.h
+    SCB_EnableDCache();
+#endif /* CONFIG_DCACHE */
 #endif /* CONFIG_SOC_FAMILY_STM32H7XX */
     HAL_Init();
 }
@@ -25,23 +25,34 @@
 #include "hal/gpio_hal.h"
 #include "hal/dma_hal.h"
 #include "hal/irq_hal.h"
+#include "trace/trace.h"
 #include "ll/spi_ll.h"
 
 #define _SPI_DATASIZE(bits)     SPI_DATASIZE_##bits##_BIT
 #define SPI_DATASIZE(bits)      _SPI_DATASIZE(bits)
 
 static spi_obj_t spi_obj[SPI_NUM_MAX];
+#if (CONFIG_SPI_TX_DMA == 1)
+static dma_hal_buffer_t spi_dma_tx[SPI_NUM_MAX];
+#endif /* (CONFIG_SPI_TX_DMA == 1) */
+#if ((CONFIG_SPI_TX_DMA == 1) && (CONFIG_SPI_RX_DMA == 1))
+static dma_hal_buffer_t spi_dma_rx[SPI_NUM_MAX];
+#endif /* ((CONFIG_SPI_TX_DMA == 1) && (CONFIG_SPI_RX_DMA == 1)) */
 
-static int spi_hal_init(spi_num_t spi_num, spi_driver_config_t *config);
-static int spi_hal_deinit(spi_num_t spi_num);
-static void spi_hal_start(spi_num_t spi_num);
-static void spi_hal_stop(spi_num_t spi_num);
-static int spi_hal_send(spi_num_t spi_num, const void *data, uint32_t len);
-static int spi_hal_receive(spi_num_t spi_num, void *data, uint32_t len);
-static int spi_hal_transfer(spi_num_t spi_num, const void *tx_data, void *rx_data, uint32_t len);
-static spi_driver_status_t spi_hal_get_status(spi_num_t spi_num);
-static spi_driver_error_t spi_hal_get_error(spi_num_t spi_num);
-
+OMNI_DRIVER_API int spi_hal_init(spi_num_t spi_num, spi_driver_config_t *config);
+OMNI_DRIVER_API int spi_hal_deinit(spi_num_t spi_num);
+OMNI_DRIVER_API void spi_hal_start(spi_num_t spi_num);
+OMNI_DRIVER_API void spi_hal_stop(spi_num_t spi_num);
+OMNI_DRIVER_API int spi_hal_send(spi_num_t spi_num, const void *data, uint32_t len);
+OMNI_DRIVER_API int spi_hal_receive(spi_num_t spi_num, void *data, uint32_t len);
+OMNI_DRIVER_API int spi_hal_transfer(spi_num_t spi_num, const void *tx_data, void *rx_data, uint32_t len);
+OMNI_DRIVER_API int spi_hal_stream_send(spi_num_t spi_num, void *buffer0, void *buffer1, uint32_t len, spi_stream_callback cb);
+OMNI_DRIVER_API int spi_hal_stream_receive(spi_num_t spi_num, void *buffer0, void *buffer1, uint32_t len, spi_stream_callback cb);
+OMNI_DRIVER_API void spi_hal_stream_stop(spi_num_t spi_num);
+OMNI_DRIVER_API spi_driver_status_t spi_hal_get_status(spi_num_t spi_num);
+OMNI_DRIVER_API spi_driver_error_t spi_hal_get_error(spi_num_t spi_num);
+
+#if !defined(CONFIG_OMNI_DRIVER_DIRECT_CALL)
 const struct spi_driver_api spi_driver = {
     .init = spi_hal_init,
     .deinit = spi_hal_deinit,
@@ -50,9 +61,13 @@ const struct spi_driver_api spi_driver = {
     .send = spi_hal_send,
     .receive = spi_hal_receive,
     .transfer = spi_hal_transfer,
+    .stream_send = spi_hal_stream_send,
+    .stream_receive = spi_hal_stream_receive,
+    .stream_stop = spi_hal_stream_stop,
     .get_status = spi_hal_get_status,
     .get_error = spi_hal_get_error,
 };
+#endif /* CONFIG_OMNI_DRIVER_DIRECT_CALL */
 
 static uint32_t spi_hal_get_clock(spi_dev_t *dev);
 static int spi_hal_configure(spi_dev_t *dev, spi_driver_config_t *config);
@@ -62,6 +77,19 @@ static void spi_hal_reset_gpio(spi_dev_t *dev);
 static int spi_hal_enable_clock(spi_num_t spi_num);
 static void spi_hal_reset_clock(spi_num_t spi_num);
 static spi_obj_t *spi_hal_get_obj(SPI_HandleTypeDef *hspi);
+#if (CONFIG_SPI_TX_DMA == 1)
+static uint32_t spi_hal_get_bytes(SPI_HandleTypeDef *handle, uint32_t len);
+static uint32_t spi_hal_get_frame_bytes(SPI_HandleTypeDef *handle);
+static int spi_hal_dma_set_width(spi_dev_t *dev);
+#endif /* (CONFIG_SPI_TX_DMA == 1) */
+static void spi_hal_dma_complete(spi_obj_t *obj);
+#if (CONFIG_SPI_TX_DMA == 1)
+static int spi_hal_stream_start(spi_obj_t *obj, void *buffer0, void *buffer1, uint32_t len, spi_stream_callback cb, bool rx);
+static spi_stream_callback spi_hal_stream_end(spi_obj_t *obj);
+static void spi_tx_stream_callback(DMA_HandleTypeDef *hdma);
+static void spi_rx_stream_callback(DMA_HandleTypeDef *hdma);
+static void spi_stream_error_callback(DMA_HandleTypeDef *hdma);
+#endif /* (CONFIG_SPI_TX_DMA == 1) */
 
 /**
  * @brief Initialize SPI bus
@@ -70,7 +98,7 @@ static spi_obj_t *spi_hal_get_obj(SPI_HandleTypeDef *hspi);
  * @param config Pointer to the SPI driver configuration
  * @return Operation status
  */
-static int spi_hal_init(spi_num_t spi_num, spi_driver_config_t *config) {
+OMNI_DRIVER_API int spi_hal_init(spi_num_t spi_num, spi_driver_config_t *config) {
     omni_assert(spi_num < SPI_NUM_MAX);
     omni_assert_not_null(config);
 
@@ -108,6 +136,10 @@ static int spi_hal_init(spi_num_t spi_num, spi_driver_config_t *config) {
 #if (CONFIG_SPI_TX_DMA == 1)
     // Initialize SPI DMA TX
     if (obj->dev->dma_tx != NULL) {
+        if (dma_hal_claim(obj->dev->dma_tx, obj->dev->handle->Instance, DMA_HAL_DIR_TX) != OMNI_OK) {
+            return OMNI_FAIL;
+        }
+
         dma_hal_enable_clock(obj->dev->dma_tx->ins);
 
         if (HAL_DMA_Init(obj->dev->dma_tx->handle) != HAL_OK) {
@@ -127,6 +159,10 @@ static int spi_hal_init(spi_num_t spi_num, spi_driver_config_t *config) {
 #if (CONFIG_SPI_RX_DMA == 1)
     // Initialize SPI DMA RX
     if (obj->dev->dma_rx != NULL) {
+        if (dma_hal_claim(obj->dev->dma_rx, obj->dev->handle->Instance, DMA_HAL_DIR_RX) != OMNI_OK) {
+            return OMNI_FAIL;
+        }
+
         dma_hal_enable_clock(obj->dev->dma_rx->ins);
 
         if (HAL_DMA_Init(obj->dev->dma_rx->handle) != HAL_OK) {
@@ -171,12 +207,15 @@ static int spi_hal_init(spi_num_t spi_num, spi_driver_config_t *config) {
  * @param spi_num SPI number
  * @return Operation status
  */
-static int spi_hal_deinit(spi_num_t spi_num) {
+OMNI_DRIVER_API int spi_hal_deinit(spi_num_t spi_num) {
     omni_assert(spi_num < SPI_NUM_MAX);
 
     spi_obj_t *obj = &spi_obj[spi_num];
     omni_assert_not_null(obj);
 
+    // A streaming DMA cannot be deinitialized
+    spi_hal_stream_stop(spi_num);
+
     // Reset SPI clock
     spi_hal_reset_clock(spi_num);
 
@@ -186,6 +225,7 @@ static int spi_hal_deinit(spi_num_t spi_num) {
 #if (CONFIG_SPI_TX_DMA == 1)
     // Deinitialize SPI DMA TX
     if (obj->dev->dma_tx != NULL) {
+        dma_hal_release(obj->dev->dma_tx);
         HAL_DMA_DeInit(obj->dev->dma_tx->handle);
     }
 #endif /* (CONFIG_SPI_TX_DMA == 1) */
@@ -193,10 +233,19 @@ static int spi_hal_deinit(spi_num_t spi_num) {
 #if (CONFIG_SPI_RX_DMA == 1)
     // Deinitialize SPI DMA RX
     if (obj->dev->dma_rx != NULL) {
+        dma_hal_release(obj->dev->dma_rx);
         HAL_DMA_DeInit(obj->dev->dma_rx->handle);
     }
 #endif /* (CONFIG_SPI_RX_DMA == 1) */
 
+    // Release bounce buffers of aborted transfers
+#if (CONFIG_SPI_TX_DMA == 1)
+    dma_hal_abort(&spi_dma_tx[spi_num]);
+#endif /* (CONFIG_SPI_TX_DMA == 1) */
+#if ((CONFIG_SPI_TX_DMA == 1) && (CONFIG_SPI_RX_DMA == 1))
+    dma_hal_abort(&spi_dma_rx[spi_num]);
+#endif /* ((CONFIG_SPI_TX_DMA == 1) && (CONFIG_SPI_RX_DMA == 1)) */
+
     // Disable SPI IRQ
     NVIC_DisableIRQ(obj->dev->irq_num);
 
@@ -233,7 +282,7 @@ static int spi_hal_deinit(spi_num_t spi_num) {
  * 
  * @param spi_num SPI number
  */
-static void spi_hal_start(spi_num_t spi_num) {
+OMNI_DRIVER_API void spi_hal_start(spi_num_t spi_num) {
     omni_assert(spi_num < SPI_NUM_MAX);
 
     spi_obj_t *obj = &spi_obj[spi_num];
@@ -250,7 +299,7 @@ static void spi_hal_start(spi_num_t spi_num) {
  * 
  * @param spi_num SPI number
  */
-static void spi_hal_stop(spi_num_t spi_num) {
+OMNI_DRIVER_API void spi_hal_stop(spi_num_t spi_num) {
     omni_assert(spi_num < SPI_NUM_MAX);
 
     spi_obj_t *obj = &spi_obj[spi_num];
@@ -270,7 +319,7 @@ static void spi_hal_stop(spi_num_t spi_num) {
  * @param len Length of data buffer
  * @return Operation status
  */
-static int spi_hal_send(spi_num_t spi_num, const void *data, uint32_t len) {
+OMNI_DRIVER_API int spi_hal_send(spi_num_t spi_num, const void *data, uint32_t len) {
     HAL_StatusTypeDef status;
     omni_assert(spi_num < SPI_NUM_MAX);
     omni_assert_not_null(data);
@@ -287,9 +336,19 @@ static int spi_hal_send(spi_num_t spi_num, const void *data, uint32_t len) {
 
     // Set busy status
     obj->status.busy = 1;
+    TRACE_RECORD(TRACE_EVENT_DRV_START, TRACE_DRV_SPI | spi_num, len);
 
 #if (CONFIG_SPI_TX_DMA == 1)
-    status = HAL_SPI_Transmit_DMA(handle, (uint8_t *)data, (uint16_t)len);
+    const void *tx_dma = dma_hal_tx_prepare(&spi_dma_tx[spi_num], data, spi_hal_get_bytes(handle, len));
+    if (tx_dma == NULL) {
+        obj->status.busy = 0;
+        return OMNI_FAIL;
+    }
+
+    status = HAL_SPI_Transmit_DMA(handle, (uint8_t *)tx_dma, (uint16_t)len);
+    if (status != HAL_OK) {
+        dma_hal_tx_complete(&spi_dma_tx[spi_num]);
+    }
 #else
     status = HAL_SPI_Transmit_IT(handle, (uint8_t *)data, (uint16_t)len);
 #endif /* (CONFIG_SPI_TX_DMA == 1) */
@@ -322,7 +381,7 @@ static int spi_hal_send(spi_num_t spi_num, const void *data, uint32_t len) {
  * @param len Length of data buffer
  * @return Operation status
  */
-static int spi_hal_receive(spi_num_t spi_num, void *data, uint32_t len) {
+OMNI_DRIVER_API int spi_hal_receive(spi_num_t spi_num, void *data, uint32_t len) {
     HAL_StatusTypeDef status;
     omni_assert(spi_num < SPI_NUM_MAX);
     omni_assert_not_null(data);
@@ -339,9 +398,20 @@ static int spi_hal_receive(spi_num_t spi_num, void *data, uint32_t len) {
 
     // Set busy status
     obj->status.busy = 1;
+    TRACE_RECORD(TRACE_EVENT_DRV_START, TRACE_DRV_SPI | spi_num, len);
 
 #if ((CONFIG_SPI_TX_DMA == 1) && (CONFIG_SPI_RX_DMA == 1))
-    status = HAL_SPI_TransmitReceive_DMA(handle, (uint8_t *)data, (uint8_t *)data, (uint16_t)len);
+    // The buffer is sent while it is received, one DMA buffer serves both
+    void *rx_dma = dma_hal_rx_prepare(&spi_dma_rx[spi_num], data, spi_hal_get_bytes(handle, len));
+    if (rx_dma == NULL) {
+        obj->status.busy = 0;
+        return OMNI_FAIL;
+    }
+
+    status = HAL_SPI_TransmitReceive_DMA(handle, (uint8_t *)rx_dma, (uint8_t *)rx_dma, (uint16_t)len);
+    if (status != HAL_OK) {
+        dma_hal_abort(&spi_dma_rx[spi_num]);
+    }
 #else
     status = HAL_SPI_TransmitReceive_IT(handle, (uint8_t *)data, (uint8_t *)data, (uint16_t)len);
 #endif /* ((CONFIG_SPI_TX_DMA == 1) && (CONFIG_SPI_RX_DMA == 1)) */
@@ -375,7 +445,7 @@ static int spi_hal_receive(spi_num_t spi_num, void *data, uint32_t len) {
  * @param len Length of data buffer
  * @return Operation status
  */
-static int spi_hal_transfer(spi_num_t spi_num, const void *tx_data, void *rx_data, uint32_t len) {
+OMNI_DRIVER_API int spi_hal_transfer(spi_num_t spi_num, const void *tx_data, void *rx_data, uint32_t len) {
     HAL_StatusTypeDef status;
     omni_assert(spi_num < SPI_NUM_MAX);
     omni_assert_not_null(tx_data);
@@ -393,9 +463,26 @@ static int spi_hal_transfer(spi_num_t spi_num, const void *tx_data, void *rx_dat
 
     // Set busy status
     obj->status.busy = 1;
+    TRACE_RECORD(TRACE_EVENT_DRV_START, TRACE_DRV_SPI | spi_num, len);
 
 #if ((CONFIG_SPI_TX_DMA == 1) && (CONFIG_SPI_RX_DMA == 1))
-    status = HAL_SPI_TransmitReceive_DMA(handle, (uint8_t *)tx_data, (uint8_t *)rx_data, (uint16_t)len);
+    const void *tx_dma = dma_hal_tx_prepare(&spi_dma_tx[spi_num], tx_data, spi_hal_get_bytes(handle, len));
+    if (tx_dma == NULL) {
+        obj->status.busy = 0;
+        return OMNI_FAIL;
+    }
+
+    void *rx_dma = dma_hal_rx_prepare(&spi_dma_rx[spi_num], rx_data, spi_hal_get_bytes(handle, len));
+    if (rx_dma == NULL) {
+        dma_hal_tx_complete(&spi_dma_tx[spi_num]);
+        obj->status.busy = 0;
+        return OMNI_FAIL;
+    }
+
+    status = HAL_SPI_TransmitReceive_DMA(handle, (uint8_t *)tx_dma, (uint8_t *)rx_dma, (uint16_t)len);
+    if (status != HAL_OK) {
+        spi_hal_dma_complete(obj);
+    }
 #else
     status = HAL_SPI_TransmitReceive_IT(handle, (uint8_t *)tx_data, (uint8_t *)rx_data, (uint16_t)len);
 #endif /* ((CONFIG_SPI_TX_DMA == 1) && (CONFIG_SPI_RX_DMA == 1)) */
@@ -420,13 +507,98 @@ static int spi_hal_transfer(spi_num_t spi_num, const void *tx_data, void *rx_dat
     return OMNI_OK;
 }
 
+/**
+ * @brief Send a continuous stream from two buffers
+ *
+ * @note Needs the TX DMA on a stream with double buffer mode (STM32F4 and
+ *       STM32H7). The DMA sends buffer0 then buffer1 and back without a
+ *       gap, cb is called with the buffer just sent so it can be refilled
+ *       while the other one goes out. Received frames are dropped. Runs
+ *       until stream_stop. With the data cache enabled the buffers must be
+ *       aligned to cache lines, unless they are in the non-cacheable region.
+ * @param spi_num SPI number
+ * @param buffer0 Pointer to first buffer
+ * @param buffer1 Pointer to second buffer
+ * @param len Number of frames in each buffer
+ * @param cb Stream callback
+ * @return Operation status
+ */
+OMNI_DRIVER_API int spi_hal_stream_send(spi_num_t spi_num, void *buffer0, void *buffer1, uint32_t len, spi_stream_callback cb) {
+    omni_assert(spi_num < SPI_NUM_MAX);
+    omni_assert_not_null(buffer0);
+    omni_assert_not_null(buffer1);
+    omni_assert_non_zero(len);
+    omni_assert_not_null(cb);
+
+    spi_obj_t *obj = &spi_obj[spi_num];
+    omni_assert_not_null(obj);
+
+#if (CONFIG_SPI_TX_DMA == 1)
+    return spi_hal_stream_start(obj, buffer0, buffer1, len, cb, false);
+#else
+    (void)obj;
+    return OMNI_FAIL;
+#endif /* (CONFIG_SPI_TX_DMA == 1) */
+}
+
+/**
+ * @brief Receive a continuous stream into two buffers
+ *
+ * @note Needs the TX and RX DMA on streams with double buffer mode. As with
+ *       receive, the buffers are sent while they are received, so the
+ *       frames clocked out are the previous content of the buffer. cb is
+ *       called with each full buffer while the other one is being filled.
+ *       Runs until stream_stop.
+ * @param spi_num SPI number
+ * @param buffer0 Pointer to first buffer
+ * @param buffer1 Pointer to second buffer
+ * @param len Number of frames in each buffer
+ * @param cb Stream callback
+ * @return Operation status
+ */
+OMNI_DRIVER_API int spi_hal_stream_receive(spi_num_t spi_num, void *buffer0, void *buffer1, uint32_t len, spi_stream_callback cb) {
+    omni_assert(spi_num < SPI_NUM_MAX);
+    omni_assert_not_null(buffer0);
+    omni_assert_not_null(buffer1);
+    omni_assert_non_zero(len);
+    omni_assert_not_null(cb);
+
+    spi_obj_t *obj = &spi_obj[spi_num];
+    omni_assert_not_null(obj);
+
+#if ((CONFIG_SPI_TX_DMA == 1) && (CONFIG_SPI_RX_DMA == 1))
+    return spi_hal_stream_start(obj, buffer0, buffer1, len, cb, true);
+#else
+    (void)obj;
+    return OMNI_FAIL;
+#endif /* ((CONFIG_SPI_TX_DMA == 1) && (CONFIG_SPI_RX_DMA == 1)) */
+}
+
+/**
+ * @brief Stop the stream
+ *
+ * @param spi_num SPI number
+ */
+OMNI_DRIVER_API void spi_hal_stream_stop(spi_num_t spi_num) {
+    omni_assert(spi_num < SPI_NUM_MAX);
+
+    spi_obj_t *obj = &spi_obj[spi_num];
+    omni_assert_not_null(obj);
+
+#if (CONFIG_SPI_TX_DMA == 1)
+    (void)spi_hal_stream_end(obj);
+#else
+    (void)obj;
+#endif /* (CONFIG_SPI_TX_DMA == 1) */
+}
+
 /**
  * @brief Get SPI bus status
  * 
  * @param spi_num SPI number
  * @return SPI driver status
  */
-static spi_driver_status_t spi_hal_get_status(spi_num_t spi_num) {
+OMNI_DRIVER_API spi_driver_status_t spi_hal_get_status(spi_num_t spi_num) {
     omni_assert(spi_num < SPI_NUM_MAX);
 
     spi_obj_t *obj = &spi_obj[spi_num];
@@ -441,7 +613,7 @@ static spi_driver_status_t spi_hal_get_status(spi_num_t spi_num) {
  * @param spi_num SPI number
  * @return SPI driver error
  */
-static spi_driver_error_t spi_hal_get_error(spi_num_t spi_num) {
+OMNI_DRIVER_API spi_driver_error_t spi_hal_get_error(spi_num_t spi_num) {
     omni_assert(spi_num < SPI_NUM_MAX);
 
     spi_obj_t *obj = &spi_obj[spi_num];
@@ -455,7 +627,7 @@ static spi_driver_error_t spi_hal_get_error(spi_num_t spi_num) {
 /**
  * @brief SPI IRQ handler
  */
-static void spi_hal_irq_request(spi_obj_t *obj) {
+static OMNI_FAST_ISR void spi_hal_irq_request(spi_obj_t *obj) {
     omni_assert_not_null(obj);
 
     SPI_HandleTypeDef *handle = obj->dev->handle;
@@ -467,7 +639,7 @@ static void spi_hal_irq_request(spi_obj_t *obj) {
 /**
  * @brief SPI1 IRQ handler
  */
-static void spi1_irq_handler(void) {
+static OMNI_FAST_ISR void spi1_irq_handler(void) {
     spi_hal_irq_request(&spi_obj[SPI_NUM_1]);
 }
 #endif /* CONFIG_SPI_NUM_1 */
@@ -476,7 +648,7 @@ static void spi1_irq_handler(void) {
 /**
  * @brief SPI2 IRQ handler
  */
-static void spi2_irq_handler(void) {
+static OMNI_FAST_ISR void spi2_irq_handler(void) {
     spi_hal_irq_request(&spi_obj[SPI_NUM_2]);
 }
 #endif /* CONFIG_SPI_NUM_2 */
@@ -485,7 +657,7 @@ static void spi2_irq_handler(void) {
 /**
  * @brief SPI3 IRQ handler
  */
-static void spi3_irq_handler(void) {
+static OMNI_FAST_ISR void spi3_irq_handler(void) {
     spi_hal_irq_request(&spi_obj[SPI_NUM_3]);
 }
 #endif /* CONFIG_SPI_NUM_3 */
@@ -494,7 +666,7 @@ static void spi3_irq_handler(void) {
 /**
  * @brief SPI4 IRQ handler
  */
-static void spi4_irq_handler(void) {
+static OMNI_FAST_ISR void spi4_irq_handler(void) {
     spi_hal_irq_request(&spi_obj[SPI_NUM_4]);
 }
 #endif /* CONFIG_SPI_NUM_4 */
@@ -503,7 +675,7 @@ static void spi4_irq_handler(void) {
 /**
  * @brief SPI5 IRQ handler
  */
-static void spi5_irq_handler(void) {
+static OMNI_FAST_ISR void spi5_irq_handler(void) {
     spi_hal_irq_request(&spi_obj[SPI_NUM_5]);
 }
 #endif /* CONFIG_SPI_NUM_5 */
@@ -512,39 +684,39 @@ static void spi5_irq_handler(void) {
 /**
  * @brief SPI6 IRQ handler
  */
-static void spi6_irq_handler(void) {
+static OMNI_FAST_ISR void spi6_irq_handler(void) {
     spi_hal_irq_request(&spi_obj[SPI_NUM_6]);
 }
 #endif /* CONFIG_SPI_NUM_6 */
 
 #if (CONFIG_SPI_TX_DMA == 1)
 #if (CONFIG_SPI1_TX_DMA == 1)
-void spi1_tx_dma_irq_handler(void) {
+OMNI_FAST_ISR void spi1_tx_dma_irq_handler(void) {
     HAL_DMA_IRQHandler(spi_obj[SPI_NUM_1].dev->dma_tx->handle);
 }
 #endif /* (CONFIG_SPI1_TX_DMA == 1) */
 #if (CONFIG_SPI2_TX_DMA == 1)
-void spi2_tx_dma_irq_handler(void) {
+OMNI_FAST_ISR void spi2_tx_dma_irq_handler(void) {
     HAL_DMA_IRQHandler(spi_obj[SPI_NUM_2].dev->dma_tx->handle);
 }
 #endif /* (CONFIG_SPI2_TX_DMA == 1) */
 #if (CONFIG_SPI3_TX_DMA == 1)
-void spi3_tx_dma_irq_handler(void) {
+OMNI_FAST_ISR void spi3_tx_dma_irq_handler(void) {
     HAL_DMA_IRQHandler(spi_obj[SPI_NUM_3].dev->dma_tx->handle);
 }
 #endif /* (CONFIG_SPI3_TX_DMA == 1) */
 #if (CONFIG_SPI4_TX_DMA == 1)
-void spi4_tx_dma_irq_handler(void) {
+OMNI_FAST_ISR void spi4_tx_dma_irq_handler(void) {
     HAL_DMA_IRQHandler(spi_obj[SPI_NUM_4].dev->dma_tx->handle);
 }
 #endif /* (CONFIG_SPI4_TX_DMA == 1) */
 #if (CONFIG_SPI5_TX_DMA == 1)
-void spi5_tx_dma_irq_handler(void) {
+OMNI_FAST_ISR void spi5_tx_dma_irq_handler(void) {
     HAL_DMA_IRQHandler(spi_obj[SPI_NUM_5].dev->dma_tx->handle);
 }
 #endif /* (CONFIG_SPI5_TX_DMA == 1) */
 #if (CONFIG_SPI6_TX_DMA == 1)
-void spi6_tx_dma_irq_handler(void) {
+OMNI_FAST_ISR void spi6_tx_dma_irq_handler(void) {
     HAL_DMA_IRQHandler(spi_obj[SPI_NUM_6].dev->dma_tx->handle);
 }
 #endif /* (CONFIG_SPI6_TX_DMA == 1) */
@@ -552,32 +724,32 @@ void spi6_tx_dma_irq_handler(void) {
 
 #if (CONFIG_SPI_RX_DMA == 1)
 #if (CONFIG_SPI1_RX_DMA == 1)
-void spi1_rx_dma_irq_handler(void) {
+OMNI_FAST_ISR void spi1_rx_dma_irq_handler(void) {
     HAL_DMA_IRQHandler(spi_obj[SPI_NUM_1].dev->dma_rx->handle);
 }
 #endif /* (CONFIG_SPI1_RX_DMA == 1) */
 #if (CONFIG_SPI2_RX_DMA == 1)
-void spi2_rx_dma_irq_handler(void) {
+OMNI_FAST_ISR void spi2_rx_dma_irq_handler(void) {
     HAL_DMA_IRQHandler(spi_obj[SPI_NUM_2].dev->dma_rx->handle);
 }
 #endif /* (CONFIG_SPI2_RX_DMA == 1) */
 #if (CONFIG_SPI3_RX_DMA == 1)
-void spi3_rx_dma_irq_handler(void) {
+OMNI_FAST_ISR void spi3_rx_dma_irq_handler(void) {
     HAL_DMA_IRQHandler(spi_obj[SPI_NUM_3].dev->dma_rx->handle);
 }
 #endif /* (CONFIG_SPI3_RX_DMA == 1) */
 #if (CONFIG_SPI4_RX_DMA == 1)
-void spi4_rx_dma_irq_handler(void) {
+OMNI_FAST_ISR void spi4_rx_dma_irq_handler(void) {
     HAL_DMA_IRQHandler(spi_obj[SPI_NUM_4].dev->dma_rx->handle);
 }
 #endif /* (CONFIG_SPI4_RX_DMA == 1) */
 #if (CONFIG_SPI5_RX_DMA == 1)
-void spi5_rx_dma_irq_handler(void) {
+OMNI_FAST_ISR void spi5_rx_dma_irq_handler(void) {
     HAL_DMA_IRQHandler(spi_obj[SPI_NUM_5].dev->dma_rx->handle);
 }
 #endif /* (CONFIG_SPI5_RX_DMA == 1) */
 #if (CONFIG_SPI6_RX_DMA == 1)
-void spi6_rx_dma_irq_handler(void) {
+OMNI_FAST_ISR void spi6_rx_dma_irq_handler(void) {
     HAL_DMA_IRQHandler(spi_obj[SPI_NUM_6].dev->dma_rx->handle);
 }
 #endif /* (CONFIG_SPI6_RX_DMA == 1) */
@@ -661,13 +833,69 @@ static void spi_hal_irq_register(void) {
 #endif /* (CONFIG_SPI_NUM_6 == 1) */
 }
 
+#if (CONFIG_SPI_TX_DMA == 1)
+static void spi_tx_stream_callback(DMA_HandleTypeDef *hdma) {
+    SPI_HandleTypeDef *hspi = (SPI_HandleTypeDef *)hdma->Parent;
+    spi_obj_t *obj = spi_hal_get_obj(hspi);
+    omni_assert_not_null(obj);
+
+    // A receive stream reports the RX side only
+    if (obj->data.rx_num != 0U) {
+        return;
+    }
+
+    uint32_t len = spi_hal_get_bytes(hspi, obj->data.tx_num);
+    void *buffer = dma_hal_double_done(hdma, DMA_HAL_DIR_TX, len);
+
+    if (obj->stream_cb != NULL) {
+        obj->stream_cb(buffer);
+    }
+
+    dma_hal_double_refill(buffer, len);
+}
+
+static void spi_rx_stream_callback(DMA_HandleTypeDef *hdma) {
+    SPI_HandleTypeDef *hspi = (SPI_HandleTypeDef *)hdma->Parent;
+    spi_obj_t *obj = spi_hal_get_obj(hspi);
+    omni_assert_not_null(obj);
+
+    void *buffer = dma_hal_double_done(hdma, DMA_HAL_DIR_RX, spi_hal_get_bytes(hspi, obj->data.rx_num));
+
+    if (obj->stream_cb != NULL) {
+        obj->stream_cb(buffer);
+    }
+}
+
+static void spi_stream_error_callback(DMA_HandleTypeDef *hdma) {
+    SPI_HandleTypeDef *hspi = (SPI_HandleTypeDef *)hdma->Parent;
+    spi_obj_t *obj = spi_hal_get_obj(hspi);
+    spi_stream_callback cb;
+    omni_assert_not_null(obj);
+
+    // FIFO and direct mode errors do not stop the stream
+    if (HAL_DMA_GetState(hdma) != HAL_DMA_STATE_READY) {
+        return;
+    }
+
+    obj->error.bus_error = 1;
+
+    cb = spi_hal_stream_end(obj);
+    if (cb != NULL) {
+        cb(NULL);
+    }
+}
+#endif /* (CONFIG_SPI_TX_DMA == 1) */
+
 /********************* Callback functions **********************/
 void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi) {
     spi_obj_t *obj = spi_hal_get_obj(hspi);
     omni_assert_not_null(obj);
 
+    spi_hal_dma_complete(obj);
+
     // Clear busy status
     obj->status.busy = 0;
+    TRACE_RECORD(TRACE_EVENT_DRV_COMPLETE, TRACE_DRV_SPI | (uint32_t)(obj - spi_obj), 0);
 
     if (obj->event_cb != NULL) {
         // Set TX complete event
@@ -679,8 +907,11 @@ void HAL_SPI_RxCpltCallback(SPI_HandleTypeDef *hspi) {
     spi_obj_t *obj = spi_hal_get_obj(hspi);
     omni_assert_not_null(obj);
 
+    spi_hal_dma_complete(obj);
+
     // Clear busy status
     obj->status.busy = 0;
+    TRACE_RECORD(TRACE_EVENT_DRV_COMPLETE, TRACE_DRV_SPI | (uint32_t)(obj - spi_obj), 0);
 
     if (obj->event_cb != NULL) {
         // Set RX complete event
@@ -692,8 +923,11 @@ void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef *hspi) {
     spi_obj_t *obj = spi_hal_get_obj(hspi);
     omni_assert_not_null(obj);
 
+    spi_hal_dma_complete(obj);
+
     // Clear busy status
     obj->status.busy = 0;
+    TRACE_RECORD(TRACE_EVENT_DRV_COMPLETE, TRACE_DRV_SPI | (uint32_t)(obj - spi_obj), 0);
 
     if (obj->event_cb != NULL) {
         // Set TX/RX complete event
@@ -707,8 +941,11 @@ void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi) {
     spi_obj_t *obj = spi_hal_get_obj(hspi);
     omni_assert_not_null(obj);
 
+    spi_hal_dma_complete(obj);
+
     // Clear busy status
     obj->status.busy = 0;
+    TRACE_RECORD(TRACE_EVENT_DRV_ERROR, TRACE_DRV_SPI | (uint32_t)(obj - spi_obj), 0);
 
     // Get error
     error = HAL_SPI_GetError(hspi);
@@ -738,11 +975,19 @@ void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi) {
  */
 static int spi_hal_configure(spi_dev_t *dev, spi_driver_config_t *config) {
     uint32_t spi_clock = 0;
+    uint32_t data_size = SPI_OP_DATA_SIZE_GET(config->option);
     SPI_HandleTypeDef *handle = dev->handle;
 
-    if ((SPI_OP_DATA_SIZE_GET(config->option) != 8U) && (SPI_OP_DATA_SIZE_GET(config->option) != 16U)) {
+#if defined(SPI_CFG1_DSIZE)
+    // STM32H7 frames are 4 to 32 bits
+    if ((data_size < 4U) || (data_size > 32U)) {
         return OMNI_FAIL;
     }
+#else
+    if ((data_size != 8U) && (data_size != 16U)) {
+        return OMNI_FAIL;
+    }
+#endif /* SPI_CFG1_DSIZE */
 
     if (SPI_OP_MODE_GET(config->option) == SPI_OP_MODE_MASTER) {
         handle->Init.Mode = SPI_MODE_MASTER;
@@ -768,11 +1013,15 @@ static int spi_hal_configure(spi_dev_t *dev, spi_driver_config_t *config) {
         handle->Init.CLKPhase = SPI_PHASE_2EDGE;
     }
 
-    if (SPI_OP_DATA_SIZE_GET(config->option) == 8U) {
+#if defined(SPI_CFG1_DSIZE)
+    handle->Init.DataSize = (data_size - 1U) << SPI_CFG1_DSIZE_Pos;
+#else
+    if (data_size == 8U) {
         handle->Init.DataSize = SPI_DATASIZE_8BIT;
     } else {
         handle->Init.DataSize = SPI_DATASIZE_16BIT;
     }
+#endif /* SPI_CFG1_DSIZE */
 
     if (SPI_OP_BIT_ORDER_GET(config->option) == SPI_OP_BIT_ORDER_MSB) {
         handle->Init.FirstBit = SPI_FIRSTBIT_MSB;
@@ -830,6 +1079,12 @@ static int spi_hal_configure(spi_dev_t *dev, spi_driver_config_t *config) {
         return OMNI_FAIL;
     }
 
+#if (CONFIG_SPI_TX_DMA == 1)
+    if (spi_hal_dma_set_width(dev) != OMNI_OK) {
+        return OMNI_FAIL;
+    }
+#endif /* (CONFIG_SPI_TX_DMA == 1) */
+
     if (HAL_SPI_Init(handle) != HAL_OK) {
         return OMNI_FAIL;
     }
@@ -1081,3 +1336,221 @@ static spi_obj_t *spi_hal_get_obj(SPI_HandleTypeDef *hspi) {
 
     return obj;
 }
+
+#if (CONFIG_SPI_TX_DMA == 1)
+/**
+ * @brief Get number of bytes of a transfer
+ * 
+ * @param handle SPI handle
+ * @param len Number of data frames
+ * @return Number of bytes
+ */
+static uint32_t spi_hal_get_bytes(SPI_HandleTypeDef *handle, uint32_t len) {
+    return len * spi_hal_get_frame_bytes(handle);
+}
+
+/**
+ * @brief Get number of bytes a data frame takes in memory
+ * 
+ * @param handle SPI handle
+ * @return 1, 2 or 4
+ */
+static uint32_t spi_hal_get_frame_bytes(SPI_HandleTypeDef *handle) {
+#if defined(SPI_CFG1_DSIZE)
+    uint32_t data_size = (handle->Init.DataSize >> SPI_CFG1_DSIZE_Pos) + 1U;
+
+    if (data_size > 16U) {
+        return 4U;
+    }
+
+    return (data_size > 8U) ? 2U : 1U;
+#else
+    return (handle->Init.DataSize == SPI_DATASIZE_16BIT) ? 2U : 1U;
+#endif /* SPI_CFG1_DSIZE */
+}
+
+/**
+ * @brief Match the DMA data width to the frame size
+ * 
+ * @note Frames wider than 8 bits are moved as half words or words, the
+ *       STM32H7 HAL rejects a DMA transfer narrower than the frame.
+ * @param dev SPI device information
+ * @return Operation status
+ */
+static int spi_hal_dma_set_width(spi_dev_t *dev) {
+    uint32_t frame_bytes = spi_hal_get_frame_bytes(dev->handle);
+    uint32_t periph_align = DMA_PDATAALIGN_BYTE;
+    uint32_t mem_align = DMA_MDATAALIGN_BYTE;
+    dma_dev_t *dma[2] = {dev->dma_tx, dev->dma_rx};
+
+    if (frame_bytes == 4U) {
+        periph_align = DMA_PDATAALIGN_WORD;
+        mem_align = DMA_MDATAALIGN_WORD;
+    } else if (frame_bytes == 2U) {
+        periph_align = DMA_PDATAALIGN_HALFWORD;
+        mem_align = DMA_MDATAALIGN_HALFWORD;
+    }
+
+    for (uint32_t i = 0; i < 2U; i++) {
+        if ((dma[i] == NULL) || (dma[i]->handle->Init.MemDataAlignment == mem_align)) {
+            continue;
+        }
+
+        dma[i]->handle->Init.PeriphDataAlignment = periph_align;
+        dma[i]->handle->Init.MemDataAlignment = mem_align;
+        if (HAL_DMA_Init(dma[i]->handle) != HAL_OK) {
+            return OMNI_FAIL;
+        }
+    }
+
+    return OMNI_OK;
+}
+#endif /* (CONFIG_SPI_TX_DMA == 1) */
+
+/**
+ * @brief Complete the DMA buffers of a transfer
+ * 
+ * @param obj SPI object
+ */
+static void spi_hal_dma_complete(spi_obj_t *obj) {
+#if (CONFIG_SPI_TX_DMA == 1)
+    dma_hal_tx_complete(&spi_dma_tx[obj - spi_obj]);
+#endif /* (CONFIG_SPI_TX_DMA == 1) */
+#if ((CONFIG_SPI_TX_DMA == 1) && (CONFIG_SPI_RX_DMA == 1))
+    dma_hal_rx_complete(&spi_dma_rx[obj - spi_obj]);
+#endif /* ((CONFIG_SPI_TX_DMA == 1) && (CONFIG_SPI_RX_DMA == 1)) */
+}
+
+#if (CONFIG_SPI_TX_DMA == 1)
+/**
+ * @brief Start a double buffer stream
+ *
+ * @param obj SPI object
+ * @param buffer0 Pointer to first buffer
+ * @param buffer1 Pointer to second buffer
+ * @param len Number of frames in each buffer
+ * @param cb Stream callback
+ * @param rx True to receive into the buffers while they are sent
+ * @return Operation status
+ */
+static int spi_hal_stream_start(spi_obj_t *obj, void *buffer0, void *buffer1, uint32_t len, spi_stream_callback cb, bool rx) {
+    SPI_HandleTypeDef *handle = obj->dev->handle;
+    uint32_t bytes = spi_hal_get_bytes(handle, len);
+
+    if ((obj->dev->dma_tx == NULL) || (rx && (obj->dev->dma_rx == NULL))) {
+        return OMNI_FAIL;
+    }
+
+    if (obj->status.busy || (handle->State != HAL_SPI_STATE_READY)) {
+        return OMNI_BUSY;
+    }
+
+    obj->data.tx_num = len;
+    obj->data.rx_num = rx ? len : 0U;
+    obj->stream_cb = cb;
+
+    obj->status.busy = 1;
+
+#if defined(SPI_CR1_CSTART)
+    volatile void *tx_reg = &handle->Instance->TXDR;
+    volatile void *rx_reg = &handle->Instance->RXDR;
+#else
+    volatile void *tx_reg = &handle->Instance->DR;
+    volatile void *rx_reg = &handle->Instance->DR;
+#endif /* SPI_CR1_CSTART */
+
+    // The RX stream is started first so no frame is lost
+    if (rx && (dma_hal_double_start(handle->hdmarx, DMA_HAL_DIR_RX, rx_reg, buffer0, buffer1, len, bytes,
+                                    spi_rx_stream_callback, spi_stream_error_callback) != OMNI_OK)) {
+        obj->stream_cb = NULL;
+        obj->data.rx_num = 0;
+        obj->status.busy = 0;
+        return OMNI_FAIL;
+    }
+
+    if (dma_hal_double_start(handle->hdmatx, DMA_HAL_DIR_TX, tx_reg, buffer0, buffer1, len, bytes,
+                             spi_tx_stream_callback, spi_stream_error_callback) != OMNI_OK) {
+        if (rx) {
+            dma_hal_double_stop(handle->hdmarx);
+        }
+        obj->stream_cb = NULL;
+        obj->data.rx_num = 0;
+        obj->status.busy = 0;
+        return OMNI_FAIL;
+    }
+
+    TRACE_RECORD(TRACE_EVENT_DRV_START, TRACE_DRV_SPI | (uint32_t)(obj - spi_obj), len);
+
+#if defined(SPI_CR1_CSTART)
+    // TSIZE 0 keeps the transfer going until the stream is stopped
+    MODIFY_REG(handle->Instance->CR2, SPI_CR2_TSIZE, 0U);
+    if (!rx && (handle->Init.Direction == SPI_DIRECTION_2LINES)) {
+        MODIFY_REG(handle->Instance->CFG2, SPI_CFG2_COMM, SPI_CFG2_COMM_0);
+    }
+    if (rx) {
+        SET_BIT(handle->Instance->CFG1, SPI_CFG1_RXDMAEN);
+    }
+    SET_BIT(handle->Instance->CFG1, SPI_CFG1_TXDMAEN);
+    __HAL_SPI_ENABLE(handle);
+    if (handle->Init.Mode == SPI_MODE_MASTER) {
+        SET_BIT(handle->Instance->CR1, SPI_CR1_CSTART);
+    }
+#else
+    if (rx) {
+        SET_BIT(handle->Instance->CR2, SPI_CR2_RXDMAEN);
+    }
+    SET_BIT(handle->Instance->CR2, SPI_CR2_TXDMAEN);
+    __HAL_SPI_ENABLE(handle);
+#endif /* SPI_CR1_CSTART */
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief End a double buffer stream
+ *
+ * @param obj SPI object
+ * @return Stream callback, NULL if no stream was running
+ */
+static spi_stream_callback spi_hal_stream_end(spi_obj_t *obj) {
+    spi_stream_callback cb = obj->stream_cb;
+    SPI_HandleTypeDef *handle;
+
+    if (cb == NULL) {
+        return NULL;
+    }
+
+    handle = obj->dev->handle;
+
+#if defined(SPI_CR1_CSTART)
+    // Let the master finish the current frame before the DMA is stopped
+    if (READ_BIT(handle->Instance->CR1, SPI_CR1_CSTART) != 0U) {
+        SET_BIT(handle->Instance->CR1, SPI_CR1_CSUSP);
+        while (READ_BIT(handle->Instance->CR1, SPI_CR1_CSTART) != 0U) {
+        }
+    }
+    __HAL_SPI_DISABLE(handle);
+    CLEAR_BIT(handle->Instance->CFG1, SPI_CFG1_TXDMAEN | SPI_CFG1_RXDMAEN);
+    if (handle->Init.Direction == SPI_DIRECTION_2LINES) {
+        MODIFY_REG(handle->Instance->CFG2, SPI_CFG2_COMM, 0U);
+    }
+    __HAL_SPI_CLEAR_SUSPFLAG(handle);
+#else
+    CLEAR_BIT(handle->Instance->CR2, SPI_CR2_TXDMAEN | SPI_CR2_RXDMAEN);
+#endif /* SPI_CR1_CSTART */
+
+    dma_hal_double_stop(handle->hdmatx);
+    if (obj->data.rx_num != 0U) {
+        dma_hal_double_stop(handle->hdmarx);
+    }
+
+    // Frames dropped by a send stream overrun the receiver
+    __HAL_SPI_CLEAR_OVRFLAG(handle);
+
+    obj->stream_cb = NULL;
+    obj->data.rx_num = 0;
+    obj->status.busy = 0;
+
+    return cb;
+}
+#endif /* (CONFIG_SPI_TX_DMA == 1) */
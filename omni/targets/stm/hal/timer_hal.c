@@ -1,7 +1,7 @@
 /**
-  * @file    dwt_hal.c
+  * @file    timer_hal.c
   * @author  LuckkMaker
-  * @brief   DWT HAL driver
+  * @brief   Timer HAL driver
   * @attention
   *
   * Copyright (c) 2024 LuckkMaker
@@ -23,20 +23,692 @@
 /* Includes ------------------------------------------------------------------*/
 #include "drivers/timer.h"
 #include "hal/dwt_hal.h"
+#if defined(CONFIG_TIMER_HARDWARE)
+#include "hal/gpio_hal.h"
+#include "hal/dma_hal.h"
+#include "hal/irq_hal.h"
+#include "ll/timer_ll.h"
 
+#define TIMER_HAL_CHANNEL(ch)   ((uint32_t)(ch) << 2U)
+
+static timer_obj_t timer_obj[TIMER_NUM_MAX];
+// Buffers of burst and DMA writes, cleaned or bounced for the data cache
+static dma_hal_buffer_t timer_dma_up[TIMER_NUM_MAX];
+
+static int timer_hal_init(timer_num_t timer_num, timer_driver_config_t *config);
+static int timer_hal_deinit(timer_num_t timer_num);
+static int timer_hal_start(timer_num_t timer_num);
+static int timer_hal_stop(timer_num_t timer_num);
+static uint32_t timer_hal_get_counter(timer_num_t timer_num);
+static int timer_hal_pwm_start(timer_num_t timer_num, timer_channel_t channel, uint32_t pulse, timer_pwm_polarity_t polarity);
+static int timer_hal_pwm_stop(timer_num_t timer_num, timer_channel_t channel);
+static void timer_hal_pwm_set_pulse(timer_num_t timer_num, timer_channel_t channel, uint32_t pulse);
+static int timer_hal_capture_start(timer_num_t timer_num, timer_channel_t channel, timer_capture_edge_t edge, uint32_t *buffer, uint32_t len);
+static int timer_hal_capture_stop(timer_num_t timer_num, timer_channel_t channel);
+static int timer_hal_burst_write(timer_num_t timer_num, timer_channel_t channel, uint32_t channels, const uint32_t *data, uint32_t len);
+static int timer_hal_dma_write(timer_num_t timer_num, volatile uint32_t *reg, const uint32_t *data, uint32_t len);
+static timer_driver_status_t timer_hal_get_status(timer_num_t timer_num);
+static timer_driver_error_t timer_hal_get_error(timer_num_t timer_num);
+#endif /* CONFIG_TIMER_HARDWARE */
 static void timer_hal_delay_ms(uint32_t delay);
 static void timer_hal_delay_us(uint32_t delay);
 static uint32_t timer_hal_get_tick(uint32_t frequency);
+static uint32_t timer_hal_idle(uint32_t us);
 
 const struct timer_driver_api timer_driver = {
+#if defined(CONFIG_TIMER_HARDWARE)
+    .init = timer_hal_init,
+    .deinit = timer_hal_deinit,
+    .start = timer_hal_start,
+    .stop = timer_hal_stop,
+    .get_counter = timer_hal_get_counter,
+    .pwm_start = timer_hal_pwm_start,
+    .pwm_stop = timer_hal_pwm_stop,
+    .pwm_set_pulse = timer_hal_pwm_set_pulse,
+    .capture_start = timer_hal_capture_start,
+    .capture_stop = timer_hal_capture_stop,
+    .burst_write = timer_hal_burst_write,
+    .dma_write = timer_hal_dma_write,
+    .get_status = timer_hal_get_status,
+    .get_error = timer_hal_get_error,
+#endif /* CONFIG_TIMER_HARDWARE */
     .delay_ms = timer_hal_delay_ms,
     .delay_us = timer_hal_delay_us,
     .get_tick = timer_hal_get_tick,
+    .idle = timer_hal_idle,
 };
 
+#if defined(CONFIG_TIMER_HARDWARE)
+static int timer_hal_configure(timer_dev_t *dev, timer_driver_config_t *config);
+static void timer_hal_irq_register(timer_num_t timer_num, timer_dev_t *dev);
+static void timer_hal_set_gpio(timer_dev_t *dev);
+static void timer_hal_reset_gpio(timer_dev_t *dev);
+static int timer_hal_enable_clock(timer_num_t timer_num);
+static void timer_hal_reset_clock(timer_num_t timer_num);
+static void timer_hal_init_undo(timer_num_t timer_num, bool dma_up, bool dma_cc);
+static int timer_hal_convert_status(HAL_StatusTypeDef status);
+static timer_obj_t *timer_hal_get_obj(TIM_HandleTypeDef *htim);
+#if (CONFIG_TIMER_UP_DMA == 1)
+static void timer_hal_dma_write_cplt(DMA_HandleTypeDef *hdma);
+static void timer_hal_dma_write_error(DMA_HandleTypeDef *hdma);
+#endif /* (CONFIG_TIMER_UP_DMA == 1) */
+
+/**
+ * @brief Initialize timer
+ *
+ * @param timer_num Timer number
+ * @param config Pointer to the timer driver configuration
+ * @return Operation status
+ */
+static int timer_hal_init(timer_num_t timer_num, timer_driver_config_t *config) {
+    omni_assert(timer_num < TIMER_NUM_MAX);
+    omni_assert_not_null(config);
+
+    timer_obj_t *obj = &timer_obj[timer_num];
+
+    // Set event callback
+    if (config->event_cb != NULL) {
+        obj->event_cb = config->event_cb;
+    } else {
+        obj->event_cb = NULL;
+    }
+
+    // Get dev information
+    obj->dev = timer_ll_get_dev(timer_num);
+    omni_assert_not_null(obj->dev);
+
+    // Clear status
+    obj->status = (timer_driver_status_t){0};
+
+    // Clear error
+    obj->error = (timer_driver_error_t){0};
+
+    // Clear data
+    obj->data = (timer_driver_data_t){0};
+    obj->data.mode = config->mode;
+
+    // Register IRQ
+    timer_hal_irq_register(timer_num, obj->dev);
+
+    // Enable timer clock
+    if (timer_hal_enable_clock(timer_num) != OMNI_OK) {
+        timer_obj[timer_num] = (timer_obj_t){0};
+        return OMNI_FAIL;
+    }
+
+    // Initialize GPIO
+    timer_hal_set_gpio(obj->dev);
+
+#if (CONFIG_TIMER_UP_DMA == 1)
+    // Initialize update DMA
+    if (obj->dev->dma_up != NULL) {
+        if (dma_hal_claim(obj->dev->dma_up, obj->dev->handle->Instance, DMA_HAL_DIR_TX) != OMNI_OK) {
+            timer_hal_init_undo(timer_num, false, false);
+            return OMNI_FAIL;
+        }
+
+        dma_hal_enable_clock(obj->dev->dma_up->ins);
+
+        if (HAL_DMA_Init(obj->dev->dma_up->handle) != HAL_OK) {
+            timer_hal_init_undo(timer_num, true, false);
+            return OMNI_FAIL;
+        }
+
+        __HAL_LINKDMA(obj->dev->handle, hdma[TIM_DMA_ID_UPDATE], *(obj->dev->dma_up->handle));
+
+        // Enable update DMA IRQ
+        NVIC_ClearPendingIRQ(obj->dev->dma_up->irq_num);
+        NVIC_SetPriority(obj->dev->dma_up->irq_num, \
+            NVIC_EncodePriority(NVIC_GetPriorityGrouping(), obj->dev->dma_up->irq_prio, 0));
+        NVIC_EnableIRQ(obj->dev->dma_up->irq_num);
+    }
+#endif /* (CONFIG_TIMER_UP_DMA == 1) */
+
+#if (CONFIG_TIMER_CC_DMA == 1)
+    // Initialize capture DMA
+    if (obj->dev->dma_cc != NULL) {
+        if (dma_hal_claim(obj->dev->dma_cc, obj->dev->handle->Instance, DMA_HAL_DIR_RX) != OMNI_OK) {
+            timer_hal_init_undo(timer_num, true, false);
+            return OMNI_FAIL;
+        }
+
+        dma_hal_enable_clock(obj->dev->dma_cc->ins);
+
+        if (HAL_DMA_Init(obj->dev->dma_cc->handle) != HAL_OK) {
+            timer_hal_init_undo(timer_num, true, true);
+            return OMNI_FAIL;
+        }
+
+        __HAL_LINKDMA(obj->dev->handle, hdma[TIM_DMA_ID_CC1 + obj->dev->cc_dma_channel], *(obj->dev->dma_cc->handle));
+
+        // Enable capture DMA IRQ
+        NVIC_ClearPendingIRQ(obj->dev->dma_cc->irq_num);
+        NVIC_SetPriority(obj->dev->dma_cc->irq_num, \
+            NVIC_EncodePriority(NVIC_GetPriorityGrouping(), obj->dev->dma_cc->irq_prio, 0));
+        NVIC_EnableIRQ(obj->dev->dma_cc->irq_num);
+    }
+#endif /* (CONFIG_TIMER_CC_DMA == 1) */
+
+    // Initialize IRQ
+    NVIC_ClearPendingIRQ(obj->dev->irq_num);
+    NVIC_SetPriority(obj->dev->irq_num, \
+        NVIC_EncodePriority(NVIC_GetPriorityGrouping(), obj->dev->irq_prio, 0));
+    NVIC_EnableIRQ(obj->dev->irq_num);
+
+    if (obj->dev->cc_irq_num != obj->dev->irq_num) {
+        NVIC_ClearPendingIRQ(obj->dev->cc_irq_num);
+        NVIC_SetPriority(obj->dev->cc_irq_num, \
+            NVIC_EncodePriority(NVIC_GetPriorityGrouping(), obj->dev->irq_prio, 0));
+        NVIC_EnableIRQ(obj->dev->cc_irq_num);
+    }
+
+    // Initialize timer
+    if (timer_hal_configure(obj->dev, config) != OMNI_OK) {
+        timer_hal_init_undo(timer_num, true, true);
+        return OMNI_FAIL;
+    }
+
+    // Set initialized status
+    obj->status.is_initialized = 1;
+    // Call event callback
+    if (obj->event_cb != NULL) {
+        // Set initialized event
+        obj->event_cb(TIMER_EVENT_INITIALIZED);
+    }
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Deinitialize timer
+ *
+ * @param timer_num Timer number
+ * @return Operation status
+ */
+static int timer_hal_deinit(timer_num_t timer_num) {
+    omni_assert(timer_num < TIMER_NUM_MAX);
+
+    timer_obj_t *obj = &timer_obj[timer_num];
+    omni_assert_not_null(obj->dev);
+
+    TIM_HandleTypeDef *handle = obj->dev->handle;
+
+    // Deinitialize timer
+    switch (obj->data.mode) {
+        case TIMER_MODE_PWM:
+            HAL_TIM_PWM_DeInit(handle);
+            break;
+
+        case TIMER_MODE_CAPTURE:
+            HAL_TIM_IC_DeInit(handle);
+            break;
+
+        case TIMER_MODE_ENCODER:
+            HAL_TIM_Encoder_DeInit(handle);
+            break;
+
+        default:
+            HAL_TIM_Base_DeInit(handle);
+            break;
+    }
+
+    // Reset timer clock
+    timer_hal_reset_clock(timer_num);
+
+    // Reset GPIO
+    timer_hal_reset_gpio(obj->dev);
+
+#if (CONFIG_TIMER_UP_DMA == 1)
+    // Deinitialize update DMA
+    if (obj->dev->dma_up != NULL) {
+        dma_hal_release(obj->dev->dma_up);
+        HAL_DMA_DeInit(obj->dev->dma_up->handle);
+        NVIC_DisableIRQ(obj->dev->dma_up->irq_num);
+    }
+#endif /* (CONFIG_TIMER_UP_DMA == 1) */
+
+#if (CONFIG_TIMER_CC_DMA == 1)
+    // Deinitialize capture DMA
+    if (obj->dev->dma_cc != NULL) {
+        dma_hal_release(obj->dev->dma_cc);
+        HAL_DMA_DeInit(obj->dev->dma_cc->handle);
+        NVIC_DisableIRQ(obj->dev->dma_cc->irq_num);
+    }
+#endif /* (CONFIG_TIMER_CC_DMA == 1) */
+
+    // Disable timer IRQ
+    NVIC_DisableIRQ(obj->dev->irq_num);
+    NVIC_DisableIRQ(obj->dev->cc_irq_num);
+
+    dma_hal_abort(&timer_dma_up[timer_num]);
+
+    // Clear object
+    timer_obj[timer_num] = (timer_obj_t){0};
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Start timer counter
+ *
+ * @note The update interrupt is enabled when an event callback is set.
+ * @param timer_num Timer number
+ * @return Operation status
+ */
+static int timer_hal_start(timer_num_t timer_num) {
+    omni_assert(timer_num < TIMER_NUM_MAX);
+
+    timer_obj_t *obj = &timer_obj[timer_num];
+    omni_assert_not_null(obj->dev);
+
+    TIM_HandleTypeDef *handle = obj->dev->handle;
+
+    if (obj->data.mode == TIMER_MODE_ENCODER) {
+        if (HAL_TIM_Encoder_Start(handle, TIM_CHANNEL_ALL) != HAL_OK) {
+            return OMNI_FAIL;
+        }
+    } else {
+        // Keep the HAL state untouched, channel functions start on their own
+        if (obj->event_cb != NULL) {
+            __HAL_TIM_CLEAR_FLAG(handle, TIM_FLAG_UPDATE);
+            __HAL_TIM_ENABLE_IT(handle, TIM_IT_UPDATE);
+        }
+        __HAL_TIM_ENABLE(handle);
+    }
+
+    // Set running status
+    obj->status.running = 1;
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Stop timer counter
+ *
+ * @param timer_num Timer number
+ * @return Operation status
+ */
+static int timer_hal_stop(timer_num_t timer_num) {
+    omni_assert(timer_num < TIMER_NUM_MAX);
+
+    timer_obj_t *obj = &timer_obj[timer_num];
+    omni_assert_not_null(obj->dev);
+
+    TIM_HandleTypeDef *handle = obj->dev->handle;
+
+    if (obj->data.mode == TIMER_MODE_ENCODER) {
+        if (HAL_TIM_Encoder_Stop(handle, TIM_CHANNEL_ALL) != HAL_OK) {
+            return OMNI_FAIL;
+        }
+    } else {
+        __HAL_TIM_DISABLE_IT(handle, TIM_IT_UPDATE);
+        // Stop the counter even if channels are still enabled
+        handle->Instance->CR1 &= ~TIM_CR1_CEN;
+    }
+
+    // Clear running status
+    obj->status.running = 0;
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Get timer counter
+ *
+ * @param timer_num Timer number
+ * @return Current counter value
+ */
+static uint32_t timer_hal_get_counter(timer_num_t timer_num) {
+    omni_assert(timer_num < TIMER_NUM_MAX);
+
+    timer_obj_t *obj = &timer_obj[timer_num];
+    omni_assert_not_null(obj->dev);
+
+    return __HAL_TIM_GET_COUNTER(obj->dev->handle);
+}
+
+/**
+ * @brief Start PWM output on a channel
+ *
+ * @param timer_num Timer number
+ * @param channel Timer channel
+ * @param pulse Pulse width in counter ticks
+ * @param polarity Output polarity
+ * @return Operation status
+ */
+static int timer_hal_pwm_start(timer_num_t timer_num, timer_channel_t channel, uint32_t pulse, timer_pwm_polarity_t polarity) {
+    TIM_OC_InitTypeDef oc_config = {0};
+    omni_assert(timer_num < TIMER_NUM_MAX);
+    omni_assert(channel < TIMER_CHANNEL_MAX);
+
+    timer_obj_t *obj = &timer_obj[timer_num];
+    omni_assert_not_null(obj->dev);
+
+    TIM_HandleTypeDef *handle = obj->dev->handle;
+
+    if (obj->data.mode != TIMER_MODE_PWM) {
+        return OMNI_FAIL;
+    }
+
+    oc_config.OCMode = TIM_OCMODE_PWM1;
+    oc_config.Pulse = pulse;
+    if (polarity == TIMER_PWM_POLARITY_HIGH) {
+        oc_config.OCPolarity = TIM_OCPOLARITY_HIGH;
+    } else {
+        oc_config.OCPolarity = TIM_OCPOLARITY_LOW;
+    }
+    oc_config.OCNPolarity = TIM_OCNPOLARITY_HIGH;
+    oc_config.OCFastMode = TIM_OCFAST_DISABLE;
+    oc_config.OCIdleState = TIM_OCIDLESTATE_RESET;
+    oc_config.OCNIdleState = TIM_OCNIDLESTATE_RESET;
+
+    if (HAL_TIM_PWM_ConfigChannel(handle, &oc_config, TIMER_HAL_CHANNEL(channel)) != HAL_OK) {
+        return OMNI_FAIL;
+    }
+
+    if (timer_hal_convert_status(HAL_TIM_PWM_Start(handle, TIMER_HAL_CHANNEL(channel))) != OMNI_OK) {
+        return OMNI_FAIL;
+    }
+
+    // Set running status
+    obj->status.running = 1;
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Stop PWM output on a channel
+ *
+ * @param timer_num Timer number
+ * @param channel Timer channel
+ * @return Operation status
+ */
+static int timer_hal_pwm_stop(timer_num_t timer_num, timer_channel_t channel) {
+    omni_assert(timer_num < TIMER_NUM_MAX);
+    omni_assert(channel < TIMER_CHANNEL_MAX);
+
+    timer_obj_t *obj = &timer_obj[timer_num];
+    omni_assert_not_null(obj->dev);
+
+    return timer_hal_convert_status(HAL_TIM_PWM_Stop(obj->dev->handle, TIMER_HAL_CHANNEL(channel)));
+}
+
+/**
+ * @brief Set PWM pulse of a channel
+ *
+ * @note The new pulse takes effect on the next update event.
+ * @param timer_num Timer number
+ * @param channel Timer channel
+ * @param pulse Pulse width in counter ticks
+ */
+static void timer_hal_pwm_set_pulse(timer_num_t timer_num, timer_channel_t channel, uint32_t pulse) {
+    omni_assert(timer_num < TIMER_NUM_MAX);
+    omni_assert(channel < TIMER_CHANNEL_MAX);
+
+    timer_obj_t *obj = &timer_obj[timer_num];
+    omni_assert_not_null(obj->dev);
+
+    __HAL_TIM_SET_COMPARE(obj->dev->handle, TIMER_HAL_CHANNEL(channel), pulse);
+}
+
+/**
+ * @brief Start input capture into a buffer
+ *
+ * @note Edge timestamps are moved by the capture DMA, no interrupt is taken
+ *       per edge. The channel must match the configured capture DMA request.
+ *       With the data cache enabled the buffer must start and end on a
+ *       cache line unless it is in the non-cacheable region, the halves are
+ *       invalidated as they complete.
+ * @param timer_num Timer number
+ * @param channel Timer channel
+ * @param edge Capture edge
+ * @param buffer Pointer to timestamp buffer
+ * @param len Number of timestamps to capture (up to 65535)
+ * @return Operation status
+ */
+static int timer_hal_capture_start(timer_num_t timer_num, timer_channel_t channel, timer_capture_edge_t edge, uint32_t *buffer, uint32_t len) {
+    TIM_IC_InitTypeDef ic_config = {0};
+    omni_assert(timer_num < TIMER_NUM_MAX);
+    omni_assert(channel < TIMER_CHANNEL_MAX);
+    omni_assert_not_null(buffer);
+    omni_assert_non_zero(len);
+
+    timer_obj_t *obj = &timer_obj[timer_num];
+    omni_assert_not_null(obj->dev);
+
+    TIM_HandleTypeDef *handle = obj->dev->handle;
+
+    if ((obj->data.mode != TIMER_MODE_CAPTURE) || (len > 0xFFFFU)) {
+        return OMNI_FAIL;
+    }
+
+    if ((obj->dev->dma_cc == NULL) || (obj->dev->cc_dma_channel != (uint32_t)channel)) {
+        return OMNI_FAIL;
+    }
+
+    if (obj->status.capture_busy) {
+        return OMNI_BUSY;
+    }
+
+    switch (edge) {
+        case TIMER_CAPTURE_EDGE_RISING:
+            ic_config.ICPolarity = TIM_ICPOLARITY_RISING;
+            break;
+
+        case TIMER_CAPTURE_EDGE_FALLING:
+            ic_config.ICPolarity = TIM_ICPOLARITY_FALLING;
+            break;
+
+        default:
+            ic_config.ICPolarity = TIM_ICPOLARITY_BOTHEDGE;
+            break;
+    }
+    ic_config.ICSelection = TIM_ICSELECTION_DIRECTTI;
+    ic_config.ICPrescaler = TIM_ICPSC_DIV1;
+    ic_config.ICFilter = 0;
+
+    if (HAL_TIM_IC_ConfigChannel(handle, &ic_config, TIMER_HAL_CHANNEL(channel)) != HAL_OK) {
+        return OMNI_FAIL;
+    }
+
+    if (dma_hal_circular_prepare(buffer, len * sizeof(uint32_t)) != OMNI_OK) {
+        return OMNI_FAIL;
+    }
+
+    obj->data.capture_buffer = buffer;
+    obj->data.capture_num = len;
+
+    // Set capture busy status
+    obj->status.capture_busy = 1;
+
+    if (timer_hal_convert_status(HAL_TIM_IC_Start_DMA(handle, TIMER_HAL_CHANNEL(channel), buffer, (uint16_t)len)) != OMNI_OK) {
+        obj->status.capture_busy = 0;
+        return OMNI_FAIL;
+    }
+
+    // Set running status
+    obj->status.running = 1;
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Stop input capture
+ *
+ * @param timer_num Timer number
+ * @param channel Timer channel
+ * @return Operation status
+ */
+static int timer_hal_capture_stop(timer_num_t timer_num, timer_channel_t channel) {
+    omni_assert(timer_num < TIMER_NUM_MAX);
+    omni_assert(channel < TIMER_CHANNEL_MAX);
+
+    timer_obj_t *obj = &timer_obj[timer_num];
+    omni_assert_not_null(obj->dev);
+
+    HAL_TIM_IC_Stop_DMA(obj->dev->handle, TIMER_HAL_CHANNEL(channel));
+
+    // Clear capture busy status
+    obj->status.capture_busy = 0;
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Write compare registers with DMA burst on update events
+ *
+ * @note Each update event writes @p channels consecutive compare registers
+ *       starting at @p channel, so @p data holds @p len / @p channels frames.
+ * @param timer_num Timer number
+ * @param channel First timer channel to update
+ * @param channels Number of channels updated per event (1..4)
+ * @param data Pointer to compare values
+ * @param len Number of compare values
+ * @return Operation status
+ */
+static int timer_hal_burst_write(timer_num_t timer_num, timer_channel_t channel, uint32_t channels, const uint32_t *data, uint32_t len) {
+    omni_assert(timer_num < TIMER_NUM_MAX);
+    omni_assert(channel < TIMER_CHANNEL_MAX);
+    omni_assert((channels != 0) && ((channel + channels) <= TIMER_CHANNEL_MAX));
+    omni_assert_not_null(data);
+    omni_assert_non_zero(len);
+
+    timer_obj_t *obj = &timer_obj[timer_num];
+    omni_assert_not_null(obj->dev);
+
+    TIM_HandleTypeDef *handle = obj->dev->handle;
+
+    if (obj->dev->dma_up == NULL) {
+        return OMNI_FAIL;
+    }
+
+    if ((obj->status.burst_busy) || (obj->status.dma_write_busy)) {
+        return OMNI_BUSY;
+    }
+
+    const void *burst_dma = dma_hal_tx_prepare(&timer_dma_up[timer_num], data, len * sizeof(uint32_t));
+    if (burst_dma == NULL) {
+        return OMNI_FAIL;
+    }
+
+    obj->data.burst_buffer = data;
+    obj->data.burst_num = len;
+
+    // Set burst busy status
+    obj->status.burst_busy = 1;
+
+    if (timer_hal_convert_status(HAL_TIM_DMABurst_MultiWriteStart(handle, TIM_DMABASE_CCR1 + (uint32_t)channel, \
+            TIM_DMA_UPDATE, (uint32_t *)burst_dma, (channels - 1U) << TIM_DCR_DBL_Pos, len)) != OMNI_OK) {
+        dma_hal_tx_complete(&timer_dma_up[timer_num]);
+        obj->status.burst_busy = 0;
+        return OMNI_FAIL;
+    }
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Write words to a peripheral register with DMA on update events
+ *
+ * @note One word is written to @p reg on every update event, so the output
+ *       timing is set by the counter period and does not depend on the CPU.
+ *       The counter is started if needed and stopped when the stream completes.
+ *       On STM32F4 only DMA2 can reach AHB peripherals such as GPIO, use the
+ *       update DMA of TIM1 or TIM8 to write GPIO registers.
+ * @param timer_num Timer number
+ * @param reg Pointer to the destination register
+ * @param data Pointer to words to write
+ * @param len Number of words to write (up to 65535)
+ * @return Operation status
+ */
+static int timer_hal_dma_write(timer_num_t timer_num, volatile uint32_t *reg, const uint32_t *data, uint32_t len) {
+    omni_assert(timer_num < TIMER_NUM_MAX);
+    omni_assert_not_null(reg);
+    omni_assert_not_null(data);
+    omni_assert_non_zero(len);
+
+    timer_obj_t *obj = &timer_obj[timer_num];
+    omni_assert_not_null(obj->dev);
+
+#if (CONFIG_TIMER_UP_DMA == 1)
+    TIM_HandleTypeDef *handle = obj->dev->handle;
+    DMA_HandleTypeDef *hdma = handle->hdma[TIM_DMA_ID_UPDATE];
+
+    if ((obj->dev->dma_up == NULL) || (hdma == NULL) || (len > 0xFFFFU)) {
+        return OMNI_FAIL;
+    }
+
+    if ((obj->status.burst_busy) || (obj->status.dma_write_busy)) {
+        return OMNI_BUSY;
+    }
+
+    const void *write_dma = dma_hal_tx_prepare(&timer_dma_up[timer_num], data, len * sizeof(uint32_t));
+    if (write_dma == NULL) {
+        return OMNI_FAIL;
+    }
+
+    hdma->XferCpltCallback = timer_hal_dma_write_cplt;
+    hdma->XferHalfCpltCallback = NULL;
+    hdma->XferErrorCallback = timer_hal_dma_write_error;
+
+    // Set DMA write busy status
+    obj->status.dma_write_busy = 1;
+
+    if (timer_hal_convert_status(HAL_DMA_Start_IT(hdma, (uint32_t)write_dma, (uint32_t)reg, len)) != OMNI_OK) {
+        dma_hal_tx_complete(&timer_dma_up[timer_num]);
+        obj->status.dma_write_busy = 0;
+        return OMNI_FAIL;
+    }
+
+    __HAL_TIM_ENABLE_DMA(handle, TIM_DMA_UPDATE);
+
+    // Start counter, the first word is written on the next update event
+    if (!obj->status.running) {
+        __HAL_TIM_SET_COUNTER(handle, 0);
+        __HAL_TIM_ENABLE(handle);
+        obj->status.running = 1;
+    }
+
+    return OMNI_OK;
+#else
+    return OMNI_FAIL;
+#endif /* (CONFIG_TIMER_UP_DMA == 1) */
+}
+
+/**
+ * @brief Get timer status
+ *
+ * @param timer_num Timer number
+ * @return Timer driver status
+ */
+static timer_driver_status_t timer_hal_get_status(timer_num_t timer_num) {
+    omni_assert(timer_num < TIMER_NUM_MAX);
+
+    timer_obj_t *obj = &timer_obj[timer_num];
+    omni_assert_not_null(obj);
+
+    return obj->status;
+}
+
+/**
+ * @brief Get timer error
+ *
+ * @param timer_num Timer number
+ * @return Timer driver error
+ */
+static timer_driver_error_t timer_hal_get_error(timer_num_t timer_num) {
+    omni_assert(timer_num < TIMER_NUM_MAX);
+
+    timer_obj_t *obj = &timer_obj[timer_num];
+    omni_assert_not_null(obj);
+
+    return obj->error;
+}
+#endif /* CONFIG_TIMER_HARDWARE */
+
 /**
  * @brief Delay for a number of milliseconds
- * 
+ *
  * @param delay Number of milliseconds to delay
  */
 static void timer_hal_delay_ms(uint32_t delay) {
@@ -45,7 +717,7 @@ static void timer_hal_delay_ms(uint32_t delay) {
 
 /**
  * @brief Delay for a number of microseconds
- * 
+ *
  * @param delay Number of microseconds to delay
  */
 static void timer_hal_delay_us(uint32_t delay) {
@@ -54,9 +726,747 @@ static void timer_hal_delay_us(uint32_t delay) {
 
 /**
  * @brief Get current tick
- * 
+ *
  * @return Current tick
  */
 static uint32_t timer_hal_get_tick(uint32_t frequency) {
     return dwt_hal_get_tick(frequency);
 }
+
+/**
+ * @brief Sleep until the next interrupt or timeout
+ *
+ * @param us Maximum number of microseconds to sleep
+ * @return Number of microseconds actually slept
+ */
+static uint32_t timer_hal_idle(uint32_t us) {
+    return dwt_hal_sleep_us(us);
+}
+
+#if defined(CONFIG_TIMER_HARDWARE)
+/********************* IRQ handlers **********************/
+
+/**
+ * @brief Timer IRQ handler
+ */
+static OMNI_FAST_ISR void timer_hal_irq_request(timer_obj_t *obj) {
+    omni_assert_not_null(obj);
+
+    HAL_TIM_IRQHandler(obj->dev->handle);
+}
+
+#if (CONFIG_TIMER_NUM_1 == 1)
+/**
+ * @brief TIM1 IRQ handler
+ */
+static OMNI_FAST_ISR void tim1_irq_handler(void) {
+    timer_hal_irq_request(&timer_obj[TIMER_NUM_1]);
+}
+#if (CONFIG_TIM1_UP_DMA == 1)
+/**
+ * @brief TIM1 update DMA IRQ handler
+ */
+static OMNI_FAST_ISR void tim1_up_dma_irq_handler(void) {
+    HAL_DMA_IRQHandler(timer_obj[TIMER_NUM_1].dev->dma_up->handle);
+}
+#endif /* (CONFIG_TIM1_UP_DMA == 1) */
+#if (CONFIG_TIM1_CC_DMA == 1)
+/**
+ * @brief TIM1 capture DMA IRQ handler
+ */
+static OMNI_FAST_ISR void tim1_cc_dma_irq_handler(void) {
+    HAL_DMA_IRQHandler(timer_obj[TIMER_NUM_1].dev->dma_cc->handle);
+}
+#endif /* (CONFIG_TIM1_CC_DMA == 1) */
+#endif /* (CONFIG_TIMER_NUM_1 == 1) */
+
+#if (CONFIG_TIMER_NUM_2 == 1)
+/**
+ * @brief TIM2 IRQ handler
+ */
+static OMNI_FAST_ISR void tim2_irq_handler(void) {
+    timer_hal_irq_request(&timer_obj[TIMER_NUM_2]);
+}
+#if (CONFIG_TIM2_UP_DMA == 1)
+/**
+ * @brief TIM2 update DMA IRQ handler
+ */
+static OMNI_FAST_ISR void tim2_up_dma_irq_handler(void) {
+    HAL_DMA_IRQHandler(timer_obj[TIMER_NUM_2].dev->dma_up->handle);
+}
+#endif /* (CONFIG_TIM2_UP_DMA == 1) */
+#if (CONFIG_TIM2_CC_DMA == 1)
+/**
+ * @brief TIM2 capture DMA IRQ handler
+ */
+static OMNI_FAST_ISR void tim2_cc_dma_irq_handler(void) {
+    HAL_DMA_IRQHandler(timer_obj[TIMER_NUM_2].dev->dma_cc->handle);
+}
+#endif /* (CONFIG_TIM2_CC_DMA == 1) */
+#endif /* (CONFIG_TIMER_NUM_2 == 1) */
+
+#if (CONFIG_TIMER_NUM_3 == 1)
+/**
+ * @brief TIM3 IRQ handler
+ */
+static OMNI_FAST_ISR void tim3_irq_handler(void) {
+    timer_hal_irq_request(&timer_obj[TIMER_NUM_3]);
+}
+#if (CONFIG_TIM3_UP_DMA == 1)
+/**
+ * @brief TIM3 update DMA IRQ handler
+ */
+static OMNI_FAST_ISR void tim3_up_dma_irq_handler(void) {
+    HAL_DMA_IRQHandler(timer_obj[TIMER_NUM_3].dev->dma_up->handle);
+}
+#endif /* (CONFIG_TIM3_UP_DMA == 1) */
+#if (CONFIG_TIM3_CC_DMA == 1)
+/**
+ * @brief TIM3 capture DMA IRQ handler
+ */
+static OMNI_FAST_ISR void tim3_cc_dma_irq_handler(void) {
+    HAL_DMA_IRQHandler(timer_obj[TIMER_NUM_3].dev->dma_cc->handle);
+}
+#endif /* (CONFIG_TIM3_CC_DMA == 1) */
+#endif /* (CONFIG_TIMER_NUM_3 == 1) */
+
+#if (CONFIG_TIMER_NUM_4 == 1)
+/**
+ * @brief TIM4 IRQ handler
+ */
+static OMNI_FAST_ISR void tim4_irq_handler(void) {
+    timer_hal_irq_request(&timer_obj[TIMER_NUM_4]);
+}
+#if (CONFIG_TIM4_UP_DMA == 1)
+/**
+ * @brief TIM4 update DMA IRQ handler
+ */
+static OMNI_FAST_ISR void tim4_up_dma_irq_handler(void) {
+    HAL_DMA_IRQHandler(timer_obj[TIMER_NUM_4].dev->dma_up->handle);
+}
+#endif /* (CONFIG_TIM4_UP_DMA == 1) */
+#if (CONFIG_TIM4_CC_DMA == 1)
+/**
+ * @brief TIM4 capture DMA IRQ handler
+ */
+static OMNI_FAST_ISR void tim4_cc_dma_irq_handler(void) {
+    HAL_DMA_IRQHandler(timer_obj[TIMER_NUM_4].dev->dma_cc->handle);
+}
+#endif /* (CONFIG_TIM4_CC_DMA == 1) */
+#endif /* (CONFIG_TIMER_NUM_4 == 1) */
+
+#if (CONFIG_TIMER_NUM_5 == 1)
+/**
+ * @brief TIM5 IRQ handler
+ */
+static OMNI_FAST_ISR void tim5_irq_handler(void) {
+    timer_hal_irq_request(&timer_obj[TIMER_NUM_5]);
+}
+#if (CONFIG_TIM5_UP_DMA == 1)
+/**
+ * @brief TIM5 update DMA IRQ handler
+ */
+static OMNI_FAST_ISR void tim5_up_dma_irq_handler(void) {
+    HAL_DMA_IRQHandler(timer_obj[TIMER_NUM_5].dev->dma_up->handle);
+}
+#endif /* (CONFIG_TIM5_UP_DMA == 1) */
+#if (CONFIG_TIM5_CC_DMA == 1)
+/**
+ * @brief TIM5 capture DMA IRQ handler
+ */
+static OMNI_FAST_ISR void tim5_cc_dma_irq_handler(void) {
+    HAL_DMA_IRQHandler(timer_obj[TIMER_NUM_5].dev->dma_cc->handle);
+}
+#endif /* (CONFIG_TIM5_CC_DMA == 1) */
+#endif /* (CONFIG_TIMER_NUM_5 == 1) */
+
+#if (CONFIG_TIMER_NUM_8 == 1)
+/**
+ * @brief TIM8 IRQ handler
+ */
+static OMNI_FAST_ISR void tim8_irq_handler(void) {
+    timer_hal_irq_request(&timer_obj[TIMER_NUM_8]);
+}
+#if (CONFIG_TIM8_UP_DMA == 1)
+/**
+ * @brief TIM8 update DMA IRQ handler
+ */
+static OMNI_FAST_ISR void tim8_up_dma_irq_handler(void) {
+    HAL_DMA_IRQHandler(timer_obj[TIMER_NUM_8].dev->dma_up->handle);
+}
+#endif /* (CONFIG_TIM8_UP_DMA == 1) */
+#if (CONFIG_TIM8_CC_DMA == 1)
+/**
+ * @brief TIM8 capture DMA IRQ handler
+ */
+static OMNI_FAST_ISR void tim8_cc_dma_irq_handler(void) {
+    HAL_DMA_IRQHandler(timer_obj[TIMER_NUM_8].dev->dma_cc->handle);
+}
+#endif /* (CONFIG_TIM8_CC_DMA == 1) */
+#endif /* (CONFIG_TIMER_NUM_8 == 1) */
+
+/**
+ * @brief Register timer IRQ
+ *
+ * @param timer_num Timer number
+ * @param dev Timer device information
+ */
+static void timer_hal_irq_register(timer_num_t timer_num, timer_dev_t *dev) {
+    switch (timer_num) {
+#if (CONFIG_TIMER_NUM_1 == 1)
+        case TIMER_NUM_1:
+            irq_hal_register_handler(dev->irq_num, tim1_irq_handler);
+            if (dev->cc_irq_num != dev->irq_num) {
+                irq_hal_register_handler(dev->cc_irq_num, tim1_irq_handler);
+            }
+#if (CONFIG_TIM1_UP_DMA == 1)
+            irq_hal_register_handler(dev->dma_up->irq_num, tim1_up_dma_irq_handler);
+#endif /* (CONFIG_TIM1_UP_DMA == 1) */
+#if (CONFIG_TIM1_CC_DMA == 1)
+            irq_hal_register_handler(dev->dma_cc->irq_num, tim1_cc_dma_irq_handler);
+#endif /* (CONFIG_TIM1_CC_DMA == 1) */
+            break;
+#endif /* (CONFIG_TIMER_NUM_1 == 1) */
+
+#if (CONFIG_TIMER_NUM_2 == 1)
+        case TIMER_NUM_2:
+            irq_hal_register_handler(dev->irq_num, tim2_irq_handler);
+            if (dev->cc_irq_num != dev->irq_num) {
+                irq_hal_register_handler(dev->cc_irq_num, tim2_irq_handler);
+            }
+#if (CONFIG_TIM2_UP_DMA == 1)
+            irq_hal_register_handler(dev->dma_up->irq_num, tim2_up_dma_irq_handler);
+#endif /* (CONFIG_TIM2_UP_DMA == 1) */
+#if (CONFIG_TIM2_CC_DMA == 1)
+            irq_hal_register_handler(dev->dma_cc->irq_num, tim2_cc_dma_irq_handler);
+#endif /* (CONFIG_TIM2_CC_DMA == 1) */
+            break;
+#endif /* (CONFIG_TIMER_NUM_2 == 1) */
+
+#if (CONFIG_TIMER_NUM_3 == 1)
+        case TIMER_NUM_3:
+            irq_hal_register_handler(dev->irq_num, tim3_irq_handler);
+            if (dev->cc_irq_num != dev->irq_num) {
+                irq_hal_register_handler(dev->cc_irq_num, tim3_irq_handler);
+            }
+#if (CONFIG_TIM3_UP_DMA == 1)
+            irq_hal_register_handler(dev->dma_up->irq_num, tim3_up_dma_irq_handler);
+#endif /* (CONFIG_TIM3_UP_DMA == 1) */
+#if (CONFIG_TIM3_CC_DMA == 1)
+            irq_hal_register_handler(dev->dma_cc->irq_num, tim3_cc_dma_irq_handler);
+#endif /* (CONFIG_TIM3_CC_DMA == 1) */
+            break;
+#endif /* (CONFIG_TIMER_NUM_3 == 1) */
+
+#if (CONFIG_TIMER_NUM_4 == 1)
+        case TIMER_NUM_4:
+            irq_hal_register_handler(dev->irq_num, tim4_irq_handler);
+            if (dev->cc_irq_num != dev->irq_num) {
+                irq_hal_register_handler(dev->cc_irq_num, tim4_irq_handler);
+            }
+#if (CONFIG_TIM4_UP_DMA == 1)
+            irq_hal_register_handler(dev->dma_up->irq_num, tim4_up_dma_irq_handler);
+#endif /* (CONFIG_TIM4_UP_DMA == 1) */
+#if (CONFIG_TIM4_CC_DMA == 1)
+            irq_hal_register_handler(dev->dma_cc->irq_num, tim4_cc_dma_irq_handler);
+#endif /* (CONFIG_TIM4_CC_DMA == 1) */
+            break;
+#endif /* (CONFIG_TIMER_NUM_4 == 1) */
+
+#if (CONFIG_TIMER_NUM_5 == 1)
+        case TIMER_NUM_5:
+            irq_hal_register_handler(dev->irq_num, tim5_irq_handler);
+            if (dev->cc_irq_num != dev->irq_num) {
+                irq_hal_register_handler(dev->cc_irq_num, tim5_irq_handler);
+            }
+#if (CONFIG_TIM5_UP_DMA == 1)
+            irq_hal_register_handler(dev->dma_up->irq_num, tim5_up_dma_irq_handler);
+#endif /* (CONFIG_TIM5_UP_DMA == 1) */
+#if (CONFIG_TIM5_CC_DMA == 1)
+            irq_hal_register_handler(dev->dma_cc->irq_num, tim5_cc_dma_irq_handler);
+#endif /* (CONFIG_TIM5_CC_DMA == 1) */
+            break;
+#endif /* (CONFIG_TIMER_NUM_5 == 1) */
+
+#if (CONFIG_TIMER_NUM_8 == 1)
+        case TIMER_NUM_8:
+            irq_hal_register_handler(dev->irq_num, tim8_irq_handler);
+            if (dev->cc_irq_num != dev->irq_num) {
+                irq_hal_register_handler(dev->cc_irq_num, tim8_irq_handler);
+            }
+#if (CONFIG_TIM8_UP_DMA == 1)
+            irq_hal_register_handler(dev->dma_up->irq_num, tim8_up_dma_irq_handler);
+#endif /* (CONFIG_TIM8_UP_DMA == 1) */
+#if (CONFIG_TIM8_CC_DMA == 1)
+            irq_hal_register_handler(dev->dma_cc->irq_num, tim8_cc_dma_irq_handler);
+#endif /* (CONFIG_TIM8_CC_DMA == 1) */
+            break;
+#endif /* (CONFIG_TIMER_NUM_8 == 1) */
+        default:
+            break;
+    }
+}
+
+/********************* Callback functions **********************/
+void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim) {
+    timer_obj_t *obj = timer_hal_get_obj(htim);
+    omni_assert_not_null(obj);
+
+#if (CONFIG_TIMER_UP_DMA == 1)
+    // DMA burst completion is reported through the same HAL callback
+    if ((obj->status.burst_busy) && (htim->hdma[TIM_DMA_ID_UPDATE] != NULL) && \
+        (htim->hdma[TIM_DMA_ID_UPDATE]->State == HAL_DMA_STATE_READY)) {
+        HAL_TIM_DMABurst_WriteStop(htim, TIM_DMA_UPDATE);
+        dma_hal_tx_complete(&timer_dma_up[obj - timer_obj]);
+
+        // Clear burst busy status
+        obj->status.burst_busy = 0;
+
+        if (obj->event_cb != NULL) {
+            // Set burst complete event
+            obj->event_cb(TIMER_EVENT_BURST_COMPLETE);
+        }
+        return;
+    }
+#endif /* (CONFIG_TIMER_UP_DMA == 1) */
+
+    if (obj->event_cb != NULL) {
+        // Set update event
+        obj->event_cb(TIMER_EVENT_UPDATE);
+    }
+}
+
+void HAL_TIM_IC_CaptureHalfCpltCallback(TIM_HandleTypeDef *htim) {
+    timer_obj_t *obj = timer_hal_get_obj(htim);
+    omni_assert_not_null(obj);
+
+    // Drop cached lines of the first half before it is read
+    dma_hal_circular_done(obj->data.capture_buffer, (obj->data.capture_num / 2U) * sizeof(uint32_t));
+
+    if (obj->event_cb != NULL) {
+        // Set capture half event
+        obj->event_cb(TIMER_EVENT_CAPTURE_HALF);
+    }
+}
+
+void HAL_TIM_IC_CaptureCallback(TIM_HandleTypeDef *htim) {
+    timer_obj_t *obj = timer_hal_get_obj(htim);
+    omni_assert_not_null(obj);
+
+    if (!obj->status.capture_busy) {
+        return;
+    }
+
+    // Release the channel so that the next capture can be started
+    HAL_TIM_IC_Stop_DMA(htim, TIMER_HAL_CHANNEL(obj->dev->cc_dma_channel));
+    dma_hal_circular_done(obj->data.capture_buffer, obj->data.capture_num * sizeof(uint32_t));
+
+    // Clear capture busy status
+    obj->status.capture_busy = 0;
+
+    if (obj->event_cb != NULL) {
+        // Set capture complete event
+        obj->event_cb(TIMER_EVENT_CAPTURE_COMPLETE);
+    }
+}
+
+void HAL_TIM_ErrorCallback(TIM_HandleTypeDef *htim) {
+    timer_obj_t *obj = timer_hal_get_obj(htim);
+    omni_assert_not_null(obj);
+
+    dma_hal_abort(&timer_dma_up[obj - timer_obj]);
+
+    // Clear busy status
+    obj->status.capture_busy = 0;
+    obj->status.burst_busy = 0;
+    obj->status.dma_write_busy = 0;
+
+    // Set DMA error
+    obj->error.dma_error = 1;
+
+    if (obj->event_cb != NULL) {
+        // Set DMA error event
+        obj->event_cb(TIMER_EVENT_DMA_ERROR);
+    }
+}
+
+#if (CONFIG_TIMER_UP_DMA == 1)
+/**
+ * @brief DMA write complete callback
+ *
+ * @param hdma DMA handle
+ */
+static void timer_hal_dma_write_cplt(DMA_HandleTypeDef *hdma) {
+    TIM_HandleTypeDef *htim = (TIM_HandleTypeDef *)hdma->Parent;
+    timer_obj_t *obj = timer_hal_get_obj(htim);
+    omni_assert_not_null(obj);
+
+    // Stop counter so that the last word stays on the output
+    __HAL_TIM_DISABLE_DMA(htim, TIM_DMA_UPDATE);
+    htim->Instance->CR1 &= ~TIM_CR1_CEN;
+    dma_hal_tx_complete(&timer_dma_up[obj - timer_obj]);
+
+    // Clear busy and running status
+    obj->status.dma_write_busy = 0;
+    obj->status.running = 0;
+
+    if (obj->event_cb != NULL) {
+        // Set DMA write complete event
+        obj->event_cb(TIMER_EVENT_DMA_WRITE_COMPLETE);
+    }
+}
+
+/**
+ * @brief DMA write error callback
+ *
+ * @param hdma DMA handle
+ */
+static void timer_hal_dma_write_error(DMA_HandleTypeDef *hdma) {
+    TIM_HandleTypeDef *htim = (TIM_HandleTypeDef *)hdma->Parent;
+    timer_obj_t *obj = timer_hal_get_obj(htim);
+    omni_assert_not_null(obj);
+
+    __HAL_TIM_DISABLE_DMA(htim, TIM_DMA_UPDATE);
+    htim->Instance->CR1 &= ~TIM_CR1_CEN;
+    dma_hal_abort(&timer_dma_up[obj - timer_obj]);
+
+    // Clear busy and running status
+    obj->status.dma_write_busy = 0;
+    obj->status.running = 0;
+
+    // Set DMA error
+    obj->error.dma_error = 1;
+
+    if (obj->event_cb != NULL) {
+        // Set DMA error event
+        obj->event_cb(TIMER_EVENT_DMA_ERROR);
+    }
+}
+#endif /* (CONFIG_TIMER_UP_DMA == 1) */
+
+/********************* Private functions **********************/
+
+/**
+ * @brief Configure timer
+ *
+ * @param dev Timer device information
+ * @param config Pointer to the timer driver configuration
+ * @return Operation status
+ */
+static int timer_hal_configure(timer_dev_t *dev, timer_driver_config_t *config) {
+    TIM_Encoder_InitTypeDef encoder_config = {0};
+    TIM_MasterConfigTypeDef master_config = {0};
+    HAL_StatusTypeDef status;
+    uint32_t prescaler;
+    TIM_HandleTypeDef *handle = dev->handle;
+
+    if ((config->frequency == 0) || (config->frequency > dev->clock) || (config->period == 0)) {
+        return OMNI_FAIL;
+    }
+
+    // Prescaler is 16 bits on all timers
+    prescaler = dev->clock / config->frequency;
+    if (prescaler > 0x10000U) {
+        return OMNI_FAIL;
+    }
+
+    if (!IS_TIM_32B_COUNTER_INSTANCE(handle->Instance) && (config->period > 0x10000U)) {
+        return OMNI_FAIL;
+    }
+
+    handle->Init.Prescaler = prescaler - 1;
+    handle->Init.CounterMode = TIM_COUNTERMODE_UP;
+    handle->Init.Period = config->period - 1;
+    handle->Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+    handle->Init.RepetitionCounter = 0;
+    handle->Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_ENABLE;
+
+    switch (config->mode) {
+        case TIMER_MODE_BASE:
+            status = HAL_TIM_Base_Init(handle);
+            break;
+
+        case TIMER_MODE_PWM:
+            status = HAL_TIM_PWM_Init(handle);
+            break;
+
+        case TIMER_MODE_CAPTURE:
+            status = HAL_TIM_IC_Init(handle);
+            break;
+
+        case TIMER_MODE_ENCODER:
+            encoder_config.EncoderMode = TIM_ENCODERMODE_TI12;
+            encoder_config.IC1Polarity = TIM_ICPOLARITY_RISING;
+            encoder_config.IC1Selection = TIM_ICSELECTION_DIRECTTI;
+            encoder_config.IC1Prescaler = TIM_ICPSC_DIV1;
+            encoder_config.IC1Filter = 0;
+            encoder_config.IC2Polarity = TIM_ICPOLARITY_RISING;
+            encoder_config.IC2Selection = TIM_ICSELECTION_DIRECTTI;
+            encoder_config.IC2Prescaler = TIM_ICPSC_DIV1;
+            encoder_config.IC2Filter = 0;
+            status = HAL_TIM_Encoder_Init(handle, &encoder_config);
+            break;
+
+        default:
+            return OMNI_FAIL;
+    }
+
+    if (status != HAL_OK) {
+        return OMNI_FAIL;
+    }
+
+    // Output the update event on TRGO, an ADC can then start a scan each period
+    if (((config->mode == TIMER_MODE_BASE) || (config->mode == TIMER_MODE_PWM)) &&
+        IS_TIM_MASTER_INSTANCE(handle->Instance)) {
+        master_config.MasterOutputTrigger = TIM_TRGO_UPDATE;
+        master_config.MasterSlaveMode = TIM_MASTERSLAVEMODE_DISABLE;
+        if (HAL_TIMEx_MasterConfigSynchronization(handle, &master_config) != HAL_OK) {
+            return OMNI_FAIL;
+        }
+    }
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Set GPIO for timer
+ *
+ * @param dev Timer device information
+ */
+static void timer_hal_set_gpio(timer_dev_t *dev) {
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+
+    GPIO_InitStruct.Mode = GPIO_MODE_AF_PP;
+    GPIO_InitStruct.Pull = GPIO_NOPULL;
+    GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_VERY_HIGH;
+
+    for (uint32_t i = 0; i < ARRAY_SIZE(dev->ch_pin); i++) {
+        if (dev->ch_pin[i] != NULL) {
+            gpio_hal_enable_clock(dev->ch_pin[i]->ins);
+
+            GPIO_InitStruct.Pin = dev->ch_pin[i]->index;
+            GPIO_InitStruct.Alternate = dev->ch_pin[i]->alternate;
+            HAL_GPIO_Init(dev->ch_pin[i]->ins, &GPIO_InitStruct);
+        }
+    }
+}
+
+/**
+ * @brief Reset GPIO for timer
+ *
+ * @param dev Timer device information
+ */
+static void timer_hal_reset_gpio(timer_dev_t *dev) {
+    for (uint32_t i = 0; i < ARRAY_SIZE(dev->ch_pin); i++) {
+        if (dev->ch_pin[i] != NULL) {
+            HAL_GPIO_DeInit(dev->ch_pin[i]->ins, dev->ch_pin[i]->index);
+        }
+    }
+}
+
+/**
+ * @brief Enable timer clock
+ *
+ * @param timer_num Timer number
+ *
+ * @return Operation status
+ */
+static int timer_hal_enable_clock(timer_num_t timer_num) {
+    switch (timer_num) {
+#if defined(TIM1) && (CONFIG_TIMER_NUM_1 == 1)
+        case TIMER_NUM_1:
+            __HAL_RCC_TIM1_CLK_ENABLE();
+            break;
+#endif /* TIM1 && (CONFIG_TIMER_NUM_1 == 1) */
+
+#if defined(TIM2) && (CONFIG_TIMER_NUM_2 == 1)
+        case TIMER_NUM_2:
+            __HAL_RCC_TIM2_CLK_ENABLE();
+            break;
+#endif /* TIM2 && (CONFIG_TIMER_NUM_2 == 1) */
+
+#if defined(TIM3) && (CONFIG_TIMER_NUM_3 == 1)
+        case TIMER_NUM_3:
+            __HAL_RCC_TIM3_CLK_ENABLE();
+            break;
+#endif /* TIM3 && (CONFIG_TIMER_NUM_3 == 1) */
+
+#if defined(TIM4) && (CONFIG_TIMER_NUM_4 == 1)
+        case TIMER_NUM_4:
+            __HAL_RCC_TIM4_CLK_ENABLE();
+            break;
+#endif /* TIM4 && (CONFIG_TIMER_NUM_4 == 1) */
+
+#if defined(TIM5) && (CONFIG_TIMER_NUM_5 == 1)
+        case TIMER_NUM_5:
+            __HAL_RCC_TIM5_CLK_ENABLE();
+            break;
+#endif /* TIM5 && (CONFIG_TIMER_NUM_5 == 1) */
+
+#if defined(TIM8) && (CONFIG_TIMER_NUM_8 == 1)
+        case TIMER_NUM_8:
+            __HAL_RCC_TIM8_CLK_ENABLE();
+            break;
+#endif /* TIM8 && (CONFIG_TIMER_NUM_8 == 1) */
+        default:
+            return OMNI_FAIL;
+    }
+
+    return OMNI_OK;
+}
+
+/**
+ * @brief Undo a failed initialization in reverse order
+ *
+ * @note Only streams claimed by this timer are released and deinitialized,
+ *       a claim fails when another driver owns the stream.
+ * @param timer_num Timer number
+ * @param dma_up Update DMA stream was claimed
+ * @param dma_cc Capture DMA stream was claimed
+ */
+static void timer_hal_init_undo(timer_num_t timer_num, bool dma_up, bool dma_cc) {
+    timer_obj_t *obj = &timer_obj[timer_num];
+
+    NVIC_DisableIRQ(obj->dev->irq_num);
+    NVIC_DisableIRQ(obj->dev->cc_irq_num);
+
+#if (CONFIG_TIMER_CC_DMA == 1)
+    if (dma_cc && (obj->dev->dma_cc != NULL)) {
+        NVIC_DisableIRQ(obj->dev->dma_cc->irq_num);
+        HAL_DMA_DeInit(obj->dev->dma_cc->handle);
+        dma_hal_release(obj->dev->dma_cc);
+    }
+#else
+    UNUSED(dma_cc);
+#endif /* (CONFIG_TIMER_CC_DMA == 1) */
+
+#if (CONFIG_TIMER_UP_DMA == 1)
+    if (dma_up && (obj->dev->dma_up != NULL)) {
+        NVIC_DisableIRQ(obj->dev->dma_up->irq_num);
+        HAL_DMA_DeInit(obj->dev->dma_up->handle);
+        dma_hal_release(obj->dev->dma_up);
+    }
+#else
+    UNUSED(dma_up);
+#endif /* (CONFIG_TIMER_UP_DMA == 1) */
+
+    timer_hal_reset_gpio(obj->dev);
+    timer_hal_reset_clock(timer_num);
+
+    timer_obj[timer_num] = (timer_obj_t){0};
+}
+
+/**
+ * @brief Reset timer clock
+ *
+ * @param timer_num Timer number
+ */
+static void timer_hal_reset_clock(timer_num_t timer_num) {
+    switch (timer_num) {
+#if defined(TIM1) && (CONFIG_TIMER_NUM_1 == 1)
+        case TIMER_NUM_1:
+            __HAL_RCC_TIM1_CLK_DISABLE();
+            break;
+#endif /* TIM1 && (CONFIG_TIMER_NUM_1 == 1) */
+
+#if defined(TIM2) && (CONFIG_TIMER_NUM_2 == 1)
+        case TIMER_NUM_2:
+            __HAL_RCC_TIM2_CLK_DISABLE();
+            break;
+#endif /* TIM2 && (CONFIG_TIMER_NUM_2 == 1) */
+
+#if defined(TIM3) && (CONFIG_TIMER_NUM_3 == 1)
+        case TIMER_NUM_3:
+            __HAL_RCC_TIM3_CLK_DISABLE();
+            break;
+#endif /* TIM3 && (CONFIG_TIMER_NUM_3 == 1) */
+
+#if defined(TIM4) && (CONFIG_TIMER_NUM_4 == 1)
+        case TIMER_NUM_4:
+            __HAL_RCC_TIM4_CLK_DISABLE();
+            break;
+#endif /* TIM4 && (CONFIG_TIMER_NUM_4 == 1) */
+
+#if defined(TIM5) && (CONFIG_TIMER_NUM_5 == 1)
+        case TIMER_NUM_5:
+            __HAL_RCC_TIM5_CLK_DISABLE();
+            break;
+#endif /* TIM5 && (CONFIG_TIMER_NUM_5 == 1) */
+
+#if defined(TIM8) && (CONFIG_TIMER_NUM_8 == 1)
+        case TIMER_NUM_8:
+            __HAL_RCC_TIM8_CLK_DISABLE();
+            break;
+#endif /* TIM8 && (CONFIG_TIMER_NUM_8 == 1) */
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Convert HAL status to OMNI status
+ *
+ * @param status HAL status
+ * @return Operation status
+ */
+static int timer_hal_convert_status(HAL_StatusTypeDef status) {
+    switch (status) {
+        case HAL_OK:
+            return OMNI_OK;
+
+        case HAL_BUSY:
+            return OMNI_BUSY;
+
+        default:
+            return OMNI_FAIL;
+    }
+}
+
+/**
+ * @brief Get timer object
+ *
+ * @param htim Timer handle
+ * @return Pointer to timer object
+ */
+static timer_obj_t *timer_hal_get_obj(TIM_HandleTypeDef *htim) {
+    timer_obj_t *obj = NULL;
+
+#if defined(TIM1) && (CONFIG_TIMER_NUM_1 == 1)
+    if (htim->Instance == TIM1) {
+        obj = &timer_obj[TIMER_NUM_1];
+    }
+#endif /* TIM1 && (CONFIG_TIMER_NUM_1 == 1) */
+
+#if defined(TIM2) && (CONFIG_TIMER_NUM_2 == 1)
+    if (htim->Instance == TIM2) {
+        obj = &timer_obj[TIMER_NUM_2];
+    }
+#endif /* TIM2 && (CONFIG_TIMER_NUM_2 == 1) */
+
+#if defined(TIM3) && (CONFIG_TIMER_NUM_3 == 1)
+    if (htim->Instance == TIM3) {
+        obj = &timer_obj[TIMER_NUM_3];
+    }
+#endif /* TIM3 && (CONFIG_TIMER_NUM_3 == 1) */
+
+#if defined(TIM4) && (CONFIG_TIMER_NUM_4 == 1)
+    if (htim->Instance == TIM4) {
+        obj = &timer_obj[TIMER_NUM_4];
+    }
+#endif /* TIM4 && (CONFIG_TIMER_NUM_4 == 1) */
+
+#if defined(TIM5) && (CONFIG_TIMER_NUM_5 == 1)
+    if (htim->Instance == TIM5) {
+        obj = &timer_obj[TIMER_NUM_5];
+    }
+#endif /* TIM5 && (CONFIG_TIMER_NUM_5 == 1) */
+
+#if defined(TIM8) && (CONFIG_TIMER_NUM_8 == 1)
+    if (htim->Instance == TIM8) {
+        obj = &timer_obj[TIMER_NUM_8];
+    }
+#endif /* TIM8 && (CONFIG_TIMER_NUM_8 == 1) */
+
+    return obj;
+}
+#endif /* CONFIG_TIMER_HARDWARE */
@@ -25,21 +25,26 @@
 #include "hal/gpio_hal.h"
 #include "hal/dma_hal.h"
 #include "hal/irq_hal.h"
+#include "trace/trace.h"
 #include "ll/usart_ll.h"
 
 static usart_obj_t usart_obj[USART_NUM_MAX];
 
-static int usart_hal_init(usart_num_t usart_num, usart_driver_config_t *config);
-static int usart_hal_deinit(usart_num_t usart_num);
-static void usart_hal_start(usart_num_t usart_num);
-static void usart_hal_stop(usart_num_t usart_num);
-static int usart_hal_poll_send(usart_num_t usart_num, const uint8_t *data, uint32_t len, uint32_t timeout);
-static int usart_hal_poll_receive(usart_num_t usart_num, void *data, uint32_t len, uint32_t timeout);
-static int usart_hal_send(usart_num_t usart_num, const uint8_t *data, uint32_t len);
-static int usart_hal_receive(usart_num_t usart_num, void *data, uint32_t len);
-static usart_driver_status_t usart_hal_get_status(usart_num_t usart_num);
-static usart_driver_error_t usart_hal_get_error(usart_num_t usart_num);
-
+OMNI_DRIVER_API int usart_hal_init(usart_num_t usart_num, usart_driver_config_t *config);
+OMNI_DRIVER_API int usart_hal_deinit(usart_num_t usart_num);
+OMNI_DRIVER_API void usart_hal_start(usart_num_t usart_num);
+OMNI_DRIVER_API void usart_hal_stop(usart_num_t usart_num);
+OMNI_DRIVER_API int usart_hal_poll_send(usart_num_t usart_num, const uint8_t *data, uint32_t len, uint32_t timeout);
+OMNI_DRIVER_API int usart_hal_poll_receive(usart_num_t usart_num, void *data, uint32_t len, uint32_t timeout);
+OMNI_DRIVER_API int usart_hal_send(usart_num_t usart_num, const uint8_t *data, uint32_t len);
+OMNI_DRIVER_API int usart_hal_receive(usart_num_t usart_num, void *data, uint32_t len);
+OMNI_DRIVER_API int usart_hal_stream_send(usart_num_t usart_num, void *buffer0, void *buffer1, uint32_t len, usart_stream_callback cb);
+OMNI_DRIVER_API int usart_hal_stream_receive(usart_num_t usart_num, void *buffer0, void *buffer1, uint32_t len, usart_stream_callback cb);
+OMNI_DRIVER_API void usart_hal_stream_stop(usart_num_t usart_num);
+OMNI_DRIVER_API usart_driver_status_t usart_hal_get_status(usart_num_t usart_num);
+OMNI_DRIVER_API usart_driver_error_t usart_hal_get_error(usart_num_t usart_num);
+
+#if !defined(CONFIG_OMNI_DRIVER_DIRECT_CALL)
 const struct usart_driver_api usart_driver = {
     .init = usart_hal_init,
     .deinit = usart_hal_deinit,
@@ -49,9 +54,13 @@ const struct usart_driver_api usart_driver = {
     .poll_receive = usart_hal_poll_receive,
     .send = usart_hal_send,
     .receive = usart_hal_receive,
+    .stream_send = usart_hal_stream_send,
+    .stream_receive = usart_hal_stream_receive,
+    .stream_stop = usart_hal_stream_stop,
     .get_status = usart_hal_get_status,
     .get_error = usart_hal_get_error,
 };
+#endif /* CONFIG_OMNI_DRIVER_DIRECT_CALL */
 
 static void usart_hal_irq_register(void);
 static void usart_hal_irq_request(usart_obj_t *obj);
@@ -63,6 +72,12 @@ static usart_obj_t *usart_hal_get_obj(UART_HandleTypeDef *huart);
 
 static void usart_tx_dma_event_callback(DMA_HandleTypeDef *hdma);
 static void usart_rx_dma_event_callback(DMA_HandleTypeDef *hdma);
+#if ((CONFIG_USART_TX_DMA == 1) || (CONFIG_USART_RX_DMA == 1))
+static void usart_tx_stream_callback(DMA_HandleTypeDef *hdma);
+static void usart_rx_stream_callback(DMA_HandleTypeDef *hdma);
+static void usart_stream_error_callback(DMA_HandleTypeDef *hdma);
+static uint32_t usart_hal_get_bytes(UART_HandleTypeDef *handle, uint32_t len);
+#endif /* ((CONFIG_USART_TX_DMA == 1) || (CONFIG_USART_RX_DMA == 1)) */
 
 /**
  * @brief Open the USART port
@@ -71,7 +86,7 @@ static void usart_rx_dma_event_callback(DMA_HandleTypeDef *hdma);
  * @param config Pointer to driver configuration structure
  * @return Operation status
  */
-static int usart_hal_init(usart_num_t usart_num, usart_driver_config_t *config) {
+OMNI_DRIVER_API int usart_hal_init(usart_num_t usart_num, usart_driver_config_t *config) {
     omni_assert(usart_num < USART_NUM_MAX);
     omni_assert_not_null(config);
 
@@ -110,6 +125,10 @@ static int usart_hal_init(usart_num_t usart_num, usart_driver_config_t *config)
 #if (CONFIG_USART_TX_DMA == 1)
     // Configure USART DMA TX
     if (obj->dev->dma_tx != NULL) {
+        if (dma_hal_claim(obj->dev->dma_tx, obj->dev->handle->Instance, DMA_HAL_DIR_TX) != OMNI_OK) {
+            return OMNI_FAIL;
+        }
+
         dma_hal_enable_clock(obj->dev->dma_tx->ins);
 
         if (HAL_DMA_Init(obj->dev->dma_tx->handle) != HAL_OK) {
@@ -128,6 +147,10 @@ static int usart_hal_init(usart_num_t usart_num, usart_driver_config_t *config)
 #if (CONFIG_USART_RX_DMA == 1)
      // Configure USART DMA RX
     if (obj->dev->dma_rx != NULL) {
+        if (dma_hal_claim(obj->dev->dma_rx, obj->dev->handle->Instance, DMA_HAL_DIR_RX) != OMNI_OK) {
+            return OMNI_FAIL;
+        }
+
         dma_hal_enable_clock(obj->dev->dma_rx->ins);
 
         if (HAL_DMA_Init(obj->dev->dma_rx->handle) != HAL_OK) {
@@ -236,12 +259,15 @@ static int usart_hal_init(usart_num_t usart_num, usart_driver_config_t *config)
  * @param usart_num USART port number
  * @return Operation status
  */
-static int usart_hal_deinit(usart_num_t usart_num) {
+OMNI_DRIVER_API int usart_hal_deinit(usart_num_t usart_num) {
     omni_assert(usart_num < USART_NUM_MAX);
 
     usart_obj_t *obj = &usart_obj[usart_num];
     omni_assert_not_null(obj);
 
+    // A streaming DMA cannot be deinitialized
+    usart_hal_stream_stop(usart_num);
+
     // Reset USART clock
     usart_hal_reset_clock(usart_num);
 
@@ -251,6 +277,7 @@ static int usart_hal_deinit(usart_num_t usart_num) {
 #if (CONFIG_USART_TX_DMA == 1)
     // Deinitialize USART DMA TX
     if (obj->dev->dma_tx != NULL) {
+        dma_hal_release(obj->dev->dma_tx);
         HAL_DMA_DeInit(obj->dev->dma_tx->handle);
     }
 #endif /* (CONFIG_USART_TX_DMA == 1) */
@@ -258,6 +285,7 @@ static int usart_hal_deinit(usart_num_t usart_num) {
 #if (CONFIG_USART_RX_DMA == 1)
     // Deinitialize USART DMA RX
     if (obj->dev->dma_rx != NULL) {
+        dma_hal_release(obj->dev->dma_rx);
         HAL_DMA_DeInit(obj->dev->dma_rx->handle);
     }
 #endif /* (CONFIG_USART_RX_DMA == 1) */
@@ -297,7 +325,7 @@ static int usart_hal_deinit(usart_num_t usart_num) {
  * 
  * @param usart_num USART port number
  */
-static void usart_hal_start(usart_num_t usart_num) {
+OMNI_DRIVER_API void usart_hal_start(usart_num_t usart_num) {
     omni_assert(usart_num < USART_NUM_MAX);
 
     usart_obj_t *obj = &usart_obj[usart_num];
@@ -314,7 +342,7 @@ static void usart_hal_start(usart_num_t usart_num) {
  * 
  * @param usart_num USART port number
  */
-static void usart_hal_stop(usart_num_t usart_num) {
+OMNI_DRIVER_API void usart_hal_stop(usart_num_t usart_num) {
     omni_assert(usart_num < USART_NUM_MAX);
 
     usart_obj_t *obj = &usart_obj[usart_num];
@@ -335,7 +363,7 @@ static void usart_hal_stop(usart_num_t usart_num) {
  * @param timeout Timeout in ms
  * @return Operation status
  */
-static int usart_hal_poll_send(usart_num_t usart_num, const uint8_t *data, uint32_t len, uint32_t timeout) {
+OMNI_DRIVER_API int usart_hal_poll_send(usart_num_t usart_num, const uint8_t *data, uint32_t len, uint32_t timeout) {
     omni_assert(usart_num < USART_NUM_MAX);
     omni_assert_not_null(data);
     omni_assert_non_zero(len);
@@ -361,7 +389,7 @@ static int usart_hal_poll_send(usart_num_t usart_num, const uint8_t *data, uint3
  * @param timeout Timeout in ms
  * @return Operation status
  */
-static int usart_hal_poll_receive(usart_num_t usart_num, void *data, uint32_t len, uint32_t timeout) {
+OMNI_DRIVER_API int usart_hal_poll_receive(usart_num_t usart_num, void *data, uint32_t len, uint32_t timeout) {
     omni_assert(usart_num < USART_NUM_MAX);
     omni_assert_not_null(data);
     omni_assert_non_zero(len);
@@ -386,7 +414,7 @@ static int usart_hal_poll_receive(usart_num_t usart_num, void *data, uint32_t le
  * @param len Length of data buffer
  * @return Operation status
  */
-static int usart_hal_send(usart_num_t usart_num, const uint8_t *data, uint32_t len) {
+OMNI_DRIVER_API int usart_hal_send(usart_num_t usart_num, const uint8_t *data, uint32_t len) {
     omni_assert(usart_num < USART_NUM_MAX);
     omni_assert_not_null(data);
     omni_assert_non_zero(len);
@@ -406,6 +434,7 @@ static int usart_hal_send(usart_num_t usart_num, const uint8_t *data, uint32_t l
     obj->data.tx_count = 0;
 
     obj->status.tx_busy = 1;
+    TRACE_RECORD(TRACE_EVENT_DRV_START, TRACE_DRV_USART | usart_num, len);
 
 #if (CONFIG_USART_TX_DMA == 1)
     handle->hdmatx->XferCpltCallback = usart_tx_dma_event_callback;
@@ -436,7 +465,7 @@ static int usart_hal_send(usart_num_t usart_num, const uint8_t *data, uint32_t l
  * @param len Length of data buffer
  * @return Operation status
  */
-static int usart_hal_receive(usart_num_t usart_num, void *data, uint32_t len) {
+OMNI_DRIVER_API int usart_hal_receive(usart_num_t usart_num, void *data, uint32_t len) {
     omni_assert(usart_num < USART_NUM_MAX);
     omni_assert_not_null(data);
     omni_assert_non_zero(len);
@@ -462,6 +491,7 @@ static int usart_hal_receive(usart_num_t usart_num, void *data, uint32_t len) {
     obj->error = (usart_driver_error_t){0};
 
     obj->status.rx_busy = 1;
+    TRACE_RECORD(TRACE_EVENT_DRV_START, TRACE_DRV_USART_RX | usart_num, len);
 
 #if (CONFIG_USART_RX_DMA == 1)
     handle->hdmarx->XferCpltCallback = usart_rx_dma_event_callback;
@@ -490,13 +520,182 @@ static int usart_hal_receive(usart_num_t usart_num, void *data, uint32_t len) {
     return OMNI_OK;
 }
 
+/**
+ * @brief Send a continuous stream from two buffers
+ *
+ * @note Needs the TX DMA on a stream with double buffer mode (STM32F4).
+ *       The DMA sends buffer0 then buffer1 and back without a gap, cb is
+ *       called with the buffer just sent so it can be refilled while the
+ *       other one goes out. Runs until stream_stop.
+ * @param usart_num USART port number
+ * @param buffer0 Pointer to first buffer
+ * @param buffer1 Pointer to second buffer
+ * @param len Length of each buffer
+ * @param cb Stream callback
+ * @return Operation status
+ */
+OMNI_DRIVER_API int usart_hal_stream_send(usart_num_t usart_num, void *buffer0, void *buffer1, uint32_t len, usart_stream_callback cb) {
+    omni_assert(usart_num < USART_NUM_MAX);
+    omni_assert_not_null(buffer0);
+    omni_assert_not_null(buffer1);
+    omni_assert_non_zero(len);
+    omni_assert_not_null(cb);
+
+    usart_obj_t *obj = &usart_obj[usart_num];
+    omni_assert_not_null(obj);
+
+#if (CONFIG_USART_TX_DMA == 1)
+    UART_HandleTypeDef *handle = obj->dev->handle;
+
+    if (obj->dev->dma_tx == NULL) {
+        return OMNI_FAIL;
+    }
+
+    if (obj->status.tx_busy) {
+        return OMNI_BUSY;
+    }
+
+    obj->data.tx_num = len;
+    obj->data.tx_count = 0;
+    obj->tx_stream_cb = cb;
+
+    obj->status.tx_busy = 1;
+
+    if (dma_hal_double_start(handle->hdmatx, DMA_HAL_DIR_TX, &handle->Instance->DR, buffer0, buffer1,
+                             len, usart_hal_get_bytes(handle, len),
+                             usart_tx_stream_callback, usart_stream_error_callback) != OMNI_OK) {
+        obj->tx_stream_cb = NULL;
+        obj->status.tx_busy = 0;
+        return OMNI_FAIL;
+    }
+
+    TRACE_RECORD(TRACE_EVENT_DRV_START, TRACE_DRV_USART | usart_num, len);
+
+    __HAL_UART_CLEAR_FLAG(handle, UART_FLAG_TC);
+
+    /* Enable the DMA transfer for transmit request by setting the DMAT bit
+       in the UART CR3 register */
+    ATOMIC_SET_BIT(handle->Instance->CR3, USART_CR3_DMAT);
+
+    return OMNI_OK;
+#else
+    (void)obj;
+    return OMNI_FAIL;
+#endif /* (CONFIG_USART_TX_DMA == 1) */
+}
+
+/**
+ * @brief Receive a continuous stream into two buffers
+ *
+ * @note Needs the RX DMA on a stream with double buffer mode (STM32F4).
+ *       The DMA fills buffer0 then buffer1 and back without a gap, cb is
+ *       called with each full buffer while the other one is being filled.
+ *       Runs until stream_stop.
+ * @param usart_num USART port number
+ * @param buffer0 Pointer to first buffer
+ * @param buffer1 Pointer to second buffer
+ * @param len Length of each buffer
+ * @param cb Stream callback
+ * @return Operation status
+ */
+OMNI_DRIVER_API int usart_hal_stream_receive(usart_num_t usart_num, void *buffer0, void *buffer1, uint32_t len, usart_stream_callback cb) {
+    omni_assert(usart_num < USART_NUM_MAX);
+    omni_assert_not_null(buffer0);
+    omni_assert_not_null(buffer1);
+    omni_assert_non_zero(len);
+    omni_assert_not_null(cb);
+
+    usart_obj_t *obj = &usart_obj[usart_num];
+    omni_assert_not_null(obj);
+
+#if (CONFIG_USART_RX_DMA == 1)
+    UART_HandleTypeDef *handle = obj->dev->handle;
+
+    if (obj->dev->dma_rx == NULL) {
+        return OMNI_FAIL;
+    }
+
+    if (obj->status.rx_busy) {
+        return OMNI_BUSY;
+    }
+
+    obj->data.rx_num = len;
+    obj->data.rx_count = 0;
+    obj->rx_stream_cb = cb;
+
+    // Clear error
+    obj->error = (usart_driver_error_t){0};
+
+    obj->status.rx_busy = 1;
+
+    if (dma_hal_double_start(handle->hdmarx, DMA_HAL_DIR_RX, &handle->Instance->DR, buffer0, buffer1,
+                             len, usart_hal_get_bytes(handle, len),
+                             usart_rx_stream_callback, usart_stream_error_callback) != OMNI_OK) {
+        obj->rx_stream_cb = NULL;
+        obj->status.rx_busy = 0;
+        return OMNI_FAIL;
+    }
+
+    TRACE_RECORD(TRACE_EVENT_DRV_START, TRACE_DRV_USART_RX | usart_num, len);
+
+    // Disable RXNE interrupt
+    ATOMIC_CLEAR_BIT(handle->Instance->CR1, USART_CR1_RXNEIE);
+
+    /* Clear the Overrun flag just before enabling the DMA Rx request */
+    __HAL_UART_CLEAR_OREFLAG(handle);
+
+    /* Enable the DMA transfer for the receiver request by setting the DMAR bit
+    in the UART CR3 register */
+    ATOMIC_SET_BIT(handle->Instance->CR3, USART_CR3_DMAR);
+
+    return OMNI_OK;
+#else
+    (void)obj;
+    return OMNI_FAIL;
+#endif /* (CONFIG_USART_RX_DMA == 1) */
+}
+
+/**
+ * @brief Stop the send and receive streams
+ *
+ * @param usart_num USART port number
+ */
+OMNI_DRIVER_API void usart_hal_stream_stop(usart_num_t usart_num) {
+    omni_assert(usart_num < USART_NUM_MAX);
+
+    usart_obj_t *obj = &usart_obj[usart_num];
+    omni_assert_not_null(obj);
+
+#if (CONFIG_USART_TX_DMA == 1)
+    if (obj->tx_stream_cb != NULL) {
+        ATOMIC_CLEAR_BIT(obj->dev->handle->Instance->CR3, USART_CR3_DMAT);
+        dma_hal_double_stop(obj->dev->handle->hdmatx);
+
+        obj->tx_stream_cb = NULL;
+        obj->status.tx_busy = 0;
+    }
+#endif /* (CONFIG_USART_TX_DMA == 1) */
+
+#if (CONFIG_USART_RX_DMA == 1)
+    if (obj->rx_stream_cb != NULL) {
+        ATOMIC_CLEAR_BIT(obj->dev->handle->Instance->CR3, USART_CR3_DMAR);
+        dma_hal_double_stop(obj->dev->handle->hdmarx);
+
+        obj->rx_stream_cb = NULL;
+        obj->status.rx_busy = 0;
+    }
+#endif /* (CONFIG_USART_RX_DMA == 1) */
+
+    (void)obj;
+}
+
 /**
  * @brief Get USART port status
  * 
  * @param usart_num USART port number
  * @return USART driver status
  */
-static usart_driver_status_t usart_hal_get_status(usart_num_t usart_num) {
+OMNI_DRIVER_API usart_driver_status_t usart_hal_get_status(usart_num_t usart_num) {
     omni_assert(usart_num < USART_NUM_MAX);
 
     usart_obj_t *obj = &usart_obj[usart_num];
@@ -511,7 +710,7 @@ static usart_driver_status_t usart_hal_get_status(usart_num_t usart_num) {
  * @param usart_num USART port number
  * @return USART driver error
  */
-static usart_driver_error_t usart_hal_get_error(usart_num_t usart_num) {
+OMNI_DRIVER_API usart_driver_error_t usart_hal_get_error(usart_num_t usart_num) {
     omni_assert(usart_num < USART_NUM_MAX);
 
     usart_obj_t *obj = &usart_obj[usart_num];
@@ -524,7 +723,7 @@ static usart_driver_error_t usart_hal_get_error(usart_num_t usart_num) {
 /**
  * @brief USART IRQ handler
  */
-static void usart_hal_irq_request(usart_obj_t *obj) {
+static OMNI_FAST_ISR void usart_hal_irq_request(usart_obj_t *obj) {
     uint32_t event = 0;
     uint16_t data = 0;
     omni_assert_not_null(obj);
@@ -654,6 +853,18 @@ static void usart_hal_irq_request(usart_obj_t *obj) {
         __HAL_UART_CLEAR_PEFLAG(handle);
     }
 
+#if defined(CONFIG_COMPONENT_TRACE)
+    if (event & USART_EVENT_TX_COMPLETE) {
+        TRACE_RECORD(TRACE_EVENT_DRV_COMPLETE, TRACE_DRV_USART | (uint32_t)(obj - usart_obj), 0);
+    }
+    if (event & USART_EVENT_RECEIVE_COMPLETE) {
+        TRACE_RECORD(TRACE_EVENT_DRV_COMPLETE, TRACE_DRV_USART_RX | (uint32_t)(obj - usart_obj), 0);
+    }
+    if (event & (USART_EVENT_RX_OVERFLOW | USART_EVENT_RX_FRAMING_ERROR | USART_EVENT_RX_PARITY_ERROR)) {
+        TRACE_RECORD(TRACE_EVENT_DRV_ERROR, TRACE_DRV_USART_RX | (uint32_t)(obj - usart_obj), event);
+    }
+#endif /* CONFIG_COMPONENT_TRACE */
+
     // Send event
     if ((obj->event_cb != NULL) && (event != 0)) {
         obj->event_cb(event);
@@ -664,7 +875,7 @@ static void usart_hal_irq_request(usart_obj_t *obj) {
 /**
  * @brief USART1 IRQ handler
  */
-static void usart1_irq_handler(void) {
+static OMNI_FAST_ISR void usart1_irq_handler(void) {
     usart_hal_irq_request(&usart_obj[USART_NUM_1]);
 }
 #endif /* CONFIG_USART_NUM_1 */
@@ -673,7 +884,7 @@ static void usart1_irq_handler(void) {
 /**
  * @brief USART2 IRQ handler
  */
-static void usart2_irq_handler(void) {
+static OMNI_FAST_ISR void usart2_irq_handler(void) {
     usart_hal_irq_request(&usart_obj[USART_NUM_2]);
 }
 #endif /* CONFIG_USART_NUM_2 */
@@ -682,7 +893,7 @@ static void usart2_irq_handler(void) {
 /**
  * @brief USART3 IRQ handler
  */
-static void usart3_irq_handler(void) {
+static OMNI_FAST_ISR void usart3_irq_handler(void) {
     usart_hal_irq_request(&usart_obj[USART_NUM_3]);
 }
 #endif /* CONFIG_USART_NUM_3 */
@@ -691,7 +902,7 @@ static void usart3_irq_handler(void) {
 /**
  * @brief USART4 IRQ handler
  */
-static void usart4_irq_handler(void) {
+static OMNI_FAST_ISR void usart4_irq_handler(void) {
     usart_hal_irq_request(&usart_obj[USART_NUM_4]);
 }
 #endif /* CONFIG_USART_NUM_4 */
@@ -700,7 +911,7 @@ static void usart4_irq_handler(void) {
 /**
  * @brief USART5 IRQ handler
  */
-static void usart5_irq_handler(void) {
+static OMNI_FAST_ISR void usart5_irq_handler(void) {
     usart_hal_irq_request(&usart_obj[USART_NUM_5]);
 }
 #endif /* CONFIG_USART_NUM_5 */
@@ -709,7 +920,7 @@ static void usart5_irq_handler(void) {
 /**
  * @brief USART6 IRQ handler
  */
-static void usart6_irq_handler(void) {
+static OMNI_FAST_ISR void usart6_irq_handler(void) {
     usart_hal_irq_request(&usart_obj[USART_NUM_6]);
 }
 #endif /* CONFIG_USART_NUM_6 */
@@ -718,7 +929,7 @@ static void usart6_irq_handler(void) {
 /**
  * @brief USART7 IRQ handler
  */
-static void usart7_irq_handler(void) {
+static OMNI_FAST_ISR void usart7_irq_handler(void) {
     usart_hal_irq_request(&usart_obj[USART_NUM_7]);
 }
 #endif /* CONFIG_USART_NUM_7 */
@@ -727,7 +938,7 @@ static void usart7_irq_handler(void) {
 /**
  * @brief USART8 IRQ handler
  */
-static void usart8_irq_handler(void) {
+static OMNI_FAST_ISR void usart8_irq_handler(void) {
     usart_hal_irq_request(&usart_obj[USART_NUM_8]);
 }
 #endif /* CONFIG_USART_NUM_8 */
@@ -736,7 +947,7 @@ static void usart8_irq_handler(void) {
 /**
  * @brief USART9 IRQ handler
  */
-static void usart9_irq_handler(void) {
+static OMNI_FAST_ISR void usart9_irq_handler(void) {
     usart_hal_irq_request(&usart_obj[USART_NUM_9]);
 }
 #endif /* CONFIG_USART_NUM_9 */
@@ -745,59 +956,59 @@ static void usart9_irq_handler(void) {
 /**
  * @brief USART10 IRQ handler
  */
-static void usart10_irq_handler(void) {
+static OMNI_FAST_ISR void usart10_irq_handler(void) {
     usart_hal_irq_request(&usart_obj[USART_NUM_10]);
 }
 #endif /* CONFIG_USART_NUM_10 */
 
 #if (CONFIG_USART_TX_DMA == 1)
 #if (CONFIG_USART1_TX_DMA == 1)
-void usart1_tx_dma_irq_handler(void) {
+OMNI_FAST_ISR void usart1_tx_dma_irq_handler(void) {
     HAL_DMA_IRQHandler(usart_obj[USART_NUM_1].dev->dma_tx->handle);
 }
 #endif /* (CONFIG_USART1_TX_DMA == 1) */
 #if (CONFIG_USART2_TX_DMA == 1)
-void usart2_tx_dma_irq_handler(void) {
+OMNI_FAST_ISR void usart2_tx_dma_irq_handler(void) {
     HAL_DMA_IRQHandler(usart_obj[USART_NUM_2].dev->dma_tx->handle);
 }
 #endif /* (CONFIG_USART2_TX_DMA == 1) */
 #if (CONFIG_USART3_TX_DMA == 1)
-void usart3_tx_dma_irq_handler(void) {
+OMNI_FAST_ISR void usart3_tx_dma_irq_handler(void) {
     HAL_DMA_IRQHandler(usart_obj[USART_NUM_3].dev->dma_tx->handle);
 }
 #endif /* (CONFIG_USART3_TX_DMA == 1) */
 #if (CONFIG_USART4_TX_DMA == 1)
-void usart4_tx_dma_irq_handler(void) {
+OMNI_FAST_ISR void usart4_tx_dma_irq_handler(void) {
     HAL_DMA_IRQHandler(usart_obj[USART_NUM_4].dev->dma_tx->handle);
 }
 #endif /* (CONFIG_USART4_TX_DMA == 1) */
 #if (CONFIG_USART5_TX_DMA == 1)
-void usart5_tx_dma_irq_handler(void) {
+OMNI_FAST_ISR void usart5_tx_dma_irq_handler(void) {
     HAL_DMA_IRQHandler(usart_obj[USART_NUM_5].dev->dma_tx->handle);
 }
 #endif /* (CONFIG_USART5_TX_DMA == 1) */
 #if (CONFIG_USART6_TX_DMA == 1)
-void usart6_tx_dma_irq_handler(void) {
+OMNI_FAST_ISR void usart6_tx_dma_irq_handler(void) {
     HAL_DMA_IRQHandler(usart_obj[USART_NUM_6].dev->dma_tx->handle);
 }
 #endif /* (CONFIG_USART6_TX_DMA == 1) */
 #if (CONFIG_USART7_TX_DMA == 1)
-void usart7_tx_dma_irq_handler(void) {
+OMNI_FAST_ISR void usart7_tx_dma_irq_handler(void) {
     HAL_DMA_IRQHandler(usart_obj[USART_NUM_7].dev->dma_tx->handle);
 }
 #endif /* (CONFIG_USART7_TX_DMA == 1) */
 #if (CONFIG_USART8_TX_DMA == 1)
-void usart8_tx_dma_irq_handler(void) {
+OMNI_FAST_ISR void usart8_tx_dma_irq_handler(void) {
     HAL_DMA_IRQHandler(usart_obj[USART_NUM_8].dev->dma_tx->handle);
 }
 #endif /* (CONFIG_USART8_TX_DMA == 1) */
 #if (CONFIG_USART9_TX_DMA == 1)
-void usart9_tx_dma_irq_handler(void) {
+OMNI_FAST_ISR void usart9_tx_dma_irq_handler(void) {
     HAL_DMA_IRQHandler(usart_obj[USART_NUM_9].dev->dma_tx->handle);
 }
 #endif /* (CONFIG_USART9_TX_DMA == 1) */
 #if (CONFIG_USART10_TX_DMA == 1)
-void usart10_tx_dma_irq_handler(void) {
+OMNI_FAST_ISR void usart10_tx_dma_irq_handler(void) {
     HAL_DMA_IRQHandler(usart_obj[USART_NUM_10].dev->dma_tx->handle);
 }
 #endif /* (CONFIG_USART10_TX_DMA == 1) */
@@ -805,52 +1016,52 @@ void usart10_tx_dma_irq_handler(void) {
 
 #if (CONFIG_USART_RX_DMA == 1)
 #if (CONFIG_USART1_RX_DMA == 1)
-void usart1_rx_dma_irq_handler(void) {
+OMNI_FAST_ISR void usart1_rx_dma_irq_handler(void) {
     HAL_DMA_IRQHandler(usart_obj[USART_NUM_1].dev->dma_rx->handle);
 }
 #endif /* (CONFIG_USART1_RX_DMA == 1) */
 #if (CONFIG_USART2_RX_DMA == 1)
-void usart2_rx_dma_irq_handler(void) {
+OMNI_FAST_ISR void usart2_rx_dma_irq_handler(void) {
     HAL_DMA_IRQHandler(usart_obj[USART_NUM_2].dev->dma_rx->handle);
 }
 #endif /* (CONFIG_USART2_RX_DMA == 1) */
 #if (CONFIG_USART3_RX_DMA == 1)
-void usart3_rx_dma_irq_handler(void) {
+OMNI_FAST_ISR void usart3_rx_dma_irq_handler(void) {
     HAL_DMA_IRQHandler(usart_obj[USART_NUM_3].dev->dma_rx->handle);
 }
 #endif /* (CONFIG_USART3_RX_DMA == 1) */
 #if (CONFIG_USART4_RX_DMA == 1)
-void usart4_rx_dma_irq_handler(void) {
+OMNI_FAST_ISR void usart4_rx_dma_irq_handler(void) {
     HAL_DMA_IRQHandler(usart_obj[USART_NUM_4].dev->dma_rx->handle);
 }
 #endif /* (CONFIG_USART4_RX_DMA == 1) */
 #if (CONFIG_USART5_RX_DMA == 1)
-void usart5_rx_dma_irq_handler(void) {
+OMNI_FAST_ISR void usart5_rx_dma_irq_handler(void) {
     HAL_DMA_IRQHandler(usart_obj[USART_NUM_5].dev->dma_rx->handle);
 }
 #endif /* (CONFIG_USART5_RX_DMA == 1) */
 #if (CONFIG_USART6_RX_DMA == 1)
-void usart6_rx_dma_irq_handler(void) {
+OMNI_FAST_ISR void usart6_rx_dma_irq_handler(void) {
     HAL_DMA_IRQHandler(usart_obj[USART_NUM_6].dev->dma_rx->handle);
 }
 #endif /* (CONFIG_USART6_RX_DMA == 1) */
 #if (CONFIG_USART7_RX_DMA == 1)
-void usart7_rx_dma_irq_handler(void) {
+OMNI_FAST_ISR void usart7_rx_dma_irq_handler(void) {
     HAL_DMA_IRQHandler(usart_obj[USART_NUM_7].dev->dma_rx->handle);
 }
 #endif /* (CONFIG_USART7_RX_DMA == 1) */
 #if (CONFIG_USART8_RX_DMA == 1)
-void usart8_rx_dma_irq_handler(void) {
+OMNI_FAST_ISR void usart8_rx_dma_irq_handler(void) {
     HAL_DMA_IRQHandler(usart_obj[USART_NUM_8].dev->dma_rx->handle);
 }
 #endif /* (CONFIG_USART8_RX_DMA == 1) */
 #if (CONFIG_USART9_RX_DMA == 1)
-void usart9_rx_dma_irq_handler(void) {
+OMNI_FAST_ISR void usart9_rx_dma_irq_handler(void) {
     HAL_DMA_IRQHandler(usart_obj[USART_NUM_9].dev->dma_rx->handle);
 }
 #endif /* (CONFIG_USART9_RX_DMA == 1) */
 #if (CONFIG_USART10_RX_DMA == 1)
-void usart10_rx_dma_irq_handler(void) {
+OMNI_FAST_ISR void usart10_rx_dma_irq_handler(void) {
     HAL_DMA_IRQHandler(usart_obj[USART_NUM_10].dev->dma_rx->handle);
 }
 #endif /* (CONFIG_USART10_RX_DMA == 1) */
@@ -1030,6 +1241,7 @@ static void usart_rx_dma_event_callback(DMA_HandleTypeDef *hdma) {
         ATOMIC_CLEAR_BIT(huart->Instance->CR1, USART_CR1_IDLEIE);
 
         obj->status.rx_busy = 0;
+        TRACE_RECORD(TRACE_EVENT_DRV_COMPLETE, TRACE_DRV_USART_RX | (uint32_t)(obj - usart_obj), 0);
 
         // Enable RXNE interrupt
         ATOMIC_SET_BIT(huart->Instance->CR1, USART_CR1_RXNEIE);
@@ -1040,6 +1252,63 @@ static void usart_rx_dma_event_callback(DMA_HandleTypeDef *hdma) {
     }
 }
 
+#if ((CONFIG_USART_TX_DMA == 1) || (CONFIG_USART_RX_DMA == 1))
+static void usart_tx_stream_callback(DMA_HandleTypeDef *hdma) {
+    UART_HandleTypeDef *huart = (UART_HandleTypeDef *)hdma->Parent;
+    usart_obj_t *obj = usart_hal_get_obj(huart);
+    omni_assert_not_null(obj);
+
+    uint32_t len = usart_hal_get_bytes(huart, obj->data.tx_num);
+    void *buffer = dma_hal_double_done(hdma, DMA_HAL_DIR_TX, len);
+
+    if (obj->tx_stream_cb != NULL) {
+        obj->tx_stream_cb(buffer);
+    }
+
+    dma_hal_double_refill(buffer, len);
+}
+
+static void usart_rx_stream_callback(DMA_HandleTypeDef *hdma) {
+    UART_HandleTypeDef *huart = (UART_HandleTypeDef *)hdma->Parent;
+    usart_obj_t *obj = usart_hal_get_obj(huart);
+    omni_assert_not_null(obj);
+
+    void *buffer = dma_hal_double_done(hdma, DMA_HAL_DIR_RX, usart_hal_get_bytes(huart, obj->data.rx_num));
+
+    if (obj->rx_stream_cb != NULL) {
+        obj->rx_stream_cb(buffer);
+    }
+}
+
+static void usart_stream_error_callback(DMA_HandleTypeDef *hdma) {
+    UART_HandleTypeDef *huart = (UART_HandleTypeDef *)hdma->Parent;
+    usart_obj_t *obj = usart_hal_get_obj(huart);
+    usart_stream_callback cb;
+    omni_assert_not_null(obj);
+
+    // FIFO and direct mode errors do not stop the stream
+    if (HAL_DMA_GetState(hdma) != HAL_DMA_STATE_READY) {
+        return;
+    }
+
+    if (hdma == huart->hdmatx) {
+        ATOMIC_CLEAR_BIT(huart->Instance->CR3, USART_CR3_DMAT);
+        cb = obj->tx_stream_cb;
+        obj->tx_stream_cb = NULL;
+        obj->status.tx_busy = 0;
+    } else {
+        ATOMIC_CLEAR_BIT(huart->Instance->CR3, USART_CR3_DMAR);
+        cb = obj->rx_stream_cb;
+        obj->rx_stream_cb = NULL;
+        obj->status.rx_busy = 0;
+    }
+
+    if (cb != NULL) {
+        cb(NULL);
+    }
+}
+#endif /* ((CONFIG_USART_TX_DMA == 1) || (CONFIG_USART_RX_DMA == 1)) */
+
 /********************* Callback functions **********************/
 void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart) {
     usart_obj_t *obj = usart_hal_get_obj(huart);
@@ -1370,3 +1639,21 @@ static usart_obj_t *usart_hal_get_obj(UART_HandleTypeDef *huart) {
 
     return obj;
 }
+
+#if ((CONFIG_USART_TX_DMA == 1) || (CONFIG_USART_RX_DMA == 1))
+/**
+ * @brief Get number of bytes of a transfer
+ * 
+ * @param handle UART handle
+ * @param len Number of data frames
+ * @return Number of bytes
+ */
+static uint32_t usart_hal_get_bytes(UART_HandleTypeDef *handle, uint32_t len) {
+    // 9-bit frames without parity take a half word
+    if ((handle->Init.WordLength == UART_WORDLENGTH_9B) && (handle->Init.Parity == UART_PARITY_NONE)) {
+        return len * 2U;
+    }
+
+    return len;
+}
+#endif /* ((CONFIG_USART_TX_DMA == 1) || (CONFIG_USART_RX_DMA == 1)) */
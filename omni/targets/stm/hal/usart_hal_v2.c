@@ -25,21 +25,32 @@
 #include "hal/gpio_hal.h"
 #include "hal/dma_hal.h"
 #include "hal/irq_hal.h"
+#include "trace/trace.h"
 #include "ll/usart_ll.h"
 
 static usart_obj_t usart_obj[USART_NUM_MAX];
+#if (CONFIG_USART_TX_DMA == 1)
+static dma_hal_buffer_t usart_dma_tx[USART_NUM_MAX];
+#endif /* (CONFIG_USART_TX_DMA == 1) */
+#if (CONFIG_USART_RX_DMA == 1)
+static dma_hal_buffer_t usart_dma_rx[USART_NUM_MAX];
+#endif /* (CONFIG_USART_RX_DMA == 1) */
 
-static int usart_hal_init(usart_num_t usart_num, usart_driver_config_t *config);
-static int usart_hal_deinit(usart_num_t usart_num);
-static void usart_hal_start(usart_num_t usart_num);
-static void usart_hal_stop(usart_num_t usart_num);
-static int usart_hal_poll_send(usart_num_t usart_num, const uint8_t *data, uint32_t len, uint32_t timeout);
-static int usart_hal_poll_receive(usart_num_t usart_num, void *data, uint32_t len, uint32_t timeout);
-static int usart_hal_send(usart_num_t usart_num, const uint8_t *data, uint32_t len);
-static int usart_hal_receive(usart_num_t usart_num, void *data, uint32_t len);
-static usart_driver_status_t usart_hal_get_status(usart_num_t usart_num);
-static usart_driver_error_t usart_hal_get_error(usart_num_t usart_num);
-
+OMNI_DRIVER_API int usart_hal_init(usart_num_t usart_num, usart_driver_config_t *config);
+OMNI_DRIVER_API int usart_hal_deinit(usart_num_t usart_num);
+OMNI_DRIVER_API void usart_hal_start(usart_num_t usart_num);
+OMNI_DRIVER_API void usart_hal_stop(usart_num_t usart_num);
+OMNI_DRIVER_API int usart_hal_poll_send(usart_num_t usart_num, const uint8_t *data, uint32_t len, uint32_t timeout);
+OMNI_DRIVER_API int usart_hal_poll_receive(usart_num_t usart_num, void *data, uint32_t len, uint32_t timeout);
+OMNI_DRIVER_API int usart_hal_send(usart_num_t usart_num, const uint8_t *data, uint32_t len);
+OMNI_DRIVER_API int usart_hal_receive(usart_num_t usart_num, void *data, uint32_t len);
+OMNI_DRIVER_API int usart_hal_stream_send(usart_num_t usart_num, void *buffer0, void *buffer1, uint32_t len, usart_stream_callback cb);
+OMNI_DRIVER_API int usart_hal_stream_receive(usart_num_t usart_num, void *buffer0, void *buffer1, uint32_t len, usart_stream_callback cb);
+OMNI_DRIVER_API void usart_hal_stream_stop(usart_num_t usart_num);
+OMNI_DRIVER_API usart_driver_status_t usart_hal_get_status(usart_num_t usart_num);
+OMNI_DRIVER_API usart_driver_error_t usart_hal_get_error(usart_num_t usart_num);
+
+#if !defined(CONFIG_OMNI_DRIVER_DIRECT_CALL)
 const struct usart_driver_api usart_driver = {
     .init = usart_hal_init,
     .deinit = usart_hal_deinit,
@@ -49,9 +60,13 @@ const struct usart_driver_api usart_driver = {
     .poll_receive = usart_hal_poll_receive,
     .send = usart_hal_send,
     .receive = usart_hal_receive,
+    .stream_send = usart_hal_stream_send,
+    .stream_receive = usart_hal_stream_receive,
+    .stream_stop = usart_hal_stream_stop,
     .get_status = usart_hal_get_status,
     .get_error = usart_hal_get_error,
 };
+#endif /* CONFIG_OMNI_DRIVER_DIRECT_CALL */
 
 static void usart_hal_irq_register(void);
 static void usart_hal_irq_request(usart_obj_t *obj);
@@ -60,6 +75,12 @@ static void usart_hal_reset_gpio(usart_dev_t *dev);
 static void usart_hal_enable_clock(usart_num_t usart_num);
 static void usart_hal_reset_clock(usart_num_t usart_num);
 static usart_obj_t *usart_hal_get_obj(UART_HandleTypeDef *huart);
+#if ((CONFIG_USART_TX_DMA == 1) || (CONFIG_USART_RX_DMA == 1))
+static uint32_t usart_hal_get_bytes(UART_HandleTypeDef *handle, uint32_t len);
+static void usart_tx_stream_callback(DMA_HandleTypeDef *hdma);
+static void usart_rx_stream_callback(DMA_HandleTypeDef *hdma);
+static void usart_stream_error_callback(DMA_HandleTypeDef *hdma);
+#endif /* ((CONFIG_USART_TX_DMA == 1) || (CONFIG_USART_RX_DMA == 1)) */
 
 /**
  * @brief Open the USART port
@@ -68,7 +89,7 @@ static usart_obj_t *usart_hal_get_obj(UART_HandleTypeDef *huart);
  * @param config Pointer to driver configuration structure
  * @return Operation status
  */
-static int usart_hal_init(usart_num_t usart_num, usart_driver_config_t *config) {
+OMNI_DRIVER_API int usart_hal_init(usart_num_t usart_num, usart_driver_config_t *config) {
     omni_assert(usart_num < USART_NUM_MAX);
     omni_assert_not_null(config);
 
@@ -107,6 +128,10 @@ static int usart_hal_init(usart_num_t usart_num, usart_driver_config_t *config)
 #if (CONFIG_USART_TX_DMA == 1)
     // Configure USART DMA TX
     if (obj->dev->dma_tx != NULL) {
+        if (dma_hal_claim(obj->dev->dma_tx, obj->dev->handle->Instance, DMA_HAL_DIR_TX) != OMNI_OK) {
+            return OMNI_FAIL;
+        }
+
         dma_hal_enable_clock(obj->dev->dma_tx->ins);
 
         if (HAL_DMA_Init(obj->dev->dma_tx->handle) != HAL_OK) {
@@ -125,6 +150,10 @@ static int usart_hal_init(usart_num_t usart_num, usart_driver_config_t *config)
 #if (CONFIG_USART_RX_DMA == 1)
      // Configure USART DMA RX
     if (obj->dev->dma_rx != NULL) {
+        if (dma_hal_claim(obj->dev->dma_rx, obj->dev->handle->Instance, DMA_HAL_DIR_RX) != OMNI_OK) {
+            return OMNI_FAIL;
+        }
+
         dma_hal_enable_clock(obj->dev->dma_rx->ins);
 
         if (HAL_DMA_Init(obj->dev->dma_rx->handle) != HAL_OK) {
@@ -233,12 +262,15 @@ static int usart_hal_init(usart_num_t usart_num, usart_driver_config_t *config)
  * @param usart_num USART port number
  * @return Operation status
  */
-static int usart_hal_deinit(usart_num_t usart_num) {
+OMNI_DRIVER_API int usart_hal_deinit(usart_num_t usart_num) {
     omni_assert(usart_num < USART_NUM_MAX);
 
     usart_obj_t *obj = &usart_obj[usart_num];
     omni_assert_not_null(obj);
 
+    // A streaming DMA cannot be deinitialized
+    usart_hal_stream_stop(usart_num);
+
     // Reset USART clock
     usart_hal_reset_clock(usart_num);
 
@@ -248,6 +280,7 @@ static int usart_hal_deinit(usart_num_t usart_num) {
 #if (CONFIG_USART_TX_DMA == 1)
     // Deinitialize USART DMA TX
     if (obj->dev->dma_tx != NULL) {
+        dma_hal_release(obj->dev->dma_tx);
         HAL_DMA_DeInit(obj->dev->dma_tx->handle);
     }
 #endif /* (CONFIG_USART_TX_DMA == 1) */
@@ -255,10 +288,19 @@ static int usart_hal_deinit(usart_num_t usart_num) {
 #if (CONFIG_USART_RX_DMA == 1)
     // Deinitialize USART DMA RX
     if (obj->dev->dma_rx != NULL) {
+        dma_hal_release(obj->dev->dma_rx);
         HAL_DMA_DeInit(obj->dev->dma_rx->handle);
     }
 #endif /* (CONFIG_USART_RX_DMA == 1) */
 
+    // Release bounce buffers of aborted transfers
+#if (CONFIG_USART_TX_DMA == 1)
+    dma_hal_abort(&usart_dma_tx[usart_num]);
+#endif /* (CONFIG_USART_TX_DMA == 1) */
+#if (CONFIG_USART_RX_DMA == 1)
+    dma_hal_abort(&usart_dma_rx[usart_num]);
+#endif /* (CONFIG_USART_RX_DMA == 1) */
+
     // Disable USART IRQ
     NVIC_DisableIRQ(obj->dev->irq_num);
 
@@ -294,7 +336,7 @@ static int usart_hal_deinit(usart_num_t usart_num) {
  * 
  * @param usart_num USART port number
  */
-static void usart_hal_start(usart_num_t usart_num) {
+OMNI_DRIVER_API void usart_hal_start(usart_num_t usart_num) {
     omni_assert(usart_num < USART_NUM_MAX);
 
     usart_obj_t *obj = &usart_obj[usart_num];
@@ -311,7 +353,7 @@ static void usart_hal_start(usart_num_t usart_num) {
  * 
  * @param usart_num USART port number
  */
-static void usart_hal_stop(usart_num_t usart_num) {
+OMNI_DRIVER_API void usart_hal_stop(usart_num_t usart_num) {
     omni_assert(usart_num < USART_NUM_MAX);
 
     usart_obj_t *obj = &usart_obj[usart_num];
@@ -332,7 +374,7 @@ static void usart_hal_stop(usart_num_t usart_num) {
  * @param timeout Timeout in ms
  * @return Operation status
  */
-static int usart_hal_poll_send(usart_num_t usart_num, const uint8_t *data, uint32_t len, uint32_t timeout) {
+OMNI_DRIVER_API int usart_hal_poll_send(usart_num_t usart_num, const uint8_t *data, uint32_t len, uint32_t timeout) {
     omni_assert(usart_num < USART_NUM_MAX);
     omni_assert_not_null(data);
     omni_assert_non_zero(len);
@@ -358,7 +400,7 @@ static int usart_hal_poll_send(usart_num_t usart_num, const uint8_t *data, uint3
  * @param timeout Timeout in ms
  * @return Operation status
  */
-static int usart_hal_poll_receive(usart_num_t usart_num, void *data, uint32_t len, uint32_t timeout) {
+OMNI_DRIVER_API int usart_hal_poll_receive(usart_num_t usart_num, void *data, uint32_t len, uint32_t timeout) {
     omni_assert(usart_num < USART_NUM_MAX);
     omni_assert_not_null(data);
     omni_assert_non_zero(len);
@@ -383,7 +425,7 @@ static int usart_hal_poll_receive(usart_num_t usart_num, void *data, uint32_t le
  * @param len Length of data buffer
  * @return Operation status
  */
-static int usart_hal_send(usart_num_t usart_num, const uint8_t *data, uint32_t len) {
+OMNI_DRIVER_API int usart_hal_send(usart_num_t usart_num, const uint8_t *data, uint32_t len) {
     omni_assert(usart_num < USART_NUM_MAX);
     omni_assert_not_null(data);
     omni_assert_non_zero(len);
@@ -398,9 +440,16 @@ static int usart_hal_send(usart_num_t usart_num, const uint8_t *data, uint32_t l
     }
 
     obj->status.tx_busy = 1;
+    TRACE_RECORD(TRACE_EVENT_DRV_START, TRACE_DRV_USART | usart_num, len);
 
 #if (CONFIG_USART_TX_DMA == 1)
-    HAL_UART_Transmit_DMA(handle, (const uint8_t *)data, (uint16_t)len);
+    const void *tx_dma = dma_hal_tx_prepare(&usart_dma_tx[usart_num], data, usart_hal_get_bytes(handle, len));
+    if (tx_dma == NULL) {
+        obj->status.tx_busy = 0;
+        return OMNI_FAIL;
+    }
+
+    HAL_UART_Transmit_DMA(handle, (const uint8_t *)tx_dma, (uint16_t)len);
 #else
     HAL_UART_Transmit_IT(handle, (const uint8_t *)data, (uint16_t)len);
 #endif /* (CONFIG_USART_TX_DMA == 1) */
@@ -416,7 +465,7 @@ static int usart_hal_send(usart_num_t usart_num, const uint8_t *data, uint32_t l
  * @param len Length of data buffer
  * @return Operation status
  */
-static int usart_hal_receive(usart_num_t usart_num, void *data, uint32_t len) {
+OMNI_DRIVER_API int usart_hal_receive(usart_num_t usart_num, void *data, uint32_t len) {
     omni_assert(usart_num < USART_NUM_MAX);
     omni_assert_not_null(data);
     omni_assert_non_zero(len);
@@ -434,9 +483,16 @@ static int usart_hal_receive(usart_num_t usart_num, void *data, uint32_t len) {
     obj->error = (usart_driver_error_t){0};
 
     obj->status.rx_busy = 1;
+    TRACE_RECORD(TRACE_EVENT_DRV_START, TRACE_DRV_USART_RX | usart_num, len);
 
 #if (CONFIG_USART_RX_DMA == 1)
-    HAL_UART_Receive_DMA(handle, (uint8_t *)data, (uint16_t)len);
+    void *rx_dma = dma_hal_rx_prepare(&usart_dma_rx[usart_num], data, usart_hal_get_bytes(handle, len));
+    if (rx_dma == NULL) {
+        obj->status.rx_busy = 0;
+        return OMNI_FAIL;
+    }
+
+    HAL_UART_Receive_DMA(handle, (uint8_t *)rx_dma, (uint16_t)len);
 #else
     HAL_UART_Receive_IT(handle, (uint8_t *)data, (uint16_t)len);
 #endif /* (CONFIG_USART_RX_DMA == 1) */
@@ -444,13 +500,183 @@ static int usart_hal_receive(usart_num_t usart_num, void *data, uint32_t len) {
     return OMNI_OK;
 }
 
+/**
+ * @brief Send a continuous stream from two buffers
+ *
+ * @note Needs the TX DMA on a stream with double buffer mode (DMA1 and DMA2).
+ *       The DMA sends buffer0 then buffer1 and back without a gap, cb is
+ *       called with the buffer just sent so it can be refilled while the
+ *       other one goes out. Runs until stream_stop. With the data cache
+ *       enabled the buffers must be aligned to cache lines, unless they
+ *       are in the non-cacheable region.
+ * @param usart_num USART port number
+ * @param buffer0 Pointer to first buffer
+ * @param buffer1 Pointer to second buffer
+ * @param len Length of each buffer
+ * @param cb Stream callback
+ * @return Operation status
+ */
+OMNI_DRIVER_API int usart_hal_stream_send(usart_num_t usart_num, void *buffer0, void *buffer1, uint32_t len, usart_stream_callback cb) {
+    omni_assert(usart_num < USART_NUM_MAX);
+    omni_assert_not_null(buffer0);
+    omni_assert_not_null(buffer1);
+    omni_assert_non_zero(len);
+    omni_assert_not_null(cb);
+
+    usart_obj_t *obj = &usart_obj[usart_num];
+    omni_assert_not_null(obj);
+
+#if (CONFIG_USART_TX_DMA == 1)
+    UART_HandleTypeDef *handle = obj->dev->handle;
+
+    if (obj->dev->dma_tx == NULL) {
+        return OMNI_FAIL;
+    }
+
+    if (obj->status.tx_busy) {
+        return OMNI_BUSY;
+    }
+
+    obj->data.tx_num = len;
+    obj->data.tx_count = 0;
+    obj->tx_stream_cb = cb;
+
+    obj->status.tx_busy = 1;
+
+    if (dma_hal_double_start(handle->hdmatx, DMA_HAL_DIR_TX, &handle->Instance->TDR, buffer0, buffer1,
+                             len, usart_hal_get_bytes(handle, len),
+                             usart_tx_stream_callback, usart_stream_error_callback) != OMNI_OK) {
+        obj->tx_stream_cb = NULL;
+        obj->status.tx_busy = 0;
+        return OMNI_FAIL;
+    }
+
+    TRACE_RECORD(TRACE_EVENT_DRV_START, TRACE_DRV_USART | usart_num, len);
+
+    __HAL_UART_CLEAR_FLAG(handle, UART_CLEAR_TCF);
+
+    /* Enable the DMA transfer for transmit request by setting the DMAT bit
+       in the UART CR3 register */
+    ATOMIC_SET_BIT(handle->Instance->CR3, USART_CR3_DMAT);
+
+    return OMNI_OK;
+#else
+    (void)obj;
+    return OMNI_FAIL;
+#endif /* (CONFIG_USART_TX_DMA == 1) */
+}
+
+/**
+ * @brief Receive a continuous stream into two buffers
+ *
+ * @note Needs the RX DMA on a stream with double buffer mode (DMA1 and DMA2).
+ *       The DMA fills buffer0 then buffer1 and back without a gap, cb is
+ *       called with each full buffer while the other one is being filled.
+ *       Runs until stream_stop. With the data cache enabled the buffers
+ *       must be aligned to cache lines, unless they are in the
+ *       non-cacheable region.
+ * @param usart_num USART port number
+ * @param buffer0 Pointer to first buffer
+ * @param buffer1 Pointer to second buffer
+ * @param len Length of each buffer
+ * @param cb Stream callback
+ * @return Operation status
+ */
+OMNI_DRIVER_API int usart_hal_stream_receive(usart_num_t usart_num, void *buffer0, void *buffer1, uint32_t len, usart_stream_callback cb) {
+    omni_assert(usart_num < USART_NUM_MAX);
+    omni_assert_not_null(buffer0);
+    omni_assert_not_null(buffer1);
+    omni_assert_non_zero(len);
+    omni_assert_not_null(cb);
+
+    usart_obj_t *obj = &usart_obj[usart_num];
+    omni_assert_not_null(obj);
+
+#if (CONFIG_USART_RX_DMA == 1)
+    UART_HandleTypeDef *handle = obj->dev->handle;
+
+    if (obj->dev->dma_rx == NULL) {
+        return OMNI_FAIL;
+    }
+
+    if (obj->status.rx_busy) {
+        return OMNI_BUSY;
+    }
+
+    obj->data.rx_num = len;
+    obj->data.rx_count = 0;
+    obj->rx_stream_cb = cb;
+
+    // Clear error
+    obj->error = (usart_driver_error_t){0};
+
+    obj->status.rx_busy = 1;
+
+    if (dma_hal_double_start(handle->hdmarx, DMA_HAL_DIR_RX, &handle->Instance->RDR, buffer0, buffer1,
+                             len, usart_hal_get_bytes(handle, len),
+                             usart_rx_stream_callback, usart_stream_error_callback) != OMNI_OK) {
+        obj->rx_stream_cb = NULL;
+        obj->status.rx_busy = 0;
+        return OMNI_FAIL;
+    }
+
+    TRACE_RECORD(TRACE_EVENT_DRV_START, TRACE_DRV_USART_RX | usart_num, len);
+
+    /* Clear the Overrun flag just before enabling the DMA Rx request */
+    __HAL_UART_CLEAR_OREFLAG(handle);
+
+    /* Enable the DMA transfer for the receiver request by setting the DMAR bit
+    in the UART CR3 register */
+    ATOMIC_SET_BIT(handle->Instance->CR3, USART_CR3_DMAR);
+
+    return OMNI_OK;
+#else
+    (void)obj;
+    return OMNI_FAIL;
+#endif /* (CONFIG_USART_RX_DMA == 1) */
+}
+
+/**
+ * @brief Stop the send and receive streams
+ *
+ * @param usart_num USART port number
+ */
+OMNI_DRIVER_API void usart_hal_stream_stop(usart_num_t usart_num) {
+    omni_assert(usart_num < USART_NUM_MAX);
+
+    usart_obj_t *obj = &usart_obj[usart_num];
+    omni_assert_not_null(obj);
+
+#if (CONFIG_USART_TX_DMA == 1)
+    if (obj->tx_stream_cb != NULL) {
+        ATOMIC_CLEAR_BIT(obj->dev->handle->Instance->CR3, USART_CR3_DMAT);
+        dma_hal_double_stop(obj->dev->handle->hdmatx);
+
+        obj->tx_stream_cb = NULL;
+        obj->status.tx_busy = 0;
+    }
+#endif /* (CONFIG_USART_TX_DMA == 1) */
+
+#if (CONFIG_USART_RX_DMA == 1)
+    if (obj->rx_stream_cb != NULL) {
+        ATOMIC_CLEAR_BIT(obj->dev->handle->Instance->CR3, USART_CR3_DMAR);
+        dma_hal_double_stop(obj->dev->handle->hdmarx);
+
+        obj->rx_stream_cb = NULL;
+        obj->status.rx_busy = 0;
+    }
+#endif /* (CONFIG_USART_RX_DMA == 1) */
+
+    (void)obj;
+}
+
 /**
  * @brief Get USART port status
  * 
  * @param usart_num USART port number
  * @return USART driver status
  */
-static usart_driver_status_t usart_hal_get_status(usart_num_t usart_num) {
+OMNI_DRIVER_API usart_driver_status_t usart_hal_get_status(usart_num_t usart_num) {
     omni_assert(usart_num < USART_NUM_MAX);
 
     usart_obj_t *obj = &usart_obj[usart_num];
@@ -465,7 +691,7 @@ static usart_driver_status_t usart_hal_get_status(usart_num_t usart_num) {
  * @param usart_num USART port number
  * @return USART driver error
  */
-static usart_driver_error_t usart_hal_get_error(usart_num_t usart_num) {
+OMNI_DRIVER_API usart_driver_error_t usart_hal_get_error(usart_num_t usart_num) {
     omni_assert(usart_num < USART_NUM_MAX);
 
     usart_obj_t *obj = &usart_obj[usart_num];
@@ -478,7 +704,7 @@ static usart_driver_error_t usart_hal_get_error(usart_num_t usart_num) {
 /**
  * @brief USART IRQ handler
  */
-static void usart_hal_irq_request(usart_obj_t *obj) {
+static OMNI_FAST_ISR void usart_hal_irq_request(usart_obj_t *obj) {
     omni_assert_not_null(obj);
 
     UART_HandleTypeDef *handle = obj->dev->handle;
@@ -490,7 +716,7 @@ static void usart_hal_irq_request(usart_obj_t *obj) {
 /**
  * @brief USART1 IRQ handler
  */
-static void usart1_irq_handler(void) {
+static OMNI_FAST_ISR void usart1_irq_handler(void) {
     usart_hal_irq_request(&usart_obj[USART_NUM_1]);
 }
 #endif /* CONFIG_USART_NUM_1 */
@@ -499,7 +725,7 @@ static void usart1_irq_handler(void) {
 /**
  * @brief USART2 IRQ handler
  */
-static void usart2_irq_handler(void) {
+static OMNI_FAST_ISR void usart2_irq_handler(void) {
     usart_hal_irq_request(&usart_obj[USART_NUM_2]);
 }
 #endif /* CONFIG_USART_NUM_2 */
@@ -508,7 +734,7 @@ static void usart2_irq_handler(void) {
 /**
  * @brief USART3 IRQ handler
  */
-static void usart3_irq_handler(void) {
+static OMNI_FAST_ISR void usart3_irq_handler(void) {
     usart_hal_irq_request(&usart_obj[USART_NUM_3]);
 }
 #endif /* CONFIG_USART_NUM_3 */
@@ -517,7 +743,7 @@ static void usart3_irq_handler(void) {
 /**
  * @brief USART4 IRQ handler
  */
-static void usart4_irq_handler(void) {
+static OMNI_FAST_ISR void usart4_irq_handler(void) {
     usart_hal_irq_request(&usart_obj[USART_NUM_4]);
 }
 #endif /* CONFIG_USART_NUM_4 */
@@ -526,7 +752,7 @@ static void usart4_irq_handler(void) {
 /**
  * @brief USART5 IRQ handler
  */
-static void usart5_irq_handler(void) {
+static OMNI_FAST_ISR void usart5_irq_handler(void) {
     usart_hal_irq_request(&usart_obj[USART_NUM_5]);
 }
 #endif /* CONFIG_USART_NUM_5 */
@@ -535,7 +761,7 @@ static void usart5_irq_handler(void) {
 /**
  * @brief USART6 IRQ handler
  */
-static void usart6_irq_handler(void) {
+static OMNI_FAST_ISR void usart6_irq_handler(void) {
     usart_hal_irq_request(&usart_obj[USART_NUM_6]);
 }
 #endif /* CONFIG_USART_NUM_6 */
@@ -544,7 +770,7 @@ static void usart6_irq_handler(void) {
 /**
  * @brief USART7 IRQ handler
  */
-static void usart7_irq_handler(void) {
+static OMNI_FAST_ISR void usart7_irq_handler(void) {
     usart_hal_irq_request(&usart_obj[USART_NUM_7]);
 }
 #endif /* CONFIG_USART_NUM_7 */
@@ -553,7 +779,7 @@ static void usart7_irq_handler(void) {
 /**
  * @brief USART8 IRQ handler
  */
-static void usart8_irq_handler(void) {
+static OMNI_FAST_ISR void usart8_irq_handler(void) {
     usart_hal_irq_request(&usart_obj[USART_NUM_8]);
 }
 #endif /* CONFIG_USART_NUM_8 */
@@ -562,7 +788,7 @@ static void usart8_irq_handler(void) {
 /**
  * @brief USART9 IRQ handler
  */
-static void usart9_irq_handler(void) {
+static OMNI_FAST_ISR void usart9_irq_handler(void) {
     usart_hal_irq_request(&usart_obj[USART_NUM_9]);
 }
 #endif /* CONFIG_USART_NUM_9 */
@@ -571,59 +797,59 @@ static void usart9_irq_handler(void) {
 /**
  * @brief USART10 IRQ handler
  */
-static void usart10_irq_handler(void) {
+static OMNI_FAST_ISR void usart10_irq_handler(void) {
     usart_hal_irq_request(&usart_obj[USART_NUM_10]);
 }
 #endif /* CONFIG_USART_NUM_10 */
 
 #if (CONFIG_USART_TX_DMA == 1)
 #if (CONFIG_USART1_TX_DMA == 1)
-void usart1_tx_dma_irq_handler(void) {
+OMNI_FAST_ISR void usart1_tx_dma_irq_handler(void) {
     HAL_DMA_IRQHandler(usart_obj[USART_NUM_1].dev->dma_tx->handle);
 }
 #endif /* (CONFIG_USART1_TX_DMA == 1) */
 #if (CONFIG_USART2_TX_DMA == 1)
-void usart2_tx_dma_irq_handler(void) {
+OMNI_FAST_ISR void usart2_tx_dma_irq_handler(void) {
     HAL_DMA_IRQHandler(usart_obj[USART_NUM_2].dev->dma_tx->handle);
 }
 #endif /* (CONFIG_USART2_TX_DMA == 1) */
 #if (CONFIG_USART3_TX_DMA == 1)
-void usart3_tx_dma_irq_handler(void) {
+OMNI_FAST_ISR void usart3_tx_dma_irq_handler(void) {
     HAL_DMA_IRQHandler(usart_obj[USART_NUM_3].dev->dma_tx->handle);
 }
 #endif /* (CONFIG_USART3_TX_DMA == 1) */
 #if (CONFIG_USART4_TX_DMA == 1)
-void usart4_tx_dma_irq_handler(void) {
+OMNI_FAST_ISR void usart4_tx_dma_irq_handler(void) {
     HAL_DMA_IRQHandler(usart_obj[USART_NUM_4].dev->dma_tx->handle);
 }
 #endif /* (CONFIG_USART4_TX_DMA == 1) */
 #if (CONFIG_USART5_TX_DMA == 1)
-void usart5_tx_dma_irq_handler(void) {
+OMNI_FAST_ISR void usart5_tx_dma_irq_handler(void) {
     HAL_DMA_IRQHandler(usart_obj[USART_NUM_5].dev->dma_tx->handle);
 }
 #endif /* (CONFIG_USART5_TX_DMA == 1) */
 #if (CONFIG_USART6_TX_DMA == 1)
-void usart6_tx_dma_irq_handler(void) {
+OMNI_FAST_ISR void usart6_tx_dma_irq_handler(void) {
     HAL_DMA_IRQHandler(usart_obj[USART_NUM_6].dev->dma_tx->handle);
 }
 #endif /* (CONFIG_USART6_TX_DMA == 1) */
 #if (CONFIG_USART7_TX_DMA == 1)
-void usart7_tx_dma_irq_handler(void) {
+OMNI_FAST_ISR void usart7_tx_dma_irq_handler(void) {
     HAL_DMA_IRQHandler(usart_obj[USART_NUM_7].dev->dma_tx->handle);
 }
 #endif /* (CONFIG_USART7_TX_DMA == 1) */
 #if (CONFIG_USART8_TX_DMA == 1)
-void usart8_tx_dma_irq_handler(void) {
+OMNI_FAST_ISR void usart8_tx_dma_irq_handler(void) {
     HAL_DMA_IRQHandler(usart_obj[USART_NUM_8].dev->dma_tx->handle);
 }
 #endif /* (CONFIG_USART8_TX_DMA == 1) */
 #if (CONFIG_USART9_TX_DMA == 1)
-void usart9_tx_dma_irq_handler(void) {
+OMNI_FAST_ISR void usart9_tx_dma_irq_handler(void) {
     HAL_DMA_IRQHandler(usart_obj[USART_NUM_9].dev->dma_tx->handle);
 }
 #endif /* (CONFIG_USART9_TX_DMA == 1) */
 #if (CONFIG_USART10_TX_DMA == 1)
-void usart10_tx_dma_irq_handler(void) {
+OMNI_FAST_ISR void usart10_tx_dma_irq_handler(void) {
     HAL_DMA_IRQHandler(usart_obj[USART_NUM_10].dev->dma_tx->handle);
 }
 #endif /* (CONFIG_USART10_TX_DMA == 1) */
@@ -631,52 +857,52 @@ void usart10_tx_dma_irq_handler(void) {
 
 #if (CONFIG_USART_RX_DMA == 1)
 #if (CONFIG_USART1_RX_DMA == 1)
-void usart1_rx_dma_irq_handler(void) {
+OMNI_FAST_ISR void usart1_rx_dma_irq_handler(void) {
     HAL_DMA_IRQHandler(usart_obj[USART_NUM_1].dev->dma_rx->handle);
 }
 #endif /* (CONFIG_USART1_RX_DMA == 1) */
 #if (CONFIG_USART2_RX_DMA == 1)
-void usart2_rx_dma_irq_handler(void) {
+OMNI_FAST_ISR void usart2_rx_dma_irq_handler(void) {
     HAL_DMA_IRQHandler(usart_obj[USART_NUM_2].dev->dma_rx->handle);
 }
 #endif /* (CONFIG_USART2_RX_DMA == 1) */
 #if (CONFIG_USART3_RX_DMA == 1)
-void usart3_rx_dma_irq_handler(void) {
+OMNI_FAST_ISR void usart3_rx_dma_irq_handler(void) {
     HAL_DMA_IRQHandler(usart_obj[USART_NUM_3].dev->dma_rx->handle);
 }
 #endif /* (CONFIG_USART3_RX_DMA == 1) */
 #if (CONFIG_USART4_RX_DMA == 1)
-void usart4_rx_dma_irq_handler(void) {
+OMNI_FAST_ISR void usart4_rx_dma_irq_handler(void) {
     HAL_DMA_IRQHandler(usart_obj[USART_NUM_4].dev->dma_rx->handle);
 }
 #endif /* (CONFIG_USART4_RX_DMA == 1) */
 #if (CONFIG_USART5_RX_DMA == 1)
-void usart5_rx_dma_irq_handler(void) {
+OMNI_FAST_ISR void usart5_rx_dma_irq_handler(void) {
     HAL_DMA_IRQHandler(usart_obj[USART_NUM_5].dev->dma_rx->handle);
 }
 #endif /* (CONFIG_USART5_RX_DMA == 1) */
 #if (CONFIG_USART6_RX_DMA == 1)
-void usart6_rx_dma_irq_handler(void) {
+OMNI_FAST_ISR void usart6_rx_dma_irq_handler(void) {
     HAL_DMA_IRQHandler(usart_obj[USART_NUM_6].dev->dma_rx->handle);
 }
 #endif /* (CONFIG_USART6_RX_DMA == 1) */
 #if (CONFIG_USART7_RX_DMA == 1)
-void usart7_rx_dma_irq_handler(void) {
+OMNI_FAST_ISR void usart7_rx_dma_irq_handler(void) {
     HAL_DMA_IRQHandler(usart_obj[USART_NUM_7].dev->dma_rx->handle);
 }
 #endif /* (CONFIG_USART7_RX_DMA == 1) */
 #if (CONFIG_USART8_RX_DMA == 1)
-void usart8_rx_dma_irq_handler(void) {
+OMNI_FAST_ISR void usart8_rx_dma_irq_handler(void) {
     HAL_DMA_IRQHandler(usart_obj[USART_NUM_8].dev->dma_rx->handle);
 }
 #endif /* (CONFIG_USART8_RX_DMA == 1) */
 #if (CONFIG_USART9_RX_DMA == 1)
-void usart9_rx_dma_irq_handler(void) {
+OMNI_FAST_ISR void usart9_rx_dma_irq_handler(void) {
     HAL_DMA_IRQHandler(usart_obj[USART_NUM_9].dev->dma_rx->handle);
 }
 #endif /* (CONFIG_USART9_RX_DMA == 1) */
 #if (CONFIG_USART10_RX_DMA == 1)
-void usart10_rx_dma_irq_handler(void) {
+OMNI_FAST_ISR void usart10_rx_dma_irq_handler(void) {
     HAL_DMA_IRQHandler(usart_obj[USART_NUM_10].dev->dma_rx->handle);
 }
 #endif /* (CONFIG_USART10_RX_DMA == 1) */
@@ -808,12 +1034,74 @@ static void usart_hal_irq_register(void) {
 #endif /* (CONFIG_USART_NUM_10 == 1) */
 }
 
+#if ((CONFIG_USART_TX_DMA == 1) || (CONFIG_USART_RX_DMA == 1))
+static void usart_tx_stream_callback(DMA_HandleTypeDef *hdma) {
+    UART_HandleTypeDef *huart = (UART_HandleTypeDef *)hdma->Parent;
+    usart_obj_t *obj = usart_hal_get_obj(huart);
+    omni_assert_not_null(obj);
+
+    uint32_t len = usart_hal_get_bytes(huart, obj->data.tx_num);
+    void *buffer = dma_hal_double_done(hdma, DMA_HAL_DIR_TX, len);
+
+    if (obj->tx_stream_cb != NULL) {
+        obj->tx_stream_cb(buffer);
+    }
+
+    dma_hal_double_refill(buffer, len);
+}
+
+static void usart_rx_stream_callback(DMA_HandleTypeDef *hdma) {
+    UART_HandleTypeDef *huart = (UART_HandleTypeDef *)hdma->Parent;
+    usart_obj_t *obj = usart_hal_get_obj(huart);
+    omni_assert_not_null(obj);
+
+    void *buffer = dma_hal_double_done(hdma, DMA_HAL_DIR_RX, usart_hal_get_bytes(huart, obj->data.rx_num));
+
+    if (obj->rx_stream_cb != NULL) {
+        obj->rx_stream_cb(buffer);
+    }
+}
+
+static void usart_stream_error_callback(DMA_HandleTypeDef *hdma) {
+    UART_HandleTypeDef *huart = (UART_HandleTypeDef *)hdma->Parent;
+    usart_obj_t *obj = usart_hal_get_obj(huart);
+    usart_stream_callback cb;
+    omni_assert_not_null(obj);
+
+    // FIFO and direct mode errors do not stop the stream
+    if (HAL_DMA_GetState(hdma) != HAL_DMA_STATE_READY) {
+        return;
+    }
+
+    if (hdma == huart->hdmatx) {
+        ATOMIC_CLEAR_BIT(huart->Instance->CR3, USART_CR3_DMAT);
+        cb = obj->tx_stream_cb;
+        obj->tx_stream_cb = NULL;
+        obj->status.tx_busy = 0;
+    } else {
+        ATOMIC_CLEAR_BIT(huart->Instance->CR3, USART_CR3_DMAR);
+        cb = obj->rx_stream_cb;
+        obj->rx_stream_cb = NULL;
+        obj->status.rx_busy = 0;
+    }
+
+    if (cb != NULL) {
+        cb(NULL);
+    }
+}
+#endif /* ((CONFIG_USART_TX_DMA == 1) || (CONFIG_USART_RX_DMA == 1)) */
+
 /********************* Callback functions **********************/
 void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart) {
     usart_obj_t *obj = usart_hal_get_obj(huart);
     omni_assert_not_null(obj);
 
+#if (CONFIG_USART_TX_DMA == 1)
+    dma_hal_tx_complete(&usart_dma_tx[obj - usart_obj]);
+#endif /* (CONFIG_USART_TX_DMA == 1) */
+
     obj->status.tx_busy = 0;
+    TRACE_RECORD(TRACE_EVENT_DRV_COMPLETE, TRACE_DRV_USART | (uint32_t)(obj - usart_obj), 0);
 
     if (obj->event_cb != NULL) {
         obj->event_cb(USART_EVENT_SEND_COMPLETE);
@@ -824,7 +1112,12 @@ void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart) {
     usart_obj_t *obj = usart_hal_get_obj(huart);
     omni_assert_not_null(obj);
 
+#if (CONFIG_USART_RX_DMA == 1)
+    dma_hal_rx_complete(&usart_dma_rx[obj - usart_obj]);
+#endif /* (CONFIG_USART_RX_DMA == 1) */
+
     obj->status.rx_busy = 0;
+    TRACE_RECORD(TRACE_EVENT_DRV_COMPLETE, TRACE_DRV_USART_RX | (uint32_t)(obj - usart_obj), 0);
 
     if (obj->event_cb != NULL) {
         obj->event_cb(USART_EVENT_RECEIVE_COMPLETE);
@@ -836,6 +1129,13 @@ void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart) {
     usart_obj_t *obj = usart_hal_get_obj(huart);
     omni_assert_not_null(obj);
 
+#if (CONFIG_USART_RX_DMA == 1)
+    // Blocking errors abort the reception, return what was received
+    if (huart->RxState == HAL_UART_STATE_READY) {
+        dma_hal_rx_complete(&usart_dma_rx[obj - usart_obj]);
+    }
+#endif /* (CONFIG_USART_RX_DMA == 1) */
+
     if (huart->ErrorCode & HAL_UART_ERROR_ORE) {
         obj->error.rx_overflow = 1;
         event |= USART_EVENT_RX_OVERFLOW;
@@ -851,6 +1151,12 @@ void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart) {
         event |= USART_EVENT_RX_PARITY_ERROR;
     }
 
+#if defined(CONFIG_COMPONENT_TRACE)
+    if (event != 0) {
+        TRACE_RECORD(TRACE_EVENT_DRV_ERROR, TRACE_DRV_USART_RX | (uint32_t)(obj - usart_obj), event);
+    }
+#endif /* CONFIG_COMPONENT_TRACE */
+
     if ((obj->event_cb != NULL) && (event != 0)) {
         obj->event_cb(event);
     }
@@ -1122,3 +1428,21 @@ static usart_obj_t *usart_hal_get_obj(UART_HandleTypeDef *huart) {
 
     return obj;
 }
+
+#if ((CONFIG_USART_TX_DMA == 1) || (CONFIG_USART_RX_DMA == 1))
+/**
+ * @brief Get number of bytes of a transfer
+ * 
+ * @param handle UART handle
+ * @param len Number of data frames
+ * @return Number of bytes
+ */
+static uint32_t usart_hal_get_bytes(UART_HandleTypeDef *handle, uint32_t len) {
+    // 9-bit frames without parity take a half word
+    if ((handle->Init.WordLength == UART_WORDLENGTH_9B) && (handle->Init.Parity == UART_PARITY_NONE)) {
+        return len * 2U;
+    }
+
+    return len;
+}
+#endif /* ((CONFIG_USART_TX_DMA == 1) || (CONFIG_USART_RX_DMA == 1)) */
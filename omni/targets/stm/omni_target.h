@@ -109,6 +109,28 @@ typedef const struct usart_dev {
     dma_dev_t *dma_rx;
 } usart_dev_t;
 
+typedef const struct timer_dev {
+    TIM_HandleTypeDef *handle;
+    uint32_t clock;
+    IRQn_Type irq_num;
+    IRQn_Type cc_irq_num;
+    uint8_t irq_prio;
+    gpio_pin_t *ch_pin[4];
+    uint32_t cc_dma_channel;
+    dma_dev_t *dma_cc;
+    dma_dev_t *dma_up;
+} timer_dev_t;
+
+typedef const struct adc_dev {
+    ADC_HandleTypeDef *handle;
+    IRQn_Type irq_num;
+    uint8_t irq_prio;
+    uint32_t clock_prescaler;
+    gpio_pin_t *ch_pin;
+    uint8_t ch_num;
+    dma_dev_t *dma;
+} adc_dev_t;
+
 #if defined(CONFIG_SOC_FAMILY_STM32F1XX)
 typedef const struct usb_dev {
     USB_TypeDef *ins;
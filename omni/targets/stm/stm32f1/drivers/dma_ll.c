@@ -0,0 +1,100 @@
+/**
+  * @file    dma_ll.c
+  * @author  LuckkMaker
+  * @brief   Low-level DMA configuration
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "ll/dma_ll.h"
+
+// Index of a channel in the stream table
+#define DMA_LL_DMA1(channel)        ((channel) - 1U)
+#define DMA_LL_DMA2(channel)        (7U + (channel) - 1U)
+
+static const dma_hal_stream_t dma_ll_streams[DMA_LL_STREAM_NUM] = {
+    { DMA1_Channel1, DMA1, DMA1_Channel1_IRQn },
+    { DMA1_Channel2, DMA1, DMA1_Channel2_IRQn },
+    { DMA1_Channel3, DMA1, DMA1_Channel3_IRQn },
+    { DMA1_Channel4, DMA1, DMA1_Channel4_IRQn },
+    { DMA1_Channel5, DMA1, DMA1_Channel5_IRQn },
+    { DMA1_Channel6, DMA1, DMA1_Channel6_IRQn },
+    { DMA1_Channel7, DMA1, DMA1_Channel7_IRQn },
+#if defined(DMA2)
+    { DMA2_Channel1, DMA2, DMA2_Channel1_IRQn },
+    { DMA2_Channel2, DMA2, DMA2_Channel2_IRQn },
+    { DMA2_Channel3, DMA2, DMA2_Channel3_IRQn },
+    { DMA2_Channel4, DMA2, DMA2_Channel4_IRQn },
+    { DMA2_Channel5, DMA2, DMA2_Channel5_IRQn },
+#endif /* DMA2 */
+};
+
+// Requests of the omni drivers, every request has one fixed channel
+static const dma_hal_map_t dma_ll_map[] = {
+#if defined(USART1)
+    { USART1, DMA_HAL_DIR_TX, DMA_LL_DMA1(4), 0 },
+    { USART1, DMA_HAL_DIR_RX, DMA_LL_DMA1(5), 0 },
+#endif /* USART1 */
+#if defined(USART2)
+    { USART2, DMA_HAL_DIR_TX, DMA_LL_DMA1(7), 0 },
+    { USART2, DMA_HAL_DIR_RX, DMA_LL_DMA1(6), 0 },
+#endif /* USART2 */
+#if defined(USART3)
+    { USART3, DMA_HAL_DIR_TX, DMA_LL_DMA1(2), 0 },
+    { USART3, DMA_HAL_DIR_RX, DMA_LL_DMA1(3), 0 },
+#endif /* USART3 */
+#if defined(UART4) && defined(DMA2)
+    { UART4, DMA_HAL_DIR_TX, DMA_LL_DMA2(5), 0 },
+    { UART4, DMA_HAL_DIR_RX, DMA_LL_DMA2(3), 0 },
+#endif /* UART4 && DMA2 */
+#if defined(I2C1)
+    { I2C1, DMA_HAL_DIR_TX, DMA_LL_DMA1(6), 0 },
+    { I2C1, DMA_HAL_DIR_RX, DMA_LL_DMA1(7), 0 },
+#endif /* I2C1 */
+#if defined(I2C2)
+    { I2C2, DMA_HAL_DIR_TX, DMA_LL_DMA1(4), 0 },
+    { I2C2, DMA_HAL_DIR_RX, DMA_LL_DMA1(5), 0 },
+#endif /* I2C2 */
+#if defined(ADC1)
+    { ADC1, DMA_HAL_DIR_RX, DMA_LL_DMA1(1), 0 },
+#endif /* ADC1 */
+#if defined(ADC3) && defined(DMA2)
+    { ADC3, DMA_HAL_DIR_RX, DMA_LL_DMA2(5), 0 },
+#endif /* ADC3 && DMA2 */
+};
+
+/**
+ * @brief Get DMA stream table
+ *
+ * @return Pointer to DMA_LL_STREAM_NUM channels
+ */
+const dma_hal_stream_t* dma_ll_get_streams(void) {
+    return dma_ll_streams;
+}
+
+/**
+ * @brief Get DMA request mapping
+ *
+ * @param num Number of entries
+ * @return Pointer to mapping
+ */
+const dma_hal_map_t* dma_ll_get_map(uint32_t *num) {
+    *num = sizeof(dma_ll_map) / sizeof(dma_ll_map[0]);
+
+    return dma_ll_map;
+}
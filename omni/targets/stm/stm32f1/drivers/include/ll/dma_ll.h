@@ -0,0 +1,47 @@
+/**
+  * @file    dma_ll.h
+  * @author  LuckkMaker
+  * @brief   Low-level DMA configuration
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef OMNI_LL_DMA_H
+#define OMNI_LL_DMA_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "hal/dma_hal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(DMA2)
+#define DMA_LL_STREAM_NUM           12U     /**< DMA1 channels 1..7, DMA2 channels 1..5 */
+#else
+#define DMA_LL_STREAM_NUM           7U      /**< DMA1 channels 1..7 */
+#endif /* DMA2 */
+
+const dma_hal_stream_t* dma_ll_get_streams(void);
+const dma_hal_map_t* dma_ll_get_map(uint32_t *num);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* OMNI_LL_DMA_H */
@@ -0,0 +1,224 @@
+/**
+  * @file    adc_ll.c
+  * @author  LuckkMaker
+  * @brief   Low-level ADC configuration
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "ll/adc_ll.h"
+
+#if ((CONFIG_ADC_NUM_1 == 1) || (CONFIG_ADC_NUM_2 == 1))
+// Analog input of each channel, fixed by the device, channels 16..18 are internal
+static gpio_pin_t adc12_pins[16] = {
+    { GPIOA, GPIO_PIN_0, 0 },
+    { GPIOA, GPIO_PIN_1, 0 },
+    { GPIOA, GPIO_PIN_2, 0 },
+    { GPIOA, GPIO_PIN_3, 0 },
+    { GPIOA, GPIO_PIN_4, 0 },
+    { GPIOA, GPIO_PIN_5, 0 },
+    { GPIOA, GPIO_PIN_6, 0 },
+    { GPIOA, GPIO_PIN_7, 0 },
+    { GPIOB, GPIO_PIN_0, 0 },
+    { GPIOB, GPIO_PIN_1, 0 },
+    { GPIOC, GPIO_PIN_0, 0 },
+    { GPIOC, GPIO_PIN_1, 0 },
+    { GPIOC, GPIO_PIN_2, 0 },
+    { GPIOC, GPIO_PIN_3, 0 },
+    { GPIOC, GPIO_PIN_4, 0 },
+    { GPIOC, GPIO_PIN_5, 0 },
+};
+#endif /* (CONFIG_ADC_NUM_1 == 1) || (CONFIG_ADC_NUM_2 == 1) */
+
+#if defined(ADC3) && (CONFIG_ADC_NUM_3 == 1)
+// ADC3 has its own inputs on port F
+static gpio_pin_t adc3_pins[16] = {
+    { GPIOA, GPIO_PIN_0, 0 },
+    { GPIOA, GPIO_PIN_1, 0 },
+    { GPIOA, GPIO_PIN_2, 0 },
+    { GPIOA, GPIO_PIN_3, 0 },
+    { GPIOF, GPIO_PIN_6, 0 },
+    { GPIOF, GPIO_PIN_7, 0 },
+    { GPIOF, GPIO_PIN_8, 0 },
+    { GPIOF, GPIO_PIN_9, 0 },
+    { GPIOF, GPIO_PIN_10, 0 },
+    { GPIOF, GPIO_PIN_3, 0 },
+    { GPIOC, GPIO_PIN_0, 0 },
+    { GPIOC, GPIO_PIN_1, 0 },
+    { GPIOC, GPIO_PIN_2, 0 },
+    { GPIOC, GPIO_PIN_3, 0 },
+    { GPIOF, GPIO_PIN_4, 0 },
+    { GPIOF, GPIO_PIN_5, 0 },
+};
+#endif /* ADC3 && (CONFIG_ADC_NUM_3 == 1) */
+
+#if defined(ADC1) && (CONFIG_ADC_NUM_1 == 1)
+#if (CONFIG_ADC1_DMA == 1)
+static DMA_HandleTypeDef adc1_dma_handle = {
+    .Instance = CONFIG_ADC1_DMA_STREAM,
+    .Init = {
+        .Channel = CONFIG_ADC1_DMA_CHANNEL,
+        .Direction = DMA_PERIPH_TO_MEMORY,
+        .PeriphInc = DMA_PINC_DISABLE,
+        .MemInc = DMA_MINC_ENABLE,
+        .PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD,
+        .MemDataAlignment = DMA_MDATAALIGN_HALFWORD,
+        .Mode = DMA_CIRCULAR,
+        .Priority = CONFIG_ADC1_DMA_PRIORITY,
+        .FIFOMode = DMA_FIFOMODE_DISABLE,
+        .FIFOThreshold = DMA_FIFO_THRESHOLD_FULL,
+        .MemBurst = DMA_MBURST_SINGLE,
+        .PeriphBurst = DMA_PBURST_SINGLE,
+    },
+};
+static dma_dev_t adc1_dma = {
+    .handle = &adc1_dma_handle,
+    .ins = CONFIG_ADC1_DMA_INS,
+    .irq_num = CONFIG_ADC1_DMA_IRQ_NUM,
+    .irq_prio = CONFIG_ADC1_DMA_IRQ_PRIO,
+};
+#endif /* (CONFIG_ADC1_DMA == 1) */
+static ADC_HandleTypeDef adc1_handle = {
+    .Instance = ADC1
+};
+static adc_dev_t adc1_dev = {
+    .handle = &adc1_handle,
+    .irq_num = ADC_IRQn,
+    .irq_prio = CONFIG_ADC_IRQ_PRIO,
+    .clock_prescaler = CONFIG_ADC_CLK_PRESC,
+    .ch_pin = adc12_pins,
+    .ch_num = ARRAY_SIZE(adc12_pins),
+#if (CONFIG_ADC1_DMA == 1)
+    .dma = &adc1_dma,
+#endif /* (CONFIG_ADC1_DMA == 1) */
+};
+#endif /* ADC1 && (CONFIG_ADC_NUM_1 == 1) */
+
+#if defined(ADC2) && (CONFIG_ADC_NUM_2 == 1)
+#if (CONFIG_ADC2_DMA == 1)
+static DMA_HandleTypeDef adc2_dma_handle = {
+    .Instance = CONFIG_ADC2_DMA_STREAM,
+    .Init = {
+        .Channel = CONFIG_ADC2_DMA_CHANNEL,
+        .Direction = DMA_PERIPH_TO_MEMORY,
+        .PeriphInc = DMA_PINC_DISABLE,
+        .MemInc = DMA_MINC_ENABLE,
+        .PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD,
+        .MemDataAlignment = DMA_MDATAALIGN_HALFWORD,
+        .Mode = DMA_CIRCULAR,
+        .Priority = CONFIG_ADC2_DMA_PRIORITY,
+        .FIFOMode = DMA_FIFOMODE_DISABLE,
+        .FIFOThreshold = DMA_FIFO_THRESHOLD_FULL,
+        .MemBurst = DMA_MBURST_SINGLE,
+        .PeriphBurst = DMA_PBURST_SINGLE,
+    },
+};
+static dma_dev_t adc2_dma = {
+    .handle = &adc2_dma_handle,
+    .ins = CONFIG_ADC2_DMA_INS,
+    .irq_num = CONFIG_ADC2_DMA_IRQ_NUM,
+    .irq_prio = CONFIG_ADC2_DMA_IRQ_PRIO,
+};
+#endif /* (CONFIG_ADC2_DMA == 1) */
+static ADC_HandleTypeDef adc2_handle = {
+    .Instance = ADC2
+};
+static adc_dev_t adc2_dev = {
+    .handle = &adc2_handle,
+    .irq_num = ADC_IRQn,
+    .irq_prio = CONFIG_ADC_IRQ_PRIO,
+    .clock_prescaler = CONFIG_ADC_CLK_PRESC,
+    .ch_pin = adc12_pins,
+    .ch_num = ARRAY_SIZE(adc12_pins),
+#if (CONFIG_ADC2_DMA == 1)
+    .dma = &adc2_dma,
+#endif /* (CONFIG_ADC2_DMA == 1) */
+};
+#endif /* ADC2 && (CONFIG_ADC_NUM_2 == 1) */
+
+#if defined(ADC3) && (CONFIG_ADC_NUM_3 == 1)
+#if (CONFIG_ADC3_DMA == 1)
+static DMA_HandleTypeDef adc3_dma_handle = {
+    .Instance = CONFIG_ADC3_DMA_STREAM,
+    .Init = {
+        .Channel = CONFIG_ADC3_DMA_CHANNEL,
+        .Direction = DMA_PERIPH_TO_MEMORY,
+        .PeriphInc = DMA_PINC_DISABLE,
+        .MemInc = DMA_MINC_ENABLE,
+        .PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD,
+        .MemDataAlignment = DMA_MDATAALIGN_HALFWORD,
+        .Mode = DMA_CIRCULAR,
+        .Priority = CONFIG_ADC3_DMA_PRIORITY,
+        .FIFOMode = DMA_FIFOMODE_DISABLE,
+        .FIFOThreshold = DMA_FIFO_THRESHOLD_FULL,
+        .MemBurst = DMA_MBURST_SINGLE,
+        .PeriphBurst = DMA_PBURST_SINGLE,
+    },
+};
+static dma_dev_t adc3_dma = {
+    .handle = &adc3_dma_handle,
+    .ins = CONFIG_ADC3_DMA_INS,
+    .irq_num = CONFIG_ADC3_DMA_IRQ_NUM,
+    .irq_prio = CONFIG_ADC3_DMA_IRQ_PRIO,
+};
+#endif /* (CONFIG_ADC3_DMA == 1) */
+static ADC_HandleTypeDef adc3_handle = {
+    .Instance = ADC3
+};
+static adc_dev_t adc3_dev = {
+    .handle = &adc3_handle,
+    .irq_num = ADC_IRQn,
+    .irq_prio = CONFIG_ADC_IRQ_PRIO,
+    .clock_prescaler = CONFIG_ADC_CLK_PRESC,
+    .ch_pin = adc3_pins,
+    .ch_num = ARRAY_SIZE(adc3_pins),
+#if (CONFIG_ADC3_DMA == 1)
+    .dma = &adc3_dma,
+#endif /* (CONFIG_ADC3_DMA == 1) */
+};
+#endif /* ADC3 && (CONFIG_ADC_NUM_3 == 1) */
+
+/**
+ * @brief Get ADC device information
+ * 
+ * @param adc_num ADC number
+ * @return ADC device information
+ */
+adc_dev_t* adc_ll_get_dev(adc_num_t adc_num) {
+    switch (adc_num) {
+#if (CONFIG_ADC_NUM_1 == 1)
+        case ADC_NUM_1:
+            return &adc1_dev;
+#endif /* (CONFIG_ADC_NUM_1 == 1) */
+
+#if (CONFIG_ADC_NUM_2 == 1)
+        case ADC_NUM_2:
+            return &adc2_dev;
+#endif /* (CONFIG_ADC_NUM_2 == 1) */
+
+#if (CONFIG_ADC_NUM_3 == 1)
+        case ADC_NUM_3:
+            return &adc3_dev;
+#endif /* (CONFIG_ADC_NUM_3 == 1) */
+
+        default:
+            return NULL;
+    }
+
+    return NULL;
+}
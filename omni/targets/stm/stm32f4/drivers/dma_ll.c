@@ -0,0 +1,133 @@
+/**
+  * @file    dma_ll.c
+  * @author  LuckkMaker
+  * @brief   Low-level DMA configuration
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "ll/dma_ll.h"
+
+// Index of a stream in the stream table
+#define DMA_LL_DMA1(stream)         (stream)
+#define DMA_LL_DMA2(stream)         (8U + (stream))
+
+static const dma_hal_stream_t dma_ll_streams[DMA_LL_STREAM_NUM] = {
+    { DMA1_Stream0, DMA1, DMA1_Stream0_IRQn },
+    { DMA1_Stream1, DMA1, DMA1_Stream1_IRQn },
+    { DMA1_Stream2, DMA1, DMA1_Stream2_IRQn },
+    { DMA1_Stream3, DMA1, DMA1_Stream3_IRQn },
+    { DMA1_Stream4, DMA1, DMA1_Stream4_IRQn },
+    { DMA1_Stream5, DMA1, DMA1_Stream5_IRQn },
+    { DMA1_Stream6, DMA1, DMA1_Stream6_IRQn },
+    { DMA1_Stream7, DMA1, DMA1_Stream7_IRQn },
+    { DMA2_Stream0, DMA2, DMA2_Stream0_IRQn },
+    { DMA2_Stream1, DMA2, DMA2_Stream1_IRQn },
+    { DMA2_Stream2, DMA2, DMA2_Stream2_IRQn },
+    { DMA2_Stream3, DMA2, DMA2_Stream3_IRQn },
+    { DMA2_Stream4, DMA2, DMA2_Stream4_IRQn },
+    { DMA2_Stream5, DMA2, DMA2_Stream5_IRQn },
+    { DMA2_Stream6, DMA2, DMA2_Stream6_IRQn },
+    { DMA2_Stream7, DMA2, DMA2_Stream7_IRQn },
+};
+
+// Requests of the omni drivers, stream and channel pairs of the DMA request mapping
+static const dma_hal_map_t dma_ll_map[] = {
+#if defined(SPI1)
+    { SPI1, DMA_HAL_DIR_TX, DMA_LL_DMA2(3), DMA_CHANNEL_3 },
+    { SPI1, DMA_HAL_DIR_TX, DMA_LL_DMA2(5), DMA_CHANNEL_3 },
+    { SPI1, DMA_HAL_DIR_RX, DMA_LL_DMA2(0), DMA_CHANNEL_3 },
+    { SPI1, DMA_HAL_DIR_RX, DMA_LL_DMA2(2), DMA_CHANNEL_3 },
+#endif /* SPI1 */
+#if defined(USART1)
+    { USART1, DMA_HAL_DIR_TX, DMA_LL_DMA2(7), DMA_CHANNEL_4 },
+    { USART1, DMA_HAL_DIR_RX, DMA_LL_DMA2(2), DMA_CHANNEL_4 },
+    { USART1, DMA_HAL_DIR_RX, DMA_LL_DMA2(5), DMA_CHANNEL_4 },
+#endif /* USART1 */
+#if defined(USART2)
+    { USART2, DMA_HAL_DIR_TX, DMA_LL_DMA1(6), DMA_CHANNEL_4 },
+    { USART2, DMA_HAL_DIR_RX, DMA_LL_DMA1(5), DMA_CHANNEL_4 },
+#endif /* USART2 */
+#if defined(USART3)
+    { USART3, DMA_HAL_DIR_TX, DMA_LL_DMA1(3), DMA_CHANNEL_4 },
+    { USART3, DMA_HAL_DIR_TX, DMA_LL_DMA1(4), DMA_CHANNEL_7 },
+    { USART3, DMA_HAL_DIR_RX, DMA_LL_DMA1(1), DMA_CHANNEL_4 },
+#endif /* USART3 */
+#if defined(UART4)
+    { UART4, DMA_HAL_DIR_TX, DMA_LL_DMA1(4), DMA_CHANNEL_4 },
+    { UART4, DMA_HAL_DIR_RX, DMA_LL_DMA1(2), DMA_CHANNEL_4 },
+#endif /* UART4 */
+#if defined(UART5)
+    { UART5, DMA_HAL_DIR_TX, DMA_LL_DMA1(7), DMA_CHANNEL_4 },
+    { UART5, DMA_HAL_DIR_RX, DMA_LL_DMA1(0), DMA_CHANNEL_4 },
+#endif /* UART5 */
+#if defined(USART6)
+    { USART6, DMA_HAL_DIR_TX, DMA_LL_DMA2(6), DMA_CHANNEL_5 },
+    { USART6, DMA_HAL_DIR_TX, DMA_LL_DMA2(7), DMA_CHANNEL_5 },
+    { USART6, DMA_HAL_DIR_RX, DMA_LL_DMA2(1), DMA_CHANNEL_5 },
+    { USART6, DMA_HAL_DIR_RX, DMA_LL_DMA2(2), DMA_CHANNEL_5 },
+#endif /* USART6 */
+#if defined(I2C1)
+    { I2C1, DMA_HAL_DIR_TX, DMA_LL_DMA1(6), DMA_CHANNEL_1 },
+    { I2C1, DMA_HAL_DIR_TX, DMA_LL_DMA1(7), DMA_CHANNEL_1 },
+    { I2C1, DMA_HAL_DIR_RX, DMA_LL_DMA1(0), DMA_CHANNEL_1 },
+    { I2C1, DMA_HAL_DIR_RX, DMA_LL_DMA1(5), DMA_CHANNEL_1 },
+#endif /* I2C1 */
+#if defined(I2C2)
+    { I2C2, DMA_HAL_DIR_TX, DMA_LL_DMA1(7), DMA_CHANNEL_7 },
+    { I2C2, DMA_HAL_DIR_RX, DMA_LL_DMA1(2), DMA_CHANNEL_7 },
+    { I2C2, DMA_HAL_DIR_RX, DMA_LL_DMA1(3), DMA_CHANNEL_7 },
+#endif /* I2C2 */
+#if defined(I2C3)
+    { I2C3, DMA_HAL_DIR_TX, DMA_LL_DMA1(4), DMA_CHANNEL_3 },
+    { I2C3, DMA_HAL_DIR_RX, DMA_LL_DMA1(2), DMA_CHANNEL_3 },
+#endif /* I2C3 */
+#if defined(ADC1)
+    { ADC1, DMA_HAL_DIR_RX, DMA_LL_DMA2(0), DMA_CHANNEL_0 },
+    { ADC1, DMA_HAL_DIR_RX, DMA_LL_DMA2(4), DMA_CHANNEL_0 },
+#endif /* ADC1 */
+#if defined(ADC2)
+    { ADC2, DMA_HAL_DIR_RX, DMA_LL_DMA2(2), DMA_CHANNEL_1 },
+    { ADC2, DMA_HAL_DIR_RX, DMA_LL_DMA2(3), DMA_CHANNEL_1 },
+#endif /* ADC2 */
+#if defined(ADC3)
+    { ADC3, DMA_HAL_DIR_RX, DMA_LL_DMA2(0), DMA_CHANNEL_2 },
+    { ADC3, DMA_HAL_DIR_RX, DMA_LL_DMA2(1), DMA_CHANNEL_2 },
+#endif /* ADC3 */
+};
+
+/**
+ * @brief Get DMA stream table
+ *
+ * @return Pointer to DMA_LL_STREAM_NUM streams
+ */
+const dma_hal_stream_t* dma_ll_get_streams(void) {
+    return dma_ll_streams;
+}
+
+/**
+ * @brief Get DMA request mapping
+ *
+ * @param num Number of entries
+ * @return Pointer to mapping
+ */
+const dma_hal_map_t* dma_ll_get_map(uint32_t *num) {
+    *num = sizeof(dma_ll_map) / sizeof(dma_ll_map[0]);
+
+    return dma_ll_map;
+}
@@ -0,0 +1,633 @@
+/**
+  * @file    timer_ll.c
+  * @author  LuckkMaker
+  * @brief   Low-level timer configuration
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "ll/timer_ll.h"
+
+#if defined(TIM1) && (CONFIG_TIMER_NUM_1 == 1)
+#if (CONFIG_TIM1_CH1_DEF == 1)
+static gpio_pin_t tim1_ch1_pin = { CONFIG_TIM1_CH1_PORT, CONFIG_TIM1_CH1_PIN, CONFIG_TIM1_CH1_AF };
+#endif /* (CONFIG_TIM1_CH1_DEF == 1) */
+#if (CONFIG_TIM1_CH2_DEF == 1)
+static gpio_pin_t tim1_ch2_pin = { CONFIG_TIM1_CH2_PORT, CONFIG_TIM1_CH2_PIN, CONFIG_TIM1_CH2_AF };
+#endif /* (CONFIG_TIM1_CH2_DEF == 1) */
+#if (CONFIG_TIM1_CH3_DEF == 1)
+static gpio_pin_t tim1_ch3_pin = { CONFIG_TIM1_CH3_PORT, CONFIG_TIM1_CH3_PIN, CONFIG_TIM1_CH3_AF };
+#endif /* (CONFIG_TIM1_CH3_DEF == 1) */
+#if (CONFIG_TIM1_CH4_DEF == 1)
+static gpio_pin_t tim1_ch4_pin = { CONFIG_TIM1_CH4_PORT, CONFIG_TIM1_CH4_PIN, CONFIG_TIM1_CH4_AF };
+#endif /* (CONFIG_TIM1_CH4_DEF == 1) */
+#if (CONFIG_TIM1_UP_DMA == 1)
+static DMA_HandleTypeDef tim1_up_dma_handle = {
+    .Instance = CONFIG_TIM1_UP_DMA_STREAM,
+    .Init = {
+        .Channel = CONFIG_TIM1_UP_DMA_CHANNEL,
+        .Direction = DMA_MEMORY_TO_PERIPH,
+        .PeriphInc = DMA_PINC_DISABLE,
+        .MemInc = DMA_MINC_ENABLE,
+        .PeriphDataAlignment = DMA_PDATAALIGN_WORD,
+        .MemDataAlignment = DMA_MDATAALIGN_WORD,
+        .Mode = DMA_NORMAL,
+        .Priority = CONFIG_TIM1_UP_DMA_PRIORITY,
+        .FIFOMode = DMA_FIFOMODE_DISABLE,
+        .FIFOThreshold = DMA_FIFO_THRESHOLD_FULL,
+        .MemBurst = DMA_MBURST_SINGLE,
+        .PeriphBurst = DMA_PBURST_SINGLE,
+    },
+};
+static dma_dev_t tim1_up_dma = {
+    .handle = &tim1_up_dma_handle,
+    .ins = CONFIG_TIM1_UP_DMA_INS,
+    .irq_num = CONFIG_TIM1_UP_DMA_IRQ_NUM,
+    .irq_prio = CONFIG_TIM1_UP_DMA_IRQ_PRIO,
+};
+#endif /* (CONFIG_TIM1_UP_DMA == 1) */
+#if (CONFIG_TIM1_CC_DMA == 1)
+static DMA_HandleTypeDef tim1_cc_dma_handle = {
+    .Instance = CONFIG_TIM1_CC_DMA_STREAM,
+    .Init = {
+        .Channel = CONFIG_TIM1_CC_DMA_CHANNEL,
+        .Direction = DMA_PERIPH_TO_MEMORY,
+        .PeriphInc = DMA_PINC_DISABLE,
+        .MemInc = DMA_MINC_ENABLE,
+        .PeriphDataAlignment = DMA_PDATAALIGN_WORD,
+        .MemDataAlignment = DMA_MDATAALIGN_WORD,
+        .Mode = DMA_NORMAL,
+        .Priority = CONFIG_TIM1_CC_DMA_PRIORITY,
+        .FIFOMode = DMA_FIFOMODE_DISABLE,
+        .FIFOThreshold = DMA_FIFO_THRESHOLD_FULL,
+        .MemBurst = DMA_MBURST_SINGLE,
+        .PeriphBurst = DMA_PBURST_SINGLE,
+    },
+};
+static dma_dev_t tim1_cc_dma = {
+    .handle = &tim1_cc_dma_handle,
+    .ins = CONFIG_TIM1_CC_DMA_INS,
+    .irq_num = CONFIG_TIM1_CC_DMA_IRQ_NUM,
+    .irq_prio = CONFIG_TIM1_CC_DMA_IRQ_PRIO,
+};
+#endif /* (CONFIG_TIM1_CC_DMA == 1) */
+static TIM_HandleTypeDef tim1_handle = {
+    .Instance = TIM1
+};
+static timer_dev_t tim1_dev = {
+    .handle = &tim1_handle,
+    .clock = CONFIG_TIM1_CLK_FREQ,
+    .irq_num = TIM1_UP_TIM10_IRQn,
+    .cc_irq_num = TIM1_CC_IRQn,
+    .irq_prio = CONFIG_TIM1_IRQ_PRIO,
+#if (CONFIG_TIM1_CH1_DEF == 1)
+    .ch_pin[0] = &tim1_ch1_pin,
+#endif /* (CONFIG_TIM1_CH1_DEF == 1) */
+#if (CONFIG_TIM1_CH2_DEF == 1)
+    .ch_pin[1] = &tim1_ch2_pin,
+#endif /* (CONFIG_TIM1_CH2_DEF == 1) */
+#if (CONFIG_TIM1_CH3_DEF == 1)
+    .ch_pin[2] = &tim1_ch3_pin,
+#endif /* (CONFIG_TIM1_CH3_DEF == 1) */
+#if (CONFIG_TIM1_CH4_DEF == 1)
+    .ch_pin[3] = &tim1_ch4_pin,
+#endif /* (CONFIG_TIM1_CH4_DEF == 1) */
+#if (CONFIG_TIM1_UP_DMA == 1)
+    .dma_up = &tim1_up_dma,
+#endif /* (CONFIG_TIM1_UP_DMA == 1) */
+#if (CONFIG_TIM1_CC_DMA == 1)
+    .cc_dma_channel = CONFIG_TIM1_CC_DMA_CH,
+    .dma_cc = &tim1_cc_dma,
+#endif /* (CONFIG_TIM1_CC_DMA == 1) */
+};
+#endif /* TIM1 && (CONFIG_TIMER_NUM_1 == 1) */
+
+#if defined(TIM2) && (CONFIG_TIMER_NUM_2 == 1)
+#if (CONFIG_TIM2_CH1_DEF == 1)
+static gpio_pin_t tim2_ch1_pin = { CONFIG_TIM2_CH1_PORT, CONFIG_TIM2_CH1_PIN, CONFIG_TIM2_CH1_AF };
+#endif /* (CONFIG_TIM2_CH1_DEF == 1) */
+#if (CONFIG_TIM2_CH2_DEF == 1)
+static gpio_pin_t tim2_ch2_pin = { CONFIG_TIM2_CH2_PORT, CONFIG_TIM2_CH2_PIN, CONFIG_TIM2_CH2_AF };
+#endif /* (CONFIG_TIM2_CH2_DEF == 1) */
+#if (CONFIG_TIM2_CH3_DEF == 1)
+static gpio_pin_t tim2_ch3_pin = { CONFIG_TIM2_CH3_PORT, CONFIG_TIM2_CH3_PIN, CONFIG_TIM2_CH3_AF };
+#endif /* (CONFIG_TIM2_CH3_DEF == 1) */
+#if (CONFIG_TIM2_CH4_DEF == 1)
+static gpio_pin_t tim2_ch4_pin = { CONFIG_TIM2_CH4_PORT, CONFIG_TIM2_CH4_PIN, CONFIG_TIM2_CH4_AF };
+#endif /* (CONFIG_TIM2_CH4_DEF == 1) */
+#if (CONFIG_TIM2_UP_DMA == 1)
+static DMA_HandleTypeDef tim2_up_dma_handle = {
+    .Instance = CONFIG_TIM2_UP_DMA_STREAM,
+    .Init = {
+        .Channel = CONFIG_TIM2_UP_DMA_CHANNEL,
+        .Direction = DMA_MEMORY_TO_PERIPH,
+        .PeriphInc = DMA_PINC_DISABLE,
+        .MemInc = DMA_MINC_ENABLE,
+        .PeriphDataAlignment = DMA_PDATAALIGN_WORD,
+        .MemDataAlignment = DMA_MDATAALIGN_WORD,
+        .Mode = DMA_NORMAL,
+        .Priority = CONFIG_TIM2_UP_DMA_PRIORITY,
+        .FIFOMode = DMA_FIFOMODE_DISABLE,
+        .FIFOThreshold = DMA_FIFO_THRESHOLD_FULL,
+        .MemBurst = DMA_MBURST_SINGLE,
+        .PeriphBurst = DMA_PBURST_SINGLE,
+    },
+};
+static dma_dev_t tim2_up_dma = {
+    .handle = &tim2_up_dma_handle,
+    .ins = CONFIG_TIM2_UP_DMA_INS,
+    .irq_num = CONFIG_TIM2_UP_DMA_IRQ_NUM,
+    .irq_prio = CONFIG_TIM2_UP_DMA_IRQ_PRIO,
+};
+#endif /* (CONFIG_TIM2_UP_DMA == 1) */
+#if (CONFIG_TIM2_CC_DMA == 1)
+static DMA_HandleTypeDef tim2_cc_dma_handle = {
+    .Instance = CONFIG_TIM2_CC_DMA_STREAM,
+    .Init = {
+        .Channel = CONFIG_TIM2_CC_DMA_CHANNEL,
+        .Direction = DMA_PERIPH_TO_MEMORY,
+        .PeriphInc = DMA_PINC_DISABLE,
+        .MemInc = DMA_MINC_ENABLE,
+        .PeriphDataAlignment = DMA_PDATAALIGN_WORD,
+        .MemDataAlignment = DMA_MDATAALIGN_WORD,
+        .Mode = DMA_NORMAL,
+        .Priority = CONFIG_TIM2_CC_DMA_PRIORITY,
+        .FIFOMode = DMA_FIFOMODE_DISABLE,
+        .FIFOThreshold = DMA_FIFO_THRESHOLD_FULL,
+        .MemBurst = DMA_MBURST_SINGLE,
+        .PeriphBurst = DMA_PBURST_SINGLE,
+    },
+};
+static dma_dev_t tim2_cc_dma = {
+    .handle = &tim2_cc_dma_handle,
+    .ins = CONFIG_TIM2_CC_DMA_INS,
+    .irq_num = CONFIG_TIM2_CC_DMA_IRQ_NUM,
+    .irq_prio = CONFIG_TIM2_CC_DMA_IRQ_PRIO,
+};
+#endif /* (CONFIG_TIM2_CC_DMA == 1) */
+static TIM_HandleTypeDef tim2_handle = {
+    .Instance = TIM2
+};
+static timer_dev_t tim2_dev = {
+    .handle = &tim2_handle,
+    .clock = CONFIG_TIM2_CLK_FREQ,
+    .irq_num = TIM2_IRQn,
+    .cc_irq_num = TIM2_IRQn,
+    .irq_prio = CONFIG_TIM2_IRQ_PRIO,
+#if (CONFIG_TIM2_CH1_DEF == 1)
+    .ch_pin[0] = &tim2_ch1_pin,
+#endif /* (CONFIG_TIM2_CH1_DEF == 1) */
+#if (CONFIG_TIM2_CH2_DEF == 1)
+    .ch_pin[1] = &tim2_ch2_pin,
+#endif /* (CONFIG_TIM2_CH2_DEF == 1) */
+#if (CONFIG_TIM2_CH3_DEF == 1)
+    .ch_pin[2] = &tim2_ch3_pin,
+#endif /* (CONFIG_TIM2_CH3_DEF == 1) */
+#if (CONFIG_TIM2_CH4_DEF == 1)
+    .ch_pin[3] = &tim2_ch4_pin,
+#endif /* (CONFIG_TIM2_CH4_DEF == 1) */
+#if (CONFIG_TIM2_UP_DMA == 1)
+    .dma_up = &tim2_up_dma,
+#endif /* (CONFIG_TIM2_UP_DMA == 1) */
+#if (CONFIG_TIM2_CC_DMA == 1)
+    .cc_dma_channel = CONFIG_TIM2_CC_DMA_CH,
+    .dma_cc = &tim2_cc_dma,
+#endif /* (CONFIG_TIM2_CC_DMA == 1) */
+};
+#endif /* TIM2 && (CONFIG_TIMER_NUM_2 == 1) */
+
+#if defined(TIM3) && (CONFIG_TIMER_NUM_3 == 1)
+#if (CONFIG_TIM3_CH1_DEF == 1)
+static gpio_pin_t tim3_ch1_pin = { CONFIG_TIM3_CH1_PORT, CONFIG_TIM3_CH1_PIN, CONFIG_TIM3_CH1_AF };
+#endif /* (CONFIG_TIM3_CH1_DEF == 1) */
+#if (CONFIG_TIM3_CH2_DEF == 1)
+static gpio_pin_t tim3_ch2_pin = { CONFIG_TIM3_CH2_PORT, CONFIG_TIM3_CH2_PIN, CONFIG_TIM3_CH2_AF };
+#endif /* (CONFIG_TIM3_CH2_DEF == 1) */
+#if (CONFIG_TIM3_CH3_DEF == 1)
+static gpio_pin_t tim3_ch3_pin = { CONFIG_TIM3_CH3_PORT, CONFIG_TIM3_CH3_PIN, CONFIG_TIM3_CH3_AF };
+#endif /* (CONFIG_TIM3_CH3_DEF == 1) */
+#if (CONFIG_TIM3_CH4_DEF == 1)
+static gpio_pin_t tim3_ch4_pin = { CONFIG_TIM3_CH4_PORT, CONFIG_TIM3_CH4_PIN, CONFIG_TIM3_CH4_AF };
+#endif /* (CONFIG_TIM3_CH4_DEF == 1) */
+#if (CONFIG_TIM3_UP_DMA == 1)
+static DMA_HandleTypeDef tim3_up_dma_handle = {
+    .Instance = CONFIG_TIM3_UP_DMA_STREAM,
+    .Init = {
+        .Channel = CONFIG_TIM3_UP_DMA_CHANNEL,
+        .Direction = DMA_MEMORY_TO_PERIPH,
+        .PeriphInc = DMA_PINC_DISABLE,
+        .MemInc = DMA_MINC_ENABLE,
+        .PeriphDataAlignment = DMA_PDATAALIGN_WORD,
+        .MemDataAlignment = DMA_MDATAALIGN_WORD,
+        .Mode = DMA_NORMAL,
+        .Priority = CONFIG_TIM3_UP_DMA_PRIORITY,
+        .FIFOMode = DMA_FIFOMODE_DISABLE,
+        .FIFOThreshold = DMA_FIFO_THRESHOLD_FULL,
+        .MemBurst = DMA_MBURST_SINGLE,
+        .PeriphBurst = DMA_PBURST_SINGLE,
+    },
+};
+static dma_dev_t tim3_up_dma = {
+    .handle = &tim3_up_dma_handle,
+    .ins = CONFIG_TIM3_UP_DMA_INS,
+    .irq_num = CONFIG_TIM3_UP_DMA_IRQ_NUM,
+    .irq_prio = CONFIG_TIM3_UP_DMA_IRQ_PRIO,
+};
+#endif /* (CONFIG_TIM3_UP_DMA == 1) */
+#if (CONFIG_TIM3_CC_DMA == 1)
+static DMA_HandleTypeDef tim3_cc_dma_handle = {
+    .Instance = CONFIG_TIM3_CC_DMA_STREAM,
+    .Init = {
+        .Channel = CONFIG_TIM3_CC_DMA_CHANNEL,
+        .Direction = DMA_PERIPH_TO_MEMORY,
+        .PeriphInc = DMA_PINC_DISABLE,
+        .MemInc = DMA_MINC_ENABLE,
+        .PeriphDataAlignment = DMA_PDATAALIGN_WORD,
+        .MemDataAlignment = DMA_MDATAALIGN_WORD,
+        .Mode = DMA_NORMAL,
+        .Priority = CONFIG_TIM3_CC_DMA_PRIORITY,
+        .FIFOMode = DMA_FIFOMODE_DISABLE,
+        .FIFOThreshold = DMA_FIFO_THRESHOLD_FULL,
+        .MemBurst = DMA_MBURST_SINGLE,
+        .PeriphBurst = DMA_PBURST_SINGLE,
+    },
+};
+static dma_dev_t tim3_cc_dma = {
+    .handle = &tim3_cc_dma_handle,
+    .ins = CONFIG_TIM3_CC_DMA_INS,
+    .irq_num = CONFIG_TIM3_CC_DMA_IRQ_NUM,
+    .irq_prio = CONFIG_TIM3_CC_DMA_IRQ_PRIO,
+};
+#endif /* (CONFIG_TIM3_CC_DMA == 1) */
+static TIM_HandleTypeDef tim3_handle = {
+    .Instance = TIM3
+};
+static timer_dev_t tim3_dev = {
+    .handle = &tim3_handle,
+    .clock = CONFIG_TIM3_CLK_FREQ,
+    .irq_num = TIM3_IRQn,
+    .cc_irq_num = TIM3_IRQn,
+    .irq_prio = CONFIG_TIM3_IRQ_PRIO,
+#if (CONFIG_TIM3_CH1_DEF == 1)
+    .ch_pin[0] = &tim3_ch1_pin,
+#endif /* (CONFIG_TIM3_CH1_DEF == 1) */
+#if (CONFIG_TIM3_CH2_DEF == 1)
+    .ch_pin[1] = &tim3_ch2_pin,
+#endif /* (CONFIG_TIM3_CH2_DEF == 1) */
+#if (CONFIG_TIM3_CH3_DEF == 1)
+    .ch_pin[2] = &tim3_ch3_pin,
+#endif /* (CONFIG_TIM3_CH3_DEF == 1) */
+#if (CONFIG_TIM3_CH4_DEF == 1)
+    .ch_pin[3] = &tim3_ch4_pin,
+#endif /* (CONFIG_TIM3_CH4_DEF == 1) */
+#if (CONFIG_TIM3_UP_DMA == 1)
+    .dma_up = &tim3_up_dma,
+#endif /* (CONFIG_TIM3_UP_DMA == 1) */
+#if (CONFIG_TIM3_CC_DMA == 1)
+    .cc_dma_channel = CONFIG_TIM3_CC_DMA_CH,
+    .dma_cc = &tim3_cc_dma,
+#endif /* (CONFIG_TIM3_CC_DMA == 1) */
+};
+#endif /* TIM3 && (CONFIG_TIMER_NUM_3 == 1) */
+
+#if defined(TIM4) && (CONFIG_TIMER_NUM_4 == 1)
+#if (CONFIG_TIM4_CH1_DEF == 1)
+static gpio_pin_t tim4_ch1_pin = { CONFIG_TIM4_CH1_PORT, CONFIG_TIM4_CH1_PIN, CONFIG_TIM4_CH1_AF };
+#endif /* (CONFIG_TIM4_CH1_DEF == 1) */
+#if (CONFIG_TIM4_CH2_DEF == 1)
+static gpio_pin_t tim4_ch2_pin = { CONFIG_TIM4_CH2_PORT, CONFIG_TIM4_CH2_PIN, CONFIG_TIM4_CH2_AF };
+#endif /* (CONFIG_TIM4_CH2_DEF == 1) */
+#if (CONFIG_TIM4_CH3_DEF == 1)
+static gpio_pin_t tim4_ch3_pin = { CONFIG_TIM4_CH3_PORT, CONFIG_TIM4_CH3_PIN, CONFIG_TIM4_CH3_AF };
+#endif /* (CONFIG_TIM4_CH3_DEF == 1) */
+#if (CONFIG_TIM4_CH4_DEF == 1)
+static gpio_pin_t tim4_ch4_pin = { CONFIG_TIM4_CH4_PORT, CONFIG_TIM4_CH4_PIN, CONFIG_TIM4_CH4_AF };
+#endif /* (CONFIG_TIM4_CH4_DEF == 1) */
+#if (CONFIG_TIM4_UP_DMA == 1)
+static DMA_HandleTypeDef tim4_up_dma_handle = {
+    .Instance = CONFIG_TIM4_UP_DMA_STREAM,
+    .Init = {
+        .Channel = CONFIG_TIM4_UP_DMA_CHANNEL,
+        .Direction = DMA_MEMORY_TO_PERIPH,
+        .PeriphInc = DMA_PINC_DISABLE,
+        .MemInc = DMA_MINC_ENABLE,
+        .PeriphDataAlignment = DMA_PDATAALIGN_WORD,
+        .MemDataAlignment = DMA_MDATAALIGN_WORD,
+        .Mode = DMA_NORMAL,
+        .Priority = CONFIG_TIM4_UP_DMA_PRIORITY,
+        .FIFOMode = DMA_FIFOMODE_DISABLE,
+        .FIFOThreshold = DMA_FIFO_THRESHOLD_FULL,
+        .MemBurst = DMA_MBURST_SINGLE,
+        .PeriphBurst = DMA_PBURST_SINGLE,
+    },
+};
+static dma_dev_t tim4_up_dma = {
+    .handle = &tim4_up_dma_handle,
+    .ins = CONFIG_TIM4_UP_DMA_INS,
+    .irq_num = CONFIG_TIM4_UP_DMA_IRQ_NUM,
+    .irq_prio = CONFIG_TIM4_UP_DMA_IRQ_PRIO,
+};
+#endif /* (CONFIG_TIM4_UP_DMA == 1) */
+#if (CONFIG_TIM4_CC_DMA == 1)
+static DMA_HandleTypeDef tim4_cc_dma_handle = {
+    .Instance = CONFIG_TIM4_CC_DMA_STREAM,
+    .Init = {
+        .Channel = CONFIG_TIM4_CC_DMA_CHANNEL,
+        .Direction = DMA_PERIPH_TO_MEMORY,
+        .PeriphInc = DMA_PINC_DISABLE,
+        .MemInc = DMA_MINC_ENABLE,
+        .PeriphDataAlignment = DMA_PDATAALIGN_WORD,
+        .MemDataAlignment = DMA_MDATAALIGN_WORD,
+        .Mode = DMA_NORMAL,
+        .Priority = CONFIG_TIM4_CC_DMA_PRIORITY,
+        .FIFOMode = DMA_FIFOMODE_DISABLE,
+        .FIFOThreshold = DMA_FIFO_THRESHOLD_FULL,
+        .MemBurst = DMA_MBURST_SINGLE,
+        .PeriphBurst = DMA_PBURST_SINGLE,
+    },
+};
+static dma_dev_t tim4_cc_dma = {
+    .handle = &tim4_cc_dma_handle,
+    .ins = CONFIG_TIM4_CC_DMA_INS,
+    .irq_num = CONFIG_TIM4_CC_DMA_IRQ_NUM,
+    .irq_prio = CONFIG_TIM4_CC_DMA_IRQ_PRIO,
+};
+#endif /* (CONFIG_TIM4_CC_DMA == 1) */
+static TIM_HandleTypeDef tim4_handle = {
+    .Instance = TIM4
+};
+static timer_dev_t tim4_dev = {
+    .handle = &tim4_handle,
+    .clock = CONFIG_TIM4_CLK_FREQ,
+    .irq_num = TIM4_IRQn,
+    .cc_irq_num = TIM4_IRQn,
+    .irq_prio = CONFIG_TIM4_IRQ_PRIO,
+#if (CONFIG_TIM4_CH1_DEF == 1)
+    .ch_pin[0] = &tim4_ch1_pin,
+#endif /* (CONFIG_TIM4_CH1_DEF == 1) */
+#if (CONFIG_TIM4_CH2_DEF == 1)
+    .ch_pin[1] = &tim4_ch2_pin,
+#endif /* (CONFIG_TIM4_CH2_DEF == 1) */
+#if (CONFIG_TIM4_CH3_DEF == 1)
+    .ch_pin[2] = &tim4_ch3_pin,
+#endif /* (CONFIG_TIM4_CH3_DEF == 1) */
+#if (CONFIG_TIM4_CH4_DEF == 1)
+    .ch_pin[3] = &tim4_ch4_pin,
+#endif /* (CONFIG_TIM4_CH4_DEF == 1) */
+#if (CONFIG_TIM4_UP_DMA == 1)
+    .dma_up = &tim4_up_dma,
+#endif /* (CONFIG_TIM4_UP_DMA == 1) */
+#if (CONFIG_TIM4_CC_DMA == 1)
+    .cc_dma_channel = CONFIG_TIM4_CC_DMA_CH,
+    .dma_cc = &tim4_cc_dma,
+#endif /* (CONFIG_TIM4_CC_DMA == 1) */
+};
+#endif /* TIM4 && (CONFIG_TIMER_NUM_4 == 1) */
+
+#if defined(TIM5) && (CONFIG_TIMER_NUM_5 == 1)
+#if (CONFIG_TIM5_CH1_DEF == 1)
+static gpio_pin_t tim5_ch1_pin = { CONFIG_TIM5_CH1_PORT, CONFIG_TIM5_CH1_PIN, CONFIG_TIM5_CH1_AF };
+#endif /* (CONFIG_TIM5_CH1_DEF == 1) */
+#if (CONFIG_TIM5_CH2_DEF == 1)
+static gpio_pin_t tim5_ch2_pin = { CONFIG_TIM5_CH2_PORT, CONFIG_TIM5_CH2_PIN, CONFIG_TIM5_CH2_AF };
+#endif /* (CONFIG_TIM5_CH2_DEF == 1) */
+#if (CONFIG_TIM5_CH3_DEF == 1)
+static gpio_pin_t tim5_ch3_pin = { CONFIG_TIM5_CH3_PORT, CONFIG_TIM5_CH3_PIN, CONFIG_TIM5_CH3_AF };
+#endif /* (CONFIG_TIM5_CH3_DEF == 1) */
+#if (CONFIG_TIM5_CH4_DEF == 1)
+static gpio_pin_t tim5_ch4_pin = { CONFIG_TIM5_CH4_PORT, CONFIG_TIM5_CH4_PIN, CONFIG_TIM5_CH4_AF };
+#endif /* (CONFIG_TIM5_CH4_DEF == 1) */
+#if (CONFIG_TIM5_UP_DMA == 1)
+static DMA_HandleTypeDef tim5_up_dma_handle = {
+    .Instance = CONFIG_TIM5_UP_DMA_STREAM,
+    .Init = {
+        .Channel = CONFIG_TIM5_UP_DMA_CHANNEL,
+        .Direction = DMA_MEMORY_TO_PERIPH,
+        .PeriphInc = DMA_PINC_DISABLE,
+        .MemInc = DMA_MINC_ENABLE,
+        .PeriphDataAlignment = DMA_PDATAALIGN_WORD,
+        .MemDataAlignment = DMA_MDATAALIGN_WORD,
+        .Mode = DMA_NORMAL,
+        .Priority = CONFIG_TIM5_UP_DMA_PRIORITY,
+        .FIFOMode = DMA_FIFOMODE_DISABLE,
+        .FIFOThreshold = DMA_FIFO_THRESHOLD_FULL,
+        .MemBurst = DMA_MBURST_SINGLE,
+        .PeriphBurst = DMA_PBURST_SINGLE,
+    },
+};
+static dma_dev_t tim5_up_dma = {
+    .handle = &tim5_up_dma_handle,
+    .ins = CONFIG_TIM5_UP_DMA_INS,
+    .irq_num = CONFIG_TIM5_UP_DMA_IRQ_NUM,
+    .irq_prio = CONFIG_TIM5_UP_DMA_IRQ_PRIO,
+};
+#endif /* (CONFIG_TIM5_UP_DMA == 1) */
+#if (CONFIG_TIM5_CC_DMA == 1)
+static DMA_HandleTypeDef tim5_cc_dma_handle = {
+    .Instance = CONFIG_TIM5_CC_DMA_STREAM,
+    .Init = {
+        .Channel = CONFIG_TIM5_CC_DMA_CHANNEL,
+        .Direction = DMA_PERIPH_TO_MEMORY,
+        .PeriphInc = DMA_PINC_DISABLE,
+        .MemInc = DMA_MINC_ENABLE,
+        .PeriphDataAlignment = DMA_PDATAALIGN_WORD,
+        .MemDataAlignment = DMA_MDATAALIGN_WORD,
+        .Mode = DMA_NORMAL,
+        .Priority = CONFIG_TIM5_CC_DMA_PRIORITY,
+        .FIFOMode = DMA_FIFOMODE_DISABLE,
+        .FIFOThreshold = DMA_FIFO_THRESHOLD_FULL,
+        .MemBurst = DMA_MBURST_SINGLE,
+        .PeriphBurst = DMA_PBURST_SINGLE,
+    },
+};
+static dma_dev_t tim5_cc_dma = {
+    .handle = &tim5_cc_dma_handle,
+    .ins = CONFIG_TIM5_CC_DMA_INS,
+    .irq_num = CONFIG_TIM5_CC_DMA_IRQ_NUM,
+    .irq_prio = CONFIG_TIM5_CC_DMA_IRQ_PRIO,
+};
+#endif /* (CONFIG_TIM5_CC_DMA == 1) */
+static TIM_HandleTypeDef tim5_handle = {
+    .Instance = TIM5
+};
+static timer_dev_t tim5_dev = {
+    .handle = &tim5_handle,
+    .clock = CONFIG_TIM5_CLK_FREQ,
+    .irq_num = TIM5_IRQn,
+    .cc_irq_num = TIM5_IRQn,
+    .irq_prio = CONFIG_TIM5_IRQ_PRIO,
+#if (CONFIG_TIM5_CH1_DEF == 1)
+    .ch_pin[0] = &tim5_ch1_pin,
+#endif /* (CONFIG_TIM5_CH1_DEF == 1) */
+#if (CONFIG_TIM5_CH2_DEF == 1)
+    .ch_pin[1] = &tim5_ch2_pin,
+#endif /* (CONFIG_TIM5_CH2_DEF == 1) */
+#if (CONFIG_TIM5_CH3_DEF == 1)
+    .ch_pin[2] = &tim5_ch3_pin,
+#endif /* (CONFIG_TIM5_CH3_DEF == 1) */
+#if (CONFIG_TIM5_CH4_DEF == 1)
+    .ch_pin[3] = &tim5_ch4_pin,
+#endif /* (CONFIG_TIM5_CH4_DEF == 1) */
+#if (CONFIG_TIM5_UP_DMA == 1)
+    .dma_up = &tim5_up_dma,
+#endif /* (CONFIG_TIM5_UP_DMA == 1) */
+#if (CONFIG_TIM5_CC_DMA == 1)
+    .cc_dma_channel = CONFIG_TIM5_CC_DMA_CH,
+    .dma_cc = &tim5_cc_dma,
+#endif /* (CONFIG_TIM5_CC_DMA == 1) */
+};
+#endif /* TIM5 && (CONFIG_TIMER_NUM_5 == 1) */
+
+#if defined(TIM8) && (CONFIG_TIMER_NUM_8 == 1)
+#if (CONFIG_TIM8_CH1_DEF == 1)
+static gpio_pin_t tim8_ch1_pin = { CONFIG_TIM8_CH1_PORT, CONFIG_TIM8_CH1_PIN, CONFIG_TIM8_CH1_AF };
+#endif /* (CONFIG_TIM8_CH1_DEF == 1) */
+#if (CONFIG_TIM8_CH2_DEF == 1)
+static gpio_pin_t tim8_ch2_pin = { CONFIG_TIM8_CH2_PORT, CONFIG_TIM8_CH2_PIN, CONFIG_TIM8_CH2_AF };
+#endif /* (CONFIG_TIM8_CH2_DEF == 1) */
+#if (CONFIG_TIM8_CH3_DEF == 1)
+static gpio_pin_t tim8_ch3_pin = { CONFIG_TIM8_CH3_PORT, CONFIG_TIM8_CH3_PIN, CONFIG_TIM8_CH3_AF };
+#endif /* (CONFIG_TIM8_CH3_DEF == 1) */
+#if (CONFIG_TIM8_CH4_DEF == 1)
+static gpio_pin_t tim8_ch4_pin = { CONFIG_TIM8_CH4_PORT, CONFIG_TIM8_CH4_PIN, CONFIG_TIM8_CH4_AF };
+#endif /* (CONFIG_TIM8_CH4_DEF == 1) */
+#if (CONFIG_TIM8_UP_DMA == 1)
+static DMA_HandleTypeDef tim8_up_dma_handle = {
+    .Instance = CONFIG_TIM8_UP_DMA_STREAM,
+    .Init = {
+        .Channel = CONFIG_TIM8_UP_DMA_CHANNEL,
+        .Direction = DMA_MEMORY_TO_PERIPH,
+        .PeriphInc = DMA_PINC_DISABLE,
+        .MemInc = DMA_MINC_ENABLE,
+        .PeriphDataAlignment = DMA_PDATAALIGN_WORD,
+        .MemDataAlignment = DMA_MDATAALIGN_WORD,
+        .Mode = DMA_NORMAL,
+        .Priority = CONFIG_TIM8_UP_DMA_PRIORITY,
+        .FIFOMode = DMA_FIFOMODE_DISABLE,
+        .FIFOThreshold = DMA_FIFO_THRESHOLD_FULL,
+        .MemBurst = DMA_MBURST_SINGLE,
+        .PeriphBurst = DMA_PBURST_SINGLE,
+    },
+};
+static dma_dev_t tim8_up_dma = {
+    .handle = &tim8_up_dma_handle,
+    .ins = CONFIG_TIM8_UP_DMA_INS,
+    .irq_num = CONFIG_TIM8_UP_DMA_IRQ_NUM,
+    .irq_prio = CONFIG_TIM8_UP_DMA_IRQ_PRIO,
+};
+#endif /* (CONFIG_TIM8_UP_DMA == 1) */
+#if (CONFIG_TIM8_CC_DMA == 1)
+static DMA_HandleTypeDef tim8_cc_dma_handle = {
+    .Instance = CONFIG_TIM8_CC_DMA_STREAM,
+    .Init = {
+        .Channel = CONFIG_TIM8_CC_DMA_CHANNEL,
+        .Direction = DMA_PERIPH_TO_MEMORY,
+        .PeriphInc = DMA_PINC_DISABLE,
+        .MemInc = DMA_MINC_ENABLE,
+        .PeriphDataAlignment = DMA_PDATAALIGN_WORD,
+        .MemDataAlignment = DMA_MDATAALIGN_WORD,
+        .Mode = DMA_NORMAL,
+        .Priority = CONFIG_TIM8_CC_DMA_PRIORITY,
+        .FIFOMode = DMA_FIFOMODE_DISABLE,
+        .FIFOThreshold = DMA_FIFO_THRESHOLD_FULL,
+        .MemBurst = DMA_MBURST_SINGLE,
+        .PeriphBurst = DMA_PBURST_SINGLE,
+    },
+};
+static dma_dev_t tim8_cc_dma = {
+    .handle = &tim8_cc_dma_handle,
+    .ins = CONFIG_TIM8_CC_DMA_INS,
+    .irq_num = CONFIG_TIM8_CC_DMA_IRQ_NUM,
+    .irq_prio = CONFIG_TIM8_CC_DMA_IRQ_PRIO,
+};
+#endif /* (CONFIG_TIM8_CC_DMA == 1) */
+static TIM_HandleTypeDef tim8_handle = {
+    .Instance = TIM8
+};
+static timer_dev_t tim8_dev = {
+    .handle = &tim8_handle,
+    .clock = CONFIG_TIM8_CLK_FREQ,
+    .irq_num = TIM8_UP_TIM13_IRQn,
+    .cc_irq_num = TIM8_CC_IRQn,
+    .irq_prio = CONFIG_TIM8_IRQ_PRIO,
+#if (CONFIG_TIM8_CH1_DEF == 1)
+    .ch_pin[0] = &tim8_ch1_pin,
+#endif /* (CONFIG_TIM8_CH1_DEF == 1) */
+#if (CONFIG_TIM8_CH2_DEF == 1)
+    .ch_pin[1] = &tim8_ch2_pin,
+#endif /* (CONFIG_TIM8_CH2_DEF == 1) */
+#if (CONFIG_TIM8_CH3_DEF == 1)
+    .ch_pin[2] = &tim8_ch3_pin,
+#endif /* (CONFIG_TIM8_CH3_DEF == 1) */
+#if (CONFIG_TIM8_CH4_DEF == 1)
+    .ch_pin[3] = &tim8_ch4_pin,
+#endif /* (CONFIG_TIM8_CH4_DEF == 1) */
+#if (CONFIG_TIM8_UP_DMA == 1)
+    .dma_up = &tim8_up_dma,
+#endif /* (CONFIG_TIM8_UP_DMA == 1) */
+#if (CONFIG_TIM8_CC_DMA == 1)
+    .cc_dma_channel = CONFIG_TIM8_CC_DMA_CH,
+    .dma_cc = &tim8_cc_dma,
+#endif /* (CONFIG_TIM8_CC_DMA == 1) */
+};
+#endif /* TIM8 && (CONFIG_TIMER_NUM_8 == 1) */
+
+/**
+ * @brief Get timer device information
+ * 
+ * @param timer_num Timer number
+ * @return Timer device information
+ */
+timer_dev_t* timer_ll_get_dev(timer_num_t timer_num) {
+    switch (timer_num) {
+#if defined(TIM1) && (CONFIG_TIMER_NUM_1 == 1)
+        case TIMER_NUM_1:
+            return &tim1_dev;
+#endif /* TIM1 && (CONFIG_TIMER_NUM_1 == 1) */
+
+#if defined(TIM2) && (CONFIG_TIMER_NUM_2 == 1)
+        case TIMER_NUM_2:
+            return &tim2_dev;
+#endif /* TIM2 && (CONFIG_TIMER_NUM_2 == 1) */
+
+#if defined(TIM3) && (CONFIG_TIMER_NUM_3 == 1)
+        case TIMER_NUM_3:
+            return &tim3_dev;
+#endif /* TIM3 && (CONFIG_TIMER_NUM_3 == 1) */
+
+#if defined(TIM4) && (CONFIG_TIMER_NUM_4 == 1)
+        case TIMER_NUM_4:
+            return &tim4_dev;
+#endif /* TIM4 && (CONFIG_TIMER_NUM_4 == 1) */
+
+#if defined(TIM5) && (CONFIG_TIMER_NUM_5 == 1)
+        case TIMER_NUM_5:
+            return &tim5_dev;
+#endif /* TIM5 && (CONFIG_TIMER_NUM_5 == 1) */
+
+#if defined(TIM8) && (CONFIG_TIMER_NUM_8 == 1)
+        case TIMER_NUM_8:
+            return &tim8_dev;
+#endif /* TIM8 && (CONFIG_TIMER_NUM_8 == 1) */
+
+        default:
+            return NULL;
+    }
+
+    return NULL;
+}
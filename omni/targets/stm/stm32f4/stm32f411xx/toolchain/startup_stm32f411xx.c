@@ -35,6 +35,14 @@ extern uint32_t _edata;
 extern uint32_t _sidata;
 extern uint32_t _sbss;
 extern uint32_t _ebss;
+extern uint32_t _sifast_code;
+extern uint32_t _sfast_code;
+extern uint32_t _efast_code;
+extern uint32_t _sifast_data;
+extern uint32_t _sfast_data;
+extern uint32_t _efast_data;
+extern uint32_t _somni_dma;
+extern uint32_t _eomni_dma;
 
 extern void __libc_init_array(void);
 #endif /* defined(__ARMCC_VERSION) && (__ARMCC_VERSION >= 6010050) */
@@ -275,6 +283,28 @@ __NO_RETURN void Reset_Handler(void)
         dest += 4;
     }
 
+    /* Copy OMNI_FAST_CODE to ITCM, empty where it runs from flash */
+    src = (uint32_t) &_sifast_code;
+    for (dest = (uint32_t) &_sfast_code; dest < (uint32_t) &_efast_code;) {
+        *(uint32_t *) dest = *(uint32_t *) src;
+        src += 4;
+        dest += 4;
+    }
+
+    /* Copy OMNI_FAST_DATA initializers from flash */
+    src = (uint32_t) &_sifast_data;
+    for (dest = (uint32_t) &_sfast_data; dest < (uint32_t) &_efast_data;) {
+        *(uint32_t *) dest = *(uint32_t *) src;
+        src += 4;
+        dest += 4;
+    }
+
+    /* Zero fill OMNI_DMA_DATA */
+    for (dest = (uint32_t) &_somni_dma; dest < (uint32_t) &_eomni_dma;) {
+        *(uint32_t *) dest = 0;
+        dest += 4;
+    }
+
     SystemInit();                    /* CMSIS System Initialization */
 
     __libc_init_array();             /* Initialize C Library */
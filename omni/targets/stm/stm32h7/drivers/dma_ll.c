@@ -0,0 +1,65 @@
+/**
+  * @file    dma_ll.c
+  * @author  LuckkMaker
+  * @brief   Low-level DMA configuration
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "ll/dma_ll.h"
+
+static const dma_hal_stream_t dma_ll_streams[DMA_LL_STREAM_NUM] = {
+    { DMA1_Stream0, DMA1, DMA1_Stream0_IRQn },
+    { DMA1_Stream1, DMA1, DMA1_Stream1_IRQn },
+    { DMA1_Stream2, DMA1, DMA1_Stream2_IRQn },
+    { DMA1_Stream3, DMA1, DMA1_Stream3_IRQn },
+    { DMA1_Stream4, DMA1, DMA1_Stream4_IRQn },
+    { DMA1_Stream5, DMA1, DMA1_Stream5_IRQn },
+    { DMA1_Stream6, DMA1, DMA1_Stream6_IRQn },
+    { DMA1_Stream7, DMA1, DMA1_Stream7_IRQn },
+    { DMA2_Stream0, DMA2, DMA2_Stream0_IRQn },
+    { DMA2_Stream1, DMA2, DMA2_Stream1_IRQn },
+    { DMA2_Stream2, DMA2, DMA2_Stream2_IRQn },
+    { DMA2_Stream3, DMA2, DMA2_Stream3_IRQn },
+    { DMA2_Stream4, DMA2, DMA2_Stream4_IRQn },
+    { DMA2_Stream5, DMA2, DMA2_Stream5_IRQn },
+    { DMA2_Stream6, DMA2, DMA2_Stream6_IRQn },
+    { DMA2_Stream7, DMA2, DMA2_Stream7_IRQn },
+};
+
+/**
+ * @brief Get DMA stream table
+ *
+ * @return Pointer to DMA_LL_STREAM_NUM streams
+ */
+const dma_hal_stream_t* dma_ll_get_streams(void) {
+    return dma_ll_streams;
+}
+
+/**
+ * @brief Get DMA request mapping
+ *
+ * @param num Number of entries
+ * @return Pointer to mapping
+ */
+const dma_hal_map_t* dma_ll_get_map(uint32_t *num) {
+    // DMAMUX routes any request to any stream
+    *num = 0;
+
+    return NULL;
+}
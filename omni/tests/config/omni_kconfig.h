@@ -0,0 +1,38 @@
+/**
+  * @file    omni_kconfig.h
+  * @author  LuckkMaker
+  * @brief   Fixed configuration of the host tests
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/**
+ * Stands in for the header kconfig.py generates, the host tests are built
+ * without Kconfig. Keep it to symbols the posix target can build.
+ */
+
+#define CONFIG_OMNI_DRIVER 1
+#define CONFIG_OMNI_DRIVER_GPIO 1
+#define CONFIG_GPIO_IRQ 1
+#define CONFIG_GPIO_IRQ_EVENT_NUM 16
+#define CONFIG_GPIO_IRQ_PRIO 5
+#define CONFIG_OMNI_DRIVER_TIMER 1
+#define CONFIG_TIMER_HARDWARE 1
+#define CONFIG_OMNI_DRIVER_USART 1
+#define CONFIG_OMNI_DRIVER_SPI 1
+#define CONFIG_OMNI_DRIVER_I2C 1
+#define CONFIG_IRQ_STATS 1
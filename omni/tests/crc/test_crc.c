@@ -0,0 +1,226 @@
+/**
+  * @file    test_crc.c
+  * @author  LuckkMaker
+  * @brief   Tests of the CRC component table code
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "omni_test.h"
+#include "crc/crc.h"
+
+// Built twice, as test_crc with CONFIG_CRC_SLICE_BY_8 and as
+// test_crc_bytewise without it
+
+#define CRC_DATA_LEN        300U
+
+/**
+ * @brief Model and its check value, the CRC of "123456789"
+ */
+typedef struct crc_check {
+    const char *name;
+    crc_model_t model;
+    uint32_t check;
+} crc_check_t;
+
+static const uint8_t crc_check_data[] = "123456789";
+
+// Odd widths from the CRC catalogue, LSB and MSB first
+static const crc_check_t crc_odd_models[] = {
+    { "CRC-3/ROHC",      { 3, 0x3U, 0x7U, true, true, 0x0U }, 0x6U },
+    { "CRC-3/GSM",       { 3, 0x3U, 0x0U, false, false, 0x7U }, 0x4U },
+    { "CRC-5/USB",       { 5, 0x05U, 0x1FU, true, true, 0x1FU }, 0x19U },
+    { "CRC-5/EPC-C1G2",  { 5, 0x09U, 0x09U, false, false, 0x00U }, 0x00U },
+    { "CRC-12/DECT",     { 12, 0x80FU, 0x000U, false, false, 0x000U }, 0xF5BU },
+    { "CRC-12/UMTS",     { 12, 0x80FU, 0x000U, false, true, 0x000U }, 0xDAFU },
+    { "CRC-24/OPENPGP",  { 24, 0x864CFBU, 0xB704CEU, false, false, 0x000000U }, 0x21CF02U },
+    { "CRC-24/BLE",      { 24, 0x00065BU, 0x555555U, true, true, 0x000000U }, 0xC25A56U },
+};
+
+static crc_table_t table;
+static uint8_t data[CRC_DATA_LEN];
+static uint32_t rand_state = 1;
+
+static uint32_t test_rand(void) {
+    rand_state = (rand_state * 1103515245U) + 12345U;
+
+    return rand_state >> 8;
+}
+
+/**
+ * @brief Bit at a time reference, straight from the model parameters
+ */
+static uint32_t crc_reference(const crc_model_t *model, const uint8_t *buf, uint32_t len) {
+    uint32_t top = 1UL << (model->width - 1U);
+    uint32_t mask = (model->width == 32U) ? 0xFFFFFFFFU : ((1UL << model->width) - 1U);
+    uint32_t value = model->init;
+
+    for (uint32_t i = 0; i < len; i++) {
+        for (uint32_t bit = 0; bit < 8U; bit++) {
+            uint32_t in = model->reflect_in ? ((buf[i] >> bit) & 1U) : ((buf[i] >> (7U - bit)) & 1U);
+            bool feedback = (((value & top) != 0U) ? 1U : 0U) != in;
+
+            value = (value << 1) & mask;
+            if (feedback) {
+                value ^= model->poly;
+            }
+        }
+    }
+
+    if (model->reflect_out) {
+        uint32_t out = 0;
+
+        for (uint32_t bit = 0; bit < model->width; bit++) {
+            out |= ((value >> bit) & 1U) << (model->width - 1U - bit);
+        }
+        value = out;
+    }
+
+    return (value ^ model->xor_out) & mask;
+}
+
+/**
+ * @brief Check value of a model, from the table code and the reference
+ */
+static void crc_check_model(const crc_model_t *model, uint32_t check) {
+    uint32_t value = 0;
+
+    TEST_ASSERT(crc.init_table(model, &table) == OMNI_OK);
+    TEST_ASSERT(crc.compute(model, &table, crc_check_data, 9U, &value) == OMNI_OK);
+    TEST_ASSERT_EQUAL(check, value);
+    TEST_ASSERT_EQUAL(check, crc_reference(model, crc_check_data, 9U));
+}
+
+/**
+ * @brief One-shot, split and incremental updates of a model against the
+ *        reference, table built by the caller
+ */
+static void crc_check_split(const crc_model_t *model) {
+    crc_ctx_t ctx;
+    uint32_t one_shot = 0;
+
+    for (uint32_t i = 0; i < CRC_DATA_LEN; i++) {
+        data[i] = (uint8_t)test_rand();
+    }
+
+    TEST_ASSERT(crc.init_table(model, &table) == OMNI_OK);
+
+    // Every length from the start, covers every tail after the 8 byte steps
+    for (uint32_t len = 0; len <= 40U; len++) {
+        TEST_ASSERT(crc.compute(model, &table, data, len, &one_shot) == OMNI_OK);
+        TEST_ASSERT_EQUAL(crc_reference(model, data, len), one_shot);
+    }
+
+    TEST_ASSERT(crc.compute(model, &table, data, CRC_DATA_LEN, &one_shot) == OMNI_OK);
+    TEST_ASSERT_EQUAL(crc_reference(model, data, CRC_DATA_LEN), one_shot);
+
+    // Two updates, split at every offset
+    for (uint32_t split = 0; split <= CRC_DATA_LEN; split++) {
+        TEST_ASSERT(crc.start(&ctx, model, &table) == OMNI_OK);
+        TEST_ASSERT(crc.update(&ctx, data, split) == OMNI_OK);
+        TEST_ASSERT(crc.update(&ctx, &data[split], CRC_DATA_LEN - split) == OMNI_OK);
+        TEST_ASSERT_EQUAL(one_shot, crc.finish(&ctx));
+    }
+
+    // Random pieces, finish after each one leaves the context running
+    for (uint32_t run = 0; run < 50U; run++) {
+        uint32_t offset = 0;
+
+        TEST_ASSERT(crc.start(&ctx, model, &table) == OMNI_OK);
+        while (offset < CRC_DATA_LEN) {
+            uint32_t piece = test_rand() % 20U;
+
+            if (piece > (CRC_DATA_LEN - offset)) {
+                piece = CRC_DATA_LEN - offset;
+            }
+
+            TEST_ASSERT(crc.update(&ctx, &data[offset], piece) == OMNI_OK);
+            offset += piece;
+            TEST_ASSERT_EQUAL(crc_reference(model, data, offset), crc.finish(&ctx));
+        }
+
+        TEST_ASSERT_EQUAL(one_shot, crc.finish(&ctx));
+    }
+}
+
+/**
+ * @brief Check values of the built-in models
+ */
+static void test_crc_builtin(void) {
+    crc_check_model(&crc_model_8, 0xF4U);
+    crc_check_model(&crc_model_8_maxim, 0xA1U);
+    crc_check_model(&crc_model_16_ccitt, 0x29B1U);
+    crc_check_model(&crc_model_16_xmodem, 0x31C3U);
+    crc_check_model(&crc_model_16_modbus, 0x4B37U);
+    crc_check_model(&crc_model_32, 0xCBF43926U);
+    crc_check_model(&crc_model_32c, 0xE3069283U);
+    crc_check_model(&crc_model_32_mpeg2, 0x0376E6E7U);
+}
+
+/**
+ * @brief Check values of widths 3, 5, 12 and 24
+ */
+static void test_crc_odd_width(void) {
+    for (uint32_t i = 0; i < (sizeof(crc_odd_models) / sizeof(crc_odd_models[0])); i++) {
+        crc_check_model(&crc_odd_models[i].model, crc_odd_models[i].check);
+    }
+}
+
+/**
+ * @brief Split and incremental updates of every model
+ */
+static void test_crc_split(void) {
+    crc_check_split(&crc_model_8);
+    crc_check_split(&crc_model_8_maxim);
+    crc_check_split(&crc_model_16_ccitt);
+    crc_check_split(&crc_model_16_modbus);
+    crc_check_split(&crc_model_32);
+    crc_check_split(&crc_model_32_mpeg2);
+
+    for (uint32_t i = 0; i < (sizeof(crc_odd_models) / sizeof(crc_odd_models[0])); i++) {
+        crc_check_split(&crc_odd_models[i].model);
+    }
+}
+
+/**
+ * @brief Invalid widths, and no table without a CRC unit
+ */
+static void test_crc_invalid(void) {
+    crc_model_t model = crc_model_32;
+    crc_ctx_t ctx;
+
+    model.width = 0;
+    TEST_ASSERT(crc.init_table(&model, &table) == OMNI_FAIL);
+    TEST_ASSERT(crc.start(&ctx, &model, &table) == OMNI_FAIL);
+
+    model.width = 33;
+    TEST_ASSERT(crc.init_table(&model, &table) == OMNI_FAIL);
+    TEST_ASSERT(crc.start(&ctx, &model, &table) == OMNI_FAIL);
+
+    TEST_ASSERT(crc.start(&ctx, &crc_model_32, NULL) == OMNI_FAIL);
+}
+
+int main(void) {
+    TEST_RUN(test_crc_builtin);
+    TEST_RUN(test_crc_odd_width);
+    TEST_RUN(test_crc_split);
+    TEST_RUN(test_crc_invalid);
+
+    TEST_EXIT();
+}
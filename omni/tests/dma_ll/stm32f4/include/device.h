@@ -0,0 +1,144 @@
+/**
+  * @file    device.h
+  * @author  LuckkMaker
+  * @brief   Stand-in STM32F4 device header of the DMA map test
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef OMNI_INC_DEVICE_H
+#define OMNI_INC_DEVICE_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Just enough of STM32F407 for ll/dma_ll.h and hal/dma_hal.h, with the
+ * addresses and IRQ numbers of RM0090. Registers are never accessed.
+ */
+
+typedef enum {
+    DMA1_Stream0_IRQn = 11,
+    DMA1_Stream1_IRQn = 12,
+    DMA1_Stream2_IRQn = 13,
+    DMA1_Stream3_IRQn = 14,
+    DMA1_Stream4_IRQn = 15,
+    DMA1_Stream5_IRQn = 16,
+    DMA1_Stream6_IRQn = 17,
+    DMA1_Stream7_IRQn = 47,
+    DMA2_Stream0_IRQn = 56,
+    DMA2_Stream1_IRQn = 57,
+    DMA2_Stream2_IRQn = 58,
+    DMA2_Stream3_IRQn = 59,
+    DMA2_Stream4_IRQn = 60,
+    DMA2_Stream5_IRQn = 68,
+    DMA2_Stream6_IRQn = 69,
+    DMA2_Stream7_IRQn = 70,
+} IRQn_Type;
+
+typedef struct {
+    volatile uint32_t CR;
+    volatile uint32_t NDTR;
+    volatile uint32_t PAR;
+    volatile uint32_t M0AR;
+    volatile uint32_t M1AR;
+    volatile uint32_t FCR;
+} DMA_Stream_TypeDef;
+
+typedef struct {
+    volatile uint32_t LISR;
+    volatile uint32_t HISR;
+    volatile uint32_t LIFCR;
+    volatile uint32_t HIFCR;
+} DMA_TypeDef;
+
+typedef struct {
+    uint32_t Channel;
+} DMA_InitTypeDef;
+
+typedef struct {
+    DMA_Stream_TypeDef *Instance;
+    DMA_InitTypeDef Init;
+} DMA_HandleTypeDef;
+
+typedef const struct dma_dev {
+    DMA_HandleTypeDef *handle;
+} dma_dev_t;
+
+#define DMA1_BASE                   0x40026000UL
+#define DMA2_BASE                   0x40026400UL
+
+#define DMA1                        ((DMA_TypeDef *)DMA1_BASE)
+#define DMA2                        ((DMA_TypeDef *)DMA2_BASE)
+
+#define DMA1_Stream0                ((DMA_Stream_TypeDef *)(DMA1_BASE + 0x010UL))
+#define DMA1_Stream1                ((DMA_Stream_TypeDef *)(DMA1_BASE + 0x028UL))
+#define DMA1_Stream2                ((DMA_Stream_TypeDef *)(DMA1_BASE + 0x040UL))
+#define DMA1_Stream3                ((DMA_Stream_TypeDef *)(DMA1_BASE + 0x058UL))
+#define DMA1_Stream4                ((DMA_Stream_TypeDef *)(DMA1_BASE + 0x070UL))
+#define DMA1_Stream5                ((DMA_Stream_TypeDef *)(DMA1_BASE + 0x088UL))
+#define DMA1_Stream6                ((DMA_Stream_TypeDef *)(DMA1_BASE + 0x0A0UL))
+#define DMA1_Stream7                ((DMA_Stream_TypeDef *)(DMA1_BASE + 0x0B8UL))
+#define DMA2_Stream0                ((DMA_Stream_TypeDef *)(DMA2_BASE + 0x010UL))
+#define DMA2_Stream1                ((DMA_Stream_TypeDef *)(DMA2_BASE + 0x028UL))
+#define DMA2_Stream2                ((DMA_Stream_TypeDef *)(DMA2_BASE + 0x040UL))
+#define DMA2_Stream3                ((DMA_Stream_TypeDef *)(DMA2_BASE + 0x058UL))
+#define DMA2_Stream4                ((DMA_Stream_TypeDef *)(DMA2_BASE + 0x070UL))
+#define DMA2_Stream5                ((DMA_Stream_TypeDef *)(DMA2_BASE + 0x088UL))
+#define DMA2_Stream6                ((DMA_Stream_TypeDef *)(DMA2_BASE + 0x0A0UL))
+#define DMA2_Stream7                ((DMA_Stream_TypeDef *)(DMA2_BASE + 0x0B8UL))
+
+#define TIM1                        ((void *)0x40010000UL)
+#define TIM2                        ((void *)0x40000000UL)
+#define TIM8                        ((void *)0x40010400UL)
+#define SPI1                        ((void *)0x40013000UL)
+#define SPI2                        ((void *)0x40003800UL)
+#define SPI3                        ((void *)0x40003C00UL)
+#define USART1                      ((void *)0x40011000UL)
+#define USART2                      ((void *)0x40004400UL)
+#define USART3                      ((void *)0x40004800UL)
+#define UART4                       ((void *)0x40004C00UL)
+#define UART5                       ((void *)0x40005000UL)
+#define USART6                      ((void *)0x40011400UL)
+#define I2C1                        ((void *)0x40005400UL)
+#define I2C2                        ((void *)0x40005800UL)
+#define I2C3                        ((void *)0x40005C00UL)
+#define ADC1                        ((void *)0x40012000UL)
+#define ADC2                        ((void *)0x40012100UL)
+#define ADC3                        ((void *)0x40012200UL)
+
+// CHSEL field of DMA_SxCR
+#define DMA_CHANNEL_0               0x00000000U
+#define DMA_CHANNEL_1               0x02000000U
+#define DMA_CHANNEL_2               0x04000000U
+#define DMA_CHANNEL_3               0x06000000U
+#define DMA_CHANNEL_4               0x08000000U
+#define DMA_CHANNEL_5               0x0A000000U
+#define DMA_CHANNEL_6               0x0C000000U
+#define DMA_CHANNEL_7               0x0E000000U
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* OMNI_INC_DEVICE_H */
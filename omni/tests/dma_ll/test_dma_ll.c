@@ -0,0 +1,195 @@
+/**
+  * @file    test_dma_ll.c
+  * @author  LuckkMaker
+  * @brief   Tests of the STM32F4 DMA stream table and request mapping
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "omni_test.h"
+#include "ll/dma_ll.h"
+
+/**
+ * @brief Request of the reference table
+ */
+typedef struct test_request {
+    const void *periph;
+    dma_hal_dir_t dir;
+    uint8_t dma;
+    uint8_t stream;
+    uint8_t channel;
+} test_request_t;
+
+// DMA1 and DMA2 request mapping of RM0090 for the requests of the omni
+// drivers, written down independently of the table in dma_ll.c
+static const test_request_t test_requests[] = {
+    { SPI1,   DMA_HAL_DIR_TX, 2, 3, 3 },
+    { SPI1,   DMA_HAL_DIR_TX, 2, 5, 3 },
+    { SPI1,   DMA_HAL_DIR_RX, 2, 0, 3 },
+    { SPI1,   DMA_HAL_DIR_RX, 2, 2, 3 },
+    { USART1, DMA_HAL_DIR_TX, 2, 7, 4 },
+    { USART1, DMA_HAL_DIR_RX, 2, 2, 4 },
+    { USART1, DMA_HAL_DIR_RX, 2, 5, 4 },
+    { USART2, DMA_HAL_DIR_TX, 1, 6, 4 },
+    { USART2, DMA_HAL_DIR_RX, 1, 5, 4 },
+    { USART3, DMA_HAL_DIR_TX, 1, 3, 4 },
+    { USART3, DMA_HAL_DIR_TX, 1, 4, 7 },
+    { USART3, DMA_HAL_DIR_RX, 1, 1, 4 },
+    { UART4,  DMA_HAL_DIR_TX, 1, 4, 4 },
+    { UART4,  DMA_HAL_DIR_RX, 1, 2, 4 },
+    { UART5,  DMA_HAL_DIR_TX, 1, 7, 4 },
+    { UART5,  DMA_HAL_DIR_RX, 1, 0, 4 },
+    { USART6, DMA_HAL_DIR_TX, 2, 6, 5 },
+    { USART6, DMA_HAL_DIR_TX, 2, 7, 5 },
+    { USART6, DMA_HAL_DIR_RX, 2, 1, 5 },
+    { USART6, DMA_HAL_DIR_RX, 2, 2, 5 },
+    { I2C1,   DMA_HAL_DIR_TX, 1, 6, 1 },
+    { I2C1,   DMA_HAL_DIR_TX, 1, 7, 1 },
+    { I2C1,   DMA_HAL_DIR_RX, 1, 0, 1 },
+    { I2C1,   DMA_HAL_DIR_RX, 1, 5, 1 },
+    { I2C2,   DMA_HAL_DIR_TX, 1, 7, 7 },
+    { I2C2,   DMA_HAL_DIR_RX, 1, 2, 7 },
+    { I2C2,   DMA_HAL_DIR_RX, 1, 3, 7 },
+    { I2C3,   DMA_HAL_DIR_TX, 1, 4, 3 },
+    { I2C3,   DMA_HAL_DIR_RX, 1, 2, 3 },
+    { ADC1,   DMA_HAL_DIR_RX, 2, 0, 0 },
+    { ADC1,   DMA_HAL_DIR_RX, 2, 4, 0 },
+    { ADC2,   DMA_HAL_DIR_RX, 2, 2, 1 },
+    { ADC2,   DMA_HAL_DIR_RX, 2, 3, 1 },
+    { ADC3,   DMA_HAL_DIR_RX, 2, 0, 2 },
+    { ADC3,   DMA_HAL_DIR_RX, 2, 1, 2 },
+};
+
+#define TEST_REQUEST_NUM    (sizeof(test_requests) / sizeof(test_requests[0]))
+
+/**
+ * @brief Number of map entries matching a request
+ */
+static uint32_t test_map_count(const void *periph, dma_hal_dir_t dir, uint32_t stream, uint32_t channel) {
+    const dma_hal_map_t *map;
+    uint32_t num;
+    uint32_t count = 0;
+
+    map = dma_ll_get_map(&num);
+    for (uint32_t i = 0; i < num; i++) {
+        if ((map[i].periph == periph) && (map[i].dir == dir) &&
+            (map[i].stream == stream) && (map[i].channel == channel)) {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+/**
+ * @brief Number of map entries of a peripheral
+ */
+static uint32_t test_map_periph(const void *periph) {
+    const dma_hal_map_t *map;
+    uint32_t num;
+    uint32_t count = 0;
+
+    map = dma_ll_get_map(&num);
+    for (uint32_t i = 0; i < num; i++) {
+        if (map[i].periph == periph) {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+/**
+ * @brief Stream indexes follow DMA1 streams 0..7, DMA2 streams 0..7
+ */
+static void test_dma_ll_streams(void) {
+    static const IRQn_Type irqs[DMA_LL_STREAM_NUM] = {
+        DMA1_Stream0_IRQn, DMA1_Stream1_IRQn, DMA1_Stream2_IRQn, DMA1_Stream3_IRQn,
+        DMA1_Stream4_IRQn, DMA1_Stream5_IRQn, DMA1_Stream6_IRQn, DMA1_Stream7_IRQn,
+        DMA2_Stream0_IRQn, DMA2_Stream1_IRQn, DMA2_Stream2_IRQn, DMA2_Stream3_IRQn,
+        DMA2_Stream4_IRQn, DMA2_Stream5_IRQn, DMA2_Stream6_IRQn, DMA2_Stream7_IRQn,
+    };
+    const dma_hal_stream_t *streams = dma_ll_get_streams();
+
+    for (uint32_t i = 0; i < DMA_LL_STREAM_NUM; i++) {
+        uintptr_t base = (i < 8U) ? DMA1_BASE : DMA2_BASE;
+
+        TEST_ASSERT_EQUAL(base + 0x10U + (0x18U * (i & 0x7U)), (uintptr_t)streams[i].ins);
+        TEST_ASSERT_EQUAL(base, (uintptr_t)streams[i].dma);
+        TEST_ASSERT_EQUAL(irqs[i], streams[i].irq_num);
+    }
+}
+
+/**
+ * @brief Every request of the reference table is mapped exactly once
+ */
+static void test_dma_ll_mapped(void) {
+    for (uint32_t i = 0; i < TEST_REQUEST_NUM; i++) {
+        const test_request_t *req = &test_requests[i];
+        uint32_t stream = (req->dma == 1U) ? req->stream : (8U + req->stream);
+        uint32_t channel = DMA_CHANNEL_1 * req->channel;
+
+        if (test_map_count(req->periph, req->dir, stream, channel) != 1U) {
+            printf("  DMA%u stream %u channel %u, request %u\n",
+                   req->dma, req->stream, req->channel, (unsigned)i);
+        }
+        TEST_ASSERT_EQUAL(1, test_map_count(req->periph, req->dir, stream, channel));
+    }
+}
+
+/**
+ * @brief The map holds nothing beyond the reference table
+ */
+static void test_dma_ll_no_extra(void) {
+    const dma_hal_map_t *map;
+    uint32_t num;
+
+    map = dma_ll_get_map(&num);
+    TEST_ASSERT_EQUAL(TEST_REQUEST_NUM, num);
+
+    for (uint32_t i = 0; i < num; i++) {
+        TEST_ASSERT(map[i].stream < DMA_LL_STREAM_NUM);
+        TEST_ASSERT_EQUAL(0, map[i].channel & ~DMA_CHANNEL_7);
+    }
+}
+
+/**
+ * @brief Requests outside the mapping, timers and peripherals without a
+ *        driver DMA option, have no entry and are not checked by the HAL
+ */
+static void test_dma_ll_unmapped(void) {
+    TEST_ASSERT_EQUAL(0, test_map_periph(TIM1));
+    TEST_ASSERT_EQUAL(0, test_map_periph(TIM2));
+    TEST_ASSERT_EQUAL(0, test_map_periph(TIM8));
+    TEST_ASSERT_EQUAL(0, test_map_periph(SPI2));
+    TEST_ASSERT_EQUAL(0, test_map_periph(SPI3));
+
+    // A mapped peripheral on a stream or channel it is not wired to
+    TEST_ASSERT_EQUAL(0, test_map_count(USART1, DMA_HAL_DIR_TX, 8U + 6U, DMA_CHANNEL_4));
+    TEST_ASSERT_EQUAL(0, test_map_count(USART1, DMA_HAL_DIR_TX, 8U + 7U, DMA_CHANNEL_5));
+    TEST_ASSERT_EQUAL(0, test_map_count(SPI1, DMA_HAL_DIR_RX, 8U + 3U, DMA_CHANNEL_3));
+}
+
+int main(void) {
+    TEST_RUN(test_dma_ll_streams);
+    TEST_RUN(test_dma_ll_mapped);
+    TEST_RUN(test_dma_ll_no_extra);
+    TEST_RUN(test_dma_ll_unmapped);
+
+    TEST_EXIT();
+}
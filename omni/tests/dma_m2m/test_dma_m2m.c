@@ -0,0 +1,195 @@
+/**
+  * @file    test_dma_m2m.c
+  * @author  LuckkMaker
+  * @brief   Tests of the memory to memory DMA transfer split
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "omni_test.h"
+#include "hal/dma_m2m.h"
+
+#define M2M_RUNS            20000U
+
+static uint32_t rand_state = 1;
+
+static uint32_t test_rand(void) {
+    rand_state = (rand_state * 1103515245U) + 12345U;
+
+    return rand_state >> 8;
+}
+
+/**
+ * @brief Split an entry, then run its DMA part chunk by chunk
+ *
+ * @note Checks that head, chunks and tail cover the entry exactly, that
+ *       the DMA part is aligned and that no chunk exceeds the NDTR.
+ */
+static void m2m_check(uintptr_t dst, uint32_t len, uint32_t align, dma_m2m_mode_t mode) {
+    uint32_t head;
+    uint32_t tail;
+    uint32_t dma_len = dma_m2m_split(dst, len, align, &head, &tail);
+    uintptr_t pos = dst + head;
+    uint32_t left = dma_len;
+
+    TEST_ASSERT_EQUAL(len, head + dma_len + tail);
+
+    if (dma_len == 0U) {
+        TEST_ASSERT_EQUAL(len, head);
+        TEST_ASSERT_EQUAL(0, tail);
+        return;
+    }
+
+    TEST_ASSERT(head < align);
+    TEST_ASSERT(tail < align);
+    TEST_ASSERT_EQUAL(0, pos & (align - 1U));
+    TEST_ASSERT_EQUAL(0, dma_len & (align - 1U));
+
+    while (left > 0U) {
+        uint32_t count;
+        uint32_t chunk = dma_m2m_chunk(mode, left, &count);
+
+        TEST_ASSERT(chunk > 0U);
+        TEST_ASSERT(chunk <= left);
+        TEST_ASSERT(count <= DMA_M2M_NDTR_MAX);
+        TEST_ASSERT_EQUAL(chunk, (mode == DMA_M2M_MODE_WORD) ? (count * 4U) : count);
+        if (mode != DMA_M2M_MODE_PORT) {
+            // Every chunk starts on a word
+            TEST_ASSERT_EQUAL(0, chunk & 0x3U);
+        }
+
+        pos += chunk;
+        left -= chunk;
+    }
+
+    TEST_ASSERT_EQUAL(dst + len - tail, pos);
+}
+
+/**
+ * @brief Unaligned head and tail around an aligned middle
+ */
+static void test_m2m_head_tail(void) {
+    uint32_t head;
+    uint32_t tail;
+
+    TEST_ASSERT_EQUAL(64, dma_m2m_split(0x24000000U, 64, 32, &head, &tail));
+    TEST_ASSERT_EQUAL(0, head);
+    TEST_ASSERT_EQUAL(0, tail);
+
+    TEST_ASSERT_EQUAL(64, dma_m2m_split(0x24000001U, 100, 32, &head, &tail));
+    TEST_ASSERT_EQUAL(31, head);
+    TEST_ASSERT_EQUAL(5, tail);
+
+    TEST_ASSERT_EQUAL(96, dma_m2m_split(0x24000000U, 127, 32, &head, &tail));
+    TEST_ASSERT_EQUAL(0, head);
+    TEST_ASSERT_EQUAL(31, tail);
+
+    TEST_ASSERT_EQUAL(8, dma_m2m_split(0x20000003U, 12, 4, &head, &tail));
+    TEST_ASSERT_EQUAL(1, head);
+    TEST_ASSERT_EQUAL(3, tail);
+}
+
+/**
+ * @brief Entries without an aligned block are copied by the CPU
+ */
+static void test_m2m_short(void) {
+    uint32_t head;
+    uint32_t tail;
+
+    for (uint32_t len = 0; len < 4U; len++) {
+        for (uint32_t offset = 0; offset < 4U; offset++) {
+            TEST_ASSERT_EQUAL(0, dma_m2m_split(0x20000000U + offset, len, 4, &head, &tail));
+            TEST_ASSERT_EQUAL(len, head);
+            TEST_ASSERT_EQUAL(0, tail);
+        }
+    }
+
+    // Head alone reaches the end
+    TEST_ASSERT_EQUAL(0, dma_m2m_split(0x24000001U, 31, 32, &head, &tail));
+    // Head and tail meet on the boundary
+    TEST_ASSERT_EQUAL(0, dma_m2m_split(0x24000010U, 40, 32, &head, &tail));
+    TEST_ASSERT_EQUAL(40, head);
+    TEST_ASSERT_EQUAL(0, tail);
+}
+
+/**
+ * @brief Chunks are capped at the NDTR, packed bytes at a word multiple
+ */
+static void test_m2m_chunk_limits(void) {
+    uint32_t count;
+
+    TEST_ASSERT_EQUAL(0xFFFFU, dma_m2m_chunk(DMA_M2M_MODE_PORT, 0xFFFFU, &count));
+    TEST_ASSERT_EQUAL(0xFFFFU, count);
+    TEST_ASSERT_EQUAL(0xFFFFU, dma_m2m_chunk(DMA_M2M_MODE_PORT, 0x10000U, &count));
+    TEST_ASSERT_EQUAL(1, dma_m2m_chunk(DMA_M2M_MODE_PORT, 1, &count));
+
+    TEST_ASSERT_EQUAL(0x3FFFCU, dma_m2m_chunk(DMA_M2M_MODE_WORD, 0x3FFFCU, &count));
+    TEST_ASSERT_EQUAL(0xFFFFU, count);
+    TEST_ASSERT_EQUAL(0x3FFFCU, dma_m2m_chunk(DMA_M2M_MODE_WORD, 0x40000U, &count));
+    TEST_ASSERT_EQUAL(0xFFFFU, count);
+    TEST_ASSERT_EQUAL(4, dma_m2m_chunk(DMA_M2M_MODE_WORD, 4, &count));
+    TEST_ASSERT_EQUAL(1, count);
+
+    TEST_ASSERT_EQUAL(0xFFFCU, dma_m2m_chunk(DMA_M2M_MODE_PACK, 0xFFFCU, &count));
+    TEST_ASSERT_EQUAL(0xFFFCU, dma_m2m_chunk(DMA_M2M_MODE_PACK, 0x10000U, &count));
+    TEST_ASSERT_EQUAL(0xFFFCU, count);
+    TEST_ASSERT_EQUAL(0xFFFCU, dma_m2m_chunk(DMA_M2M_MODE_PACK, 0xFFFFU + 1U, &count));
+}
+
+/**
+ * @brief Whole transfers across chunk boundaries
+ */
+static void test_m2m_boundaries(void) {
+    static const uint32_t lens[] = {
+        0xFFFCU, 0xFFFFU, 0x10000U, 0x10004U, 0x1FFF8U,
+        0x3FFFCU, 0x40000U, 0x40004U, 0x7FFF8U, 0x100000U,
+    };
+
+    for (uint32_t i = 0; i < (sizeof(lens) / sizeof(lens[0])); i++) {
+        for (uint32_t offset = 0; offset < 40U; offset += 3U) {
+            m2m_check(0x24000000U + offset, lens[i] + offset, 32, DMA_M2M_MODE_WORD);
+            m2m_check(0x24000000U + offset, lens[i] + offset, 32, DMA_M2M_MODE_PACK);
+            m2m_check(0x20000000U + offset, lens[i] + offset, 4, DMA_M2M_MODE_WORD);
+            m2m_check(0x20000000U + offset, lens[i] + offset, 4, DMA_M2M_MODE_PACK);
+            m2m_check(0x20000000U + offset, lens[i] + offset, 4, DMA_M2M_MODE_PORT);
+        }
+    }
+}
+
+/**
+ * @brief Random addresses, lengths and modes
+ */
+static void test_m2m_random(void) {
+    for (uint32_t run = 0; run < M2M_RUNS; run++) {
+        uintptr_t dst = 0x24000000U + (test_rand() % 4096U);
+        uint32_t len = ((test_rand() & 3U) == 0U) ? (test_rand() % 0x80000U) : (test_rand() % 256U);
+        uint32_t align = ((test_rand() & 1U) == 0U) ? 4U : 32U;
+
+        m2m_check(dst, len, align, (dma_m2m_mode_t)(test_rand() % 3U));
+    }
+}
+
+int main(void) {
+    TEST_RUN(test_m2m_head_tail);
+    TEST_RUN(test_m2m_short);
+    TEST_RUN(test_m2m_chunk_limits);
+    TEST_RUN(test_m2m_boundaries);
+    TEST_RUN(test_m2m_random);
+
+    TEST_EXIT();
+}
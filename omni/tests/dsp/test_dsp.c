@@ -0,0 +1,331 @@
+/**
+  * @file    test_dsp.c
+  * @author  LuckkMaker
+  * @brief   Tests of the DSP kernels against reference outputs
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <math.h>
+#include <string.h>
+#include "omni_test.h"
+#include "dsp/dsp.h"
+
+#define TEST_PI             3.14159265358979323846
+#define FIR_MAX_TAPS        33U
+#define FIR_MAX_BLOCK       17U
+#define FIR_HISTORY         (FIR_MAX_TAPS + (5U * FIR_MAX_BLOCK))
+#define BIQUAD_MAX_STAGES   3U
+#define BIQUAD_LEN          50U
+
+static uint32_t rand_state = 1;
+
+static int32_t test_rand(void) {
+    rand_state = (rand_state * 1103515245U) + 12345U;
+
+    return (int32_t)(rand_state >> 1);
+}
+
+static int64_t test_sat(int64_t value, int64_t min, int64_t max) {
+    return (value > max) ? max : ((value < min) ? min : value);
+}
+
+/**
+ * @brief Q15 and Q31 FIR are bit-exact with a direct convolution over the
+ *        whole input, across block boundaries and partial blocks
+ */
+static void test_dsp_fir(void) {
+    q15_t coeffs15[FIR_MAX_TAPS];
+    q31_t coeffs31[FIR_MAX_TAPS];
+    float coeffsf[FIR_MAX_TAPS];
+    q15_t state15[DSP_FIR_STATE_LEN(FIR_MAX_TAPS, FIR_MAX_BLOCK)];
+    q31_t state31[DSP_FIR_STATE_LEN(FIR_MAX_TAPS, FIR_MAX_BLOCK)];
+    float statef[DSP_FIR_STATE_LEN(FIR_MAX_TAPS, FIR_MAX_BLOCK)];
+    q15_t in15[FIR_MAX_BLOCK], out15[FIR_MAX_BLOCK];
+    q31_t in31[FIR_MAX_BLOCK], out31[FIR_MAX_BLOCK];
+    float inf[FIR_MAX_BLOCK], outf[FIR_MAX_BLOCK];
+    dsp_fir_q15_t fir15;
+    dsp_fir_q31_t fir31;
+    dsp_fir_f32_t firf;
+    double errf = 0.0;
+
+    for (uint32_t taps = 1; taps <= FIR_MAX_TAPS; taps += 4U) {
+        for (uint32_t block = 1; block <= FIR_MAX_BLOCK; block += 4U) {
+            // Zero history before the first block, like the cleared state
+            q15_t history15[FIR_HISTORY] = {0};
+            q31_t history31[FIR_HISTORY] = {0};
+            uint32_t pos = FIR_MAX_TAPS;
+
+            for (uint32_t k = 0; k < taps; k++) {
+                coeffs15[k] = (q15_t)test_rand();
+                // Two guard bits, the Q31 sum must not wrap
+                coeffs31[k] = test_rand() / (int32_t)(4U * taps);
+                coeffsf[k] = (float)coeffs15[k] / 32768.0f;
+            }
+
+            TEST_ASSERT_EQUAL(OMNI_OK, dsp.fir_q15_init(&fir15, taps, coeffs15, state15, block));
+            TEST_ASSERT_EQUAL(OMNI_OK, dsp.fir_q31_init(&fir31, taps, coeffs31, state31, block));
+            TEST_ASSERT_EQUAL(OMNI_OK, dsp.fir_f32_init(&firf, taps, coeffsf, statef, block));
+
+            for (uint32_t run = 0; run < 5U; run++) {
+                // Every other block is one sample short
+                uint32_t len = block - (((run & 1U) != 0U) && (block > 1U) ? 1U : 0U);
+
+                for (uint32_t i = 0; i < len; i++) {
+                    in15[i] = (q15_t)test_rand();
+                    in31[i] = test_rand();
+                    inf[i] = (float)in15[i] / 32768.0f;
+                    history15[pos + i] = in15[i];
+                    history31[pos + i] = in31[i];
+                }
+
+                dsp.fir_q15(&fir15, in15, out15, len);
+                dsp.fir_q31(&fir31, in31, out31, len);
+                dsp.fir_f32(&firf, inf, outf, len);
+
+                for (uint32_t i = 0; i < len; i++) {
+                    const q15_t *x15 = &history15[pos + i + 1U - taps];
+                    const q31_t *x31 = &history31[pos + i + 1U - taps];
+                    int64_t acc15 = 0;
+                    int64_t acc31 = 0;
+
+                    for (uint32_t k = 0; k < taps; k++) {
+                        acc15 += (int64_t)coeffs15[k] * x15[k];
+                        acc31 += (int64_t)coeffs31[k] * x31[k];
+                    }
+
+                    TEST_ASSERT_EQUAL(test_sat(acc15 >> 15, INT16_MIN, INT16_MAX), out15[i]);
+                    TEST_ASSERT_EQUAL(test_sat(acc31 >> 31, INT32_MIN, INT32_MAX), out31[i]);
+                    errf = fmax(errf, fabs(outf[i] - ((double)acc15 / (32768.0 * 32768.0))));
+                }
+
+                pos += len;
+            }
+        }
+    }
+
+    TEST_ASSERT(errf < 1e-5);
+}
+
+/**
+ * @brief Q15 cascades are bit-exact with a direct form I reference, Q31
+ *        and float cascades follow a double precision reference
+ */
+static void test_dsp_biquad(void) {
+    // Butterworth lowpass at 0.1 fs, two identical stages
+    const double lowpass[5] = {0.0674553, 0.1349105, 0.0674553, -1.1429805, 0.4128016};
+    q15_t coeffs15[5U * BIQUAD_MAX_STAGES];
+    q15_t state15[DSP_BIQUAD_STATE_LEN(BIQUAD_MAX_STAGES)];
+    q15_t in15[BIQUAD_LEN], out15[BIQUAD_LEN], ref15[BIQUAD_LEN];
+    q31_t coeffs31[10];
+    q31_t state31[DSP_BIQUAD_STATE_LEN(2)];
+    q31_t in31[4U * BIQUAD_LEN], out31[4U * BIQUAD_LEN];
+    float coeffsf[10];
+    float statef[DSP_BIQUAD_STATE_LEN(2)];
+    float inf[4U * BIQUAD_LEN], outf[4U * BIQUAD_LEN];
+    double ref[4U * BIQUAD_LEN];
+    double ref_state[2][4] = {{0}};
+    dsp_biquad_q15_t biquad15;
+    dsp_biquad_q31_t biquad31;
+    dsp_biquad_f32_t biquadf;
+    double err31 = 0.0;
+    double errf = 0.0;
+
+    for (uint32_t stages = 1; stages <= BIQUAD_MAX_STAGES; stages++) {
+        for (uint32_t post_shift = 0; post_shift <= 2U; post_shift++) {
+            int32_t ref_state15[BIQUAD_MAX_STAGES][4] = {{0}};
+
+            for (uint32_t i = 0; i < (5U * stages); i++) {
+                coeffs15[i] = (q15_t)(test_rand() >> 3);
+            }
+
+            TEST_ASSERT_EQUAL(OMNI_OK, dsp.biquad_q15_init(&biquad15, stages, coeffs15, state15, post_shift));
+
+            for (uint32_t run = 0; run < 4U; run++) {
+                for (uint32_t i = 0; i < BIQUAD_LEN; i++) {
+                    in15[i] = (q15_t)(test_rand() >> 2);
+                    ref15[i] = in15[i];
+                }
+
+                // Filter in place on odd runs
+                if ((run & 1U) != 0U) {
+                    memcpy(out15, in15, sizeof(out15));
+                    dsp.biquad_q15(&biquad15, out15, out15, BIQUAD_LEN);
+                } else {
+                    dsp.biquad_q15(&biquad15, in15, out15, BIQUAD_LEN);
+                }
+
+                for (uint32_t stage = 0; stage < stages; stage++) {
+                    const q15_t *c = &coeffs15[5U * stage];
+                    int32_t *s = ref_state15[stage];
+
+                    for (uint32_t i = 0; i < BIQUAD_LEN; i++) {
+                        int64_t acc = ((int64_t)c[0] * ref15[i]) + ((int64_t)c[1] * s[0]) + ((int64_t)c[2] * s[1]) -
+                                      ((int64_t)c[3] * s[2]) - ((int64_t)c[4] * s[3]);
+                        int32_t y = (int32_t)test_sat(acc >> (15U - post_shift), INT16_MIN, INT16_MAX);
+
+                        s[1] = s[0];
+                        s[0] = ref15[i];
+                        s[3] = s[2];
+                        s[2] = y;
+                        ref15[i] = (q15_t)y;
+                    }
+                }
+
+                TEST_ASSERT(memcmp(ref15, out15, sizeof(out15)) == 0);
+            }
+        }
+    }
+
+    for (uint32_t stage = 0; stage < 2U; stage++) {
+        for (uint32_t i = 0; i < 5U; i++) {
+            // Q31 coefficients scaled by 2^-1, a1 is beyond -1
+            coeffs31[(5U * stage) + i] = (q31_t)lrint(lowpass[i] * 1073741824.0);
+            coeffsf[(5U * stage) + i] = (float)lowpass[i];
+        }
+    }
+
+    TEST_ASSERT_EQUAL(OMNI_OK, dsp.biquad_q31_init(&biquad31, 2, coeffs31, state31, 1));
+    TEST_ASSERT_EQUAL(OMNI_OK, dsp.biquad_f32_init(&biquadf, 2, coeffsf, statef));
+    TEST_ASSERT_EQUAL(OMNI_FAIL, dsp.biquad_q31_init(&biquad31, 2, coeffs31, state31, 32));
+
+    for (uint32_t i = 0; i < (4U * BIQUAD_LEN); i++) {
+        double x = (0.4 * sin(0.3 * i)) + (0.2 * sin(2.1 * i));
+
+        in31[i] = (q31_t)lrint(x * 2147483648.0);
+        inf[i] = (float)x;
+        ref[i] = (double)in31[i] / 2147483648.0;
+    }
+
+    dsp.biquad_q31(&biquad31, in31, out31, 4U * BIQUAD_LEN);
+    dsp.biquad_f32(&biquadf, inf, outf, 4U * BIQUAD_LEN);
+
+    for (uint32_t stage = 0; stage < 2U; stage++) {
+        double *s = ref_state[stage];
+
+        for (uint32_t i = 0; i < (4U * BIQUAD_LEN); i++) {
+            double y = (lowpass[0] * ref[i]) + (lowpass[1] * s[0]) + (lowpass[2] * s[1]) -
+                       (lowpass[3] * s[2]) - (lowpass[4] * s[3]);
+
+            s[1] = s[0];
+            s[0] = ref[i];
+            s[3] = s[2];
+            s[2] = y;
+            ref[i] = y;
+        }
+    }
+
+    for (uint32_t i = 0; i < (4U * BIQUAD_LEN); i++) {
+        err31 = fmax(err31, fabs(((double)out31[i] / 2147483648.0) - ref[i]));
+        errf = fmax(errf, fabs((double)outf[i] - ref[i]));
+    }
+
+    TEST_ASSERT(err31 < 1e-6);
+    TEST_ASSERT(errf < 1e-5);
+}
+
+/**
+ * @brief Real FFT bins match a double precision DFT of the same input
+ */
+static void test_dsp_rfft(void) {
+    static q15_t twiddle15[DSP_RFFT_TWIDDLE_LEN(DSP_RFFT_MAX_LEN)];
+    static q31_t twiddle31[DSP_RFFT_TWIDDLE_LEN(DSP_RFFT_MAX_LEN)];
+    static float twiddlef[DSP_RFFT_TWIDDLE_LEN(DSP_RFFT_MAX_LEN)];
+    static q15_t in15[DSP_RFFT_MAX_LEN], out15[DSP_RFFT_MAX_LEN];
+    static q31_t in31[DSP_RFFT_MAX_LEN], out31[DSP_RFFT_MAX_LEN];
+    static float inf[DSP_RFFT_MAX_LEN], outf[DSP_RFFT_MAX_LEN];
+    static double x[DSP_RFFT_MAX_LEN];
+    dsp_rfft_q15_t rfft15;
+    dsp_rfft_q31_t rfft31;
+    dsp_rfft_f32_t rfftf;
+
+    TEST_ASSERT_EQUAL(OMNI_FAIL, dsp.rfft_q15_init(&rfft15, DSP_RFFT_MIN_LEN / 2U, twiddle15));
+    TEST_ASSERT_EQUAL(OMNI_FAIL, dsp.rfft_q15_init(&rfft15, 48, twiddle15));
+    TEST_ASSERT_EQUAL(OMNI_FAIL, dsp.rfft_f32_init(&rfftf, DSP_RFFT_MAX_LEN * 2U, twiddlef));
+
+    for (uint32_t n = DSP_RFFT_MIN_LEN; n <= DSP_RFFT_MAX_LEN; n *= 2U) {
+        double err15 = 0.0;
+        double err31 = 0.0;
+        double errf = 0.0;
+
+        TEST_ASSERT_EQUAL(OMNI_OK, dsp.rfft_q15_init(&rfft15, n, twiddle15));
+        TEST_ASSERT_EQUAL(OMNI_OK, dsp.rfft_q31_init(&rfft31, n, twiddle31));
+        TEST_ASSERT_EQUAL(OMNI_OK, dsp.rfft_f32_init(&rfftf, n, twiddlef));
+
+        // Two tones, noise and an offset, quantized to Q15 for all formats
+        for (uint32_t i = 0; i < n; i++) {
+            double value = (0.4 * sin(2.0 * TEST_PI * 3.0 * i / n)) +
+                           (0.3 * cos(2.0 * TEST_PI * ((n / 4U) - 1U) * i / n)) +
+                           (0.1 * (((test_rand() % 1000) / 1000.0) - 0.5)) + 0.05;
+
+            in15[i] = (q15_t)lrint(value * 32768.0);
+            in31[i] = (q31_t)in15[i] * 65536;
+            inf[i] = (float)in15[i] / 32768.0f;
+            x[i] = (double)in15[i] / 32768.0;
+        }
+
+        dsp.rfft_q15(&rfft15, in15, out15);
+        dsp.rfft_q31(&rfft31, in31, out31);
+        dsp.rfft_f32(&rfftf, inf, outf);
+
+        for (uint32_t k = 0; k <= (n / 2U); k++) {
+            double re = 0.0;
+            double im = 0.0;
+            uint32_t re_index = 2U * k;
+            uint32_t im_index = (2U * k) + 1U;
+            double im15, im31, imf;
+
+            for (uint32_t i = 0; i < n; i++) {
+                re += x[i] * cos(2.0 * TEST_PI * k * i / n);
+                im -= x[i] * sin(2.0 * TEST_PI * k * i / n);
+            }
+
+            // DC and Nyquist bins are real and packed into out[0] and out[1]
+            if ((k == 0U) || (k == (n / 2U))) {
+                re_index = (k == 0U) ? 0U : 1U;
+                im15 = 0.0;
+                im31 = 0.0;
+                imf = 0.0;
+            } else {
+                im15 = out15[im_index] / 32768.0;
+                im31 = out31[im_index] / 2147483648.0;
+                imf = outf[im_index];
+            }
+
+            err15 = fmax(err15, hypot((out15[re_index] / 32768.0) - (re / n), im15 - (im / n)));
+            err31 = fmax(err31, hypot((out31[re_index] / 2147483648.0) - (re / n), im31 - (im / n)));
+            errf = fmax(errf, hypot(outf[re_index] - re, imf - im) / n);
+        }
+
+        // Q15 within 8 LSB
+        TEST_ASSERT(err15 < (8.0 / 32768.0));
+        TEST_ASSERT(err31 < 1e-7);
+        TEST_ASSERT(errf < 1e-6);
+        if ((err15 >= (8.0 / 32768.0)) || (err31 >= 1e-7) || (errf >= 1e-6)) {
+            printf("  n %u: q15 %.2e q31 %.2e f32 %.2e\n", (unsigned)n, err15, err31, errf);
+        }
+    }
+}
+
+int main(void) {
+    TEST_RUN(test_dsp_fir);
+    TEST_RUN(test_dsp_biquad);
+    TEST_RUN(test_dsp_rfft);
+
+    TEST_EXIT();
+}
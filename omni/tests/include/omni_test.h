@@ -0,0 +1,99 @@
+/**
+  * @file    omni_test.h
+  * @author  LuckkMaker
+  * @brief   Minimal test helpers of the host tests
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef OMNI_TEST_H
+#define OMNI_TEST_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Each test program is one translation unit: TEST_RUN() runs a case and
+ * prints its result, TEST_EXIT() returns the exit code for ctest.
+ */
+
+static int test_failed = 0;
+static int test_case_failed = 0;
+
+/**
+ * @brief Check a condition, the case goes on after a failure
+ */
+#define TEST_ASSERT(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("  %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            test_case_failed = 1; \
+        } \
+    } while (0)
+
+/**
+ * @brief Check that two integers are equal
+ */
+#define TEST_ASSERT_EQUAL(expected, actual) \
+    do { \
+        long long expected_ = (long long)(expected); \
+        long long actual_ = (long long)(actual); \
+        if (expected_ != actual_) { \
+            printf("  %s:%d: %s is %lld, expected %lld\n", __FILE__, __LINE__, #actual, actual_, expected_); \
+            test_case_failed = 1; \
+        } \
+    } while (0)
+
+/**
+ * @brief Check that an integer lies in [min, max]
+ */
+#define TEST_ASSERT_RANGE(min, max, actual) \
+    do { \
+        long long actual_ = (long long)(actual); \
+        if ((actual_ < (long long)(min)) || (actual_ > (long long)(max))) { \
+            printf("  %s:%d: %s is %lld, expected %lld..%lld\n", __FILE__, __LINE__, #actual, actual_, (long long)(min), (long long)(max)); \
+            test_case_failed = 1; \
+        } \
+    } while (0)
+
+/**
+ * @brief Run a test case
+ */
+#define TEST_RUN(test) \
+    do { \
+        test_case_failed = 0; \
+        test(); \
+        printf("%s %s\n", test_case_failed ? "FAIL" : "PASS", #test); \
+        test_failed |= test_case_failed; \
+    } while (0)
+
+/**
+ * @brief Return the exit code of the test program
+ */
+#define TEST_EXIT() return test_failed
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* OMNI_TEST_H */
@@ -0,0 +1,181 @@
+/**
+  * @file    test_memops.c
+  * @author  LuckkMaker
+  * @brief   Tests of the memops component against the C library
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "omni_test.h"
+#include "memops/memops.h"
+
+#define MEMOPS_MAX_LEN      4096U
+#define MEMOPS_MAX_OFFSET   64U
+#define MEMOPS_AREA         (MEMOPS_MAX_LEN + (2U * MEMOPS_MAX_OFFSET))
+#define MEMOPS_RUNS         20000U
+#define MEMOPS_SMALL_LEN    72U
+
+// Buffers under test and their libc reference, 64-byte aligned so the
+// offsets below cover every alignment of source and destination
+static uint8_t src[MEMOPS_AREA] __attribute__((aligned(64)));
+static uint8_t dst[MEMOPS_AREA] __attribute__((aligned(64)));
+static uint8_t ref_src[MEMOPS_AREA] __attribute__((aligned(64)));
+static uint8_t ref_dst[MEMOPS_AREA] __attribute__((aligned(64)));
+
+static uint32_t rand_state = 1;
+
+static uint32_t test_rand(void) {
+    rand_state = (rand_state * 1103515245U) + 12345U;
+
+    return rand_state >> 8;
+}
+
+/**
+ * @brief Fill both buffers with random bytes and copy them to the reference
+ */
+static void memops_fill(void) {
+    for (uint32_t i = 0; i < MEMOPS_AREA; i++) {
+        src[i] = (uint8_t)test_rand();
+        dst[i] = (uint8_t)test_rand();
+    }
+
+    memcpy(ref_src, src, sizeof(src));
+    memcpy(ref_dst, dst, sizeof(dst));
+}
+
+/**
+ * @brief Random length, mostly short, sometimes up to MEMOPS_MAX_LEN
+ */
+static size_t memops_rand_len(void) {
+    return ((test_rand() & 3U) == 0U) ? (test_rand() % MEMOPS_MAX_LEN) : (test_rand() % 80U);
+}
+
+/**
+ * @brief Check a copy against memcpy, including the bytes around it
+ */
+static void memops_check_copy(size_t dst_offset, size_t src_offset, size_t len) {
+    void *ret = memops.copy(&dst[dst_offset], &src[src_offset], len);
+
+    memcpy(&ref_dst[dst_offset], &ref_src[src_offset], len);
+
+    TEST_ASSERT(ret == &dst[dst_offset]);
+    TEST_ASSERT(memcmp(dst, ref_dst, sizeof(dst)) == 0);
+    TEST_ASSERT(memcmp(src, ref_src, sizeof(src)) == 0);
+}
+
+/**
+ * @brief Check a fill against memset, including the bytes around it
+ */
+static void memops_check_set(size_t dst_offset, int value, size_t len) {
+    void *ret = memops.set(&dst[dst_offset], value, len);
+
+    memset(&ref_dst[dst_offset], value, len);
+
+    TEST_ASSERT(ret == &dst[dst_offset]);
+    TEST_ASSERT(memcmp(dst, ref_dst, sizeof(dst)) == 0);
+}
+
+/**
+ * @brief Check a move inside one buffer against memmove
+ */
+static void memops_check_move(size_t dst_offset, size_t src_offset, size_t len) {
+    void *ret = memops.move(&src[dst_offset], &src[src_offset], len);
+
+    memmove(&ref_src[dst_offset], &ref_src[src_offset], len);
+
+    TEST_ASSERT(ret == &src[dst_offset]);
+    TEST_ASSERT(memcmp(src, ref_src, sizeof(src)) == 0);
+}
+
+/**
+ * @brief Every length up to MEMOPS_SMALL_LEN at every alignment pair
+ */
+static void test_memops_small(void) {
+    memops_fill();
+
+    for (size_t len = 0; len <= MEMOPS_SMALL_LEN; len++) {
+        for (size_t dst_offset = 0; dst_offset < 8U; dst_offset++) {
+            for (size_t src_offset = 0; src_offset < 8U; src_offset++) {
+                memops_check_copy(dst_offset, src_offset, len);
+                memops_check_move(dst_offset, src_offset, len);
+                // Overlap at both ends of the buffer
+                memops_check_move(dst_offset + 1U, src_offset, len);
+                memops_check_move(dst_offset, src_offset + 1U, len);
+            }
+
+            memops_check_set(dst_offset, (int)(len * 37U), len);
+        }
+    }
+}
+
+/**
+ * @brief Random lengths and offsets against memcpy
+ */
+static void test_memops_copy(void) {
+    for (uint32_t run = 0; run < MEMOPS_RUNS; run++) {
+        size_t len = memops_rand_len();
+
+        if ((run % 64U) == 0U) {
+            memops_fill();
+        }
+
+        memops_check_copy(test_rand() % MEMOPS_MAX_OFFSET, test_rand() % MEMOPS_MAX_OFFSET, len);
+    }
+}
+
+/**
+ * @brief Random lengths, offsets and values against memset, values
+ *        outside a byte are truncated like memset does
+ */
+static void test_memops_set(void) {
+    for (uint32_t run = 0; run < MEMOPS_RUNS; run++) {
+        size_t len = memops_rand_len();
+        int value = (int)(test_rand() % 512U) - 256;
+
+        if ((run % 64U) == 0U) {
+            memops_fill();
+        }
+
+        memops_check_set(test_rand() % MEMOPS_MAX_OFFSET, value, len);
+    }
+}
+
+/**
+ * @brief Random overlapping moves in both directions against memmove
+ */
+static void test_memops_move(void) {
+    for (uint32_t run = 0; run < MEMOPS_RUNS; run++) {
+        size_t len = memops_rand_len();
+
+        if ((run % 64U) == 0U) {
+            memops_fill();
+        }
+
+        memops_check_move(test_rand() % MEMOPS_MAX_OFFSET, test_rand() % MEMOPS_MAX_OFFSET, len);
+    }
+}
+
+int main(void) {
+    TEST_RUN(test_memops_small);
+    TEST_RUN(test_memops_copy);
+    TEST_RUN(test_memops_set);
+    TEST_RUN(test_memops_move);
+
+    TEST_EXIT();
+}
@@ -0,0 +1,172 @@
+/**
+  * @file    test_at24c.c
+  * @author  LuckkMaker
+  * @brief   Tests of the AT24C EEPROM model
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "omni_test.h"
+#include "drivers/init.h"
+#include "drivers/i2c.h"
+#include "hal/irq_hal.h"
+#include "hal/clock_hal.h"
+#include "models/at24c_model.h"
+
+#define EEPROM_ADDR         0x50
+#define EEPROM_WRITE_US     5000U
+
+static volatile uint32_t i2c_event_mask;
+static volatile uint32_t i2c_event_num;
+
+static void i2c_event(uint32_t event) {
+    i2c_event_mask = event;
+    i2c_event_num++;
+}
+
+/**
+ * @brief Wait for the completion interrupt of the last transfer
+ *
+ * @return Event of the transfer
+ */
+static uint32_t eeprom_wait(uint32_t event_num) {
+    for (uint32_t i = 0; (i2c_event_num == event_num) && (i < 1000U); i++) {
+        irq_hal_wait(1000);
+    }
+    TEST_ASSERT_EQUAL(event_num + 1U, i2c_event_num);
+
+    return i2c_event_mask;
+}
+
+static uint32_t eeprom_write(uint16_t dev_addr, uint16_t mem_addr, i2c_mem_addr_size_t size, const uint8_t *data, uint16_t len) {
+    uint32_t event_num = i2c_event_num;
+
+    TEST_ASSERT_EQUAL(OMNI_OK, i2c_driver.write(I2C_NUM_1, dev_addr, mem_addr, size, data, len));
+
+    return eeprom_wait(event_num);
+}
+
+static uint32_t eeprom_read(uint16_t dev_addr, uint16_t mem_addr, i2c_mem_addr_size_t size, uint8_t *data, uint16_t len) {
+    uint32_t event_num = i2c_event_num;
+
+    TEST_ASSERT_EQUAL(OMNI_OK, i2c_driver.read(I2C_NUM_1, dev_addr, mem_addr, size, data, len));
+
+    return eeprom_wait(event_num);
+}
+
+/**
+ * @brief The address is NACKed for tWR after a page write, ACK polling waits it out
+ */
+static void test_at24c_write_cycle(void) {
+    at24c_model_t eeprom;
+    at24c_model_config_t config = {
+        .size = 32768,
+        .addr = EEPROM_ADDR,
+        .write_time_us = EEPROM_WRITE_US,
+    };
+    uint8_t data[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    uint8_t read[4];
+    uint64_t start;
+    uint32_t event;
+    at24c_model_stats_t stats;
+
+    TEST_ASSERT_EQUAL(OMNI_OK, at24c_model_init(&eeprom, &config));
+    TEST_ASSERT_EQUAL(OMNI_OK, at24c_model_attach(&eeprom, I2C_NUM_1));
+
+    start = clock_hal_get_ns();
+    event = eeprom_write(EEPROM_ADDR, 100, I2C_MEM_ADDR_SIZE_16, data, 4);
+    TEST_ASSERT_EQUAL(I2C_EVENT_TRANSFER_COMPLETE, event);
+    TEST_ASSERT(at24c_model_is_busy(&eeprom));
+
+    // A transfer during the write cycle ends with an address NACK interrupt
+    event = eeprom_read(EEPROM_ADDR, 100, I2C_MEM_ADDR_SIZE_16, read, sizeof(read));
+    TEST_ASSERT(event & I2C_EVENT_ADDRESS_NACK);
+    TEST_ASSERT(event & I2C_EVENT_TRANSFER_INCOMPLETE);
+
+    TEST_ASSERT_EQUAL(OMNI_OK, i2c_driver.is_device_ready(I2C_NUM_1, EEPROM_ADDR, 10000));
+    TEST_ASSERT_RANGE(EEPROM_WRITE_US, EEPROM_WRITE_US + 50000U, (clock_hal_get_ns() - start) / 1000U);
+    TEST_ASSERT(!at24c_model_is_busy(&eeprom));
+
+    stats = at24c_model_get_stats(&eeprom);
+    TEST_ASSERT_EQUAL(1, stats.write_cycle);
+    TEST_ASSERT(stats.address_nack >= 2U);
+    TEST_ASSERT_EQUAL(4, stats.write_bytes);
+
+    TEST_ASSERT_EQUAL(I2C_EVENT_TRANSFER_COMPLETE, eeprom_read(EEPROM_ADDR, 100, I2C_MEM_ADDR_SIZE_16, read, sizeof(read)));
+    TEST_ASSERT_EQUAL(0, read[0]);
+    TEST_ASSERT_EQUAL(3, read[3]);
+
+    // 64 byte pages, bytes past 127 wrap to 64
+    eeprom_write(EEPROM_ADDR, 124, I2C_MEM_ADDR_SIZE_16, data, sizeof(data));
+    TEST_ASSERT_EQUAL(OMNI_OK, i2c_driver.is_device_ready(I2C_NUM_1, EEPROM_ADDR, 10000));
+    eeprom_read(EEPROM_ADDR, 124, I2C_MEM_ADDR_SIZE_16, read, sizeof(read));
+    TEST_ASSERT_EQUAL(0, read[0]);
+    TEST_ASSERT_EQUAL(3, read[3]);
+    eeprom_read(EEPROM_ADDR, 64, I2C_MEM_ADDR_SIZE_16, read, sizeof(read));
+    TEST_ASSERT_EQUAL(4, read[0]);
+    TEST_ASSERT_EQUAL(7, read[3]);
+    TEST_ASSERT_EQUAL(2, at24c_model_get_stats(&eeprom).write_cycle);
+
+    at24c_model_detach(&eeprom, I2C_NUM_1);
+    at24c_model_deinit(&eeprom);
+}
+
+/**
+ * @brief A 16 Kbit part answers on 8 addresses, each selecting 256 bytes
+ */
+static void test_at24c_blocks(void) {
+    at24c_model_t eeprom;
+    at24c_model_config_t config = {
+        .size = 2048,
+        .addr = EEPROM_ADDR,
+        .write_time_us = 0,
+    };
+    uint8_t data = 0xA5;
+    uint8_t read = 0;
+
+    TEST_ASSERT_EQUAL(OMNI_OK, at24c_model_init(&eeprom, &config));
+    TEST_ASSERT_EQUAL(OMNI_OK, at24c_model_attach(&eeprom, I2C_NUM_1));
+
+    TEST_ASSERT_EQUAL(OMNI_OK, i2c_driver.is_device_ready(I2C_NUM_1, EEPROM_ADDR + 7, 1));
+    TEST_ASSERT_EQUAL(OMNI_FAIL, i2c_driver.is_device_ready(I2C_NUM_1, EEPROM_ADDR + 8, 1));
+
+    TEST_ASSERT_EQUAL(I2C_EVENT_TRANSFER_COMPLETE, eeprom_write(EEPROM_ADDR + 3, 0x10, I2C_MEM_ADDR_SIZE_8, &data, 1));
+    TEST_ASSERT(!at24c_model_is_busy(&eeprom));
+    eeprom_read(EEPROM_ADDR + 3, 0x10, I2C_MEM_ADDR_SIZE_8, &read, 1);
+    TEST_ASSERT_EQUAL(0xA5, read);
+    TEST_ASSERT_EQUAL(0xA5, eeprom.config.memory[(3U * 256U) + 0x10U]);
+
+    at24c_model_detach(&eeprom, I2C_NUM_1);
+    at24c_model_deinit(&eeprom);
+}
+
+int main(void) {
+    i2c_driver_config_t config = {
+        .mode = I2C_MODE_I2C,
+        .bus_speed = I2C_BUS_SPEED_FAST,
+        .event_cb = i2c_event,
+    };
+
+    driver_init();
+    i2c_driver.init(I2C_NUM_1, &config);
+
+    TEST_RUN(test_at24c_write_cycle);
+    TEST_RUN(test_at24c_blocks);
+
+    TEST_EXIT();
+}
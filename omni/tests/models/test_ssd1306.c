@@ -0,0 +1,171 @@
+/**
+  * @file    test_ssd1306.c
+  * @author  LuckkMaker
+  * @brief   Tests of the SSD1306 display model
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "omni_test.h"
+#include "drivers/init.h"
+#include "drivers/i2c.h"
+#include "drivers/display/ssd1306_types.h"
+#include "hal/irq_hal.h"
+#include "models/ssd1306_model.h"
+
+#define DISPLAY_ADDR        0x3C
+#define DISPLAY_HEIGHT      32U
+
+static ssd1306_model_t display;
+static volatile uint32_t i2c_event_mask;
+static volatile uint32_t i2c_event_num;
+
+static void i2c_event(uint32_t event) {
+    i2c_event_mask = event;
+    i2c_event_num++;
+}
+
+/**
+ * @brief Transmit to the display and wait for the completion interrupt
+ *
+ * @return Event of the transfer
+ */
+static uint32_t display_send(uint16_t addr, const uint8_t *data, uint32_t len) {
+    uint32_t event_num = i2c_event_num;
+
+    TEST_ASSERT_EQUAL(OMNI_OK, i2c_driver.master_transmit(I2C_NUM_1, addr, data, len, 0));
+    for (uint32_t i = 0; (i2c_event_num == event_num) && (i < 1000U); i++) {
+        irq_hal_wait(1000);
+    }
+    TEST_ASSERT_EQUAL(event_num + 1U, i2c_event_num);
+
+    return i2c_event_mask;
+}
+
+/**
+ * @brief Only the configured address is acknowledged, reads return the status
+ */
+static void test_ssd1306_bus(void) {
+    uint8_t command[2] = {0x00, SSD1306_SET_DISPLAY_ON};
+    uint8_t status = 0;
+    uint32_t event_num;
+
+    TEST_ASSERT(display_send(DISPLAY_ADDR + 1, command, sizeof(command)) & I2C_EVENT_ADDRESS_NACK);
+    TEST_ASSERT_EQUAL(0, ssd1306_model_get_stats(&display).transfers);
+
+    event_num = i2c_event_num;
+    TEST_ASSERT_EQUAL(OMNI_OK, i2c_driver.master_receive(I2C_NUM_1, DISPLAY_ADDR, &status, 1, 0));
+    for (uint32_t i = 0; (i2c_event_num == event_num) && (i < 1000U); i++) {
+        irq_hal_wait(1000);
+    }
+    TEST_ASSERT_EQUAL(I2C_EVENT_TRANSFER_COMPLETE, i2c_event_mask);
+    TEST_ASSERT_EQUAL(SSD1306_STATUS_DISPLAY_OFF, status);
+
+    TEST_ASSERT_EQUAL(I2C_EVENT_TRANSFER_COMPLETE, display_send(DISPLAY_ADDR, command, sizeof(command)));
+    TEST_ASSERT(display.display_on);
+}
+
+/**
+ * @brief Horizontal addressing fills the window, remap and flip mirror the panel
+ */
+static void test_ssd1306_frame(void) {
+    const uint8_t init[] = {
+        0x00,
+        SSD1306_SET_MEMORY_ADDR_MODE, SSD1306_SET_MEMORY_ADDR_HORIZ,
+        SSD1306_SET_COLUMN_ADDR, 0, 127,
+        SSD1306_SET_PAGE_ADDR, 0, 3,
+        SSD1306_SET_MULTIPLEX_RATIO, DISPLAY_HEIGHT - 1U,
+        0xA1, 0xC8,
+        SSD1306_SET_DISPLAY_ON,
+    };
+    uint8_t frame[1 + (128U * 4U)];
+    ssd1306_model_stats_t stats;
+
+    // Only the first 8 columns of each page lit
+    frame[0] = 0x40;
+    for (uint32_t i = 0; i < (128U * 4U); i++) {
+        frame[1U + i] = ((i % 128U) < 8U) ? 0xFF : 0x00;
+    }
+
+    ssd1306_model_reset_stats(&display);
+    TEST_ASSERT_EQUAL(I2C_EVENT_TRANSFER_COMPLETE, display_send(DISPLAY_ADDR, init, sizeof(init)));
+    TEST_ASSERT_EQUAL(I2C_EVENT_TRANSFER_COMPLETE, display_send(DISPLAY_ADDR, frame, sizeof(frame)));
+
+    // Segment remap moves column 0 to the right edge
+    TEST_ASSERT_EQUAL(0, ssd1306_model_get_pixel(&display, 0, 0));
+    TEST_ASSERT_EQUAL(1, ssd1306_model_get_pixel(&display, 127, 0));
+    TEST_ASSERT_EQUAL(1, ssd1306_model_get_pixel(&display, 120, DISPLAY_HEIGHT - 1U));
+    TEST_ASSERT_EQUAL(0, ssd1306_model_get_pixel(&display, 119, DISPLAY_HEIGHT - 1U));
+    TEST_ASSERT_EQUAL(0xFF, display.ram[3][7]);
+    TEST_ASSERT_EQUAL(0x00, display.ram[3][8]);
+
+    // The pointer wrapped to the window start, the same frame again is all unchanged
+    TEST_ASSERT_EQUAL(I2C_EVENT_TRANSFER_COMPLETE, display_send(DISPLAY_ADDR, frame, sizeof(frame)));
+    stats = ssd1306_model_get_stats(&display);
+    TEST_ASSERT_EQUAL(3, stats.transfers);
+    TEST_ASSERT_EQUAL(2U * 128U * 4U, stats.data_bytes);
+    TEST_ASSERT_EQUAL((120U * 4U) + (128U * 4U), stats.unchanged_bytes);
+    TEST_ASSERT_EQUAL(sizeof(init) - 1U, stats.cmd_bytes);
+    TEST_ASSERT_EQUAL(sizeof(init) + (2U * sizeof(frame)), stats.bus_bytes);
+}
+
+/**
+ * @brief Page addressing stays in its page and wraps to its column start
+ */
+static void test_ssd1306_page_mode(void) {
+    const uint8_t setup[] = {
+        0x00,
+        SSD1306_SET_MEMORY_ADDR_MODE, SSD1306_SET_MEMORY_ADDR_PAGE,
+        0xB2, 0x0E, 0x17,
+    };
+    const uint8_t data[] = {0x40, 0x11, 0x22, 0x33};
+
+    TEST_ASSERT_EQUAL(I2C_EVENT_TRANSFER_COMPLETE, display_send(DISPLAY_ADDR, setup, sizeof(setup)));
+    TEST_ASSERT_EQUAL(I2C_EVENT_TRANSFER_COMPLETE, display_send(DISPLAY_ADDR, data, sizeof(data)));
+
+    TEST_ASSERT_EQUAL(0x33, display.ram[2][126]);
+    TEST_ASSERT_EQUAL(0x22, display.ram[2][127]);
+    TEST_ASSERT_EQUAL(0xFF, display.ram[2][0]);
+    TEST_ASSERT_EQUAL(0x00, display.ram[3][126]);
+}
+
+int main(void) {
+    i2c_driver_config_t i2c_config = {
+        .mode = I2C_MODE_I2C,
+        .bus_speed = I2C_BUS_SPEED_FAST,
+        .event_cb = i2c_event,
+    };
+    ssd1306_model_config_t display_config = {
+        .addr = DISPLAY_ADDR,
+        .height = DISPLAY_HEIGHT,
+    };
+
+    driver_init();
+    i2c_driver.init(I2C_NUM_1, &i2c_config);
+    if ((ssd1306_model_init(&display, &display_config) != OMNI_OK) || (ssd1306_model_attach(&display, I2C_NUM_1) != OMNI_OK)) {
+        return 1;
+    }
+
+    TEST_RUN(test_ssd1306_bus);
+    TEST_RUN(test_ssd1306_frame);
+    TEST_RUN(test_ssd1306_page_mode);
+
+    ssd1306_model_detach(&display, I2C_NUM_1);
+
+    TEST_EXIT();
+}
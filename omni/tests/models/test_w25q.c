@@ -0,0 +1,224 @@
+/**
+  * @file    test_w25q.c
+  * @author  LuckkMaker
+  * @brief   Tests of the W25Q flash model
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "omni_test.h"
+#include "drivers/init.h"
+#include "drivers/gpio.h"
+#include "drivers/spi.h"
+#include "hal/irq_hal.h"
+#include "hal/clock_hal.h"
+#include "models/w25q_model.h"
+
+#define FLASH_CS        GET_PIN(A, 4)
+#define FLASH_SIZE      (8U * 1024U * 1024U)
+
+static w25q_model_t flash;
+static volatile uint32_t spi_complete;
+
+static void spi_event(uint32_t event) {
+    if (event & SPI_EVENT_TRANSFER_COMPLETE) {
+        spi_complete++;
+    }
+}
+
+/**
+ * @brief Run one SPI transfer and wait for its completion interrupt
+ */
+static void flash_xfer(const uint8_t *tx, uint8_t *rx, uint32_t len) {
+    uint32_t complete = spi_complete;
+
+    if (rx == NULL) {
+        spi_driver.send(SPI_NUM_1, tx, len);
+    } else {
+        spi_driver.receive(SPI_NUM_1, rx, len);
+    }
+
+    for (uint32_t i = 0; (spi_complete == complete) && (i < 1000U); i++) {
+        irq_hal_wait(1000);
+    }
+    TEST_ASSERT_EQUAL(complete + 1U, spi_complete);
+}
+
+/**
+ * @brief Send a command and read the response with CS held low
+ */
+static void flash_command(const uint8_t *cmd, uint32_t cmd_len, uint8_t *rx, uint32_t rx_len) {
+    gpio_driver.set_level(FLASH_CS, GPIO_LEVEL_LOW);
+    flash_xfer(cmd, NULL, cmd_len);
+    if (rx_len != 0U) {
+        flash_xfer(NULL, rx, rx_len);
+    }
+    gpio_driver.set_level(FLASH_CS, GPIO_LEVEL_HIGH);
+}
+
+static uint8_t flash_status(void) {
+    uint8_t cmd = 0x05;
+    uint8_t status;
+
+    flash_command(&cmd, 1, &status, 1);
+
+    return status;
+}
+
+static void flash_write_enable(void) {
+    uint8_t cmd = 0x06;
+
+    flash_command(&cmd, 1, NULL, 0);
+}
+
+/**
+ * @brief Poll BUSY, return microseconds from @p start until it cleared
+ */
+static uint32_t flash_wait_busy(uint64_t start) {
+    while (flash_status() & 0x01U) {
+    }
+
+    return (uint32_t)((clock_hal_get_ns() - start) / 1000U);
+}
+
+static void flash_read(uint32_t addr, uint8_t *data, uint32_t len) {
+    uint8_t cmd[4] = {0x03, (uint8_t)(addr >> 16), (uint8_t)(addr >> 8), (uint8_t)addr};
+
+    flash_command(cmd, sizeof(cmd), data, len);
+}
+
+/**
+ * @brief JEDEC ID matches the configured capacity
+ */
+static void test_w25q_id(void) {
+    uint8_t cmd = 0x9F;
+    uint8_t id[3];
+
+    flash_command(&cmd, 1, id, sizeof(id));
+    TEST_ASSERT_EQUAL(0xEF, id[0]);
+    TEST_ASSERT_EQUAL(0x40, id[1]);
+    TEST_ASSERT_EQUAL(23, id[2]);
+}
+
+/**
+ * @brief Page program is busy for tPP, wraps in the page and clears bits
+ */
+static void test_w25q_program(void) {
+    uint8_t program[4 + 8] = {0x02, 0x00, 0x01, 0xFC, 1, 2, 3, 4, 5, 6, 7, 8};
+    uint8_t again[4 + 1] = {0x02, 0x00, 0x01, 0xFC, 0xF0};
+    uint8_t data[8];
+    uint64_t start;
+    uint32_t busy_us;
+    w25q_model_stats_t stats;
+
+    w25q_model_reset_stats(&flash);
+
+    // Without WEL the program is ignored
+    flash_command(program, sizeof(program), NULL, 0);
+    TEST_ASSERT_EQUAL(0, flash_status() & 0x01U);
+    TEST_ASSERT_EQUAL(1, w25q_model_get_stats(&flash).ignored);
+
+    flash_write_enable();
+    TEST_ASSERT_EQUAL(0x02, flash_status() & 0x02U);
+    start = clock_hal_get_ns();
+    flash_command(program, sizeof(program), NULL, 0);
+    TEST_ASSERT(w25q_model_is_busy(&flash));
+    busy_us = flash_wait_busy(start);
+    TEST_ASSERT_RANGE(400, 50000, busy_us);
+    TEST_ASSERT_EQUAL(0, flash_status() & 0x02U);
+
+    stats = w25q_model_get_stats(&flash);
+    TEST_ASSERT_EQUAL(1, stats.page_program);
+    TEST_ASSERT(stats.status_poll > 0U);
+
+    flash_read(0x0001FC, data, 4);
+    TEST_ASSERT_EQUAL(1, data[0]);
+    TEST_ASSERT_EQUAL(4, data[3]);
+    flash_read(0x000100, data, 4);
+    TEST_ASSERT_EQUAL(5, data[0]);
+    TEST_ASSERT_EQUAL(8, data[3]);
+
+    // 0x01 & 0xF0
+    flash_write_enable();
+    flash_command(again, sizeof(again), NULL, 0);
+    flash_wait_busy(clock_hal_get_ns());
+    flash_read(0x0001FC, data, 1);
+    TEST_ASSERT_EQUAL(0x00, data[0]);
+}
+
+/**
+ * @brief Sector erase is busy for tSE and ignores other commands meanwhile
+ */
+static void test_w25q_erase(void) {
+    uint8_t erase[4] = {0x20, 0x00, 0x01, 0x00};
+    uint8_t data[4];
+    uint64_t start;
+    uint32_t busy_us;
+
+    w25q_model_reset_stats(&flash);
+
+    flash_write_enable();
+    start = clock_hal_get_ns();
+    flash_command(erase, sizeof(erase), NULL, 0);
+    TEST_ASSERT(flash_status() & 0x01U);
+
+    // Reads are not served during the cycle
+    flash_read(0x000100, data, sizeof(data));
+    TEST_ASSERT_EQUAL(1, w25q_model_get_stats(&flash).ignored);
+
+    busy_us = flash_wait_busy(start);
+    TEST_ASSERT_RANGE(45000, 100000, busy_us);
+    TEST_ASSERT_EQUAL(1, w25q_model_get_stats(&flash).erase);
+
+    flash_read(0x000100, data, sizeof(data));
+    TEST_ASSERT_EQUAL(0xFF, data[0]);
+    TEST_ASSERT_EQUAL(0xFF, data[3]);
+}
+
+int main(void) {
+    gpio_driver_config_t gpio_config = {
+        .mode = GPIO_MODE_PP_OUTPUT,
+        .level = GPIO_LEVEL_HIGH,
+    };
+    spi_driver_config_t spi_config = {
+        .option = SPI_OP_MODE_MASTER | SPI_OP_DATA_SIZE_SET(8),
+        .frequency = 10000000,
+        .event_cb = spi_event,
+    };
+    w25q_model_config_t flash_config = {
+        .size = FLASH_SIZE,
+        .cs_pin = FLASH_CS,
+        .time_percent = 100,
+    };
+
+    driver_init();
+    gpio_driver.init(FLASH_CS, &gpio_config);
+    spi_driver.init(SPI_NUM_1, &spi_config);
+    if ((w25q_model_init(&flash, &flash_config) != OMNI_OK) || (w25q_model_attach(&flash, SPI_NUM_1) != OMNI_OK)) {
+        return 1;
+    }
+
+    TEST_RUN(test_w25q_id);
+    TEST_RUN(test_w25q_program);
+    TEST_RUN(test_w25q_erase);
+
+    w25q_model_detach(&flash, SPI_NUM_1);
+    w25q_model_deinit(&flash);
+
+    TEST_EXIT();
+}
@@ -0,0 +1,117 @@
+/**
+  * @file    test_mpu.c
+  * @author  LuckkMaker
+  * @brief   Tests of the MPU region size and stack guard arithmetic
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "omni_test.h"
+#include "mpu/mpu.h"
+
+#define MPU_RUNS            20000U
+
+static uint32_t rand_state = 1;
+
+static uint32_t test_rand(void) {
+    rand_state = (rand_state * 1103515245U) + 12345U;
+
+    return rand_state >> 8;
+}
+
+/**
+ * @brief Lengths round up to the next power of two, 32 bytes at least
+ */
+static void test_mpu_region_size(void) {
+    TEST_ASSERT_EQUAL(32, mpu_region_size(0));
+    TEST_ASSERT_EQUAL(32, mpu_region_size(1));
+    TEST_ASSERT_EQUAL(32, mpu_region_size(32));
+    TEST_ASSERT_EQUAL(64, mpu_region_size(33));
+    TEST_ASSERT_EQUAL(0x8000U, mpu_region_size(0x5000U));
+    TEST_ASSERT_EQUAL(0x20000U, mpu_region_size(0x20000U));
+    TEST_ASSERT_EQUAL(0x40000U, mpu_region_size(0x20001U));
+    TEST_ASSERT_EQUAL(0x80000000U, mpu_region_size(0x40000001U));
+    TEST_ASSERT_EQUAL(0x80000000U, mpu_region_size(0x80000000U));
+
+    // Above the largest size the loop would overflow
+    TEST_ASSERT_EQUAL(0, mpu_region_size(0x80000001U));
+    TEST_ASSERT_EQUAL(0, mpu_region_size(0xFFFFFFFFU));
+
+    for (uint32_t run = 0; run < MPU_RUNS; run++) {
+        uint32_t len = test_rand() >> (test_rand() % 24U);
+        uint32_t size = mpu_region_size(len);
+
+        TEST_ASSERT_EQUAL(0, size & (size - 1U));
+        TEST_ASSERT(size >= len);
+        TEST_ASSERT((size == MPU_REGION_MIN_SIZE) || ((size >> 1) < len));
+    }
+}
+
+/**
+ * @brief Sizes are powers of two of 32 bytes or more, bases aligned to them
+ */
+static void test_mpu_region_is_valid(void) {
+    TEST_ASSERT(mpu_region_is_valid(0x24000000U, 512U * 1024U));
+    TEST_ASSERT(mpu_region_is_valid(0x30000000U, 32U));
+    TEST_ASSERT(mpu_region_is_valid(0x00000000U, 0x80000000U));
+
+    TEST_ASSERT(!mpu_region_is_valid(0x20000000U, 0U));
+    TEST_ASSERT(!mpu_region_is_valid(0x20000000U, 16U));
+    TEST_ASSERT(!mpu_region_is_valid(0x20000000U, 48U));
+    TEST_ASSERT(!mpu_region_is_valid(0x20000010U, 32U));
+    TEST_ASSERT(!mpu_region_is_valid(0x24040000U, 512U * 1024U));
+    TEST_ASSERT(!mpu_region_is_valid(0x80000000U, 0xFFFFFFFFU));
+
+    // A section placed at the alignment of its rounded size always fits
+    for (uint32_t run = 0; run < MPU_RUNS; run++) {
+        uint32_t len = (test_rand() % 0x100000U) + 1U;
+        uint32_t size = mpu_region_size(len);
+        uint32_t base = 0x30000000U + (size * (test_rand() % 4U));
+
+        TEST_ASSERT(mpu_region_is_valid(base, size));
+        TEST_ASSERT(!mpu_region_is_valid(base + 4U, size));
+    }
+}
+
+/**
+ * @brief The guard is the first aligned block at or above the stack bottom
+ */
+static void test_mpu_guard_base(void) {
+    TEST_ASSERT_EQUAL(0x24000400U, mpu_guard_base(0x24000400U));
+    TEST_ASSERT_EQUAL(0x24000420U, mpu_guard_base(0x24000401U));
+    TEST_ASSERT_EQUAL(0x24000420U, mpu_guard_base(0x2400041FU));
+    TEST_ASSERT_EQUAL(0x2407FC00U, mpu_guard_base(0x2407FBF8U));
+
+    for (uint32_t bottom = 0x20000000U; bottom < 0x20000100U; bottom += 4U) {
+        uint32_t base = mpu_guard_base(bottom);
+
+        TEST_ASSERT(mpu_region_is_valid(base, MPU_REGION_MIN_SIZE));
+        TEST_ASSERT(base >= bottom);
+        TEST_ASSERT((base - bottom) < MPU_REGION_MIN_SIZE);
+        // The guard never reaches past a 64 byte stack
+        TEST_ASSERT((base + MPU_REGION_MIN_SIZE) <= (bottom + 64U));
+    }
+}
+
+int main(void) {
+    TEST_RUN(test_mpu_region_size);
+    TEST_RUN(test_mpu_region_is_valid);
+    TEST_RUN(test_mpu_guard_base);
+
+    TEST_EXIT();
+}
@@ -0,0 +1,303 @@
+/**
+  * @file    test_posix.c
+  * @author  LuckkMaker
+  * @brief   Tests of the posix target
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "omni_test.h"
+#include "drivers/init.h"
+#include "drivers/gpio.h"
+#include "drivers/timer.h"
+#include "drivers/spi.h"
+#include "drivers/i2c.h"
+#include "hal/irq_hal.h"
+#include "hal/gpio_hal.h"
+#include "hal/spi_hal.h"
+#include "hal/clock_hal.h"
+
+// Wait for a condition set from an interrupt handler, up to 1 s
+#define WAIT_FOR(cond) \
+    do { \
+        for (uint32_t wait_ = 0; !(cond) && (wait_ < 1000U); wait_++) { \
+            irq_hal_wait(1000); \
+        } \
+    } while (0)
+
+static volatile uint32_t irq_order[4];
+static volatile uint32_t irq_order_num;
+static volatile uint32_t timer_updates;
+static volatile uint32_t spi_events;
+static volatile uint32_t i2c_events;
+static uint32_t watch_level;
+static uint32_t watch_count;
+
+static void user_irq0_handler(void) {
+    irq_order[irq_order_num++] = 0;
+}
+
+static void user_irq1_handler(void) {
+    irq_order[irq_order_num++] = 1;
+}
+
+/**
+ * @brief Pending interrupts wait for PRIMASK and run by priority
+ */
+static void test_irq_priority(void) {
+    irq_stats_t stats;
+
+    irq_hal_register_handler(USER_IRQn, user_irq0_handler);
+    irq_hal_register_handler(USER_IRQn + 1, user_irq1_handler);
+    irq_hal_set_priority(USER_IRQn, 8, 0);
+    irq_hal_set_priority(USER_IRQn + 1, 2, 0);
+    irq_hal_enable(USER_IRQn);
+    irq_hal_enable(USER_IRQn + 1);
+    irq_hal_stats_reset();
+
+    __disable_irq();
+    irq_hal_set_pending(USER_IRQn);
+    irq_hal_set_pending(USER_IRQn + 1);
+    clock_hal_sleep_ns(2000000U);
+    TEST_ASSERT_EQUAL(0, irq_order_num);
+    TEST_ASSERT_EQUAL(1, irq_hal_get_pending(USER_IRQn));
+    TEST_ASSERT_EQUAL(1, __get_PRIMASK());
+    __enable_irq();
+
+    WAIT_FOR(irq_order_num == 2);
+    TEST_ASSERT_EQUAL(2, irq_order_num);
+    TEST_ASSERT_EQUAL(1, irq_order[0]);
+    TEST_ASSERT_EQUAL(0, irq_order[1]);
+    TEST_ASSERT_EQUAL(0, irq_hal_get_pending(USER_IRQn));
+
+    TEST_ASSERT_EQUAL(OMNI_OK, irq_hal_stats_get(USER_IRQn, &stats));
+    TEST_ASSERT_EQUAL(1, stats.count);
+
+    // A disabled interrupt stays pending
+    irq_hal_disable(USER_IRQn);
+    irq_hal_set_pending(USER_IRQn);
+    irq_hal_wait(2000);
+    TEST_ASSERT_EQUAL(2, irq_order_num);
+    irq_hal_enable(USER_IRQn);
+    WAIT_FOR(irq_order_num == 3);
+    TEST_ASSERT_EQUAL(3, irq_order_num);
+
+    irq_hal_disable(USER_IRQn);
+    irq_hal_disable(USER_IRQn + 1);
+}
+
+static void gpio_watch(void *context, uint32_t gpio_num, uint32_t level) {
+    UNUSED(context);
+    UNUSED(gpio_num);
+    watch_level = level;
+    watch_count++;
+}
+
+/**
+ * @brief Outputs reach watches, injected edges reach the event ring
+ */
+static void test_gpio(void) {
+    gpio_driver_config_t config = {
+        .mode = GPIO_MODE_PP_OUTPUT,
+        .pull = GPIO_PULL_NONE,
+        .level = GPIO_LEVEL_LOW,
+    };
+    gpio_event_t event;
+
+    TEST_ASSERT_EQUAL(OMNI_OK, gpio_driver.init(GET_PIN(B, 3), &config));
+    TEST_ASSERT_EQUAL(OMNI_OK, gpio_hal_watch(GET_PIN(B, 3), gpio_watch, NULL));
+    gpio_driver.set_level(GET_PIN(B, 3), GPIO_LEVEL_HIGH);
+    TEST_ASSERT_EQUAL(1, gpio_driver.get_level(GET_PIN(B, 3)));
+    TEST_ASSERT_EQUAL(1, watch_count);
+    TEST_ASSERT_EQUAL(1, watch_level);
+    gpio_driver.toggle(GET_PIN(B, 3));
+    TEST_ASSERT_EQUAL(0, gpio_driver.get_level(GET_PIN(B, 3)));
+    TEST_ASSERT_EQUAL(2, watch_count);
+    gpio_hal_watch(GET_PIN(B, 3), NULL, NULL);
+
+    config.mode = GPIO_MODE_DEFAULT_INPUT;
+    TEST_ASSERT_EQUAL(OMNI_OK, gpio_driver.init(GET_PIN(C, 5), &config));
+    TEST_ASSERT_EQUAL(OMNI_OK, gpio_driver.irq_enable(GET_PIN(C, 5), GPIO_TRIGGER_RISING, GPIO_PULL_NONE, 0));
+
+    gpio_hal_inject(GET_PIN(C, 5), 1);
+    WAIT_FOR(gpio_driver.get_count(GET_PIN(C, 5)) == 1);
+    TEST_ASSERT_EQUAL(1, gpio_driver.get_level(GET_PIN(C, 5)));
+    TEST_ASSERT_EQUAL(OMNI_OK, gpio_driver.read_event(&event));
+    TEST_ASSERT_EQUAL(GET_PIN(C, 5), event.gpio_num);
+    TEST_ASSERT_EQUAL(1, event.level);
+
+    // Falling edges are not enabled
+    gpio_hal_inject(GET_PIN(C, 5), 0);
+    irq_hal_wait(2000);
+    TEST_ASSERT_EQUAL(1, gpio_driver.get_count(GET_PIN(C, 5)));
+    TEST_ASSERT_EQUAL(OMNI_FAIL, gpio_driver.read_event(&event));
+    TEST_ASSERT_EQUAL(0, gpio_driver.get_lost());
+
+    gpio_driver.irq_disable(GET_PIN(C, 5));
+}
+
+static void timer_event(uint32_t event) {
+    if (event & TIMER_EVENT_UPDATE) {
+        timer_updates++;
+    }
+}
+
+/**
+ * @brief The time base raises update interrupts at its rate
+ */
+static void test_timer(void) {
+    timer_driver_config_t config = {
+        .mode = TIMER_MODE_BASE,
+        .frequency = 1000000,
+        .period = 1000,
+        .event_cb = timer_event,
+    };
+    uint64_t start;
+    uint32_t tick;
+    uint32_t updates;
+
+    TEST_ASSERT_EQUAL(OMNI_OK, timer_driver.init(TIMER_NUM_1, &config));
+    TEST_ASSERT_EQUAL(OMNI_OK, timer_driver.start(TIMER_NUM_1));
+    TEST_ASSERT_RANGE(0, 999, timer_driver.get_counter(TIMER_NUM_1));
+
+    start = clock_hal_get_ns();
+    tick = timer_driver.get_tick(1000);
+    timer_driver.delay_ms(100);
+    tick = timer_driver.get_tick(1000) - tick;
+    updates = timer_updates;
+
+    // Delays never return early, the host scheduler may make them late
+    TEST_ASSERT((clock_hal_get_ns() - start) >= 100000000U);
+    TEST_ASSERT_RANGE(100, 200, tick);
+    TEST_ASSERT_RANGE(50, 200, updates);
+
+    start = clock_hal_get_ns();
+    timer_driver.delay_us(500);
+    TEST_ASSERT_RANGE(500000, 20000000, clock_hal_get_ns() - start);
+
+    TEST_ASSERT_EQUAL(OMNI_OK, timer_driver.stop(TIMER_NUM_1));
+    updates = timer_updates;
+    timer_driver.delay_ms(10);
+    TEST_ASSERT_RANGE(updates, updates + 1, timer_updates);
+
+    TEST_ASSERT_EQUAL(OMNI_OK, timer_driver.deinit(TIMER_NUM_1));
+}
+
+static void spi_loopback(void *context, const uint8_t *tx, uint8_t *rx, uint32_t len) {
+    uint8_t *last = (uint8_t *)context;
+
+    for (uint32_t i = 0; i < len; i++) {
+        if (rx != NULL) {
+            rx[i] = (tx != NULL) ? (uint8_t)~tx[i] : *last;
+        }
+        if (tx != NULL) {
+            *last = tx[i];
+        }
+    }
+}
+
+static void spi_event(uint32_t event) {
+    spi_events |= event;
+}
+
+/**
+ * @brief SPI transfers reach an attached model and complete from the IRQ
+ */
+static void test_spi(void) {
+    spi_driver_config_t config = {
+        .option = SPI_OP_MODE_MASTER | SPI_OP_DATA_SIZE_SET(8),
+        .frequency = 1000000,
+        .event_cb = spi_event,
+    };
+    uint8_t last = 0;
+    spi_hal_model_t model = {
+        .context = &last,
+        .cs_pin = SPI_HAL_CS_HARD,
+        .transfer = spi_loopback,
+    };
+    uint8_t tx[4] = {0x00, 0x5A, 0xA5, 0xFF};
+    uint8_t rx[4];
+
+    TEST_ASSERT_EQUAL(OMNI_OK, spi_driver.init(SPI_NUM_1, &config));
+
+    // No model drives MISO
+    spi_events = 0;
+    TEST_ASSERT_EQUAL(OMNI_OK, spi_driver.transfer(SPI_NUM_1, tx, rx, sizeof(rx)));
+    WAIT_FOR(spi_events & SPI_EVENT_TRANSFER_COMPLETE);
+    TEST_ASSERT(spi_events & SPI_EVENT_TRANSFER_COMPLETE);
+    TEST_ASSERT_EQUAL(0xFF, rx[0]);
+    TEST_ASSERT_EQUAL(0xFF, rx[3]);
+
+    TEST_ASSERT_EQUAL(OMNI_OK, spi_hal_attach(SPI_NUM_1, &model));
+    spi_events = 0;
+    TEST_ASSERT_EQUAL(OMNI_OK, spi_driver.transfer(SPI_NUM_1, tx, rx, sizeof(rx)));
+    WAIT_FOR(spi_events & SPI_EVENT_TRANSFER_COMPLETE);
+    TEST_ASSERT_EQUAL(0, spi_driver.get_status(SPI_NUM_1).busy);
+    TEST_ASSERT_EQUAL(0xFF, rx[0]);
+    TEST_ASSERT_EQUAL(0xA5, rx[1]);
+    TEST_ASSERT_EQUAL(0x5A, rx[2]);
+    TEST_ASSERT_EQUAL(0x00, rx[3]);
+
+    spi_events = 0;
+    TEST_ASSERT_EQUAL(OMNI_OK, spi_driver.receive(SPI_NUM_1, rx, 1));
+    WAIT_FOR(spi_events & SPI_EVENT_TRANSFER_COMPLETE);
+    TEST_ASSERT_EQUAL(0xFF, rx[0]);
+
+    TEST_ASSERT_EQUAL(OMNI_OK, spi_hal_detach(SPI_NUM_1, &model));
+    spi_driver.deinit(SPI_NUM_1);
+}
+
+static void i2c_event(uint32_t event) {
+    i2c_events |= event;
+}
+
+/**
+ * @brief An address without a model is not acknowledged
+ */
+static void test_i2c_nack(void) {
+    i2c_driver_config_t config = {
+        .mode = I2C_MODE_I2C,
+        .bus_speed = I2C_BUS_SPEED_FAST,
+        .event_cb = i2c_event,
+    };
+    uint8_t data = 0;
+
+    TEST_ASSERT_EQUAL(OMNI_OK, i2c_driver.init(I2C_NUM_1, &config));
+    TEST_ASSERT(i2c_events & I2C_EVENT_INITIALIZED);
+
+    i2c_events = 0;
+    TEST_ASSERT_EQUAL(OMNI_OK, i2c_driver.master_transmit(I2C_NUM_1, 0x42, &data, 1, 0));
+    WAIT_FOR(i2c_events != 0);
+    TEST_ASSERT(i2c_events & I2C_EVENT_ADDRESS_NACK);
+    TEST_ASSERT(i2c_events & I2C_EVENT_TRANSFER_INCOMPLETE);
+    TEST_ASSERT_EQUAL(OMNI_FAIL, i2c_driver.is_device_ready(I2C_NUM_1, 0x42, 2));
+
+    i2c_driver.deinit(I2C_NUM_1);
+}
+
+int main(void) {
+    driver_init();
+
+    TEST_RUN(test_irq_priority);
+    TEST_RUN(test_gpio);
+    TEST_RUN(test_timer);
+    TEST_RUN(test_spi);
+    TEST_RUN(test_i2c_nack);
+
+    TEST_EXIT();
+}
@@ -0,0 +1,189 @@
+/**
+  * @file    test_waveform.c
+  * @author  LuckkMaker
+  * @brief   Tests of the waveform component encoder and open/close paths
+  * @attention
+  *
+  * Copyright (c) 2024 LuckkMaker
+  * All rights reserved.
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  * You may obtain a copy of the License at
+  *
+  *     http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "omni_test.h"
+#include "drivers/gpio.h"
+
+// The host target has no update DMA and no BSRR, the component is built
+// into the test with a stand-in register. Writes fail in the host timer.
+#define CONFIG_TIMER_UP_DMA 1
+
+static volatile uint32_t test_bsrr;
+
+volatile uint32_t *gpio_hal_get_bsrr(uint32_t gpio_num) {
+    (void)gpio_num;
+
+    return &test_bsrr;
+}
+
+#include "waveform/waveform.c"
+
+#define TEST_SAMPLES_MAX    512U
+
+static uint32_t samples[TEST_SAMPLES_MAX];
+
+/**
+ * @brief Level of one pin in a sample, -1 if the sample does not drive it
+ */
+static int test_pin_level(uint32_t sample, uint32_t pin) {
+    uint32_t set = (sample >> pin) & 0x01U;
+    uint32_t reset = (sample >> (pin + 16U)) & 0x01U;
+
+    TEST_ASSERT(!(set && reset));
+
+    return set ? 1 : (reset ? 0 : -1);
+}
+
+/**
+ * @brief WS2812 bits are 3 samples, MSB first, high 1 or 2 samples
+ */
+static void test_waveform_ws2812(void) {
+    const waveform_encoding_t encoding = WAVEFORM_ENCODING_WS2812;
+    const uint16_t pins[] = { 1U << 5 };
+    const uint8_t data[] = { 0xA5 };
+    const uint8_t *const lanes[] = { data };
+    uint32_t num;
+
+    num = waveform.encode(&encoding, pins, lanes, 1, 1, samples, TEST_SAMPLES_MAX);
+    TEST_ASSERT_EQUAL(8U * 3U + 120U, num);
+
+    for (uint32_t bit = 0; bit < 8U; bit++) {
+        int one = (data[0] >> (7U - bit)) & 0x01U;
+
+        TEST_ASSERT_EQUAL(1, test_pin_level(samples[bit * 3U], 5));
+        TEST_ASSERT_EQUAL(one, test_pin_level(samples[bit * 3U + 1U], 5));
+        TEST_ASSERT_EQUAL(0, test_pin_level(samples[bit * 3U + 2U], 5));
+    }
+
+    for (uint32_t i = 8U * 3U; i < num; i++) {
+        TEST_ASSERT_EQUAL(WAVEFORM_SAMPLE(0, 1U << 5), samples[i]);
+    }
+}
+
+/**
+ * @brief Lanes are sent in parallel, each on its own pins, other pins untouched
+ */
+static void test_waveform_lanes(void) {
+    const waveform_encoding_t encoding = { .samples_per_bit = 4, .zero_high = 1, .one_high = 3, .reset_samples = 2 };
+    const uint16_t pins[] = { 1U << 0, (1U << 3) | (1U << 4), 1U << 15 };
+    const uint8_t lane0[] = { 0xFF, 0x00 };
+    const uint8_t lane1[] = { 0x00, 0xFF };
+    const uint8_t lane2[] = { 0x5A, 0xC3 };
+    const uint8_t *const lanes[] = { lane0, lane1, lane2 };
+    const uint16_t all = (1U << 0) | (1U << 3) | (1U << 4) | (1U << 15);
+    uint32_t num;
+
+    num = waveform.encode(&encoding, pins, lanes, 3, 2, samples, TEST_SAMPLES_MAX);
+    TEST_ASSERT_EQUAL(2U * 8U * 4U + 2U, num);
+
+    for (uint32_t i = 0; i < num; i++) {
+        // Every sample drives all lane pins and nothing else
+        TEST_ASSERT_EQUAL(all, (samples[i] | (samples[i] >> 16)) & 0xFFFFU);
+        TEST_ASSERT_EQUAL(0, samples[i] & (samples[i] >> 16));
+    }
+
+    for (uint32_t lane = 0; lane < 3U; lane++) {
+        for (uint32_t bit = 0; bit < 16U; bit++) {
+            uint32_t byte = lanes[lane][bit / 8U];
+            uint32_t high = ((byte >> (7U - (bit % 8U))) & 0x01U) ? 3U : 1U;
+
+            for (uint32_t sample = 0; sample < 4U; sample++) {
+                for (uint32_t pin = 0; pin < 16U; pin++) {
+                    if (pins[lane] & (1U << pin)) {
+                        TEST_ASSERT_EQUAL((sample < high) ? 1 : 0, test_pin_level(samples[bit * 4U + sample], pin));
+                    }
+                }
+            }
+        }
+    }
+
+    TEST_ASSERT_EQUAL(WAVEFORM_SAMPLE(0, all), samples[num - 1U]);
+}
+
+/**
+ * @brief A buffer one word short is rejected and left untouched
+ */
+static void test_waveform_short_buffer(void) {
+    const waveform_encoding_t encoding = WAVEFORM_ENCODING_WS2812;
+    const uint16_t pins[] = { 1U << 0 };
+    const uint8_t data[] = { 0x12, 0x34 };
+    const uint8_t *const lanes[] = { data };
+    uint32_t need = 2U * 8U * 3U + 120U;
+
+    memset(samples, 0xEE, sizeof(samples));
+    TEST_ASSERT_EQUAL(0, waveform.encode(&encoding, pins, lanes, 1, 2, samples, need - 1U));
+    TEST_ASSERT_EQUAL(0xEEEEEEEEU, samples[0]);
+    TEST_ASSERT_EQUAL(need, waveform.encode(&encoding, pins, lanes, 1, 2, samples, need));
+}
+
+/**
+ * @brief A failed open leaves the pins and the timer as they were
+ */
+static void test_waveform_open_unwind(void) {
+    waveform_obj_t obj = {0};
+    uint32_t base = GET_PORT(C);
+
+    obj.config.timer_num = TIMER_NUM_1;
+    obj.config.gpio_num = base;
+    obj.config.pin_mask = (1U << 2) | (1U << 9);
+    obj.config.frequency = 0;
+    obj.config.period = 10;
+
+    // Pins driven high from outside read high while they are inputs
+    gpio_hal_inject(base + 2U, 1);
+    gpio_hal_inject(base + 9U, 1);
+
+    TEST_ASSERT(waveform.open(&obj) == OMNI_FAIL);
+    TEST_ASSERT_EQUAL(0, obj.status.is_initialized);
+    TEST_ASSERT(waveform_active == NULL);
+    TEST_ASSERT_EQUAL(1, gpio_driver.get_level(base + 2U));
+    TEST_ASSERT_EQUAL(1, gpio_driver.get_level(base + 9U));
+
+    // A valid open drives them low, close releases them again
+    obj.config.frequency = 1000000;
+    TEST_ASSERT(waveform.open(&obj) == OMNI_OK);
+    TEST_ASSERT_EQUAL(1, obj.status.is_initialized);
+    TEST_ASSERT(obj.data.bsrr == &test_bsrr);
+    TEST_ASSERT_EQUAL(0, gpio_driver.get_level(base + 2U));
+    TEST_ASSERT_EQUAL(0, gpio_driver.get_level(base + 9U));
+
+    // No update DMA on the host, the write fails and clears busy
+    samples[0] = WAVEFORM_SAMPLE(1U << 2, 1U << 9);
+    TEST_ASSERT(waveform.write(&obj, samples, 1) == OMNI_FAIL);
+    TEST_ASSERT_EQUAL(0, obj.status.busy);
+
+    TEST_ASSERT(waveform.close(&obj) == OMNI_OK);
+    TEST_ASSERT(waveform_active == NULL);
+    TEST_ASSERT_EQUAL(1, gpio_driver.get_level(base + 2U));
+    TEST_ASSERT_EQUAL(1, gpio_driver.get_level(base + 9U));
+}
+
+int main(void) {
+    TEST_RUN(test_waveform_ws2812);
+    TEST_RUN(test_waveform_lanes);
+    TEST_RUN(test_waveform_short_buffer);
+    TEST_RUN(test_waveform_open_unwind);
+
+    TEST_EXIT();
+}
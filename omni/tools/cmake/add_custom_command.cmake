@@ -33,7 +33,7 @@
 # )
 
 add_custom_target(menuconfig
-    COMMAND ${Python3_EXECUTABLE} ${OMNI_PYTHON_SCRIPTS_DIR}/run_menuconfig.py
+    COMMAND ${CMAKE_COMMAND} -E env OMNI_FAMILY=${CONFIG_OMNI_FAMILY} ${Python3_EXECUTABLE} ${OMNI_PYTHON_SCRIPTS_DIR}/run_menuconfig.py
     COMMENT "Running kconfig menuconfig"
     WORKING_DIRECTORY ${OMNI_BASE}
 )
@@ -45,3 +45,29 @@ add_custom_target(menuconfig
 #     COMMENT "Running kconfig.py script with project configuration"
 #     WORKING_DIRECTORY ${OMNI_KCONFIG_DIR}
 # )
+
+
+if(DEFINED CONFIG_COMPONENT_BENCH)
+    set(QEMU_BENCH_ARGS
+        --target ${CONFIG_OMNI_TARGET}
+        --timeout ${CONFIG_BENCH_QEMU_TIMEOUT}
+        --threshold ${CONFIG_BENCH_THRESHOLD}
+        --output ${CMAKE_BINARY_DIR}/bench.json
+    )
+
+    if(NOT "${CONFIG_BENCH_QEMU_MACHINE}" STREQUAL "")
+        list(APPEND QEMU_BENCH_ARGS --machine ${CONFIG_BENCH_QEMU_MACHINE})
+    endif()
+
+    if(EXISTS ${APPLICATION_SOURCE_DIR}/bench_baseline.json)
+        list(APPEND QEMU_BENCH_ARGS --baseline ${APPLICATION_SOURCE_DIR}/bench_baseline.json)
+    endif()
+
+    add_custom_target(qemu-bench
+        COMMAND ${Python3_EXECUTABLE} ${OMNI_PYTHON_SCRIPTS_DIR}/qemu_bench.py $<TARGET_FILE:${CMAKE_PROJECT_NAME}> ${QEMU_BENCH_ARGS}
+        DEPENDS ${CMAKE_PROJECT_NAME}
+        COMMENT "Running benchmarks under QEMU"
+        WORKING_DIRECTORY ${CMAKE_BINARY_DIR}
+        USES_TERMINAL
+    )
+endif()
@@ -17,6 +17,9 @@ set(BOARD_PROPERTIES
 # apm32f4 family
     # "apm32f405rg" "apm32f4" "apm32f405xx" "apm"
     "apm32f407ig" "apm32f4" "apm32f407xx" "apm"
+
+# posix host
+    "posix" "host" "host" "posix"
 )
 
 set(BOARD_FOUND FALSE)
@@ -59,6 +62,8 @@ if(NOT BOARD_FOUND)
         "  stm32h750vb  - Platform: stm, Family: stm32h7, Target: stm32h750xx\n"
         "  ------------------------------------------------------------------\n"
         "  apm32f407ig  - Platform: apm, Family: apm32f4, Target: apm32f407xx\n" 
+        "  ------------------------------------------------------------------\n"
+        "  posix        - Platform: posix, Family: host, Target: host\n"
         )
     message(STATUS "")
 else()
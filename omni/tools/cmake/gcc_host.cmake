@@ -0,0 +1,12 @@
+# Native GCC, used by the posix platform
+# gcc must be part of path environment
+set(CMAKE_C_COMPILER                gcc)
+set(CMAKE_ASM_COMPILER              ${CMAKE_C_COMPILER})
+set(CMAKE_CXX_COMPILER              g++)
+set(CMAKE_AR                        ar)
+set(CMAKE_LINKER                    g++)
+set(CMAKE_OBJCOPY                   objcopy)
+set(CMAKE_OBJDUMP                   objdump)
+set(CMAKE_SIZE                      size)
+
+message(STATUS "Toolchain file loaded")
@@ -21,7 +21,8 @@ if(result)
     message(FATAL_ERROR "remove_old_kconfig.py failed with exit code ${result}")
 endif()
 
-# Run kconfig.py script
+# Run kconfig.py script, Kconfig reads the SoC family from the environment
+set(ENV{OMNI_FAMILY} ${CONFIG_OMNI_FAMILY})
 execute_process(
     COMMAND ${Python3_EXECUTABLE} ${OMNI_PYTHON_SCRIPTS_DIR}/kconfig.py --handwritten-input-configs ${OMNI_BASE}/Kconfig ${OMNI_BASE}/.config ${OMNI_KCONFIG_DIR}/omni_kconfig.h ${OMNI_KCONFIG_DIR}/kconfigLog.txt ${OMNI_BASE}/.config ${APPLICATION_SOURCE_DIR}/prj.conf
     WORKING_DIRECTORY ${OMNI_BASE}
@@ -0,0 +1,159 @@
+import argparse
+import re
+import struct
+import sys
+
+# Rebuild log text from a deferred log stream and the firmware ELF.
+# Format strings live in the non-loaded .omni_log section, a frame holds the
+# string offset and raw 32-bit arguments. The frame layout matches
+# components/dlog/dlog.h.
+#
+# Example, capture RTT channel 2 with J-Link and decode it:
+#   JLinkRTTLogger -Device STM32F407VG -If SWD -Speed 4000 -RTTChannel 2 log.bin
+#   python dlog_decoder.py firmware.elf log.bin
+
+DLOG_MARKER = 0x1A
+DLOG_ARG_MAX = 8
+DLOG_LEVEL_LOST = 7
+LOG_SECTION = '.omni_log'
+
+LEVELS = {1: 'E', 2: 'W', 3: 'I', 4: 'D'}
+
+SHF_ALLOC = 0x2
+SHT_NOBITS = 8
+
+FORMAT = re.compile(r'%([-+ #0]*)(\d+)?(?:\.(\d+))?(?:hh|h|ll|l|j|z|t)?([diouxXcsp%])')
+
+
+class Elf:
+    """Minimal ELF32 little endian reader, enough for the log section and string constants."""
+
+    def __init__(self, data):
+        if data[:4] != b'\x7fELF' or data[4] != 1 or data[5] != 1:
+            raise ValueError('Not a 32-bit little endian ELF file')
+
+        shoff, = struct.unpack_from('<I', data, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from('<HHH', data, 0x2E)
+
+        headers = []
+        for i in range(shnum):
+            headers.append(struct.unpack_from('<IIIIIIIIII', data, shoff + i * shentsize))
+
+        names = headers[shstrndx]
+        self.sections = {}
+        self.loaded = []
+        for name, sh_type, flags, addr, offset, size, _, _, _, _ in headers:
+            end = data.index(b'\0', names[4] + name)
+            section_name = data[names[4] + name:end].decode()
+            content = b'' if sh_type == SHT_NOBITS else data[offset:offset + size]
+            self.sections[section_name] = content
+            if (flags & SHF_ALLOC) and sh_type != SHT_NOBITS and size > 0:
+                self.loaded.append((addr, content))
+
+    def read_string(self, address):
+        for base, content in self.loaded:
+            if base <= address < base + len(content):
+                end = content.find(b'\0', address - base)
+                if end < 0:
+                    return None
+                return content[address - base:end].decode(errors='replace')
+        return None
+
+
+def string_at(table, offset):
+    end = table.index(b'\0', offset)
+    return table[offset:end].decode(errors='replace'), end
+
+
+def format_message(elf, fmt, args):
+    args = list(args)
+
+    def convert(match):
+        flags, width, precision, conversion = match.groups()
+        if conversion == '%':
+            return '%'
+        if not args:
+            return match.group(0)
+        value = args.pop(0)
+        spec = '%' + flags + (width or '') + ('.' + precision if precision else '')
+        if conversion in 'di':
+            return (spec + 'd') % (value - (1 << 32) if value & 0x80000000 else value)
+        if conversion == 'c':
+            return (spec + 'c') % chr(value & 0xFF)
+        if conversion == 's':
+            text = elf.read_string(value)
+            return (spec + 's') % (text if text is not None else '<0x{:08x}>'.format(value))
+        if conversion == 'p':
+            return '0x{:08x}'.format(value)
+        if conversion == 'u':
+            conversion = 'd'
+        return (spec + conversion) % value
+
+    return FORMAT.sub(convert, fmt)
+
+
+def decode(elf, data):
+    """Yield (level, location, message) for every frame in the stream."""
+    table = elf.sections.get(LOG_SECTION)
+    if table is None:
+        raise ValueError('No {} section in ELF file'.format(LOG_SECTION))
+
+    offset = 0
+    while offset + 4 <= len(data):
+        header, = struct.unpack_from('<I', data, offset)
+        string_id = header & 0xFFFFF
+        num = (header >> 20) & 0x0F
+        level = (header >> 24) & 0x07
+
+        valid = (header >> 27) == DLOG_MARKER and num <= DLOG_ARG_MAX and offset + 4 + num * 4 <= len(data)
+        if valid and level != DLOG_LEVEL_LOST:
+            # A valid ID points at the start of a string in the table
+            valid = level in LEVELS and string_id < len(table) and (string_id == 0 or table[string_id - 1] == 0)
+        if not valid:
+            # Resynchronize on the next byte
+            offset += 1
+            continue
+
+        args = struct.unpack_from('<{}I'.format(num), data, offset + 4)
+        offset += 4 + num * 4
+
+        if level == DLOG_LEVEL_LOST:
+            yield 'W', '', '{} log frames lost'.format(args[0] if args else 0)
+            continue
+
+        fmt, end = string_at(table, string_id)
+        location, _ = string_at(table, end + 1)
+        yield LEVELS[level], location, format_message(elf, fmt, args)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Decode an omni deferred log stream')
+    parser.add_argument('elf', help='Firmware ELF file')
+    parser.add_argument('input', help='Binary log file, - for stdin')
+    parser.add_argument('--location', action='store_true', help='Print file and line of every message')
+    args = parser.parse_args()
+
+    with open(args.elf, 'rb') as file:
+        elf_data = file.read()
+
+    if args.input == '-':
+        data = sys.stdin.buffer.read()
+    else:
+        with open(args.input, 'rb') as file:
+            data = file.read()
+
+    try:
+        elf = Elf(elf_data)
+        for level, location, message in decode(elf, data):
+            message = message.rstrip('\r\n')
+            if args.location and location:
+                print('{}: {} ({})'.format(level, message, location))
+            else:
+                print('{}: {}'.format(level, message))
+    except ValueError as e:
+        print('Error: {}'.format(e), file=sys.stderr)
+        sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()
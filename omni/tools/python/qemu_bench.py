@@ -0,0 +1,140 @@
+import argparse
+import json
+import subprocess
+import sys
+
+# Run an omni benchmark firmware headless under qemu-system-arm and collect
+# the results printed by components/bench over semihosting.
+#
+# -icount makes the virtual clock follow the executed instructions, so the
+# SysTick ticks of a case do not depend on the host load and can be compared
+# against a baseline to catch regressions.
+#
+# Example:
+#   python qemu_bench.py build/omni.elf --target stm32f405xx --output bench.json
+#   python qemu_bench.py build/omni.elf --target stm32f405xx --baseline bench_baseline.json
+
+# QEMU machine of each omni target
+MACHINES = {
+    'stm32f405xx': 'netduinoplus2',
+    'stm32f407xx': 'netduinoplus2',
+}
+
+RESULT_PREFIX = 'BENCH '
+END_PREFIX = 'BENCH_END '
+
+
+def run_qemu(args, machine):
+    command = [
+        args.qemu,
+        '-M', machine,
+        '-display', 'none',
+        '-monitor', 'none',
+        '-serial', 'null',
+        '-semihosting-config', 'enable=on,target=native',
+        '-icount', 'shift={}'.format(args.icount_shift),
+        '-kernel', args.elf,
+    ]
+
+    try:
+        process = subprocess.run(command, stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                                 timeout=args.timeout, check=False)
+    except FileNotFoundError:
+        sys.exit('{} not found'.format(args.qemu))
+    except subprocess.TimeoutExpired as error:
+        output = (error.stdout or b'').decode(errors='replace')
+        sys.stdout.write(output)
+        sys.exit('QEMU timed out after {} s'.format(args.timeout))
+
+    return process.returncode, process.stdout.decode(errors='replace')
+
+
+def parse_output(output):
+    cases = []
+    summary = None
+
+    for line in output.splitlines():
+        line = line.strip()
+        if line.startswith(END_PREFIX):
+            summary = json.loads(line[len(END_PREFIX):])
+        elif line.startswith(RESULT_PREFIX):
+            cases.append(json.loads(line[len(RESULT_PREFIX):]))
+
+    return cases, summary
+
+
+def compare(cases, baseline, threshold):
+    base = {case['name']: case for case in baseline.get('cases', [])}
+    regressions = []
+
+    print('{:<24} {:>12} {:>12} {:>9}'.format('case', 'baseline', 'ticks', 'change'))
+    for case in cases:
+        reference = base.get(case['name'])
+        if reference is None or reference['min'] == 0:
+            print('{:<24} {:>12} {:>12} {:>9}'.format(case['name'], '-', case['min'], 'new'))
+            continue
+
+        change = (case['min'] - reference['min']) * 100.0 / reference['min']
+        mark = ''
+        if change > threshold:
+            regressions.append(case['name'])
+            mark = ' !'
+        print('{:<24} {:>12} {:>12} {:>+8.1f}%{}'.format(case['name'], reference['min'], case['min'], change, mark))
+
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Run omni benchmarks under QEMU')
+    parser.add_argument('elf', help='Benchmark firmware ELF file')
+    parser.add_argument('--target', default='', help='omni target, selects the QEMU machine')
+    parser.add_argument('--machine', default='', help='QEMU machine, overrides the target')
+    parser.add_argument('--qemu', default='qemu-system-arm', help='QEMU executable')
+    parser.add_argument('--icount-shift', type=int, default=0, help='QEMU -icount shift')
+    parser.add_argument('--timeout', type=int, default=120, help='Timeout in seconds')
+    parser.add_argument('--output', help='JSON result file')
+    parser.add_argument('--baseline', help='JSON result file to compare against')
+    parser.add_argument('--threshold', type=float, default=5.0, help='Regression threshold in percent')
+    args = parser.parse_args()
+
+    machine = args.machine or MACHINES.get(args.target)
+    if not machine:
+        sys.exit('No QEMU machine for target "{}", use --machine'.format(args.target))
+
+    returncode, output = run_qemu(args, machine)
+    cases, summary = parse_output(output)
+
+    result = {
+        'elf': args.elf,
+        'target': args.target,
+        'machine': machine,
+        'icount_shift': args.icount_shift,
+        'cases': cases,
+        'failed': summary['failed'] if summary else None,
+    }
+
+    if args.output:
+        with open(args.output, 'w') as file:
+            json.dump(result, file, indent=2)
+            file.write('\n')
+
+    if summary is None:
+        sys.stdout.write(output)
+        sys.exit('Benchmark did not finish, QEMU exit status {}'.format(returncode))
+
+    regressions = []
+    if args.baseline:
+        with open(args.baseline) as file:
+            regressions = compare(cases, json.load(file), args.threshold)
+    else:
+        for case in cases:
+            print('{:<24} {:>12}'.format(case['name'], case['min']))
+
+    if summary['failed'] or returncode != 0:
+        sys.exit('{} case(s) failed, QEMU exit status {}'.format(summary['failed'], returncode))
+    if regressions:
+        sys.exit('Regression above {}%: {}'.format(args.threshold, ', '.join(regressions)))
+
+
+if __name__ == '__main__':
+    main()
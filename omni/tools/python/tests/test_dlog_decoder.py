@@ -0,0 +1,120 @@
+import os
+import struct
+import sys
+import unittest
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), '..'))
+
+import dlog_decoder as dec
+
+# Unit tests for dlog_decoder.py, run with:
+#   python -m unittest discover -s omni/tools/python/tests
+
+SHT_PROGBITS = 1
+SHT_STRTAB = 3
+SHF_ALLOC = 0x2
+
+RODATA_ADDR = 0x08001000
+
+# .omni_log as the DLOG macro lays it out, format then location, at address 0
+LOG_SECTION = b'boot\0main.c:10\0' + \
+              b'spi%u sent %u bytes\0spi.c:42\0' + \
+              b'temp %d C, mode %s, reg 0x%08X, %c%%\0sensor.c:7\0'
+LOG_BOOT = 0
+LOG_SPI = LOG_SECTION.index(b'spi%u')
+LOG_SENSOR = LOG_SECTION.index(b'temp')
+
+RODATA = b'fast\0slow\0'
+
+
+def build_elf(sections):
+    """ELF32 little endian with the given (name, type, flags, addr, content) sections."""
+    names = b'\0'
+    name_offsets = []
+    for name, _, _, _, _ in sections:
+        name_offsets.append(len(names))
+        names += name.encode() + b'\0'
+    name_offsets.append(len(names))
+    names += b'.shstrtab\0'
+    sections = list(sections) + [('.shstrtab', SHT_STRTAB, 0, 0, names)]
+
+    body = b''
+    offsets = []
+    for _, _, _, _, content in sections:
+        offsets.append(52 + len(body))
+        body += content
+    shoff = 52 + len(body)
+
+    header = b'\x7fELF' + bytes([1, 1, 1]) + bytes(9)
+    header += struct.pack('<HHIIIIIHHHHHH', 2, 40, 1, 0, 0, shoff, 0, 52, 0, 0, 40, len(sections) + 1,
+                          len(sections))
+
+    table = bytes(40)
+    for (_, sh_type, flags, addr, content), name, offset in zip(sections, name_offsets, offsets):
+        table += struct.pack('<IIIIIIIIII', name, sh_type, flags, addr, offset, len(content), 0, 0, 1, 0)
+
+    return header + body + table
+
+
+def frame(string_id, level, *args):
+    header = (string_id & 0xFFFFF) | (len(args) << 20) | (level << 24) | (dec.DLOG_MARKER << 27)
+    return struct.pack('<{}I'.format(len(args) + 1), header, *args)
+
+
+ELF = dec.Elf(build_elf([
+    ('.rodata', SHT_PROGBITS, SHF_ALLOC, RODATA_ADDR, RODATA),
+    ('.omni_log', SHT_PROGBITS, 0, 0, LOG_SECTION),
+]))
+
+
+class DecodeTest(unittest.TestCase):
+    def test_frames(self):
+        data = frame(LOG_BOOT, 3) + frame(LOG_SPI, 4, 2, 128)
+        self.assertEqual(list(dec.decode(ELF, data)), [
+            ('I', 'main.c:10', 'boot'),
+            ('D', 'spi.c:42', 'spi2 sent 128 bytes'),
+        ])
+
+    def test_conversions(self):
+        data = frame(LOG_SENSOR, 2, (-12) & 0xFFFFFFFF, RODATA_ADDR + 5, 0xBEEF, ord('x'))
+        self.assertEqual(list(dec.decode(ELF, data)),
+                         [('W', 'sensor.c:7', 'temp -12 C, mode slow, reg 0x0000BEEF, x%')])
+
+    def test_string_outside_elf(self):
+        data = frame(LOG_SENSOR, 1, 0, 0x20000000, 0, ord('y'))
+        message = list(dec.decode(ELF, data))[0][2]
+        self.assertIn('mode <0x20000000>', message)
+
+    def test_missing_arguments_kept_as_text(self):
+        data = frame(LOG_SPI, 3, 1)
+        self.assertEqual(list(dec.decode(ELF, data))[0][2], 'spi1 sent %u bytes')
+
+    def test_lost_frames(self):
+        data = frame(0, dec.DLOG_LEVEL_LOST, 5)
+        self.assertEqual(list(dec.decode(ELF, data)), [('W', '', '5 log frames lost')])
+
+    def test_resync_after_garbage(self):
+        data = b'\x00\x1A\xFF' + frame(LOG_BOOT, 3) + b'\xD3' + frame(LOG_SPI, 3, 0, 1)
+        self.assertEqual([message for _, _, message in dec.decode(ELF, data)], ['boot', 'spi0 sent 1 bytes'])
+
+    def test_id_inside_a_string_rejected(self):
+        # Not the start of a string, the frame is skipped byte by byte
+        data = frame(LOG_SPI + 1, 3) + frame(LOG_BOOT, 3)
+        self.assertEqual([message for _, _, message in dec.decode(ELF, data)], ['boot'])
+
+    def test_truncated_frame(self):
+        data = frame(LOG_BOOT, 3) + frame(LOG_SPI, 3, 1, 2)[:-2]
+        self.assertEqual([message for _, _, message in dec.decode(ELF, data)], ['boot'])
+
+    def test_missing_section(self):
+        elf = dec.Elf(build_elf([('.rodata', SHT_PROGBITS, SHF_ALLOC, RODATA_ADDR, RODATA)]))
+        with self.assertRaises(ValueError):
+            list(dec.decode(elf, frame(LOG_BOOT, 3)))
+
+    def test_not_elf32(self):
+        with self.assertRaises(ValueError):
+            dec.Elf(b'\x7fELF\x02\x01' + bytes(64))
+
+
+if __name__ == '__main__':
+    unittest.main()
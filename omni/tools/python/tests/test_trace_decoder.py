@@ -0,0 +1,121 @@
+import os
+import struct
+import sys
+import unittest
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), '..'))
+
+import trace_decoder as dec
+
+# Unit tests for trace_decoder.py, run with:
+#   python -m unittest discover -s omni/tools/python/tests
+
+FREQUENCY = 480000000
+
+
+def record(word0, event, context=0, arg=0):
+    return struct.pack('<II', word0 & 0xFFFFFFFF, event | (context << 8) | (arg << 16))
+
+
+def stream(*records, frequency=FREQUENCY):
+    """Stream header as written by trace.start(), followed by the records."""
+    header = record(dec.TRACE_SYNC_MAGIC, dec.EVENT_SYNC, arg=dec.TRACE_VERSION) + \
+        record(frequency, dec.EVENT_CLOCK)
+    return header + b''.join(records)
+
+
+def timed(events):
+    """Events without the thread name metadata."""
+    return [event for event in events if event['ph'] != 'M']
+
+
+class RecordTest(unittest.TestCase):
+    def test_irq_and_user_events(self):
+        data = stream(record(480, dec.EVENT_IRQ_ENTER, context=15),
+                      record(960, dec.EVENT_IRQ_EXIT, context=15),
+                      record(1440, dec.EVENT_USER_BEGIN, context=2),
+                      record(1920, dec.EVENT_USER_END, context=2),
+                      record(2400, dec.EVENT_USER_MARK, context=7, arg=0x1234))
+        events = timed(dec.decode(data, {2: 'parse'}))
+        self.assertEqual([(e['name'], e['ph']) for e in events],
+                         [('SysTick', 'B'), ('SysTick', 'E'), ('parse', 'B'), ('parse', 'E'), ('mark 7', 'i')])
+        self.assertEqual([e['ts'] for e in events], [1.0, 2.0, 3.0, 4.0, 5.0])
+        self.assertEqual(events[4]['args'], {'arg': 0x1234})
+
+    def test_external_irq_name(self):
+        events = timed(dec.decode(stream(record(0, dec.EVENT_IRQ_ENTER, context=16 + 37))))
+        self.assertEqual(events[0]['name'], 'IRQ37')
+
+    def test_thread_switch_closes_previous_thread(self):
+        data = stream(record(0, dec.EVENT_THREAD_SWITCH, arg=1),
+                      record(480, dec.EVENT_THREAD_SWITCH, arg=2))
+        events = timed(dec.decode(data, {1: 'main'}))
+        self.assertEqual([(e['name'], e['ph']) for e in events],
+                         [('main', 'B'), ('main', 'E'), ('thread 2', 'B')])
+
+    def test_driver_events(self):
+        data = stream(record(0, dec.EVENT_DRV_START, context=0x21, arg=64),
+                      record(480, dec.EVENT_DRV_ERROR, context=0x21, arg=3))
+        events = timed(dec.decode(data))
+        self.assertEqual(events[0]['name'], 'spi1')
+        self.assertEqual(events[0]['args'], {'len': 64})
+        self.assertEqual(events[1]['ph'], 'e')
+        self.assertEqual(events[1]['args'], {'error': 3})
+
+    def test_lost_events(self):
+        events = timed(dec.decode(stream(record(0, dec.EVENT_LOST, arg=12))))
+        self.assertEqual(events[0]['name'], 'lost 12')
+
+
+class TimestampTest(unittest.TestCase):
+    def test_counter_wrap(self):
+        data = stream(record(0xFFFFFE20, dec.EVENT_USER_MARK),
+                      record(0x000001E0, dec.EVENT_USER_MARK))
+        events = timed(dec.decode(data))
+        self.assertAlmostEqual(events[1]['ts'] - events[0]['ts'], 960 / FREQUENCY * 1e6)
+
+    def test_idle_time_records(self):
+        # 10 s without events, trace.flush() records a timestamp every 2^30 cycles
+        end = 10 * FREQUENCY
+        records = [record(0, dec.EVENT_USER_MARK)]
+        records += [record(stamp, dec.EVENT_TIME) for stamp in range(1 << 30, end, 1 << 30)]
+        records.append(record(end, dec.EVENT_USER_MARK))
+        events = timed(dec.decode(stream(*records)))
+        self.assertEqual(len(events), 2)
+        self.assertAlmostEqual(events[1]['ts'], 10e6)
+
+    def test_gap_over_one_period_without_time_records(self):
+        # The documented limit, the decoder cannot see a whole missing period
+        end = 10 * FREQUENCY
+        events = timed(dec.decode(stream(record(0, dec.EVENT_USER_MARK), record(end, dec.EVENT_USER_MARK))))
+        self.assertAlmostEqual(events[1]['ts'], (end - (1 << 32)) / FREQUENCY * 1e6)
+
+
+class StreamTest(unittest.TestCase):
+    def test_garbage_before_sync(self):
+        data = b'\x4F\x54\x52\x43\x00\x00\x00' + stream(record(480, dec.EVENT_USER_MARK))
+        events = timed(dec.decode(data))
+        self.assertEqual(len(events), 1)
+        self.assertEqual(events[0]['ts'], 1.0)
+
+    def test_truncated_record_ignored(self):
+        data = stream(record(480, dec.EVENT_USER_MARK)) + b'\x00\x01\x02'
+        self.assertEqual(len(timed(dec.decode(data))), 1)
+
+    def test_missing_sync(self):
+        with self.assertRaises(ValueError):
+            dec.decode(record(480, dec.EVENT_USER_MARK))
+
+    def test_missing_clock(self):
+        data = record(dec.TRACE_SYNC_MAGIC, dec.EVENT_SYNC, arg=dec.TRACE_VERSION) + record(0, dec.EVENT_USER_MARK)
+        with self.assertRaises(ValueError):
+            dec.decode(data)
+
+    def test_unsupported_version(self):
+        data = record(dec.TRACE_SYNC_MAGIC, dec.EVENT_SYNC, arg=dec.TRACE_VERSION + 1)
+        with self.assertRaises(ValueError):
+            dec.decode(data)
+
+
+if __name__ == '__main__':
+    unittest.main()
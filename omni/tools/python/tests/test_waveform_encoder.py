@@ -0,0 +1,148 @@
+import argparse
+import os
+import re
+import sys
+import unittest
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), '..'))
+
+import waveform_encoder as enc
+
+# Unit tests for waveform_encoder.py, run with:
+#   python -m unittest discover -s omni/tools/python/tests
+
+# WS2812 sample rate used by --ws2812, 2.4 MHz
+WS2812_SAMPLE_NS = 1e9 / 2.4e6
+
+
+def pin_levels(samples, pin):
+    """Return the level of one pin per sample, None if the sample does not drive it."""
+    levels = []
+    for value in samples:
+        set_bit = (value >> pin) & 0x01
+        reset_bit = (value >> (pin + 16)) & 0x01
+        if set_bit and reset_bit:
+            raise AssertionError('Pin {} set and reset in 0x{:08X}'.format(pin, value))
+        levels.append(1 if set_bit else (0 if reset_bit else None))
+    return levels
+
+
+class BitTimingTest(unittest.TestCase):
+    def test_ws2812_bits_are_msb_first(self):
+        samples = enc.encode([(1 << 0, bytes([0xA0]))], **dict(enc.WS2812, reset_samples=0))
+        levels = pin_levels(samples, 0)
+        expect = []
+        for bit in (1, 0, 1, 0, 0, 0, 0, 0):
+            high = enc.WS2812['one_high'] if bit else enc.WS2812['zero_high']
+            expect += [1] * high + [0] * (enc.WS2812['samples_per_bit'] - high)
+        self.assertEqual(levels, expect)
+
+    def test_ws2812_high_times_in_datasheet_window(self):
+        period = enc.WS2812['samples_per_bit'] * WS2812_SAMPLE_NS
+        t0h = enc.WS2812['zero_high'] * WS2812_SAMPLE_NS
+        t1h = enc.WS2812['one_high'] * WS2812_SAMPLE_NS
+        # T0H 400 ns, T1H 800 ns, both +-150 ns, bit period 1.25 us +-600 ns
+        self.assertLessEqual(abs(t0h - 400), 150)
+        self.assertLessEqual(abs(t1h - 800), 150)
+        self.assertLessEqual(abs(period - 1250), 600)
+
+    def test_custom_encoding(self):
+        samples = enc.encode([(1 << 3, bytes([0x01]))], samples_per_bit=5, zero_high=2, one_high=4, reset_samples=0)
+        levels = pin_levels(samples, 3)
+        self.assertEqual(levels[:5], [1, 1, 0, 0, 0])
+        self.assertEqual(levels[-5:], [1, 1, 1, 1, 0])
+
+    def test_full_high_bit(self):
+        samples = enc.encode([(1, bytes([0xFF]))], samples_per_bit=2, zero_high=1, one_high=2, reset_samples=0)
+        self.assertEqual(pin_levels(samples, 0), [1] * 16)
+
+    def test_invalid_encoding(self):
+        with self.assertRaises(ValueError):
+            enc.encode([(1, b'\x00')], samples_per_bit=0, zero_high=0, one_high=0, reset_samples=0)
+        with self.assertRaises(ValueError):
+            enc.encode([(1, b'\x00')], samples_per_bit=3, zero_high=1, one_high=4, reset_samples=0)
+
+
+class ResetPaddingTest(unittest.TestCase):
+    def test_reset_samples_drive_all_lanes_low(self):
+        lanes = [(1 << 0, bytes([0xFF])), (1 << 5, bytes([0x0F]))]
+        samples = enc.encode(lanes, samples_per_bit=3, zero_high=1, one_high=2, reset_samples=7)
+        tail = samples[-7:]
+        self.assertEqual(tail, [((1 << 0) | (1 << 5)) << 16] * 7)
+
+    def test_ws2812_latch_time(self):
+        samples = enc.encode([(1, bytes([0x00]))], **enc.WS2812)
+        tail = samples[8 * enc.WS2812['samples_per_bit']:]
+        self.assertEqual(len(tail), enc.WS2812['reset_samples'])
+        self.assertTrue(all(level == 0 for level in pin_levels(tail, 0)))
+        # WS2812 latches the data after at least 50 us low
+        self.assertGreaterEqual(len(tail) * WS2812_SAMPLE_NS, 50000)
+
+    def test_no_padding(self):
+        samples = enc.encode([(1, bytes([0x00]))], samples_per_bit=3, zero_high=1, one_high=2, reset_samples=0)
+        self.assertEqual(len(samples), 24)
+
+    def test_last_bit_ends_low(self):
+        samples = enc.encode([(1, bytes([0xFF]))], **dict(enc.WS2812, reset_samples=0))
+        self.assertEqual(pin_levels(samples, 0)[-1], 0)
+
+
+class BufferLayoutTest(unittest.TestCase):
+    def test_length(self):
+        lanes = [(1 << 1, bytes(5)), (1 << 2, bytes(5))]
+        samples = enc.encode(lanes, samples_per_bit=4, zero_high=1, one_high=3, reset_samples=11)
+        self.assertEqual(len(samples), 5 * 8 * 4 + 11)
+
+    def test_samples_are_bsrr_words(self):
+        lanes = [(1 << 0, bytes([0x5A, 0xC3])), (1 << 15, bytes([0x96, 0x3C]))]
+        mask = (1 << 0) | (1 << 15)
+        for value in enc.encode(lanes, **enc.WS2812):
+            self.assertEqual(value & ~0xFFFFFFFF, 0)
+            set_mask = value & 0xFFFF
+            reset_mask = value >> 16
+            # Every lane pin is driven, pins outside the lanes are untouched
+            self.assertEqual(set_mask & reset_mask, 0)
+            self.assertEqual(set_mask | reset_mask, mask)
+
+    def test_parallel_lanes_are_independent(self):
+        lanes = [(1 << 0, bytes([0xF0])), (1 << 1, bytes([0x0F]))]
+        samples = enc.encode(lanes, samples_per_bit=3, zero_high=1, one_high=2, reset_samples=0)
+        for pin, data in ((0, 0xF0), (1, 0x0F)):
+            single = enc.encode([(1 << pin, bytes([data]))], samples_per_bit=3, zero_high=1, one_high=2, reset_samples=0)
+            self.assertEqual(pin_levels(samples, pin), pin_levels(single, pin))
+
+    def test_lanes_sharing_a_pin_mask(self):
+        samples = enc.encode([(0x0003, bytes([0x80]))], samples_per_bit=3, zero_high=1, one_high=2, reset_samples=0)
+        self.assertEqual(pin_levels(samples, 0), pin_levels(samples, 1))
+
+    def test_unequal_lanes(self):
+        with self.assertRaises(ValueError):
+            enc.encode([(1, bytes(2)), (2, bytes(3))], **enc.WS2812)
+
+    def test_empty_lanes(self):
+        self.assertEqual(enc.encode([], samples_per_bit=3, zero_high=1, one_high=2, reset_samples=2), [0, 0])
+
+    def test_c_array_round_trip(self):
+        samples = enc.encode([(1 << 4, bytes([0x12, 0x34]))], **enc.WS2812)
+        text = enc.to_c_array('leds', samples)
+        self.assertTrue(text.startswith('const uint32_t leds[{}] = {{\n'.format(len(samples))))
+        self.assertTrue(text.endswith('};\n'))
+        values = [int(v, 16) for v in re.findall(r'0x([0-9A-F]{8}),', text)]
+        self.assertEqual(values, samples)
+        rows = text.splitlines()[1:-1]
+        self.assertTrue(all(len(row.split()) <= 6 for row in rows))
+
+
+class ParseLaneTest(unittest.TestCase):
+    def test_parse(self):
+        self.assertEqual(enc.parse_lane('3:ff00'), (1 << 3, b'\xff\x00'))
+        self.assertEqual(enc.parse_lane('0x0f:01'), (1 << 15, b'\x01'))
+
+    def test_invalid(self):
+        for text in ('16:00', '-1:00', '2:xyz'):
+            with self.assertRaises(argparse.ArgumentTypeError):
+                enc.parse_lane(text)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,181 @@
+import argparse
+import json
+import struct
+import sys
+
+# Convert a binary stream from the trace component into Chrome trace JSON,
+# which can be opened in https://ui.perfetto.dev or chrome://tracing.
+# The record layout matches components/trace/trace.h.
+#
+# Example, capture RTT channel 1 with J-Link and convert it:
+#   JLinkRTTLogger -Device STM32F407VG -If SWD -Speed 4000 -RTTChannel 1 trace.bin
+#   python trace_decoder.py trace.bin -o trace.json
+
+TRACE_SYNC_MAGIC = 0x4352544F
+TRACE_VERSION = 1
+
+EVENT_SYNC = 0x01
+EVENT_CLOCK = 0x02
+EVENT_LOST = 0x03
+EVENT_TIME = 0x04
+EVENT_IRQ_ENTER = 0x10
+EVENT_IRQ_EXIT = 0x11
+EVENT_THREAD_SWITCH = 0x20
+EVENT_DRV_START = 0x30
+EVENT_DRV_COMPLETE = 0x31
+EVENT_DRV_ERROR = 0x32
+EVENT_USER_BEGIN = 0x40
+EVENT_USER_END = 0x41
+EVENT_USER_MARK = 0x42
+
+DRIVERS = {0x10: 'usart tx', 0x20: 'spi', 0x30: 'i2c', 0x40: 'usart rx'}
+
+PID = 1
+TID_IRQ = 1
+TID_THREAD = 2
+TID_USER = 3
+
+# Cortex-M exception names, external interrupts are shown as IRQn
+EXCEPTIONS = {2: 'NMI', 3: 'HardFault', 4: 'MemManage', 5: 'BusFault', 6: 'UsageFault',
+              11: 'SVCall', 12: 'DebugMon', 14: 'PendSV', 15: 'SysTick'}
+
+
+def exception_name(vector):
+    if vector in EXCEPTIONS:
+        return EXCEPTIONS[vector]
+    return 'IRQ{}'.format(vector - 16)
+
+
+def find_sync(data, offset=0):
+    magic = struct.pack('<I', TRACE_SYNC_MAGIC)
+    while True:
+        index = data.find(magic, offset)
+        if index < 0:
+            return -1
+        if index + 8 > len(data):
+            return -1
+        info, = struct.unpack_from('<I', data, index + 4)
+        if (info & 0xFF) == EVENT_SYNC:
+            return index
+        offset = index + 1
+
+
+def read_records(data):
+    """Yield (word0, event, context, arg) from the first sync record on."""
+    offset = find_sync(data)
+    if offset < 0:
+        raise ValueError('No sync record found')
+
+    while offset + 8 <= len(data):
+        word0, info = struct.unpack_from('<II', data, offset)
+        offset += 8
+        yield word0, info & 0xFF, (info >> 8) & 0xFF, info >> 16
+
+
+def decode(data, names=None):
+    """Return a list of Chrome trace events."""
+    names = names or {}
+    events = []
+    frequency = None
+    last = None
+    high = 0
+    thread = None
+
+    def timestamp(cycles):
+        nonlocal last, high
+        # Unwrap the 32-bit cycle counter. This needs records less than 2^32 cycles
+        # apart, trace.flush() records EVENT_TIME while idle to keep it so as long
+        # as it runs at least every 3 * 2^30 cycles.
+        if last is not None and cycles < last:
+            high += 1 << 32
+        last = cycles
+        return (high + cycles) * 1e6 / frequency
+
+    for word0, event, context, arg in read_records(data):
+        if event == EVENT_SYNC:
+            if arg != TRACE_VERSION:
+                raise ValueError('Unsupported trace version {}'.format(arg))
+            continue
+        if event == EVENT_CLOCK:
+            frequency = word0
+            continue
+        if frequency is None:
+            raise ValueError('Clock record missing after sync')
+
+        ts = timestamp(word0)
+
+        if event == EVENT_TIME:
+            continue
+        if event == EVENT_LOST:
+            events.append({'name': 'lost {}'.format(arg), 'ph': 'i', 's': 'g', 'ts': ts, 'pid': PID, 'tid': TID_USER})
+        elif event == EVENT_IRQ_ENTER:
+            events.append({'name': exception_name(context), 'ph': 'B', 'ts': ts, 'pid': PID, 'tid': TID_IRQ})
+        elif event == EVENT_IRQ_EXIT:
+            events.append({'name': exception_name(context), 'ph': 'E', 'ts': ts, 'pid': PID, 'tid': TID_IRQ})
+        elif event == EVENT_THREAD_SWITCH:
+            if thread is not None:
+                events.append({'name': thread, 'ph': 'E', 'ts': ts, 'pid': PID, 'tid': TID_THREAD})
+            thread = names.get(arg, 'thread {}'.format(arg))
+            events.append({'name': thread, 'ph': 'B', 'ts': ts, 'pid': PID, 'tid': TID_THREAD})
+        elif event in (EVENT_DRV_START, EVENT_DRV_COMPLETE, EVENT_DRV_ERROR):
+            name = '{}{}'.format(DRIVERS.get(context & 0xF0, 'drv'), context & 0x0F)
+            if event == EVENT_DRV_START:
+                events.append({'name': name, 'cat': 'driver', 'ph': 'b', 'id': context, 'ts': ts, 'pid': PID,
+                               'args': {'len': arg}})
+            else:
+                phase = {'name': name, 'cat': 'driver', 'ph': 'e', 'id': context, 'ts': ts, 'pid': PID}
+                if event == EVENT_DRV_ERROR:
+                    phase['args'] = {'error': arg}
+                events.append(phase)
+        elif event == EVENT_USER_BEGIN:
+            events.append({'name': names.get(context, 'span {}'.format(context)), 'ph': 'B', 'ts': ts, 'pid': PID,
+                           'tid': TID_USER})
+        elif event == EVENT_USER_END:
+            events.append({'name': names.get(context, 'span {}'.format(context)), 'ph': 'E', 'ts': ts, 'pid': PID,
+                           'tid': TID_USER})
+        elif event == EVENT_USER_MARK:
+            events.append({'name': names.get(context, 'mark {}'.format(context)), 'ph': 'i', 's': 't', 'ts': ts,
+                           'pid': PID, 'tid': TID_USER, 'args': {'arg': arg}})
+
+    for tid, name in ((TID_IRQ, 'irq'), (TID_THREAD, 'thread'), (TID_USER, 'user')):
+        events.append({'name': 'thread_name', 'ph': 'M', 'pid': PID, 'tid': tid, 'args': {'name': name}})
+
+    return events
+
+
+def parse_name(text):
+    key, _, name = text.partition('=')
+    try:
+        return int(key, 0), name
+    except ValueError:
+        raise argparse.ArgumentTypeError('Invalid name mapping: {}'.format(text))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Convert an omni trace stream to Chrome trace JSON')
+    parser.add_argument('input', help='Binary trace file')
+    parser.add_argument('--name', action='append', type=parse_name, default=[],
+                        help='Name a thread, span or mark ID as <id>=<name>, may be repeated')
+    parser.add_argument('-o', '--output', help='Output file, stdout if not set')
+    args = parser.parse_args()
+
+    with open(args.input, 'rb') as file:
+        data = file.read()
+
+    try:
+        events = decode(data, dict(args.name))
+    except ValueError as e:
+        print('Error: {}'.format(e), file=sys.stderr)
+        sys.exit(1)
+
+    content = json.dumps({'traceEvents': events, 'displayTimeUnit': 'ns'}, indent=1)
+    if args.output:
+        with open(args.output, 'w') as file:
+            file.write(content)
+        print('Converted {} events to {}'.format(len(events), args.output))
+    else:
+        sys.stdout.write(content + '\n')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,110 @@
+import argparse
+import sys
+
+# Encode data lanes into a GPIO waveform buffer for the waveform component.
+# The bit encoding matches waveform.encode() in components/waveform, so the
+# generated table can be placed in flash and passed to waveform.write().
+#
+# Example, two WS2812 strips on PB0 and PB1 with one pixel each:
+#   python waveform_encoder.py --ws2812 --lane 0:ff0000 --lane 1:00ff00
+
+WS2812 = {'samples_per_bit': 3, 'zero_high': 1, 'one_high': 2, 'reset_samples': 120}
+
+
+def sample(set_mask, reset_mask):
+    return (set_mask & 0xFFFF) | ((reset_mask & 0xFFFF) << 16)
+
+
+def encode(lanes, samples_per_bit, zero_high, one_high, reset_samples):
+    """Return BSRR samples for a list of (pin_mask, bytes) lanes."""
+    if samples_per_bit <= 0 or zero_high > samples_per_bit or one_high > samples_per_bit:
+        raise ValueError('Invalid bit encoding')
+
+    byte_num = max((len(data) for _, data in lanes), default=0)
+    if any(len(data) != byte_num for _, data in lanes):
+        raise ValueError('All lanes must have the same length')
+
+    all_mask = 0
+    for pins, _ in lanes:
+        all_mask |= pins
+
+    samples = []
+    for byte in range(byte_num):
+        for bit in range(7, -1, -1):
+            one_mask = 0
+            for pins, data in lanes:
+                if (data[byte] >> bit) & 0x01:
+                    one_mask |= pins
+
+            for index in range(samples_per_bit):
+                high_mask = 0
+                if index < zero_high:
+                    high_mask |= all_mask & ~one_mask
+                if index < one_high:
+                    high_mask |= one_mask
+                samples.append(sample(high_mask, all_mask & ~high_mask))
+
+    samples.extend([sample(0, all_mask)] * reset_samples)
+
+    return samples
+
+
+def parse_lane(text):
+    pin, _, data = text.partition(':')
+    pin = int(pin, 0)
+    if not 0 <= pin < 16:
+        raise argparse.ArgumentTypeError('Pin must be in range 0..15: {}'.format(pin))
+    try:
+        return (1 << pin, bytes.fromhex(data))
+    except ValueError:
+        raise argparse.ArgumentTypeError('Invalid hex data: {}'.format(data))
+
+
+def to_c_array(name, samples):
+    lines = ['const uint32_t {}[{}] = {{'.format(name, len(samples))]
+    for i in range(0, len(samples), 6):
+        lines.append('    ' + ' '.join('0x{:08X},'.format(s) for s in samples[i:i + 6]))
+    lines.append('};')
+    return '\n'.join(lines) + '\n'
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Encode data lanes into a GPIO waveform buffer')
+    parser.add_argument('--lane', action='append', type=parse_lane, required=True,
+                        help='Lane as <pin>:<hex data>, may be repeated for parallel lanes')
+    parser.add_argument('--ws2812', action='store_true', help='Use the WS2812 encoding at 2.4 MHz sample rate')
+    parser.add_argument('--samples-per-bit', type=int, default=3, help='Samples per data bit')
+    parser.add_argument('--zero-high', type=int, default=1, help='High samples of a 0 bit')
+    parser.add_argument('--one-high', type=int, default=2, help='High samples of a 1 bit')
+    parser.add_argument('--reset-samples', type=int, default=0, help='Low samples appended after the data')
+    parser.add_argument('--name', default='waveform_samples', help='C array name')
+    parser.add_argument('-o', '--output', help='Output file, stdout if not set')
+    args = parser.parse_args()
+
+    if args.ws2812:
+        encoding = WS2812
+    else:
+        encoding = {
+            'samples_per_bit': args.samples_per_bit,
+            'zero_high': args.zero_high,
+            'one_high': args.one_high,
+            'reset_samples': args.reset_samples,
+        }
+
+    try:
+        samples = encode(args.lane, **encoding)
+    except ValueError as e:
+        print('Error: {}'.format(e), file=sys.stderr)
+        sys.exit(1)
+
+    content = to_c_array(args.name, samples)
+    if args.output:
+        with open(args.output, 'w') as file:
+            file.write(content)
+        print('Generated {} samples in {}'.format(len(samples), args.output))
+    else:
+        sys.stdout.write(content)
+
+
+if __name__ == '__main__':
+    main()